@@ -19,6 +19,23 @@ struct EngineConfig {
     DXGI_FORMAT backBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
     bool cappedFPS = true;
     uint32_t targetFPS = 360;
+    uint32_t renderWorkerContexts = 8;  // Command lists available for parallel draw recording
+    bool occlusionCulling = false;        // Skip entities hidden behind occluders, tested on the CPU
+    bool occlusionBenchmarkScene = false; // Spawn walls + hidden props to measure the culler
+    bool meshLODs = false;                // Generate LOD chains at mesh creation and select per entity (slow to simplify)
+    bool indirectDraws = false;           // Submit the forward pass with one ExecuteIndirect
+    bool asyncGeometryUploads = false;    // Copy mesh data on the copy queue instead of the frame's list
+    bool meshDeduplication = false;       // Share one allocation between meshes with identical content (keeps a CPU copy of each)
+    bool quantizedVertices = true;        // 16-bit positions and 8-bit colors in the vertex buffer
+    bool meshOptimization = true;         // Reorder mesh triangles/vertices for the GPU caches at creation
+    bool meshlets = false;                // Cluster meshes into meshlets with culling bounds at creation
+
+    // Scene settings
+    std::string gltfScene;                // .gltf/.glb imported at startup, empty for none
+
+    // Asset settings
+    std::string assetPack = "../../assets.de3pack"; // Mounted over the asset root when present, empty for none
+    bool looseAssetOverrides = true;      // Loose files under the asset root override packed ones
 
     // DEBUG SETTINGS
     uint32_t debugFrameInterval = 60;
@@ -60,6 +77,24 @@ inline void PrintConfigStats(const EngineConfig& config) {
     std::cout << "\n[Performance Settings]" << std::endl;
     std::cout << "Target FPS: " << config.targetFPS << std::endl;
     std::cout << "Capped FPS: " << (config.cappedFPS ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Render Worker Contexts: " << config.renderWorkerContexts << std::endl;
+    std::cout << "Occlusion Culling: " << (config.occlusionCulling ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Mesh LODs: " << (config.meshLODs ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Indirect Draws: " << (config.indirectDraws ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Async Geometry Uploads: " << (config.asyncGeometryUploads ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Mesh Deduplication: " << (config.meshDeduplication ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Quantized Vertices: " << (config.quantizedVertices ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Mesh Optimization: " << (config.meshOptimization ? "Enabled" : "Disabled") << std::endl;
+    std::cout << "Meshlets: " << (config.meshlets ? "Enabled" : "Disabled") << std::endl;
+
+    // Scene Settings
+    std::cout << "\n[Scene Settings]" << std::endl;
+    std::cout << "glTF Scene: " << (config.gltfScene.empty() ? "None" : config.gltfScene) << std::endl;
+
+    // Asset Settings
+    std::cout << "\n[Asset Settings]" << std::endl;
+    std::cout << "Asset Pack: " << (config.assetPack.empty() ? "None" : config.assetPack) << std::endl;
+    std::cout << "Loose Asset Overrides: " << (config.looseAssetOverrides ? "Enabled" : "Disabled") << std::endl;
 
     std::cout << "================================" << std::endl;
 }
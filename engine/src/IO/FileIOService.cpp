@@ -0,0 +1,231 @@
+#include "FileIOService.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Reads the whole file into a container resized once to the file size.
+// Container is std::vector<uint8_t> or std::string.
+template <typename Container>
+bool ReadInto(const std::string& path, Container& out) {
+    out.clear();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    out.resize(static_cast<size_t>(size.QuadPart));
+    size_t offset = 0;
+    while (offset < out.size()) {
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(out.size() - offset, 1u << 30));
+        DWORD read = 0;
+        if (!::ReadFile(file, reinterpret_cast<char*>(&out[0]) + offset, chunk, &read, nullptr) || read == 0) {
+            break;
+        }
+        offset += read;
+    }
+    CloseHandle(file);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close(file);
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    out.resize(static_cast<size_t>(info.st_size));
+    size_t offset = 0;
+    while (offset < out.size()) {
+        const ssize_t read = ::read(file, reinterpret_cast<char*>(&out[0]) + offset, out.size() - offset);
+        if (read <= 0) {
+            break;
+        }
+        offset += static_cast<size_t>(read);
+    }
+    close(file);
+#endif
+
+    if (offset != out.size()) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FileIOService::FileIOService(uint32_t workerCount, uint32_t maxBatchSize)
+    : m_maxBatchSize(std::max(maxBatchSize, 1u))
+{
+    if (workerCount == 0) {
+        workerCount = 2;
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&FileIOService::WorkerLoop, this);
+    }
+}
+
+FileIOService::~FileIOService() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_requestAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void FileIOService::ReadAsync(const std::string& path, ReadCallback callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back({ path, std::move(callback) });
+        m_stats.requests++;
+    }
+    m_requestAvailable.notify_one();
+}
+
+void FileIOService::ReadAsync(std::vector<ReadRequest> requests) {
+    if (requests.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (ReadRequest& request : requests) {
+            m_requests.push_back(std::move(request));
+        }
+        m_stats.requests += requests.size();
+    }
+    m_requestAvailable.notify_all();
+}
+
+void FileIOService::RunAsync(std::function<void()> task) {
+    // An empty path skips the read and only runs the callback
+    ReadAsync(std::string(), [task = std::move(task)](ReadResult&) { task(); });
+}
+
+std::future<FileIOService::ReadResult> FileIOService::ReadFuture(const std::string& path) {
+    // std::function needs a copyable callable, so the promise is shared
+    auto promise = std::make_shared<std::promise<ReadResult>>();
+    std::future<ReadResult> future = promise->get_future();
+    ReadAsync(path, [promise](ReadResult& result) {
+        promise->set_value(std::move(result));
+    });
+    return future;
+}
+
+void FileIOService::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_requests.empty() && m_activeRequests == 0; });
+}
+
+FileIOService::Statistics FileIOService::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void FileIOService::WorkerLoop() {
+    std::vector<ReadRequest> batch;
+    batch.reserve(m_maxBatchSize);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestAvailable.wait(lock, [this] { return m_shutdown || !m_requests.empty(); });
+            if (m_shutdown && m_requests.empty()) {
+                return;
+            }
+
+            // Leave work for the other workers when the queue is short
+            const size_t share = (m_requests.size() + m_workers.size() - 1) / m_workers.size();
+            const size_t take = std::min<size_t>(std::max<size_t>(share, 1), m_maxBatchSize);
+            for (size_t i = 0; i < take; ++i) {
+                batch.push_back(std::move(m_requests.front()));
+                m_requests.pop_front();
+            }
+            m_activeRequests += static_cast<uint32_t>(take);
+            m_stats.batches++;
+        }
+
+        uint64_t bytesRead = 0;
+        uint64_t failed = 0;
+        for (ReadRequest& request : batch) {
+            ReadResult result;
+            if (request.path.empty()) {
+                request.callback(result);
+                continue;
+            }
+            result.path = std::move(request.path);
+            result.success = ReadWholeFile(result.path, result.data);
+            if (result.success) {
+                bytesRead += result.data.size();
+            } else {
+                printf("FileIOService: Failed to read '%s'\n", result.path.c_str());
+                failed++;
+            }
+            if (request.callback) {
+                request.callback(result);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeRequests -= static_cast<uint32_t>(batch.size());
+            m_stats.completed += batch.size();
+            m_stats.failed += failed;
+            m_stats.bytesRead += bytesRead;
+            if (m_requests.empty() && m_activeRequests == 0) {
+                m_idle.notify_all();
+            }
+        }
+        batch.clear();
+    }
+}
+
+// =============================================================================
+// Synchronous Helpers
+// =============================================================================
+
+bool FileIOService::ReadWholeFile(const std::string& path, std::vector<uint8_t>& out) {
+    return ReadInto(path, out);
+}
+
+bool FileIOService::ReadWholeFile(const std::string& path, std::string& out) {
+    return ReadInto(path, out);
+}
+
+MappedFile FileIOService::Map(const std::string& path) {
+    MappedFile file;
+    file.Open(path);
+    return file;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+
+// =============================================================================
+// File IO Service
+// =============================================================================
+
+// Two ways to get at file contents without the ifstream seek/read dance:
+//  - Map: a read-only view, no copy, pages load on first touch
+//  - ReadAsync: whole-file reads on dedicated I/O threads, completion through
+//    a callback (on the I/O thread) or a future
+// I/O threads are separate from the JobSystem so blocking reads never stall
+// CPU jobs. Workers take queued requests in batches to keep lock traffic low
+// with many small files.
+class FileIOService {
+public:
+    struct ReadResult {
+        std::string path;
+        std::vector<uint8_t> data;
+        bool success = false;
+    };
+
+    using ReadCallback = std::function<void(ReadResult& result)>;
+
+    struct ReadRequest {
+        std::string path;
+        ReadCallback callback;
+    };
+
+    struct Statistics {
+        uint64_t requests = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;
+        uint64_t bytesRead = 0;
+        uint64_t batches = 0;           // Queue pops, each taking up to maxBatchSize requests
+    };
+
+    // workerCount == 0 picks two threads, enough to keep a disk queue busy
+    explicit FileIOService(uint32_t workerCount = 0, uint32_t maxBatchSize = 16);
+    ~FileIOService();
+
+    // Prevent copying
+    FileIOService(const FileIOService&) = delete;
+    FileIOService& operator=(const FileIOService&) = delete;
+
+    // Queue one read, the callback runs on an I/O thread
+    void ReadAsync(const std::string& path, ReadCallback callback);
+
+    // Queue many reads under one lock
+    void ReadAsync(std::vector<ReadRequest> requests);
+
+    // Queue one read and wait on the result wherever convenient
+    std::future<ReadResult> ReadFuture(const std::string& path);
+
+    // Queue blocking work that reads some other way (a mapped view, a file
+    // range), so it shares the I/O threads instead of stalling CPU jobs
+    void RunAsync(std::function<void()> task);
+
+    // Block until every queued read completed and its callback returned
+    void WaitIdle();
+
+    Statistics GetStatistics() const;
+
+    // =========================================================================
+    // Synchronous helpers, any thread
+    // =========================================================================
+
+    // Whole file in one allocation sized from the file system, no seeking
+    static bool ReadWholeFile(const std::string& path, std::vector<uint8_t>& out);
+    static bool ReadWholeFile(const std::string& path, std::string& out);
+
+    // Read-only view, closed when the returned object goes away
+    static MappedFile Map(const std::string& path);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<ReadRequest> m_requests;
+    uint32_t m_maxBatchSize;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_requestAvailable;
+    std::condition_variable m_idle;
+    uint32_t m_activeRequests = 0;
+    bool m_shutdown = false;
+    Statistics m_stats;
+};
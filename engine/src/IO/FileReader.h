@@ -1,43 +1,59 @@
 #pragma once
 
-// #define TINYGLTF_IMPLEMENTATION
-// #define STB_IMAGE_IMPLEMENTATION
-// #define STB_IMAGE_WRITE_IMPLEMENTATION
-
-// #include "tiny_gltf.h"
-
+#include <filesystem>
 #include <string>
 #include <vector>
-#include <fstream>
+
+#include "FileIOService.h"
+#include "VirtualFileSystem.h"
 
 // TODO:
 // Single IO entry point
 // load textures, meshes, files, etc
+//
+// Paths resolve through the mounted file system first (packs and loose
+// directories), then straight from the disk.
 class FileReader {
 public:
-    static std::string ReadFile(const std::string& filepath) {
-        std::ifstream file(filepath, std::ios::binary);
-        if (!file.is_open()) return "";
+    // Not owned, nullptr reads from the disk only
+    static void SetFileSystem(const VirtualFileSystem* fileSystem) { s_fileSystem = fileSystem; }
+    static const VirtualFileSystem* GetFileSystem() { return s_fileSystem; }
 
-        file.seekg(0, std::ios::end);
-        size_t size = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-        std::string content(size, '\0');
-        file.read(&content[0], size);
+    static std::string ReadFile(const std::string& filepath) {
+        std::string content;
+        if (!s_fileSystem || !s_fileSystem->ReadFile(filepath, content)) {
+            FileIOService::ReadWholeFile(filepath, content);
+        }
         return content;
     }
 
     static std::vector<uint8_t> ReadFileBytes(const std::string& filepath) {
-        std::ifstream file(filepath, std::ios::binary);
-        if (!file.is_open()) return {};
+        std::vector<uint8_t> bytes;
+        if (!s_fileSystem || !s_fileSystem->ReadFile(filepath, bytes)) {
+            FileIOService::ReadWholeFile(filepath, bytes);
+        }
+        return bytes;
+    }
 
-        file.seekg(0, std::ios::end);
-        size_t size = file.tellg();
-        file.seekg(0, std::ios::beg);
+    static bool Exists(const std::string& filepath) {
+        std::error_code error;
+        return (s_fileSystem && s_fileSystem->Exists(filepath)) || std::filesystem::is_regular_file(filepath, error);
+    }
 
-        std::vector<uint8_t> bytes(size);
-        file.read(reinterpret_cast<char*>(bytes.data()), size);
-        return bytes;
+    // Read-only bytes without a copy where possible. Check IsValid() on the result
+    static FileView OpenView(const std::string& filepath) {
+        FileView view;
+        if (!s_fileSystem || !s_fileSystem->OpenView(filepath, view)) {
+            view.OpenFile(filepath);
+        }
+        return view;
     }
+
+    // Read-only view of a loose file, no copy. Check IsOpen() on the result
+    static MappedFile MapFile(const std::string& filepath) {
+        return FileIOService::Map(filepath);
+    }
+
+private:
+    static inline const VirtualFileSystem* s_fileSystem = nullptr;
 };
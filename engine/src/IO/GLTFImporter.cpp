@@ -0,0 +1,642 @@
+// tinygltf lives in this translation unit only, stb in StbImpl.cpp. External
+// images are never read here, the texture pipeline resolves them from the
+// kept URI.
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#include "tiny_gltf.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "GLTFImporter.h"
+#include "jobs/JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// =============================================================================
+// Accessor Decoding
+// =============================================================================
+
+// Raw element layout of an accessor after bounds checks
+struct AccessorView {
+    const uint8_t* data = nullptr;  // nullptr for a zero-filled accessor
+    size_t stride = 0;
+    size_t elementSize = 0;         // Tightly packed element
+    size_t count = 0;
+    uint32_t components = 0;
+    int componentType = -1;
+    bool normalized = false;
+};
+
+bool ResolveView(const tinygltf::Model& model, int bufferViewIndex, size_t byteOffset, size_t elementSize,
+                 size_t count, size_t& outStride, const uint8_t*& outData) {
+    if (bufferViewIndex < 0 || bufferViewIndex >= static_cast<int>(model.bufferViews.size())) {
+        return false;
+    }
+    const tinygltf::BufferView& bufferView = model.bufferViews[bufferViewIndex];
+    if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(model.buffers.size())) {
+        return false;
+    }
+    const std::vector<unsigned char>& buffer = model.buffers[bufferView.buffer].data;
+
+    const size_t stride = bufferView.byteStride != 0 ? bufferView.byteStride : elementSize;
+    const size_t start = bufferView.byteOffset + byteOffset;
+    const size_t end = count > 0 ? start + (count - 1) * stride + elementSize : start;
+    if (end > buffer.size() || end - bufferView.byteOffset > bufferView.byteLength) {
+        return false;
+    }
+
+    outStride = stride;
+    outData = buffer.data() + start;
+    return true;
+}
+
+bool GetAccessorView(const tinygltf::Model& model, int accessorIndex, AccessorView& outView) {
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
+        return false;
+    }
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+
+    const int componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+    const int components = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    if (componentSize <= 0 || components <= 0) {
+        return false;
+    }
+
+    outView.count = accessor.count;
+    outView.components = static_cast<uint32_t>(components);
+    outView.componentType = accessor.componentType;
+    outView.normalized = accessor.normalized;
+    outView.elementSize = static_cast<size_t>(componentSize) * components;
+    outView.stride = outView.elementSize;
+    outView.data = nullptr;
+
+    // Sparse accessors may omit the base view, which then reads as zeros
+    if (accessor.bufferView < 0) {
+        return accessor.sparse.isSparse;
+    }
+    return ResolveView(model, accessor.bufferView, accessor.byteOffset, outView.elementSize, accessor.count,
+                       outView.stride, outView.data);
+}
+
+template <typename T>
+float ToFloat(T value, bool normalized) {
+    if (!normalized) {
+        return static_cast<float>(value);
+    }
+    // glTF 2.0: signed values map to max(c / MAX, -1), unsigned to c / MAX
+    const float scaled = static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+    return std::max(scaled, -1.0f);
+}
+
+template <typename T>
+void ConvertElements(const uint8_t* src, size_t srcStride, size_t count, uint32_t components, bool normalized,
+                     float* dst, size_t dstStride) {
+    for (size_t i = 0; i < count; ++i) {
+        T element[4];
+        memcpy(element, src + i * srcStride, sizeof(T) * components);
+        float* out = dst + i * dstStride;
+        for (uint32_t c = 0; c < components; ++c) {
+            out[c] = ToFloat(element[c], normalized);
+        }
+    }
+}
+
+template <>
+void ConvertElements<float>(const uint8_t* src, size_t srcStride, size_t count, uint32_t components, bool,
+                            float* dst, size_t dstStride) {
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(dst + i * dstStride, src + i * srcStride, sizeof(float) * components);
+    }
+}
+
+bool ConvertRange(int componentType, const uint8_t* src, size_t srcStride, size_t count, uint32_t components,
+                  bool normalized, float* dst, size_t dstStride) {
+    switch (componentType) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            ConvertElements<float>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            ConvertElements<int8_t>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            ConvertElements<uint8_t>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            ConvertElements<int16_t>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            ConvertElements<uint16_t>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            ConvertElements<uint32_t>(src, srcStride, count, components, normalized, dst, dstStride); return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t ReadIndex(int componentType, const uint8_t* src) {
+    switch (componentType) {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: return *src;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, src, 2); return v; }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: { uint32_t v; memcpy(&v, src, 4); return v; }
+        default: return UINT32_MAX;
+    }
+}
+
+// Decodes the first `components` components of every element as floats into
+// dst (dstStride floats apart), applying sparse substitution. The accessor
+// must hold at least `components` components and `expectedCount` elements.
+bool ReadFloats(const tinygltf::Model& model, int accessorIndex, size_t expectedCount, uint32_t components,
+                float* dst, size_t dstStride) {
+    AccessorView view;
+    if (!GetAccessorView(model, accessorIndex, view) || view.count != expectedCount || view.components < components) {
+        return false;
+    }
+
+    if (view.data) {
+        if (!ConvertRange(view.componentType, view.data, view.stride, view.count, components, view.normalized,
+                          dst, dstStride)) {
+            return false;
+        }
+    } else {
+        for (size_t i = 0; i < view.count; ++i) {
+            std::fill_n(dst + i * dstStride, components, 0.0f);
+        }
+    }
+
+    const tinygltf::Accessor::Sparse& sparse = model.accessors[accessorIndex].sparse;
+    if (!sparse.isSparse || sparse.count <= 0) {
+        return true;
+    }
+
+    const size_t sparseCount = static_cast<size_t>(sparse.count);
+    const int indexSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(sparse.indices.componentType));
+
+    size_t indexStride = 0, valueStride = 0;
+    const uint8_t* indexData = nullptr;
+    const uint8_t* valueData = nullptr;
+    if (indexSize <= 0 ||
+        !ResolveView(model, sparse.indices.bufferView, sparse.indices.byteOffset, indexSize, sparseCount,
+                     indexStride, indexData) ||
+        !ResolveView(model, sparse.values.bufferView, sparse.values.byteOffset, view.elementSize, sparseCount,
+                     valueStride, valueData)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sparseCount; ++i) {
+        const uint32_t target = ReadIndex(sparse.indices.componentType, indexData + i * indexStride);
+        if (target >= view.count) {
+            return false;
+        }
+        ConvertRange(view.componentType, valueData + i * valueStride, valueStride, 1, components, view.normalized,
+                     dst + target * dstStride, dstStride);
+    }
+    return true;
+}
+
+bool ReadIndices(const tinygltf::Model& model, int accessorIndex, std::vector<uint32_t>& outIndices) {
+    AccessorView view;
+    if (!GetAccessorView(model, accessorIndex, view) || !view.data || view.components != 1 ||
+        model.accessors[accessorIndex].sparse.isSparse) {
+        return false;
+    }
+
+    outIndices.resize(view.count);
+    switch (view.componentType) {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            for (size_t i = 0; i < view.count; ++i) outIndices[i] = view.data[i * view.stride];
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            for (size_t i = 0; i < view.count; ++i) {
+                uint16_t index;
+                memcpy(&index, view.data + i * view.stride, sizeof(index));
+                outIndices[i] = index;
+            }
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            if (view.stride == sizeof(uint32_t)) {
+                memcpy(outIndices.data(), view.data, view.count * sizeof(uint32_t));
+            } else {
+                for (size_t i = 0; i < view.count; ++i) {
+                    memcpy(&outIndices[i], view.data + i * view.stride, sizeof(uint32_t));
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Strips and fans become plain lists; anything but triangles is rejected
+bool Triangulate(int mode, std::vector<uint32_t>& indices) {
+    if (mode == TINYGLTF_MODE_TRIANGLES || mode == -1) {
+        indices.resize(indices.size() - indices.size() % 3);
+        return true;
+    }
+    if (indices.size() < 3) {
+        indices.clear();
+        return mode == TINYGLTF_MODE_TRIANGLE_STRIP || mode == TINYGLTF_MODE_TRIANGLE_FAN;
+    }
+
+    std::vector<uint32_t> list;
+    list.reserve((indices.size() - 2) * 3);
+    if (mode == TINYGLTF_MODE_TRIANGLE_STRIP) {
+        for (size_t i = 2; i < indices.size(); ++i) {
+            // Odd triangles swap to keep a consistent winding
+            const bool odd = (i & 1) != 0;
+            list.push_back(indices[i - 2]);
+            list.push_back(odd ? indices[i] : indices[i - 1]);
+            list.push_back(odd ? indices[i - 1] : indices[i]);
+        }
+    } else if (mode == TINYGLTF_MODE_TRIANGLE_FAN) {
+        for (size_t i = 2; i < indices.size(); ++i) {
+            list.push_back(indices[0]);
+            list.push_back(indices[i - 1]);
+            list.push_back(indices[i]);
+        }
+    } else {
+        return false;
+    }
+    indices.swap(list);
+    return true;
+}
+
+// =============================================================================
+// Primitive Conversion
+// =============================================================================
+
+int FindAttribute(const tinygltf::Primitive& primitive, const char* name) {
+    auto it = primitive.attributes.find(name);
+    return it != primitive.attributes.end() ? it->second : -1;
+}
+
+// Converts one primitive, safe to run concurrently with other primitives
+bool ConvertPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive,
+                      const GLTFImportSettings& settings, ImportedMesh& out) {
+    const int positionAccessor = FindAttribute(primitive, "POSITION");
+    if (positionAccessor < 0 || positionAccessor >= static_cast<int>(model.accessors.size())) {
+        return false;
+    }
+    const size_t vertexCount = model.accessors[positionAccessor].count;
+    if (vertexCount == 0 || vertexCount > UINT32_MAX) {
+        return false;
+    }
+
+    constexpr size_t vertexStride = sizeof(VertexAttributes) / sizeof(float);
+    out.vertices.resize(vertexCount);
+    float* vertexFloats = &out.vertices[0].position[0];
+
+    if (!ReadFloats(model, positionAccessor, vertexCount, 3, vertexFloats, vertexStride)) {
+        return false;
+    }
+
+    // Color: COLOR_0 (rgb of rgb/rgba) or white, tinted by the base color
+    const int colorAccessor = FindAttribute(primitive, "COLOR_0");
+    if (colorAccessor < 0 || !ReadFloats(model, colorAccessor, vertexCount, 3, vertexFloats + 3, vertexStride)) {
+        for (VertexAttributes& vertex : out.vertices) {
+            vertex.color[0] = vertex.color[1] = vertex.color[2] = 1.0f;
+        }
+    }
+    if (settings.applyBaseColor && primitive.material >= 0 &&
+        primitive.material < static_cast<int>(model.materials.size())) {
+        const std::vector<double>& factor = model.materials[primitive.material].pbrMetallicRoughness.baseColorFactor;
+        if (factor.size() >= 3 && (factor[0] != 1.0 || factor[1] != 1.0 || factor[2] != 1.0)) {
+            const float r = static_cast<float>(factor[0]);
+            const float g = static_cast<float>(factor[1]);
+            const float b = static_cast<float>(factor[2]);
+            for (VertexAttributes& vertex : out.vertices) {
+                vertex.color[0] *= r;
+                vertex.color[1] *= g;
+                vertex.color[2] *= b;
+            }
+        }
+    }
+
+    // Optional attributes are dropped rather than failing the primitive
+    const int normalAccessor = FindAttribute(primitive, "NORMAL");
+    if (normalAccessor >= 0) {
+        out.normals.resize(vertexCount * 3);
+        if (!ReadFloats(model, normalAccessor, vertexCount, 3, out.normals.data(), 3)) {
+            out.normals.clear();
+        }
+    }
+    const int uvAccessor = FindAttribute(primitive, "TEXCOORD_0");
+    if (uvAccessor >= 0) {
+        out.uvs.resize(vertexCount * 2);
+        if (!ReadFloats(model, uvAccessor, vertexCount, 2, out.uvs.data(), 2)) {
+            out.uvs.clear();
+        }
+    }
+
+    // Indices, generated for non-indexed primitives
+    if (primitive.indices >= 0) {
+        if (!ReadIndices(model, primitive.indices, out.indices)) {
+            return false;
+        }
+    } else {
+        out.indices.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) {
+            out.indices[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    if (!Triangulate(primitive.mode, out.indices) || out.indices.empty()) {
+        return false;
+    }
+    for (uint32_t index : out.indices) {
+        if (index >= vertexCount) {
+            return false;
+        }
+    }
+
+    if (settings.flipWinding) {
+        for (size_t i = 0; i < out.indices.size(); i += 3) {
+            std::swap(out.indices[i + 1], out.indices[i + 2]);
+        }
+    }
+
+    out.materialIndex = primitive.material < static_cast<int>(model.materials.size()) ? primitive.material : -1;
+    return true;
+}
+
+// =============================================================================
+// Materials, Images and Nodes
+// =============================================================================
+
+int TextureImage(const tinygltf::Model& model, int textureIndex) {
+    if (textureIndex < 0 || textureIndex >= static_cast<int>(model.textures.size())) {
+        return -1;
+    }
+    const int source = model.textures[textureIndex].source;
+    return source < static_cast<int>(model.images.size()) ? source : -1;
+}
+
+void ConvertMaterials(const tinygltf::Model& model, ImportedScene& scene) {
+    scene.materials.resize(model.materials.size());
+    for (size_t i = 0; i < model.materials.size(); ++i) {
+        const tinygltf::Material& source = model.materials[i];
+        ImportedMaterial& material = scene.materials[i];
+
+        material.name = source.name;
+        const tinygltf::PbrMetallicRoughness& pbr = source.pbrMetallicRoughness;
+        for (size_t c = 0; c < 4 && c < pbr.baseColorFactor.size(); ++c) {
+            material.baseColorFactor[c] = static_cast<float>(pbr.baseColorFactor[c]);
+        }
+        for (size_t c = 0; c < 3 && c < source.emissiveFactor.size(); ++c) {
+            material.emissiveFactor[c] = static_cast<float>(source.emissiveFactor[c]);
+        }
+        material.metallicFactor = static_cast<float>(pbr.metallicFactor);
+        material.roughnessFactor = static_cast<float>(pbr.roughnessFactor);
+
+        material.albedoImage = TextureImage(model, pbr.baseColorTexture.index);
+        material.normalImage = TextureImage(model, source.normalTexture.index);
+        material.mraoImage = TextureImage(model, pbr.metallicRoughnessTexture.index);
+        material.emissiveImage = TextureImage(model, source.emissiveTexture.index);
+    }
+}
+
+void MoveImages(tinygltf::Model& model, ImportedScene& scene) {
+    scene.images.resize(model.images.size());
+    for (size_t i = 0; i < model.images.size(); ++i) {
+        tinygltf::Image& source = model.images[i];
+        ImportedImage& image = scene.images[i];
+        image.name = source.name;
+        image.uri = source.uri;
+        image.mimeType = source.mimeType;
+        // Loaded as-is, so this holds the encoded file, not pixels
+        image.encoded = std::move(source.image);
+    }
+}
+
+void SetNodeTransform(const tinygltf::Node& node, SceneData& data) {
+    glm::vec3 translation(0.0f);
+    glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale(1.0f);
+
+    if (node.matrix.size() == 16) {
+        glm::mat4 matrix;
+        for (int i = 0; i < 16; ++i) {
+            glm::value_ptr(matrix)[i] = static_cast<float>(node.matrix[i]);  // Both column-major
+        }
+        glm::vec3 skew;
+        glm::vec4 perspective;
+        glm::decompose(matrix, scale, rotation, translation, skew, perspective);
+    } else {
+        if (node.translation.size() == 3) {
+            translation = glm::vec3(node.translation[0], node.translation[1], node.translation[2]);
+        }
+        if (node.rotation.size() == 4) {
+            // glTF stores xyzw
+            rotation = glm::quat(static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]),
+                                 static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2]));
+        }
+        if (node.scale.size() == 3) {
+            scale = glm::vec3(node.scale[0], node.scale[1], node.scale[2]);
+        }
+    }
+
+    data.position = translation;
+    data.scale = scale;
+    data.eulerAngles = glm::degrees(glm::eulerAngles(glm::normalize(rotation)));
+}
+
+// Node i of the glTF becomes scene node i; extra primitives of a node are
+// appended as children after all glTF nodes
+bool ConvertNodes(const tinygltf::Model& model, const std::vector<uint32_t>& meshFirstPrimitive,
+                  const std::vector<int>& primitiveRemap, ImportedScene& scene) {
+    const size_t nodeCount = model.nodes.size();
+    scene.nodes.resize(nodeCount);
+
+    std::vector<int> parentOf(nodeCount, -1);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        for (int child : model.nodes[i].children) {
+            if (child < 0 || child >= static_cast<int>(nodeCount) || parentOf[child] != -1 ||
+                child == static_cast<int>(i)) {
+                printf("GLTFImporter: Node %zu has an invalid or shared child %d\n", i, child);
+                return false;
+            }
+            parentOf[child] = static_cast<int>(i);
+        }
+    }
+
+    for (size_t i = 0; i < nodeCount; ++i) {
+        const tinygltf::Node& node = model.nodes[i];
+        scene.nodes[i].name = node.name.empty() ? "Node " + std::to_string(i) : node.name;
+        SetNodeTransform(node, scene.nodes[i]);
+        for (int child : node.children) {
+            scene.nodes[i].children.push_back(static_cast<size_t>(child));
+        }
+
+        if (node.mesh < 0 || node.mesh >= static_cast<int>(model.meshes.size())) {
+            continue;
+        }
+
+        const uint32_t first = meshFirstPrimitive[node.mesh];
+        const size_t primitiveCount = model.meshes[node.mesh].primitives.size();
+        if (primitiveCount == 1) {
+            scene.nodes[i].meshIndex = primitiveRemap[first];
+            continue;
+        }
+        for (size_t p = 0; p < primitiveCount; ++p) {
+            if (primitiveRemap[first + p] < 0) {
+                continue;
+            }
+            SceneData primitiveNode;
+            primitiveNode.name = scene.nodes[i].name + " [" + std::to_string(p) + "]";
+            primitiveNode.meshIndex = primitiveRemap[first + p];
+            scene.nodes[i].children.push_back(scene.nodes.size());
+            scene.nodes.push_back(std::move(primitiveNode));
+        }
+    }
+
+    // Roots of the default scene, or every parentless node without one
+    const int sceneIndex = model.defaultScene >= 0 ? model.defaultScene : 0;
+    if (sceneIndex < static_cast<int>(model.scenes.size())) {
+        for (int root : model.scenes[sceneIndex].nodes) {
+            if (root >= 0 && root < static_cast<int>(nodeCount) && parentOf[root] == -1) {
+                scene.rootNodes.push_back(static_cast<size_t>(root));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < nodeCount; ++i) {
+            if (parentOf[i] == -1) {
+                scene.rootNodes.push_back(i);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+CPUMesh ImportedMesh::GetCPUMesh() const {
+    CPUMesh mesh;
+    mesh.vertices = vertices.data();
+    mesh.indices = indices.data();
+    mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+    mesh.indexCount = static_cast<uint32_t>(indices.size());
+    mesh.normals = normals.empty() ? nullptr : normals.data();
+    mesh.uvs = uvs.empty() ? nullptr : uvs.data();
+    return mesh;
+}
+
+// =============================================================================
+// Import
+// =============================================================================
+
+bool GLTFImporter::Import(const std::string& path, ImportedScene& outScene, JobSystem* jobSystem,
+                          const GLTFImportSettings& settings, Statistics* outStats) {
+    Statistics stats;
+    outScene = ImportedScene();
+
+    // Parse
+    const Clock::time_point parseStart = Clock::now();
+    tinygltf::Model model;
+    tinygltf::TinyGLTF loader;
+    loader.SetImagesAsIs(true);
+
+    std::string error;
+    std::string warning;
+    const bool binary = path.size() >= 4 && (path.compare(path.size() - 4, 4, ".glb") == 0 ||
+                                             path.compare(path.size() - 4, 4, ".GLB") == 0);
+    const bool loaded = binary ? loader.LoadBinaryFromFile(&model, &error, &warning, path)
+                               : loader.LoadASCIIFromFile(&model, &error, &warning, path);
+    if (!warning.empty()) {
+        printf("GLTFImporter: %s", warning.c_str());
+    }
+    if (!loaded) {
+        printf("GLTFImporter: Failed to load '%s': %s\n", path.c_str(), error.c_str());
+        return false;
+    }
+    stats.parseMs = ElapsedMs(parseStart);
+
+    // Convert, one job per primitive
+    const Clock::time_point convertStart = Clock::now();
+
+    struct PrimitiveRef {
+        uint32_t mesh;
+        uint32_t primitive;
+    };
+    std::vector<PrimitiveRef> primitives;
+    std::vector<uint32_t> meshFirstPrimitive(model.meshes.size());
+    for (size_t m = 0; m < model.meshes.size(); ++m) {
+        meshFirstPrimitive[m] = static_cast<uint32_t>(primitives.size());
+        for (size_t p = 0; p < model.meshes[m].primitives.size(); ++p) {
+            primitives.push_back({ static_cast<uint32_t>(m), static_cast<uint32_t>(p) });
+        }
+    }
+
+    std::vector<ImportedMesh> converted(primitives.size());
+    std::vector<uint8_t> succeeded(primitives.size(), 0);
+    auto convert = [&](uint32_t i) {
+        const tinygltf::Mesh& mesh = model.meshes[primitives[i].mesh];
+        ImportedMesh& out = converted[i];
+        out.name = mesh.primitives.size() > 1 ? mesh.name + " [" + std::to_string(primitives[i].primitive) + "]"
+                                              : mesh.name;
+        succeeded[i] = ConvertPrimitive(model, mesh.primitives[primitives[i].primitive], settings, out) ? 1 : 0;
+        if (!succeeded[i]) {
+            out = ImportedMesh();
+        }
+    };
+    if (jobSystem) {
+        jobSystem->ParallelFor(static_cast<uint32_t>(primitives.size()), convert);
+    } else {
+        for (uint32_t i = 0; i < primitives.size(); ++i) {
+            convert(i);
+        }
+    }
+
+    // Compact away primitives that failed or aren't triangles
+    std::vector<int> primitiveRemap(primitives.size(), -1);
+    outScene.meshes.reserve(primitives.size());
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        if (!succeeded[i]) {
+            printf("GLTFImporter: Skipped mesh %u primitive %u (unsupported or invalid)\n",
+                   primitives[i].mesh, primitives[i].primitive);
+            stats.skippedPrimitives++;
+            continue;
+        }
+        stats.vertices += converted[i].vertices.size();
+        stats.triangles += converted[i].indices.size() / 3;
+        primitiveRemap[i] = static_cast<int>(outScene.meshes.size());
+        outScene.meshes.push_back(std::move(converted[i]));
+    }
+    stats.primitives = static_cast<uint32_t>(outScene.meshes.size());
+
+    ConvertMaterials(model, outScene);
+    MoveImages(model, outScene);
+    if (!ConvertNodes(model, meshFirstPrimitive, primitiveRemap, outScene)) {
+        outScene = ImportedScene();
+        return false;
+    }
+    stats.convertMs = ElapsedMs(convertStart);
+
+    if (outStats) {
+        *outStats = stats;
+    }
+    return true;
+}
+
+// =============================================================================
+// Statistics and Debug
+// =============================================================================
+
+void GLTFImporter::PrintStats(const std::string& path, const ImportedScene& scene, const Statistics& stats) {
+    printf("=== GLTFImporter: %s ===\n", path.c_str());
+    printf("Meshes: %u (%u skipped)\n", stats.primitives, stats.skippedPrimitives);
+    printf("Vertices: %llu, Triangles: %llu\n", static_cast<unsigned long long>(stats.vertices),
+           static_cast<unsigned long long>(stats.triangles));
+    printf("Nodes: %zu (%zu roots), Materials: %zu, Images: %zu\n", scene.nodes.size(), scene.rootNodes.size(),
+           scene.materials.size(), scene.images.size());
+    printf("Parse: %.2f ms, Convert: %.2f ms\n", stats.parseMs, stats.convertMs);
+    printf("===========================\n");
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "resources/RenderTypes.h"
+#include "sceneutils/SceneData.h"
+
+class JobSystem;
+
+// =============================================================================
+// Imported Data
+// =============================================================================
+
+// One glTF primitive converted to engine layout. Owns its arrays; GetCPUMesh
+// returns a view that is valid while the ImportedMesh is alive.
+struct ImportedMesh {
+    std::string name;
+    std::vector<VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<float> normals;     // Empty when the primitive has none
+    std::vector<float> uvs;         // Empty when the primitive has none
+    int materialIndex = -1;         // Into ImportedScene::materials
+
+    CPUMesh GetCPUMesh() const;
+};
+
+// glTF metallic-roughness material. Texture slots index ImportedScene::images
+// until a texture manager turns them into the handles of `material`.
+struct ImportedMaterial {
+    std::string name;
+    Material material;
+
+    float baseColorFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float emissiveFactor[3] = { 0.0f, 0.0f, 0.0f };
+    float metallicFactor = 1.0f;
+    float roughnessFactor = 1.0f;
+
+    int albedoImage = -1;
+    int normalImage = -1;
+    int mraoImage = -1;             // metallicRoughness, glTF packs AO separately
+    int emissiveImage = -1;
+};
+
+// Image source left undecoded: either a path relative to the glTF file or
+// the encoded bytes of an image embedded in a buffer / data URI.
+struct ImportedImage {
+    std::string name;
+    std::string uri;
+    std::string mimeType;
+    std::vector<uint8_t> encoded;
+};
+
+// Nodes are SceneData in the engine's own convention (local transform, euler
+// degrees). A node with several primitives gets one child node per primitive
+// so every node draws at most one mesh.
+struct ImportedScene {
+    std::vector<ImportedMesh> meshes;
+    std::vector<ImportedMaterial> materials;
+    std::vector<ImportedImage> images;
+    std::vector<SceneData> nodes;
+    std::vector<size_t> rootNodes;
+};
+
+// =============================================================================
+// glTF Importer
+// =============================================================================
+
+struct GLTFImportSettings {
+    // glTF front faces are counter-clockwise, ours are clockwise
+    bool flipWinding = true;
+    // Bake baseColorFactor into the vertex colors (no material system yet)
+    bool applyBaseColor = true;
+};
+
+// Loads .gltf/.glb through tinygltf. Images are not decoded here, only their
+// source is kept. Accessor decoding and attribute conversion run per
+// primitive, spread over the job system when one is given.
+class GLTFImporter {
+public:
+    struct Statistics {
+        double parseMs = 0.0;
+        double convertMs = 0.0;
+        uint32_t primitives = 0;
+        uint32_t skippedPrimitives = 0;
+        uint64_t vertices = 0;
+        uint64_t triangles = 0;
+    };
+
+    static bool Import(const std::string& path, ImportedScene& outScene, JobSystem* jobSystem = nullptr,
+                       const GLTFImportSettings& settings = GLTFImportSettings(), Statistics* outStats = nullptr);
+
+    static void PrintStats(const std::string& path, const ImportedScene& scene, const Statistics& stats);
+};
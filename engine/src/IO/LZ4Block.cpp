@@ -0,0 +1,186 @@
+#include "LZ4Block.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;        // The block always ends in at least 5 literals
+constexpr size_t MATCH_FIND_LIMIT = 12;    // No match may start in the last 12 bytes
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_BITS = 16;
+constexpr uint32_t SKIP_TRIGGER = 6;       // Step faster through data that doesn't match
+
+uint32_t Read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Length continuation bytes after a saturated 4-bit field
+uint8_t* WriteLength(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        op = WriteLength(op, literalLength - 15);
+    }
+    memcpy(op, literals, literalLength);
+    op += literalLength;
+
+    // The last sequence carries literals only
+    if (matchLength == 0) {
+        return op;
+    }
+
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    const size_t length = matchLength - MIN_MATCH;
+    *token |= static_cast<uint8_t>(std::min<size_t>(length, 15));
+    if (length >= 15) {
+        op = WriteLength(op, length - 15);
+    }
+    return op;
+}
+
+} // namespace
+
+size_t LZ4CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t LZ4CompressBlock(const uint8_t* src, size_t size, uint8_t* dst) {
+    uint8_t* op = dst;
+    const uint8_t* anchor = src;
+
+    if (size > MATCH_FIND_LIMIT) {
+        // Positions relative to src, stale or colliding entries fail the compare below
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+
+        const uint8_t* ip = src + 1;
+        const uint8_t* matchLimit = src + size - LAST_LITERALS;
+        const uint8_t* findLimit = src + size - MATCH_FIND_LIMIT;
+        uint32_t misses = 0;
+
+        while (ip < findLimit) {
+            const uint32_t sequence = Read32(ip);
+            const uint32_t hash = Hash(sequence);
+            const uint8_t* ref = src + table[hash];
+            table[hash] = static_cast<uint32_t>(ip - src);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || Read32(ref) != sequence) {
+                ip += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+            misses = 0;
+
+            // Extend backwards into pending literals, then forwards
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+            size_t matchLength = MIN_MATCH;
+            while (ip + matchLength < matchLimit && ip[matchLength] == ref[matchLength]) {
+                ++matchLength;
+            }
+
+            op = WriteSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), matchLength);
+            ip += matchLength;
+            anchor = ip;
+
+            // Keep the table warm across the skipped span
+            if (ip < findLimit) {
+                table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+            }
+        }
+    }
+
+    op = WriteSequence(op, anchor, static_cast<size_t>(src + size - anchor), 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+bool LZ4DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* ipEnd = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* opEnd = dst + dstSize;
+
+    while (true) {
+        if (ip >= ipEnd) {
+            return false;
+        }
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(ip, ipEnd, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(ipEnd - ip) || literalLength > static_cast<size_t>(opEnd - op)) {
+            return false;
+        }
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == ipEnd) {
+            break;
+        }
+
+        if (ipEnd - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(ip, ipEnd, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > static_cast<size_t>(opEnd - op)) {
+            return false;
+        }
+
+        // Overlapping matches repeat the last offset bytes, copy forwards
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            memcpy(op, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) {
+                op[i] = match[i];
+            }
+        }
+        op += matchLength;
+    }
+
+    return op == opEnd;
+}
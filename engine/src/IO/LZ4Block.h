@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// =============================================================================
+// LZ4 Block Compression
+// =============================================================================
+
+// Raw LZ4 block format (no frame header or checksum), so blocks interoperate
+// with the reference implementation. The compressor is the greedy single
+// hash table variant: fast, ratio close to LZ4's default level.
+
+// Worst case compressed size for size input bytes
+size_t LZ4CompressBound(size_t size);
+
+// Compresses src into dst, which must hold LZ4CompressBound(size) bytes.
+// Returns the compressed size.
+size_t LZ4CompressBlock(const uint8_t* src, size_t size, uint8_t* dst);
+
+// Decompresses exactly dstSize bytes. Returns false on malformed input
+// instead of reading or writing out of bounds.
+bool LZ4DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// =============================================================================
+// Mapped File
+// =============================================================================
+
+// Read-only memory mapping of a whole file. Pages are faulted in by the OS on
+// first touch, so opening is cheap regardless of size and untouched parts of
+// the file are never read. The view stays valid until Close or destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Prevent copying, allow moving
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;         // HANDLE
+    void* m_mapping = nullptr;      // HANDLE
+#else
+    int m_file = -1;
+#endif
+};
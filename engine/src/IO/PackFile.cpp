@@ -0,0 +1,321 @@
+#include "PackFile.h"
+#include "LZ4Block.h"
+#include "FileIOService.h"
+#include "resources/ContentHash.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool EntryLess(const PackEntry& a, std::string_view nameA, const PackEntry& b, std::string_view nameB) {
+    return a.pathHash != b.pathHash ? a.pathHash < b.pathHash : nameA < nameB;
+}
+
+} // namespace
+
+std::string NormalizePackPath(std::string_view path) {
+    std::vector<std::string_view> segments;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+        const std::string_view segment = path.substr(start, end - start);
+        start = end + 1;
+
+        if (segment.empty() || segment == ".") {
+            continue;
+        }
+        // Leading ".." segments stay, they point outside the root
+        if (segment == ".." && !segments.empty() && segments.back() != "..") {
+            segments.pop_back();
+            continue;
+        }
+        segments.push_back(segment);
+    }
+
+    std::string normalized;
+    normalized.reserve(path.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (i > 0) {
+            normalized += '/';
+        }
+        normalized += segments[i];
+    }
+    return normalized;
+}
+
+uint64_t HashPackPath(std::string_view normalizedPath) {
+    return HashBytes(normalizedPath.data(), normalizedPath.size());
+}
+
+// =============================================================================
+// Pack Writer
+// =============================================================================
+
+void PackWriter::AddFile(const std::string& packPath, const std::string& diskPath, bool compress) {
+    Source source;
+    source.path = NormalizePackPath(packPath);
+    source.diskPath = diskPath;
+    source.compress = compress;
+    m_sources.push_back(std::move(source));
+}
+
+void PackWriter::AddData(const std::string& packPath, std::vector<uint8_t> data, bool compress) {
+    Source source;
+    source.path = NormalizePackPath(packPath);
+    source.data = std::move(data);
+    source.compress = compress;
+    m_sources.push_back(std::move(source));
+}
+
+bool PackWriter::Write(const std::string& outputPath, Statistics* stats) const {
+    // Later additions of the same path replace earlier ones
+    std::vector<size_t> order(m_sources.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return m_sources[a].path < m_sources[b].path;
+    });
+    std::vector<size_t> unique;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i + 1 < order.size() && m_sources[order[i]].path == m_sources[order[i + 1]].path) {
+            continue;
+        }
+        unique.push_back(order[i]);
+    }
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        printf("PackWriter: Failed to create '%s'\n", outputPath.c_str());
+        return false;
+    }
+
+    uint64_t written = 0;
+    auto write = [&](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), size);
+        written += size;
+    };
+    auto pad = [&](uint64_t alignment) {
+        static const char zeros[PACK_ALIGNMENT] = {};
+        const uint64_t target = AlignUp(written, alignment);
+        write(zeros, static_cast<size_t>(target - written));
+    };
+
+    PackHeader header = {};
+    write(&header, sizeof(header));
+
+    Statistics result;
+    std::vector<PackEntry> entries;
+    std::string names;
+    entries.reserve(unique.size());
+
+    std::vector<uint8_t> loaded;
+    std::vector<uint8_t> compressed;
+    for (size_t index : unique) {
+        const Source& source = m_sources[index];
+
+        const std::vector<uint8_t>* data = &source.data;
+        if (!source.diskPath.empty()) {
+            if (!FileIOService::ReadWholeFile(source.diskPath, loaded)) {
+                printf("PackWriter: Failed to read '%s'\n", source.diskPath.c_str());
+                return false;
+            }
+            data = &loaded;
+        }
+
+        PackEntry entry = {};
+        entry.pathHash = HashPackPath(source.path);
+        entry.size = data->size();
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(source.path.size());
+        names += source.path;
+
+        const uint8_t* stored = data->data();
+        entry.storedSize = data->size();
+        entry.compression = PackCompression::None;
+
+        // Block positions are 32-bit, larger entries stay raw
+        if (source.compress && !data->empty() && data->size() < UINT32_MAX) {
+            compressed.resize(LZ4CompressBound(data->size()));
+            const size_t compressedSize = LZ4CompressBlock(data->data(), data->size(), compressed.data());
+            if (compressedSize <= data->size() - data->size() / 8) {
+                stored = compressed.data();
+                entry.storedSize = compressedSize;
+                entry.compression = PackCompression::LZ4;
+                result.compressedEntries++;
+            }
+        }
+
+        pad(PACK_ALIGNMENT);
+        entry.offset = written;
+        write(stored, static_cast<size_t>(entry.storedSize));
+        entries.push_back(entry);
+
+        result.sourceBytes += entry.size;
+        result.storedBytes += entry.storedSize;
+    }
+
+    // Lookup order
+    std::vector<uint32_t> sorted(entries.size());
+    for (uint32_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+        const PackEntry& ea = entries[a];
+        const PackEntry& eb = entries[b];
+        return EntryLess(ea, std::string_view(names).substr(ea.nameOffset, ea.nameLength),
+                         eb, std::string_view(names).substr(eb.nameOffset, eb.nameLength));
+    });
+
+    pad(alignof(PackEntry));
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.tocOffset = written;
+    for (uint32_t index : sorted) {
+        write(&entries[index], sizeof(PackEntry));
+    }
+    header.namesOffset = written;
+    header.namesSize = names.size();
+    write(names.data(), names.size());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        printf("PackWriter: Failed to write '%s'\n", outputPath.c_str());
+        return false;
+    }
+
+    result.entries = header.entryCount;
+    result.fileSize = written;
+    if (stats) {
+        *stats = result;
+    }
+    return true;
+}
+
+// =============================================================================
+// Pack File
+// =============================================================================
+
+bool PackFile::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.GetData();
+    const uint64_t size = m_file.GetSize();
+
+    PackHeader header;
+    if (size < sizeof(header)) {
+        printf("PackFile: '%s' is too small\n", path.c_str());
+        Close();
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != PACK_MAGIC || header.version != PACK_VERSION) {
+        printf("PackFile: '%s' is not a version %u pack\n", path.c_str(), PACK_VERSION);
+        Close();
+        return false;
+    }
+
+    const uint64_t tocSize = static_cast<uint64_t>(header.entryCount) * sizeof(PackEntry);
+    if (header.tocOffset % alignof(PackEntry) != 0 || header.tocOffset > size || tocSize > size - header.tocOffset ||
+        header.namesOffset > size || header.namesSize > size - header.namesOffset) {
+        printf("PackFile: '%s' is truncated\n", path.c_str());
+        Close();
+        return false;
+    }
+
+    const PackEntry* entries = reinterpret_cast<const PackEntry*>(data + header.tocOffset);
+    const char* names = reinterpret_cast<const char*>(data + header.namesOffset);
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        const bool inBounds = entry.offset <= size && entry.storedSize <= size - entry.offset &&
+                              static_cast<uint64_t>(entry.nameOffset) + entry.nameLength <= header.namesSize;
+        const bool validCompression = entry.compression == PackCompression::LZ4 ||
+                                      (entry.compression == PackCompression::None && entry.storedSize == entry.size);
+        const bool ordered = i == 0 ||
+            !EntryLess(entry, std::string_view(names + entry.nameOffset, entry.nameLength),
+                       entries[i - 1], std::string_view(names + entries[i - 1].nameOffset, entries[i - 1].nameLength));
+        if (!inBounds || !validCompression || !ordered) {
+            printf("PackFile: '%s' entry %u is corrupt\n", path.c_str(), i);
+            Close();
+            return false;
+        }
+    }
+
+    m_path = path;
+    m_entries = entries;
+    m_names = names;
+    m_entryCount = header.entryCount;
+    return true;
+}
+
+void PackFile::Close() {
+    m_file.Close();
+    m_path.clear();
+    m_entries = nullptr;
+    m_names = nullptr;
+    m_entryCount = 0;
+}
+
+uint32_t PackFile::Find(std::string_view normalizedPath) const {
+    const uint64_t hash = HashPackPath(normalizedPath);
+    const PackEntry* end = m_entries + m_entryCount;
+    const PackEntry* it = std::lower_bound(m_entries, end, hash, [](const PackEntry& entry, uint64_t value) {
+        return entry.pathHash < value;
+    });
+    for (; it != end && it->pathHash == hash; ++it) {
+        const uint32_t index = static_cast<uint32_t>(it - m_entries);
+        if (GetEntryName(index) == normalizedPath) {
+            return index;
+        }
+    }
+    return INVALID_ENTRY;
+}
+
+std::string_view PackFile::GetEntryName(uint32_t index) const {
+    const PackEntry& entry = m_entries[index];
+    return std::string_view(m_names + entry.nameOffset, entry.nameLength);
+}
+
+const uint8_t* PackFile::GetStoredData(uint32_t index) const {
+    return m_file.GetData() + m_entries[index].offset;
+}
+
+bool PackFile::Read(uint32_t index, uint8_t* dst) const {
+    const PackEntry& entry = m_entries[index];
+    const uint8_t* stored = GetStoredData(index);
+
+    if (entry.compression == PackCompression::None) {
+        memcpy(dst, stored, static_cast<size_t>(entry.size));
+        return true;
+    }
+    if (!LZ4DecompressBlock(stored, static_cast<size_t>(entry.storedSize), dst, static_cast<size_t>(entry.size))) {
+        printf("PackFile: '%s' entry '%.*s' failed to decompress\n", m_path.c_str(),
+               static_cast<int>(entry.nameLength), m_names + entry.nameOffset);
+        return false;
+    }
+    return true;
+}
+
+bool PackFile::Read(uint32_t index, std::vector<uint8_t>& out) const {
+    out.resize(static_cast<size_t>(m_entries[index].size));
+    if (!out.empty() && !Read(index, out.data())) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
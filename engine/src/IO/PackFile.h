@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+// =============================================================================
+// Pack File Format
+// =============================================================================
+
+// One file holding many assets, so startup opens (and the OS caches) a single
+// handle instead of thousands. Layout:
+//   PackHeader, padded to PACK_ALIGNMENT
+//   entry data, each entry starting on a PACK_ALIGNMENT boundary
+//   PackEntry table sorted by (pathHash, path)
+//   path strings, not null terminated
+// Uncompressed entries are served straight from the mapping. Compressed
+// entries are a single LZ4 block and decompress into the caller's buffer.
+constexpr uint32_t PACK_MAGIC = 0x50334544;        // "DE3P"
+constexpr uint32_t PACK_VERSION = 1;
+constexpr uint64_t PACK_ALIGNMENT = 4096;
+
+enum class PackCompression : uint32_t {
+    None = 0,
+    LZ4 = 1,
+};
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct PackEntry {
+    uint64_t pathHash;              // HashBytes of the normalized path
+    uint64_t offset;
+    uint64_t storedSize;            // Bytes in the pack
+    uint64_t size;                  // Bytes once decompressed
+    uint32_t nameOffset;            // Into the path strings
+    uint32_t nameLength;
+    PackCompression compression;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 40, "PackHeader layout is part of the file format");
+static_assert(sizeof(PackEntry) == 48, "PackEntry layout is part of the file format");
+
+// Forward slashes, no empty, "." or resolvable ".." segments. Pack paths and
+// VFS lookups both go through this, lookups are case sensitive.
+std::string NormalizePackPath(std::string_view path);
+
+uint64_t HashPackPath(std::string_view normalizedPath);
+
+// =============================================================================
+// Pack Writer
+// =============================================================================
+
+class PackWriter {
+public:
+    struct Statistics {
+        uint32_t entries = 0;
+        uint32_t compressedEntries = 0;
+        uint64_t sourceBytes = 0;
+        uint64_t storedBytes = 0;
+        uint64_t fileSize = 0;
+    };
+
+    // Source files are read when Write runs. Compression is kept only where
+    // it saves at least an eighth of the entry.
+    void AddFile(const std::string& packPath, const std::string& diskPath, bool compress);
+    void AddData(const std::string& packPath, std::vector<uint8_t> data, bool compress);
+
+    bool Write(const std::string& outputPath, Statistics* stats = nullptr) const;
+
+    size_t GetEntryCount() const { return m_sources.size(); }
+
+private:
+    struct Source {
+        std::string path;           // Normalized
+        std::string diskPath;       // Empty when data is inline
+        std::vector<uint8_t> data;
+        bool compress = false;
+    };
+
+    std::vector<Source> m_sources;
+};
+
+// =============================================================================
+// Pack File
+// =============================================================================
+
+// Read-only view of a pack. Lookups and reads are safe from any thread while
+// the pack stays open.
+class PackFile {
+public:
+    static constexpr uint32_t INVALID_ENTRY = UINT32_MAX;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    uint32_t GetEntryCount() const { return m_entryCount; }
+    const std::string& GetPath() const { return m_path; }
+
+    // Binary search on the path hash, INVALID_ENTRY when absent
+    uint32_t Find(std::string_view normalizedPath) const;
+
+    const PackEntry& GetEntry(uint32_t index) const { return m_entries[index]; }
+    std::string_view GetEntryName(uint32_t index) const;
+
+    // Stored bytes in the mapping, the entry itself when uncompressed
+    const uint8_t* GetStoredData(uint32_t index) const;
+
+    // Entry contents into dst, which holds GetEntry(index).size bytes
+    bool Read(uint32_t index, uint8_t* dst) const;
+    bool Read(uint32_t index, std::vector<uint8_t>& out) const;
+
+private:
+    MappedFile m_file;
+    std::string m_path;
+    const PackEntry* m_entries = nullptr;
+    const char* m_names = nullptr;
+    uint32_t m_entryCount = 0;
+};
@@ -0,0 +1,6 @@
+// stb_image and stb_image_write live in this translation unit only, shared by
+// the glTF importer and the texture cooker
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "tinygltf-2.9.6/stb_image.h"
+#include "tinygltf-2.9.6/stb_image_write.h"
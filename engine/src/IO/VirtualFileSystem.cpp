@@ -0,0 +1,170 @@
+#include "VirtualFileSystem.h"
+#include "FileIOService.h"
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+// Path relative to the mount point, false when the path is outside it
+bool MakeRelative(const std::string& path, const std::string& mountPoint, std::string& relative) {
+    if (mountPoint.empty()) {
+        relative = path;
+        return true;
+    }
+    if (path.compare(0, mountPoint.size(), mountPoint) != 0) {
+        return false;
+    }
+    if (path.size() == mountPoint.size()) {
+        relative.clear();
+        return true;
+    }
+    if (path[mountPoint.size()] != '/') {
+        return false;
+    }
+    relative = path.substr(mountPoint.size() + 1);
+    return true;
+}
+
+} // namespace
+
+bool FileView::OpenFile(const std::string& diskPath) {
+    *this = FileView();
+    if (!m_mapped.Open(diskPath)) {
+        return false;
+    }
+    m_data = m_mapped.GetData();
+    m_size = m_mapped.GetSize();
+    m_valid = true;
+    return true;
+}
+
+// =============================================================================
+// Virtual File System
+// =============================================================================
+
+bool VirtualFileSystem::MountPack(const std::string& packPath, const std::string& mountPoint) {
+    auto pack = std::make_unique<PackFile>();
+    if (!pack->Open(packPath)) {
+        return false;
+    }
+
+    Mount mount;
+    mount.mountPoint = NormalizePackPath(mountPoint);
+    mount.pack = std::move(pack);
+    m_mounts.push_back(std::move(mount));
+    return true;
+}
+
+void VirtualFileSystem::MountDirectory(const std::string& directory, const std::string& mountPoint) {
+    Mount mount;
+    mount.mountPoint = NormalizePackPath(mountPoint);
+    mount.directory = directory;
+    m_mounts.push_back(std::move(mount));
+}
+
+void VirtualFileSystem::UnmountAll() {
+    m_mounts.clear();
+}
+
+bool VirtualFileSystem::Resolve(const std::string& path, Location& location) const {
+    const std::string normalized = NormalizePackPath(path);
+    std::string relative;
+
+    for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it) {
+        if (!MakeRelative(normalized, it->mountPoint, relative) || relative.empty()) {
+            continue;
+        }
+
+        if (it->pack) {
+            const uint32_t entry = it->pack->Find(relative);
+            if (entry != PackFile::INVALID_ENTRY) {
+                location.mount = &*it;
+                location.entry = entry;
+                return true;
+            }
+        } else {
+            std::filesystem::path diskPath = std::filesystem::path(it->directory) / relative;
+            std::error_code error;
+            if (std::filesystem::is_regular_file(diskPath, error)) {
+                location.mount = &*it;
+                location.diskPath = diskPath.string();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) const {
+    Location location;
+    return Resolve(path, location);
+}
+
+template <typename Container>
+bool VirtualFileSystem::ReadInto(const std::string& path, Container& out) const {
+    Location location;
+    if (!Resolve(path, location)) {
+        return false;
+    }
+    if (!location.mount->pack) {
+        return FileIOService::ReadWholeFile(location.diskPath, out);
+    }
+
+    const PackFile& pack = *location.mount->pack;
+    out.resize(static_cast<size_t>(pack.GetEntry(location.entry).size));
+    if (!out.empty() && !pack.Read(location.entry, reinterpret_cast<uint8_t*>(&out[0]))) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool VirtualFileSystem::ReadFile(const std::string& path, std::vector<uint8_t>& out) const {
+    return ReadInto(path, out);
+}
+
+bool VirtualFileSystem::ReadFile(const std::string& path, std::string& out) const {
+    return ReadInto(path, out);
+}
+
+bool VirtualFileSystem::OpenView(const std::string& path, FileView& view) const {
+    view = FileView();
+
+    Location location;
+    if (!Resolve(path, location)) {
+        return false;
+    }
+
+    if (!location.mount->pack) {
+        return view.OpenFile(location.diskPath);
+    }
+
+    const PackFile& pack = *location.mount->pack;
+    const PackEntry& entry = pack.GetEntry(location.entry);
+    if (entry.compression == PackCompression::None) {
+        view.m_data = pack.GetStoredData(location.entry);
+    } else {
+        if (!pack.Read(location.entry, view.m_bytes)) {
+            return false;
+        }
+        view.m_data = view.m_bytes.data();
+    }
+    view.m_size = static_cast<size_t>(entry.size);
+    view.m_valid = true;
+    return true;
+}
+
+void VirtualFileSystem::PrintMounts() const {
+    printf("=== VirtualFileSystem ===\n");
+    for (size_t i = 0; i < m_mounts.size(); ++i) {
+        const Mount& mount = m_mounts[i];
+        const char* mountPoint = mount.mountPoint.empty() ? "/" : mount.mountPoint.c_str();
+        if (mount.pack) {
+            printf("  %zu: %s <- pack %s (%u entries)\n", i, mountPoint, mount.pack->GetPath().c_str(),
+                   mount.pack->GetEntryCount());
+        } else {
+            printf("  %zu: %s <- directory %s\n", i, mountPoint, mount.directory.c_str());
+        }
+    }
+    printf("=========================\n");
+}
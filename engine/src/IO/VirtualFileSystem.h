@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "PackFile.h"
+
+// =============================================================================
+// File View
+// =============================================================================
+
+// Read-only bytes of one file: a mapped loose file, an uncompressed pack
+// entry served from the pack mapping, or a decompressed copy. Pack views stay
+// valid while the pack is mounted.
+class FileView {
+public:
+    // Maps a loose file directly, bypassing any mounts
+    bool OpenFile(const std::string& diskPath);
+
+    bool IsValid() const { return m_valid; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    friend class VirtualFileSystem;
+
+    MappedFile m_mapped;
+    std::vector<uint8_t> m_bytes;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_valid = false;
+};
+
+// =============================================================================
+// Virtual File System
+// =============================================================================
+
+// Resolves paths against mounted packs and loose directories. Each mount
+// serves the paths under its mount point; the most recently mounted source
+// that has a file wins, so loose directories mounted after a pack override
+// its entries during development. Paths outside every mount point, and files
+// no mount has, are not found here and FileReader falls back to the disk.
+//
+// Mount before reading from other threads, lookups are const and thread safe.
+class VirtualFileSystem {
+public:
+    bool MountPack(const std::string& packPath, const std::string& mountPoint = "");
+    void MountDirectory(const std::string& directory, const std::string& mountPoint = "");
+    void UnmountAll();
+
+    bool Exists(const std::string& path) const;
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& out) const;
+    bool ReadFile(const std::string& path, std::string& out) const;
+    bool OpenView(const std::string& path, FileView& view) const;
+
+    size_t GetMountCount() const { return m_mounts.size(); }
+    void PrintMounts() const;
+
+private:
+    struct Mount {
+        std::string mountPoint;             // Normalized, empty for the root
+        std::string directory;              // Loose mounts
+        std::unique_ptr<PackFile> pack;     // Pack mounts
+    };
+
+    struct Location {
+        const Mount* mount = nullptr;
+        uint32_t entry = PackFile::INVALID_ENTRY;
+        std::string diskPath;
+    };
+
+    // Newest mount with the file, false when none has it
+    bool Resolve(const std::string& path, Location& location) const;
+
+    template <typename Container>
+    bool ReadInto(const std::string& path, Container& out) const;
+
+    std::vector<Mount> m_mounts;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+enum class LightType : uint8_t {
+    Point,
+    Spot
+};
+
+// Position comes from the entity's Position, spot direction from its
+// Rotation (forward is -Z, same as the camera).
+struct Light {
+    LightType type = LightType::Point;
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+    float range = 10.0f;              // Attenuation reaches zero here
+    float innerConeAngle = 20.0f;     // Degrees, spot only
+    float outerConeAngle = 30.0f;     // Degrees, spot only
+    bool isActive = true;
+};
@@ -5,4 +5,14 @@
 struct MeshRenderer {
     MeshHandle meshIndex = INVALID_MESH_HANDLE;
     MaterialHandle materialIndex = INVALID_MATERIAL_HANDLE;
-};
\ No newline at end of file
+};
+
+// Tag: entity's mesh is rasterized into the software occlusion buffer.
+// The mesh must be created with CPUMesh::isOccluder so its geometry is retained.
+struct Occluder {};
+
+// LOD picked for the entity last frame, kept so selection can apply hysteresis.
+// Added automatically by the forward pass when a LOD selector is active.
+struct MeshLOD {
+    uint32_t current = 0;
+};
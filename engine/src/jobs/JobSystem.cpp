@@ -0,0 +1,118 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void JobSystem::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    if (count == 1 || m_workers.empty()) {
+        for (uint32_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    // Shared state outlives this call in case a helper job starts late
+    struct ParallelForState {
+        std::atomic<uint32_t> nextIndex{0};
+        std::atomic<uint32_t> completed{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<ParallelForState>();
+
+    auto drain = [state, count, &fn]() {
+        uint32_t finished = 0;
+        for (uint32_t i = state->nextIndex.fetch_add(1); i < count; i = state->nextIndex.fetch_add(1)) {
+            fn(i);
+            finished++;
+        }
+
+        if (finished > 0 && state->completed.fetch_add(finished) + finished == count) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done.notify_all();
+        }
+    };
+
+    // fn is only touched while indices remain, and the caller does not return
+    // before every index completed, so capturing it by reference is safe
+    uint32_t helpers = std::min(count - 1, GetWorkerCount());
+    for (uint32_t i = 0; i < helpers; ++i) {
+        Submit(drain);
+    }
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state, count]() { return state->completed.load() == count; });
+}
+
+void JobSystem::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_jobs.empty() && m_activeJobs == 0; });
+}
+
+void JobSystem::WorkerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this]() { return m_shutdown || !m_jobs.empty(); });
+
+            if (m_shutdown && m_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_activeJobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeJobs--;
+            if (m_jobs.empty() && m_activeJobs == 0) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// =============================================================================
+// Job System
+// =============================================================================
+
+// Fixed pool of worker threads fed from a single FIFO queue. The calling
+// thread participates in ParallelFor so a pool with zero workers still runs.
+class JobSystem {
+public:
+    // workerCount == 0 picks hardware_concurrency - 1
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    // Prevent copying
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Fire-and-forget job
+    void Submit(std::function<void()> job);
+
+    // Run fn(index) for index in [0, count), blocks until every index completed
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+    // Block until the queue is drained and all workers are idle
+    void WaitIdle();
+
+    // Workers plus the calling thread
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_idle;
+    uint32_t m_activeJobs = 0;
+    bool m_shutdown = false;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// =============================================================================
+// Multi-Producer Single-Consumer Queue
+// =============================================================================
+
+// Unbounded lock-free FIFO: any number of threads Push, one thread Pop.
+// Producers swap themselves in as the new head with one atomic exchange and
+// then link the previous head to their node; the consumer follows the links
+// from a stub node, so neither side ever waits on the other.
+//
+// A Push that has exchanged but not linked yet makes the queue look empty up
+// to that node for a moment, Pop simply returns false and the item shows up
+// on a later call. T must be default constructible (the stub holds one).
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue()
+        : m_head(new Node())
+    {
+        m_tail = m_head.load(std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue() {
+        T discarded;
+        while (Pop(discarded)) {
+        }
+        delete m_tail;
+    }
+
+    // Prevent copying
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Any thread
+    void Push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer thread only
+    bool Pop(T& outValue) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+
+        // The popped node becomes the new stub
+        outValue = std::move(next->value);
+        m_tail = next;
+        delete tail;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        T value;
+    };
+
+    std::atomic<Node*> m_head;  // Last pushed, shared by producers
+    Node* m_tail;               // Stub before the oldest item, consumer only
+};
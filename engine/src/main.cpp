@@ -13,12 +13,17 @@
 #include "components/systems/TransformSystem.h"
 #include "components/systems/GameObjectSystem.h"
 #include "sceneutils/SceneUtils.h"
+#include "IO/GLTFImporter.h"
+#include "IO/FileReader.h"
 
 // Geometry System
 #include "renderer/renderpasses/RenderPassManager.h"
 #include "resources/GeometryManager.h"
 #include "resources/UniformManager.h"
 #include "resources/ShaderManager.h"
+#include "jobs/JobSystem.h"
+#include "renderer/OcclusionCuller.h"
+#include "renderer/LODSelector.h"
 
 // TEMP
 #include "renderer/renderpasses/ForwardPass.h"
@@ -59,9 +64,36 @@ int main() {
 
     DX12Device* device = renderer->GetDevice();
 
+    // ================================
+    std::unique_ptr<JobSystem> jobSystem = std::make_unique<JobSystem>();
+
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+    if (g_config.occlusionCulling) {
+        occlusionCuller = std::make_unique<OcclusionCuller>();
+    }
+
+    std::unique_ptr<LODSelector> lodSelector;
+    if (g_config.meshLODs) {
+        lodSelector = std::make_unique<LODSelector>();
+    }
+
+    // ================================
+    // Packed assets first, loose files mounted after them take precedence
+    const std::string assetRoot = "../../";
+    VirtualFileSystem fileSystem;
+    std::error_code packError;
+    if (!g_config.assetPack.empty() && std::filesystem::is_regular_file(g_config.assetPack, packError)) {
+        fileSystem.MountPack(g_config.assetPack, assetRoot);
+    }
+    if (g_config.looseAssetOverrides) {
+        fileSystem.MountDirectory(assetRoot, assetRoot);
+    }
+    FileReader::SetFileSystem(&fileSystem);
+    fileSystem.PrintMounts();
+
     // ================================
     std::unique_ptr<ShaderManager> shaderManager = std::make_unique<ShaderManager>();
-    shaderManager->SetShaderDirectories("../../shaders/hlsl/", "../../shaders/compiled/");
+    shaderManager->SetShaderDirectories(assetRoot + "shaders/hlsl/", assetRoot + "shaders/compiled/");
 
     // ================================
     std::unique_ptr<GeometryManager> geometryManager = std::make_unique<GeometryManager>(device->GetAllocator());
@@ -70,7 +102,15 @@ int main() {
     geoConfig.indexBufferSize = 32 * 1024 * 1024;    // 32MB
     geoConfig.uploadHeapSize = 8 * 1024 * 1024;      // 8MB
     geoConfig.maxUploadsPerFrame = 8;
+    geoConfig.autoLODCount = g_config.meshLODs ? MAX_MESH_LODS - 1 : 0;
+    geoConfig.deduplicateMeshes = g_config.meshDeduplication;
+    geoConfig.optimizeMeshes = g_config.meshOptimization;
+    geoConfig.buildMeshlets = g_config.meshlets;
+    geoConfig.vertexLayout = g_config.quantizedVertices ? VertexLayout::Compact() : VertexLayout::Float();
     geometryManager->SetConfig(geoConfig);
+    if (g_config.asyncGeometryUploads) {
+        geometryManager->EnableAsyncUploads(device->GetD3D12Device(), renderer->GetCopyQueue());
+    }
 
     // ================================
     std::unique_ptr<UniformManager> uniformManager = std::make_unique<UniformManager>(
@@ -92,7 +132,7 @@ int main() {
     // ================================
     // Render Pass System
     RenderPassManager passManager;
-    passManager.AddPass(std::make_unique<ForwardPass>());
+    passManager.AddPass(std::make_unique<ForwardPass>(geometryManager->GetVertexLayout()));
 
     // Initialize passes with both device and shader manager
     if (!passManager.InitializeAllPasses(device->GetD3D12Device(), shaderManager.get())) {
@@ -106,6 +146,10 @@ int main() {
     renderCtx.geometryManager = geometryManager.get();
     renderCtx.uniformManager = uniformManager.get();
     renderCtx.renderer = renderer.get();
+    renderCtx.jobSystem = jobSystem.get();
+    renderCtx.occlusionCuller = occlusionCuller.get();
+    renderCtx.lodSelector = lodSelector.get();
+    renderCtx.indirectDraws = g_config.indirectDraws;
 
     VertexAttributes cubeVertices[] = {
         // Front face - Red (Z = +0.5)
@@ -160,6 +204,7 @@ int main() {
     triCPUdata.indices = cubeIndices;
     triCPUdata.vertexCount = 24;
     triCPUdata.indexCount = 36;
+    triCPUdata.isOccluder = g_config.occlusionCulling;
     MeshHandle cubeMesh = INVALID_MESH_HANDLE;
     cubeMesh = geometryManager->CreateMesh(triCPUdata);
     if (cubeMesh == INVALID_MESH_HANDLE) {
@@ -179,6 +224,25 @@ int main() {
     tempObject->addScript<RotationScript>();
     registry.emplace<MeshHandle>(temp_entity, cubeMesh);
 
+    if (g_config.occlusionBenchmarkScene) {
+        SceneUtils::createOcclusionBenchmarkScene(registry, cubeMesh, cubeMesh);
+    }
+
+    if (!g_config.gltfScene.empty()) {
+        ImportedScene importedScene;
+        GLTFImporter::Statistics importStats;
+        if (GLTFImporter::Import(g_config.gltfScene, importedScene, jobSystem.get(), GLTFImportSettings(), &importStats)) {
+            GLTFImporter::PrintStats(g_config.gltfScene, importedScene, importStats);
+
+            // LODs, optimization and meshlets run in CreateMesh, spread them too
+            std::vector<MeshHandle> sceneMeshes(importedScene.meshes.size(), INVALID_MESH_HANDLE);
+            jobSystem->ParallelFor(static_cast<uint32_t>(sceneMeshes.size()), [&](uint32_t i) {
+                sceneMeshes[i] = geometryManager->CreateMesh(importedScene.meshes[i].GetCPUMesh());
+            });
+            SceneUtils::createSceneHierarchy(registry, importedScene.nodes, importedScene.rootNodes, sceneMeshes);
+        }
+    }
+
     // =========================================================================
     entt::entity cameraEntity = registry.create();
     SceneData cameraEntityData;
@@ -210,7 +274,9 @@ int main() {
 
         CommandList* cmdList = renderer->BeginFrame();
 
-        geometryManager->BeginFrame(frameCount, cmdList);
+        geometryManager->BeginFrame(frameCount, cmdList,
+                                    renderer->GetCompletedFenceValue(),
+                                    renderer->GetPendingFenceValue());
         uniformManager->BeginFrame(frameCount);
 
         renderCtx.targetCamera->setAspectRatio(
@@ -257,6 +323,12 @@ int main() {
         if (debugPrintTimer >= 9.0f) {
             geometryManager->PrintDebugInfo();
             uniformManager->PrintStats();
+            if (occlusionCuller) {
+                occlusionCuller->PrintStats();
+            }
+            if (lodSelector) {
+                lodSelector->PrintStats();
+            }
             debugPrintTimer = 0.0f;
         }
 #endif
@@ -269,6 +341,7 @@ int main() {
     shaderManager.reset();
     uniformManager.reset();
     geometryManager.reset();
+    jobSystem.reset();
 
     std::cout << "Engine shutdown complete." << std::endl;
     return 0;
@@ -0,0 +1,322 @@
+#include "ClusteredLightGrid.h"
+#include "jobs/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLUSTER_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define CLUSTER_USE_SSE2 0
+#endif
+
+namespace {
+    // Extents of the padding lanes, never within any light's reach
+    constexpr float EMPTY_MIN = 1e30f;
+    constexpr float EMPTY_MAX = -1e30f;
+    constexpr float QUARTER_PI = 0.78539816f;
+}
+
+ClusteredLightGrid::ClusteredLightGrid() {
+    AllocateClusters();
+}
+
+ClusteredLightGrid::ClusteredLightGrid(const Config& config)
+    : m_config(config)
+{
+    AllocateClusters();
+}
+
+void ClusteredLightGrid::SetConfig(const Config& config) {
+    m_config = config;
+    AllocateClusters();
+}
+
+void ClusteredLightGrid::AllocateClusters() {
+    m_config.tilesX = std::max(m_config.tilesX, 1u);
+    m_config.tilesY = std::max(m_config.tilesY, 1u);
+    m_config.slicesZ = std::max(m_config.slicesZ, 1u);
+    m_config.maxLightsPerCluster = std::max(m_config.maxLightsPerCluster, 1u);
+
+    // Tile columns are tested 4 at a time
+    m_rowStride = (m_config.tilesX + 3u) & ~3u;
+
+    m_sliceNear.resize(m_config.slicesZ);
+    m_sliceFar.resize(m_config.slicesZ);
+    m_tileMinX.resize(m_config.slicesZ * m_rowStride);
+    m_tileMaxX.resize(m_config.slicesZ * m_rowStride);
+    m_tileMinY.resize(m_config.slicesZ * m_config.tilesY);
+    m_tileMaxY.resize(m_config.slicesZ * m_config.tilesY);
+
+    m_clusterCounts.assign(GetClusterCount(), 0);
+    m_clusterScratch.assign(static_cast<size_t>(GetClusterCount()) * m_config.maxLightsPerCluster, 0);
+    m_clusterRanges.assign(GetClusterCount(), {});
+    m_lightIndices.clear();
+
+    if (m_nearPlane > 0.0f) {
+        m_logDepthScale = m_config.slicesZ / std::log(m_farPlane / m_nearPlane);
+    }
+    m_boundsDirty = true;
+}
+
+void ClusteredLightGrid::SetProjection(float fovYDegrees, float aspectRatio, float nearPlane, float farPlane) {
+    if (fovYDegrees == m_fovY && aspectRatio == m_aspectRatio &&
+        nearPlane == m_nearPlane && farPlane == m_farPlane) {
+        return;
+    }
+
+    m_fovY = fovYDegrees;
+    m_aspectRatio = aspectRatio;
+    m_nearPlane = std::max(nearPlane, 1e-4f);
+    m_farPlane = std::max(farPlane, m_nearPlane * 1.001f);
+    m_tanHalfFovY = std::tan(glm::radians(fovYDegrees) * 0.5f);
+    m_logDepthScale = m_config.slicesZ / std::log(m_farPlane / m_nearPlane);
+    m_boundsDirty = true;
+}
+
+uint32_t ClusteredLightGrid::GetSliceForDepth(float viewDepth) const {
+    if (viewDepth <= m_nearPlane) {
+        return 0;
+    }
+    const float slice = std::log(viewDepth / m_nearPlane) * m_logDepthScale;
+    return std::min(static_cast<uint32_t>(slice), m_config.slicesZ - 1);
+}
+
+void ClusteredLightGrid::BuildClusterBounds() {
+    const float tanHalfFovX = m_tanHalfFovY * m_aspectRatio;
+    const float depthRatio = m_farPlane / m_nearPlane;
+
+    for (uint32_t slice = 0; slice < m_config.slicesZ; ++slice) {
+        const float sliceNear = m_nearPlane * std::pow(depthRatio, static_cast<float>(slice) / m_config.slicesZ);
+        const float sliceFar = m_nearPlane * std::pow(depthRatio, static_cast<float>(slice + 1) / m_config.slicesZ);
+        m_sliceNear[slice] = sliceNear;
+        m_sliceFar[slice] = sliceFar;
+
+        // A froxel widens with depth, so each side's extreme sits on the near
+        // or far face depending on which side of the view axis it lies
+        for (uint32_t x = 0; x < m_rowStride; ++x) {
+            float& minX = m_tileMinX[slice * m_rowStride + x];
+            float& maxX = m_tileMaxX[slice * m_rowStride + x];
+            if (x >= m_config.tilesX) {
+                minX = EMPTY_MIN;
+                maxX = EMPTY_MAX;
+                continue;
+            }
+            const float ndc0 = -1.0f + 2.0f * x / m_config.tilesX;
+            const float ndc1 = -1.0f + 2.0f * (x + 1) / m_config.tilesX;
+            minX = ndc0 * tanHalfFovX * (ndc0 < 0.0f ? sliceFar : sliceNear);
+            maxX = ndc1 * tanHalfFovX * (ndc1 > 0.0f ? sliceFar : sliceNear);
+        }
+
+        for (uint32_t y = 0; y < m_config.tilesY; ++y) {
+            const float ndc0 = -1.0f + 2.0f * y / m_config.tilesY;
+            const float ndc1 = -1.0f + 2.0f * (y + 1) / m_config.tilesY;
+            m_tileMinY[slice * m_config.tilesY + y] = ndc0 * m_tanHalfFovY * (ndc0 < 0.0f ? sliceFar : sliceNear);
+            m_tileMaxY[slice * m_config.tilesY + y] = ndc1 * m_tanHalfFovY * (ndc1 > 0.0f ? sliceFar : sliceNear);
+        }
+    }
+
+    m_boundsDirty = false;
+}
+
+bool ClusteredLightGrid::ComputeLightBounds(const ClusterLight& light, const glm::mat4& view, LightBounds& out) const {
+    if (light.range <= 0.0f) {
+        return false;
+    }
+
+    // Bounding sphere of the light volume, tight around narrow spot cones
+    glm::vec3 center = light.position;
+    float radius = light.range;
+    if (light.type == LightType::Spot) {
+        const float angle = std::min(light.outerConeAngle, 3.14159265f);
+        if (angle > QUARTER_PI) {
+            center = light.position + light.direction * (std::cos(angle) * light.range);
+            radius = std::sin(angle) * light.range;
+        } else {
+            radius = light.range / (2.0f * std::cos(angle));
+            center = light.position + light.direction * radius;
+        }
+    }
+
+    // Depth is positive in front of the camera (view space looks down -Z)
+    const glm::vec4 viewCenter = view * glm::vec4(center, 1.0f);
+    out.center = glm::vec3(viewCenter.x, viewCenter.y, -viewCenter.z);
+    out.radius = radius;
+
+    const float depthMin = std::max(out.center.z - radius, m_nearPlane);
+    const float depthMax = std::min(out.center.z + radius, m_farPlane);
+    if (depthMin > depthMax) {
+        return false;
+    }
+
+    out.slice0 = GetSliceForDepth(depthMin);
+    out.slice1 = GetSliceForDepth(depthMax);
+
+    // Conservative screen rectangle: x / depth is most extreme on the nearest
+    // depth for negative x and on the farthest for positive x
+    const float tanHalfFovX = m_tanHalfFovY * m_aspectRatio;
+    auto project = [&](float v, bool isMin, float tanHalfFov) {
+        const bool useNear = isMin ? (v < 0.0f) : (v > 0.0f);
+        return v / ((useNear ? depthMin : depthMax) * tanHalfFov);
+    };
+    const float ndcMinX = project(out.center.x - radius, true, tanHalfFovX);
+    const float ndcMaxX = project(out.center.x + radius, false, tanHalfFovX);
+    const float ndcMinY = project(out.center.y - radius, true, m_tanHalfFovY);
+    const float ndcMaxY = project(out.center.y + radius, false, m_tanHalfFovY);
+    if (ndcMinX > 1.0f || ndcMaxX < -1.0f || ndcMinY > 1.0f || ndcMaxY < -1.0f) {
+        return false;
+    }
+
+    auto toTile = [](float ndc, uint32_t tileCount) {
+        const float tile = (ndc * 0.5f + 0.5f) * tileCount;
+        return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tileCount - 1)));
+    };
+    out.tileX0 = toTile(ndcMinX, m_config.tilesX);
+    out.tileX1 = toTile(ndcMaxX, m_config.tilesX);
+    out.tileY0 = toTile(ndcMinY, m_config.tilesY);
+    out.tileY1 = toTile(ndcMaxY, m_config.tilesY);
+    return true;
+}
+
+void ClusteredLightGrid::Build(const std::vector<ClusterLight>& lights, const glm::mat4& view, JobSystem* jobSystem) {
+    m_stats = {};
+    m_stats.inputLights = static_cast<uint32_t>(lights.size());
+
+    if (m_boundsDirty) {
+        BuildClusterBounds();
+    }
+
+    // Cull lights outside the frustum and find their candidate clusters
+    m_visibleLights.clear();
+    for (uint32_t i = 0; i < lights.size(); ++i) {
+        LightBounds bounds;
+        if (ComputeLightBounds(lights[i], view, bounds)) {
+            bounds.lightIndex = i;
+            m_visibleLights.push_back(bounds);
+        }
+    }
+    m_stats.visibleLights = static_cast<uint32_t>(m_visibleLights.size());
+
+    // Slices own disjoint clusters, so they can be filled concurrently
+    std::fill(m_clusterCounts.begin(), m_clusterCounts.end(), 0u);
+    if (jobSystem && !m_visibleLights.empty()) {
+        jobSystem->ParallelFor(m_config.slicesZ, [this](uint32_t slice) {
+            AssignSlice(slice);
+        });
+    } else {
+        for (uint32_t slice = 0; slice < m_config.slicesZ && !m_visibleLights.empty(); ++slice) {
+            AssignSlice(slice);
+        }
+    }
+
+    // Compact the fixed capacity lists into one index array
+    const uint32_t capacity = m_config.maxLightsPerCluster;
+    uint32_t offset = 0;
+    for (uint32_t cluster = 0; cluster < GetClusterCount(); ++cluster) {
+        const uint32_t rawCount = m_clusterCounts[cluster];
+        const uint32_t count = std::min(rawCount, capacity);
+        m_clusterRanges[cluster].offset = offset;
+        m_clusterRanges[cluster].count = count;
+        offset += count;
+
+        if (count > 0) {
+            m_stats.nonEmptyClusters++;
+        }
+        if (rawCount > capacity) {
+            m_stats.overflowedClusters++;
+        }
+        m_stats.maxLightsInCluster = std::max(m_stats.maxLightsInCluster, rawCount);
+    }
+
+    m_lightIndices.resize(offset);
+    for (uint32_t cluster = 0; cluster < GetClusterCount(); ++cluster) {
+        const ClusterRange& range = m_clusterRanges[cluster];
+        std::copy_n(m_clusterScratch.begin() + static_cast<size_t>(cluster) * capacity, range.count,
+                    m_lightIndices.begin() + range.offset);
+    }
+    m_stats.lightIndices = offset;
+}
+
+void ClusteredLightGrid::AssignSlice(uint32_t slice) {
+    const float sliceNear = m_sliceNear[slice];
+    const float sliceFar = m_sliceFar[slice];
+    const float* tileMinX = &m_tileMinX[slice * m_rowStride];
+    const float* tileMaxX = &m_tileMaxX[slice * m_rowStride];
+    const float* tileMinY = &m_tileMinY[slice * m_config.tilesY];
+    const float* tileMaxY = &m_tileMaxY[slice * m_config.tilesY];
+    const uint32_t capacity = m_config.maxLightsPerCluster;
+
+    // Lights are visited in index order, so every cluster list ends up sorted
+    for (const LightBounds& light : m_visibleLights) {
+        if (slice < light.slice0 || slice > light.slice1) {
+            continue;
+        }
+
+        const float radiusSq = light.radius * light.radius;
+        const float dz = std::max({ sliceNear - light.center.z, light.center.z - sliceFar, 0.0f });
+        const float dzSq = dz * dz;
+        if (dzSq > radiusSq) {
+            continue;
+        }
+
+        for (uint32_t y = light.tileY0; y <= light.tileY1; ++y) {
+            const float dy = std::max({ tileMinY[y] - light.center.y, light.center.y - tileMaxY[y], 0.0f });
+            const float dyzSq = dzSq + dy * dy;
+            if (dyzSq > radiusSq) {
+                continue;
+            }
+
+            const uint32_t rowCluster = GetClusterIndex(0, y, slice);
+            auto append = [&](uint32_t x) {
+                const uint32_t cluster = rowCluster + x;
+                const uint32_t count = m_clusterCounts[cluster]++;
+                if (count < capacity) {
+                    m_clusterScratch[static_cast<size_t>(cluster) * capacity + count] = light.lightIndex;
+                }
+            };
+
+#if CLUSTER_USE_SSE2
+            // Sphere vs. four froxel boxes per iteration
+            const __m128 centerX = _mm_set1_ps(light.center.x);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 rest = _mm_set1_ps(dyzSq);
+            const __m128 limit = _mm_set1_ps(radiusSq);
+            for (uint32_t x = light.tileX0 & ~3u; x <= light.tileX1; x += 4) {
+                const __m128 dxLow = _mm_sub_ps(_mm_loadu_ps(tileMinX + x), centerX);
+                const __m128 dxHigh = _mm_sub_ps(centerX, _mm_loadu_ps(tileMaxX + x));
+                const __m128 dx = _mm_max_ps(_mm_max_ps(dxLow, dxHigh), zero);
+                const __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), rest);
+                const int hits = _mm_movemask_ps(_mm_cmple_ps(distSq, limit));
+                if (!hits) {
+                    continue;
+                }
+
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    const uint32_t tileX = x + lane;
+                    if ((hits & (1 << lane)) && tileX >= light.tileX0 && tileX <= light.tileX1) {
+                        append(tileX);
+                    }
+                }
+            }
+#else
+            for (uint32_t x = light.tileX0; x <= light.tileX1; ++x) {
+                const float dx = std::max({ tileMinX[x] - light.center.x, light.center.x - tileMaxX[x], 0.0f });
+                if (dx * dx + dyzSq <= radiusSq) {
+                    append(x);
+                }
+            }
+#endif
+        }
+    }
+}
+
+void ClusteredLightGrid::PrintStats() const {
+    printf("=== Clustered Light Grid Stats ===\n");
+    printf("Grid: %ux%ux%u (%u clusters)\n", m_config.tilesX, m_config.tilesY, m_config.slicesZ, GetClusterCount());
+    printf("Lights: %u (visible: %u)\n", m_stats.inputLights, m_stats.visibleLights);
+    printf("Non-empty clusters: %u\n", m_stats.nonEmptyClusters);
+    printf("Light indices: %u (max per cluster: %u, overflowed clusters: %u)\n",
+           m_stats.lightIndices, m_stats.maxLightsInCluster, m_stats.overflowedClusters);
+    printf("==================================\n");
+}
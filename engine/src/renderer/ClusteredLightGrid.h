@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "components/Light.h"
+
+class JobSystem;
+
+// =============================================================================
+// Clustered Light Grid
+// =============================================================================
+
+// Bins point and spot lights into view-space froxels: tilesX x tilesY screen
+// tiles times slicesZ depth slices spaced exponentially between the near and
+// far planes. The result is one {offset, count} range per cluster into a
+// compact light index list, ready to upload as two structured buffers.
+// Pure CPU, no graphics API involved.
+//
+// Per frame:
+//   SetProjection(...)   required before the first Build, cheap when unchanged
+//   Build(lights, view, jobSystem)
+class ClusteredLightGrid {
+public:
+    struct Config {
+        uint32_t tilesX = 16;
+        uint32_t tilesY = 9;
+        uint32_t slicesZ = 24;
+        uint32_t maxLightsPerCluster = 256;    // Extra lights are dropped and counted
+    };
+
+    // World-space light as consumed by Build
+    struct ClusterLight {
+        glm::vec3 position = glm::vec3(0.0f);
+        float range = 0.0f;
+        glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);  // Spot only, normalized
+        float outerConeAngle = 0.0f;                          // Spot only, radians
+        LightType type = LightType::Point;
+    };
+
+    struct ClusterRange {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    struct Statistics {
+        uint32_t inputLights = 0;
+        uint32_t visibleLights = 0;
+        uint32_t nonEmptyClusters = 0;
+        uint32_t lightIndices = 0;
+        uint32_t maxLightsInCluster = 0;
+        uint32_t overflowedClusters = 0;
+    };
+
+    ClusteredLightGrid();
+    explicit ClusteredLightGrid(const Config& config);
+
+    void SetConfig(const Config& config);
+    const Config& GetConfig() const { return m_config; }
+
+    // Perspective parameters, matching Camera (fov in degrees)
+    void SetProjection(float fovYDegrees, float aspectRatio, float nearPlane, float farPlane);
+
+    // Assigns lights to clusters, slices are processed in parallel when a job
+    // system is given. The output only depends on the input, not thread count.
+    void Build(const std::vector<ClusterLight>& lights, const glm::mat4& view, JobSystem* jobSystem = nullptr);
+
+    // Cluster lookup, viewDepth is the positive distance along the view axis.
+    // Tile (0, 0) is the bottom-left corner of the screen (NDC -1, -1).
+    uint32_t GetSliceForDepth(float viewDepth) const;
+    uint32_t GetClusterIndex(uint32_t tileX, uint32_t tileY, uint32_t slice) const {
+        return (slice * m_config.tilesY + tileY) * m_config.tilesX + tileX;
+    }
+    uint32_t GetClusterCount() const { return m_config.tilesX * m_config.tilesY * m_config.slicesZ; }
+
+    // Results of the last Build, indices refer to the lights passed to it
+    const std::vector<ClusterRange>& GetClusterRanges() const { return m_clusterRanges; }
+    const std::vector<uint32_t>& GetLightIndices() const { return m_lightIndices; }
+
+    const Statistics& GetStatistics() const { return m_stats; }
+    void PrintStats() const;
+
+private:
+    // Bounding sphere in (x, y, depth) view space plus the clusters it may touch
+    struct LightBounds {
+        glm::vec3 center;
+        float radius;
+        uint32_t lightIndex;
+        uint32_t tileX0, tileX1;
+        uint32_t tileY0, tileY1;
+        uint32_t slice0, slice1;
+    };
+
+    void AllocateClusters();
+    void BuildClusterBounds();
+    bool ComputeLightBounds(const ClusterLight& light, const glm::mat4& view, LightBounds& out) const;
+    void AssignSlice(uint32_t slice);
+
+    Config m_config;
+    uint32_t m_rowStride = 0;           // tilesX rounded up to a multiple of 4
+
+    float m_fovY = 0.0f;
+    float m_aspectRatio = 0.0f;
+    float m_nearPlane = 0.0f;
+    float m_farPlane = 0.0f;
+    float m_tanHalfFovY = 1.0f;
+    float m_logDepthScale = 0.0f;       // slicesZ / log(far / near)
+    bool m_boundsDirty = true;
+
+    // Per slice depth range, plus x extents per (slice, column) and y extents
+    // per (slice, row). Columns are padded to m_rowStride with empty boxes.
+    std::vector<float> m_sliceNear;
+    std::vector<float> m_sliceFar;
+    std::vector<float> m_tileMinX;
+    std::vector<float> m_tileMaxX;
+    std::vector<float> m_tileMinY;
+    std::vector<float> m_tileMaxY;
+
+    // Scratch: fixed capacity list per cluster before compaction
+    std::vector<LightBounds> m_visibleLights;
+    std::vector<uint32_t> m_clusterCounts;
+    std::vector<uint32_t> m_clusterScratch;
+
+    std::vector<ClusterRange> m_clusterRanges;
+    std::vector<uint32_t> m_lightIndices;
+
+    Statistics m_stats;
+};
@@ -0,0 +1,106 @@
+#include "DrawStream.h"
+#include "jobs/JobSystem.h"
+#include <algorithm>
+
+// =============================================================================
+// DrawStream
+// =============================================================================
+
+void DrawStream::SetConstants(uint32_t rootParameter, uint64_t gpuAddress, uint32_t descriptorIndex) {
+    DrawCommand cmd;
+    cmd.type = DrawCommandType::SetConstants;
+    cmd.rootParameter = rootParameter;
+    cmd.gpuAddress = gpuAddress;
+    cmd.descriptorIndex = descriptorIndex;
+    m_commands.push_back(cmd);
+}
+
+void DrawStream::SetIndexBuffer(const IndexBufferBinding& indexBuffer) {
+    DrawCommand cmd;
+    cmd.type = DrawCommandType::SetIndexBuffer;
+    cmd.indexBuffer = indexBuffer;
+    m_commands.push_back(cmd);
+}
+
+void DrawStream::DrawIndexed(const DrawIndexedArgs& args) {
+    DrawCommand cmd;
+    cmd.type = DrawCommandType::DrawIndexed;
+    cmd.draw = args;
+    m_commands.push_back(cmd);
+    m_drawCount++;
+}
+
+void DrawStream::Append(const DrawStream& other) {
+    m_commands.insert(m_commands.end(), other.m_commands.begin(), other.m_commands.end());
+    m_drawCount += other.m_drawCount;
+}
+
+// =============================================================================
+// Chunking
+// =============================================================================
+
+std::vector<DrawChunk> SplitDrawChunks(uint32_t itemCount, uint32_t maxChunks, uint32_t minItemsPerChunk) {
+    std::vector<DrawChunk> chunks;
+    if (itemCount == 0) {
+        return chunks;
+    }
+
+    maxChunks = std::max(maxChunks, 1u);
+    minItemsPerChunk = std::max(minItemsPerChunk, 1u);
+
+    uint32_t chunkCount = std::min(maxChunks, std::max(itemCount / minItemsPerChunk, 1u));
+
+    // Spread the remainder over the first chunks so sizes differ by at most one
+    uint32_t baseSize = itemCount / chunkCount;
+    uint32_t remainder = itemCount % chunkCount;
+
+    chunks.reserve(chunkCount);
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        uint32_t size = baseSize + (i < remainder ? 1 : 0);
+        chunks.push_back({ begin, begin + size });
+        begin += size;
+    }
+
+    return chunks;
+}
+
+void EncodeDrawChunks(JobSystem* jobSystem,
+                      const std::vector<DrawItem>& items,
+                      const std::vector<DrawChunk>& chunks,
+                      const DrawEncodeFn& encode,
+                      std::vector<DrawStream>& outStreams) {
+    if (outStreams.size() < chunks.size()) {
+        outStreams.resize(chunks.size());
+    }
+
+    auto encodeChunk = [&](uint32_t chunkIndex) {
+        const DrawChunk& chunk = chunks[chunkIndex];
+        DrawStream& stream = outStreams[chunkIndex];
+        stream.Clear();
+        if (chunk.GetCount() > 0) {
+            encode(items.data() + chunk.begin, chunk.GetCount(), stream);
+        }
+    };
+
+    uint32_t chunkCount = static_cast<uint32_t>(chunks.size());
+    if (jobSystem) {
+        jobSystem->ParallelFor(chunkCount, encodeChunk);
+    } else {
+        for (uint32_t i = 0; i < chunkCount; ++i) {
+            encodeChunk(i);
+        }
+    }
+}
+
+void MergeDrawStreams(const std::vector<DrawStream>& streams, DrawStream& out) {
+    size_t totalCommands = out.GetCommandCount();
+    for (const auto& stream : streams) {
+        totalCommands += stream.GetCommandCount();
+    }
+
+    out.Reserve(totalCommands);
+    for (const auto& stream : streams) {
+        out.Append(stream);
+    }
+}
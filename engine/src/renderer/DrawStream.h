@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <glm/glm.hpp>
+
+#include "resources/RenderTypes.h"
+
+class JobSystem;
+
+/* =============================================================================
+   Backend-neutral draw recording. Passes encode their visible list into
+   DrawStreams (plain command records), which are later replayed onto a real
+   command list. Keeping this layer free of DX12 lets chunking, ordering and
+   merging be exercised on any platform.
+   ============================================================================= */
+
+// Entry of the per-frame visible list
+struct DrawItem {
+    MeshHandle mesh = INVALID_MESH_HANDLE;
+    glm::mat4 model = glm::mat4(1.0f);
+    uint32_t lod = 0;
+};
+
+// Matches the layout of D3D12_DRAW_INDEXED_ARGUMENTS
+struct DrawIndexedArgs {
+    uint32_t indexCount = 0;
+    uint32_t instanceCount = 1;
+    uint32_t startIndex = 0;
+    int32_t baseVertex = 0;
+    uint32_t startInstance = 0;
+};
+
+static_assert(sizeof(DrawIndexedArgs) == 5 * sizeof(uint32_t), "DrawIndexedArgs size mismatch");
+
+inline DrawIndexedArgs MakeDrawIndexedArgs(const MeshView& view, uint32_t instanceCount = 1, uint32_t startInstance = 0) {
+    DrawIndexedArgs args;
+    args.indexCount = view.indexCount;
+    args.instanceCount = instanceCount;
+    args.startIndex = view.indexOffset;
+    args.baseVertex = static_cast<int32_t>(view.vertexOffset);
+    args.startInstance = startInstance;
+    return args;
+}
+
+enum class DrawCommandType : uint8_t {
+    SetConstants,   // Bind a constant buffer to a root parameter
+    SetIndexBuffer, // Rebind the index buffer, switches index width
+    DrawIndexed
+};
+
+struct DrawCommand {
+    DrawCommandType type = DrawCommandType::DrawIndexed;
+
+    // SetConstants
+    uint32_t rootParameter = 0;
+    uint32_t descriptorIndex = UINT32_MAX;
+    uint64_t gpuAddress = 0;
+
+    // SetIndexBuffer
+    IndexBufferBinding indexBuffer;
+
+    // DrawIndexed
+    DrawIndexedArgs draw;
+};
+
+class DrawStream {
+public:
+    void SetConstants(uint32_t rootParameter, uint64_t gpuAddress, uint32_t descriptorIndex);
+    void SetIndexBuffer(const IndexBufferBinding& indexBuffer);
+    void DrawIndexed(const DrawIndexedArgs& args);
+
+    // Append another stream's commands after this one's
+    void Append(const DrawStream& other);
+
+    void Clear() { m_commands.clear(); m_drawCount = 0; }
+    void Reserve(size_t commandCount) { m_commands.reserve(commandCount); }
+
+    const std::vector<DrawCommand>& GetCommands() const { return m_commands; }
+    size_t GetCommandCount() const { return m_commands.size(); }
+    uint32_t GetDrawCount() const { return m_drawCount; }
+    bool IsEmpty() const { return m_commands.empty(); }
+
+private:
+    std::vector<DrawCommand> m_commands;
+    uint32_t m_drawCount = 0;
+};
+
+// =============================================================================
+// Chunking
+// =============================================================================
+
+// Half-open range [begin, end) into the visible list
+struct DrawChunk {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+
+    uint32_t GetCount() const { return end - begin; }
+};
+
+// Splits itemCount items into at most maxChunks contiguous, order-preserving
+// ranges of at least minItemsPerChunk items each (except when fewer items exist).
+std::vector<DrawChunk> SplitDrawChunks(uint32_t itemCount, uint32_t maxChunks, uint32_t minItemsPerChunk);
+
+// Encodes items[chunk.begin, chunk.end) into a stream
+using DrawEncodeFn = std::function<void(const DrawItem* items, uint32_t count, DrawStream& out)>;
+
+// Encodes each chunk into its own stream (outStreams[i] <-> chunks[i]) using
+// the job system when available. Streams are cleared before encoding.
+void EncodeDrawChunks(JobSystem* jobSystem,
+                      const std::vector<DrawItem>& items,
+                      const std::vector<DrawChunk>& chunks,
+                      const DrawEncodeFn& encode,
+                      std::vector<DrawStream>& outStreams);
+
+// Concatenates streams in chunk order, the result equals a serial encode
+void MergeDrawStreams(const std::vector<DrawStream>& streams, DrawStream& out);
@@ -0,0 +1,61 @@
+#include "IndirectDrawArgs.h"
+
+uint32_t BuildIndirectDrawMask(const IndirectDrawSource* sources, uint32_t sourceCount,
+                               const MeshView* meshTable, uint32_t meshTableSize,
+                               uint32_t* outMask) {
+    uint32_t drawCount = 0;
+    for (uint32_t i = 0; i < sourceCount; ++i) {
+        const IndirectDrawSource& source = sources[i];
+        const bool valid = source.visible != 0 &&
+                           source.meshSlot < meshTableSize &&
+                           meshTable[source.meshSlot].indexCount > 0;
+        outMask[i] = valid ? 1u : 0u;
+        drawCount += outMask[i];
+    }
+    return drawCount;
+}
+
+uint32_t ExclusivePrefixSum(const uint32_t* in, uint32_t count, uint32_t* out) {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t value = in[i];
+        out[i] = sum;
+        sum += value;
+    }
+    return sum;
+}
+
+void ScatterIndirectDraws(const IndirectDrawSource* sources, uint32_t sourceCount,
+                          const MeshView* meshTable,
+                          const uint32_t* mask, const uint32_t* offsets,
+                          IndirectDrawRecord* outRecords) {
+    for (uint32_t i = 0; i < sourceCount; ++i) {
+        if (!mask[i]) {
+            continue;
+        }
+
+        IndirectDrawRecord& record = outRecords[offsets[i]];
+        record.constantsAddress = sources[i].constantsAddress;
+        record.draw = MakeDrawIndexedArgs(meshTable[sources[i].meshSlot]);
+        record.padding = 0;
+    }
+}
+
+uint32_t GenerateIndirectDraws(const std::vector<IndirectDrawSource>& sources,
+                               const std::vector<MeshView>& meshTable,
+                               IndirectDrawScratch& scratch,
+                               std::vector<IndirectDrawRecord>& outRecords) {
+    const uint32_t sourceCount = static_cast<uint32_t>(sources.size());
+    scratch.mask.resize(sourceCount);
+    scratch.offsets.resize(sourceCount);
+
+    BuildIndirectDrawMask(sources.data(), sourceCount,
+                          meshTable.data(), static_cast<uint32_t>(meshTable.size()),
+                          scratch.mask.data());
+    const uint32_t drawCount = ExclusivePrefixSum(scratch.mask.data(), sourceCount, scratch.offsets.data());
+
+    outRecords.resize(drawCount);
+    ScatterIndirectDraws(sources.data(), sourceCount, meshTable.data(),
+                         scratch.mask.data(), scratch.offsets.data(), outRecords.data());
+    return drawCount;
+}
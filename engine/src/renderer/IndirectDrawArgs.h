@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DrawStream.h"
+
+/* =============================================================================
+   Indirect draw argument generation (CPU reference)
+
+   Turns the visible list into a compact array of IndirectDrawRecords that is
+   consumed by a single ExecuteIndirect. Generation is split into the same
+   three passes a compute implementation would use, each a pure function over
+   flat arrays with one independent work item per source:
+
+     1. BuildIndirectDrawMask   one thread per source, writes 0/1
+     2. ExclusivePrefixSum      scan of the mask, yields output slots
+     3. ScatterIndirectDraws    one thread per source, writes its record
+
+   Sources and the mesh table map directly onto structured buffers.
+   ============================================================================= */
+
+// Per-draw input, one per visible-list entry
+struct IndirectDrawSource {
+    uint64_t constantsAddress = 0;  // GPU address of the draw's constant buffer
+    uint32_t meshSlot = 0;          // Index into the mesh table
+    uint32_t visible = 1;           // 0 when culled, the draw is compacted away
+};
+
+// One command signature record: root CBV followed by draw-indexed arguments
+struct IndirectDrawRecord {
+    uint64_t constantsAddress = 0;
+    DrawIndexedArgs draw;
+    uint32_t padding = 0;
+};
+
+static_assert(sizeof(IndirectDrawRecord) == 32, "IndirectDrawRecord must match the command signature stride");
+
+// Pass 1: mask[i] = 1 when source i produces a draw. Returns the number of draws.
+uint32_t BuildIndirectDrawMask(const IndirectDrawSource* sources, uint32_t sourceCount,
+                               const MeshView* meshTable, uint32_t meshTableSize,
+                               uint32_t* outMask);
+
+// Pass 2: out[i] = sum of in[0, i). Returns the total. in and out may alias.
+uint32_t ExclusivePrefixSum(const uint32_t* in, uint32_t count, uint32_t* out);
+
+// Pass 3: writes the record of every masked source to outRecords[offsets[i]]
+void ScatterIndirectDraws(const IndirectDrawSource* sources, uint32_t sourceCount,
+                          const MeshView* meshTable,
+                          const uint32_t* mask, const uint32_t* offsets,
+                          IndirectDrawRecord* outRecords);
+
+// Scratch arrays reused across frames
+struct IndirectDrawScratch {
+    std::vector<uint32_t> mask;
+    std::vector<uint32_t> offsets;
+};
+
+// Runs all three passes. outRecords is resized to the draw count, records
+// keep the order of their sources.
+uint32_t GenerateIndirectDraws(const std::vector<IndirectDrawSource>& sources,
+                               const std::vector<MeshView>& meshTable,
+                               IndirectDrawScratch& scratch,
+                               std::vector<IndirectDrawRecord>& outRecords);
@@ -0,0 +1,146 @@
+#include "IndirectDrawRecorder.h"
+#include <algorithm>
+#include <cstdio>
+
+bool IndirectDrawRecorder::Initialize(ID3D12Device* device, D3D12MA::Allocator* allocator,
+                                      ID3D12RootSignature* rootSignature, const Config& config) {
+    if (!device || !allocator || !rootSignature) {
+        printf("IndirectDrawRecorder: Invalid parameters\n");
+        return false;
+    }
+
+    m_config = config;
+    m_allocator = allocator;
+
+    // Root CBV + DrawIndexedInstanced, laid out as IndirectDrawRecord
+    D3D12_INDIRECT_ARGUMENT_DESC arguments[2] = {};
+    arguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
+    arguments[0].ConstantBufferView.RootParameterIndex = m_config.constantsRootParameter;
+    arguments[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+    D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+    signatureDesc.ByteStride = sizeof(IndirectDrawRecord);
+    signatureDesc.NumArgumentDescs = _countof(arguments);
+    signatureDesc.pArgumentDescs = arguments;
+    signatureDesc.NodeMask = 0;
+
+    HRESULT hr = device->CreateCommandSignature(&signatureDesc, rootSignature, IID_PPV_ARGS(&m_commandSignature));
+    if (FAILED(hr)) {
+        printf("IndirectDrawRecorder: Failed to create command signature: 0x%08X\n", hr);
+        return false;
+    }
+
+    return true;
+}
+
+void IndirectDrawRecorder::Record(CommandList* cmdList, UINT frameIndex,
+                                  const IndirectDrawRecord* records, uint32_t recordCount) {
+    m_lastDrawCount = 0;
+
+    if (!cmdList || !IsInitialized() || recordCount == 0) {
+        return;
+    }
+
+    Buffer* argumentBuffer = UploadRecords(frameIndex, records, recordCount);
+    if (!argumentBuffer) {
+        return;
+    }
+
+    // Upload heap buffers stay in GENERIC_READ, which covers INDIRECT_ARGUMENT
+    cmdList->GetCommandList()->ExecuteIndirect(
+        m_commandSignature.Get(),
+        recordCount,
+        argumentBuffer->GetResource(),
+        0,
+        nullptr,
+        0
+    );
+
+    m_lastDrawCount = recordCount;
+}
+
+void IndirectDrawRecorder::Record(CommandList* cmdList, UINT frameIndex, const IndirectDrawRecord* records,
+                                  const Batch* batches, uint32_t batchCount) {
+    m_lastDrawCount = 0;
+
+    uint32_t recordCount = 0;
+    for (uint32_t i = 0; i < batchCount; ++i) {
+        recordCount += batches[i].recordCount;
+    }
+
+    if (!cmdList || !IsInitialized() || recordCount == 0) {
+        return;
+    }
+
+    Buffer* argumentBuffer = UploadRecords(frameIndex, records, recordCount);
+    if (!argumentBuffer) {
+        return;
+    }
+
+    ID3D12GraphicsCommandList* d3dCmdList = cmdList->GetCommandList();
+    uint32_t firstRecord = 0;
+    for (uint32_t i = 0; i < batchCount; ++i) {
+        const Batch& batch = batches[i];
+        if (batch.recordCount == 0) {
+            continue;
+        }
+
+        D3D12_INDEX_BUFFER_VIEW indexView = {};
+        indexView.BufferLocation = batch.indexBuffer.gpuAddress;
+        indexView.SizeInBytes = batch.indexBuffer.sizeInBytes;
+        indexView.Format = batch.indexBuffer.format == IndexFormat::Uint16 ? DXGI_FORMAT_R16_UINT
+                                                                           : DXGI_FORMAT_R32_UINT;
+        d3dCmdList->IASetIndexBuffer(&indexView);
+
+        d3dCmdList->ExecuteIndirect(
+            m_commandSignature.Get(),
+            batch.recordCount,
+            argumentBuffer->GetResource(),
+            static_cast<UINT64>(firstRecord) * sizeof(IndirectDrawRecord),
+            nullptr,
+            0
+        );
+        firstRecord += batch.recordCount;
+    }
+
+    m_lastDrawCount = recordCount;
+}
+
+Buffer* IndirectDrawRecorder::UploadRecords(UINT frameIndex, const IndirectDrawRecord* records, uint32_t recordCount) {
+    if (!EnsureFrameBuffer(frameIndex, recordCount)) {
+        return nullptr;
+    }
+
+    Buffer* argumentBuffer = m_frameBuffers[frameIndex].get();
+    if (!argumentBuffer->Update(records, static_cast<UINT64>(recordCount) * sizeof(IndirectDrawRecord))) {
+        return nullptr;
+    }
+    return argumentBuffer;
+}
+
+bool IndirectDrawRecorder::EnsureFrameBuffer(UINT frameIndex, uint32_t recordCount) {
+    if (m_frameBuffers.size() <= frameIndex) {
+        m_frameBuffers.resize(frameIndex + 1);
+    }
+
+    std::unique_ptr<Buffer>& buffer = m_frameBuffers[frameIndex];
+    if (buffer && buffer->GetCount() >= recordCount) {
+        return true;
+    }
+
+    // Safe to replace: the renderer waited on this frame's fence in BeginFrame
+    uint32_t capacity = std::max(m_config.initialCapacity, 1u);
+    while (capacity < recordCount) {
+        capacity *= 2;
+    }
+
+    buffer = std::make_unique<Buffer>();
+    if (!buffer->Initialize(m_allocator, static_cast<UINT64>(capacity) * sizeof(IndirectDrawRecord),
+                            sizeof(IndirectDrawRecord), true)) {
+        printf("IndirectDrawRecorder: Failed to create argument buffer for %u draws\n", capacity);
+        buffer.reset();
+        return false;
+    }
+
+    return true;
+}
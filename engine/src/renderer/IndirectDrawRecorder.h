@@ -0,0 +1,64 @@
+#pragma once
+
+#include "IndirectDrawArgs.h"
+#include "dx12/core/DX12Common.h"
+#include "dx12/core/CommandList.h"
+#include "dx12/resources/Buffer.h"
+#include <D3D12MemAlloc.h>
+#include <memory>
+#include <vector>
+
+// =============================================================================
+// Indirect Draw Recorder
+// =============================================================================
+
+// Submits a frame's IndirectDrawRecords with one ExecuteIndirect, or one per
+// batch when draws need different index buffer bindings. Records live
+// in a per-frame upload buffer, so a frame's buffer is only rewritten after the
+// renderer has waited on that frame's fence.
+class IndirectDrawRecorder {
+public:
+    struct Config {
+        uint32_t initialCapacity = 4096;    // Records per frame buffer, grows on demand
+        UINT constantsRootParameter = 0;    // Root CBV slot written by each record
+    };
+
+    IndirectDrawRecorder() = default;
+    ~IndirectDrawRecorder() = default;
+
+    IndirectDrawRecorder(const IndirectDrawRecorder&) = delete;
+    IndirectDrawRecorder& operator=(const IndirectDrawRecorder&) = delete;
+
+    // rootSignature must declare a root CBV at constantsRootParameter
+    bool Initialize(ID3D12Device* device, D3D12MA::Allocator* allocator,
+                    ID3D12RootSignature* rootSignature, const Config& config = {});
+    bool IsInitialized() const { return m_commandSignature != nullptr; }
+
+    // Consecutive records drawn with one index buffer binding
+    struct Batch {
+        uint32_t recordCount = 0;
+        IndexBufferBinding indexBuffer;
+    };
+
+    // Uploads the records into frameIndex's buffer and issues ExecuteIndirect
+    void Record(CommandList* cmdList, UINT frameIndex,
+                const IndirectDrawRecord* records, uint32_t recordCount);
+
+    // Same upload, one ExecuteIndirect per batch with its index buffer bound.
+    // Batches cover the records in order.
+    void Record(CommandList* cmdList, UINT frameIndex, const IndirectDrawRecord* records,
+                const Batch* batches, uint32_t batchCount);
+
+    uint32_t GetLastDrawCount() const { return m_lastDrawCount; }
+
+private:
+    bool EnsureFrameBuffer(UINT frameIndex, uint32_t recordCount);
+    Buffer* UploadRecords(UINT frameIndex, const IndirectDrawRecord* records, uint32_t recordCount);
+
+    Config m_config;
+    D3D12MA::Allocator* m_allocator = nullptr;
+    ComPtr<ID3D12CommandSignature> m_commandSignature;
+
+    std::vector<std::unique_ptr<Buffer>> m_frameBuffers;
+    uint32_t m_lastDrawCount = 0;
+};
@@ -0,0 +1,75 @@
+#include "LODSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+LODSelector::LODSelector() = default;
+
+LODSelector::LODSelector(const Config& config)
+    : m_config(config)
+{
+}
+
+void LODSelector::BeginFrame(const glm::vec3& cameraPosition, float fovYDegrees) {
+    m_cameraPosition = cameraPosition;
+    m_projectionScale = 1.0f / std::tan(glm::radians(fovYDegrees) * 0.5f);
+    m_stats = {};
+}
+
+float LODSelector::ComputeScreenSize(const MeshBounds& bounds, const glm::mat4& model) const {
+    const glm::vec3 boundsMin(bounds.min[0], bounds.min[1], bounds.min[2]);
+    const glm::vec3 boundsMax(bounds.max[0], bounds.max[1], bounds.max[2]);
+
+    // Bounding sphere in world space, radius scaled by the largest axis scale
+    const glm::vec3 center = glm::vec3(model * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+    const float maxScale = std::max({ glm::length(glm::vec3(model[0])),
+                                      glm::length(glm::vec3(model[1])),
+                                      glm::length(glm::vec3(model[2])) });
+    const float radius = glm::length(boundsMax - boundsMin) * 0.5f * maxScale;
+
+    // Camera inside the sphere: treat as full screen
+    const float distance = glm::length(center - m_cameraPosition);
+    if (distance <= radius) {
+        return 1.0f;
+    }
+
+    // Projected diameter over the screen height (2 * tan(fov / 2) * distance)
+    return radius * m_projectionScale / distance;
+}
+
+uint32_t LODSelector::SelectLOD(float screenSize, uint32_t currentLOD, uint32_t lodCount) {
+    if (lodCount <= 1) {
+        return 0;
+    }
+
+    const uint32_t maxLOD = std::min(lodCount, MAX_MESH_LODS) - 1;
+    const float size = screenSize * m_config.lodBias;
+    uint32_t lod = std::min(currentLOD, maxLOD);
+
+    // Coarsen while the object is clearly below the current LOD's threshold
+    while (lod < maxLOD && size < m_config.thresholds[lod] * (1.0f - m_config.hysteresis)) {
+        ++lod;
+    }
+
+    // Refine while the object is clearly above the previous LOD's threshold
+    while (lod > 0 && size > m_config.thresholds[lod - 1] * (1.0f + m_config.hysteresis)) {
+        --lod;
+    }
+
+    m_stats.selections++;
+    m_stats.lodHistogram[lod]++;
+    if (lod != currentLOD) {
+        m_stats.transitions++;
+    }
+    return lod;
+}
+
+void LODSelector::PrintStats() const {
+    printf("=== LOD Selector Stats ===\n");
+    printf("Selections: %u (transitions: %u)\n", m_stats.selections, m_stats.transitions);
+    for (uint32_t lod = 0; lod < MAX_MESH_LODS; ++lod) {
+        printf("  LOD %u: %u\n", lod, m_stats.lodHistogram[lod]);
+    }
+    printf("==========================\n");
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "resources/RenderTypes.h"
+
+// =============================================================================
+// LOD Selector
+// =============================================================================
+
+// Picks a discrete LOD from the projected size of an object's bounding sphere,
+// expressed as a fraction of the screen height (1.0 = fills the screen
+// vertically). Switching to a coarser LOD requires the size to drop a
+// hysteresis margin below the threshold, switching back requires it to rise
+// the same margin above, so objects sitting on a boundary do not pop.
+class LODSelector {
+public:
+    struct Config {
+        // Screen size below which LOD i + 1 is used instead of LOD i
+        float thresholds[MAX_MESH_LODS - 1] = { 0.5f, 0.25f, 0.12f, 0.06f };
+        float hysteresis = 0.1f;    // Relative margin around each threshold
+        float lodBias = 1.0f;       // Scales screen size, < 1 picks coarser LODs
+    };
+
+    struct Statistics {
+        uint32_t selections = 0;
+        uint32_t transitions = 0;
+        uint32_t lodHistogram[MAX_MESH_LODS] = {};
+    };
+
+    LODSelector();
+    explicit LODSelector(const Config& config);
+
+    void SetConfig(const Config& config) { m_config = config; }
+    const Config& GetConfig() const { return m_config; }
+
+    // Camera position and vertical field of view (degrees, as stored by Camera)
+    void BeginFrame(const glm::vec3& cameraPosition, float fovYDegrees);
+
+    // Projected diameter of the bounds' sphere over the screen height
+    float ComputeScreenSize(const MeshBounds& bounds, const glm::mat4& model) const;
+
+    // Returns the LOD for screenSize, given the LOD used last frame
+    uint32_t SelectLOD(float screenSize, uint32_t currentLOD, uint32_t lodCount);
+
+    const Statistics& GetStatistics() const { return m_stats; }
+    void PrintStats() const;
+
+private:
+    Config m_config;
+    glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+    float m_projectionScale = 1.0f;     // 1 / tan(fovY / 2)
+
+    Statistics m_stats;
+};
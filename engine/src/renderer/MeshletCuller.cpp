@@ -0,0 +1,113 @@
+#include "MeshletCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+void MeshletCuller::BeginView(const glm::mat4& viewProj, const glm::vec3& cameraPosition) {
+    // Gribb/Hartmann: planes are sums/differences of the matrix rows. Near
+    // uses the -w..w depth range, which is also safe (looser) for 0..w.
+    const glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+    const glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+    const glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+    const glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+    m_planes[0] = row3 + row0;  // Left
+    m_planes[1] = row3 - row0;  // Right
+    m_planes[2] = row3 + row1;  // Bottom
+    m_planes[3] = row3 - row1;  // Top
+    m_planes[4] = row3 + row2;  // Near
+    m_planes[5] = row3 - row2;  // Far
+
+    for (glm::vec4& plane : m_planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+
+    m_cameraPosition = cameraPosition;
+    m_stats = Statistics();
+}
+
+MeshletCuller::InstanceSpace MeshletCuller::MakeInstanceSpace(const glm::mat4& model) const {
+    InstanceSpace space;
+
+    const glm::mat3 linear(model);
+    const float scaleSq = std::max({ glm::dot(linear[0], linear[0]),
+                                     glm::dot(linear[1], linear[1]),
+                                     glm::dot(linear[2], linear[2]) });
+    space.radiusScale = std::sqrt(scaleSq);
+
+    // Facing survives any affine transform that keeps orientation, so the
+    // cone is tested in object space against the camera brought there
+    const float determinant = glm::determinant(linear);
+    space.coneTest = determinant > 0.0f;
+    space.cameraPosition = space.coneTest ? glm::vec3(glm::inverse(model) * glm::vec4(m_cameraPosition, 1.0f))
+                                          : glm::vec3(0.0f);
+    return space;
+}
+
+MeshletCuller::Result MeshletCuller::Classify(const MeshletBounds& bounds, const glm::mat4& model) const {
+    return Classify(bounds, model, MakeInstanceSpace(model));
+}
+
+MeshletCuller::Result MeshletCuller::Classify(const MeshletBounds& bounds, const glm::mat4& model,
+                                              const InstanceSpace& space) const {
+    const glm::vec3 center(bounds.center[0], bounds.center[1], bounds.center[2]);
+
+    // Sphere against the frustum, in world space
+    const glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+    const float worldRadius = bounds.radius * space.radiusScale;
+    for (const glm::vec4& plane : m_planes) {
+        if (glm::dot(glm::vec3(plane), worldCenter) + plane.w < -worldRadius) {
+            return Result::FrustumCulled;
+        }
+    }
+
+    // Every triangle faces away when the whole sphere sits inside the
+    // cone's back side as seen from the camera
+    if (space.coneTest) {
+        const glm::vec3 axis(bounds.coneAxis[0], bounds.coneAxis[1], bounds.coneAxis[2]);
+        const glm::vec3 toCenter = center - space.cameraPosition;
+        if (glm::dot(toCenter, axis) >= bounds.coneCutoff * glm::length(toCenter) + bounds.radius) {
+            return Result::BackfaceCulled;
+        }
+    }
+
+    return Result::Visible;
+}
+
+uint32_t MeshletCuller::CullMeshlets(const MeshletBounds* bounds, uint32_t count, const glm::mat4& model,
+                                     std::vector<uint32_t>& outVisible) {
+    const InstanceSpace space = MakeInstanceSpace(model);
+
+    uint32_t visible = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        switch (Classify(bounds[i], model, space)) {
+            case Result::Visible:
+                outVisible.push_back(i);
+                visible++;
+                break;
+            case Result::FrustumCulled: m_stats.frustumCulledMeshlets++; break;
+            case Result::BackfaceCulled: m_stats.backfaceCulledMeshlets++; break;
+        }
+    }
+
+    m_stats.testedMeshlets += count;
+    m_stats.visibleMeshlets += visible;
+    return visible;
+}
+
+// =============================================================================
+// Statistics and Debug
+// =============================================================================
+
+void MeshletCuller::PrintStats() const {
+    printf("=== MeshletCuller Stats ===\n");
+    printf("Tested Meshlets: %u\n", m_stats.testedMeshlets);
+    printf("Visible: %u\n", m_stats.visibleMeshlets);
+    printf("Frustum Culled: %u\n", m_stats.frustumCulledMeshlets);
+    printf("Backface Culled: %u (%.1f%%)\n", m_stats.backfaceCulledMeshlets,
+           m_stats.testedMeshlets > 0 ? 100.0f * m_stats.backfaceCulledMeshlets / m_stats.testedMeshlets : 0.0f);
+    printf("===========================\n");
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "resources/RenderTypes.h"
+
+// =============================================================================
+// Meshlet Culler
+// =============================================================================
+
+// CPU reference for per-meshlet culling: bounding sphere against the view
+// frustum, then the normal cone against the camera position. Mirrors what a
+// task/amplification shader does per cluster and doubles as its test oracle.
+// Pure CPU, no graphics API involved.
+//
+// Per view:
+//   BeginView(viewProj, cameraPosition)
+//   CullMeshlets(...) for every mesh instance
+class MeshletCuller {
+public:
+    enum class Result {
+        Visible,
+        FrustumCulled,
+        BackfaceCulled
+    };
+
+    struct Statistics {
+        uint32_t testedMeshlets = 0;
+        uint32_t visibleMeshlets = 0;
+        uint32_t frustumCulledMeshlets = 0;
+        uint32_t backfaceCulledMeshlets = 0;
+    };
+
+    // Extracts the frustum planes and resets statistics
+    void BeginView(const glm::mat4& viewProj, const glm::vec3& cameraPosition);
+
+    // Appends the indices (0..count-1) of the visible meshlets of one
+    // instance to outVisible and updates statistics; returns how many
+    uint32_t CullMeshlets(const MeshletBounds* bounds, uint32_t count, const glm::mat4& model,
+                          std::vector<uint32_t>& outVisible);
+
+    // Same test for a single meshlet without statistics, safe to call from
+    // several threads. Mirrored models skip the cone test, their winding flips.
+    Result Classify(const MeshletBounds& bounds, const glm::mat4& model) const;
+
+    const Statistics& GetStatistics() const { return m_stats; }
+    void PrintStats() const;
+
+private:
+    // Per-instance terms shared by every meshlet of the mesh
+    struct InstanceSpace {
+        glm::vec3 cameraPosition;   // Object space
+        float radiusScale;          // Largest axis scale of the model
+        bool coneTest;
+    };
+
+    InstanceSpace MakeInstanceSpace(const glm::mat4& model) const;
+    Result Classify(const MeshletBounds& bounds, const glm::mat4& model, const InstanceSpace& space) const;
+
+    glm::vec4 m_planes[6] = {};     // World space, xyz normalized, inside when dot >= 0
+    glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+    Statistics m_stats;
+};
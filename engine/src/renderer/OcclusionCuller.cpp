@@ -0,0 +1,353 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define OCCLUSION_USE_SSE2 0
+#endif
+
+OcclusionCuller::OcclusionCuller() {
+    AllocateLevels();
+}
+
+OcclusionCuller::OcclusionCuller(const Config& config)
+    : m_config(config)
+{
+    AllocateLevels();
+}
+
+void OcclusionCuller::SetConfig(const Config& config) {
+    m_config = config;
+    AllocateLevels();
+}
+
+void OcclusionCuller::AllocateLevels() {
+    // Rows are processed 4 pixels at a time
+    m_width = std::max((m_config.width + 3u) & ~3u, 4u);
+    m_height = std::max(m_config.height, 1u);
+
+    m_levels.clear();
+    uint32_t width = m_width;
+    uint32_t height = m_height;
+    while (true) {
+        DepthLevel level;
+        level.width = width;
+        level.height = height;
+        level.depth.assign(static_cast<size_t>(width) * height, 1.0f);
+        m_levels.push_back(std::move(level));
+
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+}
+
+// =============================================================================
+// Frame Management
+// =============================================================================
+
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProj) {
+    m_viewProj = viewProj;
+    m_stats = {};
+
+    std::vector<float>& depth = m_levels[0].depth;
+    std::fill(depth.begin(), depth.end(), 1.0f);
+}
+
+void OcclusionCuller::FinalizeOccluders() {
+    // Each texel keeps the farthest depth of the 2x2 (or wider at odd edges) block below it
+    for (size_t levelIndex = 1; levelIndex < m_levels.size(); ++levelIndex) {
+        const DepthLevel& src = m_levels[levelIndex - 1];
+        DepthLevel& dst = m_levels[levelIndex];
+
+        for (uint32_t y = 0; y < dst.height; ++y) {
+            uint32_t srcY0 = std::min(y * 2, src.height - 1);
+            uint32_t srcY1 = (y == dst.height - 1) ? src.height - 1 : std::min(y * 2 + 1, src.height - 1);
+
+            for (uint32_t x = 0; x < dst.width; ++x) {
+                uint32_t srcX0 = std::min(x * 2, src.width - 1);
+                uint32_t srcX1 = (x == dst.width - 1) ? src.width - 1 : std::min(x * 2 + 1, src.width - 1);
+
+                float maxDepth = 0.0f;
+                for (uint32_t sy = srcY0; sy <= srcY1; ++sy) {
+                    for (uint32_t sx = srcX0; sx <= srcX1; ++sx) {
+                        maxDepth = std::max(maxDepth, src.depth[sy * src.width + sx]);
+                    }
+                }
+                dst.depth[y * dst.width + x] = maxDepth;
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Rasterization
+// =============================================================================
+
+void OcclusionCuller::RasterizeOccluder(const OccluderGeometry& geometry, const glm::mat4& model) {
+    size_t vertexCount = geometry.positions.size() / 3;
+    if (vertexCount == 0 || geometry.indices.size() < 3) {
+        return;
+    }
+
+    m_stats.occluderMeshes++;
+
+    // Transform every vertex once, triangles share them through the index list
+    const glm::mat4 mvp = m_viewProj * model;
+    m_screenVertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* p = &geometry.positions[i * 3];
+        glm::vec4 clip = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+
+        ScreenVertex& sv = m_screenVertices[i];
+        sv.valid = clip.w > m_config.nearClipW;
+        if (!sv.valid) {
+            continue;
+        }
+
+        float invW = 1.0f / clip.w;
+        sv.x = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_width);
+        sv.y = (0.5f - clip.y * invW * 0.5f) * static_cast<float>(m_height);
+        sv.z = clip.z * invW * 0.5f + 0.5f;
+    }
+
+    size_t triangleCount = geometry.indices.size() / 3;
+    m_stats.occluderTriangles += static_cast<uint32_t>(triangleCount);
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        uint32_t i0 = geometry.indices[t * 3 + 0];
+        uint32_t i1 = geometry.indices[t * 3 + 1];
+        uint32_t i2 = geometry.indices[t * 3 + 2];
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+            continue;
+        }
+
+        const ScreenVertex& v0 = m_screenVertices[i0];
+        const ScreenVertex& v1 = m_screenVertices[i1];
+        const ScreenVertex& v2 = m_screenVertices[i2];
+
+        // No near plane clipping: dropping the triangle only loses occlusion, never correctness
+        if (!v0.valid || !v1.valid || !v2.valid) {
+            continue;
+        }
+
+        RasterizeTriangle(v0, v1, v2);
+    }
+}
+
+void OcclusionCuller::RasterizeTriangle(const ScreenVertex& v0, const ScreenVertex& in1, const ScreenVertex& in2) {
+    // Occluders are treated as double sided, wind everything the same way
+    float area = (in1.x - v0.x) * (in2.y - v0.y) - (in1.y - v0.y) * (in2.x - v0.x);
+    if (std::fabs(area) < 1e-8f) {
+        return;
+    }
+
+    const ScreenVertex& v1 = area > 0.0f ? in1 : in2;
+    const ScreenVertex& v2 = area > 0.0f ? in2 : in1;
+    area = std::fabs(area);
+
+    // Screen bounds, clamped to the buffer
+    float minX = std::min({ v0.x, v1.x, v2.x });
+    float maxX = std::max({ v0.x, v1.x, v2.x });
+    float minY = std::min({ v0.y, v1.y, v2.y });
+    float maxY = std::max({ v0.y, v1.y, v2.y });
+    float minZ = std::min({ v0.z, v1.z, v2.z });
+
+    if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height || minZ > 1.0f) {
+        return;
+    }
+
+    int x0 = std::max(static_cast<int>(std::floor(minX)), 0);
+    int x1 = std::min(static_cast<int>(std::ceil(maxX)), static_cast<int>(m_width) - 1);
+    int y0 = std::max(static_cast<int>(std::floor(minY)), 0);
+    int y1 = std::min(static_cast<int>(std::ceil(maxY)), static_cast<int>(m_height) - 1);
+    x0 &= ~3;
+
+    m_stats.rasterizedTriangles++;
+
+    // Edge functions E(x, y) = a*x + b*y + c, positive inside
+    auto makeEdge = [](const ScreenVertex& a, const ScreenVertex& b, float& ea, float& eb, float& ec) {
+        ea = a.y - b.y;
+        eb = b.x - a.x;
+        ec = a.x * b.y - a.y * b.x;
+    };
+
+    float a0, b0, c0, a1, b1, c1, a2, b2, c2;
+    makeEdge(v1, v2, a0, b0, c0);
+    makeEdge(v2, v0, a1, b1, c1);
+    makeEdge(v0, v1, a2, b2, c2);
+
+    // Depth plane from barycentrics: z = dzdx * x + dzdy * y + zAtOrigin
+    float invArea = 1.0f / area;
+    float dzdx = (a0 * v0.z + a1 * v1.z + a2 * v2.z) * invArea;
+    float dzdy = (b0 * v0.z + b1 * v1.z + b2 * v2.z) * invArea;
+    float zAtOrigin = (c0 * v0.z + c1 * v1.z + c2 * v2.z) * invArea;
+
+    std::vector<float>& depth = m_levels[0].depth;
+
+#if OCCLUSION_USE_SSE2
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 va0 = _mm_set1_ps(a0), va1 = _mm_set1_ps(a1), va2 = _mm_set1_ps(a2);
+    const __m128 vdzdx = _mm_set1_ps(dzdx);
+
+    for (int y = y0; y <= y1; ++y) {
+        float py = static_cast<float>(y) + 0.5f;
+        __m128 rowE0 = _mm_set1_ps(b0 * py + c0);
+        __m128 rowE1 = _mm_set1_ps(b1 * py + c1);
+        __m128 rowE2 = _mm_set1_ps(b2 * py + c2);
+        __m128 rowZ = _mm_set1_ps(dzdy * py + zAtOrigin);
+        float* row = &depth[static_cast<size_t>(y) * m_width];
+
+        for (int x = x0; x <= x1; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(va0, px), rowE0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(va1, px), rowE1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(va2, px), rowE2);
+
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                       _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            __m128 z = _mm_max_ps(_mm_add_ps(_mm_mul_ps(vdzdx, px), rowZ), zero);
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 closer = _mm_min_ps(current, z);
+            __m128 result = _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, current));
+            _mm_storeu_ps(row + x, result);
+        }
+    }
+#else
+    for (int y = y0; y <= y1; ++y) {
+        float py = static_cast<float>(y) + 0.5f;
+        float* row = &depth[static_cast<size_t>(y) * m_width];
+
+        for (int x = x0; x <= x1; ++x) {
+            float px = static_cast<float>(x) + 0.5f;
+            float e0 = a0 * px + b0 * py + c0;
+            float e1 = a1 * px + b1 * py + c1;
+            float e2 = a2 * px + b2 * py + c2;
+            if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) {
+                continue;
+            }
+
+            float z = std::max(dzdx * px + dzdy * py + zAtOrigin, 0.0f);
+            row[x] = std::min(row[x], z);
+        }
+    }
+#endif
+}
+
+// =============================================================================
+// Visibility Tests
+// =============================================================================
+
+OcclusionCuller::Result OcclusionCuller::Classify(const MeshBounds& bounds, const glm::mat4& model) const {
+    const glm::mat4 mvp = m_viewProj * model;
+
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    float minZ = std::numeric_limits<float>::max();
+
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec4 p(
+            (corner & 1) ? bounds.max[0] : bounds.min[0],
+            (corner & 2) ? bounds.max[1] : bounds.min[1],
+            (corner & 4) ? bounds.max[2] : bounds.min[2],
+            1.0f
+        );
+        glm::vec4 clip = mvp * p;
+
+        // Box crosses the camera plane, can't be rejected safely
+        if (clip.w <= m_config.nearClipW) {
+            return Result::Visible;
+        }
+
+        float invW = 1.0f / clip.w;
+        float sx = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_width);
+        float sy = (0.5f - clip.y * invW * 0.5f) * static_cast<float>(m_height);
+        float sz = clip.z * invW * 0.5f + 0.5f;
+
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, sz);
+    }
+
+    if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height || minZ > 1.0f) {
+        return Result::FrustumCulled;
+    }
+
+    int x0 = std::max(static_cast<int>(std::floor(minX)), 0);
+    int x1 = std::min(static_cast<int>(std::floor(maxX)), static_cast<int>(m_width) - 1);
+    int y0 = std::max(static_cast<int>(std::floor(minY)), 0);
+    int y1 = std::min(static_cast<int>(std::floor(maxY)), static_cast<int>(m_height) - 1);
+
+    // Walk up the pyramid until the footprint is small enough
+    uint32_t maxTexels = std::max(m_config.maxTestTexels, 1u);
+    size_t levelIndex = 0;
+    while (levelIndex + 1 < m_levels.size() &&
+           (static_cast<uint32_t>(x1 - x0) + 1 > maxTexels || static_cast<uint32_t>(y1 - y0) + 1 > maxTexels)) {
+        // Odd-sized edges are folded into the last texel of the next level
+        const DepthLevel& next = m_levels[levelIndex + 1];
+        x0 = std::min(x0 / 2, static_cast<int>(next.width) - 1);
+        x1 = std::min(x1 / 2, static_cast<int>(next.width) - 1);
+        y0 = std::min(y0 / 2, static_cast<int>(next.height) - 1);
+        y1 = std::min(y1 / 2, static_cast<int>(next.height) - 1);
+        levelIndex++;
+    }
+
+    const DepthLevel& level = m_levels[levelIndex];
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            // Any texel whose farthest occluder is behind the box leaves it visible
+            if (level.depth[static_cast<size_t>(y) * level.width + x] >= minZ) {
+                return Result::Visible;
+            }
+        }
+    }
+
+    return Result::Occluded;
+}
+
+OcclusionCuller::Result OcclusionCuller::TestBounds(const MeshBounds& bounds, const glm::mat4& model) {
+    Result result = Classify(bounds, model);
+
+    m_stats.testedObjects++;
+    switch (result) {
+        case Result::Visible: m_stats.visibleObjects++; break;
+        case Result::FrustumCulled: m_stats.frustumCulledObjects++; break;
+        case Result::Occluded: m_stats.occludedObjects++; break;
+    }
+
+    return result;
+}
+
+// =============================================================================
+// Statistics and Debug
+// =============================================================================
+
+void OcclusionCuller::PrintStats() const {
+    printf("=== OcclusionCuller Stats ===\n");
+    printf("Depth Buffer: %ux%u (%zu levels)\n", m_width, m_height, m_levels.size());
+    printf("Occluders: %u meshes, %u triangles (%u rasterized)\n",
+           m_stats.occluderMeshes, m_stats.occluderTriangles, m_stats.rasterizedTriangles);
+    printf("Tested Objects: %u\n", m_stats.testedObjects);
+    printf("Visible: %u\n", m_stats.visibleObjects);
+    printf("Frustum Culled: %u\n", m_stats.frustumCulledObjects);
+    printf("Occluded: %u (%.1f%%)\n", m_stats.occludedObjects,
+           m_stats.testedObjects > 0 ? 100.0f * m_stats.occludedObjects / m_stats.testedObjects : 0.0f);
+    printf("=============================\n");
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "resources/RenderTypes.h"
+
+// =============================================================================
+// Software Occlusion Culler
+// =============================================================================
+
+// Rasterizes occluder triangles into a small CPU depth buffer, reduces it into
+// a max-depth pyramid and tests object bounds against it. Depth is NDC z
+// remapped to [0, 1], smaller is closer. Pure CPU, no graphics API involved.
+//
+// Per frame:
+//   BeginFrame(viewProj)
+//   RasterizeOccluder(...) for every occluder
+//   FinalizeOccluders()
+//   TestBounds(...) for every candidate
+class OcclusionCuller {
+public:
+    struct Config {
+        uint32_t width = 256;              // Rounded up to a multiple of 4
+        uint32_t height = 128;
+        float nearClipW = 1e-3f;           // Triangles/boxes crossing w below this are not culled
+        uint32_t maxTestTexels = 4;        // Pyramid level picked so a box spans at most NxN texels
+    };
+
+    enum class Result {
+        Visible,
+        FrustumCulled,
+        Occluded
+    };
+
+    struct Statistics {
+        uint32_t occluderMeshes = 0;
+        uint32_t occluderTriangles = 0;
+        uint32_t rasterizedTriangles = 0;
+        uint32_t testedObjects = 0;
+        uint32_t visibleObjects = 0;
+        uint32_t frustumCulledObjects = 0;
+        uint32_t occludedObjects = 0;
+    };
+
+    OcclusionCuller();
+    explicit OcclusionCuller(const Config& config);
+
+    void SetConfig(const Config& config);
+    const Config& GetConfig() const { return m_config; }
+
+    // Clears the depth buffer and statistics
+    void BeginFrame(const glm::mat4& viewProj);
+
+    // Draws an occluder mesh transformed by model into the depth buffer
+    void RasterizeOccluder(const OccluderGeometry& geometry, const glm::mat4& model);
+
+    // Builds the max-depth pyramid, call after the last occluder
+    void FinalizeOccluders();
+
+    // Tests object-space bounds transformed by model and updates statistics
+    Result TestBounds(const MeshBounds& bounds, const glm::mat4& model);
+
+    // Same test without statistics, safe to call from several threads
+    // once FinalizeOccluders has run
+    Result Classify(const MeshBounds& bounds, const glm::mat4& model) const;
+
+    const Statistics& GetStatistics() const { return m_stats; }
+    void PrintStats() const;
+
+    // Debug access to the full resolution depth buffer
+    const std::vector<float>& GetDepthBuffer() const { return m_levels[0].depth; }
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+
+private:
+    struct DepthLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> depth;
+    };
+
+    // Screen space vertex: pixel coordinates plus [0, 1] depth
+    struct ScreenVertex {
+        float x, y, z;
+        bool valid;
+    };
+
+    void AllocateLevels();
+    void RasterizeTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2);
+
+    Config m_config;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+
+    glm::mat4 m_viewProj = glm::mat4(1.0f);
+    std::vector<DepthLevel> m_levels;
+    std::vector<ScreenVertex> m_screenVertices;
+
+    Statistics m_stats;
+};
@@ -0,0 +1,112 @@
+#include "ParallelDrawRecorder.h"
+#include "Renderer.h"
+#include "jobs/JobSystem.h"
+#include "resources/UniformManager.h"
+#include <algorithm>
+
+void ParallelDrawRecorder::Record(Renderer* renderer,
+                                  JobSystem* jobSystem,
+                                  UniformManager* uniformManager,
+                                  CommandList* cmdList,
+                                  const std::vector<DrawItem>& items,
+                                  const DrawEncodeFn& encode,
+                                  const SetupFn& setup) {
+    m_lastChunkCount = 0;
+    m_lastDrawCount = 0;
+
+    if (!renderer || !cmdList || items.empty()) {
+        return;
+    }
+
+    uint32_t maxChunks = std::min(m_config.maxChunks, renderer->GetWorkerContextCount());
+    if (!jobSystem) {
+        maxChunks = 1;
+    }
+
+    m_chunks = SplitDrawChunks(static_cast<uint32_t>(items.size()), maxChunks, m_config.minDrawsPerChunk);
+    uint32_t chunkCount = static_cast<uint32_t>(m_chunks.size());
+
+    // Small lists: encode and replay on the caller's list, no extra submission
+    if (chunkCount <= 1) {
+        EncodeDrawChunks(nullptr, items, m_chunks, encode, m_streams);
+        Replay(m_streams[0], cmdList, uniformManager);
+
+        m_lastChunkCount = 1;
+        m_lastDrawCount = m_streams[0].GetDrawCount();
+        return;
+    }
+
+    if (m_streams.size() < chunkCount) {
+        m_streams.resize(chunkCount);
+    }
+    m_workerLists.assign(chunkCount, nullptr);
+
+    // Encode + replay + close on the worker that owns the chunk
+    jobSystem->ParallelFor(chunkCount, [&](uint32_t chunkIndex) {
+        const DrawChunk& chunk = m_chunks[chunkIndex];
+        DrawStream& stream = m_streams[chunkIndex];
+        stream.Clear();
+        encode(items.data() + chunk.begin, chunk.GetCount(), stream);
+
+        CommandList* workerList = renderer->BeginWorkerCommandList(chunkIndex);
+        if (!workerList) {
+            return;
+        }
+
+        setup(workerList);
+        Replay(stream, workerList, uniformManager);
+
+        if (workerList->Close()) {
+            m_workerLists[chunkIndex] = workerList;
+        }
+    });
+
+    // Drop chunks whose list failed, order of the rest is preserved
+    m_workerLists.erase(std::remove(m_workerLists.begin(), m_workerLists.end(), nullptr), m_workerLists.end());
+    renderer->ExecuteWorkerCommandLists(m_workerLists.data(), static_cast<UINT>(m_workerLists.size()));
+
+    m_lastChunkCount = chunkCount;
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        m_lastDrawCount += m_streams[i].GetDrawCount();
+    }
+}
+
+void ParallelDrawRecorder::Replay(const DrawStream& stream, CommandList* cmdList, UniformManager* uniformManager) {
+    ID3D12GraphicsCommandList* d3dCmdList = cmdList->GetCommandList();
+    if (!d3dCmdList) {
+        return;
+    }
+
+    for (const DrawCommand& cmd : stream.GetCommands()) {
+        switch (cmd.type) {
+            case DrawCommandType::SetConstants: {
+                if (!uniformManager) {
+                    break;
+                }
+                UniformManager::UniformHandle handle;
+                handle.gpuAddress = cmd.gpuAddress;
+                handle.descriptorIndex = cmd.descriptorIndex;
+                uniformManager->SetGraphicsRootDescriptorTable(d3dCmdList, cmd.rootParameter, handle);
+                break;
+            }
+            case DrawCommandType::SetIndexBuffer: {
+                D3D12_INDEX_BUFFER_VIEW indexView = {};
+                indexView.BufferLocation = cmd.indexBuffer.gpuAddress;
+                indexView.SizeInBytes = cmd.indexBuffer.sizeInBytes;
+                indexView.Format = cmd.indexBuffer.format == IndexFormat::Uint16 ? DXGI_FORMAT_R16_UINT
+                                                                                  : DXGI_FORMAT_R32_UINT;
+                d3dCmdList->IASetIndexBuffer(&indexView);
+                break;
+            }
+            case DrawCommandType::DrawIndexed:
+                d3dCmdList->DrawIndexedInstanced(
+                    cmd.draw.indexCount,
+                    cmd.draw.instanceCount,
+                    cmd.draw.startIndex,
+                    cmd.draw.baseVertex,
+                    cmd.draw.startInstance
+                );
+                break;
+        }
+    }
+}
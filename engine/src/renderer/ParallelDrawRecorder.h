@@ -0,0 +1,58 @@
+#pragma once
+
+#include "DrawStream.h"
+#include "dx12/core/CommandList.h"
+#include <functional>
+#include <vector>
+
+class Renderer;
+class UniformManager;
+
+// =============================================================================
+// Parallel Draw Recorder
+// =============================================================================
+
+// Splits the visible list into chunks, encodes each chunk on a worker into a
+// DrawStream and replays it into that worker's own command list. The worker
+// lists are submitted in chunk order, so the GPU sees the same sequence as a
+// serial recording.
+class ParallelDrawRecorder {
+public:
+    struct Config {
+        uint32_t minDrawsPerChunk = 512;   // Below this a chunk is not worth a command list
+        uint32_t maxChunks = 8;            // Clamped to the renderer's worker context count
+    };
+
+    // Binds render targets and pipeline state on a freshly reset worker list
+    using SetupFn = std::function<void(CommandList* cmdList)>;
+
+    // Records items onto cmdList directly when the list is small, otherwise
+    // fans out to worker command lists and submits them after cmdList.
+    void Record(Renderer* renderer,
+                JobSystem* jobSystem,
+                UniformManager* uniformManager,
+                CommandList* cmdList,
+                const std::vector<DrawItem>& items,
+                const DrawEncodeFn& encode,
+                const SetupFn& setup);
+
+    // Translate a backend-neutral stream into D3D12 calls
+    static void Replay(const DrawStream& stream, CommandList* cmdList, UniformManager* uniformManager);
+
+    void SetConfig(const Config& config) { m_config = config; }
+    const Config& GetConfig() const { return m_config; }
+
+    // Stats from the last Record call
+    uint32_t GetLastChunkCount() const { return m_lastChunkCount; }
+    uint32_t GetLastDrawCount() const { return m_lastDrawCount; }
+
+private:
+    Config m_config;
+
+    std::vector<DrawChunk> m_chunks;
+    std::vector<DrawStream> m_streams;
+    std::vector<CommandList*> m_workerLists;
+
+    uint32_t m_lastChunkCount = 0;
+    uint32_t m_lastDrawCount = 0;
+};
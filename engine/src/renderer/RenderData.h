@@ -4,6 +4,9 @@
 #include "renderer/Renderer.h"
 #include "resources/GeometryManager.h"
 #include "resources/UniformManager.h"
+#include "jobs/JobSystem.h"
+#include "OcclusionCuller.h"
+#include "LODSelector.h"
 
 #include <components/Camera.h>
 #include <entt/entt.hpp>
@@ -15,6 +18,10 @@ struct RenderContext {
     entt::registry& registry;
     GeometryManager* geometryManager;
     UniformManager* uniformManager = nullptr;
+    JobSystem* jobSystem = nullptr;
+    OcclusionCuller* occlusionCuller = nullptr;
+    LODSelector* lodSelector = nullptr;
+    bool indirectDraws = false;
     // TextureManager* textureManager;
     // MaterialManager* materialManager;
     // ShaderManager* shaderManager;
@@ -1,6 +1,9 @@
 #include "Renderer.h"
+#include <algorithm>
 
-Renderer::Renderer(HWND hwnd, const EngineConfig& config) {
+Renderer::Renderer(HWND hwnd, const EngineConfig& config)
+    : m_workerContextCount(config.renderWorkerContexts)
+{
     m_device = std::make_unique<DX12Device>();
     if (!m_device->Initialize(config.enableDebugLayer)) {
         throw std::runtime_error("Failed to initialize device");
@@ -50,6 +53,17 @@ Renderer::Renderer(HWND hwnd, const EngineConfig& config) {
                                    D3D12_COMMAND_LIST_TYPE_DIRECT)) {
         throw std::runtime_error("Failed to create command list");
     }
+
+    // Create worker command lists for parallel draw recording
+    m_workerCommandLists.resize(m_workerContextCount);
+    for (UINT i = 0; i < m_workerContextCount; i++) {
+        m_workerCommandLists[i] = std::make_unique<CommandList>();
+        if (!m_workerCommandLists[i]->Initialize(device,
+                                                 m_frameResources[0].workerAllocators[i].get(),
+                                                 D3D12_COMMAND_LIST_TYPE_DIRECT)) {
+            throw std::runtime_error("Failed to create worker command list");
+        }
+    }
 }
 
 Renderer::~Renderer() {
@@ -69,6 +83,7 @@ Renderer::~Renderer() {
 
     printf("Rleasing GPU Resources...\n");
     m_frameResources.clear();
+    m_workerCommandLists.clear();
     m_commandList.reset();
     m_swapChain.reset();
     m_commandManager.reset();
@@ -95,6 +110,15 @@ bool Renderer::InitializeFrameResources() {
             throw std::runtime_error("Failed to create command allocator for frame");
         }
 
+        // One allocator per worker context, allocators are not free-threaded
+        frame.workerAllocators.resize(m_workerContextCount);
+        for (UINT worker = 0; worker < m_workerContextCount; worker++) {
+            frame.workerAllocators[worker] = std::make_unique<CommandAllocator>();
+            if (!frame.workerAllocators[worker]->Initialize(device, D3D12_COMMAND_LIST_TYPE_DIRECT)) {
+                throw std::runtime_error("Failed to create worker command allocator for frame");
+            }
+        }
+
         // Create fence for this frame
         ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&frame.frameFence)));
 
@@ -176,6 +200,13 @@ CommandList* Renderer::BeginFrame() {
         return nullptr;
     }
 
+    for (auto& workerAllocator : currentFrame.workerAllocators) {
+        if (!workerAllocator->Reset()) {
+            printf("Failed to reset worker command allocator for frame %u\n", m_currentFrameIndex);
+            return nullptr;
+        }
+    }
+
     // Reset command list with current frame's allocator
     if (!m_commandList->Reset(currentFrame.commandAllocator.get())) {
         printf("Failed to reset command list for frame %u\n", m_currentFrameIndex);
@@ -219,6 +250,45 @@ void Renderer::EndFrame(const EngineConfig& config) {
     m_swapChain->Present(config.vsync);
 }
 
+CommandList* Renderer::BeginWorkerCommandList(UINT workerIndex) {
+    if (workerIndex >= m_workerContextCount) {
+        printf("BeginWorkerCommandList: Invalid worker index %u\n", workerIndex);
+        return nullptr;
+    }
+
+    FrameResources& currentFrame = m_frameResources[m_currentFrameIndex];
+    CommandList* workerList = m_workerCommandLists[workerIndex].get();
+    if (!workerList->Reset(currentFrame.workerAllocators[workerIndex].get())) {
+        printf("Failed to reset worker command list %u for frame %u\n", workerIndex, m_currentFrameIndex);
+        return nullptr;
+    }
+
+    return workerList;
+}
+
+void Renderer::ExecuteWorkerCommandLists(CommandList* const* workerLists, UINT count) {
+    if (!m_commandList->Close()) {
+        throw std::runtime_error("Failed to close command list before worker submission");
+    }
+
+    // Main list first so clears and barriers recorded so far precede the draws
+    std::vector<ID3D12CommandList*> commandLists;
+    commandLists.reserve(count + 1);
+    commandLists.push_back(m_commandList->GetCommandList());
+    for (UINT i = 0; i < count; i++) {
+        commandLists.push_back(workerLists[i]->GetCommandList());
+    }
+
+    m_commandManager->GetGraphicsQueue()->ExecuteCommandLists(
+        static_cast<uint32_t>(commandLists.size()), commandLists.data());
+
+    // Reopen the main list on the same allocator for the remainder of the frame
+    FrameResources& currentFrame = m_frameResources[m_currentFrameIndex];
+    if (!m_commandList->Reset(currentFrame.commandAllocator.get())) {
+        throw std::runtime_error("Failed to reopen command list after worker submission");
+    }
+}
+
 // =============================================================================
 // Synchronization
 // =============================================================================
@@ -245,6 +315,26 @@ void Renderer::WaitForFrame(UINT frameIndex) {
     WaitForSingleObject(frame.fenceEvent, INFINITE);
 }
 
+void Renderer::WaitForCopyQueue(UINT64 copyFenceValue) {
+    if (copyFenceValue == 0) {
+        return;
+    }
+
+    m_commandManager->GetGraphicsQueue()->WaitForQueue(*m_commandManager->GetCopyQueue(), copyFenceValue);
+}
+
+UINT64 Renderer::GetCompletedFenceValue() const {
+    // One queue executes in order, so the highest completed value on any
+    // frame fence means everything signaled before it has completed too
+    UINT64 completedValue = 0;
+    for (const FrameResources& frame : m_frameResources) {
+        if (frame.frameFence) {
+            completedValue = std::max(completedValue, frame.frameFence->GetCompletedValue());
+        }
+    }
+    return completedValue;
+}
+
 void Renderer::WaitForAllFrames() {
     for (UINT i = 0; i < m_frameResources.size(); i++) {
         WaitForFrame(i);
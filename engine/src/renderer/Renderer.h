@@ -17,6 +17,28 @@ public:
     CommandList* BeginFrame();
     void EndFrame(const EngineConfig& config);
 
+    // Parallel recording: one command list per worker context, reset with the frame.
+    // ExecuteWorkerCommandLists submits the main list followed by the worker
+    // lists in the given order, then reopens the main list for the rest of the frame.
+    UINT GetWorkerContextCount() const { return m_workerContextCount; }
+    CommandList* BeginWorkerCommandList(UINT workerIndex);
+    void ExecuteWorkerCommandLists(CommandList* const* workerLists, UINT count);
+
+    // Index of the frame resources in use, its previous GPU work has completed
+    UINT GetCurrentFrameIndex() const { return m_currentFrameIndex; }
+
+    // Fence values come from one counter shared by all frames. Work recorded
+    // so far is covered by GetPendingFenceValue(); it has finished on the GPU
+    // once GetCompletedFenceValue() reaches that value.
+    UINT64 GetPendingFenceValue() const { return m_nextFenceValue; }
+    UINT64 GetCompletedFenceValue() const;
+
+    // Dedicated copy queue for async uploads. Its fence values are a separate
+    // timeline; WaitForCopyQueue makes graphics work submitted from here on
+    // wait for a copy fence value on the GPU.
+    CommandQueue* GetCopyQueue() const { return m_commandManager->GetCopyQueue(); }
+    void WaitForCopyQueue(UINT64 copyFenceValue);
+
     void WaitForFrame(UINT frameIndex);
     void WaitForAllFrames();
     bool IsFrameComplete(UINT frameIndex) const;
@@ -61,4 +83,7 @@ private:
     UINT64 m_nextFenceValue = 1;
 
     std::unique_ptr<CommandList> m_commandList;
+
+    UINT m_workerContextCount = 0;
+    std::vector<std::unique_ptr<CommandList>> m_workerCommandLists;
 };
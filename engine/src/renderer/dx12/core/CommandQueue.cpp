@@ -85,6 +85,17 @@ void CommandQueue::WaitForFenceValue(uint64_t fenceValue) {
     assert(result == WAIT_OBJECT_0);
 }
 
+void CommandQueue::WaitForQueue(const CommandQueue& other, uint64_t fenceValue) {
+    assert(m_commandQueue && other.m_fence);
+
+    if (other.IsFenceComplete(fenceValue)) {
+        return; // Nothing to wait for
+    }
+
+    HRESULT hr = m_commandQueue->Wait(other.m_fence.Get(), fenceValue);
+    assert(SUCCEEDED(hr));
+}
+
 void CommandQueue::Flush() {
     // Signal and wait for the latest fence value
     uint64_t latestFenceValue = Signal();
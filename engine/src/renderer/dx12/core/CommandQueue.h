@@ -23,6 +23,10 @@ public:
     bool IsFenceComplete(uint64_t fenceValue) const;
     void WaitForFenceValue(uint64_t fenceValue);
 
+    // GPU-side wait: work submitted to this queue afterwards starts once
+    // the other queue's fence reaches fenceValue. Does not block the CPU.
+    void WaitForQueue(const CommandQueue& other, uint64_t fenceValue);
+
     // Wait for all GPU work to complete
     void Flush();
 
@@ -20,6 +20,7 @@ public:
 
     // Update for dynamic buffers
     bool Update(const void* data, UINT64 size, UINT64 offset = 0);
+    void* GetMappedData() const { return m_mappedData; }    // Persistently mapped, dynamic only
 
     // View creation
     D3D12_VERTEX_BUFFER_VIEW GetVertexView() const;
@@ -4,6 +4,7 @@
 
 struct FrameResources {
     std::unique_ptr<CommandAllocator> commandAllocator;
+    std::vector<std::unique_ptr<CommandAllocator>> workerAllocators;
     ComPtr<ID3D12Fence> frameFence;
     UINT64 fenceValue = 0;
     HANDLE fenceEvent = nullptr;
@@ -22,6 +23,7 @@ struct FrameResources {
     // Move semantics
     FrameResources(FrameResources&& other) noexcept
         : commandAllocator(std::move(other.commandAllocator))
+        , workerAllocators(std::move(other.workerAllocators))
         , frameFence(std::move(other.frameFence))
         , fenceValue(other.fenceValue)
         , fenceEvent(other.fenceEvent)
@@ -39,6 +41,7 @@ struct FrameResources {
 
             // Move from other
             commandAllocator = std::move(other.commandAllocator);
+            workerAllocators = std::move(other.workerAllocators);
             frameFence = std::move(other.frameFence);
             fenceValue = other.fenceValue;
             fenceEvent = other.fenceEvent;
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "RenderPass.h"
+#include "../ParallelDrawRecorder.h"
+#include "../IndirectDrawRecorder.h"
+#include "components/Renderable.h"
 // #include "../renderer/dx12/"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <entt/entt.hpp>
+#include <algorithm>
+#include <unordered_map>
 
 class ForwardPass : public RenderPass {
 public:
+    // The input layout follows the geometry manager's vertex layout
+    explicit ForwardPass(const VertexLayout& vertexLayout = VertexLayout::Float())
+        : m_vertexLayout(vertexLayout) {}
     ~ForwardPass() = default;
 
     virtual bool Initialize(ID3D12Device* device, ShaderManager* shaderManager) {
@@ -18,7 +26,9 @@ public:
         }
 
         CreateRootSignature(device);
-        CreatePipelineState(device);
+        CreateIndirectRootSignature(device);
+        CreatePipelineState(device, m_rootSignature.Get(), m_pipelineState);
+        CreatePipelineState(device, m_indirectRootSignature.Get(), m_indirectPipelineState);
         return true;
     }
 
@@ -32,26 +42,17 @@ public:
             return;
         }
 
-        ctx.renderer->SetupRenderTarget(cmdList);
-        ctx.renderer->SetupViewportAndScissor(cmdList);
-
         if (!ctx.uniformManager) {
             printf("ForwardPass: UniformManager not available in context\n");
             return;
         }
 
-        ID3D12GraphicsCommandList* d3dCmdList = cmdList->GetCommandList();
-        ctx.uniformManager->BindDescriptorHeap(d3dCmdList);
-        if (!d3dCmdList) {
+        if (!cmdList->GetCommandList()) {
             printf("ForwardPass: Failed to get D3D12 command list\n");
             return;
         }
 
-        d3dCmdList->SetPipelineState(m_pipelineState.Get());
-        d3dCmdList->SetGraphicsRootSignature(m_rootSignature.Get());
-        d3dCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-        ctx.geometryManager->BindVertexIndexBuffers(cmdList);
+        SetupPipeline(cmdList, ctx);
 
         float clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
         ctx.renderer->ClearBackBuffer(cmdList, clearColor);
@@ -60,27 +61,30 @@ public:
         // TODO: Instance rendering
         // Upload all model matrices to a buffer, then use instanced drawing
 
-        glm::mat4 targetVp = ctx.targetCamera->getProjectionMatrix() * ctx.targetCamera->getViewMatrix();
-        auto meshView = ctx.registry.view<MeshHandle, ModelMatrix>();
-        for (auto entity : meshView) {
-            const MeshHandle meshHandle = ctx.registry.get<MeshHandle>(entity);
-            const auto& modelMatrix = ctx.registry.get<ModelMatrix>(entity);
+        const glm::mat4 targetVp = ctx.targetCamera->getProjectionMatrix() * ctx.targetCamera->getViewMatrix();
+        GatherVisibleItems(ctx, targetVp);
+        WaitForMeshUploads(ctx);
 
-            glm::mat4 mvp = targetVp * modelMatrix.matrix;
+        // Indirect mode: one ExecuteIndirect instead of per-draw API calls
+        if (ctx.indirectDraws && EnsureIndirectRecorder(ctx)) {
+            RecordIndirect(cmdList, targetVp, ctx);
+            return;
+        }
 
-            // Upload MVP for this draw call
-            auto mvpUniform = ctx.uniformManager->UploadUniform(&mvp, sizeof(glm::mat4));
-            if (!mvpUniform.IsValid()) {
-                printf("ForwardPass: Failed to upload MVP constants for entity\n");
-                continue;
+        // Record draws, large lists are split across worker command lists
+        m_drawRecorder.Record(
+            ctx.renderer,
+            ctx.jobSystem,
+            ctx.uniformManager,
+            cmdList,
+            m_drawItems,
+            [&](const DrawItem* items, uint32_t count, DrawStream& out) {
+                EncodeDraws(items, count, targetVp, ctx, out);
+            },
+            [&](CommandList* workerList) {
+                SetupPipeline(workerList, ctx);
             }
-
-            // Bind MVP uniform for this entity
-            ctx.uniformManager->SetGraphicsRootDescriptorTable(d3dCmdList, 0, mvpUniform);
-
-            // Draw this entity's mesh
-            DrawMesh(cmdList, ctx.geometryManager, meshHandle);
-        }
+        );
     }
 
     virtual char* GetName() const override { return "Forward Pass"; }
@@ -97,9 +101,229 @@ public:
 
 private:
     ShaderManager* m_shaderManager = nullptr;
+    VertexLayout m_vertexLayout;
     ShaderHandle m_vertexShaderHandle = INVALID_SHADER_HANDLE;
     ShaderHandle m_pixelShaderHandle = INVALID_SHADER_HANDLE;
 
+    std::vector<DrawItem> m_drawItems;
+    ParallelDrawRecorder m_drawRecorder;
+
+    // Indirect path: root CBV instead of a descriptor table so records can set it
+    ComPtr<ID3D12RootSignature> m_indirectRootSignature;
+    ComPtr<ID3D12PipelineState> m_indirectPipelineState;
+    IndirectDrawRecorder m_indirectRecorder;
+    bool m_indirectInitFailed = false;
+
+    std::vector<MeshView> m_meshTable;
+    std::unordered_map<uint64_t, uint32_t> m_meshSlots;
+    std::vector<IndirectDrawSource> m_indirectSources[2];   // By IndexFormat
+    std::vector<IndirectDrawRecord> m_indirectRecords;
+    std::vector<IndirectDrawRecord> m_indirectRecords32;
+    IndirectDrawScratch m_indirectScratch;
+
+    // Builds m_drawItems, dropping entities hidden behind occluders when a culler
+    // is set and picking a LOD per entity when a selector is set
+    void GatherVisibleItems(const RenderContext& ctx, const glm::mat4& viewProj) {
+        m_drawItems.clear();
+        auto meshView = ctx.registry.view<MeshHandle, ModelMatrix>();
+
+        if (ctx.lodSelector) {
+            ctx.lodSelector->BeginFrame(ctx.targetCamera->getPosition(), ctx.targetCamera->getFov());
+        }
+
+        OcclusionCuller* culler = ctx.occlusionCuller;
+        if (!culler) {
+            for (auto entity : meshView) {
+                const MeshHandle meshHandle = meshView.get<MeshHandle>(entity);
+                const glm::mat4& model = meshView.get<ModelMatrix>(entity).matrix;
+                m_drawItems.push_back({ meshHandle, model, SelectLOD(ctx, entity, meshHandle, model) });
+            }
+            return;
+        }
+
+        // Render designated occluders into the software depth buffer
+        culler->BeginFrame(viewProj);
+        auto occluderView = ctx.registry.view<Occluder, MeshHandle, ModelMatrix>();
+        for (auto entity : occluderView) {
+            const OccluderGeometry* geometry = ctx.geometryManager->GetOccluderGeometry(occluderView.get<MeshHandle>(entity));
+            if (geometry) {
+                culler->RasterizeOccluder(*geometry, occluderView.get<ModelMatrix>(entity).matrix);
+            }
+        }
+        culler->FinalizeOccluders();
+
+        // Test every candidate's bounds against it
+        for (auto entity : meshView) {
+            const MeshHandle meshHandle = meshView.get<MeshHandle>(entity);
+            const glm::mat4& model = meshView.get<ModelMatrix>(entity).matrix;
+
+            const MeshBounds* bounds = ctx.geometryManager->GetMeshBounds(meshHandle);
+            if (bounds && culler->TestBounds(*bounds, model) != OcclusionCuller::Result::Visible) {
+                continue;
+            }
+            m_drawItems.push_back({ meshHandle, model, SelectLOD(ctx, entity, meshHandle, model) });
+        }
+    }
+
+    // Meshes whose async copy is still in flight are drawn behind a GPU wait
+    // on the copy queue. Only this frame's draw items count, so uploads of
+    // meshes not on screen never hold up the graphics queue.
+    void WaitForMeshUploads(const RenderContext& ctx) {
+        uint64_t waitFenceValue = 0;
+        for (const DrawItem& item : m_drawItems) {
+            waitFenceValue = std::max(waitFenceValue, ctx.geometryManager->GetMeshUploadFence(item.mesh));
+        }
+        ctx.renderer->WaitForCopyQueue(waitFenceValue);
+    }
+
+    // Picks the entity's LOD from its screen size and remembers it for next frame
+    uint32_t SelectLOD(const RenderContext& ctx, entt::entity entity, MeshHandle meshHandle, const glm::mat4& model) {
+        if (!ctx.lodSelector) {
+            return 0;
+        }
+
+        const uint32_t lodCount = ctx.geometryManager->GetMeshLODCount(meshHandle);
+        const MeshBounds* bounds = ctx.geometryManager->GetMeshBounds(meshHandle);
+        if (lodCount <= 1 || !bounds) {
+            return 0;
+        }
+
+        MeshLOD& meshLOD = ctx.registry.get_or_emplace<MeshLOD>(entity);
+        const float screenSize = ctx.lodSelector->ComputeScreenSize(*bounds, model);
+        meshLOD.current = ctx.lodSelector->SelectLOD(screenSize, meshLOD.current, lodCount);
+        return meshLOD.current;
+    }
+
+    // Everything a command list needs before it can draw, run on the main
+    // list and again on every worker list
+    void SetupPipeline(CommandList* cmdList, const RenderContext& ctx) {
+        ctx.renderer->SetupRenderTarget(cmdList);
+        ctx.renderer->SetupViewportAndScissor(cmdList);
+
+        ID3D12GraphicsCommandList* d3dCmdList = cmdList->GetCommandList();
+        ctx.uniformManager->BindDescriptorHeap(d3dCmdList);
+
+        d3dCmdList->SetPipelineState(m_pipelineState.Get());
+        d3dCmdList->SetGraphicsRootSignature(m_rootSignature.Get());
+        d3dCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        ctx.geometryManager->BindVertexIndexBuffers(cmdList);
+    }
+
+    // Runs on worker threads: only touches const state and the uniform
+    // manager, whose allocations are synchronized
+    void EncodeDraws(const DrawItem* items, uint32_t count, const glm::mat4& viewProj,
+                     const RenderContext& ctx, DrawStream& out) {
+        out.Reserve(count * 2);
+
+        // Every stream starts on a list set up by SetupPipeline, which binds
+        // 32-bit indices; rebind only where the width changes
+        IndexFormat boundFormat = IndexFormat::Uint32;
+        for (uint32_t i = 0; i < count; ++i) {
+            const MeshView* renderData = ctx.geometryManager->GetMeshRenderData(items[i].mesh, items[i].lod);
+            if (!renderData) {
+                continue;
+            }
+
+            if (renderData->indexFormat != boundFormat) {
+                boundFormat = renderData->indexFormat;
+                out.SetIndexBuffer(ctx.geometryManager->GetIndexBufferBinding(boundFormat));
+            }
+
+            glm::mat4 mvp = viewProj * DecodedModelMatrix(ctx, items[i].mesh, items[i].model);
+
+            // Upload MVP for this draw call
+            auto mvpUniform = ctx.uniformManager->UploadUniform(&mvp, sizeof(glm::mat4));
+            if (!mvpUniform.IsValid()) {
+                printf("ForwardPass: Failed to upload MVP constants for entity\n");
+                continue;
+            }
+
+            out.SetConstants(0, mvpUniform.gpuAddress, mvpUniform.descriptorIndex);
+            out.DrawIndexed(MakeDrawIndexedArgs(*renderData));
+        }
+    }
+
+    // Quantized positions are stored relative to the mesh bounds, applying
+    // the decode on the CPU keeps the vertex shader layout agnostic
+    static glm::mat4 DecodedModelMatrix(const RenderContext& ctx, MeshHandle mesh, const glm::mat4& model) {
+        const MeshDecode* decode = ctx.geometryManager->GetMeshDecode(mesh);
+        if (!decode) {
+            return model;
+        }
+
+        glm::mat4 decoded = glm::translate(model, glm::vec3(decode->bias[0], decode->bias[1], decode->bias[2]));
+        return glm::scale(decoded, glm::vec3(decode->scale[0], decode->scale[1], decode->scale[2]));
+    }
+
+    bool EnsureIndirectRecorder(const RenderContext& ctx) {
+        if (m_indirectRecorder.IsInitialized()) {
+            return true;
+        }
+        if (m_indirectInitFailed) {
+            return false;
+        }
+
+        DX12Device* device = ctx.renderer->GetDevice();
+        if (!m_indirectRecorder.Initialize(device->GetD3D12Device(), device->GetAllocator(), m_indirectRootSignature.Get())) {
+            printf("ForwardPass: Indirect draws unavailable, falling back to direct draws\n");
+            m_indirectInitFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Resolves every visible item to a mesh table slot and its constants, then
+    // compacts them into indirect records and submits one ExecuteIndirect per
+    // index width
+    void RecordIndirect(CommandList* cmdList, const glm::mat4& viewProj, const RenderContext& ctx) {
+        m_meshTable.clear();
+        m_meshSlots.clear();
+        for (std::vector<IndirectDrawSource>& sources : m_indirectSources) {
+            sources.clear();
+            sources.reserve(m_drawItems.size());
+        }
+
+        for (const DrawItem& item : m_drawItems) {
+            const uint64_t key = (static_cast<uint64_t>(item.mesh) << 32) | item.lod;
+            auto [slotIt, inserted] = m_meshSlots.try_emplace(key, static_cast<uint32_t>(m_meshTable.size()));
+            if (inserted) {
+                // Meshes still uploading get an empty view and are compacted away
+                const MeshView* renderData = ctx.geometryManager->GetMeshRenderData(item.mesh, item.lod);
+                m_meshTable.push_back(renderData ? *renderData : MeshView{});
+            }
+
+            IndirectDrawSource source;
+            source.meshSlot = slotIt->second;
+            if (m_meshTable[source.meshSlot].indexCount > 0) {
+                glm::mat4 mvp = viewProj * DecodedModelMatrix(ctx, item.mesh, item.model);
+                auto mvpUniform = ctx.uniformManager->UploadUniform(&mvp, sizeof(glm::mat4));
+                source.constantsAddress = mvpUniform.gpuAddress;
+                source.visible = mvpUniform.IsValid() ? 1 : 0;
+            } else {
+                source.visible = 0;
+            }
+            const IndexFormat format = m_meshTable[source.meshSlot].indexFormat;
+            m_indirectSources[static_cast<uint32_t>(format)].push_back(source);
+        }
+
+        // 16-bit records first, the 32-bit ones are appended behind them
+        IndirectDrawRecorder::Batch batches[2];
+        batches[0].indexBuffer = ctx.geometryManager->GetIndexBufferBinding(IndexFormat::Uint16);
+        batches[0].recordCount = GenerateIndirectDraws(m_indirectSources[static_cast<uint32_t>(IndexFormat::Uint16)],
+                                                       m_meshTable, m_indirectScratch, m_indirectRecords);
+        batches[1].indexBuffer = ctx.geometryManager->GetIndexBufferBinding(IndexFormat::Uint32);
+        batches[1].recordCount = GenerateIndirectDraws(m_indirectSources[static_cast<uint32_t>(IndexFormat::Uint32)],
+                                                       m_meshTable, m_indirectScratch, m_indirectRecords32);
+        m_indirectRecords.insert(m_indirectRecords.end(), m_indirectRecords32.begin(), m_indirectRecords32.end());
+
+        ID3D12GraphicsCommandList* d3dCmdList = cmdList->GetCommandList();
+        d3dCmdList->SetPipelineState(m_indirectPipelineState.Get());
+        d3dCmdList->SetGraphicsRootSignature(m_indirectRootSignature.Get());
+
+        m_indirectRecorder.Record(cmdList, ctx.renderer->GetCurrentFrameIndex(), m_indirectRecords.data(), batches, 2);
+    }
+
     bool LoadShaders() {
         m_vertexShaderHandle = m_shaderManager->CreateShaderFromFile(
             "verts.hlsl",
@@ -172,14 +396,70 @@ private:
         ));
     }
 
-    void CreatePipelineState(ID3D12Device* device) {
+    // Same b0 MVP constants, bound as a root CBV so ExecuteIndirect can change it per draw
+    void CreateIndirectRootSignature(ID3D12Device* device) {
+        D3D12_ROOT_PARAMETER rootParameter = {};
+        rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+        rootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+        rootParameter.Descriptor.ShaderRegister = 0;
+        rootParameter.Descriptor.RegisterSpace = 0;
+
+        D3D12_ROOT_SIGNATURE_DESC rootSigDesc = {};
+        rootSigDesc.NumParameters = 1;
+        rootSigDesc.pParameters = &rootParameter;
+        rootSigDesc.NumStaticSamplers = 0;
+        rootSigDesc.pStaticSamplers = nullptr;
+        rootSigDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
+                            D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                            D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                            D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+
+        ComPtr<ID3DBlob> signature, errorBlob;
+        ThrowIfFailed(D3D12SerializeRootSignature(
+            &rootSigDesc,
+            D3D_ROOT_SIGNATURE_VERSION_1,
+            &signature,
+            &errorBlob
+        ));
+
+        ThrowIfFailed(device->CreateRootSignature(
+            0,
+            signature->GetBufferPointer(),
+            signature->GetBufferSize(),
+            IID_PPV_ARGS(&m_indirectRootSignature)
+        ));
+    }
+
+    static UINT BuildInputLayout(const VertexLayout& layout, D3D12_INPUT_ELEMENT_DESC* elements) {
+        UINT count = 0;
+        auto add = [&](const char* semantic, DXGI_FORMAT format, uint32_t offset) {
+            elements[count++] = { semantic, 0, format, 0, offset, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+        };
+
+        add("POSITION", layout.position == PositionEncoding::Unorm16 ? DXGI_FORMAT_R16G16B16A16_UNORM
+                                                                     : DXGI_FORMAT_R32G32B32_FLOAT, 0);
+        if (layout.normal != NormalEncoding::None) {
+            add("NORMAL", layout.normal == NormalEncoding::Oct16 ? DXGI_FORMAT_R16G16_SNORM
+                                                                 : DXGI_FORMAT_R32G32B32_FLOAT, layout.GetNormalOffset());
+        }
+        if (layout.uv != UVEncoding::None) {
+            add("TEXCOORD", layout.uv == UVEncoding::Half ? DXGI_FORMAT_R16G16_FLOAT
+                                                          : DXGI_FORMAT_R32G32_FLOAT, layout.GetUVOffset());
+        }
+        add("COLOR", layout.color == ColorEncoding::Unorm8 ? DXGI_FORMAT_R8G8B8A8_UNORM
+                                                           : DXGI_FORMAT_R32G32B32_FLOAT, layout.GetColorOffset());
+        return count;
+    }
+
+    void CreatePipelineState(ID3D12Device* device, ID3D12RootSignature* rootSignature,
+                             ComPtr<ID3D12PipelineState>& pipelineState) {
         const Shader* vs = m_shaderManager->GetShader(m_vertexShaderHandle);
         const Shader* ps = m_shaderManager->GetShader(m_pixelShaderHandle);
 
         D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 
         // Shaders
-        psoDesc.pRootSignature = m_rootSignature.Get();
+        psoDesc.pRootSignature = rootSignature;
         psoDesc.VS.pShaderBytecode = vs->GetShaderBlob()->GetBufferPointer();
         psoDesc.VS.BytecodeLength = vs->GetShaderBlob()->GetBufferSize();
         psoDesc.PS.pShaderBytecode = ps->GetShaderBlob()->GetBufferPointer();
@@ -225,14 +505,11 @@ private:
         psoDesc.DepthStencilState.FrontFace = defaultStencilOp;
         psoDesc.DepthStencilState.BackFace = defaultStencilOp;
 
-        // Input layout for position + color rendering
-        D3D12_INPUT_ELEMENT_DESC inputElements[] = {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-            { "COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-        };
-
+        // Input layout from the vertex layout. UNORM/SNORM/half formats are
+        // expanded to float by the input assembler, so the shader is shared.
+        D3D12_INPUT_ELEMENT_DESC inputElements[4];
         psoDesc.InputLayout.pInputElementDescs = inputElements;
-        psoDesc.InputLayout.NumElements = _countof(inputElements);
+        psoDesc.InputLayout.NumElements = BuildInputLayout(m_vertexLayout, inputElements);
 
         psoDesc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
         psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
@@ -250,6 +527,6 @@ private:
         psoDesc.CachedPSO.CachedBlobSizeInBytes = 0;
         psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-        ThrowIfFailed(device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineState)));
+        ThrowIfFailed(device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState)));
     }
 };
@@ -32,6 +32,7 @@ protected:
         }
         const MeshView* renderData = geometryManager->GetMeshRenderData(meshHandle);
         if (renderData) {
+            geometryManager->BindIndexBuffer(cmdList, renderData->indexFormat);
             cmdList->GetCommandList()->DrawIndexedInstanced(
                 renderData->indexCount,     // IndexCountPerInstance
                 1,                          // InstanceCount
@@ -50,6 +51,7 @@ protected:
         }
         const MeshView* renderData = geometryManager->GetMeshRenderData(meshHandle);
         if (renderData) {
+            geometryManager->BindIndexBuffer(cmdList, renderData->indexFormat);
             cmdList->GetCommandList()->DrawIndexedInstanced(
                 renderData->indexCount,
                 instanceCount,
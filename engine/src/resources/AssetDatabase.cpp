@@ -0,0 +1,455 @@
+#include "AssetDatabase.h"
+#include "ContentHash.h"
+#include "IO/FileIOService.h"
+#include "IO/PackFile.h"
+#include "jobs/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr const char* DATABASE_HEADER = "de3assetdb";
+constexpr uint32_t DATABASE_VERSION = 1;
+
+enum VisitState : uint8_t {
+    Unvisited = 0,
+    Visiting,
+    Done,
+};
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::string GetExtension(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+struct ScannedFile {
+    std::string path;
+    uint64_t size;
+    int64_t writeTime;
+};
+
+} // namespace
+
+// =============================================================================
+// Asset GUID
+// =============================================================================
+
+std::string AssetGuid::ToString() const {
+    char text[33];
+    snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(high),
+             static_cast<unsigned long long>(low));
+    return text;
+}
+
+bool AssetGuid::Parse(const std::string& text, AssetGuid& guid) {
+    if (text.size() != 32 || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        return false;
+    }
+    guid.high = std::stoull(text.substr(0, 16), nullptr, 16);
+    guid.low = std::stoull(text.substr(16), nullptr, 16);
+    return guid.IsValid();
+}
+
+// =============================================================================
+// Asset Database
+// =============================================================================
+
+AssetDatabase::AssetDatabase(const std::string& sourceDirectory, const std::string& outputDirectory)
+    : m_sourceDirectory(sourceDirectory)
+    , m_outputDirectory(outputDirectory)
+{
+    std::random_device device;
+    m_guidState[0] = (static_cast<uint64_t>(device()) << 32) ^ device();
+    m_guidState[1] = static_cast<uint64_t>(Clock::now().time_since_epoch().count());
+}
+
+void AssetDatabase::RegisterCooker(const std::string& extension, AssetCooker cooker) {
+    m_cookers[GetExtension("x" + extension)] = std::move(cooker);
+}
+
+const AssetCooker* AssetDatabase::FindCooker(const std::string& path) const {
+    auto it = m_cookers.find(GetExtension(path));
+    return it != m_cookers.end() ? &it->second : nullptr;
+}
+
+AssetGuid AssetDatabase::GenerateGuid() {
+    // 128 random bits, collisions are not a practical concern
+    AssetGuid guid;
+    while (!guid.IsValid()) {
+        guid.high = SplitMix64(m_guidState[0]);
+        guid.low = SplitMix64(m_guidState[1]);
+    }
+    return guid;
+}
+
+void AssetDatabase::RebuildIndex() {
+    m_pathIndex.clear();
+    m_guidIndex.clear();
+    m_pathIndex.reserve(m_assets.size());
+    m_guidIndex.reserve(m_assets.size());
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        m_pathIndex[m_assets[i].path] = i;
+        m_guidIndex[m_assets[i].guid.ToString()] = i;
+    }
+}
+
+const AssetDatabase::Asset* AssetDatabase::FindByPath(const std::string& path) const {
+    auto it = m_pathIndex.find(NormalizePackPath(path));
+    return it != m_pathIndex.end() ? &m_assets[it->second] : nullptr;
+}
+
+const AssetDatabase::Asset* AssetDatabase::FindByGuid(const AssetGuid& guid) const {
+    auto it = m_guidIndex.find(guid.ToString());
+    return it != m_guidIndex.end() ? &m_assets[it->second] : nullptr;
+}
+
+std::string AssetDatabase::GetOutputPath(const Asset& asset) const {
+    const AssetCooker* cooker = FindCooker(asset.path);
+    const std::string extension = cooker ? cooker->outputExtension : std::string();
+    return (std::filesystem::path(m_outputDirectory) / (asset.guid.ToString() + extension)).string();
+}
+
+std::vector<const AssetDatabase::Asset*> AssetDatabase::GetDependents(const std::string& path) const {
+    // Follow the reversed dependency edges
+    std::unordered_map<std::string, std::vector<size_t>> dependents;
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        for (const std::string& dependency : m_assets[i].dependencies) {
+            dependents[dependency].push_back(i);
+        }
+    }
+
+    std::vector<uint8_t> visited(m_assets.size(), 0);
+    std::vector<std::string> pending = { NormalizePackPath(path) };
+    std::vector<const Asset*> result;
+    while (!pending.empty()) {
+        const std::string current = std::move(pending.back());
+        pending.pop_back();
+
+        auto it = dependents.find(current);
+        if (it == dependents.end()) {
+            continue;
+        }
+        for (size_t index : it->second) {
+            if (!visited[index]) {
+                visited[index] = 1;
+                result.push_back(&m_assets[index]);
+                pending.push_back(m_assets[index].path);
+            }
+        }
+    }
+    return result;
+}
+
+uint64_t AssetDatabase::ComputeCookKey(size_t index, std::vector<uint64_t>& keys, std::vector<uint8_t>& state) const {
+    if (state[index] == Done) {
+        return keys[index];
+    }
+    const Asset& asset = m_assets[index];
+    // A cycle contributes content only, the files in it already hash each other
+    if (state[index] == Visiting) {
+        return asset.contentHash;
+    }
+    state[index] = Visiting;
+
+    uint64_t key = HashBytes(&asset.contentHash, sizeof(asset.contentHash));
+    for (const std::string& dependency : asset.dependencies) {
+        auto it = m_pathIndex.find(dependency);
+        if (it != m_pathIndex.end()) {
+            const uint64_t dependencyKey = ComputeCookKey(it->second, keys, state);
+            key = HashBytes(&dependencyKey, sizeof(dependencyKey), key);
+        } else {
+            // Missing files still change the key once they appear
+            key = HashBytes(dependency.data(), dependency.size(), key);
+        }
+    }
+
+    keys[index] = key;
+    state[index] = Done;
+    return key;
+}
+
+bool AssetDatabase::Update(JobSystem& jobSystem, Statistics* stats) {
+    Statistics result;
+    namespace fs = std::filesystem;
+
+    // =========================================================================
+    // Scan
+    // =========================================================================
+    Clock::time_point start = Clock::now();
+    std::error_code error;
+    const fs::path sourceRoot = fs::weakly_canonical(m_sourceDirectory, error);
+    const fs::path outputRoot = fs::weakly_canonical(m_outputDirectory, error);
+    if (!fs::is_directory(sourceRoot, error)) {
+        printf("AssetDatabase: '%s' is not a directory\n", m_sourceDirectory.c_str());
+        return false;
+    }
+
+    std::vector<ScannedFile> scanned;
+    for (fs::recursive_directory_iterator it(sourceRoot, fs::directory_options::skip_permission_denied, error), end;
+         it != end; it.increment(error)) {
+        // Cooked output inside the source tree is not source
+        if (it->is_directory(error) && fs::equivalent(it->path(), outputRoot, error)) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(error)) {
+            continue;
+        }
+        ScannedFile file;
+        file.path = NormalizePackPath(it->path().lexically_relative(sourceRoot).generic_string());
+        file.size = it->file_size(error);
+        file.writeTime = static_cast<int64_t>(it->last_write_time(error).time_since_epoch().count());
+        scanned.push_back(std::move(file));
+    }
+    std::sort(scanned.begin(), scanned.end(), [](const ScannedFile& a, const ScannedFile& b) {
+        return a.path < b.path;
+    });
+    result.files = static_cast<uint32_t>(scanned.size());
+    result.scanMs = ElapsedMs(start);
+
+    // =========================================================================
+    // Hash new and changed files
+    // =========================================================================
+    start = Clock::now();
+    std::vector<Asset> assets(scanned.size());
+    std::vector<uint32_t> changed;
+    std::vector<uint8_t> seen(m_assets.size(), 0);
+    for (size_t i = 0; i < scanned.size(); ++i) {
+        Asset& asset = assets[i];
+        auto it = m_pathIndex.find(scanned[i].path);
+        if (it != m_pathIndex.end()) {
+            asset = m_assets[it->second];
+            seen[it->second] = 1;
+        }
+        asset.path = scanned[i].path;
+        if (!asset.guid.IsValid() || asset.size != scanned[i].size || asset.writeTime != scanned[i].writeTime) {
+            asset.size = scanned[i].size;
+            asset.writeTime = scanned[i].writeTime;
+            changed.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    jobSystem.ParallelFor(static_cast<uint32_t>(changed.size()), [&](uint32_t i) {
+        Asset& asset = assets[changed[i]];
+        std::vector<uint8_t> bytes;
+        if (!FileIOService::ReadWholeFile((sourceRoot / asset.path).string(), bytes)) {
+            // Unreadable this run, hash again next run
+            asset.contentHash = 0;
+            asset.writeTime = 0;
+            asset.dependencies.clear();
+            return;
+        }
+        asset.contentHash = HashBytes(bytes.data(), bytes.size());
+
+        asset.dependencies.clear();
+        const AssetCooker* cooker = FindCooker(asset.path);
+        if (cooker && cooker->scanDependencies) {
+            const std::string directory = fs::path(asset.path).parent_path().generic_string();
+            for (const std::string& dependency : cooker->scanDependencies((sourceRoot / asset.path).string(), bytes)) {
+                asset.dependencies.push_back(NormalizePackPath(directory + "/" + dependency));
+            }
+        }
+    });
+    result.hashed = static_cast<uint32_t>(changed.size());
+
+    // Files gone from their old path keep their GUID when the same content
+    // shows up under a new one
+    std::unordered_map<uint64_t, std::vector<size_t>> removedByHash;
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        if (!seen[i]) {
+            removedByHash[m_assets[i].contentHash].push_back(i);
+        }
+    }
+    for (Asset& asset : assets) {
+        if (asset.guid.IsValid()) {
+            continue;
+        }
+        auto it = removedByHash.find(asset.contentHash);
+        if (it != removedByHash.end() && !it->second.empty() &&
+            FindCooker(asset.path) == FindCooker(m_assets[it->second.back()].path)) {
+            const Asset& previous = m_assets[it->second.back()];
+            asset.guid = previous.guid;
+            asset.cookKey = previous.cookKey;
+            it->second.pop_back();
+            result.renamed++;
+        }
+    }
+
+    // Whatever wasn't renamed is gone, along with its output
+    for (auto& [hash, indices] : removedByHash) {
+        for (size_t index : indices) {
+            if (FindCooker(m_assets[index].path)) {
+                fs::remove(GetOutputPath(m_assets[index]), error);
+            }
+            result.removed++;
+        }
+    }
+
+    m_assets = std::move(assets);
+    for (Asset& asset : m_assets) {
+        if (!asset.guid.IsValid()) {
+            asset.guid = GenerateGuid();
+            result.added++;
+        }
+    }
+    RebuildIndex();
+    result.hashMs = ElapsedMs(start);
+
+    // =========================================================================
+    // Cook what changed, directly or through a dependency
+    // =========================================================================
+    start = Clock::now();
+    std::vector<uint64_t> keys(m_assets.size(), 0);
+    std::vector<uint8_t> state(m_assets.size(), Unvisited);
+    std::vector<uint32_t> dirty;
+    std::vector<uint64_t> dirtyKeys;
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        const AssetCooker* cooker = FindCooker(m_assets[i].path);
+        if (!cooker || !cooker->cook) {
+            continue;
+        }
+        const uint64_t contentKey = ComputeCookKey(i, keys, state);
+        uint64_t key = HashBytes(&cooker->version, sizeof(cooker->version), contentKey);
+        key = HashBytes(cooker->outputExtension.data(), cooker->outputExtension.size(), key);
+        key = std::max<uint64_t>(key, 1);
+
+        if (m_assets[i].contentHash != 0 && key == m_assets[i].cookKey && fs::exists(GetOutputPath(m_assets[i]), error)) {
+            result.upToDate++;
+            continue;
+        }
+        dirty.push_back(static_cast<uint32_t>(i));
+        dirtyKeys.push_back(key);
+    }
+
+    if (!dirty.empty()) {
+        fs::create_directories(m_outputDirectory, error);
+    }
+
+    std::atomic<uint32_t> cooked{ 0 };
+    std::atomic<uint32_t> failed{ 0 };
+    jobSystem.ParallelFor(static_cast<uint32_t>(dirty.size()), [&](uint32_t i) {
+        Asset& asset = m_assets[dirty[i]];
+        const AssetCooker* cooker = FindCooker(asset.path);
+        if (asset.contentHash != 0 && cooker->cook((sourceRoot / asset.path).string(), GetOutputPath(asset))) {
+            asset.cookKey = dirtyKeys[i];
+            cooked++;
+        } else {
+            printf("AssetDatabase: Failed to cook '%s'\n", asset.path.c_str());
+            asset.cookKey = 0;
+            failed++;
+        }
+    });
+    result.cooked = cooked;
+    result.failed = failed;
+    result.cookMs = ElapsedMs(start);
+
+    if (stats) {
+        *stats = result;
+    }
+    return result.failed == 0;
+}
+
+// =============================================================================
+// Persistence
+// =============================================================================
+
+bool AssetDatabase::Load(const std::string& databasePath) {
+    m_assets.clear();
+    RebuildIndex();
+
+    std::ifstream file(databasePath);
+    if (!file.is_open()) {
+        return true;
+    }
+
+    std::string header;
+    uint32_t version = 0;
+    file >> header >> version;
+    if (header != DATABASE_HEADER || version != DATABASE_VERSION) {
+        printf("AssetDatabase: '%s' is not a version %u database, starting empty\n", databasePath.c_str(),
+               DATABASE_VERSION);
+        return true;
+    }
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        // <guid> <size> <writeTime> <contentHash> <cookKey> <dependencyCount> <path>
+        std::istringstream fields(line);
+        std::string guid;
+        Asset asset;
+        size_t dependencyCount = 0;
+        fields >> guid >> asset.size >> asset.writeTime >> std::hex >> asset.contentHash >> asset.cookKey >> std::dec >>
+            dependencyCount;
+        fields.get();
+        std::getline(fields, asset.path);
+        if (fields.fail() || !AssetGuid::Parse(guid, asset.guid) || asset.path.empty()) {
+            printf("AssetDatabase: '%s' is corrupt, starting empty\n", databasePath.c_str());
+            m_assets.clear();
+            RebuildIndex();
+            return true;
+        }
+
+        asset.dependencies.resize(dependencyCount);
+        for (std::string& dependency : asset.dependencies) {
+            std::getline(file, dependency);
+        }
+        m_assets.push_back(std::move(asset));
+    }
+
+    RebuildIndex();
+    return true;
+}
+
+bool AssetDatabase::Save(const std::string& databasePath) const {
+    std::ofstream file(databasePath, std::ios::trunc);
+    if (!file.is_open()) {
+        printf("AssetDatabase: Failed to create '%s'\n", databasePath.c_str());
+        return false;
+    }
+
+    file << DATABASE_HEADER << ' ' << DATABASE_VERSION << '\n';
+    for (const Asset& asset : m_assets) {
+        file << asset.guid.ToString() << ' ' << asset.size << ' ' << asset.writeTime << ' ' << std::hex
+             << asset.contentHash << ' ' << asset.cookKey << std::dec << ' ' << asset.dependencies.size() << ' '
+             << asset.path << '\n';
+        for (const std::string& dependency : asset.dependencies) {
+            file << dependency << '\n';
+        }
+    }
+    return file.good();
+}
+
+void AssetDatabase::PrintStats(const Statistics& stats) {
+    printf("=== AssetDatabase ===\n");
+    printf("Files: %u (%u hashed, %u added, %u removed, %u renamed)\n", stats.files, stats.hashed, stats.added,
+           stats.removed, stats.renamed);
+    printf("Cooked: %u, Failed: %u, Up To Date: %u\n", stats.cooked, stats.failed, stats.upToDate);
+    printf("Scan: %.2f ms, Hash: %.2f ms, Cook: %.2f ms\n", stats.scanMs, stats.hashMs, stats.cookMs);
+    printf("===========================\n");
+}
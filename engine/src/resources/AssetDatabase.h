@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobSystem;
+
+// =============================================================================
+// Asset GUID
+// =============================================================================
+
+// Random 128-bit id assigned the first time a source file is seen. It follows
+// the file across renames (matched by content) and names its cooked output.
+struct AssetGuid {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool IsValid() const { return high != 0 || low != 0; }
+    bool operator==(const AssetGuid& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const AssetGuid& other) const { return !(*this == other); }
+
+    std::string ToString() const;           // 32 hex digits
+    static bool Parse(const std::string& text, AssetGuid& guid);
+};
+
+// =============================================================================
+// Asset Cookers
+// =============================================================================
+
+// Turns one kind of source file (by extension) into its runtime form
+struct AssetCooker {
+    std::string outputExtension;            // Output is <guid><outputExtension>
+    uint64_t version = 1;                   // Change with the cook code or settings to re-cook every asset
+
+    // Paths the source references, relative to the source's directory.
+    // Optional; edits to those files re-cook this asset.
+    std::function<std::vector<std::string>(const std::string& sourcePath, const std::vector<uint8_t>& source)> scanDependencies;
+
+    // Called from worker threads
+    std::function<bool(const std::string& sourcePath, const std::string& outputPath)> cook;
+};
+
+// =============================================================================
+// Asset Database
+// =============================================================================
+
+// Tracks every file under a source directory: GUID, content hash and the
+// files it depends on, persisted between runs. Update re-hashes only files
+// whose size or write time changed, then re-cooks assets whose cook key
+// moved. The key folds in the asset's content, its cooker version and the
+// content of everything it depends on transitively, so editing a shared
+// include or buffer re-cooks exactly the assets that use it. Cooks run in
+// parallel on the job system.
+class AssetDatabase {
+public:
+    struct Asset {
+        AssetGuid guid;
+        std::string path;                   // Relative to the source directory
+        uint64_t size = 0;
+        int64_t writeTime = 0;
+        uint64_t contentHash = 0;
+        uint64_t cookKey = 0;               // Key of the last successful cook, 0 for none
+        std::vector<std::string> dependencies;
+    };
+
+    struct Statistics {
+        uint32_t files = 0;
+        uint32_t hashed = 0;                // New or changed since the last run
+        uint32_t added = 0;
+        uint32_t removed = 0;
+        uint32_t renamed = 0;
+        uint32_t cooked = 0;
+        uint32_t failed = 0;
+        uint32_t upToDate = 0;
+        double scanMs = 0.0;
+        double hashMs = 0.0;
+        double cookMs = 0.0;
+    };
+
+    AssetDatabase(const std::string& sourceDirectory, const std::string& outputDirectory);
+
+    // extension includes the dot, matched case insensitively
+    void RegisterCooker(const std::string& extension, AssetCooker cooker);
+
+    // Reads the records of a previous run, a missing file is an empty database
+    bool Load(const std::string& databasePath);
+    bool Save(const std::string& databasePath) const;
+
+    // Rescans the source directory and re-cooks what changed
+    bool Update(JobSystem& jobSystem, Statistics* stats = nullptr);
+
+    const Asset* FindByPath(const std::string& path) const;
+    const Asset* FindByGuid(const AssetGuid& guid) const;
+
+    // Assets that depend on path, directly or through other files
+    std::vector<const Asset*> GetDependents(const std::string& path) const;
+
+    std::string GetOutputPath(const Asset& asset) const;
+    size_t GetAssetCount() const { return m_assets.size(); }
+
+    static void PrintStats(const Statistics& stats);
+
+private:
+    const AssetCooker* FindCooker(const std::string& path) const;
+    AssetGuid GenerateGuid();
+    void RebuildIndex();
+    uint64_t ComputeCookKey(size_t index, std::vector<uint64_t>& keys, std::vector<uint8_t>& state) const;
+
+    std::string m_sourceDirectory;
+    std::string m_outputDirectory;
+    std::unordered_map<std::string, AssetCooker> m_cookers;
+
+    std::vector<Asset> m_assets;
+    std::unordered_map<std::string, size_t> m_pathIndex;
+    std::unordered_map<std::string, size_t> m_guidIndex;      // By AssetGuid::ToString
+    uint64_t m_guidState[2] = {};
+};
@@ -0,0 +1,114 @@
+#include "AsyncUploadScheduler.h"
+#include <algorithm>
+
+AsyncUploadScheduler::AsyncUploadScheduler(const Config& config)
+    : m_config(config)
+{
+}
+
+void AsyncUploadScheduler::Enqueue(uint32_t id, size_t bytes) {
+    m_queue.push_back({ id, bytes });
+}
+
+void AsyncUploadScheduler::Cancel(uint32_t id) {
+    auto it = std::find_if(m_queue.begin(), m_queue.end(),
+                           [id](const QueuedUpload& upload) { return upload.id == id; });
+    if (it != m_queue.end()) {
+        m_queue.erase(it);
+        return;
+    }
+
+    // Still reaches the GPU, but is no longer reported
+    if (m_inFlight.erase(id) > 0) {
+        for (Batch& batch : m_batches) {
+            batch.ids.erase(std::remove(batch.ids.begin(), batch.ids.end(), id), batch.ids.end());
+        }
+    }
+}
+
+uint32_t AsyncUploadScheduler::Submit(IUploadQueue& queue, const RecordFn& record) {
+    if (m_queue.empty() || m_batches.size() >= m_config.maxBatchesInFlight) {
+        return 0;
+    }
+
+    if (!queue.BeginBatch()) {
+        return 0;
+    }
+
+    const uint64_t fenceValue = queue.GetNextFenceValue();
+
+    Batch batch;
+    batch.fenceValue = fenceValue;
+    size_t batchBytes = 0;
+
+    while (!m_queue.empty() && batch.ids.size() < m_config.maxUploadsPerBatch) {
+        const QueuedUpload& upload = m_queue.front();
+
+        // Oversized uploads are allowed as the first entry of a batch
+        if (!batch.ids.empty() && batchBytes + upload.bytes > m_config.maxBytesPerBatch) {
+            break;
+        }
+        if (!record(upload.id, fenceValue)) {
+            break;
+        }
+
+        batch.ids.push_back(upload.id);
+        batchBytes += upload.bytes;
+        m_queue.pop_front();
+    }
+
+    if (batch.ids.empty()) {
+        queue.CancelBatch();
+        m_deferredBatches++;
+        return 0;
+    }
+
+    const uint64_t signaledValue = queue.SubmitBatch();
+    batch.fenceValue = signaledValue;
+    for (uint32_t id : batch.ids) {
+        m_inFlight[id] = signaledValue;
+    }
+
+    const uint32_t submitted = static_cast<uint32_t>(batch.ids.size());
+    m_lastSubmittedFence = signaledValue;
+    m_batches.push_back(std::move(batch));
+    m_submittedBatches++;
+    return submitted;
+}
+
+void AsyncUploadScheduler::Retire(uint64_t completedFenceValue, std::vector<uint32_t>& outCompleted) {
+    while (!m_batches.empty() && m_batches.front().fenceValue <= completedFenceValue) {
+        for (uint32_t id : m_batches.front().ids) {
+            m_inFlight.erase(id);
+            outCompleted.push_back(id);
+            m_completedUploads++;
+        }
+        m_batches.pop_front();
+    }
+}
+
+AsyncUploadScheduler::UploadState AsyncUploadScheduler::GetState(uint32_t id) const {
+    if (m_inFlight.count(id) > 0) {
+        return UploadState::InFlight;
+    }
+
+    auto it = std::find_if(m_queue.begin(), m_queue.end(),
+                           [id](const QueuedUpload& upload) { return upload.id == id; });
+    return it != m_queue.end() ? UploadState::Queued : UploadState::Unknown;
+}
+
+uint64_t AsyncUploadScheduler::GetFenceValue(uint32_t id) const {
+    auto it = m_inFlight.find(id);
+    return it != m_inFlight.end() ? it->second : 0;
+}
+
+AsyncUploadScheduler::Statistics AsyncUploadScheduler::GetStatistics() const {
+    Statistics stats;
+    stats.queuedUploads = static_cast<uint32_t>(m_queue.size());
+    stats.inFlightUploads = static_cast<uint32_t>(m_inFlight.size());
+    stats.batchesInFlight = static_cast<uint32_t>(m_batches.size());
+    stats.submittedBatches = m_submittedBatches;
+    stats.completedUploads = m_completedUploads;
+    stats.deferredBatches = m_deferredBatches;
+    return stats;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// =============================================================================
+// Async Upload Scheduling
+// =============================================================================
+
+// Queue that upload batches are recorded into and submitted on. CopyUploadQueue
+// implements it on the D3D12 copy queue; a mock that advances its completed
+// value by hand is enough to drive the scheduler without a GPU.
+class IUploadQueue {
+public:
+    virtual ~IUploadQueue() = default;
+
+    virtual bool BeginBatch() = 0;                          // Open a command list for recording
+    virtual uint64_t SubmitBatch() = 0;                     // Close, execute and signal, returns the fence value
+    virtual void CancelBatch() = 0;                         // Close without executing
+    virtual uint64_t GetNextFenceValue() const = 0;         // Value the next SubmitBatch signals
+    virtual uint64_t GetCompletedFenceValue() const = 0;
+};
+
+// Tracks uploads from request to completion:
+//
+//   Enqueue -> Queued -> (Submit records it into a batch) -> InFlight
+//           -> (Retire sees the batch fence complete) -> reported, forgotten
+//
+// Batches are submitted in request order and at most maxBatchesInFlight are
+// outstanding, which bounds the command allocators the queue needs. Pure
+// bookkeeping: the caller records the copies in the Submit callback.
+class AsyncUploadScheduler {
+public:
+    enum class UploadState {
+        Unknown,    // Never enqueued, cancelled or already retired
+        Queued,
+        InFlight
+    };
+
+    struct Config {
+        uint32_t maxBatchesInFlight = 2;
+        uint32_t maxUploadsPerBatch = 16;
+        size_t maxBytesPerBatch = 8 * 1024 * 1024;  // A single larger upload still gets its own batch
+    };
+
+    struct Statistics {
+        uint32_t queuedUploads = 0;
+        uint32_t inFlightUploads = 0;
+        uint32_t batchesInFlight = 0;
+        uint64_t submittedBatches = 0;
+        uint64_t completedUploads = 0;
+        uint64_t deferredBatches = 0;   // Submit found work but could not record any of it
+    };
+
+    // Records one upload into the open batch, returns false to leave it (and
+    // everything queued after it) for a later Submit. fenceValue is the value
+    // the batch will signal, for tagging staging memory.
+    using RecordFn = std::function<bool(uint32_t id, uint64_t fenceValue)>;
+
+    AsyncUploadScheduler() = default;
+    explicit AsyncUploadScheduler(const Config& config);
+
+    void SetConfig(const Config& config) { m_config = config; }
+    const Config& GetConfig() const { return m_config; }
+
+    // Ids must be unique among uploads that have not retired yet
+    void Enqueue(uint32_t id, size_t bytes);
+
+    // Drops a queued upload. In-flight uploads cannot be recalled and are
+    // simply not reported when they retire.
+    void Cancel(uint32_t id);
+
+    // Opens at most one batch and fills it in queue order. Returns the
+    // number of uploads submitted.
+    uint32_t Submit(IUploadQueue& queue, const RecordFn& record);
+
+    // Appends uploads whose batch has completed to outCompleted
+    void Retire(uint64_t completedFenceValue, std::vector<uint32_t>& outCompleted);
+
+    UploadState GetState(uint32_t id) const;
+    uint64_t GetFenceValue(uint32_t id) const;              // 0 unless in flight
+    uint64_t GetLastSubmittedFenceValue() const { return m_lastSubmittedFence; }
+
+    bool IsIdle() const { return m_queue.empty() && m_batches.empty(); }
+    bool HasQueuedUploads() const { return !m_queue.empty(); }
+
+    Statistics GetStatistics() const;
+
+private:
+    struct QueuedUpload {
+        uint32_t id;
+        size_t bytes;
+    };
+
+    struct Batch {
+        uint64_t fenceValue;
+        std::vector<uint32_t> ids;
+    };
+
+    Config m_config;
+
+    std::deque<QueuedUpload> m_queue;
+    std::deque<Batch> m_batches;                            // Submission order, so fences increase
+    std::unordered_map<uint32_t, uint64_t> m_inFlight;      // id -> batch fence
+
+    uint64_t m_lastSubmittedFence = 0;
+    uint64_t m_submittedBatches = 0;
+    uint64_t m_completedUploads = 0;
+    uint64_t m_deferredBatches = 0;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// =============================================================================
+// Content Hashing
+// =============================================================================
+
+// 64-bit non-cryptographic hash of a byte range (the XXH64 algorithm). Feed
+// the previous result back in as the seed to hash several ranges as one key.
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
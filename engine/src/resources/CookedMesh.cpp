@@ -0,0 +1,454 @@
+#include "CookedMesh.h"
+#include "IndexNarrowing.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+size_t AlignBlob(size_t offset) {
+    return (offset + COOKED_MESH_ALIGNMENT - 1) & ~static_cast<size_t>(COOKED_MESH_ALIGNMENT - 1);
+}
+
+bool BlobInFile(const CookedMeshBlob& blob, uint64_t expectedSize, size_t fileSize) {
+    if (blob.size != expectedSize) {
+        return false;
+    }
+    if (blob.size == 0) {
+        return true;
+    }
+    return blob.offset % COOKED_MESH_ALIGNMENT == 0 && blob.offset <= fileSize && blob.size <= fileSize - blob.offset;
+}
+
+template <typename IndexType>
+bool IndicesBelow(const IndexType* indices, size_t count, uint32_t vertexCount) {
+    IndexType maxIndex = 0;
+    for (size_t i = 0; i < count; ++i) {
+        maxIndex = std::max(maxIndex, indices[i]);
+    }
+    return count == 0 || maxIndex < vertexCount;
+}
+
+// Contents of a record whose blobs are already known to be in the file:
+// every index names a vertex of the mesh, every meshlet stays inside the
+// meshlet arrays and within the mesh shader limits
+bool RecordContentsValid(const CookedMeshRecord& record, const uint8_t* data) {
+    uint64_t totalIndexCount = 0;
+    for (uint32_t lod = 0; lod < record.lodCount; ++lod) {
+        totalIndexCount += record.lodIndexCounts[lod];
+    }
+    const uint8_t* indexData = data + record.indexData.offset;
+    const bool indicesValid = static_cast<IndexFormat>(record.indexFormat) == IndexFormat::Uint16
+        ? IndicesBelow(reinterpret_cast<const uint16_t*>(indexData), totalIndexCount, record.vertexCount)
+        : IndicesBelow(reinterpret_cast<const uint32_t*>(indexData), totalIndexCount, record.vertexCount);
+    if (!indicesValid) {
+        return false;
+    }
+
+    const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(data + record.meshlets.offset);
+    const uint8_t* triangles = data + record.meshletTriangles.offset;
+    for (uint32_t m = 0; m < record.meshletCount; ++m) {
+        const Meshlet& meshlet = meshlets[m];
+        if (meshlet.vertexCount == 0 || meshlet.vertexCount > MAX_MESHLET_VERTICES ||
+            meshlet.triangleCount > MAX_MESHLET_TRIANGLES ||
+            static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount > record.meshletVertexIndexCount ||
+            static_cast<uint64_t>(meshlet.triangleOffset) + meshlet.triangleCount * 3 > record.meshletTriangleBytes) {
+            return false;
+        }
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+            if (triangles[meshlet.triangleOffset + i] >= meshlet.vertexCount) {
+                return false;
+            }
+        }
+    }
+    return IndicesBelow(reinterpret_cast<const uint32_t*>(data + record.meshletVertexIndices.offset),
+                        record.meshletVertexIndexCount, record.vertexCount);
+}
+
+} // namespace
+
+// =============================================================================
+// Encoded Meshes
+// =============================================================================
+
+uint32_t EncodedMesh::GetTotalIndexCount() const {
+    uint32_t total = 0;
+    for (uint32_t lod = 0; lod < lodCount && lod < MAX_MESH_LODS; ++lod) {
+        total += lodIndexCounts[lod];
+    }
+    return total;
+}
+
+size_t EncodedMesh::GetIndexDataSize() const {
+    return AlignIndexDataSize(static_cast<size_t>(GetTotalIndexCount()) * GetIndexSize(indexFormat));
+}
+
+EncodedMesh CookedMesh::GetEncodedMesh() const {
+    EncodedMesh mesh;
+    mesh.layout = layout;
+    mesh.vertexData = vertexData.data();
+    mesh.vertexCount = vertexCount;
+    mesh.indexData = indexData.data();
+    mesh.indexFormat = indexFormat;
+    mesh.lodCount = static_cast<uint32_t>(std::min<size_t>(lodIndexCounts.size(), MAX_MESH_LODS));
+    for (uint32_t lod = 0; lod < mesh.lodCount; ++lod) {
+        mesh.lodIndexCounts[lod] = lodIndexCounts[lod];
+    }
+    mesh.bounds = bounds;
+
+    if (!meshlets.meshlets.empty()) {
+        mesh.meshlets = meshlets.meshlets.data();
+        mesh.meshletBounds = meshlets.bounds.data();
+        mesh.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+        mesh.meshletVertexIndices = meshlets.vertexIndices.data();
+        mesh.meshletVertexIndexCount = static_cast<uint32_t>(meshlets.vertexIndices.size());
+        mesh.meshletTriangles = meshlets.triangles.data();
+        mesh.meshletTriangleBytes = static_cast<uint32_t>(meshlets.triangles.size());
+    }
+    return mesh;
+}
+
+// =============================================================================
+// Cooking
+// =============================================================================
+
+CookedMesh CookMesh(const CPUMesh& sourceMesh, const MeshCookSettings& settings) {
+    CookedMesh cooked;
+    if (!sourceMesh.vertices || !sourceMesh.indices || sourceMesh.vertexCount == 0 || sourceMesh.indexCount == 0) {
+        return cooked;
+    }
+
+    // Reorder for the post-transform cache, overdraw and vertex fetch
+    OptimizedMesh optimized;
+    if (settings.optimize) {
+        optimized = OptimizeMesh(sourceMesh, settings.optimizeSettings);
+    }
+    const CPUMesh mesh = settings.optimize ? optimized.GetCPUMesh() : sourceMesh;
+
+    // Gather LOD index lists, precomputed ones take priority over generation
+    std::vector<const uint32_t*> lodIndices = { mesh.indices };
+    cooked.lodIndexCounts = { mesh.indexCount };
+    MeshLODChain generatedLODs;
+    if (mesh.lods && mesh.lodCount > 0) {
+        for (uint32_t lod = 0; lod < mesh.lodCount && lod + 1 < MAX_MESH_LODS; ++lod) {
+            if (mesh.lods[lod].indices && mesh.lods[lod].indexCount > 0) {
+                lodIndices.push_back(mesh.lods[lod].indices);
+                cooked.lodIndexCounts.push_back(mesh.lods[lod].indexCount);
+            }
+        }
+    } else if (settings.autoLODCount > 0) {
+        MeshLODSettings lodSettings = settings.lodSettings;
+        lodSettings.lodCount = std::min(settings.autoLODCount, MAX_MESH_LODS - 1);
+        generatedLODs = BuildMeshLODChain(mesh, lodSettings);
+        for (auto& indices : generatedLODs.lodIndices) {
+            if (settings.optimize) {
+                OptimizeVertexCache(indices.data(), static_cast<uint32_t>(indices.size()),
+                                    mesh.vertexCount, settings.optimizeSettings.cacheSize);
+            }
+            lodIndices.push_back(indices.data());
+            cooked.lodIndexCounts.push_back(static_cast<uint32_t>(indices.size()));
+        }
+    }
+
+    uint32_t totalIndexCount = 0;
+    for (uint32_t count : cooked.lodIndexCounts) {
+        totalIndexCount += count;
+    }
+
+    // Small meshes get 16-bit indices
+    cooked.indexFormat = settings.allow16BitIndices ? SelectIndexFormat(mesh.vertexCount) : IndexFormat::Uint32;
+    const uint32_t indexSize = GetIndexSize(cooked.indexFormat);
+
+    // Object-space bounds
+    MeshBounds& bounds = cooked.bounds;
+    for (int axis = 0; axis < 3; ++axis) {
+        bounds.min[axis] = mesh.vertices[0].position[axis];
+        bounds.max[axis] = mesh.vertices[0].position[axis];
+    }
+    for (uint32_t i = 1; i < mesh.vertexCount; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            bounds.min[axis] = std::min(bounds.min[axis], mesh.vertices[i].position[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], mesh.vertices[i].position[axis]);
+        }
+    }
+
+    // Cluster LOD 0, meshlet vertex indices stay relative to the vertex range
+    if (settings.buildMeshlets) {
+        cooked.meshlets = BuildMeshlets(mesh.vertices, mesh.vertexCount, mesh.indices, mesh.indexCount,
+                                        settings.meshletSettings);
+    }
+
+    // Encode vertices into the buffer layout, quantized positions relative
+    // to the bounds
+    cooked.layout = settings.vertexLayout;
+    cooked.vertexCount = mesh.vertexCount;
+    cooked.vertexData.resize(static_cast<size_t>(mesh.vertexCount) * settings.vertexLayout.GetStride());
+    EncodeVertices(settings.vertexLayout, MakeMeshDecode(settings.vertexLayout, bounds), mesh.vertices,
+                   mesh.normals, mesh.uvs, mesh.vertexCount, cooked.vertexData.data());
+
+    // Copy index data, LOD 0 first followed by the reduced LODs
+    cooked.indexData.resize(AlignIndexDataSize(static_cast<size_t>(totalIndexCount) * indexSize));
+    uint8_t* indexDst = cooked.indexData.data();
+    for (size_t lod = 0; lod < lodIndices.size(); ++lod) {
+        const uint32_t count = cooked.lodIndexCounts[lod];
+        if (cooked.indexFormat == IndexFormat::Uint16) {
+            NarrowIndices(lodIndices[lod], count, reinterpret_cast<uint16_t*>(indexDst));
+        } else {
+            memcpy(indexDst, lodIndices[lod], count * sizeof(uint32_t));
+        }
+        indexDst += count * indexSize;
+    }
+
+    return cooked;
+}
+
+CookedMesh CopyEncodedMesh(const EncodedMesh& mesh) {
+    CookedMesh cooked;
+    cooked.layout = mesh.layout;
+    cooked.vertexCount = mesh.vertexCount;
+    cooked.indexFormat = mesh.indexFormat;
+    cooked.lodIndexCounts.assign(mesh.lodIndexCounts, mesh.lodIndexCounts + std::min(mesh.lodCount, MAX_MESH_LODS));
+    cooked.bounds = mesh.bounds;
+
+    const uint8_t* vertexBytes = static_cast<const uint8_t*>(mesh.vertexData);
+    const uint8_t* indexBytes = static_cast<const uint8_t*>(mesh.indexData);
+    cooked.vertexData.assign(vertexBytes, vertexBytes + static_cast<size_t>(mesh.vertexCount) * mesh.layout.GetStride());
+    cooked.indexData.assign(indexBytes, indexBytes + mesh.GetIndexDataSize());
+
+    if (mesh.meshletCount > 0) {
+        cooked.meshlets.meshlets.assign(mesh.meshlets, mesh.meshlets + mesh.meshletCount);
+        cooked.meshlets.bounds.assign(mesh.meshletBounds, mesh.meshletBounds + mesh.meshletCount);
+        cooked.meshlets.vertexIndices.assign(mesh.meshletVertexIndices,
+                                             mesh.meshletVertexIndices + mesh.meshletVertexIndexCount);
+        cooked.meshlets.triangles.assign(mesh.meshletTriangles, mesh.meshletTriangles + mesh.meshletTriangleBytes);
+    }
+    return cooked;
+}
+
+// =============================================================================
+// Writing
+// =============================================================================
+
+bool WriteCookedMeshFile(const std::string& path, const std::vector<CookedMesh>& meshes) {
+    CookedMeshFileHeader header;
+    if (!meshes.empty()) {
+        const VertexLayout& layout = meshes[0].layout;
+        header.positionEncoding = static_cast<uint8_t>(layout.position);
+        header.normalEncoding = static_cast<uint8_t>(layout.normal);
+        header.uvEncoding = static_cast<uint8_t>(layout.uv);
+        header.colorEncoding = static_cast<uint8_t>(layout.color);
+        header.vertexStride = layout.GetStride();
+    }
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+
+    // Lay out the records, then every blob after the table
+    std::vector<CookedMeshRecord> records(meshes.size());
+    size_t cursor = sizeof(CookedMeshFileHeader) + records.size() * sizeof(CookedMeshRecord);
+    auto place = [&cursor](CookedMeshBlob& blob, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        cursor = AlignBlob(cursor);
+        blob.offset = cursor;
+        blob.size = size;
+        cursor += size;
+    };
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const CookedMesh& mesh = meshes[i];
+        CookedMeshRecord& record = records[i];
+        if (!(mesh.layout == meshes[0].layout) || mesh.lodIndexCounts.empty() ||
+            mesh.lodIndexCounts.size() > MAX_MESH_LODS) {
+            printf("CookedMesh: Mesh %zu can't be written (layout mismatch or bad LOD count)\n", i);
+            return false;
+        }
+
+        strncpy(record.name, mesh.name.c_str(), COOKED_MESH_NAME_LENGTH - 1);
+        record.vertexCount = mesh.vertexCount;
+        record.indexFormat = static_cast<uint32_t>(mesh.indexFormat);
+        record.lodCount = static_cast<uint32_t>(mesh.lodIndexCounts.size());
+        for (uint32_t lod = 0; lod < record.lodCount; ++lod) {
+            record.lodIndexCounts[lod] = mesh.lodIndexCounts[lod];
+        }
+        record.bounds = mesh.bounds;
+        record.meshletCount = static_cast<uint32_t>(mesh.meshlets.meshlets.size());
+        record.meshletVertexIndexCount = static_cast<uint32_t>(mesh.meshlets.vertexIndices.size());
+        record.meshletTriangleBytes = static_cast<uint32_t>(mesh.meshlets.triangles.size());
+
+        place(record.vertexData, mesh.vertexData.size());
+        place(record.indexData, mesh.indexData.size());
+        place(record.meshlets, mesh.meshlets.meshlets.size() * sizeof(Meshlet));
+        place(record.meshletBounds, mesh.meshlets.bounds.size() * sizeof(MeshletBounds));
+        place(record.meshletVertexIndices, mesh.meshlets.vertexIndices.size() * sizeof(uint32_t));
+        place(record.meshletTriangles, mesh.meshlets.triangles.size());
+    }
+    header.fileSize = cursor;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        printf("CookedMesh: Failed to create '%s'\n", path.c_str());
+        return false;
+    }
+
+    size_t written = 0;
+    auto write = [&](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), size);
+        written += size;
+    };
+    auto writeBlob = [&](const CookedMeshBlob& blob, const void* data) {
+        if (blob.size == 0) {
+            return;
+        }
+        static const uint8_t padding[COOKED_MESH_ALIGNMENT] = {};
+        write(padding, blob.offset - written);
+        write(data, blob.size);
+    };
+
+    write(&header, sizeof(header));
+    write(records.data(), records.size() * sizeof(CookedMeshRecord));
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const CookedMesh& mesh = meshes[i];
+        const CookedMeshRecord& record = records[i];
+        writeBlob(record.vertexData, mesh.vertexData.data());
+        writeBlob(record.indexData, mesh.indexData.data());
+        writeBlob(record.meshlets, mesh.meshlets.meshlets.data());
+        writeBlob(record.meshletBounds, mesh.meshlets.bounds.data());
+        writeBlob(record.meshletVertexIndices, mesh.meshlets.vertexIndices.data());
+        writeBlob(record.meshletTriangles, mesh.meshlets.triangles.data());
+    }
+
+    if (!file.good() || written != header.fileSize) {
+        printf("CookedMesh: Failed to write '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+bool CookedMeshFile::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path)) {
+        return false;
+    }
+
+    const size_t fileSize = m_file.GetSize();
+    const uint8_t* data = m_file.GetData();
+
+    CookedMeshFileHeader header;
+    if (fileSize < sizeof(header)) {
+        printf("CookedMesh: '%s' is too small\n", path.c_str());
+        Close();
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != COOKED_MESH_MAGIC || header.version != COOKED_MESH_VERSION || header.fileSize != fileSize) {
+        printf("CookedMesh: '%s' is not a version %u cooked mesh file\n", path.c_str(), COOKED_MESH_VERSION);
+        Close();
+        return false;
+    }
+
+    m_layout.position = static_cast<PositionEncoding>(header.positionEncoding);
+    m_layout.normal = static_cast<NormalEncoding>(header.normalEncoding);
+    m_layout.uv = static_cast<UVEncoding>(header.uvEncoding);
+    m_layout.color = static_cast<ColorEncoding>(header.colorEncoding);
+    if (header.meshCount > 0 && m_layout.GetStride() != header.vertexStride) {
+        printf("CookedMesh: '%s' has an unknown vertex layout\n", path.c_str());
+        Close();
+        return false;
+    }
+
+    const size_t tableSize = static_cast<size_t>(header.meshCount) * sizeof(CookedMeshRecord);
+    if (tableSize > fileSize - sizeof(header)) {
+        printf("CookedMesh: '%s' is truncated\n", path.c_str());
+        Close();
+        return false;
+    }
+
+    // The table sits right after the 32-byte header of a page-aligned
+    // mapping, so it is read in place
+    const CookedMeshRecord* records = reinterpret_cast<const CookedMeshRecord*>(data + sizeof(header));
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        const CookedMeshRecord& record = records[i];
+        const IndexFormat indexFormat = static_cast<IndexFormat>(record.indexFormat);
+
+        bool valid = record.vertexCount > 0 && record.lodCount > 0 && record.lodCount <= MAX_MESH_LODS &&
+                     (indexFormat == IndexFormat::Uint16 || indexFormat == IndexFormat::Uint32);
+        uint64_t totalIndexCount = 0;
+        for (uint32_t lod = 0; valid && lod < record.lodCount; ++lod) {
+            totalIndexCount += record.lodIndexCounts[lod];
+        }
+        valid = valid && totalIndexCount <= UINT32_MAX;
+        if (valid) {
+            EncodedMesh expected;
+            expected.indexFormat = indexFormat;
+            expected.lodCount = record.lodCount;
+            memcpy(expected.lodIndexCounts, record.lodIndexCounts, sizeof(record.lodIndexCounts));
+
+            valid = BlobInFile(record.vertexData, static_cast<uint64_t>(record.vertexCount) * header.vertexStride, fileSize) &&
+                    BlobInFile(record.indexData, expected.GetIndexDataSize(), fileSize) &&
+                    BlobInFile(record.meshlets, static_cast<uint64_t>(record.meshletCount) * sizeof(Meshlet), fileSize) &&
+                    BlobInFile(record.meshletBounds, static_cast<uint64_t>(record.meshletCount) * sizeof(MeshletBounds), fileSize) &&
+                    BlobInFile(record.meshletVertexIndices, static_cast<uint64_t>(record.meshletVertexIndexCount) * sizeof(uint32_t), fileSize) &&
+                    BlobInFile(record.meshletTriangles, record.meshletTriangleBytes, fileSize) &&
+                    RecordContentsValid(record, data);
+        }
+        if (!valid) {
+            printf("CookedMesh: '%s' mesh %u is corrupt\n", path.c_str(), i);
+            Close();
+            return false;
+        }
+    }
+
+    m_records = records;
+    m_meshCount = header.meshCount;
+    return true;
+}
+
+void CookedMeshFile::Close() {
+    m_file.Close();
+    m_records = nullptr;
+    m_meshCount = 0;
+    m_layout = VertexLayout();
+}
+
+EncodedMesh CookedMeshFile::GetMesh(uint32_t index) const {
+    EncodedMesh mesh;
+    if (index >= m_meshCount) {
+        return mesh;
+    }
+
+    const CookedMeshRecord& record = m_records[index];
+    const uint8_t* data = m_file.GetData();
+
+    mesh.layout = m_layout;
+    mesh.vertexData = data + record.vertexData.offset;
+    mesh.vertexCount = record.vertexCount;
+    mesh.indexData = data + record.indexData.offset;
+    mesh.indexFormat = static_cast<IndexFormat>(record.indexFormat);
+    mesh.lodCount = record.lodCount;
+    memcpy(mesh.lodIndexCounts, record.lodIndexCounts, sizeof(record.lodIndexCounts));
+    mesh.bounds = record.bounds;
+
+    if (record.meshletCount > 0) {
+        mesh.meshlets = reinterpret_cast<const Meshlet*>(data + record.meshlets.offset);
+        mesh.meshletBounds = reinterpret_cast<const MeshletBounds*>(data + record.meshletBounds.offset);
+        mesh.meshletCount = record.meshletCount;
+        mesh.meshletVertexIndices = reinterpret_cast<const uint32_t*>(data + record.meshletVertexIndices.offset);
+        mesh.meshletVertexIndexCount = record.meshletVertexIndexCount;
+        mesh.meshletTriangles = data + record.meshletTriangles.offset;
+        mesh.meshletTriangleBytes = record.meshletTriangleBytes;
+    }
+    return mesh;
+}
+
+std::string CookedMeshFile::GetMeshName(uint32_t index) const {
+    if (index >= m_meshCount) {
+        return std::string();
+    }
+    const char* name = m_records[index].name;
+    return std::string(name, strnlen(name, COOKED_MESH_NAME_LENGTH));
+}
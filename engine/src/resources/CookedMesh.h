@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RenderTypes.h"
+#include "VertexLayout.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "IO/MappedFile.h"
+
+// =============================================================================
+// Encoded Meshes
+// =============================================================================
+
+// A mesh already in GeometryManager's buffer format: vertices encoded in a
+// vertex layout, every LOD's indices back to back in their final width.
+// Creating a mesh from it only copies bytes.
+struct EncodedMesh {
+    VertexLayout layout;
+    const void* vertexData = nullptr;       // vertexCount * layout stride bytes
+    uint32_t vertexCount = 0;
+    const void* indexData = nullptr;        // LOD 0 first, padded to 4 bytes
+    IndexFormat indexFormat = IndexFormat::Uint32;
+    uint32_t lodIndexCounts[MAX_MESH_LODS] = {};
+    uint32_t lodCount = 0;
+    MeshBounds bounds;                      // Quantized positions are relative to these
+
+    // Meshlets of LOD 0, optional. Offsets are relative to these arrays.
+    const Meshlet* meshlets = nullptr;
+    const MeshletBounds* meshletBounds = nullptr;
+    uint32_t meshletCount = 0;
+    const uint32_t* meshletVertexIndices = nullptr;
+    uint32_t meshletVertexIndexCount = 0;
+    const uint8_t* meshletTriangles = nullptr;
+    uint32_t meshletTriangleBytes = 0;
+
+    uint32_t GetTotalIndexCount() const;
+    size_t GetIndexDataSize() const;
+};
+
+// =============================================================================
+// Cooking
+// =============================================================================
+
+// What GeometryManager::CreateMesh does to a CPUMesh, minus the upload
+struct MeshCookSettings {
+    VertexLayout vertexLayout;
+    uint32_t autoLODCount = 0;              // LODs generated when the mesh has none
+    MeshLODSettings lodSettings;
+    bool allow16BitIndices = true;
+    bool optimize = false;
+    MeshOptimizeSettings optimizeSettings;
+    bool buildMeshlets = false;
+    MeshletBuildSettings meshletSettings;
+};
+
+// Owned result of cooking one mesh
+struct CookedMesh {
+    std::string name;
+    VertexLayout layout;
+    uint32_t vertexCount = 0;
+    IndexFormat indexFormat = IndexFormat::Uint32;
+    std::vector<uint32_t> lodIndexCounts;
+    MeshBounds bounds;
+    std::vector<uint8_t> vertexData;
+    std::vector<uint8_t> indexData;
+    MeshletData meshlets;
+
+    // View over the arrays above
+    EncodedMesh GetEncodedMesh() const;
+};
+
+// Optimizes, builds LODs and meshlets, then encodes. Empty vertexData when
+// the mesh is invalid.
+CookedMesh CookMesh(const CPUMesh& mesh, const MeshCookSettings& settings);
+
+// Copies an encoded mesh into owned arrays
+CookedMesh CopyEncodedMesh(const EncodedMesh& mesh);
+
+// =============================================================================
+// Cooked Mesh Files
+// =============================================================================
+
+// On-disk layout, little endian, every blob aligned to COOKED_MESH_ALIGNMENT:
+//   CookedMeshFileHeader
+//   CookedMeshRecord[meshCount]
+//   per mesh: vertex data, index data, meshlets, meshlet bounds,
+//             meshlet vertex indices, meshlet triangles
+// All meshes of a file share its vertex layout.
+constexpr uint32_t COOKED_MESH_MAGIC = 0x4D334544;     // "DE3M"
+constexpr uint32_t COOKED_MESH_VERSION = 1;
+constexpr uint32_t COOKED_MESH_ALIGNMENT = 16;
+constexpr uint32_t COOKED_MESH_NAME_LENGTH = 64;
+
+struct CookedMeshFileHeader {
+    uint32_t magic = COOKED_MESH_MAGIC;
+    uint32_t version = COOKED_MESH_VERSION;
+    uint8_t positionEncoding = 0;
+    uint8_t normalEncoding = 0;
+    uint8_t uvEncoding = 0;
+    uint8_t colorEncoding = 0;
+    uint32_t vertexStride = 0;
+    uint32_t meshCount = 0;
+    uint32_t reserved = 0;
+    uint64_t fileSize = 0;
+};
+
+// A blob's position in the file
+struct CookedMeshBlob {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct CookedMeshRecord {
+    char name[COOKED_MESH_NAME_LENGTH] = {};
+    uint32_t vertexCount = 0;
+    uint32_t indexFormat = 0;               // IndexFormat
+    uint32_t lodCount = 0;
+    uint32_t lodIndexCounts[MAX_MESH_LODS] = {};
+    MeshBounds bounds;
+    uint32_t meshletCount = 0;
+    uint32_t meshletVertexIndexCount = 0;
+    uint32_t meshletTriangleBytes = 0;
+    uint32_t reserved = 0;
+    CookedMeshBlob vertexData;
+    CookedMeshBlob indexData;
+    CookedMeshBlob meshlets;
+    CookedMeshBlob meshletBounds;
+    CookedMeshBlob meshletVertexIndices;
+    CookedMeshBlob meshletTriangles;
+};
+
+static_assert(sizeof(CookedMeshFileHeader) == 32, "CookedMeshFileHeader size mismatch");
+static_assert(sizeof(CookedMeshRecord) % 8 == 0, "CookedMeshRecord must keep blobs 8-byte aligned");
+
+// Meshes must share one vertex layout. Returns false on I/O errors.
+bool WriteCookedMeshFile(const std::string& path, const std::vector<CookedMesh>& meshes);
+
+// Maps a cooked file and hands out views into it. Open validates the header,
+// every record's ranges, every index and every meshlet once; GetMesh is then
+// just pointer arithmetic. Views are valid while the file stays open.
+class CookedMeshFile {
+public:
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    uint32_t GetMeshCount() const { return m_meshCount; }
+    const VertexLayout& GetVertexLayout() const { return m_layout; }
+    size_t GetFileSize() const { return m_file.GetSize(); }
+
+    EncodedMesh GetMesh(uint32_t index) const;
+    std::string GetMeshName(uint32_t index) const;
+
+private:
+    MappedFile m_file;
+    VertexLayout m_layout;
+    const CookedMeshRecord* m_records = nullptr;    // Right after the header, in the mapping
+    uint32_t m_meshCount = 0;
+};
@@ -0,0 +1,729 @@
+#include "CookedTexture.h"
+#include "TextureCompression.h"
+#include "jobs/JobSystem.h"
+
+// The implementation lives in IO/StbImpl.cpp
+#include "tinygltf-2.9.6/stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTURE_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define TEXTURE_USE_SSE2 0
+#endif
+
+namespace {
+
+// =============================================================================
+// Linear Levels
+// =============================================================================
+
+// A mip level as RGBA float while it is filtered. Color is linear, normals
+// are in [-1, 1].
+struct LinearLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> texels;
+};
+
+// Fine enough that the steep start of the sRGB curve stays under a quarter
+// of an 8-bit step
+constexpr uint32_t LINEAR_TO_SRGB_STEPS = 16384;
+
+float SRGBToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& GetSRGBToLinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values;
+        for (uint32_t i = 0; i < 256; ++i) {
+            values[i] = SRGBToLinear(i / 255.0f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+const std::vector<uint8_t>& GetLinearToSRGBTable() {
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> values(LINEAR_TO_SRGB_STEPS);
+        for (uint32_t i = 0; i < LINEAR_TO_SRGB_STEPS; ++i) {
+            const float srgb = LinearToSRGB(static_cast<float>(i) / (LINEAR_TO_SRGB_STEPS - 1));
+            values[i] = static_cast<uint8_t>(std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+        return values;
+    }();
+    return table;
+}
+
+uint8_t UnitToByte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+LinearLevel ToLinear(const TextureImage& image, TextureUsage usage) {
+    LinearLevel level;
+    level.width = image.width;
+    level.height = image.height;
+    level.texels.resize(image.pixels.size());
+
+    const std::array<float, 256>& srgbToLinear = GetSRGBToLinearTable();
+    for (size_t i = 0; i < image.pixels.size(); i += 4) {
+        const uint8_t* pixel = &image.pixels[i];
+        float* texel = &level.texels[i];
+        for (uint32_t c = 0; c < 3; ++c) {
+            switch (usage) {
+            case TextureUsage::Color:
+                texel[c] = srgbToLinear[pixel[c]];
+                break;
+            case TextureUsage::Normal:
+                texel[c] = pixel[c] * (2.0f / 255.0f) - 1.0f;
+                break;
+            default:
+                texel[c] = pixel[c] * (1.0f / 255.0f);
+                break;
+            }
+        }
+        texel[3] = pixel[3] * (1.0f / 255.0f);
+    }
+    return level;
+}
+
+TextureImage FromLinear(const LinearLevel& level, TextureUsage usage) {
+    TextureImage image;
+    image.width = level.width;
+    image.height = level.height;
+    image.pixels.resize(level.texels.size());
+
+    const std::vector<uint8_t>& linearToSRGB = GetLinearToSRGBTable();
+    for (size_t i = 0; i < level.texels.size(); i += 4) {
+        const float* texel = &level.texels[i];
+        uint8_t* pixel = &image.pixels[i];
+        for (uint32_t c = 0; c < 3; ++c) {
+            switch (usage) {
+            case TextureUsage::Color: {
+                const float step = std::clamp(texel[c], 0.0f, 1.0f) * (LINEAR_TO_SRGB_STEPS - 1) + 0.5f;
+                pixel[c] = linearToSRGB[static_cast<uint32_t>(step)];
+                break;
+            }
+            case TextureUsage::Normal:
+                pixel[c] = UnitToByte(texel[c] * 0.5f + 0.5f);
+                break;
+            default:
+                pixel[c] = UnitToByte(texel[c]);
+                break;
+            }
+        }
+        pixel[3] = UnitToByte(texel[3]);
+    }
+    return image;
+}
+
+// Source texels one destination texel averages along one axis. Even sizes
+// take two halves; odd sizes 2m+1 shrink to m, so each destination texel
+// covers 2 + 1/m source texels and three taps weigh in the partial ones at
+// both ends. Nothing is dropped at the last row or column.
+struct FilterTaps {
+    uint32_t first = 0;
+    uint32_t count = 1;
+    float weights[3] = { 1.0f, 0.0f, 0.0f };
+};
+
+FilterTaps GetFilterTaps(uint32_t sourceSize, uint32_t index) {
+    FilterTaps taps;
+    if (sourceSize == 1) {
+        return taps;
+    }
+
+    taps.first = index * 2;
+    if (sourceSize % 2 == 0) {
+        taps.count = 2;
+        taps.weights[0] = 0.5f;
+        taps.weights[1] = 0.5f;
+    } else {
+        const float half = static_cast<float>(sourceSize / 2);
+        const float inverseSize = 1.0f / sourceSize;
+        taps.count = 3;
+        taps.weights[0] = (half - index) * inverseSize;
+        taps.weights[1] = half * inverseSize;
+        taps.weights[2] = (index + 1) * inverseSize;
+    }
+    return taps;
+}
+
+// Box filter to half size, one texel (four floats) per SSE register
+LinearLevel Downsample(const LinearLevel& source) {
+    LinearLevel level;
+    level.width = std::max(source.width / 2, 1u);
+    level.height = std::max(source.height / 2, 1u);
+    level.texels.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+    std::vector<FilterTaps> columnTaps(level.width);
+    for (uint32_t x = 0; x < level.width; ++x) {
+        columnTaps[x] = GetFilterTaps(source.width, x);
+    }
+
+    const size_t sourceStride = static_cast<size_t>(source.width) * 4;
+    for (uint32_t y = 0; y < level.height; ++y) {
+        const FilterTaps rowTaps = GetFilterTaps(source.height, y);
+        float* destination = &level.texels[static_cast<size_t>(y) * level.width * 4];
+
+        for (uint32_t x = 0; x < level.width; ++x) {
+            const FilterTaps& taps = columnTaps[x];
+#if TEXTURE_USE_SSE2
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t r = 0; r < rowTaps.count; ++r) {
+                const float* row = &source.texels[(rowTaps.first + r) * sourceStride + taps.first * 4];
+                __m128 rowSum = _mm_mul_ps(_mm_loadu_ps(row), _mm_set1_ps(taps.weights[0]));
+                for (uint32_t c = 1; c < taps.count; ++c) {
+                    rowSum = _mm_add_ps(rowSum, _mm_mul_ps(_mm_loadu_ps(row + c * 4), _mm_set1_ps(taps.weights[c])));
+                }
+                sum = _mm_add_ps(sum, _mm_mul_ps(rowSum, _mm_set1_ps(rowTaps.weights[r])));
+            }
+            _mm_storeu_ps(destination + x * 4, sum);
+#else
+            for (uint32_t channel = 0; channel < 4; ++channel) {
+                float sum = 0.0f;
+                for (uint32_t r = 0; r < rowTaps.count; ++r) {
+                    const float* row = &source.texels[(rowTaps.first + r) * sourceStride + taps.first * 4];
+                    float rowSum = 0.0f;
+                    for (uint32_t c = 0; c < taps.count; ++c) {
+                        rowSum += row[c * 4 + channel] * taps.weights[c];
+                    }
+                    sum += rowSum * rowTaps.weights[r];
+                }
+                destination[x * 4 + channel] = sum;
+            }
+#endif
+        }
+    }
+    return level;
+}
+
+// Unit length XYZ, alpha untouched. Degenerate normals (averaged to zero)
+// point straight out of the surface.
+void Renormalize(LinearLevel& level) {
+    const size_t count = level.texels.size();
+#if TEXTURE_USE_SSE2
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 up = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+    const __m128 epsilon = _mm_set1_ps(1e-12f);
+    for (size_t i = 0; i < count; i += 4) {
+        const __m128 texel = _mm_loadu_ps(&level.texels[i]);
+        const __m128 squared = _mm_mul_ps(texel, texel);
+        // x + y + z in each of the first three lanes
+        const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(3, 0, 2, 1))),
+                                                _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(3, 1, 0, 2)));
+        const __m128 valid = _mm_cmpgt_ps(lengthSquared, epsilon);
+        __m128 normal = _mm_div_ps(texel, _mm_sqrt_ps(_mm_max_ps(lengthSquared, epsilon)));
+        normal = _mm_or_ps(_mm_and_ps(valid, normal), _mm_andnot_ps(valid, up));
+        _mm_storeu_ps(&level.texels[i], _mm_or_ps(_mm_and_ps(xyzMask, normal), _mm_andnot_ps(xyzMask, texel)));
+    }
+#else
+    for (size_t i = 0; i < count; i += 4) {
+        float* texel = &level.texels[i];
+        const float lengthSquared = texel[0] * texel[0] + texel[1] * texel[1] + texel[2] * texel[2];
+        if (lengthSquared > 1e-12f) {
+            const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+            texel[0] *= inverseLength;
+            texel[1] *= inverseLength;
+            texel[2] *= inverseLength;
+        } else {
+            texel[0] = 0.0f;
+            texel[1] = 0.0f;
+            texel[2] = 1.0f;
+        }
+    }
+#endif
+}
+
+// Bilinear, texel centers mapped onto texel centers so UVs keep their place
+LinearLevel Resample(const LinearLevel& source, uint32_t width, uint32_t height) {
+    LinearLevel level;
+    level.width = width;
+    level.height = height;
+    level.texels.resize(static_cast<size_t>(width) * height * 4);
+
+    const float scaleX = static_cast<float>(source.width) / width;
+    const float scaleY = static_cast<float>(source.height) / height;
+    for (uint32_t y = 0; y < height; ++y) {
+        const float sourceY = std::max((y + 0.5f) * scaleY - 0.5f, 0.0f);
+        const uint32_t y0 = std::min(static_cast<uint32_t>(sourceY), source.height - 1);
+        const uint32_t y1 = std::min(y0 + 1, source.height - 1);
+        const float fy = sourceY - y0;
+
+        for (uint32_t x = 0; x < width; ++x) {
+            const float sourceX = std::max((x + 0.5f) * scaleX - 0.5f, 0.0f);
+            const uint32_t x0 = std::min(static_cast<uint32_t>(sourceX), source.width - 1);
+            const uint32_t x1 = std::min(x0 + 1, source.width - 1);
+            const float fx = sourceX - x0;
+
+            const float* t00 = &source.texels[(static_cast<size_t>(y0) * source.width + x0) * 4];
+            const float* t10 = &source.texels[(static_cast<size_t>(y0) * source.width + x1) * 4];
+            const float* t01 = &source.texels[(static_cast<size_t>(y1) * source.width + x0) * 4];
+            const float* t11 = &source.texels[(static_cast<size_t>(y1) * source.width + x1) * 4];
+            float* destination = &level.texels[(static_cast<size_t>(y) * width + x) * 4];
+            for (uint32_t c = 0; c < 4; ++c) {
+                const float top = t00[c] + (t10[c] - t00[c]) * fx;
+                const float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+                destination[c] = top + (bottom - top) * fy;
+            }
+        }
+    }
+    return level;
+}
+
+// Level 0 from base, each further level filtered from the one before. Only
+// the level being filtered is kept in float.
+std::vector<TextureImage> BuildMipChain(LinearLevel base, TextureUsage usage, uint32_t maxLevels) {
+    uint32_t levelCount = 1;
+    for (uint32_t size = std::max(base.width, base.height); size > 1; size /= 2) {
+        levelCount++;
+    }
+    levelCount = std::min(levelCount, MAX_TEXTURE_LEVELS);
+    if (maxLevels > 0) {
+        levelCount = std::min(levelCount, maxLevels);
+    }
+
+    std::vector<TextureImage> levels;
+    levels.reserve(levelCount);
+    LinearLevel current = std::move(base);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        if (level > 0) {
+            current = Downsample(current);
+        }
+        if (usage == TextureUsage::Normal) {
+            Renormalize(current);
+        }
+        levels.push_back(FromLinear(current, usage));
+    }
+    return levels;
+}
+
+// =============================================================================
+// Block Helpers
+// =============================================================================
+
+uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Width of one row of the level in elements (blocks, or pixels for RGBA8)
+uint32_t GetRowElements(TextureFormat format, uint32_t width) {
+    return IsBlockCompressed(format) ? (width + TEXTURE_BLOCK_DIMENSION - 1) / TEXTURE_BLOCK_DIMENSION : width;
+}
+
+uint32_t GetRowCount(TextureFormat format, uint32_t height) {
+    return IsBlockCompressed(format) ? (height + TEXTURE_BLOCK_DIMENSION - 1) / TEXTURE_BLOCK_DIMENSION : height;
+}
+
+// The 4x4 pixels of a block, clamped at the edges of levels under 4 pixels
+void GatherBlock(const TextureImage& image, uint32_t blockX, uint32_t blockY, uint8_t* pixels) {
+    for (uint32_t y = 0; y < TEXTURE_BLOCK_DIMENSION; ++y) {
+        const uint32_t sourceY = std::min(blockY * TEXTURE_BLOCK_DIMENSION + y, image.height - 1);
+        for (uint32_t x = 0; x < TEXTURE_BLOCK_DIMENSION; ++x) {
+            const uint32_t sourceX = std::min(blockX * TEXTURE_BLOCK_DIMENSION + x, image.width - 1);
+            memcpy(pixels + (y * TEXTURE_BLOCK_DIMENSION + x) * 4,
+                   &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4], 4);
+        }
+    }
+}
+
+void EncodeBlock(TextureFormat format, const uint8_t* pixels, uint8_t* block) {
+    switch (format) {
+    case TextureFormat::BC1:
+    case TextureFormat::BC1_SRGB:
+        EncodeBC1Block(pixels, block);
+        break;
+    case TextureFormat::BC3:
+    case TextureFormat::BC3_SRGB:
+        EncodeBC3Block(pixels, block);
+        break;
+    case TextureFormat::BC5:
+        EncodeBC5Block(pixels, block);
+        break;
+    default:
+        EncodeBC7Block(pixels, block);
+        break;
+    }
+}
+
+bool DecodeBlock(TextureFormat format, const uint8_t* block, uint8_t* pixels) {
+    switch (format) {
+    case TextureFormat::BC1:
+    case TextureFormat::BC1_SRGB:
+        DecodeBC1Block(block, pixels);
+        return true;
+    case TextureFormat::BC3:
+    case TextureFormat::BC3_SRGB:
+        DecodeBC3Block(block, pixels);
+        return true;
+    case TextureFormat::BC5:
+        DecodeBC5Block(block, pixels);
+        return true;
+    default:
+        return DecodeBC7Block(block, pixels);
+    }
+}
+
+TextureFormat ResolveFormat(TextureFormat format, TextureUsage usage) {
+    if (usage != TextureUsage::Color) {
+        switch (format) {
+        case TextureFormat::RGBA8_SRGB: return TextureFormat::RGBA8;
+        case TextureFormat::BC1_SRGB: return TextureFormat::BC1;
+        case TextureFormat::BC3_SRGB: return TextureFormat::BC3;
+        case TextureFormat::BC7_SRGB: return TextureFormat::BC7;
+        default: return format;
+        }
+    }
+    switch (format) {
+    case TextureFormat::RGBA8: return TextureFormat::RGBA8_SRGB;
+    case TextureFormat::BC1: return TextureFormat::BC1_SRGB;
+    case TextureFormat::BC3: return TextureFormat::BC3_SRGB;
+    case TextureFormat::BC7: return TextureFormat::BC7_SRGB;
+    default: return format;     // BC5 has no sRGB variant
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// Images
+// =============================================================================
+
+bool LoadTextureImage(const std::string& path, TextureImage& image) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        printf("CookedTexture: Failed to open '%s'\n", path.c_str());
+        return false;
+    }
+    if (!LoadTextureImage(file.GetData(), file.GetSize(), image)) {
+        printf("CookedTexture: Failed to decode '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool LoadTextureImage(const void* data, size_t size, TextureImage& image) {
+    if (!data || size == 0 || size > static_cast<size_t>(INT32_MAX)) {
+        return false;
+    }
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(static_cast<const stbi_uc*>(data), static_cast<int>(size),
+                                            &width, &height, &channels, 4);
+    if (!pixels) {
+        return false;
+    }
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+    return true;
+}
+
+std::vector<TextureImage> GenerateMipChain(const TextureImage& image, TextureUsage usage, uint32_t maxLevels) {
+    if (!image.IsValid()) {
+        return {};
+    }
+    return BuildMipChain(ToLinear(image, usage), usage, maxLevels);
+}
+
+TextureImage ResizeTextureImage(const TextureImage& image, TextureUsage usage, uint32_t width, uint32_t height) {
+    if (!image.IsValid() || width == 0 || height == 0) {
+        return {};
+    }
+    LinearLevel level = Resample(ToLinear(image, usage), width, height);
+    if (usage == TextureUsage::Normal) {
+        Renormalize(level);
+    }
+    return FromLinear(level, usage);
+}
+
+// =============================================================================
+// Cooking
+// =============================================================================
+
+CookedTexture CookTexture(const TextureImage& image, const TextureCookSettings& settings, JobSystem* jobSystem) {
+    CookedTexture cooked;
+    if (!image.IsValid()) {
+        return cooked;
+    }
+
+    cooked.usage = settings.usage;
+    cooked.format = ResolveFormat(settings.format, settings.usage);
+
+    // Block formats need level 0 in whole blocks. Resampling keeps UVs in
+    // place where padding would shift them.
+    LinearLevel base = ToLinear(image, settings.usage);
+    if (IsBlockCompressed(cooked.format)) {
+        const uint32_t width = AlignUp(image.width, TEXTURE_BLOCK_DIMENSION);
+        const uint32_t height = AlignUp(image.height, TEXTURE_BLOCK_DIMENSION);
+        if (width != image.width || height != image.height) {
+            base = Resample(base, width, height);
+        }
+    }
+    cooked.width = base.width;
+    cooked.height = base.height;
+
+    const std::vector<TextureImage> mips = BuildMipChain(std::move(base), settings.usage, settings.generateMips ? settings.maxLevels : 1);
+
+    // Footprints the GPU copy expects
+    const uint32_t elementSize = GetTextureElementSize(cooked.format);
+    uint64_t cursor = 0;
+    cooked.levels.resize(mips.size());
+    for (size_t i = 0; i < mips.size(); ++i) {
+        TextureLevel& level = cooked.levels[i];
+        level.width = mips[i].width;
+        level.height = mips[i].height;
+        level.rowPitch = AlignUp(GetRowElements(cooked.format, level.width) * elementSize, TEXTURE_ROW_PITCH_ALIGNMENT);
+        level.rowCount = GetRowCount(cooked.format, level.height);
+        level.offset = AlignUp(cursor, static_cast<uint64_t>(TEXTURE_PLACEMENT_ALIGNMENT));
+        level.size = static_cast<uint64_t>(level.rowPitch) * level.rowCount;
+        cursor = level.offset + level.size;
+    }
+    cooked.data.resize(cursor);
+
+    // One task per row of blocks over every level, the big levels dominate
+    struct RowTask {
+        uint32_t level;
+        uint32_t row;
+    };
+    std::vector<RowTask> tasks;
+    for (uint32_t level = 0; level < cooked.levels.size(); ++level) {
+        for (uint32_t row = 0; row < cooked.levels[level].rowCount; ++row) {
+            tasks.push_back({ level, row });
+        }
+    }
+
+    auto encodeRow = [&](uint32_t taskIndex) {
+        const RowTask task = tasks[taskIndex];
+        const TextureImage& mip = mips[task.level];
+        const TextureLevel& level = cooked.levels[task.level];
+        uint8_t* destination = cooked.data.data() + level.offset + static_cast<size_t>(task.row) * level.rowPitch;
+
+        if (!IsBlockCompressed(cooked.format)) {
+            memcpy(destination, &mip.pixels[static_cast<size_t>(task.row) * mip.width * 4], static_cast<size_t>(mip.width) * 4);
+            return;
+        }
+        uint8_t pixels[TEXTURE_BLOCK_PIXELS * 4];
+        const uint32_t blocks = GetRowElements(cooked.format, mip.width);
+        for (uint32_t block = 0; block < blocks; ++block) {
+            GatherBlock(mip, block, task.row, pixels);
+            EncodeBlock(cooked.format, pixels, destination + static_cast<size_t>(block) * elementSize);
+        }
+    };
+
+    if (jobSystem) {
+        jobSystem->ParallelFor(static_cast<uint32_t>(tasks.size()), encodeRow);
+    } else {
+        for (uint32_t i = 0; i < tasks.size(); ++i) {
+            encodeRow(i);
+        }
+    }
+    return cooked;
+}
+
+TextureImage DecodeTextureLevel(const uint8_t* data, const TextureLevel& level, TextureFormat format) {
+    TextureImage image;
+    image.width = level.width;
+    image.height = level.height;
+    image.pixels.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+    if (!IsBlockCompressed(format)) {
+        for (uint32_t y = 0; y < level.height; ++y) {
+            memcpy(&image.pixels[static_cast<size_t>(y) * level.width * 4], data + static_cast<size_t>(y) * level.rowPitch,
+                   static_cast<size_t>(level.width) * 4);
+        }
+        return image;
+    }
+
+    const uint32_t elementSize = GetTextureElementSize(format);
+    const uint32_t blocksWide = GetRowElements(format, level.width);
+    uint8_t pixels[TEXTURE_BLOCK_PIXELS * 4];
+    for (uint32_t blockY = 0; blockY < level.rowCount; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+            const uint8_t* block = data + static_cast<size_t>(blockY) * level.rowPitch + static_cast<size_t>(blockX) * elementSize;
+            if (!DecodeBlock(format, block, pixels)) {
+                // Magenta for modes this decoder doesn't know
+                for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+                    pixels[i * 4 + 0] = 255;
+                    pixels[i * 4 + 1] = 0;
+                    pixels[i * 4 + 2] = 255;
+                    pixels[i * 4 + 3] = 255;
+                }
+            }
+
+            for (uint32_t y = 0; y < TEXTURE_BLOCK_DIMENSION; ++y) {
+                const uint32_t imageY = blockY * TEXTURE_BLOCK_DIMENSION + y;
+                if (imageY >= level.height) {
+                    break;
+                }
+                for (uint32_t x = 0; x < TEXTURE_BLOCK_DIMENSION; ++x) {
+                    const uint32_t imageX = blockX * TEXTURE_BLOCK_DIMENSION + x;
+                    if (imageX < level.width) {
+                        memcpy(&image.pixels[(static_cast<size_t>(imageY) * level.width + imageX) * 4],
+                               pixels + (y * TEXTURE_BLOCK_DIMENSION + x) * 4, 4);
+                    }
+                }
+            }
+        }
+    }
+    return image;
+}
+
+// =============================================================================
+// Writing
+// =============================================================================
+
+bool WriteCookedTextureFile(const std::string& path, const CookedTexture& texture) {
+    if (texture.levels.empty() || texture.levels.size() > MAX_TEXTURE_LEVELS) {
+        printf("CookedTexture: '%s' has no levels or too many to write\n", path.c_str());
+        return false;
+    }
+
+    CookedTextureFileHeader header;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.usage = static_cast<uint32_t>(texture.usage);
+    header.width = texture.width;
+    header.height = texture.height;
+    header.levelCount = static_cast<uint32_t>(texture.levels.size());
+    strncpy(header.name, texture.name.c_str(), COOKED_TEXTURE_NAME_LENGTH - 1);
+    header.dataOffset = AlignUp(static_cast<uint64_t>(sizeof(header) + texture.levels.size() * sizeof(CookedTextureLevelRecord)),
+                                static_cast<uint64_t>(TEXTURE_PLACEMENT_ALIGNMENT));
+    header.dataSize = texture.data.size();
+    header.fileSize = header.dataOffset + header.dataSize;
+
+    std::vector<CookedTextureLevelRecord> records(texture.levels.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const TextureLevel& level = texture.levels[i];
+        records[i].width = level.width;
+        records[i].height = level.height;
+        records[i].rowPitch = level.rowPitch;
+        records[i].rowCount = level.rowCount;
+        records[i].offset = level.offset;
+        records[i].size = level.size;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        printf("CookedTexture: Failed to create '%s'\n", path.c_str());
+        return false;
+    }
+
+    static const uint8_t padding[TEXTURE_PLACEMENT_ALIGNMENT] = {};
+    const size_t tableEnd = sizeof(header) + records.size() * sizeof(CookedTextureLevelRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CookedTextureLevelRecord));
+    file.write(reinterpret_cast<const char*>(padding), header.dataOffset - tableEnd);
+    file.write(reinterpret_cast<const char*>(texture.data.data()), texture.data.size());
+
+    if (!file.good()) {
+        printf("CookedTexture: Failed to write '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+bool CookedTextureFile::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path)) {
+        return false;
+    }
+
+    const size_t fileSize = m_file.GetSize();
+    const uint8_t* data = m_file.GetData();
+
+    CookedTextureFileHeader header;
+    if (fileSize < sizeof(header)) {
+        printf("CookedTexture: '%s' is too small\n", path.c_str());
+        Close();
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != COOKED_TEXTURE_MAGIC || header.version != COOKED_TEXTURE_VERSION || header.fileSize != fileSize) {
+        printf("CookedTexture: '%s' is not a version %u cooked texture file\n", path.c_str(), COOKED_TEXTURE_VERSION);
+        Close();
+        return false;
+    }
+
+    const size_t tableEnd = sizeof(header) + static_cast<size_t>(header.levelCount) * sizeof(CookedTextureLevelRecord);
+    if (header.format > static_cast<uint32_t>(TextureFormat::BC7_SRGB) ||
+        header.usage > static_cast<uint32_t>(TextureUsage::Normal) ||
+        header.levelCount == 0 || header.levelCount > MAX_TEXTURE_LEVELS ||
+        header.dataOffset % TEXTURE_PLACEMENT_ALIGNMENT != 0 || header.dataOffset < tableEnd ||
+        header.dataOffset > fileSize || header.dataSize != fileSize - header.dataOffset) {
+        printf("CookedTexture: '%s' has a bad header\n", path.c_str());
+        Close();
+        return false;
+    }
+
+    m_format = static_cast<TextureFormat>(header.format);
+    m_usage = static_cast<TextureUsage>(header.usage);
+    m_width = header.width;
+    m_height = header.height;
+    m_name.assign(header.name, strnlen(header.name, COOKED_TEXTURE_NAME_LENGTH));
+
+    // Every level has to fit its footprint and the blob
+    const uint32_t elementSize = GetTextureElementSize(m_format);
+    std::vector<CookedTextureLevelRecord> records(header.levelCount);
+    memcpy(records.data(), data + sizeof(header), records.size() * sizeof(CookedTextureLevelRecord));
+    m_levels.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const CookedTextureLevelRecord& record = records[i];
+        const bool valid = record.width > 0 && record.height > 0 &&
+                           record.rowPitch % TEXTURE_ROW_PITCH_ALIGNMENT == 0 &&
+                           static_cast<uint64_t>(GetRowElements(m_format, record.width)) * elementSize <= record.rowPitch &&
+                           record.rowCount == GetRowCount(m_format, record.height) &&
+                           record.offset % TEXTURE_PLACEMENT_ALIGNMENT == 0 &&
+                           record.size == static_cast<uint64_t>(record.rowPitch) * record.rowCount &&
+                           record.offset <= header.dataSize && record.size <= header.dataSize - record.offset;
+        if (!valid) {
+            printf("CookedTexture: '%s' level %zu is out of range\n", path.c_str(), i);
+            Close();
+            return false;
+        }
+
+        TextureLevel& level = m_levels[i];
+        level.width = record.width;
+        level.height = record.height;
+        level.rowPitch = record.rowPitch;
+        level.rowCount = record.rowCount;
+        level.offset = record.offset;
+        level.size = record.size;
+    }
+
+    m_data = data + header.dataOffset;
+    m_dataSize = static_cast<size_t>(header.dataSize);
+    return true;
+}
+
+void CookedTextureFile::Close() {
+    m_file.Close();
+    m_name.clear();
+    m_levels.clear();
+    m_data = nullptr;
+    m_dataSize = 0;
+    m_width = 0;
+    m_height = 0;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RenderTypes.h"
+#include "IO/MappedFile.h"
+
+class JobSystem;
+
+// =============================================================================
+// Texture Images
+// =============================================================================
+
+// Uncompressed RGBA8 pixels, rows tightly packed
+struct TextureImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;
+
+    bool IsValid() const { return width > 0 && height > 0 && pixels.size() == static_cast<size_t>(width) * height * 4; }
+};
+
+// Any format stb_image reads (PNG, JPEG, TGA, BMP, ...), expanded to RGBA8
+bool LoadTextureImage(const std::string& path, TextureImage& image);
+bool LoadTextureImage(const void* data, size_t size, TextureImage& image);
+
+// What the texels mean, which decides filtering and format
+enum class TextureUsage : uint32_t {
+    Color,          // sRGB color, alpha linear. Filtered in linear space, stored as an _SRGB format
+    Linear,         // Data (roughness, metalness, occlusion, height), filtered as stored
+    Normal          // Tangent-space normal in RGB, renormalized on every level
+};
+
+// Full mip chain of image down to 1x1, level 0 included (maxLevels 0 for
+// all of them). Each level halves the one above, odd sizes rounding down,
+// with a box filter in linear float with SSE2: two taps along even axes,
+// three weighted taps along odd ones so their last row and column still
+// count. Normal maps are renormalized on every level, level 0 included.
+std::vector<TextureImage> GenerateMipChain(const TextureImage& image, TextureUsage usage, uint32_t maxLevels = 0);
+
+// Bilinear resize, filtered like the mip chain
+TextureImage ResizeTextureImage(const TextureImage& image, TextureUsage usage, uint32_t width, uint32_t height);
+
+// =============================================================================
+// Cooking
+// =============================================================================
+
+struct TextureCookSettings {
+    TextureUsage usage = TextureUsage::Color;
+    TextureFormat format = TextureFormat::BC7;     // Color usage picks the _SRGB variant
+    bool generateMips = true;
+    uint32_t maxLevels = 0;                         // 0 for the full chain
+};
+
+// Copies to the GPU need rows and subresources at these alignments
+// (D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and _PLACEMENT_ALIGNMENT), so cooked
+// data is laid out with them and can be copied into an upload buffer as is.
+constexpr uint32_t TEXTURE_ROW_PITCH_ALIGNMENT = 256;
+constexpr uint32_t TEXTURE_PLACEMENT_ALIGNMENT = 512;
+constexpr uint32_t MAX_TEXTURE_LEVELS = 16;
+
+// One mip level's footprint in the data blob
+struct TextureLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowPitch = 0;          // Bytes between rows of blocks (or pixels for RGBA8)
+    uint32_t rowCount = 0;
+    uint64_t offset = 0;            // From the start of the data blob
+    uint64_t size = 0;              // rowPitch * rowCount
+};
+
+struct CookedTexture {
+    std::string name;
+    TextureFormat format = TextureFormat::RGBA8;
+    TextureUsage usage = TextureUsage::Color;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+};
+
+// Builds the mip chain and encodes every level. Blocks are encoded in
+// parallel on jobSystem when given (pass none from inside a job). Block
+// formats need a level 0 that is a multiple of 4 on both sides, other sizes
+// are resampled up to one. Empty data when the image is invalid.
+CookedTexture CookTexture(const TextureImage& image, const TextureCookSettings& settings, JobSystem* jobSystem = nullptr);
+
+// Expands one level of cooked data back to RGBA8, for verification.
+// BC7 decodes the mode CookTexture writes only.
+TextureImage DecodeTextureLevel(const uint8_t* data, const TextureLevel& level, TextureFormat format);
+
+// =============================================================================
+// Cooked Texture Files
+// =============================================================================
+
+// On-disk layout, little endian:
+//   CookedTextureFileHeader
+//   CookedTextureLevelRecord[levelCount]
+//   data blob at dataOffset (TEXTURE_PLACEMENT_ALIGNMENT), levels laid out
+//   as TextureLevel describes
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x54334544;  // "DE3T"
+constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+constexpr uint32_t COOKED_TEXTURE_NAME_LENGTH = 64;
+
+struct CookedTextureFileHeader {
+    uint32_t magic = COOKED_TEXTURE_MAGIC;
+    uint32_t version = COOKED_TEXTURE_VERSION;
+    uint32_t format = 0;                    // TextureFormat
+    uint32_t usage = 0;                     // TextureUsage
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    uint32_t reserved = 0;
+    char name[COOKED_TEXTURE_NAME_LENGTH] = {};
+    uint64_t dataOffset = 0;
+    uint64_t dataSize = 0;
+    uint64_t fileSize = 0;
+};
+
+struct CookedTextureLevelRecord {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowPitch = 0;
+    uint32_t rowCount = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+static_assert(sizeof(CookedTextureFileHeader) == 120, "CookedTextureFileHeader size mismatch");
+static_assert(sizeof(CookedTextureLevelRecord) == 32, "CookedTextureLevelRecord size mismatch");
+
+bool WriteCookedTextureFile(const std::string& path, const CookedTexture& texture);
+
+// Maps a cooked texture and hands out views into it. Open validates the
+// header and every level once. GetData is the whole blob, ready to be
+// copied to a TEXTURE_PLACEMENT_ALIGNMENT-aligned upload offset and
+// copied per level with the footprints of GetLevel.
+class CookedTextureFile {
+public:
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    TextureFormat GetFormat() const { return m_format; }
+    TextureUsage GetUsage() const { return m_usage; }
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+    const TextureLevel& GetLevel(uint32_t index) const { return m_levels[index]; }
+    const std::string& GetName() const { return m_name; }
+
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetDataSize() const { return m_dataSize; }
+    const uint8_t* GetLevelData(uint32_t index) const { return m_data + m_levels[index].offset; }
+
+private:
+    MappedFile m_file;
+    std::string m_name;
+    TextureFormat m_format = TextureFormat::RGBA8;
+    TextureUsage m_usage = TextureUsage::Color;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    std::vector<TextureLevel> m_levels;
+    const uint8_t* m_data = nullptr;
+    size_t m_dataSize = 0;
+};
@@ -0,0 +1,112 @@
+#include "CopyUploadQueue.h"
+#include <cstdio>
+
+CopyUploadQueue::~CopyUploadQueue() {
+    Shutdown();
+}
+
+bool CopyUploadQueue::Initialize(ID3D12Device* device, CommandQueue* copyQueue, uint32_t allocatorCount) {
+    if (!device || !copyQueue || allocatorCount == 0) {
+        printf("CopyUploadQueue: Invalid parameters\n");
+        return false;
+    }
+
+    m_queue = copyQueue;
+
+    m_allocators.resize(allocatorCount);
+    for (AllocatorSlot& slot : m_allocators) {
+        slot.allocator = std::make_unique<CommandAllocator>();
+        if (!slot.allocator->Initialize(device, D3D12_COMMAND_LIST_TYPE_COPY)) {
+            printf("CopyUploadQueue: Failed to create copy command allocator\n");
+            Shutdown();
+            return false;
+        }
+    }
+
+    m_commandList = std::make_unique<CommandList>();
+    if (!m_commandList->Initialize(device, m_allocators[0].allocator.get(), D3D12_COMMAND_LIST_TYPE_COPY)) {
+        printf("CopyUploadQueue: Failed to create copy command list\n");
+        Shutdown();
+        return false;
+    }
+
+    return true;
+}
+
+void CopyUploadQueue::Shutdown() {
+    if (m_queue) {
+        WaitIdle();
+    }
+
+    m_commandList.reset();
+    m_allocators.clear();
+    m_activeAllocator = UINT32_MAX;
+    m_queue = nullptr;
+}
+
+bool CopyUploadQueue::BeginBatch() {
+    if (!m_queue || m_activeAllocator != UINT32_MAX) {
+        return false;
+    }
+
+    // Any allocator whose last batch has completed can be reset
+    const uint64_t completedValue = m_queue->GetCompletedFenceValue();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_allocators.size()); ++i) {
+        AllocatorSlot& slot = m_allocators[i];
+        if (slot.fenceValue > completedValue) {
+            continue;
+        }
+
+        if (!slot.allocator->Reset() || !m_commandList->Reset(slot.allocator.get())) {
+            printf("CopyUploadQueue: Failed to reset copy command list\n");
+            return false;
+        }
+
+        m_activeAllocator = i;
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t CopyUploadQueue::SubmitBatch() {
+    if (m_activeAllocator == UINT32_MAX) {
+        return m_lastSubmittedFence;
+    }
+
+    if (!m_commandList->Close()) {
+        throw std::runtime_error("Failed to close copy command list");
+    }
+
+    ID3D12CommandList* commandLists[] = { m_commandList->GetCommandList() };
+    m_queue->ExecuteCommandLists(1, commandLists);
+
+    m_lastSubmittedFence = m_queue->Signal();
+    m_allocators[m_activeAllocator].fenceValue = m_lastSubmittedFence;
+    m_activeAllocator = UINT32_MAX;
+    return m_lastSubmittedFence;
+}
+
+void CopyUploadQueue::CancelBatch() {
+    if (m_activeAllocator == UINT32_MAX) {
+        return;
+    }
+
+    // Nothing was executed, the allocator stays free
+    m_commandList->Close();
+    m_activeAllocator = UINT32_MAX;
+}
+
+uint64_t CopyUploadQueue::GetNextFenceValue() const {
+    return m_queue ? m_queue->GetCurrentFenceValue() + 1 : 0;
+}
+
+uint64_t CopyUploadQueue::GetCompletedFenceValue() const {
+    return m_queue ? m_queue->GetCompletedFenceValue() : 0;
+}
+
+void CopyUploadQueue::WaitIdle() {
+    if (m_queue && m_lastSubmittedFence > 0) {
+        m_queue->WaitForFenceValue(m_lastSubmittedFence);
+    }
+}
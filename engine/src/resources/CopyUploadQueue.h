@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "AsyncUploadScheduler.h"
+#include "renderer/dx12/core/CommandQueue.h"
+#include "renderer/dx12/core/CommandAllocator.h"
+#include "renderer/dx12/core/CommandList.h"
+
+// =============================================================================
+// Copy Queue Upload Batches
+// =============================================================================
+
+// IUploadQueue on the dedicated D3D12 copy queue. Owns one copy command list
+// and a small pool of allocators, each reused once the batch recorded with it
+// has completed. Buffers written here are expected in COMMON so they promote
+// to COPY_DEST implicitly and decay back when the batch finishes; copy lists
+// cannot transition to graphics states.
+class CopyUploadQueue : public IUploadQueue {
+public:
+    CopyUploadQueue() = default;
+    ~CopyUploadQueue() override;
+
+    // Non-copyable
+    CopyUploadQueue(const CopyUploadQueue&) = delete;
+    CopyUploadQueue& operator=(const CopyUploadQueue&) = delete;
+
+    bool Initialize(ID3D12Device* device, CommandQueue* copyQueue, uint32_t allocatorCount);
+    void Shutdown();
+
+    // IUploadQueue
+    bool BeginBatch() override;
+    uint64_t SubmitBatch() override;
+    void CancelBatch() override;
+    uint64_t GetNextFenceValue() const override;
+    uint64_t GetCompletedFenceValue() const override;
+
+    // Valid between BeginBatch and SubmitBatch/CancelBatch
+    CommandList* GetCommandList() const { return m_commandList.get(); }
+    CommandQueue* GetQueue() const { return m_queue; }
+
+    // Blocks until every submitted batch has completed
+    void WaitIdle();
+
+private:
+    struct AllocatorSlot {
+        std::unique_ptr<CommandAllocator> allocator;
+        uint64_t fenceValue = 0;    // Last batch recorded with it
+    };
+
+    CommandQueue* m_queue = nullptr;
+    std::vector<AllocatorSlot> m_allocators;
+    std::unique_ptr<CommandList> m_commandList;
+    uint32_t m_activeAllocator = UINT32_MAX;
+    uint64_t m_lastSubmittedFence = 0;
+};
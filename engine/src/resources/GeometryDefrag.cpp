@@ -0,0 +1,81 @@
+#include "GeometryDefrag.h"
+#include <algorithm>
+
+float ComputeFragmentation(const std::vector<DefragBlock>& blocks) {
+    uint64_t totalFree = 0;
+    uint32_t largestFree = 0;
+    for (const DefragBlock& block : blocks) {
+        if (!block.used) {
+            totalFree += block.size;
+            largestFree = std::max(largestFree, block.size);
+        }
+    }
+
+    if (totalFree == 0) {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(static_cast<double>(largestFree) / static_cast<double>(totalFree));
+}
+
+uint32_t PlanDefragMoves(const std::vector<DefragBlock>& blocks, uint32_t budgetBytes,
+                         std::vector<DefragMove>& outMoves) {
+    outMoves.clear();
+
+    // Holes in address order, shrunk from the front as they are filled
+    struct Hole {
+        uint32_t offset;
+        uint32_t size;
+    };
+    std::vector<Hole> holes;
+    for (const DefragBlock& block : blocks) {
+        if (!block.used && block.size > 0) {
+            holes.push_back({ block.offset, block.size });
+        }
+    }
+    if (holes.empty()) {
+        return 0;
+    }
+
+    uint32_t movedBytes = 0;
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        const DefragBlock& block = *it;
+        if (!block.used || block.id == DEFRAG_PINNED_BLOCK || block.size == 0) {
+            continue;
+        }
+
+        // Nothing below this block can receive it once the lowest hole is above it
+        if (holes.front().offset >= block.offset) {
+            break;
+        }
+        if (block.size > budgetBytes - movedBytes) {
+            continue;
+        }
+
+        // First fit from the bottom, only strictly below the block itself
+        for (size_t holeIndex = 0; holeIndex < holes.size(); ++holeIndex) {
+            Hole& hole = holes[holeIndex];
+            if (hole.offset >= block.offset) {
+                break;
+            }
+            if (hole.size < block.size) {
+                continue;
+            }
+
+            outMoves.push_back({ block.id, block.offset, hole.offset, block.size });
+            movedBytes += block.size;
+
+            hole.offset += block.size;
+            hole.size -= block.size;
+            if (hole.size == 0) {
+                holes.erase(holes.begin() + holeIndex);
+            }
+            break;
+        }
+
+        if (holes.empty() || movedBytes >= budgetBytes) {
+            break;
+        }
+    }
+
+    return movedBytes;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// Geometry Defragmentation Planner
+// =============================================================================
+
+// Plans relocations that move live blocks from the top of a buffer into the
+// lowest holes that fit, so free space gathers into one large range at the
+// end. Pure CPU: it works on a layout snapshot and never touches the buffer.
+//
+// A moved block's old range is not treated as free while planning, since the
+// GPU may still read it until the copy's frame retires.
+
+static constexpr uint32_t DEFRAG_PINNED_BLOCK = UINT32_MAX;
+
+struct DefragBlock {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    uint32_t id = DEFRAG_PINNED_BLOCK;  // Caller's id, DEFRAG_PINNED_BLOCK if it must not move
+    bool used = false;
+};
+
+struct DefragMove {
+    uint32_t id = 0;
+    uint32_t srcOffset = 0;
+    uint32_t dstOffset = 0;
+    uint32_t size = 0;
+};
+
+// 0 when all free space is one block, approaching 1 as it splinters
+float ComputeFragmentation(const std::vector<DefragBlock>& blocks);
+
+// Blocks must be address ordered. Plans moves totalling at most budgetBytes,
+// considering candidates from the highest offset down. Returns bytes moved.
+uint32_t PlanDefragMoves(const std::vector<DefragBlock>& blocks, uint32_t budgetBytes,
+                         std::vector<DefragMove>& outMoves);
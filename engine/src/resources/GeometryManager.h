@@ -6,9 +6,25 @@
 #include <unordered_map>
 #include <string>
 #include <queue>
+#include <mutex>
+#include <atomic>
 
 #include "RenderTypes.h"
-#include "LinearAllocator.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "MeshletPool.h"
+#include "CookedMesh.h"
+#include "StreamingManager.h"
+#include "UploadRingAllocator.h"
+#include "TLSFAllocator.h"
+#include "GeometryDefrag.h"
+#include "AsyncUploadScheduler.h"
+#include "CopyUploadQueue.h"
+#include "UploadBatchRecorder.h"
+#include "SlotMap.h"
+#include "VertexLayout.h"
+#include "MeshCreationQueue.h"
+#include "MeshContentTable.h"
 #include "renderer/dx12/resources/Buffer.h"
 #include "renderer/dx12/core/CommandList.h"
 #include "D3D12MemAlloc.h"
@@ -17,7 +33,12 @@
 // Geometry Manager (Microsoft Engine Sample Style)
 // =============================================================================
 
-class GeometryManager {
+// CreateMesh, BeginMeshWrite, CommitMesh and CancelMeshWrite may be called
+// from any thread. New meshes are handed to the main thread through a
+// lock-free queue and join the registry in the next BeginFrame; until then
+// lookups treat them as not ready, and a DestroyMesh on them takes effect as
+// they join. Everything else belongs to the main thread.
+class GeometryManager : public IMeshStreamingTarget {
 public:
     // Constructor/Destructor
     explicit GeometryManager(D3D12MA::Allocator* allocator);
@@ -27,26 +48,94 @@ public:
     GeometryManager(const GeometryManager&) = delete;
     GeometryManager& operator=(const GeometryManager&) = delete;
 
-    // Create a mesh from description (returns immediately with handle)
+    // Create a mesh from description (returns immediately with handle). Any
+    // thread; LOD generation and the data copy run on the caller. With
+    // deduplicateMeshes, identical geometry returns the existing handle with
+    // its reference count raised; each CreateMesh pairs with one DestroyMesh.
     MeshHandle CreateMesh(const CPUMesh& mesh);
 
-    // Destroy a mesh (cleanup happens automatically)
-    void DestroyMesh(MeshHandle handle);
+    // Creation from data already in buffer format (see CookMesh and
+    // CookedMeshFile): no optimization, LOD generation or encoding, just a
+    // copy. Any thread. The layout must match the config's vertexLayout;
+    // meshlets are kept when buildMeshlets is on. Never deduplicated.
+    MeshHandle CreateMesh(const EncodedMesh& mesh) override;
+
+    // Zero-copy creation: reserves staging space in the mapped upload heap and
+    // the mesh's buffer ranges, then returns spans to decode straight into.
+    // The span stays valid until CommitMesh or CancelMeshWrite, and may be
+    // filled on any thread. Open writes hold the upload ring, so commit
+    // promptly. Invalid span when out of space; retry after a frame.
+    // indexCount covers LOD 0 only, such meshes get no generated LODs.
+    // Indices are 16-bit when allow16BitIndices and vertexCount permit, see
+    // WriteSpanIndices.
+    MeshWriteSpan BeginMeshWrite(uint32_t vertexCount, uint32_t indexCount);
+
+    // Queues the written data for upload. Bounds come from the caller since
+    // staging memory is too slow to read back, and must be the ones quantized
+    // positions were encoded against.
+    bool CommitMesh(const MeshWriteSpan& span, const MeshBounds& bounds);
+    void CancelMeshWrite(const MeshWriteSpan& span);
+
+    // Destroy a mesh (cleanup happens automatically). Shared meshes only go
+    // once their last reference is destroyed.
+    void DestroyMesh(MeshHandle handle) override;
 
     // Check if mesh is ready for rendering
     bool IsMeshReady(MeshHandle handle) const;
 
-    // Get render data for a mesh (returns nullptr if not ready)
+    // Get render data for a mesh (returns nullptr if not ready or stale). With
+    // drawInFlightUploads, meshes still copying are returned as well. The
+    // pointer is only valid until the next mesh is created.
     const MeshView* GetMeshRenderData(MeshHandle handle) const;
 
-    // Frame management - call once per frame
-    void BeginFrame(uint32_t frameIndex, CommandList* uploadCmdList);
+    // Get render data for a LOD, clamped to the last available LOD
+    const MeshView* GetMeshRenderData(MeshHandle handle, uint32_t lod) const;
+
+    // Copy-queue fence value a draw of this mesh must wait for on the GPU,
+    // 0 when it can be drawn without one
+    uint64_t GetMeshUploadFence(MeshHandle handle) const;
+
+    // Number of LODs including LOD 0 (0 for unknown handles)
+    uint32_t GetMeshLODCount(MeshHandle handle) const;
+
+    // Object-space bounds (returns nullptr for unknown handles)
+    const MeshBounds* GetMeshBounds(MeshHandle handle) const;
+
+    // Maps stored positions back to object space, fold it into the model
+    // matrix (identity unless the layout quantizes positions)
+    const MeshDecode* GetMeshDecode(MeshHandle handle) const;
+
+    // Meshlets of LOD 0 (empty unless created with buildMeshlets). Offsets in
+    // the records index the arrays of GetMeshletPool.
+    MeshletView GetMeshlets(MeshHandle handle) const;
+    const MeshletPool* GetMeshletPool() const { return m_meshletPool.get(); }
+
+    // CPU occluder geometry (returns nullptr unless created with isOccluder)
+    const OccluderGeometry* GetOccluderGeometry(MeshHandle handle) const;
+
+    // Frame management - call once per frame. Buffer ranges of destroyed
+    // meshes are tagged with pendingFenceValue and returned to the allocators
+    // once completedFenceValue reaches it.
+    void BeginFrame(uint32_t frameIndex, CommandList* uploadCmdList,
+                    uint64_t completedFenceValue, uint64_t pendingFenceValue);
+
+    // Moves mesh uploads onto the copy queue. Call after SetConfig; returns
+    // false and keeps recording into the frame's command list on failure.
+    bool EnableAsyncUploads(ID3D12Device* device, CommandQueue* copyQueue);
+    bool IsAsyncUploadEnabled() const { return m_copyUploads != nullptr; }
 
     // Check if there are pending uploads that need processing
-    bool HasPendingUploads() const { return !m_uploadQueue.empty(); }
+    bool HasPendingUploads() const {
+        return !m_uploadQueue.empty() || !m_uploadScheduler.IsIdle() || m_creation.GetQueuedCount() > 0;
+    }
 
-    // Bind vertex/index buffers for rendering
+    // Bind vertex/index buffers for rendering. The index buffer is bound as
+    // 32-bit, meshes whose views say otherwise need BindIndexBuffer first.
     void BindVertexIndexBuffers(CommandList* cmdList);
+    void BindIndexBuffer(CommandList* cmdList, IndexFormat format);
+
+    // Index buffer view of the given width, for recording draws elsewhere
+    IndexBufferBinding GetIndexBufferBinding(IndexFormat format) const;
 
     // =============================================================================
     // Statistics and Debug
@@ -56,10 +145,33 @@ public:
         uint32_t totalMeshes = 0;
         uint32_t readyMeshes = 0;
         uint32_t pendingUploads = 0;
+        uint32_t uploadingMeshes = 0;       // Copies in flight on the copy queue
+        uint32_t openMeshWrites = 0;        // BeginMeshWrite without commit yet
+        uint32_t uploadBatchesInFlight = 0;
         uint32_t pendingDeletions = 0;
         size_t vertexBufferUsage = 0;
         size_t indexBufferUsage = 0;
         size_t uploadHeapUsage = 0;
+        size_t vertexLargestFreeBlock = 0;
+        size_t indexLargestFreeBlock = 0;
+        uint32_t vertexFreeBlocks = 0;
+        uint32_t indexFreeBlocks = 0;
+        uint32_t pendingFrees = 0;          // Ranges waiting on a GPU fence
+        float vertexFragmentation = 0.0f;   // 1 - largest free block / total free
+        float indexFragmentation = 0.0f;
+        uint32_t pendingRelocations = 0;
+        size_t relocatedBytes = 0;          // Total moved by defragmentation
+        uint64_t uploadCopiesQueued = 0;    // Graphics-list copies before and after merging
+        uint64_t uploadCopiesRecorded = 0;
+        uint64_t uploadBarriers = 0;
+        uint64_t dedupHits = 0;             // CreateMesh calls answered with a shared mesh
+        uint64_t dedupMisses = 0;           // Hashed meshes that needed their own allocation
+        uint64_t dedupBytesSaved = 0;       // Geometry bytes not allocated or uploaded thanks to hits
+        uint32_t sharedMeshes = 0;          // Meshes in the content table
+        uint32_t meshes16BitIndices = 0;
+        uint32_t meshlets = 0;
+        size_t meshletPoolUsage = 0;
+        size_t meshletPoolSize = 0;
     };
 
     Statistics GetStatistics() const;
@@ -75,34 +187,94 @@ public:
         size_t uploadHeapSize = 16 * 1024 * 1024;    // 16MB
         size_t maxUploadsPerFrame = 16;
         uint32_t maintenanceFrameInterval = 60;      // Frames between maintenance
+        uint32_t autoLODCount = 0;                   // LODs generated for meshes without precomputed ones
+        MeshLODSettings lodSettings;                 // Reduction settings for generated LODs
+        bool enableDefrag = true;                    // Compact vertex/index buffers incrementally
+        size_t defragBudgetPerFrame = 1024 * 1024;   // Bytes copied per frame across both buffers
+        float defragThreshold = 0.3f;                // Fragmentation that starts compaction
+        uint32_t maxUploadBatchesInFlight = 2;       // Async only, copy batches awaiting their fence
+        bool drawInFlightUploads = true;             // Async only, draw uploading meshes behind a GPU wait
+        bool deduplicateMeshes = false;              // Share meshes with identical content (CreateMesh only)
+        VertexLayout vertexLayout;                   // Encoding of the shared vertex buffer
+        bool allow16BitIndices = true;               // 16-bit indices for meshes up to 65536 vertices
+        bool optimizeMeshes = false;                 // Reorder for vertex cache, overdraw and fetch (CreateMesh only)
+        MeshOptimizeSettings optimizeSettings;
+        bool buildMeshlets = false;                  // Cluster LOD 0 into meshlets with culling bounds (CreateMesh only)
+        MeshletBuildSettings meshletSettings;
+        MeshletPool::Config meshletPool;
     };
 
     void SetConfig(const Config& config);
     const Config& GetConfig() const { return m_config; }
+    const VertexLayout& GetVertexLayout() const { return m_config.vertexLayout; }
 
 private:
     // =============================================================================
     // Internal Types
     // =============================================================================
 
+    // Everything a draw or cull reads, kept packed in the slot map's hot array
+    struct MeshRenderData {
+        MeshState state = MeshState::PendingUpload;
+        uint32_t lodCount = 0;
+        uint64_t uploadFenceValue = 0;      // Copy-queue fence of an async upload, 0 once complete
+
+        // Render data per LOD (populated after upload). All LODs share the
+        // vertex range, their index lists follow LOD 0 in one allocation.
+        MeshView lodViews[MAX_MESH_LODS];
+
+        // Culling data, lives as long as the mesh
+        MeshBounds bounds;
+        MeshDecode decode;
+        uint32_t meshletOffset = 0;
+        uint32_t meshletCount = 0;
+    };
+
+    // Bookkeeping only touched by uploads, maintenance and defragmentation
     struct MeshEntry {
-        MeshHandle handle = INVALID_MESH_HANDLE;
         std::string name;
-        MeshState state = MeshState::PendingUpload;
         uint32_t uploadFrameIndex = 0;
+        uint64_t retireFenceValue = 0;      // GPU may read the mesh until this completes
+        uint32_t pendingRelocations = 0;    // Copies in flight, views switch when they retire
+        uint32_t stagingOffset = UINT32_MAX;    // Data already in the upload heap (BeginMeshWrite)
+        uint64_t contentHash = 0;           // Key in the shared mesh table, 0 when not shared
 
         // GPU buffer positions
         uint32_t vertexOffset = 0;
         uint32_t vertexCount = 0;
         uint32_t indexOffset = 0;
         uint32_t indexCount = 0;
+        IndexFormat indexFormat = IndexFormat::Uint32;
 
         // Temporary data (cleared after upload)
         std::vector<uint8_t> vertexData;
         std::vector<uint8_t> indexData;
 
-        // Render data (populated after upload)
-        MeshView view;
+        // Index count per LOD, consumed when the views are built
+        std::vector<uint32_t> lodIndexCounts;
+
+        // Software occlusion data, lives as long as the mesh
+        std::unique_ptr<OccluderGeometry> occluder;
+
+        // Meshlet pool ranges, CPU only so they go back without a fence
+        MeshletPool::Range meshlets;
+    };
+
+    using MeshRegistry = SlotMap<MeshRenderData, MeshEntry>;
+
+    // A mesh built on a loader thread, waiting to be drained into the registry
+    struct CreatedMesh {
+        MeshRenderData renderData;
+        MeshEntry entry;
+    };
+
+    // Copy of one buffer range to a new location, applied once fenceValue completes
+    struct PendingRelocation {
+        MeshHandle handle = INVALID_MESH_HANDLE;
+        bool isVertexData = false;
+        uint32_t srcOffset = 0;
+        uint32_t dstOffset = 0;
+        uint64_t fenceValue = 0;
     };
 
     // =============================================================================
@@ -110,13 +282,26 @@ private:
     // =============================================================================
 
     bool Initialize();
+    MeshHandle SubmitMesh(CookedMesh&& cooked, std::unique_ptr<OccluderGeometry> occluder,
+                          uint64_t contentHash, std::vector<uint8_t> content);
+    bool AllocateGeometry(size_t vertexDataSize, size_t indexDataSize, MeshAllocation& outAllocation);
+    void DrainCreatedMeshes();
     void ProcessUploadQueue();
-    bool ProcessSingleUpload(MeshHandle handle);
-    bool UploadData(const void* data, size_t dataSize, size_t destOffset,
-                   size_t uploadOffset, bool isVertexData);
+    void BuildMeshViews(MeshRenderData& mesh, MeshEntry& entry);
+    void RecordStagedCopies(MeshEntry& entry, uint64_t fenceValue);
     void PerformMaintenance();
     void FlushUploads();
 
+    // Async uploads
+    void ProcessAsyncUploads();
+    bool RecordAsyncUpload(MeshHandle handle, uint64_t fenceValue);
+
+    // Defragmentation
+    void CompleteRelocations(uint64_t completedFenceValue);
+    void RunDefragStep();
+    uint32_t PlanRelocations(bool isVertexData, uint32_t budgetBytes, std::vector<DefragMove>& outMoves);
+    void RecordRelocations(bool isVertexData, const std::vector<DefragMove>& moves, uint64_t stagingOffset);
+
     // =============================================================================
     // Member Variables
     // =============================================================================
@@ -129,20 +314,45 @@ private:
     std::unique_ptr<Buffer> m_vertexBuffer;
     std::unique_ptr<Buffer> m_indexBuffer;
     std::unique_ptr<Buffer> m_uploadHeap;
+    std::unique_ptr<Buffer> m_defragStaging;
+    size_t m_vertexStride = sizeof(VertexAttributes);   // From the config's vertex layout
 
-    // Memory allocators
-    std::unique_ptr<LinearAllocator> m_vertexAllocator;
-    std::unique_ptr<LinearAllocator> m_indexAllocator;
-    std::unique_ptr<LinearAllocator> m_uploadAllocator;
+    // Buffer and staging allocators, open writes and the hand-over of meshes
+    // created on other threads. The allocators are used under its mutex.
+    MeshCreationQueue<CreatedMesh> m_creation;
 
     // Mesh management
-    std::unordered_map<MeshHandle, MeshEntry> m_meshRegistry;
+    MeshRegistry m_meshRegistry;
     std::vector<MeshHandle> m_uploadQueue;
-    MeshHandle m_nextMeshId = 1;
+
+    // Deduplication, content hash to shared mesh. Any thread, own lock.
+    MeshContentTable m_sharedMeshes;
+
+    // Meshlets of every mesh, null unless buildMeshlets. Any thread, own lock.
+    std::unique_ptr<MeshletPool> m_meshletPool;
+
+    // Graphics-list copies and the buffer states they go through
+    UploadBatchRecorder m_uploadBatch;
+    std::vector<MeshHandle> m_frameUploads;
 
     // Frame management
     uint32_t m_frameIndex = 0;
     CommandList* m_currentUploadCmdList = nullptr;
+    uint64_t m_pendingFenceValue = 0;
+
+    // Async upload state, uploads run on their own fence timeline
+    std::unique_ptr<CopyUploadQueue> m_copyUploads;
+    AsyncUploadScheduler m_uploadScheduler;
+    std::vector<uint32_t> m_completedUploads;
+    uint64_t m_copyCompletedFenceValue = 0;
+
+    // Defragmentation state
+    std::vector<PendingRelocation> m_pendingRelocations;
+    std::vector<TLSFAllocator::Block> m_layoutScratch;
+    std::vector<DefragBlock> m_defragBlocks;
+    std::vector<DefragMove> m_vertexMoves;
+    std::vector<DefragMove> m_indexMoves;
+    size_t m_relocatedBytes = 0;
 
     // State tracking
     bool m_isInitialized = false;
@@ -1,11 +1,12 @@
 #include "GeometryManager.h"
+#include "IndexNarrowing.h"
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 GeometryManager::GeometryManager(D3D12MA::Allocator* allocator)
     : m_allocator(allocator)
     , m_frameIndex(0)
-    , m_nextMeshId(1)
 {
     if (!Initialize()) {
         throw std::runtime_error("Failed to initialize GeometryManager");
@@ -15,9 +16,11 @@ GeometryManager::GeometryManager(D3D12MA::Allocator* allocator)
 GeometryManager::~GeometryManager() {
     // Wait for any pending uploads to complete
     FlushUploads();
+    m_copyUploads.reset();
     m_vertexBuffer.reset();
     m_indexBuffer.reset();
     m_uploadHeap.reset();
+    m_defragStaging.reset();
 }
 
 bool GeometryManager::Initialize() {
@@ -26,9 +29,12 @@ bool GeometryManager::Initialize() {
         return false;
     }
 
+    // Every vertex in the shared buffer uses the configured layout
+    m_vertexStride = m_config.vertexLayout.GetStride();
+
     // Create large static vertex buffer
     m_vertexBuffer = std::make_unique<Buffer>();
-    if (!m_vertexBuffer->Initialize(m_allocator, m_config.vertexBufferSize, sizeof(VertexAttributes), false)) {
+    if (!m_vertexBuffer->Initialize(m_allocator, m_config.vertexBufferSize, m_vertexStride, false)) {
         printf("GeometryManager: Failed to create vertex buffer\n");
         return false;
     }
@@ -47,13 +53,53 @@ bool GeometryManager::Initialize() {
         return false;
     }
 
+    // GPU-side bounce buffer for relocations, a buffer cannot copy onto itself
+    // while in a single state
+    m_defragStaging.reset();
+    if (m_config.enableDefrag && m_config.defragBudgetPerFrame > 0) {
+        m_defragStaging = std::make_unique<Buffer>();
+        if (!m_defragStaging->Initialize(m_allocator, m_config.defragBudgetPerFrame, 1, false)) {
+            printf("GeometryManager: Failed to create defrag staging buffer, compaction disabled\n");
+            m_defragStaging.reset();
+        }
+    }
+
     // Initialize allocators
-    m_vertexAllocator = std::make_unique<LinearAllocator>(m_config.vertexBufferSize);
-    m_indexAllocator = std::make_unique<LinearAllocator>(m_config.indexBufferSize);
-    m_uploadAllocator = std::make_unique<LinearAllocator>(m_config.uploadHeapSize);
+    // Geometry ranges are aligned to their element size so offsets convert to
+    // base vertex / start index exactly, 4-byte index alignment covers both
+    // index widths
+    MeshCreationQueue<CreatedMesh>::Config creationConfig;
+    creationConfig.vertexBufferSize = m_config.vertexBufferSize;
+    creationConfig.vertexAlignment = m_vertexStride;
+    creationConfig.indexBufferSize = m_config.indexBufferSize;
+    creationConfig.indexAlignment = sizeof(uint32_t);
+    creationConfig.uploadHeapSize = m_config.uploadHeapSize;
+    m_creation.Initialize(creationConfig);
+
+    // Geometry buffers rest in COMMON between command lists: draws promote
+    // them to vertex/index reads implicitly and the copy queue can use them
+    m_uploadBatch.Clear();
+    m_uploadBatch.RegisterBuffer(m_vertexBuffer->GetResource(), D3D12_RESOURCE_STATE_COMMON);
+    m_uploadBatch.RegisterBuffer(m_indexBuffer->GetResource(), D3D12_RESOURCE_STATE_COMMON);
+    if (m_defragStaging) {
+        m_uploadBatch.RegisterBuffer(m_defragStaging->GetResource(), D3D12_RESOURCE_STATE_COMMON);
+    }
+
+    // Async batches split the upload ring between them
+    AsyncUploadScheduler::Config schedulerConfig;
+    schedulerConfig.maxBatchesInFlight = std::max(m_config.maxUploadBatchesInFlight, 1u);
+    schedulerConfig.maxUploadsPerBatch = static_cast<uint32_t>(m_config.maxUploadsPerFrame);
+    schedulerConfig.maxBytesPerBatch = m_config.uploadHeapSize / schedulerConfig.maxBatchesInFlight;
+    m_uploadScheduler.SetConfig(schedulerConfig);
+
+    // Meshlets are CPU data for now, the pool only exists when used
+    m_meshletPool.reset();
+    if (m_config.buildMeshlets) {
+        m_meshletPool = std::make_unique<MeshletPool>(m_config.meshletPool);
+    }
 
     // Reserve space for mesh registry
-    m_meshRegistry.reserve(1024);
+    m_meshRegistry.Reserve(1024);
 
     m_isInitialized = true;
     printf("GeometryManager: Initialized successfully\n");
@@ -62,7 +108,9 @@ bool GeometryManager::Initialize() {
 
 void GeometryManager::SetConfig(const Config& config) {
     // Only allow config changes before initialization or when empty
-    if (m_isInitialized && !m_meshRegistry.empty()) {
+    DrainCreatedMeshes();
+    const bool hasOpenWrites = m_creation.GetOpenWriteCount() > 0;
+    if (m_isInitialized && (!m_meshRegistry.Empty() || hasOpenWrites)) {
         printf("GeometryManager: Cannot change config while meshes are loaded\n");
         return;
     }
@@ -71,9 +119,9 @@ void GeometryManager::SetConfig(const Config& config) {
 
     if (m_isInitialized) {
         // Reinitialize with new config
-        m_meshRegistry.clear();
+        m_meshRegistry.Clear();
         m_uploadQueue.clear();
-        m_nextMeshId = 1;
+        m_sharedMeshes.Clear();
         m_isInitialized = false;
 
         if (!Initialize()) {
@@ -86,21 +134,99 @@ void GeometryManager::SetConfig(const Config& config) {
 // Public Interface
 // =============================================================================
 
-MeshHandle GeometryManager::CreateMesh(const CPUMesh& mesh) {
+MeshHandle GeometryManager::CreateMesh(const CPUMesh& sourceMesh) {
     if (!m_isInitialized) {
         printf("GeometryManager: Not initialized\n");
         return INVALID_MESH_HANDLE;
     }
 
     // Validate input
-    if (!mesh.vertices || !mesh.indices || mesh.vertexCount == 0 || mesh.indexCount == 0) {
+    if (!sourceMesh.vertices || !sourceMesh.indices || sourceMesh.vertexCount == 0 || sourceMesh.indexCount == 0) {
+        printf("GeometryManager: Invalid mesh description\n");
+        return INVALID_MESH_HANDLE;
+    }
+
+    // Identical geometry already registered: share it, skipping LOD
+    // generation, allocation and upload
+    uint64_t contentHash = 0;
+    if (m_config.deduplicateMeshes) {
+        const MeshHandle shared = m_sharedMeshes.Acquire(sourceMesh, contentHash);
+        if (shared != INVALID_MESH_HANDLE) {
+            return shared;
+        }
+    }
+
+    // Reorder, build LODs and meshlets, and encode into the buffer format.
+    // Duplicates hit the shared table above and skip this.
+    MeshCookSettings cookSettings;
+    cookSettings.vertexLayout = m_config.vertexLayout;
+    cookSettings.autoLODCount = m_config.autoLODCount;
+    cookSettings.lodSettings = m_config.lodSettings;
+    cookSettings.allow16BitIndices = m_config.allow16BitIndices;
+    cookSettings.optimize = m_config.optimizeMeshes;
+    cookSettings.optimizeSettings = m_config.optimizeSettings;
+    cookSettings.buildMeshlets = m_meshletPool != nullptr;
+    cookSettings.meshletSettings = m_config.meshletSettings;
+    CookedMesh cooked = CookMesh(sourceMesh, cookSettings);
+
+    // Retain positions and indices for software occlusion
+    std::unique_ptr<OccluderGeometry> occluder;
+    if (sourceMesh.isOccluder) {
+        occluder = std::make_unique<OccluderGeometry>();
+        occluder->positions.resize(sourceMesh.vertexCount * 3);
+        for (uint32_t i = 0; i < sourceMesh.vertexCount; ++i) {
+            memcpy(&occluder->positions[i * 3], sourceMesh.vertices[i].position, sizeof(float) * 3);
+        }
+        occluder->indices.assign(sourceMesh.indices, sourceMesh.indices + sourceMesh.indexCount);
+    }
+
+    std::vector<uint8_t> content;
+    if (contentHash != 0) {
+        content = MeshContentTable::Serialize(sourceMesh);
+    }
+    return SubmitMesh(std::move(cooked), std::move(occluder), contentHash, std::move(content));
+}
+
+MeshHandle GeometryManager::CreateMesh(const EncodedMesh& mesh) {
+    if (!m_isInitialized) {
+        printf("GeometryManager: Not initialized\n");
+        return INVALID_MESH_HANDLE;
+    }
+
+    if (!mesh.vertexData || !mesh.indexData || mesh.vertexCount == 0 || mesh.lodCount == 0 ||
+        mesh.lodCount > MAX_MESH_LODS || mesh.lodIndexCounts[0] == 0) {
+        printf("GeometryManager: Invalid encoded mesh\n");
+        return INVALID_MESH_HANDLE;
+    }
+    if (!(mesh.layout == m_config.vertexLayout)) {
+        printf("GeometryManager: Encoded mesh uses another vertex layout, recook it for this one\n");
+        return INVALID_MESH_HANDLE;
+    }
+
+    // Already in buffer format, one copy per blob
+    CookedMesh cooked = CopyEncodedMesh(mesh);
+    if (!m_meshletPool) {
+        cooked.meshlets = MeshletData();
+    }
+    return SubmitMesh(std::move(cooked), nullptr, 0, {});
+}
+
+MeshHandle GeometryManager::SubmitMesh(CookedMesh&& cooked, std::unique_ptr<OccluderGeometry> occluder,
+                                       uint64_t contentHash, std::vector<uint8_t> content) {
+    if (cooked.vertexData.empty() || cooked.lodIndexCounts.empty()) {
         printf("GeometryManager: Invalid mesh description\n");
         return INVALID_MESH_HANDLE;
     }
 
+    uint32_t totalIndexCount = 0;
+    for (uint32_t count : cooked.lodIndexCounts) {
+        totalIndexCount += count;
+    }
+    const uint32_t indexSize = GetIndexSize(cooked.indexFormat);
+
     // Calculate memory requirements
-    size_t vertexDataSize = mesh.vertexCount * sizeof(VertexAttributes);
-    size_t indexDataSize = mesh.indexCount * sizeof(uint32_t);
+    size_t vertexDataSize = cooked.vertexData.size();
+    size_t indexDataSize = cooked.indexData.size();
     size_t totalSize = vertexDataSize + indexDataSize;
 
     // Check if we have enough space
@@ -110,80 +236,298 @@ MeshHandle GeometryManager::CreateMesh(const CPUMesh& mesh) {
     }
 
     // Allocate space in GPU buffers
-    uint32_t vertexOffset = m_vertexAllocator->Allocate(vertexDataSize) / sizeof(VertexAttributes);
-    uint32_t indexOffset = m_indexAllocator->Allocate(indexDataSize) / sizeof(uint32_t);
-
-    if (vertexOffset == UINT32_MAX || indexOffset == UINT32_MAX) {
-        // printf("GeometryManager: Failed to allocate space for mesh '%s'\n",
-        //        mesh.desc.fpath ? mesh.desc.fpath : "unnamed");
+    MeshAllocation allocation;
+    if (!AllocateGeometry(vertexDataSize, indexDataSize, allocation)) {
         return INVALID_MESH_HANDLE;
     }
 
-    // Create mesh handle
-    MeshHandle handle = m_nextMeshId++;
+    // Reserve the handle, the registry slot is filled in on the main thread
+    MeshHandle handle = m_meshRegistry.AllocateHandle();
+    if (handle == INVALID_MESH_HANDLE) {
+        printf("GeometryManager: Mesh registry full\n");
+        m_creation.Free(allocation);
+        return INVALID_MESH_HANDLE;
+    }
 
     // Create mesh entry
+    MeshRenderData renderData;
+    renderData.state = MeshState::PendingUpload;
+    renderData.lodCount = static_cast<uint32_t>(cooked.lodIndexCounts.size());
+    renderData.bounds = cooked.bounds;
+    renderData.decode = MakeMeshDecode(m_config.vertexLayout, cooked.bounds);
+
     MeshEntry entry;
-    entry.handle = handle;
     // entry.name = desc.name ? std::string(desc.name) : "unnamed";
-    entry.vertexOffset = vertexOffset;
-    entry.vertexCount = mesh.vertexCount;
-    entry.indexOffset = indexOffset;
-    entry.indexCount = mesh.indexCount;
-    entry.state = MeshState::PendingUpload;
-    entry.uploadFrameIndex = m_frameIndex;
+    entry.name = std::move(cooked.name);
+    entry.vertexOffset = allocation.vertexOffset / static_cast<uint32_t>(m_vertexStride);
+    entry.vertexCount = cooked.vertexCount;
+    entry.indexOffset = allocation.indexOffset / indexSize;
+    entry.indexCount = totalIndexCount;
+    entry.indexFormat = cooked.indexFormat;
+    entry.lodIndexCounts = std::move(cooked.lodIndexCounts);
+    entry.occluder = std::move(occluder);
+    entry.vertexData = std::move(cooked.vertexData);
+    entry.indexData = std::move(cooked.indexData);
+
+    // Meshlet vertex indices stay relative to the vertex range so
+    // relocations don't touch them
+    if (m_meshletPool && !cooked.meshlets.meshlets.empty()) {
+        entry.meshlets = m_meshletPool->Add(cooked.meshlets);
+        if (entry.meshlets.IsValid()) {
+            renderData.meshletOffset = entry.meshlets.meshletOffset;
+            renderData.meshletCount = entry.meshlets.meshletCount;
+        } else {
+            printf("GeometryManager: Meshlet pool full, mesh created without meshlets\n");
+        }
+    }
 
-    // Copy vertex data
-    entry.vertexData.resize(vertexDataSize);
-    memcpy(entry.vertexData.data(), mesh.vertices, vertexDataSize);
+    printf("GeometryManager: Created mesh '%s' (Handle: %u, Vertices: %u, Indices: %u, LODs: %u)\n",
+           entry.name.c_str(), handle, entry.vertexCount, entry.lodIndexCounts[0], renderData.lodCount);
 
-    // Copy index data
-    entry.indexData.resize(indexDataSize);
-    memcpy(entry.indexData.data(), mesh.indices, indexDataSize);
+    // Hand over to the main thread, which registers and uploads it
+    if (contentHash == 0) {
+        m_creation.Submit(handle, CreatedMesh{ renderData, std::move(entry) });
+        return handle;
+    }
 
-    // Add to registry
-    m_meshRegistry[handle] = std::move(entry);
+    // Publish for later duplicates. Submitted under the same lock, so a
+    // handle returned by a hit is always queued or drained.
+    // Another thread may have published the same content meanwhile, this
+    // copy then stays private.
+    m_sharedMeshes.Publish(contentHash, handle, std::move(content), static_cast<uint32_t>(totalSize),
+                           [&](bool published) {
+        if (published) {
+            entry.contentHash = contentHash;
+        }
+        m_creation.Submit(handle, CreatedMesh{ renderData, std::move(entry) });
+    });
+    return handle;
+}
 
-    // Queue for upload
-    m_uploadQueue.push_back(handle);
+MeshWriteSpan GeometryManager::BeginMeshWrite(uint32_t vertexCount, uint32_t indexCount) {
+    if (!m_isInitialized) {
+        printf("GeometryManager: Not initialized\n");
+        return {};
+    }
 
-    printf("GeometryManager: Created mesh '%s' (Handle: %u, Vertices: %u, Indices: %u)\n",
-           entry.name.c_str(), handle, mesh.vertexCount, mesh.indexCount);
+    if (vertexCount == 0 || indexCount == 0) {
+        printf("GeometryManager: Invalid mesh write size\n");
+        return {};
+    }
 
-    return handle;
+    const IndexFormat indexFormat = m_config.allow16BitIndices ? SelectIndexFormat(vertexCount) : IndexFormat::Uint32;
+    const uint32_t indexSize = GetIndexSize(indexFormat);
+    size_t vertexDataSize = static_cast<size_t>(vertexCount) * m_vertexStride;
+    size_t indexDataSize = AlignIndexDataSize(static_cast<size_t>(indexCount) * indexSize);
+    if (vertexDataSize + indexDataSize > m_config.uploadHeapSize) {
+        printf("GeometryManager: Mesh too large for upload heap (%zu bytes)\n", vertexDataSize + indexDataSize);
+        return {};
+    }
+
+    MeshHandle handle = m_meshRegistry.AllocateHandle();
+    if (handle == INVALID_MESH_HANDLE) {
+        printf("GeometryManager: Mesh registry full\n");
+        return {};
+    }
+
+    // Staging is held until the copy is recorded and assigned its fence. The
+    // mesh is kept aside until CommitMesh, the registry never sees unwritten
+    // meshes.
+    MeshAllocation allocation;
+    const bool reserved = m_creation.BeginWrite(handle, vertexDataSize, indexDataSize,
+        [&](const MeshAllocation& reservedRanges) {
+            CreatedMesh created;
+            MeshEntry& entry = created.entry;
+            entry.vertexOffset = reservedRanges.vertexOffset / static_cast<uint32_t>(m_vertexStride);
+            entry.vertexCount = vertexCount;
+            entry.indexOffset = reservedRanges.indexOffset / indexSize;
+            entry.indexCount = indexCount;
+            entry.indexFormat = indexFormat;
+            entry.lodIndexCounts = { indexCount };
+            entry.stagingOffset = reservedRanges.stagingOffset;
+            return created;
+        },
+        allocation);
+    if (!reserved) {
+        m_meshRegistry.FreeHandle(handle);
+        return {};
+    }
+
+    // Vertices first, indices right after them
+    uint8_t* staging = static_cast<uint8_t*>(m_uploadHeap->GetMappedData()) + allocation.stagingOffset;
+
+    MeshWriteSpan span;
+    span.handle = handle;
+    span.vertices = staging;
+    span.indices = staging + vertexDataSize;
+    span.indexFormat = indexFormat;
+    span.vertexCount = vertexCount;
+    span.vertexStride = static_cast<uint32_t>(m_vertexStride);
+    span.indexCount = indexCount;
+    return span;
+}
+
+bool GeometryManager::CommitMesh(const MeshWriteSpan& span, const MeshBounds& bounds) {
+    const bool committed = m_creation.Commit(span.handle, [&](CreatedMesh& created) {
+        created.renderData.state = MeshState::PendingUpload;
+        created.renderData.lodCount = 1;
+        created.renderData.bounds = bounds;
+        created.renderData.decode = MakeMeshDecode(m_config.vertexLayout, bounds);
+    });
+    if (!committed) {
+        printf("GeometryManager: CommitMesh on a mesh that is not being written (Handle: %u)\n", span.handle);
+        return false;
+    }
+
+    printf("GeometryManager: Committed mesh (Handle: %u, Vertices: %u, Indices: %u)\n",
+           span.handle, span.vertexCount, span.indexCount);
+    return true;
+}
+
+void GeometryManager::CancelMeshWrite(const MeshWriteSpan& span) {
+    // Nothing was recorded against any of it, all three ranges go back right away
+    if (m_creation.CancelWrite(span.handle)) {
+        m_meshRegistry.FreeHandle(span.handle);
+    }
 }
 
 void GeometryManager::DestroyMesh(MeshHandle handle) {
-    auto it = m_meshRegistry.find(handle);
-    if (it != m_meshRegistry.end()) {
-        MeshEntry& entry = it->second;
+    MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    if (!renderData) {
+        // Still open, or created on another thread and not drained yet. A
+        // queued mesh is destroyed as DrainCreatedMeshes registers it.
+        if (m_creation.Destroy(handle) == MeshCreationQueue<CreatedMesh>::DestroyResult::Cancelled) {
+            m_meshRegistry.FreeHandle(handle);
+        }
+        return;
+    }
+
+    MeshEntry& entry = *m_meshRegistry.GetCold(handle);
 
-        // Mark for deletion (actual cleanup happens during maintenance)
-        entry.state = MeshState::PendingDeletion;
+    // Shared meshes only go with their last reference
+    if (entry.contentHash != 0) {
+        if (!m_sharedMeshes.Release(entry.contentHash, handle)) {
+            return;
+        }
+        entry.contentHash = 0;
+    }
 
-        printf("GeometryManager: Marked mesh '%s' for deletion\n", entry.name.c_str());
+    // Staging that never got a copy recorded can be reused right away
+    if (entry.stagingOffset != UINT32_MAX && renderData->state == MeshState::PendingUpload) {
+        std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+        m_creation.GetUploadAllocator().SetFence(entry.stagingOffset, 0);
+        entry.stagingOffset = UINT32_MAX;
     }
+
+    // Mark for deletion (actual cleanup happens during maintenance).
+    // Draws recorded up to now may still reference the mesh.
+    renderData->state = MeshState::PendingDeletion;
+    entry.retireFenceValue = m_pendingFenceValue;
+    m_uploadScheduler.Cancel(handle);
+
+    printf("GeometryManager: Marked mesh '%s' for deletion\n", entry.name.c_str());
 }
 
 bool GeometryManager::IsMeshReady(MeshHandle handle) const {
-    auto it = m_meshRegistry.find(handle);
-    return it != m_meshRegistry.end() && it->second.state == MeshState::Ready;
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    return renderData && renderData->state == MeshState::Ready;
 }
 
 const MeshView* GeometryManager::GetMeshRenderData(MeshHandle handle) const {
-    auto it = m_meshRegistry.find(handle);
-    if (it != m_meshRegistry.end() && it->second.state == MeshState::Ready) {
-        return &it->second.view;
+    return GetMeshRenderData(handle, 0);
+}
+
+const MeshView* GeometryManager::GetMeshRenderData(MeshHandle handle, uint32_t lod) const {
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    if (!renderData) {
+        return nullptr;
+    }
+
+    const MeshState state = renderData->state;
+    if (state == MeshState::Ready || (state == MeshState::Uploading && m_config.drawInFlightUploads)) {
+        return &renderData->lodViews[std::min(lod, renderData->lodCount - 1)];
     }
     return nullptr;
 }
 
-void GeometryManager::BeginFrame(uint32_t frameIndex, CommandList* uploadCmdList) {
+uint64_t GeometryManager::GetMeshUploadFence(MeshHandle handle) const {
+    if (!m_config.drawInFlightUploads) {
+        return 0;   // Uploading meshes are not drawn at all
+    }
+
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    if (renderData && renderData->state == MeshState::Uploading) {
+        return renderData->uploadFenceValue;
+    }
+    return 0;
+}
+
+uint32_t GeometryManager::GetMeshLODCount(MeshHandle handle) const {
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    return renderData ? renderData->lodCount : 0;
+}
+
+const MeshBounds* GeometryManager::GetMeshBounds(MeshHandle handle) const {
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    return renderData ? &renderData->bounds : nullptr;
+}
+
+const MeshDecode* GeometryManager::GetMeshDecode(MeshHandle handle) const {
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    return renderData ? &renderData->decode : nullptr;
+}
+
+MeshletView GeometryManager::GetMeshlets(MeshHandle handle) const {
+    MeshletView view;
+    const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    if (renderData && renderData->meshletCount > 0 && m_meshletPool) {
+        view.meshlets = m_meshletPool->GetMeshlets() + renderData->meshletOffset;
+        view.bounds = m_meshletPool->GetBounds() + renderData->meshletOffset;
+        view.meshletCount = renderData->meshletCount;
+    }
+    return view;
+}
+
+const OccluderGeometry* GeometryManager::GetOccluderGeometry(MeshHandle handle) const {
+    const MeshEntry* entry = m_meshRegistry.GetCold(handle);
+    return entry ? entry->occluder.get() : nullptr;
+}
+
+void GeometryManager::BeginFrame(uint32_t frameIndex, CommandList* uploadCmdList,
+                                 uint64_t completedFenceValue, uint64_t pendingFenceValue) {
     m_frameIndex = frameIndex;
     m_currentUploadCmdList = uploadCmdList;
+    m_pendingFenceValue = pendingFenceValue;
+
+    // Register meshes created since last frame, then keep loader threads out
+    // of the allocators while this frame's work is recorded
+    DrainCreatedMeshes();
+    std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+
+    // Return buffer ranges and staging space the GPU is done with. Staging
+    // space is tagged with copy-queue fences once uploads are async.
+    m_copyCompletedFenceValue = m_copyUploads ? m_copyUploads->GetCompletedFenceValue() : 0;
+    m_creation.GetVertexAllocator().ReclaimCompleted(completedFenceValue);
+    m_creation.GetIndexAllocator().ReclaimCompleted(completedFenceValue);
+    m_creation.GetUploadAllocator().ReclaimCompleted(m_copyUploads ? m_copyCompletedFenceValue : completedFenceValue);
+
+    // Switch relocated meshes over, then start the next batch of moves ahead
+    // of this frame's uploads
+    CompleteRelocations(completedFenceValue);
+    RunDefragStep();
 
     // Process upload queue automatically
-    ProcessUploadQueue();
+    if (m_copyUploads) {
+        ProcessAsyncUploads();
+    } else {
+        ProcessUploadQueue();
+    }
+
+    // Relocations and uploads share the transitions above, the buffers go
+    // back to rest once at the end
+    if (m_currentUploadCmdList) {
+        m_uploadBatch.RestoreRestingStates(m_currentUploadCmdList->GetCommandList());
+    }
 
     // Perform maintenance periodically
     if (frameIndex % m_config.maintenanceFrameInterval == 0) {
@@ -202,170 +546,493 @@ void GeometryManager::BindVertexIndexBuffers(CommandList* cmdList) {
     D3D12_VERTEX_BUFFER_VIEW vertexView = m_vertexBuffer->GetVertexView();
     d3dCmdList->IASetVertexBuffers(0, 1, &vertexView);
 
-    // Bind index buffer
+    // Bind index buffer, 32-bit until a draw of 16-bit meshes rebinds it
     D3D12_INDEX_BUFFER_VIEW indexView = m_indexBuffer->GetIndexView(true);
     d3dCmdList->IASetIndexBuffer(&indexView);
 }
 
+void GeometryManager::BindIndexBuffer(CommandList* cmdList, IndexFormat format) {
+    if (!cmdList || !m_isInitialized) {
+        return;
+    }
+
+    D3D12_INDEX_BUFFER_VIEW indexView = m_indexBuffer->GetIndexView(format == IndexFormat::Uint32);
+    cmdList->GetCommandList()->IASetIndexBuffer(&indexView);
+}
+
+IndexBufferBinding GeometryManager::GetIndexBufferBinding(IndexFormat format) const {
+    IndexBufferBinding binding;
+    if (m_isInitialized) {
+        D3D12_INDEX_BUFFER_VIEW indexView = m_indexBuffer->GetIndexView(format == IndexFormat::Uint32);
+        binding.gpuAddress = indexView.BufferLocation;
+        binding.sizeInBytes = indexView.SizeInBytes;
+        binding.format = format;
+    }
+    return binding;
+}
+
 // =============================================================================
 // Internal Implementation
 // =============================================================================
 
+bool GeometryManager::AllocateGeometry(size_t vertexDataSize, size_t indexDataSize, MeshAllocation& outAllocation) {
+    if (!m_creation.Allocate(vertexDataSize, indexDataSize, outAllocation)) {
+        printf("GeometryManager: Out of geometry buffer space (%zu vertex bytes, %zu index bytes)\n",
+               vertexDataSize, indexDataSize);
+        return false;
+    }
+    return true;
+}
+
+void GeometryManager::DrainCreatedMeshes() {
+    m_creation.Drain([this](MeshHandle handle, CreatedMesh&& created, uint32_t destroyCount) {
+        created.entry.uploadFrameIndex = m_frameIndex;
+        m_meshRegistry.Emplace(handle, created.renderData, std::move(created.entry));
+        m_uploadQueue.push_back(handle);
+
+        // Destroyed before it got here, once per reference
+        for (uint32_t i = 0; i < destroyCount; ++i) {
+            DestroyMesh(handle);
+        }
+    });
+}
+
 void GeometryManager::ProcessUploadQueue() {
     if (m_uploadQueue.empty() || !m_currentUploadCmdList) {
         return;
     }
 
-    // Process uploads in batches to avoid overwhelming the upload heap
-    size_t processed = 0;
+    // Take meshes in queue order while their data fits one staging block
+    m_frameUploads.clear();
+    size_t vertexBytes = 0;
+    size_t indexBytes = 0;
 
     auto it = m_uploadQueue.begin();
-    while (it != m_uploadQueue.end() && processed < m_config.maxUploadsPerFrame) {
-        MeshHandle handle = *it;
+    while (it != m_uploadQueue.end() && m_frameUploads.size() < m_config.maxUploadsPerFrame) {
+        const MeshRenderData* renderData = m_meshRegistry.GetHot(*it);
+        if (!renderData || renderData->state != MeshState::PendingUpload) {
+            it = m_uploadQueue.erase(it); // Destroyed or already processed
+            continue;
+        }
 
-        if (ProcessSingleUpload(handle)) {
-            it = m_uploadQueue.erase(it);
-            processed++;
-        } else {
-            ++it;
+        // Meshes written in place already have their staging
+        const MeshEntry& entry = *m_meshRegistry.GetCold(*it);
+        size_t frameBytes = vertexBytes + indexBytes + entry.vertexData.size() + entry.indexData.size();
+        if (frameBytes > 0 && !m_creation.GetUploadAllocator().CanAllocate(frameBytes)) {
+            break; // Not enough space right now, try next frame
         }
+
+        vertexBytes += entry.vertexData.size();
+        indexBytes += entry.indexData.size();
+        m_frameUploads.push_back(*it);
+        it = m_uploadQueue.erase(it);
     }
 
-    if (processed > 0) {
-        printf("GeometryManager: Processed %zu mesh uploads this frame\n", processed);
+    if (m_frameUploads.empty()) {
+        return;
+    }
+
+    // Allocate space in upload heap, held until this frame's copies retire
+    uint32_t uploadOffset = 0;
+    if (vertexBytes + indexBytes > 0) {
+        uploadOffset = m_creation.GetUploadAllocator().Allocate(vertexBytes + indexBytes, m_pendingFenceValue);
+    }
+    if (uploadOffset == UINT32_MAX) {
+        m_uploadQueue.insert(m_uploadQueue.begin(), m_frameUploads.begin(), m_frameUploads.end());
+        return;
+    }
+
+    // All vertex data first, then all index data: meshes that are neighbours
+    // in the geometry buffers are neighbours in staging too and their copies
+    // merge into one
+    size_t vertexCursor = uploadOffset;
+    size_t indexCursor = uploadOffset + vertexBytes;
+    for (MeshHandle handle : m_frameUploads) {
+        MeshRenderData& renderData = *m_meshRegistry.GetHot(handle);
+        MeshEntry& entry = *m_meshRegistry.GetCold(handle);
+
+        if (entry.stagingOffset != UINT32_MAX) {
+            RecordStagedCopies(entry, m_pendingFenceValue);
+        } else {
+            const size_t vertexDataSize = entry.vertexData.size();
+            const size_t indexDataSize = entry.indexData.size();
+
+            m_uploadHeap->Update(entry.vertexData.data(), vertexDataSize, vertexCursor);
+            m_uploadHeap->Update(entry.indexData.data(), indexDataSize, indexCursor);
+
+            m_uploadBatch.AddCopy(m_vertexBuffer->GetResource(), entry.vertexOffset * m_vertexStride,
+                                  m_uploadHeap->GetResource(), vertexCursor, vertexDataSize);
+            m_uploadBatch.AddCopy(m_indexBuffer->GetResource(), entry.indexOffset * GetIndexSize(entry.indexFormat),
+                                  m_uploadHeap->GetResource(), indexCursor, indexDataSize);
+            vertexCursor += vertexDataSize;
+            indexCursor += indexDataSize;
+        }
+
+        // Update mesh state, the copies precede every draw on this list
+        renderData.state = MeshState::Ready;
+        BuildMeshViews(renderData, entry);
     }
+
+    m_uploadBatch.Flush(m_currentUploadCmdList->GetCommandList());
+
+    printf("GeometryManager: Processed %zu mesh uploads this frame\n", m_frameUploads.size());
 }
 
-bool GeometryManager::ProcessSingleUpload(MeshHandle handle) {
-    auto it = m_meshRegistry.find(handle);
-    if (it == m_meshRegistry.end()) {
-        return true; // Remove from queue if mesh no longer exists
+void GeometryManager::RecordStagedCopies(MeshEntry& entry, uint64_t fenceValue) {
+    const size_t vertexDataSize = entry.vertexCount * m_vertexStride;
+    const size_t indexDataSize = AlignIndexDataSize(entry.indexCount * GetIndexSize(entry.indexFormat));
+    const uint64_t vertexSrc = entry.stagingOffset;
+    const uint64_t indexSrc = entry.stagingOffset + vertexDataSize;
+
+    if (m_copyUploads) {
+        ID3D12GraphicsCommandList* cmdList = m_copyUploads->GetCommandList()->GetCommandList();
+        cmdList->CopyBufferRegion(m_vertexBuffer->GetResource(), entry.vertexOffset * m_vertexStride,
+                                  m_uploadHeap->GetResource(), vertexSrc, vertexDataSize);
+        cmdList->CopyBufferRegion(m_indexBuffer->GetResource(), entry.indexOffset * GetIndexSize(entry.indexFormat),
+                                  m_uploadHeap->GetResource(), indexSrc, indexDataSize);
+    } else {
+        m_uploadBatch.AddCopy(m_vertexBuffer->GetResource(), entry.vertexOffset * m_vertexStride,
+                              m_uploadHeap->GetResource(), vertexSrc, vertexDataSize);
+        m_uploadBatch.AddCopy(m_indexBuffer->GetResource(), entry.indexOffset * GetIndexSize(entry.indexFormat),
+                              m_uploadHeap->GetResource(), indexSrc, indexDataSize);
     }
 
-    MeshEntry& entry = it->second;
-    if (entry.state != MeshState::PendingUpload) {
-        return true; // Already processed or in wrong state
+    // The staging block now retires with the submission that reads it
+    m_creation.GetUploadAllocator().SetFence(entry.stagingOffset, fenceValue);
+    entry.stagingOffset = UINT32_MAX;
+}
+
+void GeometryManager::BuildMeshViews(MeshRenderData& mesh, MeshEntry& entry) {
+    // Setup render data, one view per LOD over the shared vertex range
+    uint32_t lodIndexOffset = entry.indexOffset;
+    for (uint32_t lod = 0; lod < mesh.lodCount; ++lod) {
+        MeshView& view = mesh.lodViews[lod];
+        view.vertexOffset = entry.vertexOffset;
+        view.vertexCount = entry.vertexCount;
+        view.indexOffset = lodIndexOffset;
+        view.indexCount = entry.lodIndexCounts[lod];
+        view.indexFormat = entry.indexFormat;
+        lodIndexOffset += entry.lodIndexCounts[lod];
     }
 
-    // Calculate data sizes
-    size_t vertexDataSize = entry.vertexData.size();
-    size_t indexDataSize = entry.indexData.size();
-    size_t totalSize = vertexDataSize + indexDataSize;
+    // Clear temporary data to save memory
+    entry.vertexData.clear();
+    entry.vertexData.shrink_to_fit();
+    entry.indexData.clear();
+    entry.indexData.shrink_to_fit();
+}
 
-    // Check if we have enough space in upload heap
-    if (!m_uploadAllocator->CanAllocate(totalSize)) {
-        // Not enough space right now, try next frame
+// =============================================================================
+// Async Uploads
+// =============================================================================
+
+bool GeometryManager::EnableAsyncUploads(ID3D12Device* device, CommandQueue* copyQueue) {
+    if (!m_isInitialized) {
+        printf("GeometryManager: Not initialized\n");
         return false;
     }
+    if (m_copyUploads) {
+        return true;
+    }
 
-    // Allocate space in upload heap
-    uint32_t uploadOffset = m_uploadAllocator->Allocate(totalSize);
-    if (uploadOffset == UINT32_MAX) {
+    // Staging space handed out so far is tagged with graphics fences, which
+    // the copy timeline cannot retire
+    std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+    if (m_creation.GetUploadAllocator().GetUsedSpace() > 0) {
+        printf("GeometryManager: Async uploads must be enabled before the first upload\n");
         return false;
     }
 
-    // Upload vertex data
-    if (!UploadData(entry.vertexData.data(), vertexDataSize,
-                   entry.vertexOffset * sizeof(VertexAttributes),
-                   uploadOffset, true)) {
-        printf("GeometryManager: Failed to upload vertex data for mesh '%s'\n", entry.name.c_str());
+    auto copyUploads = std::make_unique<CopyUploadQueue>();
+    if (!copyUploads->Initialize(device, copyQueue, m_uploadScheduler.GetConfig().maxBatchesInFlight)) {
+        printf("GeometryManager: Failed to create copy queue uploads, staying on the graphics queue\n");
         return false;
     }
 
-    // Upload index data
-    if (!UploadData(entry.indexData.data(), indexDataSize,
-                   entry.indexOffset * sizeof(uint32_t),
-                   uploadOffset + vertexDataSize, false)) {
-        printf("GeometryManager: Failed to upload index data for mesh '%s'\n", entry.name.c_str());
-        return false;
+    m_copyUploads = std::move(copyUploads);
+    printf("GeometryManager: Mesh uploads moved to the copy queue\n");
+    return true;
+}
+
+void GeometryManager::ProcessAsyncUploads() {
+    // Meshes whose copies completed become Ready and stop requiring a GPU wait
+    m_completedUploads.clear();
+    m_uploadScheduler.Retire(m_copyCompletedFenceValue, m_completedUploads);
+    for (uint32_t handle : m_completedUploads) {
+        MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+        if (renderData && renderData->state == MeshState::Uploading) {
+            renderData->state = MeshState::Ready;
+            renderData->uploadFenceValue = 0;
+        }
     }
 
-    // Update mesh state
-    entry.state = MeshState::Ready;
+    // New meshes join the scheduler in creation order
+    for (MeshHandle handle : m_uploadQueue) {
+        const MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+        if (renderData && renderData->state == MeshState::PendingUpload) {
+            const MeshEntry& entry = *m_meshRegistry.GetCold(handle);
+            m_uploadScheduler.Enqueue(handle, entry.vertexCount * m_vertexStride +
+                                              AlignIndexDataSize(entry.indexCount * GetIndexSize(entry.indexFormat)));
+        }
+    }
+    m_uploadQueue.clear();
 
-    // Setup render data
-    entry.view.vertexOffset = entry.vertexOffset;
-    entry.view.vertexCount = entry.vertexCount;
-    entry.view.indexOffset = entry.indexOffset;
-    entry.view.indexCount = entry.indexCount;
+    // Relocations hold the buffers in copy states until their frame retires,
+    // see RunDefragStep
+    if (!m_pendingRelocations.empty()) {
+        return;
+    }
 
-    // Clear temporary data to save memory
-    entry.vertexData.clear();
-    entry.vertexData.shrink_to_fit();
-    entry.indexData.clear();
-    entry.indexData.shrink_to_fit();
+    // One batch per frame, it never touches the frame's command list
+    const uint32_t submitted = m_uploadScheduler.Submit(*m_copyUploads,
+        [this](uint32_t handle, uint64_t fenceValue) {
+            return RecordAsyncUpload(handle, fenceValue);
+        });
 
-    printf("GeometryManager: Uploaded mesh '%s' to GPU\n", entry.name.c_str());
-    return true;
+    if (submitted > 0) {
+        printf("GeometryManager: Submitted %u mesh uploads on the copy queue\n", submitted);
+    }
 }
 
-bool GeometryManager::UploadData(const void* data, size_t dataSize, size_t destOffset,
-                                size_t uploadOffset, bool isVertexData) {
-    if (!m_uploadHeap->Update(data, static_cast<UINT64>(dataSize), static_cast<UINT64>(uploadOffset))) {
-        printf("GeometryManager: Failed to update upload heap\n");
-        return false;
+bool GeometryManager::RecordAsyncUpload(MeshHandle handle, uint64_t fenceValue) {
+    MeshRenderData* renderData = m_meshRegistry.GetHot(handle);
+    if (!renderData || renderData->state != MeshState::PendingUpload) {
+        return true; // Nothing left to copy
     }
 
-    ID3D12GraphicsCommandList* cmdList = m_currentUploadCmdList->GetCommandList();
+    // Both buffers rest in COMMON between uses, so the copy queue promotes
+    // them to COPY_DEST implicitly. Buffers allow one queue to write a range
+    // while others read different ranges.
+    MeshEntry& entry = *m_meshRegistry.GetCold(handle);
+    if (entry.stagingOffset == UINT32_MAX) {
+        size_t vertexDataSize = entry.vertexData.size();
+        size_t indexDataSize = entry.indexData.size();
+
+        // Staging space stays reserved until the copy batch retires
+        uint32_t uploadOffset = m_creation.GetUploadAllocator().Allocate(vertexDataSize + indexDataSize, fenceValue);
+        if (uploadOffset == UINT32_MAX) {
+            return false;
+        }
+
+        if (!m_uploadHeap->Update(entry.vertexData.data(), vertexDataSize, uploadOffset) ||
+            !m_uploadHeap->Update(entry.indexData.data(), indexDataSize, uploadOffset + vertexDataSize)) {
+            printf("GeometryManager: Failed to update upload heap for mesh '%s'\n", entry.name.c_str());
+            return false;
+        }
 
-    Buffer* targetBuffer = isVertexData ? m_vertexBuffer.get() : m_indexBuffer.get();
-    D3D12_RESOURCE_STATES targetState = isVertexData ?
-        D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER :
-        D3D12_RESOURCE_STATE_INDEX_BUFFER;
-
-    // Transition to copy destination
-    D3D12_RESOURCE_BARRIER barrier = {};
-    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-    barrier.Transition.pResource = targetBuffer->GetResource();
-    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
-    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
-    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    cmdList->ResourceBarrier(1, &barrier);
-
-    cmdList->CopyBufferRegion(
-        targetBuffer->GetResource(),
-        destOffset,
-        m_uploadHeap->GetResource(),
-        uploadOffset,
-        dataSize
-    );
-
-    // Transition to final state
-    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    barrier.Transition.StateAfter = targetState;
-    cmdList->ResourceBarrier(1, &barrier);
+        ID3D12GraphicsCommandList* cmdList = m_copyUploads->GetCommandList()->GetCommandList();
+        cmdList->CopyBufferRegion(m_vertexBuffer->GetResource(), entry.vertexOffset * m_vertexStride,
+                                  m_uploadHeap->GetResource(), uploadOffset, vertexDataSize);
+        cmdList->CopyBufferRegion(m_indexBuffer->GetResource(), entry.indexOffset * GetIndexSize(entry.indexFormat),
+                                  m_uploadHeap->GetResource(), uploadOffset + vertexDataSize, indexDataSize);
+    } else {
+        RecordStagedCopies(entry, fenceValue);
+    }
 
+    renderData->state = MeshState::Uploading;
+    renderData->uploadFenceValue = fenceValue;
+    BuildMeshViews(*renderData, entry);
     return true;
 }
 
+// =============================================================================
+// Maintenance
+// =============================================================================
+
 void GeometryManager::PerformMaintenance() {
-    // Clean up deleted meshes
-    auto it = m_meshRegistry.begin();
-    while (it != m_meshRegistry.end()) {
-        if (it->second.state == MeshState::PendingDeletion) {
-            printf("GeometryManager: Cleaning up mesh '%s'\n", it->second.name.c_str());
-
-            // TODO: In a real implementation, you'd want to:
-            // 1. Add freed space back to allocators (requires more sophisticated allocator)
-            // 2. Defragment buffers periodically
-            // 3. Handle reference counting for in-flight renders
-
-            it = m_meshRegistry.erase(it);
+    // Clean up deleted meshes, their slots hand out new handle generations
+    m_meshRegistry.ForEach([this](MeshHandle handle, const MeshRenderData& renderData, const MeshEntry& entry) {
+        // A copy still writing the ranges keeps them allocated a little longer
+        if (renderData.state != MeshState::PendingDeletion ||
+            renderData.uploadFenceValue > m_copyCompletedFenceValue) {
+            return;
+        }
+        printf("GeometryManager: Cleaning up mesh '%s'\n", entry.name.c_str());
+
+        // Ranges are reused once the GPU has passed the mesh's last frame
+        m_creation.GetVertexAllocator().FreeDeferred(entry.vertexOffset * m_vertexStride, entry.retireFenceValue);
+        m_creation.GetIndexAllocator().FreeDeferred(entry.indexOffset * GetIndexSize(entry.indexFormat), entry.retireFenceValue);
+        if (m_meshletPool) {
+            m_meshletPool->Remove(entry.meshlets);
+        }
+
+        m_meshRegistry.Remove(handle);
+    });
+
+    // printf("GeometryManager: Performed maintenance at frame %u\n", m_frameIndex);
+}
+
+// =============================================================================
+// Defragmentation
+// =============================================================================
+
+void GeometryManager::CompleteRelocations(uint64_t completedFenceValue) {
+    size_t completed = 0;
+    for (; completed < m_pendingRelocations.size(); ++completed) {
+        const PendingRelocation& relocation = m_pendingRelocations[completed];
+        if (relocation.fenceValue > completedFenceValue) {
+            break;
+        }
+
+        TLSFAllocator* allocator = relocation.isVertexData ? &m_creation.GetVertexAllocator() : &m_creation.GetIndexAllocator();
+
+        // Mesh destroyed mid-move: maintenance already released the old range
+        // and the stale handle no longer resolves
+        MeshRenderData* renderData = m_meshRegistry.GetHot(relocation.handle);
+        if (!renderData) {
+            allocator->FreeDeferred(relocation.dstOffset, m_pendingFenceValue);
+            continue;
+        }
+
+        MeshEntry& entry = *m_meshRegistry.GetCold(relocation.handle);
+        entry.pendingRelocations--;
+
+        if (relocation.isVertexData) {
+            entry.vertexOffset = relocation.dstOffset / m_vertexStride;
+            for (uint32_t lod = 0; lod < renderData->lodCount; ++lod) {
+                renderData->lodViews[lod].vertexOffset = entry.vertexOffset;
+            }
         } else {
-            ++it;
+            const uint32_t newIndexOffset = relocation.dstOffset / GetIndexSize(entry.indexFormat);
+            for (uint32_t lod = 0; lod < renderData->lodCount; ++lod) {
+                MeshView& view = renderData->lodViews[lod];
+                view.indexOffset = view.indexOffset - entry.indexOffset + newIndexOffset;
+            }
+            entry.indexOffset = newIndexOffset;
         }
+
+        // Frames recorded before the switch may still read the old range
+        allocator->FreeDeferred(relocation.srcOffset, m_pendingFenceValue);
     }
 
-    // Reset upload allocator periodically (simple strategy)
-    m_uploadAllocator->Reset();
+    m_pendingRelocations.erase(m_pendingRelocations.begin(), m_pendingRelocations.begin() + completed);
+}
+
+void GeometryManager::RunDefragStep() {
+    if (!m_defragStaging || !m_currentUploadCmdList) {
+        return;
+    }
 
-    // printf("GeometryManager: Performed maintenance at frame %u\n", m_frameIndex);
+    // Relocations move whole buffers out of COMMON on the graphics queue,
+    // which must not overlap a copy-queue batch writing them. Uploads go
+    // first, compaction waits for a frame with none queued or in flight.
+    if (m_copyUploads && (m_uploadScheduler.GetLastSubmittedFenceValue() > m_copyCompletedFenceValue ||
+                          m_uploadScheduler.HasQueuedUploads() || !m_uploadQueue.empty())) {
+        return;
+    }
+
+    const uint32_t budget = static_cast<uint32_t>(m_defragStaging->GetSize());
+    const uint32_t vertexBytes = PlanRelocations(true, budget, m_vertexMoves);
+    const uint32_t indexBytes = PlanRelocations(false, budget - vertexBytes, m_indexMoves);
+
+    // Vertex moves use the front of the staging buffer, index moves the rest
+    RecordRelocations(true, m_vertexMoves, 0);
+    RecordRelocations(false, m_indexMoves, vertexBytes);
+
+    m_relocatedBytes += vertexBytes + indexBytes;
+}
+
+uint32_t GeometryManager::PlanRelocations(bool isVertexData, uint32_t budgetBytes, std::vector<DefragMove>& outMoves) {
+    outMoves.clear();
+    if (budgetBytes == 0) {
+        return 0;
+    }
+
+    TLSFAllocator* allocator = isVertexData ? &m_creation.GetVertexAllocator() : &m_creation.GetIndexAllocator();
+    allocator->GetBlocks(m_layoutScratch);
+
+    m_defragBlocks.clear();
+    for (const TLSFAllocator::Block& block : m_layoutScratch) {
+        m_defragBlocks.push_back({ block.offset, block.size, DEFRAG_PINNED_BLOCK, block.used });
+    }
+    if (ComputeFragmentation(m_defragBlocks) < m_config.defragThreshold) {
+        return 0;
+    }
+
+    // Only settled meshes may move: uploaded, not dying, no copy in flight.
+    // Everything else (including ranges awaiting a fence) stays pinned.
+    std::unordered_map<uint32_t, MeshHandle> movable;
+    m_meshRegistry.ForEach([&](MeshHandle handle, const MeshRenderData& renderData, const MeshEntry& entry) {
+        if (renderData.state != MeshState::Ready || entry.pendingRelocations > 0) {
+            return;
+        }
+        const uint32_t offset = isVertexData ? entry.vertexOffset * static_cast<uint32_t>(m_vertexStride)
+                                             : entry.indexOffset * GetIndexSize(entry.indexFormat);
+        movable[offset] = handle;
+    });
+    for (DefragBlock& block : m_defragBlocks) {
+        auto it = block.used ? movable.find(block.offset) : movable.end();
+        if (it != movable.end()) {
+            block.id = it->second;
+        }
+    }
+
+    PlanDefragMoves(m_defragBlocks, budgetBytes, outMoves);
+
+    // Reserve destinations now so regular allocations cannot take them
+    uint32_t movedBytes = 0;
+    auto keep = outMoves.begin();
+    for (const DefragMove& move : outMoves) {
+        if (!allocator->AllocateAt(move.dstOffset, move.size)) {
+            printf("GeometryManager: Defrag could not reserve offset %u\n", move.dstOffset);
+            continue;
+        }
+        *keep++ = move;
+        movedBytes += move.size;
+    }
+    outMoves.erase(keep, outMoves.end());
+
+    return movedBytes;
+}
+
+void GeometryManager::RecordRelocations(bool isVertexData, const std::vector<DefragMove>& moves, uint64_t stagingOffset) {
+    if (moves.empty()) {
+        return;
+    }
+
+    ID3D12GraphicsCommandList* cmdList = m_currentUploadCmdList->GetCommandList();
+    ID3D12Resource* target = isVertexData ? m_vertexBuffer->GetResource() : m_indexBuffer->GetResource();
+    ID3D12Resource* staging = m_defragStaging->GetResource();
+
+    m_uploadBatch.Transition(target, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    m_uploadBatch.Transition(staging, D3D12_RESOURCE_STATE_COPY_DEST);
+    m_uploadBatch.FlushBarriers(cmdList);
+
+    uint64_t offset = stagingOffset;
+    for (const DefragMove& move : moves) {
+        cmdList->CopyBufferRegion(staging, offset, target, move.srcOffset, move.size);
+        offset += move.size;
+    }
+
+    m_uploadBatch.Transition(target, D3D12_RESOURCE_STATE_COPY_DEST);
+    m_uploadBatch.Transition(staging, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    m_uploadBatch.FlushBarriers(cmdList);
+
+    offset = stagingOffset;
+    for (const DefragMove& move : moves) {
+        cmdList->CopyBufferRegion(target, move.dstOffset, staging, offset, move.size);
+        offset += move.size;
+
+        // Views keep pointing at the source until this frame retires
+        m_meshRegistry.GetCold(move.id)->pendingRelocations++;
+        m_pendingRelocations.push_back({ move.id, isVertexData, move.srcOffset, move.dstOffset, m_pendingFenceValue });
+    }
+
+    // The target stays in COPY_DEST for this frame's uploads, BeginFrame
+    // restores resting states once everything is recorded
 }
 
 void GeometryManager::FlushUploads() {
     while (!m_uploadQueue.empty() && m_currentUploadCmdList) {
+        size_t queued = m_uploadQueue.size();
         ProcessUploadQueue();
+
+        // The upload ring only frees space as fences complete, stop rather
+        // than spin when it is full
+        if (m_uploadQueue.size() == queued) {
+            printf("GeometryManager: Upload heap full, %zu uploads left queued\n", queued);
+            break;
+        }
     }
 }
 
@@ -375,21 +1042,70 @@ void GeometryManager::FlushUploads() {
 
 GeometryManager::Statistics GeometryManager::GetStatistics() const {
     Statistics stats = {};
-
-    stats.totalMeshes = static_cast<uint32_t>(m_meshRegistry.size());
-    stats.vertexBufferUsage = m_vertexAllocator ? m_vertexAllocator->GetUsedSpace() : 0;
-    stats.indexBufferUsage = m_indexAllocator ? m_indexAllocator->GetUsedSpace() : 0;
-    stats.uploadHeapUsage = m_uploadAllocator ? m_uploadAllocator->GetUsedSpace() : 0;
-    stats.pendingUploads = static_cast<uint32_t>(m_uploadQueue.size());
+    // Takes the creation mutex itself
+    stats.openMeshWrites = m_creation.GetOpenWriteCount();
+    std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+
+    const TLSFAllocator& vertexAllocator = m_creation.GetVertexAllocator();
+    const TLSFAllocator& indexAllocator = m_creation.GetIndexAllocator();
+    stats.totalMeshes = m_meshRegistry.Size();
+    stats.vertexBufferUsage = vertexAllocator.GetUsedSpace();
+    stats.indexBufferUsage = indexAllocator.GetUsedSpace();
+    stats.uploadHeapUsage = m_creation.GetUploadAllocator().GetUsedSpace();
+    const AsyncUploadScheduler::Statistics uploadStats = m_uploadScheduler.GetStatistics();
+    stats.pendingUploads = static_cast<uint32_t>(m_uploadQueue.size()) + uploadStats.queuedUploads +
+                           m_creation.GetQueuedCount();
+    stats.uploadBatchesInFlight = uploadStats.batchesInFlight;
+    stats.vertexLargestFreeBlock = vertexAllocator.GetLargestFreeBlock();
+    stats.indexLargestFreeBlock = indexAllocator.GetLargestFreeBlock();
+    stats.vertexFreeBlocks = vertexAllocator.GetFreeBlockCount();
+    stats.indexFreeBlocks = indexAllocator.GetFreeBlockCount();
+    stats.pendingFrees = vertexAllocator.GetPendingFreeCount() + indexAllocator.GetPendingFreeCount();
+
+    auto fragmentation = [](const TLSFAllocator& allocator) {
+        std::vector<TLSFAllocator::Block> layout;
+        allocator.GetBlocks(layout);
+        std::vector<DefragBlock> blocks;
+        for (const TLSFAllocator::Block& block : layout) {
+            blocks.push_back({ block.offset, block.size, DEFRAG_PINNED_BLOCK, block.used });
+        }
+        return ComputeFragmentation(blocks);
+    };
+    stats.vertexFragmentation = fragmentation(vertexAllocator);
+    stats.indexFragmentation = fragmentation(indexAllocator);
+    stats.pendingRelocations = static_cast<uint32_t>(m_pendingRelocations.size());
+    stats.relocatedBytes = m_relocatedBytes;
+
+    const UploadBatchRecorder::Statistics& batchStats = m_uploadBatch.GetStatistics();
+    stats.uploadCopiesQueued = batchStats.queuedCopies;
+    stats.uploadCopiesRecorded = batchStats.recordedCopies;
+    stats.uploadBarriers = batchStats.barriers;
+
+    const MeshContentTable::Statistics sharedStats = m_sharedMeshes.GetStatistics();
+    stats.dedupHits = sharedStats.hits;
+    stats.dedupMisses = sharedStats.misses;
+    stats.dedupBytesSaved = sharedStats.bytesSaved;
+    stats.sharedMeshes = sharedStats.sharedMeshes;
+
+    if (m_meshletPool) {
+        const MeshletPool::Statistics poolStats = m_meshletPool->GetStatistics();
+        stats.meshlets = poolStats.meshlets;
+        stats.meshletPoolUsage = poolStats.bytesUsed;
+        stats.meshletPoolSize = poolStats.bytesTotal;
+    }
 
     // Count by state
-    for (const auto& pair : m_meshRegistry) {
-        switch (pair.second.state) {
+    m_meshRegistry.ForEach([&stats](MeshHandle, const MeshRenderData& renderData, const MeshEntry& entry) {
+        if (entry.indexFormat == IndexFormat::Uint16) {
+            stats.meshes16BitIndices++;
+        }
+        switch (renderData.state) {
             case MeshState::PendingUpload: break; // Already counted in pendingUploads
+            case MeshState::Uploading: stats.uploadingMeshes++; break;
             case MeshState::Ready: stats.readyMeshes++; break;
             case MeshState::PendingDeletion: stats.pendingDeletions++; break;
         }
-    }
+    });
 
     return stats;
 }
@@ -401,13 +1117,43 @@ void GeometryManager::PrintDebugInfo() const {
     printf("Total Meshes: %u\n", stats.totalMeshes);
     printf("Ready Meshes: %u\n", stats.readyMeshes);
     printf("Pending Uploads: %u\n", stats.pendingUploads);
+    if (m_copyUploads) {
+        printf("Async Uploads: %u meshes in %u batches on the copy queue\n",
+               stats.uploadingMeshes, stats.uploadBatchesInFlight);
+    }
     printf("Pending Deletions: %u\n", stats.pendingDeletions);
+    printf("Vertex Layout: %zu bytes per vertex (%s positions)\n",
+           m_vertexStride, m_config.vertexLayout.IsQuantized() ? "quantized" : "float");
     printf("Vertex Buffer Usage: %.1f MB / %.1f MB\n",
            stats.vertexBufferUsage / (1024.0f * 1024.0f),
            m_config.vertexBufferSize / (1024.0f * 1024.0f));
-    printf("Index Buffer Usage: %.1f MB / %.1f MB\n",
+    printf("Index Buffer Usage: %.1f MB / %.1f MB (%u of %u meshes with 16-bit indices)\n",
            stats.indexBufferUsage / (1024.0f * 1024.0f),
-           m_config.indexBufferSize / (1024.0f * 1024.0f));
+           m_config.indexBufferSize / (1024.0f * 1024.0f),
+           stats.meshes16BitIndices, stats.totalMeshes);
+    printf("Vertex Free Blocks: %u (largest %.1f MB)\n",
+           stats.vertexFreeBlocks, stats.vertexLargestFreeBlock / (1024.0f * 1024.0f));
+    printf("Index Free Blocks: %u (largest %.1f MB)\n",
+           stats.indexFreeBlocks, stats.indexLargestFreeBlock / (1024.0f * 1024.0f));
+    printf("Pending Frees: %u\n", stats.pendingFrees);
+    printf("Fragmentation: vertex %.2f, index %.2f (relocations in flight: %u, moved %.1f MB)\n",
+           stats.vertexFragmentation, stats.indexFragmentation, stats.pendingRelocations,
+           stats.relocatedBytes / (1024.0f * 1024.0f));
+    printf("Upload Copies: %llu queued, %llu recorded after merging, %llu barriers\n",
+           static_cast<unsigned long long>(stats.uploadCopiesQueued),
+           static_cast<unsigned long long>(stats.uploadCopiesRecorded),
+           static_cast<unsigned long long>(stats.uploadBarriers));
+    if (m_config.deduplicateMeshes) {
+        const uint64_t lookups = stats.dedupHits + stats.dedupMisses;
+        printf("Mesh Dedup: %llu hits / %llu lookups (%.1f%%), %u shared meshes, %.1f MB saved\n",
+               static_cast<unsigned long long>(stats.dedupHits), static_cast<unsigned long long>(lookups),
+               lookups > 0 ? 100.0f * stats.dedupHits / lookups : 0.0f, stats.sharedMeshes,
+               stats.dedupBytesSaved / (1024.0f * 1024.0f));
+    }
+    if (m_meshletPool) {
+        printf("Meshlets: %u (pool %.1f MB / %.1f MB)\n", stats.meshlets,
+               stats.meshletPoolUsage / (1024.0f * 1024.0f), stats.meshletPoolSize / (1024.0f * 1024.0f));
+    }
     printf("Upload Heap Usage: %.1f MB / %.1f MB\n",
            stats.uploadHeapUsage / (1024.0f * 1024.0f),
            m_config.uploadHeapSize / (1024.0f * 1024.0f));
@@ -0,0 +1,39 @@
+#include "IndexNarrowing.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INDEX_NARROWING_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define INDEX_NARROWING_USE_SSE2 0
+#endif
+
+void NarrowIndices(const uint32_t* src, uint32_t count, uint16_t* dst) {
+    uint32_t i = 0;
+
+#if INDEX_NARROWING_USE_SSE2
+    // SSE2 only packs with signed saturation: bias into int16 range, pack,
+    // then flip the sign bit back
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 8 <= count; i += 8) {
+        const __m128i low = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), bias32);
+        const __m128i high = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), bias32);
+        const __m128i packed = _mm_xor_si128(_mm_packs_epi32(low, high), bias16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        dst[i] = static_cast<uint16_t>(src[i]);
+    }
+}
+
+void WriteSpanIndices(const MeshWriteSpan& span, uint32_t first, const uint32_t* indices, uint32_t count) {
+    if (span.indexFormat == IndexFormat::Uint16) {
+        NarrowIndices(indices, count, static_cast<uint16_t*>(span.indices) + first);
+    } else {
+        memcpy(static_cast<uint32_t*>(span.indices) + first, indices, count * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "RenderTypes.h"
+
+// =============================================================================
+// Index Narrowing
+// =============================================================================
+
+// Narrowest format that can address vertexCount vertices
+inline IndexFormat SelectIndexFormat(uint32_t vertexCount) {
+    return vertexCount <= 65536 ? IndexFormat::Uint16 : IndexFormat::Uint32;
+}
+
+// Index ranges are padded to 4 bytes so both widths share one allocator and
+// every range starts on a whole index of either width
+inline size_t AlignIndexDataSize(size_t size) {
+    return (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+}
+
+// dst[i] = uint16_t(src[i]). Every value must be below 65536 (see
+// SelectIndexFormat), larger ones are not detected.
+void NarrowIndices(const uint32_t* src, uint32_t count, uint16_t* dst);
+
+// Stores count indices starting at index first of a write span, narrowed
+// when the span is 16-bit. Store-only, so fine on write-combined staging.
+void WriteSpanIndices(const MeshWriteSpan& span, uint32_t first, const uint32_t* indices, uint32_t count);
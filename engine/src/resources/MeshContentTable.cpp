@@ -0,0 +1,116 @@
+#include "MeshContentTable.h"
+#include "ContentHash.h"
+#include <cstring>
+
+namespace {
+
+// Calls fn(data, size) per stream, absent streams with size 0. The occluder
+// flag counts, shared meshes keep one occluder copy or none.
+template <typename Fn>
+void ForEachMeshContentStream(const CPUMesh& mesh, Fn&& fn) {
+    const uint8_t occluder = mesh.isOccluder ? 1 : 0;
+    fn(&occluder, sizeof(occluder));
+    fn(mesh.vertices, mesh.vertexCount * sizeof(VertexAttributes));
+    fn(mesh.normals, mesh.normals ? mesh.vertexCount * 3 * sizeof(float) : 0);
+    fn(mesh.uvs, mesh.uvs ? mesh.vertexCount * 2 * sizeof(float) : 0);
+    fn(mesh.indices, mesh.indexCount * sizeof(uint32_t));
+    for (uint32_t lod = 0; mesh.lods && lod < mesh.lodCount && lod + 1 < MAX_MESH_LODS; ++lod) {
+        fn(mesh.lods[lod].indices, mesh.lods[lod].indices ? mesh.lods[lod].indexCount * sizeof(uint32_t) : 0);
+    }
+}
+
+bool ContentEquals(const CPUMesh& mesh, const std::vector<uint8_t>& content) {
+    size_t cursor = 0;
+    bool equal = true;
+    ForEachMeshContentStream(mesh, [&](const void* data, size_t size) {
+        uint64_t storedSize = 0;
+        if (!equal || cursor + sizeof(storedSize) > content.size()) {
+            equal = false;
+            return;
+        }
+        memcpy(&storedSize, content.data() + cursor, sizeof(storedSize));
+        cursor += sizeof(storedSize);
+        if (storedSize != size || cursor + size > content.size() ||
+            (size > 0 && memcmp(content.data() + cursor, data, size) != 0)) {
+            equal = false;
+            return;
+        }
+        cursor += size;
+    });
+    return equal && cursor == content.size();
+}
+
+} // namespace
+
+uint64_t MeshContentTable::Hash(const CPUMesh& mesh) {
+    uint64_t hash = 0;
+    ForEachMeshContentStream(mesh, [&hash](const void* data, size_t size) {
+        const uint64_t size64 = size;
+        hash = HashBytes(&size64, sizeof(size64), hash);
+        if (size > 0) {
+            hash = HashBytes(data, size, hash);
+        }
+    });
+    return hash != 0 ? hash : 1;    // 0 marks meshes outside the table
+}
+
+std::vector<uint8_t> MeshContentTable::Serialize(const CPUMesh& mesh) {
+    std::vector<uint8_t> content;
+    ForEachMeshContentStream(mesh, [&content](const void* data, size_t size) {
+        const uint64_t size64 = size;
+        const uint8_t* sizeBytes = reinterpret_cast<const uint8_t*>(&size64);
+        content.insert(content.end(), sizeBytes, sizeBytes + sizeof(size64));
+        if (size > 0) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            content.insert(content.end(), bytes, bytes + size);
+        }
+    });
+    return content;
+}
+
+MeshHandle MeshContentTable::Acquire(const CPUMesh& mesh, uint64_t& outHash) {
+    outHash = Hash(mesh);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_meshes.find(outHash);
+    if (it != m_meshes.end()) {
+        SharedMesh& shared = it->second;
+        if (ContentEquals(mesh, shared.content)) {
+            shared.refCount++;
+            m_hits++;
+            m_bytesSaved += shared.byteSize;
+            return shared.handle;
+        }
+        outHash = 0;    // Hash collision, this one stays private
+    }
+    m_misses++;
+    return INVALID_MESH_HANDLE;
+}
+
+bool MeshContentTable::Release(uint64_t hash, MeshHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_meshes.find(hash);
+    if (it == m_meshes.end() || it->second.handle != handle) {
+        return true;
+    }
+    if (--it->second.refCount > 0) {
+        return false;
+    }
+    m_meshes.erase(it);
+    return true;
+}
+
+void MeshContentTable::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_meshes.clear();
+}
+
+MeshContentTable::Statistics MeshContentTable::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.bytesSaved = m_bytesSaved;
+    stats.sharedMeshes = static_cast<uint32_t>(m_meshes.size());
+    return stats;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "RenderTypes.h"
+
+// =============================================================================
+// Mesh Content Table
+// =============================================================================
+
+// Content hash to shared mesh, for deduplicating CreateMesh. A hash hit only
+// counts when the content matches byte for byte, so a collision never shares
+// the wrong geometry; each shared mesh keeps a copy of its source streams for
+// that. Any thread, own lock.
+class MeshContentTable {
+public:
+    struct Statistics {
+        uint64_t hits = 0;              // Acquires answered with a shared mesh
+        uint64_t misses = 0;            // Acquires that needed their own mesh
+        uint64_t bytesSaved = 0;        // Geometry bytes of the shared meshes handed out
+        uint32_t sharedMeshes = 0;
+    };
+
+    MeshContentTable() = default;
+
+    // Prevent copying
+    MeshContentTable(const MeshContentTable&) = delete;
+    MeshContentTable& operator=(const MeshContentTable&) = delete;
+
+    // Hash of everything that ends up in the buffers: vertices, every index
+    // list and the occluder flag. Never 0.
+    static uint64_t Hash(const CPUMesh& mesh);
+
+    // The hashed streams, each behind its size, to publish with the mesh
+    static std::vector<uint8_t> Serialize(const CPUMesh& mesh);
+
+    // A shared mesh with the same content, its reference count raised. On a
+    // miss, INVALID_MESH_HANDLE and outHash is the key to publish under, 0
+    // after a collision (the mesh then stays private).
+    MeshHandle Acquire(const CPUMesh& mesh, uint64_t& outHash);
+
+    // Shares handle under hash with one reference, unless another thread
+    // published the same content first. submit(published) runs under the
+    // lock either way, so a handle Acquire hands out is always submitted.
+    template <typename Submit>
+    bool Publish(uint64_t hash, MeshHandle handle, std::vector<uint8_t> content, uint32_t byteSize,
+                 Submit&& submit) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const bool published = m_meshes.emplace(hash, SharedMesh{ handle, std::move(content), 1, byteSize }).second;
+        submit(published);
+        return published;
+    }
+
+    // Drops one reference. False while others remain; true once the last
+    // one went, or when handle is not the one shared under hash.
+    bool Release(uint64_t hash, MeshHandle handle);
+
+    void Clear();
+    Statistics GetStatistics() const;
+
+private:
+    struct SharedMesh {
+        MeshHandle handle = INVALID_MESH_HANDLE;
+        std::vector<uint8_t> content;       // See Serialize
+        uint32_t refCount = 0;
+        uint32_t byteSize = 0;              // Vertex plus index bytes, for the saved-bytes stat
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, SharedMesh> m_meshes;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_bytesSaved = 0;
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "RenderTypes.h"
+#include "TLSFAllocator.h"
+#include "UploadRingAllocator.h"
+#include "jobs/MPSCQueue.h"
+
+// =============================================================================
+// Mesh Creation Queue
+// =============================================================================
+
+// Byte offsets of one mesh's ranges. The staging range only exists for meshes
+// written in place.
+struct MeshAllocation {
+    uint32_t vertexOffset = UINT32_MAX;
+    uint32_t indexOffset = UINT32_MAX;
+    uint32_t stagingOffset = UINT32_MAX;
+};
+
+// The CPU side of creating meshes on any thread: vertex, index and staging
+// allocators behind one mutex, meshes being written in place, and the
+// lock-free hand-over of finished meshes to the thread that owns them. Mesh
+// is whatever the owner registers per mesh; handles come from the owner too.
+//
+// A handle given to the queue is open (BeginWrite until Commit or
+// CancelWrite), then queued (Submit or Commit until Drain), then the owner's.
+// Queued handles are tracked under the mutex, not by looking into the MPSC
+// queue, so Destroy finds a mesh whose producer has not finished linking it
+// and hands the destroy to Drain instead of losing it.
+template <typename Mesh>
+class MeshCreationQueue {
+public:
+    struct Config {
+        size_t vertexBufferSize = 0;
+        size_t vertexAlignment = 1;             // Vertex stride, so offsets convert to base vertices
+        size_t indexBufferSize = 0;
+        size_t indexAlignment = sizeof(uint32_t);
+        size_t uploadHeapSize = 0;
+    };
+
+    enum class DestroyResult {
+        Unknown,        // Neither open nor queued: drained already, or stale
+        Cancelled,      // Was open, its ranges are free again. The handle is the caller's to free.
+        Deferred,       // Queued, Drain reports the destroy with the mesh
+    };
+
+    MeshCreationQueue() = default;
+
+    // Prevent copying
+    MeshCreationQueue(const MeshCreationQueue&) = delete;
+    MeshCreationQueue& operator=(const MeshCreationQueue&) = delete;
+
+    // Owning thread, with nothing open or queued
+    void Initialize(const Config& config) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vertexAllocator = std::make_unique<TLSFAllocator>(config.vertexBufferSize, config.vertexAlignment);
+        m_indexAllocator = std::make_unique<TLSFAllocator>(config.indexBufferSize, config.indexAlignment);
+        m_uploadAllocator = std::make_unique<UploadRingAllocator>(config.uploadHeapSize);
+        m_openWrites.clear();
+        m_queued.clear();
+    }
+
+    // =========================================================================
+    // Any thread
+    // =========================================================================
+
+    // Vertex and index ranges, both or neither
+    bool Allocate(size_t vertexBytes, size_t indexBytes, MeshAllocation& outAllocation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return AllocateGeometry(vertexBytes, indexBytes, outAllocation);
+    }
+
+    // Returns ranges no copy was recorded against
+    void Free(const MeshAllocation& allocation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FreeImmediately(allocation);
+    }
+
+    // Hands a finished mesh to the owning thread
+    void Submit(uint32_t handle, Mesh mesh) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Enqueue(handle, std::move(mesh));
+    }
+
+    // Staging for vertexBytes + indexBytes (held until the owner sets its
+    // fence) plus the buffer ranges, then makeMesh(allocation) builds the
+    // mesh kept open until Commit. False when anything is out of space.
+    template <typename MakeMesh>
+    bool BeginWrite(uint32_t handle, size_t vertexBytes, size_t indexBytes, MakeMesh&& makeMesh,
+                    MeshAllocation& outAllocation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        outAllocation.stagingOffset =
+            m_uploadAllocator->Allocate(vertexBytes + indexBytes, UploadRingAllocator::PENDING_FENCE);
+        if (outAllocation.stagingOffset == UINT32_MAX) {
+            return false;
+        }
+        if (!AllocateGeometry(vertexBytes, indexBytes, outAllocation)) {
+            m_uploadAllocator->SetFence(outAllocation.stagingOffset, 0);
+            outAllocation.stagingOffset = UINT32_MAX;
+            return false;
+        }
+
+        m_openWrites.emplace(handle, OpenWrite{ outAllocation, makeMesh(outAllocation) });
+        return true;
+    }
+
+    // Runs finish(mesh) and queues it in one step, so a Destroy never finds
+    // the handle in neither place. False when the handle is not open.
+    template <typename Finish>
+    bool Commit(uint32_t handle, Finish&& finish) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_openWrites.find(handle);
+        if (it == m_openWrites.end()) {
+            return false;
+        }
+        Mesh mesh = std::move(it->second.mesh);
+        m_openWrites.erase(it);
+        finish(mesh);
+        Enqueue(handle, std::move(mesh));
+        return true;
+    }
+
+    // Frees an open write's ranges, false when the handle is not open. The
+    // handle is the caller's to free.
+    bool CancelWrite(uint32_t handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return CancelOpenWrite(handle);
+    }
+
+    // Queued and not drained yet, cheap enough to poll every frame
+    uint32_t GetQueuedCount() const { return m_queuedCount.load(std::memory_order_relaxed); }
+
+    uint32_t GetOpenWriteCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<uint32_t>(m_openWrites.size());
+    }
+
+    // =========================================================================
+    // Owning thread
+    // =========================================================================
+
+    DestroyResult Destroy(uint32_t handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (CancelOpenWrite(handle)) {
+            return DestroyResult::Cancelled;
+        }
+        auto it = m_queued.find(handle);
+        if (it == m_queued.end()) {
+            return DestroyResult::Unknown;
+        }
+        // Counted: a shared mesh can be destroyed once per reference
+        it->second++;
+        return DestroyResult::Deferred;
+    }
+
+    // fn(handle, Mesh&&, destroyCount) for every mesh linked so far, in push
+    // order. destroyCount is how often Destroy deferred on it. A mesh still
+    // being linked shows up on a later call.
+    template <typename Fn>
+    void Drain(Fn&& fn) {
+        QueuedMesh queued;
+        while (m_createdMeshes.Pop(queued)) {
+            m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+
+            uint32_t destroyCount = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_queued.find(queued.handle);
+                if (it != m_queued.end()) {
+                    destroyCount = it->second;
+                    m_queued.erase(it);
+                }
+            }
+            fn(queued.handle, std::move(queued.mesh), destroyCount);
+        }
+    }
+
+    // The allocators, for fence-tagged frees, reclaiming and defragmentation.
+    // Hold GetMutex() while other threads may be creating.
+    std::mutex& GetMutex() const { return m_mutex; }
+    TLSFAllocator& GetVertexAllocator() { return *m_vertexAllocator; }
+    TLSFAllocator& GetIndexAllocator() { return *m_indexAllocator; }
+    UploadRingAllocator& GetUploadAllocator() { return *m_uploadAllocator; }
+    const TLSFAllocator& GetVertexAllocator() const { return *m_vertexAllocator; }
+    const TLSFAllocator& GetIndexAllocator() const { return *m_indexAllocator; }
+    const UploadRingAllocator& GetUploadAllocator() const { return *m_uploadAllocator; }
+
+private:
+    struct OpenWrite {
+        MeshAllocation allocation;
+        Mesh mesh;
+    };
+
+    struct QueuedMesh {
+        uint32_t handle = INVALID_MESH_HANDLE;
+        Mesh mesh;
+    };
+
+    // Caller holds m_mutex
+    bool AllocateGeometry(size_t vertexBytes, size_t indexBytes, MeshAllocation& outAllocation) {
+        outAllocation.vertexOffset = m_vertexAllocator->Allocate(vertexBytes);
+        outAllocation.indexOffset = m_indexAllocator->Allocate(indexBytes);
+        if (outAllocation.vertexOffset != UINT32_MAX && outAllocation.indexOffset != UINT32_MAX) {
+            return true;
+        }
+
+        // Give back whichever half succeeded
+        if (outAllocation.vertexOffset != UINT32_MAX) {
+            m_vertexAllocator->Free(outAllocation.vertexOffset);
+        }
+        if (outAllocation.indexOffset != UINT32_MAX) {
+            m_indexAllocator->Free(outAllocation.indexOffset);
+        }
+        outAllocation.vertexOffset = UINT32_MAX;
+        outAllocation.indexOffset = UINT32_MAX;
+        return false;
+    }
+
+    // Caller holds m_mutex
+    void FreeImmediately(const MeshAllocation& allocation) {
+        if (allocation.stagingOffset != UINT32_MAX) {
+            m_uploadAllocator->SetFence(allocation.stagingOffset, 0);
+        }
+        m_vertexAllocator->Free(allocation.vertexOffset);
+        m_indexAllocator->Free(allocation.indexOffset);
+    }
+
+    // Caller holds m_mutex
+    bool CancelOpenWrite(uint32_t handle) {
+        auto it = m_openWrites.find(handle);
+        if (it == m_openWrites.end()) {
+            return false;
+        }
+        FreeImmediately(it->second.allocation);
+        m_openWrites.erase(it);
+        return true;
+    }
+
+    // Caller holds m_mutex. Tracked before the push so Destroy sees it from
+    // the moment the handle can be known to anyone else, and pushed under the
+    // mutex so no producer links behind another's half-finished push.
+    void Enqueue(uint32_t handle, Mesh mesh) {
+        m_queued.emplace(handle, 0);
+        m_queuedCount.fetch_add(1, std::memory_order_relaxed);
+        m_createdMeshes.Push(QueuedMesh{ handle, std::move(mesh) });
+    }
+
+    mutable std::mutex m_mutex;
+    std::unique_ptr<TLSFAllocator> m_vertexAllocator;
+    std::unique_ptr<TLSFAllocator> m_indexAllocator;
+    std::unique_ptr<UploadRingAllocator> m_uploadAllocator;
+    std::unordered_map<uint32_t, OpenWrite> m_openWrites;
+    std::unordered_map<uint32_t, uint32_t> m_queued;        // Handle -> destroys deferred to Drain
+
+    MPSCQueue<QueuedMesh> m_createdMeshes;
+    std::atomic<uint32_t> m_queuedCount{ 0 };
+};
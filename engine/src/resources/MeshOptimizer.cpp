@@ -0,0 +1,546 @@
+#include "MeshOptimizer.h"
+#include "ContentHash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// FIFO post-transform cache. A vertex is cached while fewer than cacheSize
+// misses happened since it was last transformed; Reset empties the cache by
+// moving the clock past every stamp.
+class FifoCache {
+public:
+    FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+        : m_stamps(vertexCount, 0)
+        , m_cacheSize(cacheSize)
+        , m_time(cacheSize + 1) {}
+
+    // Returns true on a miss
+    bool Access(uint32_t vertex) {
+        if (m_time - m_stamps[vertex] > m_cacheSize) {
+            m_stamps[vertex] = m_time++;
+            return true;
+        }
+        return false;
+    }
+
+    void Reset() { m_time += m_cacheSize + 1; }
+
+private:
+    std::vector<uint32_t> m_stamps;
+    uint32_t m_cacheSize;
+    uint32_t m_time;
+};
+
+// Triangles around each vertex, compressed: triangles of vertex v are
+// triangles[offsets[v] .. offsets[v + 1])
+struct TriangleAdjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+};
+
+TriangleAdjacency BuildAdjacency(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount) {
+    TriangleAdjacency adjacency;
+    adjacency.offsets.assign(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        adjacency.offsets[indices[i] + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        adjacency.offsets[v + 1] += adjacency.offsets[v];
+    }
+
+    adjacency.triangles.resize(indexCount);
+    std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        adjacency.triangles[cursor[indices[i]]++] = i / 3;
+    }
+    return adjacency;
+}
+
+bool IndicesInRange(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount) {
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VerticesEqual(const OptimizedMesh& mesh, uint32_t a, uint32_t b) {
+    if (memcmp(&mesh.vertices[a], &mesh.vertices[b], sizeof(VertexAttributes)) != 0) {
+        return false;
+    }
+    if (!mesh.normals.empty() && memcmp(&mesh.normals[a * 3], &mesh.normals[b * 3], 3 * sizeof(float)) != 0) {
+        return false;
+    }
+    if (!mesh.uvs.empty() && memcmp(&mesh.uvs[a * 2], &mesh.uvs[b * 2], 2 * sizeof(float)) != 0) {
+        return false;
+    }
+    return true;
+}
+
+// Moves every attribute to its new slot, remap[old] = new or UINT32_MAX to drop
+void RemapVertices(OptimizedMesh& mesh, const std::vector<uint32_t>& remap, uint32_t newCount) {
+    const uint32_t oldCount = static_cast<uint32_t>(mesh.vertices.size());
+
+    std::vector<VertexAttributes> vertices(newCount);
+    std::vector<float> normals(mesh.normals.empty() ? 0 : newCount * 3);
+    std::vector<float> uvs(mesh.uvs.empty() ? 0 : newCount * 2);
+    for (uint32_t v = 0; v < oldCount; ++v) {
+        const uint32_t target = remap[v];
+        if (target == UINT32_MAX) {
+            continue;
+        }
+        vertices[target] = mesh.vertices[v];
+        if (!normals.empty()) {
+            memcpy(&normals[target * 3], &mesh.normals[v * 3], 3 * sizeof(float));
+        }
+        if (!uvs.empty()) {
+            memcpy(&uvs[target * 2], &mesh.uvs[v * 2], 2 * sizeof(float));
+        }
+    }
+
+    mesh.vertices = std::move(vertices);
+    mesh.normals = std::move(normals);
+    mesh.uvs = std::move(uvs);
+
+    for (uint32_t& index : mesh.indices) {
+        index = remap[index];
+    }
+    for (auto& lod : mesh.lodIndices) {
+        for (uint32_t& index : lod) {
+            index = remap[index];
+        }
+    }
+}
+
+struct Vec3 {
+    float x, y, z;
+};
+
+Vec3 Position(const VertexAttributes* vertices, uint32_t index) {
+    const float* p = vertices[index].position;
+    return { p[0], p[1], p[2] };
+}
+
+} // namespace
+
+// =============================================================================
+// Analysis
+// =============================================================================
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, uint32_t indexCount,
+                                    uint32_t vertexCount, uint32_t cacheSize) {
+    VertexCacheStats stats;
+    if (!indices || indexCount < 3 || vertexCount == 0 || !IndicesInRange(indices, indexCount, vertexCount)) {
+        return stats;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t referencedCount = 0;
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        stats.transformedVertices += cache.Access(indices[i]) ? 1 : 0;
+        if (!referenced[indices[i]]) {
+            referenced[indices[i]] = 1;
+            referencedCount++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(stats.transformedVertices) / (indexCount / 3);
+    stats.atvr = static_cast<float>(stats.transformedVertices) / referencedCount;
+    return stats;
+}
+
+// =============================================================================
+// Mesh Copies
+// =============================================================================
+
+CPUMesh OptimizedMesh::GetCPUMesh() {
+    m_lodViews.resize(lodIndices.size());
+    for (size_t lod = 0; lod < lodIndices.size(); ++lod) {
+        m_lodViews[lod].indices = lodIndices[lod].data();
+        m_lodViews[lod].indexCount = static_cast<uint32_t>(lodIndices[lod].size());
+        m_lodViews[lod].error = lod < lodErrors.size() ? lodErrors[lod] : 0.0f;
+    }
+
+    CPUMesh mesh;
+    mesh.vertices = vertices.data();
+    mesh.indices = indices.data();
+    mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+    mesh.indexCount = static_cast<uint32_t>(indices.size());
+    mesh.lods = m_lodViews.empty() ? nullptr : m_lodViews.data();
+    mesh.lodCount = static_cast<uint32_t>(m_lodViews.size());
+    mesh.normals = normals.empty() ? nullptr : normals.data();
+    mesh.uvs = uvs.empty() ? nullptr : uvs.data();
+    mesh.isOccluder = isOccluder;
+    return mesh;
+}
+
+OptimizedMesh CopyMesh(const CPUMesh& mesh) {
+    OptimizedMesh copy;
+    copy.vertices.assign(mesh.vertices, mesh.vertices + mesh.vertexCount);
+    if (mesh.normals) {
+        copy.normals.assign(mesh.normals, mesh.normals + mesh.vertexCount * 3);
+    }
+    if (mesh.uvs) {
+        copy.uvs.assign(mesh.uvs, mesh.uvs + mesh.vertexCount * 2);
+    }
+    copy.indices.assign(mesh.indices, mesh.indices + mesh.indexCount);
+    if (mesh.lods) {
+        for (uint32_t lod = 0; lod < mesh.lodCount; ++lod) {
+            if (mesh.lods[lod].indices && mesh.lods[lod].indexCount > 0) {
+                copy.lodIndices.emplace_back(mesh.lods[lod].indices, mesh.lods[lod].indices + mesh.lods[lod].indexCount);
+                copy.lodErrors.push_back(mesh.lods[lod].error);
+            }
+        }
+    }
+    copy.isOccluder = mesh.isOccluder;
+    return copy;
+}
+
+// =============================================================================
+// Step 1: Vertex Deduplication
+// =============================================================================
+
+uint32_t DeduplicateVertices(OptimizedMesh& mesh) {
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    if (vertexCount == 0) {
+        return 0;
+    }
+
+    // Open addressing over vertex indices, at most half full
+    uint32_t tableSize = 1;
+    while (tableSize < vertexCount * 2) {
+        tableSize *= 2;
+    }
+    std::vector<uint32_t> table(tableSize, UINT32_MAX);
+
+    std::vector<uint32_t> remap(vertexCount);
+    uint32_t uniqueCount = 0;
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        uint64_t hash = HashBytes(&mesh.vertices[v], sizeof(VertexAttributes));
+        if (!mesh.normals.empty()) {
+            hash = HashBytes(&mesh.normals[v * 3], 3 * sizeof(float), hash);
+        }
+        if (!mesh.uvs.empty()) {
+            hash = HashBytes(&mesh.uvs[v * 2], 2 * sizeof(float), hash);
+        }
+
+        uint32_t slot = static_cast<uint32_t>(hash) & (tableSize - 1);
+        while (table[slot] != UINT32_MAX && !VerticesEqual(mesh, table[slot], v)) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == UINT32_MAX) {
+            table[slot] = v;
+            remap[v] = uniqueCount++;
+        } else {
+            remap[v] = remap[table[slot]];
+        }
+    }
+
+    if (uniqueCount < vertexCount) {
+        RemapVertices(mesh, remap, uniqueCount);
+    }
+    return uniqueCount;
+}
+
+// =============================================================================
+// Step 2: Vertex Cache (Tipsify, Sander et al. 2007)
+// =============================================================================
+
+void OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount,
+                         uint32_t cacheSize, std::vector<uint32_t>* outClusters) {
+    if (outClusters) {
+        outClusters->clear();
+    }
+
+    const uint32_t triangleCount = indexCount / 3;
+    if (!indices || triangleCount == 0 || vertexCount == 0 || !IndicesInRange(indices, indexCount, vertexCount)) {
+        return;
+    }
+
+    const TriangleAdjacency adjacency = BuildAdjacency(indices, triangleCount * 3, vertexCount);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    uint32_t time = cacheSize + 1;
+    uint32_t scanCursor = 0;
+
+    // Next vertex with live triangles: recent dead ends first, then input order
+    auto skipDeadEnd = [&]() -> uint32_t {
+        while (!deadEnd.empty()) {
+            const uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+        while (scanCursor < vertexCount) {
+            if (liveTriangles[scanCursor] > 0) {
+                return scanCursor;
+            }
+            scanCursor++;
+        }
+        return UINT32_MAX;
+    };
+
+    uint32_t fan = skipDeadEnd();
+    bool restarted = true;
+    while (fan != UINT32_MAX) {
+        if (restarted && outClusters) {
+            outClusters->push_back(static_cast<uint32_t>(output.size() / 3));
+        }
+
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i) {
+            const uint32_t triangle = adjacency.triangles[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = 1;
+
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that stays in cache longest and whose
+        // remaining fan still fits in it
+        uint32_t next = UINT32_MAX;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            const int64_t age = static_cast<int64_t>(time) - cacheTime[vertex];
+            if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize) {
+                priority = age;
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        restarted = next == UINT32_MAX;
+        fan = restarted ? skipDeadEnd() : next;
+    }
+
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+// =============================================================================
+// Step 3: Overdraw (cluster sorting, Sander et al. 2007)
+// =============================================================================
+
+void OptimizeOverdraw(uint32_t* indices, uint32_t indexCount,
+                      const VertexAttributes* vertices, uint32_t vertexCount,
+                      const std::vector<uint32_t>& hardClusters,
+                      uint32_t cacheSize, float threshold) {
+    const uint32_t triangleCount = indexCount / 3;
+    if (!indices || !vertices || triangleCount == 0 || !IndicesInRange(indices, indexCount, vertexCount)) {
+        return;
+    }
+
+    // Whole-list ACMR is the budget soft splits are measured against
+    const float meshACMR = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, cacheSize).acmr;
+
+    // Split hard clusters wherever the run so far is at least as cache
+    // friendly as the budget allows; a cluster starts on a cold cache
+    std::vector<uint32_t> clusters;
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t h = 0; h < std::max<size_t>(hardClusters.size(), 1); ++h) {
+        const uint32_t begin = hardClusters.empty() ? 0 : hardClusters[h];
+        const uint32_t end = h + 1 < hardClusters.size() ? hardClusters[h + 1] : triangleCount;
+
+        clusters.push_back(begin);
+        cache.Reset();
+        uint32_t clusterStart = begin;
+        uint32_t misses = 0;
+        for (uint32_t t = begin; t < end; ++t) {
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                misses += cache.Access(indices[t * 3 + corner]) ? 1 : 0;
+            }
+
+            const uint32_t clusterTriangles = t + 1 - clusterStart;
+            if (t + 1 < end && static_cast<float>(misses) / clusterTriangles <= meshACMR * threshold) {
+                clusters.push_back(t + 1);
+                clusterStart = t + 1;
+                misses = 0;
+                cache.Reset();
+            }
+        }
+    }
+
+    // Area-weighted centroid and normal per cluster
+    const uint32_t clusterCount = static_cast<uint32_t>(clusters.size());
+    std::vector<Vec3> clusterCentroid(clusterCount, { 0.0f, 0.0f, 0.0f });
+    std::vector<Vec3> clusterNormal(clusterCount, { 0.0f, 0.0f, 0.0f });
+    Vec3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        const uint32_t begin = clusters[c];
+        const uint32_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+
+        Vec3 centroid = { 0.0f, 0.0f, 0.0f };
+        Vec3 normal = { 0.0f, 0.0f, 0.0f };
+        float area = 0.0f;
+        for (uint32_t t = begin; t < end; ++t) {
+            const Vec3 a = Position(vertices, indices[t * 3 + 0]);
+            const Vec3 b = Position(vertices, indices[t * 3 + 1]);
+            const Vec3 d = Position(vertices, indices[t * 3 + 2]);
+
+            // Front faces are clockwise (see MeshletBuilder's TriangleNormal),
+            // so cross(d - a, b - a) points out of the surface
+            const Vec3 e0 = { d.x - a.x, d.y - a.y, d.z - a.z };
+            const Vec3 e1 = { b.x - a.x, b.y - a.y, b.z - a.z };
+            const Vec3 n = { e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+            const float triangleArea = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+
+            centroid.x += (a.x + b.x + d.x) * triangleArea;
+            centroid.y += (a.y + b.y + d.y) * triangleArea;
+            centroid.z += (a.z + b.z + d.z) * triangleArea;
+            normal.x += n.x;
+            normal.y += n.y;
+            normal.z += n.z;
+            area += triangleArea;
+        }
+
+        meshCentroid.x += centroid.x;
+        meshCentroid.y += centroid.y;
+        meshCentroid.z += centroid.z;
+        meshArea += area;
+
+        const float scale = area > 0.0f ? 1.0f / (3.0f * area) : 0.0f;
+        clusterCentroid[c] = { centroid.x * scale, centroid.y * scale, centroid.z * scale };
+        clusterNormal[c] = normal;
+    }
+
+    const float meshScale = meshArea > 0.0f ? 1.0f / (3.0f * meshArea) : 0.0f;
+    meshCentroid = { meshCentroid.x * meshScale, meshCentroid.y * meshScale, meshCentroid.z * meshScale };
+
+    // Clusters far out along their own normal occlude the most, draw them first
+    std::vector<float> sortKey(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        const Vec3& n = clusterNormal[c];
+        const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+        const Vec3 offset = { clusterCentroid[c].x - meshCentroid.x,
+                              clusterCentroid[c].y - meshCentroid.y,
+                              clusterCentroid[c].z - meshCentroid.z };
+        sortKey[c] = length > 0.0f ? (offset.x * n.x + offset.y * n.y + offset.z * n.z) / length : 0.0f;
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return sortKey[a] > sortKey[b];
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (uint32_t c : order) {
+        const uint32_t begin = clusters[c];
+        const uint32_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+        output.insert(output.end(), indices + begin * 3, indices + end * 3);
+    }
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+// =============================================================================
+// Step 4: Vertex Fetch
+// =============================================================================
+
+uint32_t OptimizeVertexFetch(OptimizedMesh& mesh) {
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+
+    // First use in LOD 0 decides the order, LOD-only vertices follow
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t nextVertex = 0;
+    auto visit = [&](const std::vector<uint32_t>& indices) {
+        for (uint32_t index : indices) {
+            if (index < vertexCount && remap[index] == UINT32_MAX) {
+                remap[index] = nextVertex++;
+            }
+        }
+    };
+    visit(mesh.indices);
+    for (const auto& lod : mesh.lodIndices) {
+        visit(lod);
+    }
+
+    RemapVertices(mesh, remap, nextVertex);
+    return nextVertex;
+}
+
+// =============================================================================
+// Pipeline
+// =============================================================================
+
+OptimizedMesh OptimizeMesh(const CPUMesh& mesh, const MeshOptimizeSettings& settings,
+                           MeshOptimizeReport* outReport) {
+    OptimizedMesh result = CopyMesh(mesh);
+    if (!mesh.vertices || !mesh.indices || mesh.vertexCount == 0 || mesh.indexCount < 3 ||
+        !IndicesInRange(mesh.indices, mesh.indexCount, mesh.vertexCount)) {
+        return result;
+    }
+    for (const auto& lod : result.lodIndices) {
+        if (!IndicesInRange(lod.data(), static_cast<uint32_t>(lod.size()), mesh.vertexCount)) {
+            return result;
+        }
+    }
+
+    if (outReport) {
+        outReport->vertexCountBefore = mesh.vertexCount;
+        outReport->before = AnalyzeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount, settings.cacheSize);
+    }
+
+    uint32_t vertexCount = DeduplicateVertices(result);
+
+    auto optimizeList = [&](std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> hardClusters;
+        const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+        OptimizeVertexCache(indices.data(), indexCount, vertexCount, settings.cacheSize, &hardClusters);
+        if (settings.optimizeOverdraw) {
+            OptimizeOverdraw(indices.data(), indexCount, result.vertices.data(), vertexCount,
+                             hardClusters, settings.cacheSize, settings.overdrawThreshold);
+        }
+    };
+    optimizeList(result.indices);
+    for (auto& lod : result.lodIndices) {
+        optimizeList(lod);
+    }
+
+    vertexCount = OptimizeVertexFetch(result);
+
+    if (outReport) {
+        outReport->vertexCountAfter = vertexCount;
+        outReport->after = AnalyzeVertexCache(result.indices.data(), static_cast<uint32_t>(result.indices.size()),
+                                              vertexCount, settings.cacheSize);
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderTypes.h"
+
+// =============================================================================
+// Mesh Optimizer (vertex cache, overdraw and vertex fetch ordering)
+// =============================================================================
+
+// Reorders a mesh for the GPU without changing what it renders. The pipeline
+// runs in the order the steps depend on each other:
+//
+//   1. DeduplicateVertices    merge bit-identical vertices
+//   2. OptimizeVertexCache    Tipsify triangle order for the post-transform cache
+//   3. OptimizeOverdraw       sort triangle clusters front-to-back-ish
+//   4. OptimizeVertexFetch    renumber vertices in first-use order
+//
+// Every step works on an OptimizedMesh that owns its arrays. LOD index lists
+// are remapped along with LOD 0 and reordered on their own.
+
+struct MeshOptimizeSettings {
+    uint32_t cacheSize = 16;            // Simulated post-transform cache entries (FIFO)
+    bool optimizeOverdraw = true;
+    float overdrawThreshold = 1.05f;    // Cache efficiency a cluster split may cost, 1 = none
+};
+
+// Post-transform cache efficiency of an index list, FIFO simulation
+struct VertexCacheStats {
+    uint32_t transformedVertices = 0;   // Cache misses
+    float acmr = 0.0f;                  // Misses per triangle: 0.5 ideal, 3 worst
+    float atvr = 0.0f;                  // Misses per referenced vertex: 1 ideal
+};
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, uint32_t indexCount,
+                                    uint32_t vertexCount, uint32_t cacheSize = 16);
+
+struct OptimizedMesh {
+    std::vector<VertexAttributes> vertices;
+    std::vector<float> normals;         // Empty when the source had none
+    std::vector<float> uvs;
+    std::vector<uint32_t> indices;
+    std::vector<std::vector<uint32_t>> lodIndices;
+    std::vector<float> lodErrors;
+    bool isOccluder = false;
+
+    // View over the arrays above, valid until the mesh is modified
+    CPUMesh GetCPUMesh();
+
+private:
+    std::vector<CPUMeshLOD> m_lodViews;
+};
+
+struct MeshOptimizeReport {
+    uint32_t vertexCountBefore = 0;
+    uint32_t vertexCountAfter = 0;
+    VertexCacheStats before;            // LOD 0, as authored
+    VertexCacheStats after;
+};
+
+// Copies the mesh into owned arrays
+OptimizedMesh CopyMesh(const CPUMesh& mesh);
+
+// Step 1. Returns the remaining vertex count.
+uint32_t DeduplicateVertices(OptimizedMesh& mesh);
+
+// Step 2, per index list. outClusters (optional) receives the first triangle
+// of every run that Tipsify had to restart from a dead end.
+void OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount,
+                         uint32_t cacheSize, std::vector<uint32_t>* outClusters = nullptr);
+
+// Step 3, per index list already in cache order. Splits the hard clusters
+// further where the split costs at most threshold in ACMR, then orders the
+// clusters so outward-facing ones on the outside of the mesh draw first.
+void OptimizeOverdraw(uint32_t* indices, uint32_t indexCount,
+                      const VertexAttributes* vertices, uint32_t vertexCount,
+                      const std::vector<uint32_t>& hardClusters,
+                      uint32_t cacheSize, float threshold);
+
+// Step 4. Drops vertices no list references, returns the new vertex count.
+uint32_t OptimizeVertexFetch(OptimizedMesh& mesh);
+
+// Runs all four steps
+OptimizedMesh OptimizeMesh(const CPUMesh& mesh, const MeshOptimizeSettings& settings = {},
+                           MeshOptimizeReport* outReport = nullptr);
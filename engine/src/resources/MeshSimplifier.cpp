@@ -0,0 +1,462 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+
+// Symmetric 4x4 error quadric stored as its upper triangle
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+
+    void AddPlane(double nx, double ny, double nz, double d, double weight) {
+        a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz; a03 += weight * nx * d;
+        a11 += weight * ny * ny; a12 += weight * ny * nz; a13 += weight * ny * d;
+        a22 += weight * nz * nz; a23 += weight * nz * d;
+        a33 += weight * d * d;
+    }
+
+    void Add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+    }
+
+    double Evaluate(double x, double y, double z) const {
+        double result = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+                      + a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+                      + a22 * z * z + 2.0 * a23 * z
+                      + a33;
+        return result > 0.0 ? result : 0.0;
+    }
+};
+
+struct Vec3d {
+    double x, y, z;
+};
+
+Vec3d Sub(const Vec3d& a, const Vec3d& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+Vec3d Cross(const Vec3d& a, const Vec3d& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+double Dot(const Vec3d& a, const Vec3d& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+double Length(const Vec3d& a) { return std::sqrt(Dot(a, a)); }
+
+struct PositionKey {
+    uint32_t bits[3];
+    bool operator==(const PositionKey& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const {
+        return (key.bits[0] * 73856093u) ^ (key.bits[1] * 19349663u) ^ (key.bits[2] * 83492791u);
+    }
+};
+
+struct Collapse {
+    double cost;
+    uint32_t from;
+    uint32_t to;
+    uint32_t fromVersion;
+    uint32_t toVersion;
+
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+} // namespace
+
+std::vector<uint32_t> SimplifyMesh(const CPUMesh& mesh, const uint32_t* indices, uint32_t indexCount,
+                                   uint32_t targetIndexCount, float maxError,
+                                   float* outError) {
+    const VertexAttributes* vertices = mesh.vertices;
+    const uint32_t vertexCount = mesh.vertexCount;
+    if (outError) {
+        *outError = 0.0f;
+    }
+
+    std::vector<uint32_t> result;
+    if (!vertices || !indices || vertexCount == 0 || indexCount < 3) {
+        return result;
+    }
+
+    // Weld vertices sharing a position into classes, collapses work on classes
+    std::vector<uint32_t> vertexClass(vertexCount);
+    std::vector<Vec3d> classPosition;
+    std::vector<std::vector<uint32_t>> classVertices;
+    {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> classLookup;
+        classLookup.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            PositionKey key;
+            memcpy(key.bits, vertices[v].position, sizeof(key.bits));
+
+            auto inserted = classLookup.emplace(key, static_cast<uint32_t>(classPosition.size()));
+            if (inserted.second) {
+                const float* p = vertices[v].position;
+                classPosition.push_back({ p[0], p[1], p[2] });
+                classVertices.emplace_back();
+            }
+            vertexClass[v] = inserted.first->second;
+            classVertices[inserted.first->second].push_back(v);
+        }
+    }
+
+    uint32_t classCount = static_cast<uint32_t>(classPosition.size());
+
+    // Squared difference of the attributes the mesh has: color, normal, UV
+    auto attributeDistance = [&](uint32_t a, uint32_t b) {
+        float distance = 0.0f;
+        auto accumulate = [&distance](const float* x, const float* y, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i) {
+                distance += (x[i] - y[i]) * (x[i] - y[i]);
+            }
+        };
+        accumulate(vertices[a].color, vertices[b].color, 3);
+        if (mesh.normals) {
+            accumulate(mesh.normals + a * 3, mesh.normals + b * 3, 3);
+        }
+        if (mesh.uvs) {
+            accumulate(mesh.uvs + a * 2, mesh.uvs + b * 2, 2);
+        }
+        return distance;
+    };
+
+    // Seam classes hold copies with different attributes. They only collapse
+    // into other seam classes, so every corner keeps a copy on its side.
+    std::vector<uint8_t> classIsSeam(classCount, 0);
+    for (uint32_t c = 0; c < classCount; ++c) {
+        const std::vector<uint32_t>& copies = classVertices[c];
+        for (size_t i = 1; i < copies.size() && !classIsSeam[c]; ++i) {
+            classIsSeam[c] = attributeDistance(copies[0], copies[i]) > 0.0f;
+        }
+    }
+
+    // Triangles in class space, original corners kept for the final remap
+    uint32_t triangleCount = indexCount / 3;
+    std::vector<uint32_t> triClass(triangleCount * 3);
+    std::vector<uint32_t> triCorner(triangleCount * 3);
+    std::vector<uint8_t> triAlive(triangleCount, 0);
+    std::vector<std::vector<uint32_t>> classTriangles(classCount);
+    uint32_t liveTriangles = 0;
+
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        bool valid = true;
+        for (uint32_t c = 0; c < 3; ++c) {
+            uint32_t v = indices[t * 3 + c];
+            if (v >= vertexCount) {
+                valid = false;
+                break;
+            }
+            triCorner[t * 3 + c] = v;
+            triClass[t * 3 + c] = vertexClass[v];
+        }
+
+        if (!valid || triClass[t * 3] == triClass[t * 3 + 1] ||
+            triClass[t * 3 + 1] == triClass[t * 3 + 2] || triClass[t * 3] == triClass[t * 3 + 2]) {
+            continue;
+        }
+
+        triAlive[t] = 1;
+        liveTriangles++;
+        for (uint32_t c = 0; c < 3; ++c) {
+            classTriangles[triClass[t * 3 + c]].push_back(t);
+        }
+    }
+
+    // Plane quadrics, area weighted
+    std::vector<Quadric> quadrics(classCount);
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    auto edgeKey = [](uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    };
+
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        if (!triAlive[t]) {
+            continue;
+        }
+
+        const Vec3d& p0 = classPosition[triClass[t * 3 + 0]];
+        const Vec3d& p1 = classPosition[triClass[t * 3 + 1]];
+        const Vec3d& p2 = classPosition[triClass[t * 3 + 2]];
+        Vec3d normal = Cross(Sub(p1, p0), Sub(p2, p0));
+        double area = Length(normal);
+        if (area > 0.0) {
+            Vec3d n = { normal.x / area, normal.y / area, normal.z / area };
+            double d = -Dot(n, p0);
+            for (uint32_t c = 0; c < 3; ++c) {
+                quadrics[triClass[t * 3 + c]].AddPlane(n.x, n.y, n.z, d, area * 0.5);
+            }
+        }
+
+        for (uint32_t c = 0; c < 3; ++c) {
+            edgeUse[edgeKey(triClass[t * 3 + c], triClass[t * 3 + (c + 1) % 3])]++;
+        }
+    }
+
+    // Open borders get a heavily weighted plane perpendicular to the face so
+    // silhouettes survive
+    const double borderWeight = 10.0;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        if (!triAlive[t]) {
+            continue;
+        }
+
+        const Vec3d& p0 = classPosition[triClass[t * 3 + 0]];
+        const Vec3d& p1 = classPosition[triClass[t * 3 + 1]];
+        const Vec3d& p2 = classPosition[triClass[t * 3 + 2]];
+        Vec3d faceNormal = Cross(Sub(p1, p0), Sub(p2, p0));
+
+        for (uint32_t c = 0; c < 3; ++c) {
+            uint32_t a = triClass[t * 3 + c];
+            uint32_t b = triClass[t * 3 + (c + 1) % 3];
+            if (edgeUse[edgeKey(a, b)] != 1) {
+                continue;
+            }
+
+            Vec3d edge = Sub(classPosition[b], classPosition[a]);
+            Vec3d m = Cross(edge, faceNormal);
+            double length = Length(m);
+            if (length <= 0.0) {
+                continue;
+            }
+            m = { m.x / length, m.y / length, m.z / length };
+            double d = -Dot(m, classPosition[a]);
+            double weight = borderWeight * Dot(edge, edge);
+            quadrics[a].AddPlane(m.x, m.y, m.z, d, weight);
+            quadrics[b].AddPlane(m.x, m.y, m.z, d, weight);
+        }
+    }
+
+    // Collapse candidates, stale entries are skipped through version stamps
+    std::vector<uint32_t> version(classCount, 0);
+    std::vector<uint32_t> parent(classCount);
+    std::vector<uint8_t> classAlive(classCount, 1);
+    for (uint32_t c = 0; c < classCount; ++c) {
+        parent[c] = c;
+    }
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+
+    auto pushEdge = [&](uint32_t a, uint32_t b) {
+        Quadric q = quadrics[a];
+        q.Add(quadrics[b]);
+        double costToB = q.Evaluate(classPosition[b].x, classPosition[b].y, classPosition[b].z);
+        double costToA = q.Evaluate(classPosition[a].x, classPosition[a].y, classPosition[a].z);
+        if (classIsSeam[a] != classIsSeam[b]) {
+            if (classIsSeam[b]) {
+                queue.push({ costToB, a, b, version[a], version[b] });
+            } else {
+                queue.push({ costToA, b, a, version[b], version[a] });
+            }
+        } else if (costToB <= costToA) {
+            queue.push({ costToB, a, b, version[a], version[b] });
+        } else {
+            queue.push({ costToA, b, a, version[b], version[a] });
+        }
+    };
+
+    for (const auto& edge : edgeUse) {
+        pushEdge(static_cast<uint32_t>(edge.first >> 32), static_cast<uint32_t>(edge.first & 0xFFFFFFFFu));
+    }
+
+    // Rejects collapses that flip or squash a surviving triangle
+    auto collapseIsValid = [&](uint32_t from, uint32_t to) {
+        const Vec3d& target = classPosition[to];
+        for (uint32_t t : classTriangles[from]) {
+            if (!triAlive[t]) {
+                continue;
+            }
+
+            const uint32_t* tri = &triClass[t * 3];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                continue; // Removed by the collapse
+            }
+
+            Vec3d p[3];
+            Vec3d q[3];
+            for (uint32_t c = 0; c < 3; ++c) {
+                p[c] = classPosition[tri[c]];
+                q[c] = tri[c] == from ? target : p[c];
+            }
+
+            Vec3d before = Cross(Sub(p[1], p[0]), Sub(p[2], p[0]));
+            Vec3d after = Cross(Sub(q[1], q[0]), Sub(q[2], q[0]));
+            double afterLength = Length(after);
+            if (afterLength <= 1e-12 || Dot(before, after) < 0.25 * Length(before) * afterLength) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+    uint32_t targetTriangles = targetIndexCount / 3;
+    double largestCost = 0.0;
+
+    while (liveTriangles > targetTriangles && !queue.empty()) {
+        Collapse collapse = queue.top();
+        queue.pop();
+
+        uint32_t from = collapse.from;
+        uint32_t to = collapse.to;
+        if (!classAlive[from] || !classAlive[to] ||
+            version[from] != collapse.fromVersion || version[to] != collapse.toVersion) {
+            continue;
+        }
+
+        if (collapse.cost > maxCost) {
+            break;
+        }
+
+        if (!collapseIsValid(from, to)) {
+            continue;
+        }
+
+        largestCost = std::max(largestCost, collapse.cost);
+
+        classAlive[from] = 0;
+        parent[from] = to;
+        quadrics[to].Add(quadrics[from]);
+        version[to]++;
+
+        for (uint32_t t : classTriangles[from]) {
+            if (!triAlive[t]) {
+                continue;
+            }
+
+            uint32_t* tri = &triClass[t * 3];
+            for (uint32_t c = 0; c < 3; ++c) {
+                if (tri[c] == from) {
+                    tri[c] = to;
+                }
+            }
+
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                triAlive[t] = 0;
+                liveTriangles--;
+            } else {
+                classTriangles[to].push_back(t);
+            }
+        }
+        classTriangles[from].clear();
+
+        // Compact the survivor's list and requeue its edges
+        auto& toTriangles = classTriangles[to];
+        toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+                                         [&](uint32_t t) { return !triAlive[t]; }),
+                          toTriangles.end());
+        std::sort(toTriangles.begin(), toTriangles.end());
+        toTriangles.erase(std::unique(toTriangles.begin(), toTriangles.end()), toTriangles.end());
+
+        for (uint32_t t : toTriangles) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                uint32_t neighbor = triClass[t * 3 + c];
+                if (neighbor != to) {
+                    pushEdge(to, neighbor);
+                }
+            }
+        }
+    }
+
+    // Map surviving corners back to real vertices. The target class holds one
+    // copy per side of any seam, so take the copy whose color, normal and UV
+    // (those the mesh has) are closest to the original corner's.
+    auto findRoot = [&](uint32_t c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]];
+            c = parent[c];
+        }
+        return c;
+    };
+
+    auto remapCorner = [&](uint32_t vertex) {
+        uint32_t root = findRoot(vertexClass[vertex]);
+        if (root == vertexClass[vertex]) {
+            return vertex;
+        }
+
+        const std::vector<uint32_t>& candidates = classVertices[root];
+        uint32_t best = candidates[0];
+        float bestDistance = attributeDistance(best, vertex);
+        for (size_t i = 1; i < candidates.size() && bestDistance > 0.0f; ++i) {
+            const float distance = attributeDistance(candidates[i], vertex);
+            if (distance < bestDistance) {
+                best = candidates[i];
+                bestDistance = distance;
+            }
+        }
+        return best;
+    };
+
+    result.reserve(static_cast<size_t>(liveTriangles) * 3);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        if (!triAlive[t]) {
+            continue;
+        }
+        for (uint32_t c = 0; c < 3; ++c) {
+            result.push_back(remapCorner(triCorner[t * 3 + c]));
+        }
+    }
+
+    if (outError) {
+        *outError = static_cast<float>(std::sqrt(largestCost));
+    }
+    return result;
+}
+
+MeshLODChain BuildMeshLODChain(const CPUMesh& mesh, const MeshLODSettings& settings) {
+    MeshLODChain chain;
+    if (!mesh.vertices || !mesh.indices || mesh.vertexCount == 0 || mesh.indexCount < 3) {
+        return chain;
+    }
+
+    // Error budget is relative to the mesh size
+    float minPos[3], maxPos[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        minPos[axis] = maxPos[axis] = mesh.vertices[0].position[axis];
+    }
+    for (uint32_t v = 1; v < mesh.vertexCount; ++v) {
+        for (int axis = 0; axis < 3; ++axis) {
+            minPos[axis] = std::min(minPos[axis], mesh.vertices[v].position[axis]);
+            maxPos[axis] = std::max(maxPos[axis], mesh.vertices[v].position[axis]);
+        }
+    }
+    float dx = maxPos[0] - minPos[0];
+    float dy = maxPos[1] - minPos[1];
+    float dz = maxPos[2] - minPos[2];
+    float diagonal = std::sqrt(dx * dx + dy * dy + dz * dz);
+    float maxError = settings.maxError * diagonal;
+
+    chain.lodIndices.reserve(settings.lodCount);
+    const uint32_t* sourceIndices = mesh.indices;
+    uint32_t sourceCount = mesh.indexCount;
+
+    for (uint32_t lod = 0; lod < settings.lodCount && lod + 1 < MAX_MESH_LODS; ++lod) {
+        uint32_t target = static_cast<uint32_t>(sourceCount * settings.reductionPerLOD);
+        target -= target % 3;
+
+        float error = 0.0f;
+        std::vector<uint32_t> lodIndices = SimplifyMesh(mesh, sourceIndices, sourceCount,
+                                                        target, maxError, &error);
+
+        // Not worth a LOD if it barely reduced anything
+        if (lodIndices.empty() || lodIndices.size() > sourceCount * settings.minReduction) {
+            break;
+        }
+
+        float previousError = chain.lodErrors.empty() ? 0.0f : chain.lodErrors.back();
+        chain.lodErrors.push_back(std::max(error, previousError));
+        chain.lodIndices.push_back(std::move(lodIndices));
+
+        sourceIndices = chain.lodIndices.back().data();
+        sourceCount = static_cast<uint32_t>(chain.lodIndices.back().size());
+    }
+
+    return chain;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderTypes.h"
+
+// =============================================================================
+// Mesh Simplifier (quadric error metric edge collapse)
+// =============================================================================
+
+// Simplification never creates vertices: every output index references one of
+// the input vertices, so all LODs of a mesh share a single vertex range.
+// Vertices with identical positions (attribute seams) are collapsed together,
+// and seams only collapse into other seam vertices so UV and normal splits
+// stay where they are.
+
+struct MeshLODSettings {
+    uint32_t lodCount = 4;              // LODs to build beyond LOD 0
+    float reductionPerLOD = 0.5f;       // Target index count ratio between consecutive LODs
+    float maxError = 0.05f;             // Max collapse error, relative to the bounds diagonal
+    float minReduction = 0.9f;          // Stop the chain once a LOD keeps more than this ratio
+};
+
+struct MeshLODChain {
+    // LOD 1..n index lists, each referencing the LOD 0 vertices
+    std::vector<std::vector<uint32_t>> lodIndices;
+    // Object-space error of each LOD (same count as lodIndices)
+    std::vector<float> lodErrors;
+};
+
+// Collapses edges of indices (over mesh's vertices) until at most
+// targetIndexCount indices remain or the next collapse would exceed maxError
+// (absolute, object space). Returns the new index list; outError receives
+// the largest error introduced. A corner moved onto a seam takes the copy
+// whose color, normal and UV (those the mesh has) are closest to its own.
+std::vector<uint32_t> SimplifyMesh(const CPUMesh& mesh, const uint32_t* indices, uint32_t indexCount,
+                                   uint32_t targetIndexCount, float maxError,
+                                   float* outError = nullptr);
+
+// Builds a progressive LOD chain, each LOD simplified from the previous one
+MeshLODChain BuildMeshLODChain(const CPUMesh& mesh, const MeshLODSettings& settings = {});
@@ -0,0 +1,396 @@
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 Sub(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline float Length(const Vec3& a) { return std::sqrt(Dot(a, a)); }
+
+inline Vec3 Cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline Vec3 Normalize(const Vec3& a) {
+    const float length = Length(a);
+    return length > 0.0f ? Vec3{ a.x / length, a.y / length, a.z / length } : Vec3{ 0.0f, 0.0f, 0.0f };
+}
+
+inline Vec3 Position(const VertexAttributes* vertices, uint32_t index) {
+    const float* p = vertices[index].position;
+    return { p[0], p[1], p[2] };
+}
+
+// Facing direction of a triangle. Front faces are clockwise on screen
+// (D3D default) under the right-handed projection, so clockwise seen from
+// the front in object space too.
+inline Vec3 TriangleNormal(const Vec3& a, const Vec3& b, const Vec3& c) {
+    return Normalize(Cross(Sub(c, a), Sub(b, a)));
+}
+
+// Meshlet being grown, local vertex slots of mesh vertices live in localIndex
+struct MeshletState {
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+    Vec3 centroidSum = { 0.0f, 0.0f, 0.0f };
+    Vec3 normalSum = { 0.0f, 0.0f, 0.0f };
+    Vec3 boundsMin = { 0.0f, 0.0f, 0.0f };
+    Vec3 boundsMax = { 0.0f, 0.0f, 0.0f };
+
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>(triangles.size() / 3); }
+};
+
+} // namespace
+
+// =============================================================================
+// Building
+// =============================================================================
+
+MeshletData BuildMeshlets(const VertexAttributes* vertices, uint32_t vertexCount,
+                          const uint32_t* indices, uint32_t indexCount,
+                          const MeshletBuildSettings& settings) {
+    MeshletData data;
+    const uint32_t triangleCount = indexCount / 3;
+    if (!vertices || !indices || vertexCount == 0 || triangleCount == 0) {
+        return data;
+    }
+    for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+        if (indices[i] >= vertexCount) {
+            return data;
+        }
+    }
+
+    // Local indices are bytes
+    const uint32_t maxVertices = std::min(std::max(settings.maxVertices, 3u), 256u);
+    const uint32_t maxTriangles = std::max(settings.maxTriangles, 1u);
+
+    // Triangles around each vertex: adjacentTriangles[adjacencyOffsets[v] .. adjacencyOffsets[v + 1])
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<uint32_t> adjacentTriangles(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+            adjacentTriangles[cursor[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<Vec3> centroids(triangleCount);
+    std::vector<Vec3> normals(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        const Vec3 a = Position(vertices, indices[t * 3 + 0]);
+        const Vec3 b = Position(vertices, indices[t * 3 + 1]);
+        const Vec3 c = Position(vertices, indices[t * 3 + 2]);
+        centroids[t] = { (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f };
+        normals[t] = TriangleNormal(a, b, c);
+    }
+
+    // Unemitted triangles per vertex. Vertices close to finished make good
+    // seeds: starting there leaves no stragglers for later meshlets.
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<int16_t> localIndex(vertexCount, -1);
+    std::vector<uint32_t> previousVertices;
+    MeshletState meshlet;
+    uint32_t seedCursor = 0;
+
+    data.meshlets.reserve(triangleCount / maxTriangles + 1);
+    data.vertexIndices.reserve(triangleCount);
+    data.triangles.reserve(triangleCount * 3);
+
+    auto countNewVertices = [&](uint32_t triangle) {
+        uint32_t count = 0;
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const uint32_t vertex = indices[triangle * 3 + corner];
+            // A triangle may repeat a vertex, count it once
+            bool repeated = false;
+            for (uint32_t previous = 0; previous < corner; ++previous) {
+                repeated |= indices[triangle * 3 + previous] == vertex;
+            }
+            count += (localIndex[vertex] < 0 && !repeated) ? 1 : 0;
+        }
+        return count;
+    };
+
+    auto addTriangle = [&](uint32_t triangle) {
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const uint32_t vertex = indices[triangle * 3 + corner];
+            if (localIndex[vertex] < 0) {
+                localIndex[vertex] = static_cast<int16_t>(meshlet.vertices.size());
+                meshlet.vertices.push_back(vertex);
+
+                const Vec3 p = Position(vertices, vertex);
+                if (meshlet.vertices.size() == 1) {
+                    meshlet.boundsMin = p;
+                    meshlet.boundsMax = p;
+                } else {
+                    meshlet.boundsMin = { std::min(meshlet.boundsMin.x, p.x), std::min(meshlet.boundsMin.y, p.y), std::min(meshlet.boundsMin.z, p.z) };
+                    meshlet.boundsMax = { std::max(meshlet.boundsMax.x, p.x), std::max(meshlet.boundsMax.y, p.y), std::max(meshlet.boundsMax.z, p.z) };
+                }
+            }
+            meshlet.triangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+            liveTriangles[vertex]--;
+        }
+
+        const Vec3& centroid = centroids[triangle];
+        const Vec3& normal = normals[triangle];
+        meshlet.centroidSum = { meshlet.centroidSum.x + centroid.x, meshlet.centroidSum.y + centroid.y, meshlet.centroidSum.z + centroid.z };
+        meshlet.normalSum = { meshlet.normalSum.x + normal.x, meshlet.normalSum.y + normal.y, meshlet.normalSum.z + normal.z };
+        emitted[triangle] = 1;
+    };
+
+    auto flushMeshlet = [&]() {
+        if (meshlet.triangles.empty()) {
+            return;
+        }
+
+        Meshlet out;
+        out.vertexOffset = static_cast<uint32_t>(data.vertexIndices.size());
+        out.triangleOffset = static_cast<uint32_t>(data.triangles.size());
+        out.vertexCount = static_cast<uint32_t>(meshlet.vertices.size());
+        out.triangleCount = meshlet.GetTriangleCount();
+
+        data.vertexIndices.insert(data.vertexIndices.end(), meshlet.vertices.begin(), meshlet.vertices.end());
+        data.triangles.insert(data.triangles.end(), meshlet.triangles.begin(), meshlet.triangles.end());
+        data.meshlets.push_back(out);
+        data.bounds.push_back(ComputeMeshletBounds(vertices, meshlet.vertices.data(),
+                                                   meshlet.triangles.data(), out.triangleCount));
+
+        for (uint32_t vertex : meshlet.vertices) {
+            localIndex[vertex] = -1;
+        }
+        previousVertices.swap(meshlet.vertices);
+        meshlet = MeshletState();
+    };
+
+    // Seed next to the previous meshlet where the fewest triangles remain
+    // around the corners, falling back to input order
+    auto pickSeed = [&]() {
+        uint32_t seed = UINT32_MAX;
+        uint32_t seedLive = UINT32_MAX;
+        for (uint32_t vertex : previousVertices) {
+            for (uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i) {
+                const uint32_t triangle = adjacentTriangles[i];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                const uint32_t live = liveTriangles[indices[triangle * 3 + 0]] +
+                                      liveTriangles[indices[triangle * 3 + 1]] +
+                                      liveTriangles[indices[triangle * 3 + 2]];
+                if (live < seedLive) {
+                    seed = triangle;
+                    seedLive = live;
+                }
+            }
+        }
+        if (seed == UINT32_MAX) {
+            while (emitted[seedCursor]) {
+                seedCursor++;
+            }
+            seed = seedCursor;
+        }
+        return seed;
+    };
+
+    uint32_t remaining = triangleCount;
+    while (remaining > 0) {
+        if (meshlet.triangles.empty()) {
+            addTriangle(pickSeed());
+            remaining--;
+            continue;
+        }
+
+        // Best unemitted triangle sharing a vertex with the meshlet. Priority
+        // goes to triangles adding no vertex, then ones finishing off a
+        // vertex (its last live triangle, which would otherwise be left
+        // stranded), then by new vertex count. Ties go to the lowest growth
+        // cost: distance from the meshlet's centroid, scaled up the further
+        // the triangle turns from the meshlet's facing.
+        const float invCount = 1.0f / static_cast<float>(meshlet.GetTriangleCount());
+        const Vec3 meshletCentroid = { meshlet.centroidSum.x * invCount, meshlet.centroidSum.y * invCount, meshlet.centroidSum.z * invCount };
+        const Vec3 meshletAxis = Normalize(meshlet.normalSum);
+        auto growthCost = [&](uint32_t triangle) {
+            const float distance = Length(Sub(centroids[triangle], meshletCentroid));
+            const float spread = 1.0f - Dot(normals[triangle], meshletAxis);
+            return distance * (1.0f + settings.coneWeight * spread);
+        };
+
+        uint32_t best = UINT32_MAX;
+        uint32_t bestPriority = UINT32_MAX;
+        float bestCost = std::numeric_limits<float>::max();
+        const uint32_t vertexBudget = maxVertices - static_cast<uint32_t>(meshlet.vertices.size());
+        for (uint32_t vertex : meshlet.vertices) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            for (uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i) {
+                const uint32_t triangle = adjacentTriangles[i];
+                if (emitted[triangle]) {
+                    continue;
+                }
+                const uint32_t newVertices = countNewVertices(triangle);
+                if (newVertices > vertexBudget) {
+                    continue;
+                }
+                const bool finishesVertex = liveTriangles[indices[triangle * 3 + 0]] == 1 ||
+                                            liveTriangles[indices[triangle * 3 + 1]] == 1 ||
+                                            liveTriangles[indices[triangle * 3 + 2]] == 1;
+                const uint32_t priority = newVertices == 0 ? 0 : (finishesVertex ? 1 : 1 + newVertices);
+                if (priority > bestPriority) {
+                    continue;
+                }
+                const float cost = growthCost(triangle);
+                if (priority < bestPriority || cost < bestCost) {
+                    best = triangle;
+                    bestPriority = priority;
+                    bestCost = cost;
+                }
+            }
+        }
+
+        // Disconnected piece: take the next triangle in input order if it
+        // fits and lands near the meshlet, so small parts share meshlets
+        // without stretching their bounds far
+        if (best == UINT32_MAX) {
+            while (seedCursor < triangleCount && emitted[seedCursor]) {
+                seedCursor++;
+            }
+            if (seedCursor < triangleCount && countNewVertices(seedCursor) <= vertexBudget) {
+                const Vec3 extent = Sub(meshlet.boundsMax, meshlet.boundsMin);
+                const Vec3& centroid = centroids[seedCursor];
+                const bool nearby =
+                    centroid.x >= meshlet.boundsMin.x - extent.x * 0.5f && centroid.x <= meshlet.boundsMax.x + extent.x * 0.5f &&
+                    centroid.y >= meshlet.boundsMin.y - extent.y * 0.5f && centroid.y <= meshlet.boundsMax.y + extent.y * 0.5f &&
+                    centroid.z >= meshlet.boundsMin.z - extent.z * 0.5f && centroid.z <= meshlet.boundsMax.z + extent.z * 0.5f;
+                if (nearby) {
+                    best = seedCursor;
+                }
+            }
+        }
+
+        if (best == UINT32_MAX) {
+            flushMeshlet();
+            continue;
+        }
+
+        addTriangle(best);
+        remaining--;
+        if (meshlet.GetTriangleCount() >= maxTriangles) {
+            flushMeshlet();
+        }
+    }
+    flushMeshlet();
+
+    return data;
+}
+
+// =============================================================================
+// Bounds
+// =============================================================================
+
+MeshletBounds ComputeMeshletBounds(const VertexAttributes* vertices, const uint32_t* vertexIndices,
+                                   const uint8_t* triangles, uint32_t triangleCount) {
+    MeshletBounds bounds;
+    if (triangleCount == 0) {
+        return bounds;
+    }
+
+    // Vertices of the meshlet are exactly the ones its triangles reference
+    uint32_t vertexCount = 0;
+    for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+        vertexCount = std::max(vertexCount, static_cast<uint32_t>(triangles[i]) + 1);
+    }
+
+    // Ritter sphere: start from the most distant pair among the axis
+    // extremes, then grow to take in every vertex
+    uint32_t minVertex[3] = { 0, 0, 0 };
+    uint32_t maxVertex[3] = { 0, 0, 0 };
+    for (uint32_t i = 1; i < vertexCount; ++i) {
+        const float* p = vertices[vertexIndices[i]].position;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (p[axis] < vertices[vertexIndices[minVertex[axis]]].position[axis]) minVertex[axis] = i;
+            if (p[axis] > vertices[vertexIndices[maxVertex[axis]]].position[axis]) maxVertex[axis] = i;
+        }
+    }
+
+    int spanAxis = 0;
+    float spanDistance = -1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const Vec3 d = Sub(Position(vertices, vertexIndices[maxVertex[axis]]), Position(vertices, vertexIndices[minVertex[axis]]));
+        if (Dot(d, d) > spanDistance) {
+            spanDistance = Dot(d, d);
+            spanAxis = axis;
+        }
+    }
+
+    const Vec3 p0 = Position(vertices, vertexIndices[minVertex[spanAxis]]);
+    const Vec3 p1 = Position(vertices, vertexIndices[maxVertex[spanAxis]]);
+    Vec3 center = { (p0.x + p1.x) * 0.5f, (p0.y + p1.y) * 0.5f, (p0.z + p1.z) * 0.5f };
+    float radius = std::sqrt(spanDistance) * 0.5f;
+
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const Vec3 p = Position(vertices, vertexIndices[i]);
+        const float distance = Length(Sub(p, center));
+        if (distance > radius) {
+            const float grown = (radius + distance) * 0.5f;
+            const float shift = (grown - radius) / distance;
+            center = { center.x + (p.x - center.x) * shift, center.y + (p.y - center.y) * shift, center.z + (p.z - center.z) * shift };
+            radius = grown;
+        }
+    }
+
+    bounds.center[0] = center.x;
+    bounds.center[1] = center.y;
+    bounds.center[2] = center.z;
+    bounds.radius = radius;
+
+    // Normal cone around the mean facing direction; degenerate triangles
+    // are never rasterized and don't constrain it
+    Vec3 normalSum = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        const Vec3 normal = TriangleNormal(Position(vertices, vertexIndices[triangles[t * 3 + 0]]),
+                                           Position(vertices, vertexIndices[triangles[t * 3 + 1]]),
+                                           Position(vertices, vertexIndices[triangles[t * 3 + 2]]));
+        normalSum = { normalSum.x + normal.x, normalSum.y + normal.y, normalSum.z + normal.z };
+    }
+
+    const Vec3 axis = Normalize(normalSum);
+    if (Dot(axis, axis) == 0.0f) {
+        return bounds;
+    }
+
+    float minDot = 1.0f;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        const Vec3 normal = TriangleNormal(Position(vertices, vertexIndices[triangles[t * 3 + 0]]),
+                                           Position(vertices, vertexIndices[triangles[t * 3 + 1]]),
+                                           Position(vertices, vertexIndices[triangles[t * 3 + 2]]));
+        if (Dot(normal, normal) > 0.0f) {
+            minDot = std::min(minDot, Dot(normal, axis));
+        }
+    }
+
+    bounds.coneAxis[0] = axis.x;
+    bounds.coneAxis[1] = axis.y;
+    bounds.coneAxis[2] = axis.z;
+
+    // Past ~84 degrees the cone can't pass the test from any useful position
+    if (minDot > 0.1f) {
+        bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+    return bounds;
+}
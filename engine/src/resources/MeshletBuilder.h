@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderTypes.h"
+
+// =============================================================================
+// Meshlet Builder
+// =============================================================================
+
+// Partitions an index list into meshlets of at most maxVertices unique
+// vertices and maxTriangles triangles. Each meshlet grows greedily from a
+// seed triangle through shared vertices, preferring triangles that add no
+// new vertex, lie close to the meshlet and face the same way, so clusters
+// come out compact with tight bounds and narrow normal cones. Seeds follow
+// the input order, which keeps cache-optimized meshes cache friendly.
+//
+// Pure CPU, no graphics API involved.
+
+struct MeshletBuildSettings {
+    uint32_t maxVertices = MAX_MESHLET_VERTICES;
+    uint32_t maxTriangles = MAX_MESHLET_TRIANGLES;
+    float coneWeight = 0.5f;            // 0 = spatial only, higher trades compactness for cone culling
+};
+
+// Offsets in the meshlets are relative to the arrays here
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;  // Parallel to meshlets
+    std::vector<uint32_t> vertexIndices;
+    std::vector<uint8_t> triangles;     // Three local vertex indices per triangle
+};
+
+MeshletData BuildMeshlets(const VertexAttributes* vertices, uint32_t vertexCount,
+                          const uint32_t* indices, uint32_t indexCount,
+                          const MeshletBuildSettings& settings = {});
+
+// Bounding sphere and normal cone of one meshlet
+MeshletBounds ComputeMeshletBounds(const VertexAttributes* vertices, const uint32_t* vertexIndices,
+                                   const uint8_t* triangles, uint32_t triangleCount);
@@ -0,0 +1,93 @@
+#include "MeshletPool.h"
+#include <cstring>
+
+MeshletPool::MeshletPool(const Config& config)
+    : m_config(config)
+{
+    m_meshlets.resize(config.maxMeshlets);
+    m_bounds.resize(config.maxMeshlets);
+    m_vertexIndices.resize(config.maxVertexIndices);
+
+    // Triangle ranges start on 4 bytes for aligned loads on the GPU
+    const size_t triangleBytes = (static_cast<size_t>(config.maxTriangles) * 3 + 3) & ~size_t(3);
+    m_triangles.resize(triangleBytes);
+
+    m_meshletAllocator = std::make_unique<TLSFAllocator>(m_meshlets.size() * sizeof(Meshlet), sizeof(Meshlet));
+    m_vertexIndexAllocator = std::make_unique<TLSFAllocator>(m_vertexIndices.size() * sizeof(uint32_t), sizeof(uint32_t));
+    m_triangleAllocator = std::make_unique<TLSFAllocator>(triangleBytes, 4);
+
+    m_stats.bytesTotal = m_meshlets.size() * (sizeof(Meshlet) + sizeof(MeshletBounds)) +
+                         m_vertexIndices.size() * sizeof(uint32_t) + triangleBytes;
+}
+
+MeshletPool::Range MeshletPool::Add(const MeshletData& data) {
+    Range range;
+    if (data.meshlets.empty()) {
+        return range;
+    }
+
+    const uint32_t meshletCount = static_cast<uint32_t>(data.meshlets.size());
+    const uint32_t vertexIndexCount = static_cast<uint32_t>(data.vertexIndices.size());
+    const uint32_t triangleCount = static_cast<uint32_t>(data.triangles.size() / 3);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint32_t meshletByteOffset = m_meshletAllocator->Allocate(meshletCount * sizeof(Meshlet));
+        const uint32_t vertexByteOffset = m_vertexIndexAllocator->Allocate(vertexIndexCount * sizeof(uint32_t));
+        const uint32_t triangleByteOffset = m_triangleAllocator->Allocate(data.triangles.size());
+        if (meshletByteOffset == UINT32_MAX || vertexByteOffset == UINT32_MAX || triangleByteOffset == UINT32_MAX) {
+            if (meshletByteOffset != UINT32_MAX) m_meshletAllocator->Free(meshletByteOffset);
+            if (vertexByteOffset != UINT32_MAX) m_vertexIndexAllocator->Free(vertexByteOffset);
+            if (triangleByteOffset != UINT32_MAX) m_triangleAllocator->Free(triangleByteOffset);
+            return range;
+        }
+
+        range.meshletOffset = meshletByteOffset / sizeof(Meshlet);
+        range.meshletCount = meshletCount;
+        range.vertexIndexOffset = vertexByteOffset / sizeof(uint32_t);
+        range.vertexIndexCount = vertexIndexCount;
+        range.triangleByteOffset = triangleByteOffset;
+        range.triangleCount = triangleCount;
+
+        m_stats.meshlets += meshletCount;
+        m_stats.vertexIndices += vertexIndexCount;
+        m_stats.triangles += triangleCount;
+    }
+
+    // The ranges are ours now, fill them outside the lock
+    for (uint32_t i = 0; i < meshletCount; ++i) {
+        Meshlet meshlet = data.meshlets[i];
+        meshlet.vertexOffset += range.vertexIndexOffset;
+        meshlet.triangleOffset += range.triangleByteOffset;
+        m_meshlets[range.meshletOffset + i] = meshlet;
+        m_bounds[range.meshletOffset + i] = data.bounds[i];
+    }
+    memcpy(&m_vertexIndices[range.vertexIndexOffset], data.vertexIndices.data(), vertexIndexCount * sizeof(uint32_t));
+    memcpy(&m_triangles[range.triangleByteOffset], data.triangles.data(), data.triangles.size());
+
+    return range;
+}
+
+void MeshletPool::Remove(const Range& range) {
+    if (!range.IsValid()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_meshletAllocator->Free(range.meshletOffset * sizeof(Meshlet));
+    m_vertexIndexAllocator->Free(range.vertexIndexOffset * sizeof(uint32_t));
+    m_triangleAllocator->Free(range.triangleByteOffset);
+
+    m_stats.meshlets -= range.meshletCount;
+    m_stats.vertexIndices -= range.vertexIndexCount;
+    m_stats.triangles -= range.triangleCount;
+}
+
+MeshletPool::Statistics MeshletPool::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics stats = m_stats;
+    stats.bytesUsed = static_cast<size_t>(stats.meshlets) * (sizeof(Meshlet) + sizeof(MeshletBounds)) +
+                      static_cast<size_t>(stats.vertexIndices) * sizeof(uint32_t) +
+                      static_cast<size_t>(stats.triangles) * 3;
+    return stats;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "RenderTypes.h"
+#include "MeshletBuilder.h"
+#include "TLSFAllocator.h"
+
+// =============================================================================
+// Meshlet Pool
+// =============================================================================
+
+// Fixed-capacity home for the meshlets of every mesh, parallel to the vertex
+// and index buffers: meshlet records and bounds side by side, plus the
+// vertex index and triangle arrays they point into. Offsets stored in the
+// records are pool offsets, so the arrays can be bound as they are.
+//
+// Ranges come from TLSF allocators. Add may run on any thread; the arrays
+// never reallocate, so readers of other meshes are unaffected.
+class MeshletPool {
+public:
+    struct Config {
+        uint32_t maxMeshlets = 64 * 1024;
+        uint32_t maxVertexIndices = 4 * 1024 * 1024;
+        uint32_t maxTriangles = 8 * 1024 * 1024;
+    };
+
+    // Where one mesh's meshlets live
+    struct Range {
+        uint32_t meshletOffset = UINT32_MAX;
+        uint32_t meshletCount = 0;
+        uint32_t vertexIndexOffset = UINT32_MAX;
+        uint32_t vertexIndexCount = 0;
+        uint32_t triangleByteOffset = UINT32_MAX;
+        uint32_t triangleCount = 0;
+
+        bool IsValid() const { return meshletOffset != UINT32_MAX; }
+    };
+
+    struct Statistics {
+        uint32_t meshlets = 0;
+        uint32_t vertexIndices = 0;
+        uint32_t triangles = 0;
+        size_t bytesUsed = 0;
+        size_t bytesTotal = 0;
+    };
+
+    explicit MeshletPool(const Config& config);
+
+    // Prevent copying
+    MeshletPool(const MeshletPool&) = delete;
+    MeshletPool& operator=(const MeshletPool&) = delete;
+
+    // Copies the meshlets in, rebasing their offsets. Invalid range when full.
+    Range Add(const MeshletData& data);
+    void Remove(const Range& range);
+
+    const Meshlet* GetMeshlets() const { return m_meshlets.data(); }
+    const MeshletBounds* GetBounds() const { return m_bounds.data(); }
+    const uint32_t* GetVertexIndices() const { return m_vertexIndices.data(); }
+    const uint8_t* GetTriangles() const { return m_triangles.data(); }
+
+    Statistics GetStatistics() const;
+
+private:
+    Config m_config;
+
+    std::vector<Meshlet> m_meshlets;
+    std::vector<MeshletBounds> m_bounds;
+    std::vector<uint32_t> m_vertexIndices;
+    std::vector<uint8_t> m_triangles;
+
+    mutable std::mutex m_mutex;
+    std::unique_ptr<TLSFAllocator> m_meshletAllocator;
+    std::unique_ptr<TLSFAllocator> m_vertexIndexAllocator;
+    std::unique_ptr<TLSFAllocator> m_triangleAllocator;
+    Statistics m_stats;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 // =============================================================================
 // Constants
@@ -20,6 +21,11 @@ constexpr MaterialHandle INVALID_MATERIAL_HANDLE = 0;
 
 constexpr uint32_t VERTEX_SIZE = 6;  // 6 floats per vertex
 
+constexpr uint32_t MAX_MESH_LODS = 5;  // LOD 0 plus up to four simplified levels
+
+constexpr uint32_t MAX_MESHLET_VERTICES = 64;    // Mesh shader output limits per cluster
+constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
 // =============================================================================
 // Vertex Formats
 // =============================================================================
@@ -36,22 +42,162 @@ static_assert(sizeof(VertexAttributes) == 6 * sizeof(float), "VertexAttributes s
 // Mesh System
 // =============================================================================
 
+// Simplified index list over the same vertices as LOD 0
+struct CPUMeshLOD {
+    const uint32_t* indices = nullptr;
+    uint32_t indexCount = 0;
+    float error = 0.0f;     // Object-space error, informational
+};
+
 struct CPUMesh {
     const VertexAttributes* vertices = nullptr;
     const uint32_t* indices = nullptr;
     uint32_t vertexCount = 0;
     uint32_t indexCount = 0;
+
+    // Optional precomputed LOD 1..n (offline cook). When absent GeometryManager
+    // can generate them at import, see GeometryManager::Config::autoLODCount.
+    const CPUMeshLOD* lods = nullptr;
+    uint32_t lodCount = 0;
+
+    // Optional extra attributes, encoded when the vertex layout has them
+    const float* normals = nullptr;     // xyz per vertex
+    const float* uvs = nullptr;         // uv per vertex
+
+    // Keep a CPU copy of positions/indices for software occlusion culling
+    bool isOccluder = false;
+};
+
+// Width of a mesh's indices. Both widths share the index buffer, a view of
+// the matching format must be bound to draw.
+enum class IndexFormat : uint32_t {
+    Uint16,
+    Uint32
+};
+
+inline uint32_t GetIndexSize(IndexFormat format) {
+    return format == IndexFormat::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// Writable staging memory for a mesh reserved by GeometryManager::BeginMeshWrite.
+// Points into the mapped upload heap, which is write-combined: fill it
+// sequentially and never read it back. Vertices are in the manager's vertex
+// layout (see EncodeVertices), quantized ones relative to the bounds later
+// passed to CommitMesh. Indices are indexFormat wide; WriteSpanIndices
+// narrows 32-bit source indices on the way in.
+struct MeshWriteSpan {
+    MeshHandle handle = INVALID_MESH_HANDLE;
+    uint8_t* vertices = nullptr;
+    void* indices = nullptr;
+    IndexFormat indexFormat = IndexFormat::Uint32;
+    uint32_t vertexCount = 0;
+    uint32_t vertexStride = 0;
+    uint32_t indexCount = 0;
+
+    bool IsValid() const { return vertices != nullptr; }
+};
+
+// Object-space axis aligned bounds, computed at mesh creation
+struct MeshBounds {
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+// CPU-side geometry retained for meshes created with isOccluder
+struct OccluderGeometry {
+    std::vector<float> positions;   // xyz triplets
+    std::vector<uint32_t> indices;
+};
+
+// Object-space position = bias + stored position * scale. Identity for float
+// positions, the mesh AABB for quantized ones.
+struct MeshDecode {
+    float scale[3] = { 1.0f, 1.0f, 1.0f };
+    float bias[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+// Pixel format of texture data. BC formats store 4x4 pixel blocks; _SRGB
+// variants are decoded to linear when sampled. The renderer maps these to
+// the matching DXGI_FORMAT_*_UNORM(_SRGB).
+enum class TextureFormat : uint32_t {
+    RGBA8,
+    RGBA8_SRGB,
+    BC1,
+    BC1_SRGB,
+    BC3,
+    BC3_SRGB,
+    BC5,
+    BC7,
+    BC7_SRGB
+};
+
+inline bool IsBlockCompressed(TextureFormat format) {
+    return format != TextureFormat::RGBA8 && format != TextureFormat::RGBA8_SRGB;
+}
+
+// Bytes per 4x4 block, or per pixel for RGBA8
+inline uint32_t GetTextureElementSize(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC1_SRGB:
+            return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC3_SRGB:
+        case TextureFormat::BC5:
+        case TextureFormat::BC7:
+        case TextureFormat::BC7_SRGB:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+// Backend-neutral index buffer view
+struct IndexBufferBinding {
+    uint64_t gpuAddress = 0;
+    uint32_t sizeInBytes = 0;
+    IndexFormat format = IndexFormat::Uint32;
 };
 
 struct MeshView {
     uint32_t vertexOffset = 0;
     uint32_t vertexCount = 0;
-    uint32_t indexOffset = 0;
+    uint32_t indexOffset = 0;       // In indices of indexFormat
     uint32_t indexCount = 0;
+    IndexFormat indexFormat = IndexFormat::Uint32;
+};
+
+// Cluster of LOD 0 triangles for mesh shaders and cluster culling. Offsets
+// index the meshlet pool: vertexOffset into the vertex index array (indices
+// relative to the mesh's vertex range), triangleOffset into the byte array of
+// local triangles, three uint8 corners each.
+struct Meshlet {
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+};
+
+// Object-space culling data of a meshlet. Every triangle faces away from a
+// camera at p when dot(center - p, coneAxis) >= coneCutoff * |center - p| + radius;
+// coneCutoff is 1 when the normals spread too far to ever pass.
+struct MeshletBounds {
+    float center[3] = { 0.0f, 0.0f, 0.0f };
+    float radius = 0.0f;
+    float coneAxis[3] = { 0.0f, 0.0f, 1.0f };
+    float coneCutoff = 1.0f;
+};
+
+// A mesh's meshlets and their culling bounds, parallel arrays
+struct MeshletView {
+    const Meshlet* meshlets = nullptr;
+    const MeshletBounds* bounds = nullptr;
+    uint32_t meshletCount = 0;
 };
 
 enum class MeshState {
     PendingUpload,
+    Uploading,      // Copy submitted on the copy queue, not yet complete
     Ready,
     PendingDeletion
 };
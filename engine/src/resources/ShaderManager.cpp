@@ -20,7 +20,7 @@ ShaderHandle ShaderManager::CreateShaderFromFile(const std::string& filePath,
     std::string cacheFileName = GenerateCacheFileName(filePath, entryPoint, target);
     std::string fullCachePath = m_cacheDir + cacheFileName;
 
-    printf("ShaderManager: File exists? %s\n", std::filesystem::exists(fullSourcePath) ? "YES" : "NO");
+    printf("ShaderManager: File exists? %s\n", FileReader::Exists(fullSourcePath) ? "YES" : "NO");
 
     // Create cache info
     ShaderCacheInfo cacheInfo;
@@ -206,20 +206,21 @@ std::string ShaderManager::GenerateCacheFileName(const std::string& filePath,
 }
 
 bool ShaderManager::LoadFromCache(const std::string& cacheFile, Shader* shader, const std::string& debugName) {
-    auto data = FileReader::ReadFileBytes(cacheFile);
-    if (data.empty()) {
+    // Map the cache file (or its pack entry) so the bytes are copied once, straight into the blob
+    FileView data = FileReader::OpenView(cacheFile);
+    if (!data.IsValid() || data.GetSize() == 0) {
         return false;
     }
 
     // Create a blob from the cached data
     ComPtr<ID3DBlob> blob;
-    HRESULT hr = D3DCreateBlob(data.size(), &blob);
+    HRESULT hr = D3DCreateBlob(data.GetSize(), &blob);
     if (FAILED(hr)) {
         printf("ShaderManager: Failed to create blob for cached shader %s\n", debugName.c_str());
         return false;
     }
 
-    memcpy(blob->GetBufferPointer(), data.data(), data.size());
+    memcpy(blob->GetBufferPointer(), data.GetData(), data.GetSize());
 
     // Create shader directly from blob (bypass compilation)
     return shader->InitializeFromBlob(blob.Get(), debugName);
@@ -243,8 +244,9 @@ bool ShaderManager::SaveToCache(const std::string& cacheFile, const Shader* shad
 
 bool ShaderManager::IsCacheValid(const ShaderCacheInfo& cacheInfo) {
     // Cache is valid if:
-    // 1. Cache file exists
-    // 2. Cache file is newer than source file
-    return std::filesystem::exists(cacheInfo.cacheFile) &&
+    // 1. Cache file exists, loose or packed
+    // 2. Cache file is newer than source file (packed files have no time, a
+    //    loose source overrides a packed cache)
+    return FileReader::Exists(cacheInfo.cacheFile) &&
            cacheInfo.cacheModTime >= cacheInfo.sourceModTime;
 }
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// =============================================================================
+// Generational Slot Map
+// =============================================================================
+
+// Handle-indexed storage with per-frame data split from the rest. A handle
+// packs a slot index (low INDEX_BITS) and that slot's generation (high bits);
+// a freed slot bumps its generation, so handles to it go stale instead of
+// aliasing whatever is created there next.
+//
+// Lookup is a bounds check and one load from the hot array, which stores the
+// full handle of its occupant and 0 when free. Cold data lives in a parallel
+// array and is only touched when asked for.
+//
+// Slots are reused in LIFO order. A slot whose generation runs out is retired
+// rather than wrapped, so a handle is never issued twice and never equals
+// 0 or UINT32_MAX. Pointers returned by Get* are invalidated by Insert.
+//
+// Handles can be handed out ahead of the data: AllocateHandle and FreeHandle
+// may be called from any thread, Emplace fills the slot in later. Everything
+// else, lookups included, belongs to the thread that owns the map.
+template <typename Hot, typename Cold>
+class SlotMap {
+public:
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_SLOTS = INDEX_MASK + 1;
+    static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;   // Never issued
+    static constexpr uint32_t INVALID_HANDLE = 0;
+
+    SlotMap() = default;
+
+    // Returns INVALID_HANDLE once every slot is taken
+    uint32_t Insert(Hot hot, Cold cold) {
+        const uint32_t handle = AllocateHandle();
+        if (handle != INVALID_HANDLE) {
+            Emplace(handle, std::move(hot), std::move(cold));
+        }
+        return handle;
+    }
+
+    // Any thread. Reserves a slot without touching the storage arrays,
+    // INVALID_HANDLE once every slot is taken.
+    uint32_t AllocateHandle() {
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+
+        uint32_t index = 0;
+        if (!m_freeSlots.empty()) {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else if (m_generations.size() < MAX_SLOTS) {
+            index = static_cast<uint32_t>(m_generations.size());
+            m_generations.push_back(1);
+        } else {
+            return INVALID_HANDLE;
+        }
+        return (m_generations[index] << INDEX_BITS) | index;
+    }
+
+    // Any thread. Returns an allocated handle that was never emplaced.
+    void FreeHandle(uint32_t handle) {
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+        RetireSlot(handle & INDEX_MASK);
+    }
+
+    // Stores the data for a handle from AllocateHandle
+    void Emplace(uint32_t handle, Hot hot, Cold cold) {
+        const uint32_t index = handle & INDEX_MASK;
+        if (index >= m_hot.size()) {
+            m_hot.resize(index + 1);
+            m_cold.resize(index + 1);
+        }
+
+        m_hot[index].handle = handle;
+        m_hot[index].value = std::move(hot);
+        m_cold[index] = std::move(cold);
+        m_size++;
+    }
+
+    // Releases both halves of the slot, returns false for stale handles
+    bool Remove(uint32_t handle) {
+        if (!Contains(handle)) {
+            return false;
+        }
+
+        const uint32_t index = handle & INDEX_MASK;
+        m_hot[index].handle = INVALID_HANDLE;
+        m_hot[index].value = Hot();
+        m_cold[index] = Cold();
+        m_size--;
+
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+        RetireSlot(index);
+        return true;
+    }
+
+    // Drops all entries; generations restart so handles may repeat. Handles
+    // allocated but not emplaced yet must not be in use.
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_handleMutex);
+        m_hot.clear();
+        m_cold.clear();
+        m_generations.clear();
+        m_freeSlots.clear();
+        m_size = 0;
+    }
+
+    void Reserve(size_t count) {
+        m_hot.reserve(count);
+        m_cold.reserve(count);
+    }
+
+    bool Contains(uint32_t handle) const {
+        const uint32_t index = handle & INDEX_MASK;
+        return handle != INVALID_HANDLE && index < m_hot.size() && m_hot[index].handle == handle;
+    }
+
+    Hot* GetHot(uint32_t handle) {
+        return Contains(handle) ? &m_hot[handle & INDEX_MASK].value : nullptr;
+    }
+    const Hot* GetHot(uint32_t handle) const {
+        return Contains(handle) ? &m_hot[handle & INDEX_MASK].value : nullptr;
+    }
+    Cold* GetCold(uint32_t handle) {
+        return Contains(handle) ? &m_cold[handle & INDEX_MASK] : nullptr;
+    }
+    const Cold* GetCold(uint32_t handle) const {
+        return Contains(handle) ? &m_cold[handle & INDEX_MASK] : nullptr;
+    }
+
+    uint32_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+
+    // fn(handle, Hot&, Cold&) for every live entry in slot order. Remove is
+    // allowed from inside fn, Insert is not.
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        for (size_t index = 0; index < m_hot.size(); ++index) {
+            if (m_hot[index].handle != INVALID_HANDLE) {
+                fn(m_hot[index].handle, m_hot[index].value, m_cold[index]);
+            }
+        }
+    }
+
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (size_t index = 0; index < m_hot.size(); ++index) {
+            if (m_hot[index].handle != INVALID_HANDLE) {
+                fn(m_hot[index].handle, m_hot[index].value, m_cold[index]);
+            }
+        }
+    }
+
+private:
+    // Caller holds m_handleMutex
+    void RetireSlot(uint32_t index) {
+        if (++m_generations[index] < MAX_GENERATION) {
+            m_freeSlots.push_back(index);
+        }
+    }
+
+    struct HotSlot {
+        uint32_t handle = INVALID_HANDLE;   // Occupant, INVALID_HANDLE when free
+        Hot value;
+    };
+
+    std::vector<HotSlot> m_hot;
+    std::vector<Cold> m_cold;
+    uint32_t m_size = 0;                    // Emplaced entries
+
+    // Handle allocation, shared with other threads
+    std::mutex m_handleMutex;
+    std::vector<uint32_t> m_generations;    // Generation the slot hands out next
+    std::vector<uint32_t> m_freeSlots;
+};
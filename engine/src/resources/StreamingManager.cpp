@@ -0,0 +1,320 @@
+#include "StreamingManager.h"
+#include "IO/FileIOService.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 4096;
+
+// Faults a mapped range in, one read per page
+void TouchPages(const void* data, size_t size) {
+    if (!data || size == 0) {
+        return;
+    }
+    const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(data);
+    uint8_t sink = 0;
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE) {
+        sink ^= bytes[offset];
+    }
+    sink ^= bytes[size - 1];
+    (void)sink;
+}
+
+size_t GetGeometryBytes(const EncodedMesh& mesh) {
+    return static_cast<size_t>(mesh.vertexCount) * mesh.layout.GetStride() + mesh.GetIndexDataSize();
+}
+
+} // namespace
+
+StreamingManager::StreamingManager(IMeshStreamingTarget* target, FileIOService* ioService)
+    : StreamingManager(target, ioService, Config())
+{
+}
+
+StreamingManager::StreamingManager(IMeshStreamingTarget* target, FileIOService* ioService, const Config& config)
+    : m_target(target)
+    , m_ioService(ioService)
+    , m_config(config)
+{
+}
+
+StreamingManager::~StreamingManager() {
+    // Loads in flight still hold this
+    if (m_loadsInFlight > 0) {
+        m_ioService->WaitIdle();
+    }
+    for (StreamedMesh& mesh : m_meshes) {
+        if (mesh.state == MeshState::Resident) {
+            m_target->DestroyMesh(mesh.meshHandle);
+        }
+    }
+}
+
+bool StreamingManager::AddCookedMeshFile(const std::string& path, std::vector<StreamedMeshHandle>* handles) {
+    auto file = std::make_unique<CookedMeshFile>();
+    if (!file->Open(path)) {
+        return false;
+    }
+
+    const uint32_t fileIndex = static_cast<uint32_t>(m_files.size());
+    for (uint32_t i = 0; i < file->GetMeshCount(); ++i) {
+        const EncodedMesh encoded = file->GetMesh(i);
+
+        StreamedMesh mesh;
+        mesh.file = fileIndex;
+        mesh.meshIndex = i;
+        mesh.bytes = GetGeometryBytes(encoded);
+        mesh.bounds = encoded.bounds;
+        if (handles) {
+            handles->push_back(static_cast<StreamedMeshHandle>(m_meshes.size()));
+        }
+        m_meshes.push_back(mesh);
+        m_stats.registeredBytes += mesh.bytes;
+    }
+
+    m_files.push_back(std::move(file));
+    return true;
+}
+
+void StreamingManager::BeginFrame(const glm::vec3& cameraPosition, float fovYDegrees) {
+    m_frame++;
+    m_cameraPosition = cameraPosition;
+    m_screenSize.BeginFrame(cameraPosition, fovYDegrees);
+    m_requested.clear();
+}
+
+void StreamingManager::RequestMesh(StreamedMeshHandle handle, const glm::mat4& model) {
+    if (!Contains(handle)) {
+        return;
+    }
+    const MeshBounds& bounds = m_meshes[handle].bounds;
+    const glm::vec3 center = glm::vec3(model * glm::vec4((bounds.min[0] + bounds.max[0]) * 0.5f,
+                                                         (bounds.min[1] + bounds.max[1]) * 0.5f,
+                                                         (bounds.min[2] + bounds.max[2]) * 0.5f, 1.0f));
+    RequestMesh(handle, m_screenSize.ComputeScreenSize(bounds, model), glm::length(center - m_cameraPosition));
+}
+
+void StreamingManager::RequestMesh(StreamedMeshHandle handle, float screenSize, float distance) {
+    if (!Contains(handle)) {
+        return;
+    }
+    StreamedMesh& mesh = m_meshes[handle];
+    const float priority = screenSize + m_config.distanceWeight / (1.0f + std::max(distance, 0.0f));
+    if (mesh.lastRequestFrame != m_frame) {
+        mesh.lastRequestFrame = m_frame;
+        mesh.priority = priority;
+        m_requested.push_back(handle);
+    } else {
+        mesh.priority = std::max(mesh.priority, priority);
+    }
+}
+
+void StreamingManager::Update() {
+    RetireLoads();
+    UploadLoaded();
+
+    // Candidates for eviction this frame, least recently requested first
+    m_evictionOrder.clear();
+    m_evictionCursor = 0;
+    for (StreamedMeshHandle handle = 0; handle < m_meshes.size(); ++handle) {
+        const StreamedMesh& mesh = m_meshes[handle];
+        if (mesh.state == MeshState::Resident && mesh.lastRequestFrame + m_config.evictionGraceFrames < m_frame) {
+            m_evictionOrder.push_back(handle);
+        }
+    }
+    std::sort(m_evictionOrder.begin(), m_evictionOrder.end(), [this](StreamedMeshHandle a, StreamedMeshHandle b) {
+        return m_meshes[a].lastRequestFrame < m_meshes[b].lastRequestFrame;
+    });
+
+    // A lowered budget is honored even without new requests
+    if (GetCommittedBytes() > m_config.residentBudget) {
+        MakeRoom(GetCommittedBytes() - m_config.residentBudget);
+    }
+
+    IssueLoads();
+    m_stats.peakBytes = std::max(m_stats.peakBytes, GetCommittedBytes());
+}
+
+void StreamingManager::RetireLoads() {
+    std::vector<StreamedMeshHandle> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_completedMutex);
+        completed.swap(m_completed);
+    }
+    for (StreamedMeshHandle handle : completed) {
+        m_meshes[handle].state = MeshState::Loaded;
+        m_loaded.push_back(handle);
+        m_loadsInFlight--;
+    }
+}
+
+void StreamingManager::UploadLoaded() {
+    // Most wanted first, meshes nobody asked for lately go last
+    std::sort(m_loaded.begin(), m_loaded.end(), [this](StreamedMeshHandle a, StreamedMeshHandle b) {
+        const StreamedMesh& meshA = m_meshes[a];
+        const StreamedMesh& meshB = m_meshes[b];
+        if (meshA.lastRequestFrame != meshB.lastRequestFrame) {
+            return meshA.lastRequestFrame > meshB.lastRequestFrame;
+        }
+        return meshA.priority > meshB.priority;
+    });
+
+    size_t uploadedBytes = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < m_loaded.size(); ++i) {
+        const StreamedMeshHandle handle = m_loaded[i];
+        StreamedMesh& mesh = m_meshes[handle];
+
+        // Always let one through so a mesh above the budget still progresses
+        if (uploadedBytes > 0 && uploadedBytes + mesh.bytes > m_config.uploadBytesPerFrame) {
+            m_loaded[kept++] = handle;
+            continue;
+        }
+        uploadedBytes += mesh.bytes;
+        m_loadingBytes -= mesh.bytes;
+
+        mesh.meshHandle = m_target->CreateMesh(m_files[mesh.file]->GetMesh(mesh.meshIndex));
+        if (mesh.meshHandle == INVALID_MESH_HANDLE) {
+            mesh.state = MeshState::Unloaded;
+            mesh.retryFrame = m_frame + m_config.retryFrames;
+            m_stats.failedUploads++;
+            continue;
+        }
+        mesh.state = MeshState::Resident;
+        m_residentBytes += mesh.bytes;
+        m_stats.uploads++;
+    }
+    m_loaded.resize(kept);
+}
+
+void StreamingManager::IssueLoads() {
+    std::vector<StreamedMeshHandle> pending;
+    for (StreamedMeshHandle handle : m_requested) {
+        const StreamedMesh& mesh = m_meshes[handle];
+        if (mesh.state == MeshState::Unloaded && mesh.retryFrame <= m_frame) {
+            pending.push_back(handle);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](StreamedMeshHandle a, StreamedMeshHandle b) {
+        return m_meshes[a].priority > m_meshes[b].priority;
+    });
+
+    size_t issuedBytes = 0;
+    for (StreamedMeshHandle handle : pending) {
+        StreamedMesh& mesh = m_meshes[handle];
+        if (m_loadsInFlight >= m_config.maxLoadsInFlight ||
+            (issuedBytes > 0 && issuedBytes + mesh.bytes > m_config.ioBytesPerFrame)) {
+            break;
+        }
+        // Would never fit, don't let it hold up the rest of the queue
+        if (mesh.bytes > m_config.residentBudget) {
+            m_stats.oversizeRejections++;
+            continue;
+        }
+        if (GetCommittedBytes() + mesh.bytes > m_config.residentBudget &&
+            !MakeRoom(GetCommittedBytes() + mesh.bytes - m_config.residentBudget)) {
+            // Everything resident is still wanted, lower priorities wait
+            m_stats.budgetStalls++;
+            break;
+        }
+
+        mesh.state = MeshState::Loading;
+        m_loadingBytes += mesh.bytes;
+        m_loadsInFlight++;
+        issuedBytes += mesh.bytes;
+        m_stats.loadsIssued++;
+        m_stats.ioBytes += mesh.bytes;
+
+        const CookedMeshFile* file = m_files[mesh.file].get();
+        const uint32_t meshIndex = mesh.meshIndex;
+        m_ioService->RunAsync([this, handle, file, meshIndex]() {
+            const EncodedMesh encoded = file->GetMesh(meshIndex);
+            TouchPages(encoded.vertexData, static_cast<size_t>(encoded.vertexCount) * encoded.layout.GetStride());
+            TouchPages(encoded.indexData, encoded.GetIndexDataSize());
+
+            std::lock_guard<std::mutex> lock(m_completedMutex);
+            m_completed.push_back(handle);
+        });
+    }
+}
+
+bool StreamingManager::MakeRoom(size_t bytes) {
+    size_t freed = 0;
+    while (freed < bytes && m_evictionCursor < m_evictionOrder.size()) {
+        const StreamedMeshHandle handle = m_evictionOrder[m_evictionCursor++];
+        // Uploaded or requested since the list was built
+        if (m_meshes[handle].state != MeshState::Resident ||
+            m_meshes[handle].lastRequestFrame + m_config.evictionGraceFrames >= m_frame) {
+            continue;
+        }
+        freed += m_meshes[handle].bytes;
+        Evict(handle);
+    }
+    return freed >= bytes;
+}
+
+void StreamingManager::Evict(StreamedMeshHandle handle) {
+    StreamedMesh& mesh = m_meshes[handle];
+    m_target->DestroyMesh(mesh.meshHandle);
+    mesh.meshHandle = INVALID_MESH_HANDLE;
+    mesh.state = MeshState::Unloaded;
+    m_residentBytes -= mesh.bytes;
+    m_stats.evictions++;
+    m_stats.evictedBytes += mesh.bytes;
+}
+
+StreamingManager::MeshState StreamingManager::GetMeshState(StreamedMeshHandle handle) const {
+    return Contains(handle) ? m_meshes[handle].state : MeshState::Unloaded;
+}
+
+MeshHandle StreamingManager::GetMeshHandle(StreamedMeshHandle handle) const {
+    return Contains(handle) ? m_meshes[handle].meshHandle : INVALID_MESH_HANDLE;
+}
+
+const MeshBounds* StreamingManager::GetMeshBounds(StreamedMeshHandle handle) const {
+    return Contains(handle) ? &m_meshes[handle].bounds : nullptr;
+}
+
+size_t StreamingManager::GetMeshBytes(StreamedMeshHandle handle) const {
+    return Contains(handle) ? m_meshes[handle].bytes : 0;
+}
+
+StreamingManager::Statistics StreamingManager::GetStatistics() const {
+    Statistics stats = m_stats;
+    stats.registeredMeshes = static_cast<uint32_t>(m_meshes.size());
+    stats.requestedMeshes = static_cast<uint32_t>(m_requested.size());
+    for (const StreamedMesh& mesh : m_meshes) {
+        if (mesh.state == MeshState::Resident) {
+            stats.residentMeshes++;
+        } else if (mesh.state != MeshState::Unloaded) {
+            stats.loadingMeshes++;
+        }
+    }
+    for (StreamedMeshHandle handle : m_requested) {
+        if (m_meshes[handle].state == MeshState::Resident) {
+            stats.requestedResident++;
+        }
+    }
+    stats.residentBytes = m_residentBytes;
+    stats.loadingBytes = m_loadingBytes;
+    return stats;
+}
+
+void StreamingManager::PrintStats() const {
+    const Statistics stats = GetStatistics();
+    const double mb = 1024.0 * 1024.0;
+    printf("=== StreamingManager ===\n");
+    printf("Meshes: %u registered (%.1f MB), %u resident, %u loading\n", stats.registeredMeshes,
+           stats.registeredBytes / mb, stats.residentMeshes, stats.loadingMeshes);
+    printf("Requested: %u (%u resident)\n", stats.requestedMeshes, stats.requestedResident);
+    printf("Budget: %.1f / %.1f MB resident, %.1f MB loading, peak %.1f MB\n", stats.residentBytes / mb,
+           m_config.residentBudget / mb, stats.loadingBytes / mb, stats.peakBytes / mb);
+    printf("Loads: %llu issued (%.1f MB), %llu uploaded, %llu failed\n",
+           static_cast<unsigned long long>(stats.loadsIssued), stats.ioBytes / mb,
+           static_cast<unsigned long long>(stats.uploads), static_cast<unsigned long long>(stats.failedUploads));
+    printf("Evictions: %llu (%.1f MB), Budget Stalls: %llu, Oversize: %llu\n",
+           static_cast<unsigned long long>(stats.evictions), stats.evictedBytes / mb,
+           static_cast<unsigned long long>(stats.budgetStalls), static_cast<unsigned long long>(stats.oversizeRejections));
+    printf("===========================\n");
+}
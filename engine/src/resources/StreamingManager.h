@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RenderTypes.h"
+#include "CookedMesh.h"
+#include "renderer/LODSelector.h"
+
+class FileIOService;
+
+// =============================================================================
+// Mesh Streaming
+// =============================================================================
+
+// Receives meshes once they are loaded and releases them on eviction.
+// GeometryManager implements it; a mock that counts bytes is enough to drive
+// the streaming manager without a GPU.
+class IMeshStreamingTarget {
+public:
+    virtual ~IMeshStreamingTarget() = default;
+
+    virtual MeshHandle CreateMesh(const EncodedMesh& mesh) = 0;    // INVALID_MESH_HANDLE on failure
+    virtual void DestroyMesh(MeshHandle handle) = 0;
+};
+
+using StreamedMeshHandle = uint32_t;
+constexpr StreamedMeshHandle INVALID_STREAMED_MESH = UINT32_MAX;
+
+// Keeps a world's worth of cooked meshes registered and only a budget's
+// worth resident. Every frame the caller requests the meshes it would draw;
+// each request raises the mesh's priority for the frame from its projected
+// screen size and camera distance. Update then:
+//
+//   Unloaded -> (issued in priority order within the I/O budget) -> Loading
+//            -> (pages read on an I/O thread) -> Loaded
+//            -> (handed to the target within the upload budget) -> Resident
+//            -> (evicted once unseen and the budget needs room) -> Unloaded
+//
+// Loading reads the mesh's range of its mapped cooked file on FileIOService
+// threads, so the OS page cache is the only copy until the upload. Budgets
+// count vertex and index bytes of loading, loaded and resident meshes;
+// eviction picks the least recently requested mesh first and never one
+// requested within evictionGraceFrames. Main thread only.
+class StreamingManager {
+public:
+    enum class MeshState : uint8_t {
+        Unloaded,
+        Loading,
+        Loaded,
+        Resident,
+    };
+
+    struct Config {
+        size_t residentBudget = 2048ull * 1024 * 1024;     // Geometry bytes held at once
+        size_t ioBytesPerFrame = 64 * 1024 * 1024;          // Loads issued per frame
+        size_t uploadBytesPerFrame = 32 * 1024 * 1024;      // Loaded meshes handed to the target per frame
+        uint32_t maxLoadsInFlight = 64;
+        uint32_t evictionGraceFrames = 30;                  // Frames a mesh stays safe after its last request
+        uint32_t retryFrames = 60;                          // Wait after a failed creation
+        float distanceWeight = 0.25f;                       // Priority = screen size + distanceWeight / (1 + distance)
+    };
+
+    struct Statistics {
+        uint32_t registeredMeshes = 0;
+        uint32_t residentMeshes = 0;
+        uint32_t loadingMeshes = 0;         // Reading or waiting for upload budget
+        uint32_t requestedMeshes = 0;       // Requested this frame
+        uint32_t requestedResident = 0;     // ...of which resident
+        size_t registeredBytes = 0;
+        size_t residentBytes = 0;
+        size_t loadingBytes = 0;
+        size_t peakBytes = 0;               // Highest resident plus loading bytes seen
+        uint64_t loadsIssued = 0;
+        uint64_t uploads = 0;
+        uint64_t failedUploads = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;
+        uint64_t ioBytes = 0;
+        uint64_t budgetStalls = 0;          // Frames a request found the budget full of visible meshes
+        uint64_t oversizeRejections = 0;    // Requests skipped because the mesh alone exceeds the budget
+    };
+
+    StreamingManager(IMeshStreamingTarget* target, FileIOService* ioService);
+    StreamingManager(IMeshStreamingTarget* target, FileIOService* ioService, const Config& config);
+    ~StreamingManager();
+
+    // Prevent copying
+    StreamingManager(const StreamingManager&) = delete;
+    StreamingManager& operator=(const StreamingManager&) = delete;
+
+    void SetConfig(const Config& config) { m_config = config; }
+    const Config& GetConfig() const { return m_config; }
+
+    // Registers every mesh of a cooked mesh file, handles appended in file
+    // order. The file stays mapped, no geometry is read until requested.
+    bool AddCookedMeshFile(const std::string& path, std::vector<StreamedMeshHandle>* handles = nullptr);
+
+    // Camera for this frame's priorities (vertical field of view in degrees)
+    void BeginFrame(const glm::vec3& cameraPosition, float fovYDegrees);
+
+    // The mesh is wanted this frame, once per visible instance
+    void RequestMesh(StreamedMeshHandle handle, const glm::mat4& model);
+    void RequestMesh(StreamedMeshHandle handle, float screenSize, float distance);
+
+    // Retires loads, uploads, evicts and issues loads within the budgets
+    void Update();
+
+    MeshState GetMeshState(StreamedMeshHandle handle) const;
+    // INVALID_MESH_HANDLE unless resident
+    MeshHandle GetMeshHandle(StreamedMeshHandle handle) const;
+    const MeshBounds* GetMeshBounds(StreamedMeshHandle handle) const;
+    size_t GetMeshBytes(StreamedMeshHandle handle) const;
+
+    Statistics GetStatistics() const;
+    void PrintStats() const;
+
+private:
+    struct StreamedMesh {
+        uint32_t file = 0;
+        uint32_t meshIndex = 0;
+        size_t bytes = 0;                   // Vertex plus index data
+        MeshBounds bounds;
+        MeshState state = MeshState::Unloaded;
+        MeshHandle meshHandle = INVALID_MESH_HANDLE;
+        float priority = 0.0f;              // Highest request this frame
+        uint64_t lastRequestFrame = 0;      // 0 for never
+        uint64_t retryFrame = 0;
+    };
+
+    bool Contains(StreamedMeshHandle handle) const { return handle < m_meshes.size(); }
+    void RetireLoads();
+    void UploadLoaded();
+    void IssueLoads();
+    // Frees at least bytes of budget from unrequested meshes, false if it can't
+    bool MakeRoom(size_t bytes);
+    void Evict(StreamedMeshHandle handle);
+    size_t GetCommittedBytes() const { return m_residentBytes + m_loadingBytes; }
+
+    IMeshStreamingTarget* m_target;
+    FileIOService* m_ioService;
+    Config m_config;
+    LODSelector m_screenSize;               // Only for ComputeScreenSize
+    glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+
+    std::vector<std::unique_ptr<CookedMeshFile>> m_files;
+    std::vector<StreamedMesh> m_meshes;
+    std::vector<StreamedMeshHandle> m_requested;        // This frame, unique
+    std::vector<StreamedMeshHandle> m_loaded;           // Waiting for upload budget
+    std::vector<StreamedMeshHandle> m_evictionOrder;    // Scratch, oldest request first
+    size_t m_evictionCursor = 0;
+    uint64_t m_frame = 0;
+    uint32_t m_loadsInFlight = 0;
+    size_t m_residentBytes = 0;
+    size_t m_loadingBytes = 0;
+
+    // Filled by I/O threads
+    std::mutex m_completedMutex;
+    std::vector<StreamedMeshHandle> m_completed;
+
+    Statistics m_stats;
+};
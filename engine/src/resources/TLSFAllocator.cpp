@@ -0,0 +1,386 @@
+#include "TLSFAllocator.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    uint32_t FindLowestSetBit(uint32_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+    }
+
+    uint32_t FindHighestSetBit(uint32_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return 31u - static_cast<uint32_t>(__builtin_clz(value));
+#endif
+    }
+}
+
+TLSFAllocator::TLSFAllocator(size_t size, size_t alignment)
+    : m_size(size)
+    , m_alignment(alignment > 0 ? alignment : DEFAULT_ALIGNMENT)
+{
+    Reset();
+}
+
+void TLSFAllocator::Reset() {
+    m_usedSpace = 0;
+    m_flBitmap = 0;
+    std::fill(std::begin(m_slBitmap), std::end(m_slBitmap), 0u);
+    for (auto& row : m_freeHeads) {
+        std::fill(std::begin(row), std::end(row), INVALID_NODE);
+    }
+    m_freeBlockCount = 0;
+
+    m_nodes.clear();
+    m_unusedNodes.clear();
+    m_firstNode = INVALID_NODE;
+    m_allocations.clear();
+    m_pendingFrees.clear();
+
+    // Offsets are returned as uint32_t, so only the first 4 GB are usable
+    const size_t totalUnits = std::min<size_t>(m_size / m_alignment, UINT32_MAX / m_alignment);
+    if (totalUnits == 0) {
+        return;
+    }
+
+    m_firstNode = CreateNode();
+    m_nodes[m_firstNode].offset = 0;
+    m_nodes[m_firstNode].size = static_cast<uint32_t>(totalUnits);
+    InsertFree(m_firstNode);
+}
+
+// =============================================================================
+// Size Classes
+// =============================================================================
+
+void TLSFAllocator::MapInsert(uint32_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < SL_COUNT) {
+        // Small sizes map linearly onto the first row
+        fl = 0;
+        sl = size;
+    } else {
+        const uint32_t highBit = FindHighestSetBit(size);
+        fl = highBit - SL_BITS + 1;
+        sl = (size >> (highBit - SL_BITS)) ^ SL_COUNT;
+    }
+}
+
+bool TLSFAllocator::MapSearch(uint32_t size, uint32_t& fl, uint32_t& sl) {
+    // Round up to the next class boundary so any block found is large enough
+    if (size >= SL_COUNT) {
+        const uint32_t round = (1u << (FindHighestSetBit(size) - SL_BITS)) - 1;
+        if (size > UINT32_MAX - round) {
+            return false;
+        }
+        size += round;
+    }
+    MapInsert(size, fl, sl);
+    return true;
+}
+
+bool TLSFAllocator::FindFreeBlock(uint32_t size, uint32_t& fl, uint32_t& sl) const {
+    if (!MapSearch(size, fl, sl)) {
+        return false;
+    }
+
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+        const uint32_t flMap = (fl + 1 < 32) ? (m_flBitmap & (~0u << (fl + 1))) : 0;
+        if (flMap == 0) {
+            return false;
+        }
+        fl = FindLowestSetBit(flMap);
+        slMap = m_slBitmap[fl];
+    }
+    sl = FindLowestSetBit(slMap);
+    return true;
+}
+
+uint32_t TLSFAllocator::ToUnits(size_t size) const {
+    const size_t units = std::max<size_t>((size + m_alignment - 1) / m_alignment, 1);
+    return units > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(units);
+}
+
+// =============================================================================
+// Allocation
+// =============================================================================
+
+uint32_t TLSFAllocator::Allocate(size_t size) {
+    const uint32_t units = ToUnits(size);
+
+    uint32_t fl, sl;
+    if (!FindFreeBlock(units, fl, sl)) {
+        return UINT32_MAX; // Out of space
+    }
+
+    uint32_t nodeIndex = m_freeHeads[fl][sl];
+    RemoveFree(nodeIndex);
+
+    // Return the tail of the block to the free lists
+    uint32_t remainderIndex = SplitNode(nodeIndex, units);
+    if (remainderIndex != INVALID_NODE) {
+        InsertFree(remainderIndex);
+    }
+
+    MarkUsed(nodeIndex);
+    return static_cast<uint32_t>(static_cast<size_t>(m_nodes[nodeIndex].offset) * m_alignment);
+}
+
+bool TLSFAllocator::AllocateAt(uint32_t offset, size_t size) {
+    if (offset % m_alignment != 0) {
+        return false;
+    }
+
+    const uint32_t unitOffset = static_cast<uint32_t>(offset / m_alignment);
+    const uint32_t units = ToUnits(size);
+
+    // Find the free block holding the range
+    uint32_t nodeIndex = m_firstNode;
+    while (nodeIndex != INVALID_NODE && m_nodes[nodeIndex].offset + m_nodes[nodeIndex].size <= unitOffset) {
+        nodeIndex = m_nodes[nodeIndex].nextPhysical;
+    }
+    if (nodeIndex == INVALID_NODE || m_nodes[nodeIndex].used ||
+        static_cast<uint64_t>(unitOffset) + units > static_cast<uint64_t>(m_nodes[nodeIndex].offset) + m_nodes[nodeIndex].size) {
+        return false;
+    }
+
+    RemoveFree(nodeIndex);
+
+    // Cut off the head, the claimed range becomes its own node
+    if (m_nodes[nodeIndex].offset < unitOffset) {
+        uint32_t claimedIndex = SplitNode(nodeIndex, unitOffset - m_nodes[nodeIndex].offset);
+        InsertFree(nodeIndex);
+        nodeIndex = claimedIndex;
+    }
+
+    uint32_t remainderIndex = SplitNode(nodeIndex, units);
+    if (remainderIndex != INVALID_NODE) {
+        InsertFree(remainderIndex);
+    }
+
+    MarkUsed(nodeIndex);
+    return true;
+}
+
+void TLSFAllocator::GetBlocks(std::vector<Block>& outBlocks) const {
+    outBlocks.clear();
+    for (uint32_t nodeIndex = m_firstNode; nodeIndex != INVALID_NODE; nodeIndex = m_nodes[nodeIndex].nextPhysical) {
+        const Node& node = m_nodes[nodeIndex];
+        outBlocks.push_back({
+            static_cast<uint32_t>(static_cast<size_t>(node.offset) * m_alignment),
+            static_cast<uint32_t>(static_cast<size_t>(node.size) * m_alignment),
+            node.used
+        });
+    }
+}
+
+uint32_t TLSFAllocator::SplitNode(uint32_t nodeIndex, uint32_t units) {
+    if (m_nodes[nodeIndex].size <= units) {
+        return INVALID_NODE;
+    }
+
+    uint32_t remainderIndex = CreateNode();
+    Node& node = m_nodes[nodeIndex];
+    Node& remainder = m_nodes[remainderIndex];
+
+    remainder.offset = node.offset + units;
+    remainder.size = node.size - units;
+    remainder.prevPhysical = nodeIndex;
+    remainder.nextPhysical = node.nextPhysical;
+    if (node.nextPhysical != INVALID_NODE) {
+        m_nodes[node.nextPhysical].prevPhysical = remainderIndex;
+    }
+    node.nextPhysical = remainderIndex;
+    node.size = units;
+    return remainderIndex;
+}
+
+void TLSFAllocator::MarkUsed(uint32_t nodeIndex) {
+    Node& node = m_nodes[nodeIndex];
+    node.used = true;
+    m_usedSpace += static_cast<size_t>(node.size) * m_alignment;
+
+    const uint32_t byteOffset = static_cast<uint32_t>(static_cast<size_t>(node.offset) * m_alignment);
+    m_allocations[byteOffset] = nodeIndex;
+}
+
+void TLSFAllocator::Free(uint32_t offset) {
+    auto it = m_allocations.find(offset);
+    if (it == m_allocations.end()) {
+        printf("TLSFAllocator: Free of unknown offset %u\n", offset);
+        return;
+    }
+
+    uint32_t nodeIndex = it->second;
+    m_allocations.erase(it);
+
+    m_nodes[nodeIndex].used = false;
+    m_usedSpace -= static_cast<size_t>(m_nodes[nodeIndex].size) * m_alignment;
+
+    // Coalesce with the free neighbour before
+    const uint32_t prevIndex = m_nodes[nodeIndex].prevPhysical;
+    if (prevIndex != INVALID_NODE && !m_nodes[prevIndex].used) {
+        RemoveFree(prevIndex);
+        Node& prev = m_nodes[prevIndex];
+        prev.size += m_nodes[nodeIndex].size;
+        prev.nextPhysical = m_nodes[nodeIndex].nextPhysical;
+        if (prev.nextPhysical != INVALID_NODE) {
+            m_nodes[prev.nextPhysical].prevPhysical = prevIndex;
+        }
+        ReleaseNode(nodeIndex);
+        nodeIndex = prevIndex;
+    }
+
+    // ... and the one after
+    const uint32_t nextIndex = m_nodes[nodeIndex].nextPhysical;
+    if (nextIndex != INVALID_NODE && !m_nodes[nextIndex].used) {
+        RemoveFree(nextIndex);
+        Node& node = m_nodes[nodeIndex];
+        node.size += m_nodes[nextIndex].size;
+        node.nextPhysical = m_nodes[nextIndex].nextPhysical;
+        if (node.nextPhysical != INVALID_NODE) {
+            m_nodes[node.nextPhysical].prevPhysical = nodeIndex;
+        }
+        ReleaseNode(nextIndex);
+    }
+
+    InsertFree(nodeIndex);
+}
+
+void TLSFAllocator::FreeDeferred(uint32_t offset, uint64_t fenceValue) {
+    m_pendingFrees.push_back({ offset, fenceValue });
+}
+
+void TLSFAllocator::ReclaimCompleted(uint64_t completedFenceValue) {
+    while (!m_pendingFrees.empty() && m_pendingFrees.front().fenceValue <= completedFenceValue) {
+        Free(m_pendingFrees.front().offset);
+        m_pendingFrees.pop_front();
+    }
+}
+
+bool TLSFAllocator::CanAllocate(size_t size) const {
+    uint32_t fl, sl;
+    return FindFreeBlock(ToUnits(size), fl, sl);
+}
+
+size_t TLSFAllocator::GetLargestFreeBlock() const {
+    if (m_flBitmap == 0) {
+        return 0;
+    }
+
+    // Blocks in the highest class differ in size, so scan that one list
+    const uint32_t fl = FindHighestSetBit(m_flBitmap);
+    const uint32_t sl = FindHighestSetBit(m_slBitmap[fl]);
+    uint32_t largest = 0;
+    for (uint32_t nodeIndex = m_freeHeads[fl][sl]; nodeIndex != INVALID_NODE; nodeIndex = m_nodes[nodeIndex].nextFree) {
+        largest = std::max(largest, m_nodes[nodeIndex].size);
+    }
+    return static_cast<size_t>(largest) * m_alignment;
+}
+
+// =============================================================================
+// Free Lists
+// =============================================================================
+
+uint32_t TLSFAllocator::CreateNode() {
+    if (!m_unusedNodes.empty()) {
+        uint32_t nodeIndex = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+        m_nodes[nodeIndex] = Node();
+        return nodeIndex;
+    }
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void TLSFAllocator::ReleaseNode(uint32_t nodeIndex) {
+    m_unusedNodes.push_back(nodeIndex);
+}
+
+void TLSFAllocator::InsertFree(uint32_t nodeIndex) {
+    uint32_t fl, sl;
+    MapInsert(m_nodes[nodeIndex].size, fl, sl);
+
+    Node& node = m_nodes[nodeIndex];
+    node.prevFree = INVALID_NODE;
+    node.nextFree = m_freeHeads[fl][sl];
+    if (node.nextFree != INVALID_NODE) {
+        m_nodes[node.nextFree].prevFree = nodeIndex;
+    }
+    m_freeHeads[fl][sl] = nodeIndex;
+
+    m_flBitmap |= 1u << fl;
+    m_slBitmap[fl] |= 1u << sl;
+    m_freeBlockCount++;
+}
+
+void TLSFAllocator::RemoveFree(uint32_t nodeIndex) {
+    uint32_t fl, sl;
+    MapInsert(m_nodes[nodeIndex].size, fl, sl);
+
+    Node& node = m_nodes[nodeIndex];
+    if (node.prevFree != INVALID_NODE) {
+        m_nodes[node.prevFree].nextFree = node.nextFree;
+    } else {
+        m_freeHeads[fl][sl] = node.nextFree;
+    }
+    if (node.nextFree != INVALID_NODE) {
+        m_nodes[node.nextFree].prevFree = node.prevFree;
+    }
+    node.prevFree = INVALID_NODE;
+    node.nextFree = INVALID_NODE;
+
+    if (m_freeHeads[fl][sl] == INVALID_NODE) {
+        m_slBitmap[fl] &= ~(1u << sl);
+        if (m_slBitmap[fl] == 0) {
+            m_flBitmap &= ~(1u << fl);
+        }
+    }
+    m_freeBlockCount--;
+}
+
+bool TLSFAllocator::Validate() const {
+    // Physical chain must tile the range without gaps and never hold two
+    // adjacent free blocks
+    uint32_t nodeIndex = m_firstNode;
+    uint32_t expectedOffset = 0;
+    uint32_t freeBlocks = 0;
+    size_t usedUnits = 0;
+    bool prevFree = false;
+    for (; nodeIndex != INVALID_NODE; nodeIndex = m_nodes[nodeIndex].nextPhysical) {
+        const Node& node = m_nodes[nodeIndex];
+        if (node.offset != expectedOffset || node.size == 0) {
+            return false;
+        }
+        if (!node.used) {
+            if (prevFree) {
+                return false;
+            }
+            uint32_t fl, sl;
+            MapInsert(node.size, fl, sl);
+            if (!(m_slBitmap[fl] & (1u << sl)) || !(m_flBitmap & (1u << fl))) {
+                return false;
+            }
+            freeBlocks++;
+        } else {
+            usedUnits += node.size;
+        }
+        prevFree = !node.used;
+        expectedOffset += node.size;
+    }
+
+    return freeBlocks == m_freeBlockCount && usedUnits * m_alignment == m_usedSpace;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// =============================================================================
+// TLSF Allocator for Buffer Management
+// =============================================================================
+
+// Two-level segregated fit offset allocator. Manages a range of bytes without
+// touching memory, so it can back GPU buffers. Allocate and Free are O(1):
+// free blocks live in 29x16 size-class lists indexed through two bitmaps, and
+// neighbouring free blocks are coalesced on free.
+//
+// Same interface as LinearAllocator plus Free. Offsets are multiples of the
+// alignment, which does not have to be a power of two (e.g. a vertex stride).
+// Ranges still read by the GPU go through FreeDeferred and are returned once
+// ReclaimCompleted sees their fence value complete.
+class TLSFAllocator {
+public:
+    // Physical block as reported by GetBlocks, in bytes
+    struct Block {
+        uint32_t offset;
+        uint32_t size;
+        bool used;
+    };
+
+    explicit TLSFAllocator(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+    ~TLSFAllocator() = default;
+
+    // Prevent copying
+    TLSFAllocator(const TLSFAllocator&) = delete;
+    TLSFAllocator& operator=(const TLSFAllocator&) = delete;
+
+    // Allocation methods
+    uint32_t Allocate(size_t size);             // Returns UINT32_MAX when out of space
+    void Free(uint32_t offset);
+    void Reset();
+
+    // Claims exactly [offset, offset + size) if it lies in one free block.
+    // O(blocks), meant for relocation rather than regular allocation.
+    bool AllocateAt(uint32_t offset, size_t size);
+
+    // Address-ordered layout of every block, free and used
+    void GetBlocks(std::vector<Block>& outBlocks) const;
+
+    // Fence-safe reclamation. Ranges are released in queue order, so a value
+    // lower than an earlier one waits until that one completes too.
+    void FreeDeferred(uint32_t offset, uint64_t fenceValue);
+    void ReclaimCompleted(uint64_t completedFenceValue);
+
+    // Query methods
+    size_t GetUsedSpace() const { return m_usedSpace; }
+    size_t GetAvailableSpace() const { return m_size - m_usedSpace; }
+    size_t GetTotalSize() const { return m_size; }
+    size_t GetLargestFreeBlock() const;
+    uint32_t GetAllocationCount() const { return static_cast<uint32_t>(m_allocations.size()); }
+    uint32_t GetFreeBlockCount() const { return m_freeBlockCount; }
+    uint32_t GetPendingFreeCount() const { return static_cast<uint32_t>(m_pendingFrees.size()); }
+
+    // Utility
+    bool CanAllocate(size_t size) const;
+
+    // Walks every block and checks list/bitmap invariants (debug aid)
+    bool Validate() const;
+
+private:
+    static constexpr size_t DEFAULT_ALIGNMENT = 256;
+    static constexpr uint32_t SL_BITS = 4;
+    static constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+    static constexpr uint32_t FL_COUNT = 32 - SL_BITS + 1;
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    // Block sizes and offsets are in units of m_alignment
+    struct Node {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t prevPhysical = INVALID_NODE;
+        uint32_t nextPhysical = INVALID_NODE;
+        uint32_t prevFree = INVALID_NODE;
+        uint32_t nextFree = INVALID_NODE;
+        bool used = false;
+    };
+
+    struct PendingFree {
+        uint32_t offset;
+        uint64_t fenceValue;
+    };
+
+    static void MapInsert(uint32_t size, uint32_t& fl, uint32_t& sl);
+    static bool MapSearch(uint32_t size, uint32_t& fl, uint32_t& sl);
+
+    uint32_t ToUnits(size_t size) const;
+    bool FindFreeBlock(uint32_t size, uint32_t& fl, uint32_t& sl) const;
+    uint32_t SplitNode(uint32_t nodeIndex, uint32_t units);
+    void MarkUsed(uint32_t nodeIndex);
+    uint32_t CreateNode();
+    void ReleaseNode(uint32_t nodeIndex);
+    void InsertFree(uint32_t nodeIndex);
+    void RemoveFree(uint32_t nodeIndex);
+
+    size_t m_size;
+    size_t m_alignment;
+    size_t m_usedSpace = 0;
+
+    uint32_t m_flBitmap = 0;
+    uint32_t m_slBitmap[FL_COUNT] = {};
+    uint32_t m_freeHeads[FL_COUNT][SL_COUNT];
+    uint32_t m_freeBlockCount = 0;
+
+    std::vector<Node> m_nodes;
+    uint32_t m_firstNode = INVALID_NODE;    // Block at offset 0, never merged away
+    std::vector<uint32_t> m_unusedNodes;
+
+    // Byte offset -> node of every live allocation
+    std::unordered_map<uint32_t, uint32_t> m_allocations;
+    std::deque<PendingFree> m_pendingFrees;
+};
@@ -0,0 +1,589 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// =============================================================================
+// Shared Helpers
+// =============================================================================
+
+// Mean and dominant direction of the block's points. Power iteration from
+// the bounding box diagonal, which is already close for most blocks.
+template <uint32_t Channels>
+void ComputePrincipalAxis(const float (&points)[TEXTURE_BLOCK_PIXELS][Channels], float (&mean)[Channels],
+                          float (&axis)[Channels]) {
+    float minimum[Channels], maximum[Channels];
+    for (uint32_t c = 0; c < Channels; ++c) {
+        mean[c] = 0.0f;
+        minimum[c] = FLT_MAX;
+        maximum[c] = -FLT_MAX;
+    }
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        for (uint32_t c = 0; c < Channels; ++c) {
+            mean[c] += points[i][c];
+            minimum[c] = std::min(minimum[c], points[i][c]);
+            maximum[c] = std::max(maximum[c], points[i][c]);
+        }
+    }
+    for (uint32_t c = 0; c < Channels; ++c) {
+        mean[c] /= TEXTURE_BLOCK_PIXELS;
+    }
+
+    float covariance[Channels][Channels] = {};
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        float delta[Channels];
+        for (uint32_t c = 0; c < Channels; ++c) {
+            delta[c] = points[i][c] - mean[c];
+        }
+        for (uint32_t row = 0; row < Channels; ++row) {
+            for (uint32_t column = 0; column < Channels; ++column) {
+                covariance[row][column] += delta[row] * delta[column];
+            }
+        }
+    }
+
+    auto normalize = [](float (&vector)[Channels]) {
+        float lengthSquared = 0.0f;
+        for (uint32_t c = 0; c < Channels; ++c) {
+            lengthSquared += vector[c] * vector[c];
+        }
+        if (lengthSquared < 1e-12f) {
+            return false;
+        }
+        const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+        for (uint32_t c = 0; c < Channels; ++c) {
+            vector[c] *= inverseLength;
+        }
+        return true;
+    };
+
+    for (uint32_t c = 0; c < Channels; ++c) {
+        axis[c] = maximum[c] - minimum[c];
+    }
+    if (!normalize(axis)) {
+        // Solid block, any direction works
+        for (uint32_t c = 0; c < Channels; ++c) {
+            axis[c] = 1.0f;
+        }
+        normalize(axis);
+        return;
+    }
+
+    for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+        float next[Channels] = {};
+        for (uint32_t row = 0; row < Channels; ++row) {
+            for (uint32_t column = 0; column < Channels; ++column) {
+                next[row] += covariance[row][column] * axis[column];
+            }
+        }
+        if (!normalize(next)) {
+            break;
+        }
+        memcpy(axis, next, sizeof(axis));
+    }
+}
+
+// Endpoints spanning the points' projection on the principal axis
+template <uint32_t Channels>
+void ComputeAxisEndpoints(const float (&points)[TEXTURE_BLOCK_PIXELS][Channels], float (&start)[Channels],
+                          float (&end)[Channels]) {
+    float mean[Channels], axis[Channels];
+    ComputePrincipalAxis<Channels>(points, mean, axis);
+
+    float minimum = FLT_MAX;
+    float maximum = -FLT_MAX;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        float t = 0.0f;
+        for (uint32_t c = 0; c < Channels; ++c) {
+            t += (points[i][c] - mean[c]) * axis[c];
+        }
+        minimum = std::min(minimum, t);
+        maximum = std::max(maximum, t);
+    }
+    for (uint32_t c = 0; c < Channels; ++c) {
+        start[c] = mean[c] + axis[c] * maximum;
+        end[c] = mean[c] + axis[c] * minimum;
+    }
+}
+
+// Least-squares endpoints for fixed indices: each point is
+// weights[index] * start + (1 - weights[index]) * end. False when the
+// indices don't pin both endpoints down (all the same weight).
+template <uint32_t Channels>
+bool RefitEndpoints(const float (&points)[TEXTURE_BLOCK_PIXELS][Channels], const uint8_t* indices,
+                    const float* weights, float (&start)[Channels], float (&end)[Channels]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ap[Channels] = {}, bp[Channels] = {};
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const float a = weights[indices[i]];
+        const float b = 1.0f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (uint32_t c = 0; c < Channels; ++c) {
+            ap[c] += a * points[i][c];
+            bp[c] += b * points[i][c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f) {
+        return false;
+    }
+    const float inverse = 1.0f / determinant;
+    for (uint32_t c = 0; c < Channels; ++c) {
+        start[c] = (ap[c] * bb - bp[c] * ab) * inverse;
+        end[c] = (bp[c] * aa - ap[c] * ab) * inverse;
+    }
+    return true;
+}
+
+// Nearest palette entry per pixel, returns the summed squared error
+template <uint32_t Channels>
+uint32_t SelectIndices(const int (&pixels)[TEXTURE_BLOCK_PIXELS][Channels], const int (*palette)[Channels],
+                       uint32_t paletteSize, uint8_t* indices) {
+    uint32_t totalError = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        uint32_t bestError = UINT32_MAX;
+        for (uint32_t entry = 0; entry < paletteSize; ++entry) {
+            uint32_t error = 0;
+            for (uint32_t c = 0; c < Channels; ++c) {
+                const int delta = pixels[i][c] - palette[entry][c];
+                error += static_cast<uint32_t>(delta * delta);
+            }
+            if (error < bestError) {
+                bestError = error;
+                indices[i] = static_cast<uint8_t>(entry);
+            }
+        }
+        totalError += bestError;
+    }
+    return totalError;
+}
+
+int RoundToInt(float value, int maximum) {
+    return std::clamp(static_cast<int>(value + 0.5f), 0, maximum);
+}
+
+// =============================================================================
+// BC1 Color
+// =============================================================================
+
+uint16_t Pack565(const float* color) {
+    const int r = RoundToInt(color[0] * (31.0f / 255.0f), 31);
+    const int g = RoundToInt(color[1] * (63.0f / 255.0f), 63);
+    const int b = RoundToInt(color[2] * (31.0f / 255.0f), 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void Unpack565(uint16_t packed, int* color) {
+    const int r = (packed >> 11) & 31;
+    const int g = (packed >> 5) & 63;
+    const int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+void BuildBC1Palette(uint16_t color0, uint16_t color1, bool fourColor, int (&palette)[4][3]) {
+    Unpack565(color0, palette[0]);
+    Unpack565(color1, palette[1]);
+    for (uint32_t c = 0; c < 3; ++c) {
+        if (fourColor) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+// Weight of color0 for each index in four-color mode
+constexpr float BC1_WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+// The color half of BC1 and BC3, always four-color mode
+void EncodeColorBlock(const uint8_t* pixels, uint8_t* block) {
+    float points[TEXTURE_BLOCK_PIXELS][3];
+    int colors[TEXTURE_BLOCK_PIXELS][3];
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            colors[i][c] = pixels[i * 4 + c];
+            points[i][c] = static_cast<float>(colors[i][c]);
+        }
+    }
+
+    uint16_t bestColor0 = 0;
+    uint16_t bestColor1 = 0;
+    uint8_t bestIndices[TEXTURE_BLOCK_PIXELS] = {};
+    uint32_t bestError = UINT32_MAX;
+    auto tryEndpoints = [&](const float* start, const float* end) {
+        uint16_t color0 = Pack565(start);
+        uint16_t color1 = Pack565(end);
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+        int palette[4][3];
+        BuildBC1Palette(color0, color1, true, palette);
+        uint8_t indices[TEXTURE_BLOCK_PIXELS];
+        const uint32_t error = SelectIndices<3>(colors, palette, 4, indices);
+        if (color0 == color1) {
+            // Equal endpoints decode as three-color mode, where index 3 is black
+            memset(indices, 0, sizeof(indices));
+        }
+        if (error >= bestError) {
+            return false;
+        }
+        bestError = error;
+        bestColor0 = color0;
+        bestColor1 = color1;
+        memcpy(bestIndices, indices, sizeof(indices));
+        return true;
+    };
+
+    float start[3], end[3];
+    ComputeAxisEndpoints<3>(points, start, end);
+    tryEndpoints(start, end);
+    for (uint32_t iteration = 0; iteration < 2 && bestError > 0; ++iteration) {
+        if (!RefitEndpoints<3>(points, bestIndices, BC1_WEIGHTS, start, end) || !tryEndpoints(start, end)) {
+            break;
+        }
+    }
+
+    block[0] = static_cast<uint8_t>(bestColor0);
+    block[1] = static_cast<uint8_t>(bestColor0 >> 8);
+    block[2] = static_cast<uint8_t>(bestColor1);
+    block[3] = static_cast<uint8_t>(bestColor1 >> 8);
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        bits |= static_cast<uint32_t>(bestIndices[i]) << (2 * i);
+    }
+    memcpy(block + 4, &bits, sizeof(bits));
+}
+
+void DecodeColorBlock(const uint8_t* block, bool forceFourColor, uint8_t* pixels) {
+    const uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    const uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+    const bool fourColor = forceFourColor || color0 > color1;
+    int palette[4][3];
+    BuildBC1Palette(color0, color1, fourColor, palette);
+
+    uint32_t bits;
+    memcpy(&bits, block + 4, sizeof(bits));
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const uint32_t index = (bits >> (2 * i)) & 3;
+        for (uint32_t c = 0; c < 3; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+        }
+        pixels[i * 4 + 3] = (!fourColor && index == 3) ? 0 : 255;
+    }
+}
+
+// =============================================================================
+// BC4 Channel
+// =============================================================================
+
+void BuildBC4Palette(int value0, int value1, int (&palette)[8][1]) {
+    palette[0][0] = value0;
+    palette[1][0] = value1;
+    if (value0 > value1) {
+        for (int i = 2; i < 8; ++i) {
+            palette[i][0] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; ++i) {
+            palette[i][0] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+        }
+        palette[6][0] = 0;
+        palette[7][0] = 255;
+    }
+}
+
+// =============================================================================
+// BC7 Mode 6
+// =============================================================================
+
+constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Weight of endpoint 0 for each index, for the refit
+constexpr float BC7_START_WEIGHTS[16] = {
+    64 / 64.0f, 60 / 64.0f, 55 / 64.0f, 51 / 64.0f, 47 / 64.0f, 43 / 64.0f, 38 / 64.0f, 34 / 64.0f,
+    30 / 64.0f, 26 / 64.0f, 21 / 64.0f, 17 / 64.0f, 13 / 64.0f, 9 / 64.0f, 4 / 64.0f, 0 / 64.0f,
+};
+
+// 7-bit endpoint channels plus one shared p-bit per endpoint
+struct BC7Endpoints {
+    int values[2][4] = {};
+    int pBits[2] = {};
+};
+
+void BuildBC7Palette(const BC7Endpoints& endpoints, int (&palette)[16][4]) {
+    int expanded[2][4];
+    for (uint32_t e = 0; e < 2; ++e) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            expanded[e][c] = (endpoints.values[e][c] << 1) | endpoints.pBits[e];
+        }
+    }
+    for (uint32_t i = 0; i < 16; ++i) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            palette[i][c] = ((64 - BC7_WEIGHTS[i]) * expanded[0][c] + BC7_WEIGHTS[i] * expanded[1][c] + 32) >> 6;
+        }
+    }
+}
+
+// The palette is all but evenly spaced along the endpoint line, so the
+// projection finds the nearest entry to within one; the exact error decides
+// between the neighbors. A fifth of the work of testing all sixteen.
+uint32_t SelectBC7Indices(const int (&pixels)[TEXTURE_BLOCK_PIXELS][4], const int (&palette)[16][4], uint8_t* indices) {
+    int direction[4];
+    int lengthSquared = 0;
+    for (uint32_t c = 0; c < 4; ++c) {
+        direction[c] = palette[15][c] - palette[0][c];
+        lengthSquared += direction[c] * direction[c];
+    }
+    const float scale = lengthSquared > 0 ? 15.0f / lengthSquared : 0.0f;
+
+    uint32_t totalError = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        int projection = 0;
+        for (uint32_t c = 0; c < 4; ++c) {
+            projection += (pixels[i][c] - palette[0][c]) * direction[c];
+        }
+        const int guess = RoundToInt(projection * scale, 15);
+
+        uint32_t bestError = UINT32_MAX;
+        for (int entry = std::max(guess - 1, 0); entry <= std::min(guess + 1, 15); ++entry) {
+            uint32_t error = 0;
+            for (uint32_t c = 0; c < 4; ++c) {
+                const int delta = pixels[i][c] - palette[entry][c];
+                error += static_cast<uint32_t>(delta * delta);
+            }
+            if (error < bestError) {
+                bestError = error;
+                indices[i] = static_cast<uint8_t>(entry);
+            }
+        }
+        totalError += bestError;
+    }
+    return totalError;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* data) : m_data(data) {}
+
+    void Write(uint32_t value, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i, ++m_position) {
+            if ((value >> i) & 1) {
+                m_data[m_position >> 3] |= static_cast<uint8_t>(1 << (m_position & 7));
+            }
+        }
+    }
+
+private:
+    uint8_t* m_data;
+    uint32_t m_position = 0;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* data) : m_data(data) {}
+
+    uint32_t Read(uint32_t count) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; ++i, ++m_position) {
+            value |= static_cast<uint32_t>((m_data[m_position >> 3] >> (m_position & 7)) & 1) << i;
+        }
+        return value;
+    }
+
+private:
+    const uint8_t* m_data;
+    uint32_t m_position = 0;
+};
+
+} // namespace
+
+// =============================================================================
+// Encoding
+// =============================================================================
+
+void EncodeBC1Block(const uint8_t* pixels, uint8_t* block) {
+    EncodeColorBlock(pixels, block);
+}
+
+void EncodeBC3Block(const uint8_t* pixels, uint8_t* block) {
+    EncodeBC4Block(pixels, 3, block);
+    EncodeColorBlock(pixels, block + 8);
+}
+
+void EncodeBC4Block(const uint8_t* pixels, uint32_t channel, uint8_t* block) {
+    int values[TEXTURE_BLOCK_PIXELS][1];
+    int minimum = 255;
+    int maximum = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        values[i][0] = pixels[i * 4 + channel];
+        minimum = std::min(minimum, values[i][0]);
+        maximum = std::max(maximum, values[i][0]);
+    }
+
+    // Eight-value mode between the block's extremes
+    uint8_t indices[TEXTURE_BLOCK_PIXELS] = {};
+    if (maximum > minimum) {
+        int palette[8][1];
+        BuildBC4Palette(maximum, minimum, palette);
+        SelectIndices<1>(values, palette, 8, indices);
+    }
+
+    block[0] = static_cast<uint8_t>(maximum);
+    block[1] = static_cast<uint8_t>(minimum);
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        bits |= static_cast<uint64_t>(indices[i]) << (3 * i);
+    }
+    for (uint32_t i = 0; i < 6; ++i) {
+        block[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+}
+
+void EncodeBC5Block(const uint8_t* pixels, uint8_t* block) {
+    EncodeBC4Block(pixels, 0, block);
+    EncodeBC4Block(pixels, 1, block + 8);
+}
+
+void EncodeBC7Block(const uint8_t* pixels, uint8_t* block) {
+    float points[TEXTURE_BLOCK_PIXELS][4];
+    int colors[TEXTURE_BLOCK_PIXELS][4];
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            colors[i][c] = pixels[i * 4 + c];
+            points[i][c] = static_cast<float>(colors[i][c]);
+        }
+    }
+
+    BC7Endpoints best;
+    uint8_t bestIndices[TEXTURE_BLOCK_PIXELS] = {};
+    uint32_t bestError = UINT32_MAX;
+
+    // Each p-bit combination quantizes the endpoints differently
+    auto tryEndpoints = [&](const float (&start)[4], const float (&end)[4]) {
+        bool improved = false;
+        for (int pBits = 0; pBits < 4; ++pBits) {
+            BC7Endpoints endpoints;
+            endpoints.pBits[0] = pBits & 1;
+            endpoints.pBits[1] = pBits >> 1;
+            for (uint32_t c = 0; c < 4; ++c) {
+                endpoints.values[0][c] = RoundToInt((start[c] - endpoints.pBits[0]) * 0.5f, 127);
+                endpoints.values[1][c] = RoundToInt((end[c] - endpoints.pBits[1]) * 0.5f, 127);
+            }
+
+            int palette[16][4];
+            BuildBC7Palette(endpoints, palette);
+            uint8_t indices[TEXTURE_BLOCK_PIXELS];
+            const uint32_t error = SelectBC7Indices(colors, palette, indices);
+            if (error < bestError) {
+                bestError = error;
+                best = endpoints;
+                memcpy(bestIndices, indices, sizeof(indices));
+                improved = true;
+            }
+        }
+        return improved;
+    };
+
+    float start[4], end[4];
+    ComputeAxisEndpoints<4>(points, start, end);
+    tryEndpoints(start, end);
+    for (uint32_t iteration = 0; iteration < 2 && bestError > 0; ++iteration) {
+        if (!RefitEndpoints<4>(points, bestIndices, BC7_START_WEIGHTS, start, end) || !tryEndpoints(start, end)) {
+            break;
+        }
+    }
+
+    // The first index's high bit is implied zero
+    if (bestIndices[0] & 8) {
+        std::swap(best.values[0], best.values[1]);
+        std::swap(best.pBits[0], best.pBits[1]);
+        for (uint8_t& index : bestIndices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    memset(block, 0, 16);
+    BitWriter writer(block);
+    writer.Write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c) {
+        writer.Write(static_cast<uint32_t>(best.values[0][c]), 7);
+        writer.Write(static_cast<uint32_t>(best.values[1][c]), 7);
+    }
+    writer.Write(static_cast<uint32_t>(best.pBits[0]), 1);
+    writer.Write(static_cast<uint32_t>(best.pBits[1]), 1);
+    writer.Write(bestIndices[0], 3);
+    for (uint32_t i = 1; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        writer.Write(bestIndices[i], 4);
+    }
+}
+
+// =============================================================================
+// Decoding
+// =============================================================================
+
+void DecodeBC1Block(const uint8_t* block, uint8_t* pixels) {
+    DecodeColorBlock(block, false, pixels);
+}
+
+void DecodeBC3Block(const uint8_t* block, uint8_t* pixels) {
+    DecodeColorBlock(block + 8, true, pixels);
+    DecodeBC4Block(block, 3, pixels);
+}
+
+void DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* pixels) {
+    int palette[8][1];
+    BuildBC4Palette(block[0], block[1], palette);
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < 6; ++i) {
+        bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        pixels[i * 4 + channel] = static_cast<uint8_t>(palette[(bits >> (3 * i)) & 7][0]);
+    }
+}
+
+void DecodeBC5Block(const uint8_t* block, uint8_t* pixels) {
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        pixels[i * 4 + 2] = 0;
+        pixels[i * 4 + 3] = 255;
+    }
+    DecodeBC4Block(block, 0, pixels);
+    DecodeBC4Block(block + 8, 1, pixels);
+}
+
+bool DecodeBC7Block(const uint8_t* block, uint8_t* pixels) {
+    if ((block[0] & 0x7F) != 0x40) {
+        return false;
+    }
+
+    BitReader reader(block);
+    reader.Read(7);
+    BC7Endpoints endpoints;
+    for (uint32_t c = 0; c < 4; ++c) {
+        endpoints.values[0][c] = static_cast<int>(reader.Read(7));
+        endpoints.values[1][c] = static_cast<int>(reader.Read(7));
+    }
+    endpoints.pBits[0] = static_cast<int>(reader.Read(1));
+    endpoints.pBits[1] = static_cast<int>(reader.Read(1));
+
+    int palette[16][4];
+    BuildBC7Palette(endpoints, palette);
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const uint32_t index = reader.Read(i == 0 ? 3 : 4);
+        for (uint32_t c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+        }
+    }
+    return true;
+}
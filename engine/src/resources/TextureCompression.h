@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// =============================================================================
+// Block Compression
+// =============================================================================
+
+// CPU encoders and decoders for the BC formats, one 4x4 block at a time.
+// Pixels are always 16 RGBA8 values in row order (64 bytes); callers clamp
+// at the texture edge for blocks that hang over it. Encoders are stateless
+// and thread safe.
+//
+// Quality over speed only where it is cheap: endpoints come from the
+// principal axis of the block's colors and get one least-squares refit
+// against the chosen indices.
+
+constexpr uint32_t TEXTURE_BLOCK_DIMENSION = 4;
+constexpr uint32_t TEXTURE_BLOCK_PIXELS = 16;
+
+// RGB in 5:6:5 endpoints with 2-bit indices, 8 bytes. Alpha is ignored and
+// blocks are always written in four-color mode.
+void EncodeBC1Block(const uint8_t* pixels, uint8_t* block);
+
+// BC4 alpha followed by a BC1 color block, 16 bytes
+void EncodeBC3Block(const uint8_t* pixels, uint8_t* block);
+
+// One channel (0-3) with 8-bit endpoints and 3-bit indices, 8 bytes
+void EncodeBC4Block(const uint8_t* pixels, uint32_t channel, uint8_t* block);
+
+// Red and green as two BC4 blocks, 16 bytes. Normal maps store X and Y and
+// rebuild Z in the shader.
+void EncodeBC5Block(const uint8_t* pixels, uint8_t* block);
+
+// RGBA, 16 bytes. Only mode 6 (one subset, 7-bit endpoints plus a p-bit,
+// 4-bit indices) is searched: the best single mode for smooth color and
+// alpha, and an order of magnitude faster than a full mode search.
+void EncodeBC7Block(const uint8_t* pixels, uint8_t* block);
+
+// Decoders write 16 RGBA8 pixels. Channels a format doesn't store are 0,
+// alpha 255.
+void DecodeBC1Block(const uint8_t* block, uint8_t* pixels);
+void DecodeBC3Block(const uint8_t* block, uint8_t* pixels);
+void DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* pixels);   // Writes that channel only
+void DecodeBC5Block(const uint8_t* block, uint8_t* pixels);
+
+// Mode 6 only, what EncodeBC7Block writes. False for other modes.
+bool DecodeBC7Block(const uint8_t* block, uint8_t* pixels);
@@ -0,0 +1,82 @@
+#include "UploadBatchPlanner.h"
+#include <algorithm>
+#include <functional>
+
+size_t CoalesceBufferCopies(std::vector<BufferCopy>& copies) {
+    if (copies.size() < 2) {
+        return copies.size();
+    }
+
+    std::sort(copies.begin(), copies.end(), [](const BufferCopy& a, const BufferCopy& b) {
+        if (a.dst != b.dst) {
+            return std::less<ID3D12Resource*>()(a.dst, b.dst);
+        }
+        return a.dstOffset < b.dstOffset;
+    });
+
+    size_t merged = 0;
+    for (size_t i = 1; i < copies.size(); ++i) {
+        BufferCopy& last = copies[merged];
+        const BufferCopy& next = copies[i];
+
+        const bool contiguous = next.dst == last.dst && next.src == last.src &&
+                                next.dstOffset == last.dstOffset + last.size &&
+                                next.srcOffset == last.srcOffset + last.size;
+        if (contiguous) {
+            last.size += next.size;
+        } else {
+            copies[++merged] = next;
+        }
+    }
+
+    copies.resize(merged + 1);
+    return copies.size();
+}
+
+// =============================================================================
+// State Tracking
+// =============================================================================
+
+void BufferStateTracker::RegisterBuffer(ID3D12Resource* resource, uint32_t restingState) {
+    if (resource) {
+        m_buffers[resource] = { restingState, restingState };
+    }
+}
+
+void BufferStateTracker::Clear() {
+    m_buffers.clear();
+    m_pending.clear();
+}
+
+uint32_t BufferStateTracker::GetTrackedState(ID3D12Resource* resource) const {
+    auto it = m_buffers.find(resource);
+    return it != m_buffers.end() ? it->second.current : 0;
+}
+
+void BufferStateTracker::Transition(ID3D12Resource* resource, uint32_t state) {
+    auto it = m_buffers.find(resource);
+    if (it == m_buffers.end() || it->second.current == state) {
+        return;
+    }
+
+    m_pending.push_back({ resource, it->second.current, state });
+    it->second.current = state;
+}
+
+void BufferStateTracker::TransitionToResting() {
+    for (auto& pair : m_buffers) {
+        Transition(pair.first, pair.second.resting);
+    }
+}
+
+size_t PlanCopyBatch(std::vector<BufferCopy>& copies, BufferStateTracker& tracker, uint32_t copyDestState) {
+    CoalesceBufferCopies(copies);
+
+    // Sorted by destination, so each buffer shows up as one run
+    for (size_t i = 0; i < copies.size(); ++i) {
+        if (i == 0 || copies[i].dst != copies[i - 1].dst) {
+            tracker.Transition(copies[i].dst, copyDestState);
+        }
+    }
+    return copies.size();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+struct ID3D12Resource;
+
+// =============================================================================
+// Upload Batch Planner
+// =============================================================================
+
+// The pure CPU half of UploadBatchRecorder: copy coalescing and explicit
+// buffer state tracking. Resources are only used as keys and states are the
+// raw D3D12_RESOURCE_STATES bits, so nothing here touches the graphics API.
+
+// One buffer-to-buffer copy as queued by AddCopy
+struct BufferCopy {
+    ID3D12Resource* dst = nullptr;
+    uint64_t dstOffset = 0;
+    ID3D12Resource* src = nullptr;
+    uint64_t srcOffset = 0;
+    uint64_t size = 0;
+};
+
+// Sorts copies by destination and offset and merges neighbours that are
+// contiguous in both destination and source. Returns the merged count.
+size_t CoalesceBufferCopies(std::vector<BufferCopy>& copies);
+
+struct BufferTransition {
+    ID3D12Resource* resource = nullptr;
+    uint32_t before = 0;
+    uint32_t after = 0;
+};
+
+// Tracks the current state of every registered buffer. Transitions are
+// queued from the tracked state and skipped when the buffer is already
+// there; unregistered resources (upload heaps) are assumed to stay in their
+// creation state and never get a transition.
+class BufferStateTracker {
+public:
+    // Resting state is where the buffer is expected between command lists
+    void RegisterBuffer(ID3D12Resource* resource, uint32_t restingState);
+    void Clear();
+
+    bool IsRegistered(ID3D12Resource* resource) const { return m_buffers.count(resource) != 0; }
+    // 0 (COMMON) for unregistered resources
+    uint32_t GetTrackedState(ID3D12Resource* resource) const;
+
+    void Transition(ID3D12Resource* resource, uint32_t state);
+    void TransitionToResting();
+
+    const std::vector<BufferTransition>& GetPendingTransitions() const { return m_pending; }
+    void ClearPendingTransitions() { m_pending.clear(); }
+
+private:
+    struct TrackedBuffer {
+        uint32_t current;
+        uint32_t resting;
+    };
+
+    std::unordered_map<ID3D12Resource*, TrackedBuffer> m_buffers;
+    std::vector<BufferTransition> m_pending;
+};
+
+// Coalesces a frame's copies and queues one transition into copyDestState
+// per destination buffer. Returns the number of copies left to record.
+size_t PlanCopyBatch(std::vector<BufferCopy>& copies, BufferStateTracker& tracker, uint32_t copyDestState);
@@ -0,0 +1,71 @@
+#include "UploadBatchRecorder.h"
+
+void UploadBatchRecorder::RegisterBuffer(ID3D12Resource* resource, D3D12_RESOURCE_STATES restingState) {
+    m_tracker.RegisterBuffer(resource, static_cast<uint32_t>(restingState));
+}
+
+void UploadBatchRecorder::Clear() {
+    m_tracker.Clear();
+    m_barriers.clear();
+    m_copies.clear();
+}
+
+D3D12_RESOURCE_STATES UploadBatchRecorder::GetTrackedState(ID3D12Resource* resource) const {
+    return static_cast<D3D12_RESOURCE_STATES>(m_tracker.GetTrackedState(resource));
+}
+
+void UploadBatchRecorder::Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+    m_tracker.Transition(resource, static_cast<uint32_t>(state));
+}
+
+void UploadBatchRecorder::FlushBarriers(ID3D12GraphicsCommandList* cmdList) {
+    for (const BufferTransition& transition : m_tracker.GetPendingTransitions()) {
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        barrier.Transition.pResource = transition.resource;
+        barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(transition.before);
+        barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(transition.after);
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        m_barriers.push_back(barrier);
+    }
+    m_tracker.ClearPendingTransitions();
+
+    if (m_barriers.empty()) {
+        return;
+    }
+
+    cmdList->ResourceBarrier(static_cast<UINT>(m_barriers.size()), m_barriers.data());
+    m_stats.barriers += m_barriers.size();
+    m_barriers.clear();
+}
+
+void UploadBatchRecorder::RestoreRestingStates(ID3D12GraphicsCommandList* cmdList) {
+    m_tracker.TransitionToResting();
+    FlushBarriers(cmdList);
+}
+
+void UploadBatchRecorder::AddCopy(ID3D12Resource* dst, uint64_t dstOffset,
+                                  ID3D12Resource* src, uint64_t srcOffset, uint64_t size) {
+    if (dst && src && size > 0) {
+        m_copies.push_back({ dst, dstOffset, src, srcOffset, size });
+        m_stats.queuedCopies++;
+    }
+}
+
+void UploadBatchRecorder::Flush(ID3D12GraphicsCommandList* cmdList) {
+    if (m_copies.empty()) {
+        return;
+    }
+
+    PlanCopyBatch(m_copies, m_tracker, static_cast<uint32_t>(D3D12_RESOURCE_STATE_COPY_DEST));
+    FlushBarriers(cmdList);
+
+    for (const BufferCopy& copy : m_copies) {
+        cmdList->CopyBufferRegion(copy.dst, copy.dstOffset, copy.src, copy.srcOffset, copy.size);
+        m_stats.copiedBytes += copy.size;
+    }
+    m_stats.recordedCopies += m_copies.size();
+
+    m_copies.clear();
+}
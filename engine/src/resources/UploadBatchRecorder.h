@@ -0,0 +1,61 @@
+#pragma once
+
+#include <d3d12.h>
+#include <cstdint>
+#include <vector>
+
+#include "UploadBatchPlanner.h"
+
+// =============================================================================
+// Batched Upload Recording
+// =============================================================================
+
+// Collects a frame's copies and records them with one barrier per destination
+// buffer on the way in and one on the way out, instead of a pair per copy.
+//
+// States are tracked by a BufferStateTracker and the transitions it queues
+// are batched into a single ResourceBarrier call.
+//
+// Per frame:
+//   Transition / FlushBarriers   optional, for other copy work on the same list
+//   AddCopy ... Flush(cmdList)
+//   RestoreRestingStates(cmdList) before the list is executed
+class UploadBatchRecorder {
+public:
+    struct Statistics {
+        uint64_t queuedCopies = 0;      // AddCopy calls
+        uint64_t recordedCopies = 0;    // CopyBufferRegion calls after merging
+        uint64_t barriers = 0;
+        uint64_t copiedBytes = 0;
+    };
+
+    UploadBatchRecorder() = default;
+
+    // Prevent copying
+    UploadBatchRecorder(const UploadBatchRecorder&) = delete;
+    UploadBatchRecorder& operator=(const UploadBatchRecorder&) = delete;
+
+    // Resting state is where the buffer is expected between command lists
+    void RegisterBuffer(ID3D12Resource* resource, D3D12_RESOURCE_STATES restingState);
+    void Clear();
+    D3D12_RESOURCE_STATES GetTrackedState(ID3D12Resource* resource) const;
+
+    // Queued transitions, recorded together by the next FlushBarriers
+    void Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+    void FlushBarriers(ID3D12GraphicsCommandList* cmdList);
+    void RestoreRestingStates(ID3D12GraphicsCommandList* cmdList);
+
+    // Copies are recorded by Flush, destinations are left in COPY_DEST
+    void AddCopy(ID3D12Resource* dst, uint64_t dstOffset, ID3D12Resource* src, uint64_t srcOffset, uint64_t size);
+    void Flush(ID3D12GraphicsCommandList* cmdList);
+    bool HasPendingCopies() const { return !m_copies.empty(); }
+
+    const Statistics& GetStatistics() const { return m_stats; }
+
+private:
+    BufferStateTracker m_tracker;
+    std::vector<D3D12_RESOURCE_BARRIER> m_barriers;
+    std::vector<BufferCopy> m_copies;
+
+    Statistics m_stats;
+};
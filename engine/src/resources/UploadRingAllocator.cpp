@@ -0,0 +1,105 @@
+#include "UploadRingAllocator.h"
+
+UploadRingAllocator::UploadRingAllocator(size_t size, size_t alignment)
+    : m_size(size)
+    , m_alignment(alignment ? alignment : DEFAULT_ALIGNMENT)
+{
+}
+
+uint32_t UploadRingAllocator::Allocate(size_t size, uint64_t fenceValue) {
+    size_t alignedSize = AlignUp(size);
+
+    size_t offset = 0;
+    size_t skipped = 0;
+    if (!FindSpace(alignedSize, offset, skipped)) {
+        return UINT32_MAX; // Out of space until a fence completes
+    }
+
+    m_head = offset + alignedSize;
+    m_usedSpace += skipped + alignedSize;
+    m_allocatedTotal += skipped + alignedSize;
+
+    // Allocations sharing a fence retire together, pending ones are kept
+    // apart so each can be assigned its own
+    if (!m_retirements.empty() && m_retirements.back().fenceValue == fenceValue && fenceValue != PENDING_FENCE) {
+        m_retirements.back().head = m_head;
+        m_retirements.back().allocatedTotal = m_allocatedTotal;
+    } else {
+        m_retirements.push_back({ fenceValue, offset, m_head, m_allocatedTotal });
+    }
+
+    return static_cast<uint32_t>(offset);
+}
+
+void UploadRingAllocator::ReclaimCompleted(uint64_t completedFenceValue) {
+    while (!m_retirements.empty() && m_retirements.front().fenceValue <= completedFenceValue) {
+        const Retirement& retirement = m_retirements.front();
+        m_usedSpace -= static_cast<size_t>(retirement.allocatedTotal - m_retiredTotal);
+        m_retiredTotal = retirement.allocatedTotal;
+        m_tail = retirement.head;
+        m_retirements.pop_front();
+    }
+
+    // Start over at the front once drained, keeping the largest run contiguous
+    if (m_usedSpace == 0) {
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+bool UploadRingAllocator::SetFence(uint32_t offset, uint64_t fenceValue) {
+    for (Retirement& retirement : m_retirements) {
+        if (retirement.start == offset && retirement.fenceValue == PENDING_FENCE) {
+            // A value lower than an earlier entry's still waits for that one
+            retirement.fenceValue = fenceValue;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UploadRingAllocator::Reset() {
+    m_head = 0;
+    m_tail = 0;
+    m_usedSpace = 0;
+    m_retiredTotal = m_allocatedTotal;
+    m_retirements.clear();
+}
+
+bool UploadRingAllocator::CanAllocate(size_t size) const {
+    size_t offset = 0;
+    size_t skipped = 0;
+    return FindSpace(AlignUp(size), offset, skipped);
+}
+
+size_t UploadRingAllocator::AlignUp(size_t size) const {
+    return ((size + m_alignment - 1) / m_alignment) * m_alignment;
+}
+
+bool UploadRingAllocator::FindSpace(size_t alignedSize, size_t& outOffset, size_t& outSkipped) const {
+    outSkipped = 0;
+    if (alignedSize == 0 || alignedSize > m_size || m_usedSpace == m_size) {
+        return false;
+    }
+
+    if (m_usedSpace == 0 || m_head > m_tail) {
+        // Free space is [head, size) followed by [0, tail)
+        if (m_head + alignedSize <= m_size) {
+            outOffset = m_head;
+            return true;
+        }
+        if (alignedSize <= m_tail) {
+            outOffset = 0;
+            outSkipped = m_size - m_head;
+            return true;
+        }
+        return false;
+    }
+
+    // Wrapped: free space is [head, tail)
+    if (m_head + alignedSize <= m_tail) {
+        outOffset = m_head;
+        return true;
+    }
+    return false;
+}
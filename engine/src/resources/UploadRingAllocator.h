@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+
+// =============================================================================
+// Ring Allocator for Upload Heaps
+// =============================================================================
+
+// Offset allocator over a staging buffer that the CPU writes and the GPU
+// copies from. Every allocation carries the fence value of the submission
+// that reads it; space behind it is only handed out again once that fence
+// has completed, so a copy still in flight is never overwritten.
+//
+// Allocations are contiguous: one that does not fit before the end of the
+// buffer skips the tail and starts at offset 0, and the skipped bytes retire
+// with it. Fence values passed to Allocate must not decrease.
+//
+// When the consuming submission is not known yet (data written ahead of the
+// copy), allocate with PENDING_FENCE and assign the value later with
+// SetFence. Until then the allocation and everything after it stay in use.
+class UploadRingAllocator {
+public:
+    static constexpr uint64_t PENDING_FENCE = UINT64_MAX;
+
+    explicit UploadRingAllocator(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+    ~UploadRingAllocator() = default;
+
+    // Prevent copying
+    UploadRingAllocator(const UploadRingAllocator&) = delete;
+    UploadRingAllocator& operator=(const UploadRingAllocator&) = delete;
+
+    // Allocation methods
+    uint32_t Allocate(size_t size, uint64_t fenceValue);    // Returns UINT32_MAX when out of space
+    void ReclaimCompleted(uint64_t completedFenceValue);
+    bool SetFence(uint32_t offset, uint64_t fenceValue);    // Only for PENDING_FENCE allocations
+    void Reset();                                           // Only when the GPU is idle
+
+    // Query methods
+    size_t GetUsedSpace() const { return m_usedSpace; }
+    size_t GetAvailableSpace() const { return m_size - m_usedSpace; }
+    size_t GetTotalSize() const { return m_size; }
+    uint32_t GetPendingFenceCount() const { return static_cast<uint32_t>(m_retirements.size()); }
+
+    // Utility
+    bool CanAllocate(size_t size) const;
+
+private:
+    static constexpr size_t DEFAULT_ALIGNMENT = 256;
+
+    // Everything allocated up to 'head' (and counted up to 'allocatedTotal')
+    // is free once fenceValue completes. 'start' is the first allocation's offset.
+    struct Retirement {
+        uint64_t fenceValue;
+        size_t start;
+        size_t head;
+        uint64_t allocatedTotal;
+    };
+
+    size_t AlignUp(size_t size) const;
+    bool FindSpace(size_t alignedSize, size_t& outOffset, size_t& outSkipped) const;
+
+    size_t m_size;
+    size_t m_alignment;
+    size_t m_head = 0;              // Next write position
+    size_t m_tail = 0;              // Oldest byte still in use
+    size_t m_usedSpace = 0;         // Includes skipped tail bytes
+
+    // Monotonic byte counters, their difference is the in-flight size
+    uint64_t m_allocatedTotal = 0;
+    uint64_t m_retiredTotal = 0;
+
+    std::deque<Retirement> m_retirements;
+};
@@ -0,0 +1,438 @@
+#include "VertexLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERTEX_LAYOUT_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define VERTEX_LAYOUT_USE_SSE2 0
+#endif
+
+namespace {
+
+uint32_t PositionSize(PositionEncoding encoding) {
+    return encoding == PositionEncoding::Unorm16 ? 4 * sizeof(uint16_t) : 3 * sizeof(float);
+}
+
+uint32_t NormalSize(NormalEncoding encoding) {
+    switch (encoding) {
+        case NormalEncoding::Float32: return 3 * sizeof(float);
+        case NormalEncoding::Oct16: return 2 * sizeof(int16_t);
+        default: return 0;
+    }
+}
+
+uint32_t UVSize(UVEncoding encoding) {
+    switch (encoding) {
+        case UVEncoding::Float32: return 2 * sizeof(float);
+        case UVEncoding::Half: return 2 * sizeof(uint16_t);
+        default: return 0;
+    }
+}
+
+uint32_t ColorSize(ColorEncoding encoding) {
+    return encoding == ColorEncoding::Unorm8 ? 4 : 3 * sizeof(float);
+}
+
+inline int16_t QuantizeSnorm16(float value) {
+    value = std::min(std::max(value, -1.0f), 1.0f);
+    return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+const float DEFAULT_NORMAL[3] = { 0.0f, 0.0f, 1.0f };
+const float DEFAULT_UV[2] = { 0.0f, 0.0f };
+
+#if !VERTEX_LAYOUT_USE_SSE2
+inline uint16_t QuantizeUnorm16(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+}
+
+inline uint8_t QuantizeUnorm8(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+}
+
+void EncodePositionScalar(const float position[3], const float invScale[3], const float bias[3],
+                          uint8_t* dst) {
+    uint16_t packed[4];
+    for (int axis = 0; axis < 3; ++axis) {
+        packed[axis] = QuantizeUnorm16((position[axis] - bias[axis]) * invScale[axis]);
+    }
+    packed[3] = 0;
+    memcpy(dst, packed, sizeof(packed));
+}
+
+void EncodeColorScalar(const float color[3], uint8_t* dst) {
+    dst[0] = QuantizeUnorm8(color[0]);
+    dst[1] = QuantizeUnorm8(color[1]);
+    dst[2] = QuantizeUnorm8(color[2]);
+    dst[3] = 255;
+}
+#endif
+
+#if VERTEX_LAYOUT_USE_SSE2
+inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// FloatToHalf on four lanes, same results bit for bit. Halves end up in the
+// low 16 bits of each 32-bit lane.
+inline __m128i FloatToHalf4(__m128 value) {
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+    const __m128i magnitude = _mm_xor_si128(bits, sign);
+
+    // Normal range: rebias the exponent, then round the 13 dropped bits to
+    // nearest even by adding just under half plus the kept lowest bit
+    const __m128i odd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+    __m128i half = _mm_add_epi32(magnitude, _mm_set1_epi32(static_cast<int>(0xC8000FFFu)));
+    half = _mm_srli_epi32(_mm_add_epi32(half, odd), 13);
+
+    // Below the smallest normal half: adding 0.5f lines the mantissa up with
+    // the half's subnormal steps and the FPU rounds to nearest even
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(126 << 23));
+    const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), magic)),
+                                            _mm_castps_si128(magic));
+
+    const __m128i isSubnormal = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(0x38800000));
+    const __m128i isOverflow = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x477FEFFF));
+    const __m128i isNaN = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7F800000));
+    half = Select(isSubnormal, subnormal, half);
+    half = Select(isOverflow, _mm_set1_epi32(0x7C00), half);
+    half = Select(isNaN, _mm_set1_epi32(0x7E00), half);
+    return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+}
+
+// QuantizeSnorm16 on four lanes. lround rounds halves away from zero, so
+// truncate and step out when the exact remainder reaches one half.
+inline __m128i QuantizeSnorm16x4(__m128 value) {
+    value = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    const __m128 scaled = _mm_mul_ps(value, _mm_set1_ps(32767.0f));
+    __m128i rounded = _mm_cvttps_epi32(scaled);
+    const __m128 remainder = _mm_sub_ps(scaled, _mm_cvtepi32_ps(rounded));
+    rounded = _mm_sub_epi32(rounded, _mm_castps_si128(_mm_cmpge_ps(remainder, _mm_set1_ps(0.5f))));
+    rounded = _mm_add_epi32(rounded, _mm_castps_si128(_mm_cmple_ps(remainder, _mm_set1_ps(-0.5f))));
+    return rounded;
+}
+
+// Writes the four 32-bit lanes to four consecutive vertices
+inline void StoreLanes(__m128i lanes, uint8_t* dst, uint32_t stride) {
+    for (int lane = 0; lane < 4; ++lane) {
+        const int packed = _mm_cvtsi128_si32(lanes);
+        memcpy(dst + lane * stride, &packed, sizeof(packed));
+        lanes = _mm_srli_si128(lanes, 4);
+    }
+}
+
+// EncodeOctahedral for four normals (xyz each)
+void EncodeOctahedral4(const float* normals, uint8_t* dst, uint32_t stride) {
+    const __m128 x = _mm_setr_ps(normals[0], normals[3], normals[6], normals[9]);
+    const __m128 y = _mm_setr_ps(normals[1], normals[4], normals[7], normals[10]);
+    const __m128 z = _mm_setr_ps(normals[2], normals[5], normals[8], normals[11]);
+
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 length = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)),
+                                     _mm_andnot_ps(signMask, z));
+    const __m128 valid = _mm_cmpgt_ps(length, zero);
+
+    __m128 octX = _mm_div_ps(x, length);
+    __m128 octY = _mm_div_ps(y, length);
+
+    // Fold the lower hemisphere over the diagonals
+    const __m128 signX = Select(_mm_cmpge_ps(octX, zero), one, _mm_set1_ps(-1.0f));
+    const __m128 signY = Select(_mm_cmpge_ps(octY, zero), one, _mm_set1_ps(-1.0f));
+    const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, octY)), signX);
+    const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, octX)), signY);
+    const __m128 lower = _mm_cmplt_ps(z, zero);
+    octX = _mm_and_ps(valid, Select(lower, foldedX, octX));
+    octY = _mm_and_ps(valid, Select(lower, foldedY, octY));
+
+    const __m128i packedX = QuantizeSnorm16x4(octX);
+    const __m128i packedY = QuantizeSnorm16x4(octY);
+    StoreLanes(_mm_unpacklo_epi16(_mm_packs_epi32(packedX, packedX), _mm_packs_epi32(packedY, packedY)), dst, stride);
+}
+
+// FloatToHalf for two uvs, written to two consecutive vertices
+void EncodeHalfUV2(const float* uvs, uint8_t* dst, uint32_t stride) {
+    // No unsigned 32->16 pack in SSE2: shift into signed range and back
+    __m128i halves = _mm_sub_epi32(FloatToHalf4(_mm_loadu_ps(uvs)), _mm_set1_epi32(32768));
+    halves = _mm_xor_si128(_mm_packs_epi32(halves, halves), _mm_set1_epi16(static_cast<short>(0x8000)));
+
+    const int first = _mm_cvtsi128_si32(halves);
+    const int second = _mm_cvtsi128_si32(_mm_srli_si128(halves, 4));
+    memcpy(dst, &first, sizeof(first));
+    memcpy(dst + stride, &second, sizeof(second));
+}
+#endif
+
+// Oct16 normals for count vertices, dst points at the first vertex's normal
+void EncodeOctahedralNormals(const float* normals, uint32_t count, uint8_t* dst, uint32_t stride) {
+    uint32_t i = 0;
+    if (!normals) {
+        int16_t packed[2];
+        EncodeOctahedral(DEFAULT_NORMAL, packed);
+        for (; i < count; ++i) {
+            memcpy(dst + static_cast<size_t>(i) * stride, packed, sizeof(packed));
+        }
+        return;
+    }
+
+#if VERTEX_LAYOUT_USE_SSE2
+    for (; i + 4 <= count; i += 4) {
+        EncodeOctahedral4(normals + static_cast<size_t>(i) * 3, dst + static_cast<size_t>(i) * stride, stride);
+    }
+#endif
+    for (; i < count; ++i) {
+        int16_t packed[2];
+        EncodeOctahedral(normals + static_cast<size_t>(i) * 3, packed);
+        memcpy(dst + static_cast<size_t>(i) * stride, packed, sizeof(packed));
+    }
+}
+
+// Half UVs for count vertices, dst points at the first vertex's uv
+void EncodeHalfUVs(const float* uvs, uint32_t count, uint8_t* dst, uint32_t stride) {
+    uint32_t i = 0;
+    if (!uvs) {
+        const uint16_t packed[2] = { FloatToHalf(DEFAULT_UV[0]), FloatToHalf(DEFAULT_UV[1]) };
+        for (; i < count; ++i) {
+            memcpy(dst + static_cast<size_t>(i) * stride, packed, sizeof(packed));
+        }
+        return;
+    }
+
+#if VERTEX_LAYOUT_USE_SSE2
+    for (; i + 2 <= count; i += 2) {
+        EncodeHalfUV2(uvs + static_cast<size_t>(i) * 2, dst + static_cast<size_t>(i) * stride, stride);
+    }
+#endif
+    for (; i < count; ++i) {
+        const float* uv = uvs + static_cast<size_t>(i) * 2;
+        const uint16_t packed[2] = { FloatToHalf(uv[0]), FloatToHalf(uv[1]) };
+        memcpy(dst + static_cast<size_t>(i) * stride, packed, sizeof(packed));
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// Layout
+// =============================================================================
+
+uint32_t VertexLayout::GetNormalOffset() const {
+    return PositionSize(position);
+}
+
+uint32_t VertexLayout::GetUVOffset() const {
+    return GetNormalOffset() + NormalSize(normal);
+}
+
+uint32_t VertexLayout::GetColorOffset() const {
+    return GetUVOffset() + UVSize(uv);
+}
+
+uint32_t VertexLayout::GetStride() const {
+    return GetColorOffset() + ColorSize(color);
+}
+
+VertexLayout VertexLayout::Float(bool withNormals, bool withUVs) {
+    VertexLayout layout;
+    layout.normal = withNormals ? NormalEncoding::Float32 : NormalEncoding::None;
+    layout.uv = withUVs ? UVEncoding::Float32 : UVEncoding::None;
+    return layout;
+}
+
+VertexLayout VertexLayout::Compact(bool withNormals, bool withUVs) {
+    VertexLayout layout;
+    layout.position = PositionEncoding::Unorm16;
+    layout.normal = withNormals ? NormalEncoding::Oct16 : NormalEncoding::None;
+    layout.uv = withUVs ? UVEncoding::Half : UVEncoding::None;
+    layout.color = ColorEncoding::Unorm8;
+    return layout;
+}
+
+MeshDecode MakeMeshDecode(const VertexLayout& layout, const MeshBounds& bounds) {
+    MeshDecode decode;
+    if (layout.position == PositionEncoding::Unorm16) {
+        for (int axis = 0; axis < 3; ++axis) {
+            decode.scale[axis] = bounds.max[axis] - bounds.min[axis];
+            decode.bias[axis] = bounds.min[axis];
+        }
+    }
+    return decode;
+}
+
+// =============================================================================
+// Encoding
+// =============================================================================
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    // NaN stays NaN, overflow and infinity saturate to infinity
+    if (magnitude > 0x7F800000u) {
+        return static_cast<uint16_t>(sign | 0x7E00u);
+    }
+    if (magnitude >= 0x477FF000u) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    // Below the smallest normal half: shift the implicit-one mantissa into
+    // place and round to nearest even
+    if (magnitude < 0x38800000u) {
+        if (magnitude < 0x33000000u) {
+            return static_cast<uint16_t>(sign);
+        }
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Normal range: rebias the exponent and round the mantissa to nearest
+    // even, a carry out of the mantissa bumps the exponent as it should
+    uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const uint32_t remainder = magnitude & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1))) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+void EncodeOctahedral(const float normal[3], int16_t out[2]) {
+    const float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    if (length <= 0.0f) {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    float x = normal[0] / length;
+    float y = normal[1] / length;
+
+    // Fold the lower hemisphere over the diagonals
+    if (normal[2] < 0.0f) {
+        const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    out[0] = QuantizeSnorm16(x);
+    out[1] = QuantizeSnorm16(y);
+}
+
+void EncodeVertices(const VertexLayout& layout, const MeshDecode& decode,
+                    const VertexAttributes* vertices, const float* normals, const float* uvs,
+                    uint32_t count, uint8_t* dst) {
+    const uint32_t stride = layout.GetStride();
+    const uint32_t normalOffset = layout.GetNormalOffset();
+    const uint32_t uvOffset = layout.GetUVOffset();
+    const uint32_t colorOffset = layout.GetColorOffset();
+
+    // A flat axis encodes as 0 and decodes to the bias
+    float invScale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        invScale[axis] = decode.scale[axis] > 0.0f ? 1.0f / decode.scale[axis] : 0.0f;
+    }
+
+    const bool quantizedPosition = layout.position == PositionEncoding::Unorm16;
+    const bool quantizedColor = layout.color == ColorEncoding::Unorm8;
+
+#if VERTEX_LAYOUT_USE_SSE2
+    const __m128 simdInvScale = _mm_setr_ps(invScale[0] * 65535.0f, invScale[1] * 65535.0f,
+                                            invScale[2] * 65535.0f, 0.0f);
+    const __m128 simdBias = _mm_setr_ps(decode.bias[0], decode.bias[1], decode.bias[2], 0.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 unorm16Max = _mm_set1_ps(65535.0f);
+    const __m128 unorm8Max = _mm_set1_ps(255.0f);
+    const __m128 colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 opaqueAlpha = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    const __m128i signFlip32 = _mm_set1_epi32(32768);
+    const __m128i signFlip16 = _mm_set1_epi16(static_cast<short>(0x8000));
+#endif
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const VertexAttributes& vertex = vertices[i];
+        uint8_t* out = dst + static_cast<size_t>(i) * stride;
+
+        // Position
+        if (quantizedPosition) {
+#if VERTEX_LAYOUT_USE_SSE2
+            // Loads position and color[0]; the w lane is zeroed by the scale
+            const __m128 position = _mm_loadu_ps(&vertex.position[0]);
+            __m128 scaled = _mm_mul_ps(_mm_sub_ps(position, simdBias), simdInvScale);
+            scaled = _mm_min_ps(_mm_max_ps(scaled, zero), unorm16Max);
+            __m128i quantized = _mm_cvttps_epi32(_mm_add_ps(scaled, half));
+
+            // No unsigned 32->16 pack in SSE2: shift into signed range and back
+            quantized = _mm_packs_epi32(_mm_sub_epi32(quantized, signFlip32), quantized);
+            quantized = _mm_xor_si128(quantized, signFlip16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), quantized);
+#else
+            EncodePositionScalar(vertex.position, invScale, decode.bias, out);
+#endif
+        } else {
+            memcpy(out, vertex.position, 3 * sizeof(float));
+        }
+
+        // Normal and UV, the packed encodings run as separate passes below
+        if (layout.normal == NormalEncoding::Float32) {
+            const float* normal = normals ? normals + static_cast<size_t>(i) * 3 : DEFAULT_NORMAL;
+            memcpy(out + normalOffset, normal, 3 * sizeof(float));
+        }
+        if (layout.uv == UVEncoding::Float32) {
+            const float* uv = uvs ? uvs + static_cast<size_t>(i) * 2 : DEFAULT_UV;
+            memcpy(out + uvOffset, uv, 2 * sizeof(float));
+        }
+
+        // Color
+        if (quantizedColor) {
+#if VERTEX_LAYOUT_USE_SSE2
+            // Load from position[2] so the read stays inside the vertex, then
+            // rotate to (r, g, b, 1)
+            __m128 color = _mm_loadu_ps(&vertex.position[2]);
+            color = _mm_shuffle_ps(color, color, _MM_SHUFFLE(0, 3, 2, 1));
+            color = _mm_or_ps(_mm_and_ps(color, colorMask), opaqueAlpha);
+            color = _mm_min_ps(_mm_max_ps(color, zero), one);
+            __m128i quantized = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, unorm8Max), half));
+            quantized = _mm_packs_epi32(quantized, quantized);
+            quantized = _mm_packus_epi16(quantized, quantized);
+            const int packed = _mm_cvtsi128_si32(quantized);
+            memcpy(out + colorOffset, &packed, sizeof(packed));
+#else
+            EncodeColorScalar(vertex.color, out + colorOffset);
+#endif
+        } else {
+            memcpy(out + colorOffset, vertex.color, 3 * sizeof(float));
+        }
+    }
+
+    // Packed normals and UVs convert several vertices per step
+    if (layout.normal == NormalEncoding::Oct16) {
+        EncodeOctahedralNormals(normals, count, dst + normalOffset, stride);
+    }
+    if (layout.uv == UVEncoding::Half) {
+        EncodeHalfUVs(uvs, count, dst + uvOffset, stride);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include "RenderTypes.h"
+
+// =============================================================================
+// Vertex Layouts
+// =============================================================================
+
+enum class PositionEncoding : uint8_t {
+    Float32,    // float3
+    Unorm16     // unorm16x4 relative to the mesh AABB, w unused
+};
+
+enum class NormalEncoding : uint8_t {
+    None,
+    Float32,    // float3
+    Oct16       // Octahedral snorm16x2
+};
+
+enum class UVEncoding : uint8_t {
+    None,
+    Float32,    // float2
+    Half        // half2
+};
+
+enum class ColorEncoding : uint8_t {
+    Float32,    // float3
+    Unorm8      // unorm8x4, alpha 1
+};
+
+// Attribute encodings of the shared vertex buffer. Attributes are packed in
+// the order position, normal, uv, color. Every format maps to a DXGI format
+// the input assembler expands to float, so shaders read the same types for
+// any layout; only Unorm16 positions and Oct16 normals need decoding.
+struct VertexLayout {
+    PositionEncoding position = PositionEncoding::Float32;
+    NormalEncoding normal = NormalEncoding::None;
+    UVEncoding uv = UVEncoding::None;
+    ColorEncoding color = ColorEncoding::Float32;
+
+    uint32_t GetNormalOffset() const;
+    uint32_t GetUVOffset() const;
+    uint32_t GetColorOffset() const;
+    uint32_t GetStride() const;
+
+    bool IsQuantized() const { return position == PositionEncoding::Unorm16; }
+
+    // 24 bytes without normals/uvs, same bytes as VertexAttributes
+    static VertexLayout Float(bool withNormals = false, bool withUVs = false);
+
+    // 12 bytes without normals/uvs, 4 more for each
+    static VertexLayout Compact(bool withNormals = false, bool withUVs = false);
+};
+
+inline bool operator==(const VertexLayout& a, const VertexLayout& b) {
+    return a.position == b.position && a.normal == b.normal && a.uv == b.uv && a.color == b.color;
+}
+
+// Decode parameters for a mesh encoded with this layout over these bounds
+MeshDecode MakeMeshDecode(const VertexLayout& layout, const MeshBounds& bounds);
+
+// Writes count vertices in the layout to dst (count * stride bytes). normals
+// (xyz) and uvs (xy) are optional; missing ones encode as +Z and 0.
+void EncodeVertices(const VertexLayout& layout, const MeshDecode& decode,
+                    const VertexAttributes* vertices, const float* normals, const float* uvs,
+                    uint32_t count, uint8_t* dst);
+
+// Scalar building blocks, also used to check the SIMD paths
+uint16_t FloatToHalf(float value);
+void EncodeOctahedral(const float normal[3], int16_t out[2]);
@@ -1,4 +1,5 @@
 #include "SceneUtils.h"
+#include "components/Renderable.h"
 
 GameObject* SceneUtils::addGameObjectComponent(entt::registry& registry, entt::entity entity, const SceneData& data) {
     if (!registry.valid(entity)) {
@@ -25,3 +26,98 @@ void SceneUtils::createEmptyGameObject(entt::registry& registry, const SceneData
     entt::entity entity = registry.create();
     addGameObjectComponent(registry, entity, data);
 }
+
+std::vector<entt::entity> SceneUtils::createSceneHierarchy(entt::registry& registry, const std::vector<SceneData>& nodes,
+                                                           const std::vector<size_t>& rootNodes,
+                                                           const std::vector<MeshHandle>& meshes) {
+    std::vector<entt::entity> roots;
+    roots.reserve(rootNodes.size());
+
+    // Depth first with an explicit stack, imported hierarchies can be deep
+    struct PendingNode {
+        size_t node;
+        entt::entity parent;
+    };
+    std::vector<PendingNode> stack;
+    std::vector<bool> created(nodes.size(), false);
+
+    for (size_t root : rootNodes) {
+        if (root >= nodes.size()) {
+            continue;
+        }
+        stack.push_back({ root, entt::null });
+
+        while (!stack.empty()) {
+            const PendingNode pending = stack.back();
+            stack.pop_back();
+            if (created[pending.node]) {
+                continue;
+            }
+            created[pending.node] = true;
+
+            const SceneData& data = nodes[pending.node];
+            entt::entity entity = registry.create();
+            addGameObjectComponent(registry, entity, data);
+
+            if (data.meshIndex >= 0 && static_cast<size_t>(data.meshIndex) < meshes.size() &&
+                meshes[data.meshIndex] != INVALID_MESH_HANDLE) {
+                registry.emplace<MeshHandle>(entity, meshes[data.meshIndex]);
+            }
+
+            if (pending.parent == entt::null) {
+                roots.push_back(entity);
+            } else {
+                registry.emplace<Parent>(entity, pending.parent);
+                registry.get_or_emplace<Children>(pending.parent).children.push_back(entity);
+            }
+
+            // Reversed so children are created, and listed, in order
+            for (auto it = data.children.rbegin(); it != data.children.rend(); ++it) {
+                if (*it < nodes.size()) {
+                    stack.push_back({ *it, entity });
+                }
+            }
+        }
+    }
+
+    return roots;
+}
+
+void SceneUtils::createOcclusionBenchmarkScene(entt::registry& registry, MeshHandle occluderMesh, MeshHandle propMesh,
+                                               uint32_t wallCount, uint32_t propsPerSide) {
+    const float wallSpacing = 6.0f;
+    const float propSpacing = 1.2f;
+    const float gridExtent = (propsPerSide - 1) * propSpacing;
+
+    for (uint32_t wall = 0; wall < wallCount; ++wall) {
+        float wallZ = -4.0f - wall * wallSpacing;
+
+        SceneData wallData;
+        wallData.name = "Occluder Wall " + std::to_string(wall);
+        wallData.position = glm::vec3(0.0f, 0.0f, wallZ);
+        wallData.scale = glm::vec3(gridExtent + 4.0f, gridExtent + 4.0f, 0.5f);
+
+        entt::entity wallEntity = registry.create();
+        addGameObjectComponent(registry, wallEntity, wallData);
+        registry.emplace<MeshHandle>(wallEntity, occluderMesh);
+        registry.emplace<Occluder>(wallEntity);
+
+        // Props sit between this wall and the next one
+        for (uint32_t y = 0; y < propsPerSide; ++y) {
+            for (uint32_t x = 0; x < propsPerSide; ++x) {
+                SceneData propData;
+                propData.name = "Prop";
+                propData.position = glm::vec3(
+                    x * propSpacing - gridExtent * 0.5f,
+                    y * propSpacing - gridExtent * 0.5f,
+                    wallZ - wallSpacing * 0.5f
+                );
+                propData.scale = glm::vec3(0.4f);
+
+                entt::entity propEntity = registry.create();
+                addGameObjectComponent(registry, propEntity, propData);
+                registry.emplace<MeshHandle>(propEntity, propMesh);
+            }
+        }
+    }
+}
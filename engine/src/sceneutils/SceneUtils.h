@@ -1,10 +1,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
 
 #include "components/GameObject.h"
+#include "resources/RenderTypes.h"
 #include "SceneData.h"
 
 class SceneUtils {
@@ -32,4 +34,32 @@ public:
      * @param data - The scene data to associate with the GameObject.
      */
     static void createEmptyGameObject(entt::registry& registry, const SceneData& data);
+
+    /**
+     * Creates one GameObject per node reachable from the roots and links them with
+     * Parent/Children. Node transforms are taken as local to their parent.
+     * @param registry - The registry to create the GameObjects in.
+     * @param nodes - Scene nodes, children refer to indices in this list.
+     * @param rootNodes - Indices of the nodes without a parent.
+     * @param meshes - Mesh handle per SceneData::meshIndex; invalid handles are not attached.
+     * @return The root entities, in rootNodes order.
+     */
+    static std::vector<entt::entity> createSceneHierarchy(entt::registry& registry, const std::vector<SceneData>& nodes,
+                                                          const std::vector<size_t>& rootNodes,
+                                                          const std::vector<MeshHandle>& meshes);
+
+    // =========================================================================
+    // Benchmark Scenes
+    // =========================================================================
+    /**
+     * Populates an occlusion culling stress scene: a row of walls along -Z, each
+     * hiding a grid of small props. Walls are tagged as occluders.
+     * @param registry - The registry to populate.
+     * @param occluderMesh - Unit cube created with isOccluder, stretched into walls.
+     * @param propMesh - Mesh used for the hidden props.
+     * @param wallCount - Number of walls.
+     * @param propsPerSide - Props behind each wall form a propsPerSide x propsPerSide grid.
+     */
+    static void createOcclusionBenchmarkScene(entt::registry& registry, MeshHandle occluderMesh, MeshHandle propMesh,
+                                              uint32_t wallCount = 8, uint32_t propsPerSide = 16);
 };
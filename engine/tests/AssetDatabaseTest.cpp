@@ -0,0 +1,172 @@
+// =============================================================================
+// Asset Database Test
+// =============================================================================
+//
+// AssetDatabase over a scratch source tree with a cooker that copies its
+// source and follows "include" lines. A reloaded database with nothing
+// changed hashes and cooks nothing; a renamed file keeps its GUID and output
+// without a re-cook; editing a file two includes deep re-cooks exactly the
+// assets that reach it; a cooker version bump re-cooks everything; a deleted
+// asset takes its output with it.
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "TestFiles.h"
+#include "jobs/JobSystem.h"
+#include "resources/AssetDatabase.h"
+
+namespace {
+
+// Copies the source to the output and records which sources it cooked
+class CopyCooker {
+public:
+    explicit CopyCooker(const std::string& sourceDirectory)
+        : m_sourceDirectory(sourceDirectory)
+    {
+    }
+
+    AssetCooker Make(uint64_t version) {
+        AssetCooker cooker;
+        cooker.outputExtension = ".cooked";
+        cooker.version = version;
+        cooker.scanDependencies = [](const std::string&, const std::vector<uint8_t>& source) {
+            std::vector<std::string> dependencies;
+            std::istringstream lines(std::string(source.begin(), source.end()));
+            std::string word;
+            std::string path;
+            while (lines >> word >> path) {
+                if (word == "include") {
+                    dependencies.push_back(path);
+                }
+            }
+            return dependencies;
+        };
+        cooker.cook = [this](const std::string& sourcePath, const std::string& outputPath) {
+            const std::vector<uint8_t> bytes = ReadTestFile(sourcePath);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cooked.push_back(
+                std::filesystem::path(sourcePath).lexically_relative(m_sourceDirectory).generic_string());
+            return WriteTestFile(outputPath, bytes);
+        };
+        return cooker;
+    }
+
+    // Sorted, and cleared for the next update
+    std::vector<std::string> TakeCooked() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::string> cooked = std::move(m_cooked);
+        m_cooked.clear();
+        std::sort(cooked.begin(), cooked.end());
+        return cooked;
+    }
+
+private:
+    std::string m_sourceDirectory;
+    std::mutex m_mutex;
+    std::vector<std::string> m_cooked;
+};
+
+using Paths = std::vector<std::string>;
+
+std::vector<std::string> DependentPaths(const AssetDatabase& database, const std::string& path) {
+    std::vector<std::string> paths;
+    for (const AssetDatabase::Asset* asset : database.GetDependents(path)) {
+        paths.push_back(asset->path);
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("asset_database_test");
+    const std::string source = directory.File("source");
+    const std::string output = directory.File("cooked");
+    const std::string databasePath = directory.File("assets.db");
+    JobSystem jobs(2);
+    CopyCooker copier(source);
+
+    // a.mat -> lib/base.mat -> lib/shared.inc, solo.mat on its own
+    CHECK(WriteTestFile(source + "/a.mat", "include lib/base.mat\ncolor red\n"));
+    CHECK(WriteTestFile(source + "/lib/base.mat", "include shared.inc\nroughness 0.5\n"));
+    CHECK(WriteTestFile(source + "/lib/shared.inc", "constant 1\n"));
+    CHECK(WriteTestFile(source + "/solo.mat", "color blue\n"));
+
+    AssetDatabase::Statistics stats;
+    AssetGuid soloGuid;
+    std::string soloOutput;
+    {
+        AssetDatabase database(source, output);
+        database.RegisterCooker(".mat", copier.Make(1));
+        CHECK(database.Load(databasePath));
+        CHECK(database.Update(jobs, &stats));
+        CHECK(stats.files == 4 && stats.added == 4 && stats.cooked == 3 && stats.failed == 0);
+        CHECK(copier.TakeCooked() == Paths({ "a.mat", "lib/base.mat", "solo.mat" }));
+        CHECK(DependentPaths(database, "lib/shared.inc") == Paths({ "a.mat", "lib/base.mat" }));
+
+        const AssetDatabase::Asset* solo = database.FindByPath("solo.mat");
+        CHECK(solo != nullptr);
+        if (solo) {
+            soloGuid = solo->guid;
+            soloOutput = database.GetOutputPath(*solo);
+            CHECK(std::filesystem::exists(soloOutput));
+        }
+        CHECK(database.Save(databasePath));
+    }
+
+    // A new run with nothing changed: no hashing, no cooking
+    AssetDatabase database(source, output);
+    database.RegisterCooker(".mat", copier.Make(1));
+    CHECK(database.Load(databasePath));
+    CHECK(database.GetAssetCount() == 4);
+    CHECK(database.Update(jobs, &stats));
+    CHECK(stats.hashed == 0 && stats.cooked == 0 && stats.upToDate == 3);
+    CHECK(copier.TakeCooked().empty());
+
+    // Moved and renamed: same GUID, same output, nothing cooked
+    std::filesystem::create_directories(source + "/moved");
+    std::filesystem::rename(source + "/solo.mat", source + "/moved/solo2.mat");
+    CHECK(database.Update(jobs, &stats));
+    CHECK(stats.renamed == 1 && stats.added == 0 && stats.removed == 0 && stats.cooked == 0);
+    CHECK(copier.TakeCooked().empty());
+    CHECK(database.FindByPath("solo.mat") == nullptr);
+    const AssetDatabase::Asset* moved = database.FindByPath("moved/solo2.mat");
+    CHECK(moved && moved->guid == soloGuid);
+    CHECK(database.FindByGuid(soloGuid) == moved);
+    CHECK(moved && database.GetOutputPath(*moved) == soloOutput);
+    CHECK(std::filesystem::exists(soloOutput));
+
+    // Two includes deep: exactly the two assets that reach it
+    CHECK(WriteTestFile(source + "/lib/shared.inc", "constant 22\n"));
+    CHECK(database.Update(jobs, &stats));
+    CHECK(stats.hashed == 1 && stats.cooked == 2 && stats.upToDate == 1);
+    CHECK(copier.TakeCooked() == Paths({ "a.mat", "lib/base.mat" }));
+
+    // Editing the middle one leaves the leaf alone
+    CHECK(WriteTestFile(source + "/lib/base.mat", "include shared.inc\nroughness 0.25\n"));
+    CHECK(database.Update(jobs, &stats));
+    CHECK(copier.TakeCooked() == Paths({ "a.mat", "lib/base.mat" }));
+
+    // A new cooker version re-cooks everything once
+    database.RegisterCooker(".mat", copier.Make(2));
+    CHECK(database.Update(jobs, &stats));
+    CHECK(copier.TakeCooked() == Paths({ "a.mat", "lib/base.mat", "moved/solo2.mat" }));
+    CHECK(database.Update(jobs, &stats));
+    CHECK(stats.cooked == 0 && stats.upToDate == 3);
+
+    // Deleted sources take their output along
+    std::filesystem::remove(source + "/moved/solo2.mat");
+    CHECK(database.Update(jobs, &stats));
+    CHECK(stats.removed == 1 && stats.cooked == 0);
+    CHECK(!std::filesystem::exists(soloOutput));
+    CHECK(database.FindByGuid(soloGuid) == nullptr);
+
+    return FinishTests("AssetDatabaseTest");
+}
@@ -0,0 +1,237 @@
+// =============================================================================
+// Async Upload Scheduler Test
+// =============================================================================
+//
+// Drives the scheduler against a mock upload queue whose fence completes a
+// few steps late. Every upload is reported exactly once and in request
+// order, batches respect the config limits, and cancelled uploads vanish.
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/AsyncUploadScheduler.h"
+
+namespace {
+
+class MockUploadQueue : public IUploadQueue {
+public:
+    bool BeginBatch() override {
+        CHECK(!m_open);
+        if (m_refuseBegin) {
+            return false;
+        }
+        m_open = true;
+        return true;
+    }
+
+    uint64_t SubmitBatch() override {
+        CHECK(m_open);
+        m_open = false;
+        m_submitted++;
+        return m_nextValue++;
+    }
+
+    void CancelBatch() override {
+        CHECK(m_open);
+        m_open = false;
+        m_cancelled++;
+    }
+
+    uint64_t GetNextFenceValue() const override { return m_nextValue; }
+    uint64_t GetCompletedFenceValue() const override { return m_completedValue; }
+
+    // The GPU catches up to within lagBatches of the last submission
+    void Advance(uint32_t lagBatches) {
+        const uint64_t signaled = m_nextValue - 1;
+        if (signaled > m_completedValue + lagBatches) {
+            m_completedValue = signaled - lagBatches;
+        }
+    }
+    void Flush() { m_completedValue = m_nextValue - 1; }
+
+    bool m_refuseBegin = false;
+    bool m_open = false;
+    uint32_t m_submitted = 0;
+    uint32_t m_cancelled = 0;
+
+private:
+    uint64_t m_nextValue = 1;
+    uint64_t m_completedValue = 0;
+};
+
+void TestRandomSchedule(uint32_t steps, uint32_t seed) {
+    AsyncUploadScheduler::Config config;
+    config.maxBatchesInFlight = 3;
+    config.maxUploadsPerBatch = 8;
+    config.maxBytesPerBatch = 64 * 1024;
+    AsyncUploadScheduler scheduler(config);
+    MockUploadQueue queue;
+    std::mt19937 random(seed);
+
+    std::vector<uint32_t> requested;            // Enqueue order
+    std::unordered_set<uint32_t> cancelled;
+    std::vector<uint32_t> completed;
+    uint32_t nextId = 0;
+
+    uint32_t wrongFence = 0;
+    uint32_t oversizedBatches = 0;
+    uint32_t tooManyBatches = 0;
+    uint32_t tooManyUploads = 0;
+
+    auto step = [&](bool allowRefusal) {
+        // Staging memory runs out now and then: the record callback refuses
+        const uint32_t refuseAfter = allowRefusal && random() % 5 == 0 ? random() % 4 : UINT32_MAX;
+        uint32_t recorded = 0;
+        size_t batchBytes = 0;
+        const uint32_t submitted = scheduler.Submit(queue, [&](uint32_t id, uint64_t fenceValue) {
+            if (recorded == refuseAfter) {
+                return false;
+            }
+            wrongFence += fenceValue != queue.GetNextFenceValue() ? 1 : 0;
+            batchBytes += id % 7 == 0 ? 96 * 1024 : 10 * 1024;
+            recorded++;
+            return true;
+        });
+        CHECK(submitted == recorded);
+        if (recorded > 1 && batchBytes > config.maxBytesPerBatch) {
+            oversizedBatches++;
+        }
+        tooManyUploads += recorded > config.maxUploadsPerBatch ? 1 : 0;
+        tooManyBatches += scheduler.GetStatistics().batchesInFlight > config.maxBatchesInFlight ? 1 : 0;
+        CHECK(!queue.m_open);
+
+        queue.Advance(random() % 3);
+        scheduler.Retire(queue.GetCompletedFenceValue(), completed);
+    };
+
+    for (uint32_t i = 0; i < steps; ++i) {
+        // Sizes follow the id so the record callback can account batch bytes
+        const uint32_t uploads = random() % 6;
+        for (uint32_t u = 0; u < uploads; ++u) {
+            const uint32_t id = nextId++;
+            scheduler.Enqueue(id, id % 7 == 0 ? 96 * 1024 : 10 * 1024);
+            requested.push_back(id);
+            CHECK(scheduler.GetState(id) == AsyncUploadScheduler::UploadState::Queued);
+        }
+
+        // Cancel one of the recent uploads, queued or in flight
+        if (!requested.empty() && random() % 4 == 0) {
+            const uint32_t id = requested[requested.size() - 1 - random() % std::min<size_t>(requested.size(), 16)];
+            if (scheduler.GetState(id) != AsyncUploadScheduler::UploadState::Unknown) {
+                scheduler.Cancel(id);
+                CHECK(scheduler.GetState(id) == AsyncUploadScheduler::UploadState::Unknown);
+                cancelled.insert(id);
+            }
+        }
+
+        step(true);
+    }
+
+    // Drain: everything still wanted eventually completes
+    for (uint32_t i = 0; i < steps && !scheduler.IsIdle(); ++i) {
+        step(false);
+    }
+    queue.Flush();
+    scheduler.Retire(queue.GetCompletedFenceValue(), completed);
+    CHECK(scheduler.IsIdle());
+
+    // Completed in request order, each once, none of the cancelled ones
+    std::vector<uint32_t> expected;
+    for (uint32_t id : requested) {
+        if (cancelled.count(id) == 0) {
+            expected.push_back(id);
+        }
+    }
+    std::vector<uint32_t> reported;
+    for (uint32_t id : completed) {
+        if (cancelled.count(id) == 0) {
+            reported.push_back(id);
+        }
+    }
+    CHECK(reported == expected);
+    CHECK(completed.size() == reported.size());
+    for (uint32_t id : expected) {
+        CHECK(scheduler.GetState(id) == AsyncUploadScheduler::UploadState::Unknown);
+    }
+
+    CHECK(wrongFence == 0);
+    CHECK(oversizedBatches == 0);
+    CHECK(tooManyBatches == 0);
+    CHECK(tooManyUploads == 0);
+
+    const AsyncUploadScheduler::Statistics stats = scheduler.GetStatistics();
+    CHECK(stats.submittedBatches == queue.m_submitted);
+    CHECK(stats.deferredBatches == queue.m_cancelled);
+    CHECK(stats.completedUploads == completed.size());
+    printf("  %u uploads, %u cancelled, %u batches, %u deferred\n", nextId,
+           static_cast<uint32_t>(cancelled.size()), queue.m_submitted, queue.m_cancelled);
+}
+
+void TestInFlightTracking() {
+    AsyncUploadScheduler::Config config;
+    config.maxBatchesInFlight = 1;
+    config.maxUploadsPerBatch = 2;
+    AsyncUploadScheduler scheduler(config);
+    MockUploadQueue queue;
+    auto recordAll = [](uint32_t, uint64_t) { return true; };
+
+    for (uint32_t id = 0; id < 4; ++id) {
+        scheduler.Enqueue(id, 1024);
+    }
+    CHECK(scheduler.Submit(queue, recordAll) == 2);
+    CHECK(scheduler.GetState(0) == AsyncUploadScheduler::UploadState::InFlight);
+    CHECK(scheduler.GetFenceValue(0) == 1);
+    CHECK(scheduler.GetState(2) == AsyncUploadScheduler::UploadState::Queued);
+    CHECK(scheduler.GetFenceValue(2) == 0);
+
+    // The single batch slot is taken until fence 1 completes
+    CHECK(scheduler.Submit(queue, recordAll) == 0);
+    CHECK(queue.m_submitted == 1 && queue.m_cancelled == 0);
+
+    // Cancelled in flight: still copied, never reported
+    scheduler.Cancel(1);
+    std::vector<uint32_t> completed;
+    scheduler.Retire(0, completed);
+    CHECK(completed.empty());
+    scheduler.Retire(1, completed);
+    CHECK(completed == std::vector<uint32_t>{ 0 });
+
+    CHECK(scheduler.Submit(queue, recordAll) == 2);
+    CHECK(scheduler.GetLastSubmittedFenceValue() == 2);
+}
+
+void TestRefusals() {
+    AsyncUploadScheduler scheduler;
+    MockUploadQueue queue;
+    scheduler.Enqueue(5, 1024);
+
+    // Queue cannot open a batch: nothing moves
+    queue.m_refuseBegin = true;
+    CHECK(scheduler.Submit(queue, [](uint32_t, uint64_t) { return true; }) == 0);
+    CHECK(scheduler.GetState(5) == AsyncUploadScheduler::UploadState::Queued);
+    queue.m_refuseBegin = false;
+
+    // Recorder refuses the first upload: the batch is cancelled, not submitted
+    CHECK(scheduler.Submit(queue, [](uint32_t, uint64_t) { return false; }) == 0);
+    CHECK(queue.m_cancelled == 1 && queue.m_submitted == 0);
+    CHECK(scheduler.GetStatistics().deferredBatches == 1);
+    CHECK(scheduler.GetState(5) == AsyncUploadScheduler::UploadState::Queued);
+
+    // A single upload over the byte limit still gets a batch of its own
+    scheduler.Enqueue(6, 64 * 1024 * 1024);
+    CHECK(scheduler.Submit(queue, [](uint32_t, uint64_t) { return true; }) == 1);
+    CHECK(scheduler.Submit(queue, [](uint32_t, uint64_t) { return true; }) == 1);
+    CHECK(scheduler.GetFenceValue(6) == 2);
+}
+
+} // namespace
+
+int main() {
+    TestRandomSchedule(20000, 34);
+    TestInFlightTracking();
+    TestRefusals();
+    return FinishTests("AsyncUploadSchedulerTest");
+}
@@ -0,0 +1,267 @@
+// =============================================================================
+// Clustered Light Grid Test
+// =============================================================================
+//
+// Cluster lists are checked against brute force: a light whose sphere has a
+// sample point inside a froxel must be in that cluster's list, and a listed
+// light must reach the froxel's bounding box. Parallel builds match serial
+// ones.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestCheck.h"
+#include "jobs/JobSystem.h"
+#include "renderer/ClusteredLightGrid.h"
+
+namespace {
+
+constexpr float FOV_Y = 60.0f;
+constexpr float ASPECT = 16.0f / 9.0f;
+constexpr float NEAR_PLANE = 0.1f;
+constexpr float FAR_PLANE = 200.0f;
+constexpr float TOLERANCE = 1e-3f;
+
+struct Froxel {
+    float depth0, depth1;           // View depth range
+    float ndcX0, ndcX1;
+    float ndcY0, ndcY1;
+    glm::vec3 min;                  // Bounding box in x, y, depth
+    glm::vec3 max;
+};
+
+const float TAN_HALF_FOV_Y = std::tan(glm::radians(FOV_Y) * 0.5f);
+const float TAN_HALF_FOV_X = TAN_HALF_FOV_Y * ASPECT;
+
+Froxel GetFroxel(const ClusteredLightGrid::Config& config, uint32_t x, uint32_t y, uint32_t slice) {
+    const float ratio = FAR_PLANE / NEAR_PLANE;
+    Froxel froxel;
+    froxel.depth0 = NEAR_PLANE * std::pow(ratio, static_cast<float>(slice) / config.slicesZ);
+    froxel.depth1 = NEAR_PLANE * std::pow(ratio, static_cast<float>(slice + 1) / config.slicesZ);
+    froxel.ndcX0 = -1.0f + 2.0f * x / config.tilesX;
+    froxel.ndcX1 = -1.0f + 2.0f * (x + 1) / config.tilesX;
+    froxel.ndcY0 = -1.0f + 2.0f * y / config.tilesY;
+    froxel.ndcY1 = -1.0f + 2.0f * (y + 1) / config.tilesY;
+
+    // The box spans the eight corners
+    froxel.min = glm::vec3(1e30f, 1e30f, froxel.depth0);
+    froxel.max = glm::vec3(-1e30f, -1e30f, froxel.depth1);
+    for (float depth : { froxel.depth0, froxel.depth1 }) {
+        for (float ndcX : { froxel.ndcX0, froxel.ndcX1 }) {
+            froxel.min.x = std::min(froxel.min.x, ndcX * TAN_HALF_FOV_X * depth);
+            froxel.max.x = std::max(froxel.max.x, ndcX * TAN_HALF_FOV_X * depth);
+        }
+        for (float ndcY : { froxel.ndcY0, froxel.ndcY1 }) {
+            froxel.min.y = std::min(froxel.min.y, ndcY * TAN_HALF_FOV_Y * depth);
+            froxel.max.y = std::max(froxel.max.y, ndcY * TAN_HALF_FOV_Y * depth);
+        }
+    }
+    return froxel;
+}
+
+bool IsInsideFroxel(const Froxel& froxel, const glm::vec3& point) {
+    if (point.z < froxel.depth0 || point.z > froxel.depth1) {
+        return false;
+    }
+    const float ndcX = point.x / (point.z * TAN_HALF_FOV_X);
+    const float ndcY = point.y / (point.z * TAN_HALF_FOV_Y);
+    return ndcX >= froxel.ndcX0 && ndcX <= froxel.ndcX1 && ndcY >= froxel.ndcY0 && ndcY <= froxel.ndcY1;
+}
+
+float DistanceToBox(const Froxel& froxel, const glm::vec3& point) {
+    const glm::vec3 d = glm::max(glm::max(froxel.min - point, point - froxel.max), glm::vec3(0.0f));
+    return glm::length(d);
+}
+
+// Center plus points just inside the surface, fixed directions
+std::vector<glm::vec3> GetSphereSamples(const glm::vec3& center, float radius) {
+    std::vector<glm::vec3> samples = { center };
+    std::mt19937 random(7);
+    std::normal_distribution<float> normal;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const glm::vec3 direction = glm::normalize(glm::vec3(normal(random), normal(random), normal(random)));
+        samples.push_back(center + direction * (radius * 0.98f));
+        samples.push_back(center + direction * (radius * 0.5f));
+    }
+    return samples;
+}
+
+std::vector<ClusteredLightGrid::ClusterLight> RandomPointLights(uint32_t count, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> spread(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> range(0.5f, 8.0f);
+
+    std::vector<ClusteredLightGrid::ClusterLight> lights(count);
+    for (auto& light : lights) {
+        light.position = glm::vec3(spread(random), spread(random) * 0.5f, spread(random) - 30.0f);
+        light.range = range(random);
+    }
+    return lights;
+}
+
+void TestSliceForDepth(const ClusteredLightGrid& grid) {
+    const uint32_t slices = grid.GetConfig().slicesZ;
+    CHECK(grid.GetSliceForDepth(0.0f) == 0);
+    CHECK(grid.GetSliceForDepth(NEAR_PLANE) == 0);
+    CHECK(grid.GetSliceForDepth(FAR_PLANE * 2.0f) == slices - 1);
+
+    uint32_t previous = 0;
+    for (float depth = NEAR_PLANE; depth < FAR_PLANE; depth *= 1.05f) {
+        const uint32_t slice = grid.GetSliceForDepth(depth);
+        CHECK(slice >= previous);
+        previous = slice;
+    }
+}
+
+void TestPointLightsMatchBruteForce(JobSystem& jobSystem) {
+    ClusteredLightGrid grid;
+    grid.SetProjection(FOV_Y, ASPECT, NEAR_PLANE, FAR_PLANE);
+    TestSliceForDepth(grid);
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 5.0f), glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const std::vector<ClusteredLightGrid::ClusterLight> lights = RandomPointLights(300, 30);
+    grid.Build(lights, view, nullptr);
+
+    const ClusteredLightGrid::Config& config = grid.GetConfig();
+    const auto& ranges = grid.GetClusterRanges();
+    const auto& indices = grid.GetLightIndices();
+    CHECK(grid.GetStatistics().overflowedClusters == 0);
+    CHECK(grid.GetStatistics().nonEmptyClusters > 0);
+
+    // Lights in (x, y, depth) view space
+    std::vector<glm::vec3> viewCenters;
+    std::vector<std::vector<glm::vec3>> lightSamples;
+    for (const auto& light : lights) {
+        const glm::vec4 center = view * glm::vec4(light.position, 1.0f);
+        viewCenters.push_back(glm::vec3(center.x, center.y, -center.z));
+        lightSamples.push_back(GetSphereSamples(viewCenters.back(), light.range));
+    }
+
+    uint32_t missing = 0;
+    uint32_t spurious = 0;
+    uint32_t unsorted = 0;
+    for (uint32_t slice = 0; slice < config.slicesZ; ++slice) {
+        for (uint32_t y = 0; y < config.tilesY; ++y) {
+            for (uint32_t x = 0; x < config.tilesX; ++x) {
+                const Froxel froxel = GetFroxel(config, x, y, slice);
+                const ClusteredLightGrid::ClusterRange& range = ranges[grid.GetClusterIndex(x, y, slice)];
+                const uint32_t* begin = indices.data() + range.offset;
+                const uint32_t* end = begin + range.count;
+                unsorted += std::is_sorted(begin, end) ? 0 : 1;
+
+                for (uint32_t i = 0; i < lights.size(); ++i) {
+                    const bool listed = std::binary_search(begin, end, i);
+                    if (listed) {
+                        spurious += DistanceToBox(froxel, viewCenters[i]) > lights[i].range + TOLERANCE ? 1 : 0;
+                        continue;
+                    }
+                    for (const glm::vec3& sample : lightSamples[i]) {
+                        if (IsInsideFroxel(froxel, sample)) {
+                            missing++;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CHECK(missing == 0);
+    CHECK(spurious == 0);
+    CHECK(unsorted == 0);
+
+    // Same ranges and indices whatever the thread count
+    ClusteredLightGrid parallelGrid;
+    parallelGrid.SetProjection(FOV_Y, ASPECT, NEAR_PLANE, FAR_PLANE);
+    parallelGrid.Build(lights, view, &jobSystem);
+    CHECK(parallelGrid.GetLightIndices() == indices);
+    bool sameRanges = parallelGrid.GetClusterRanges().size() == ranges.size();
+    for (size_t i = 0; sameRanges && i < ranges.size(); ++i) {
+        sameRanges = parallelGrid.GetClusterRanges()[i].offset == ranges[i].offset &&
+                     parallelGrid.GetClusterRanges()[i].count == ranges[i].count;
+    }
+    CHECK(sameRanges);
+}
+
+void TestCulledLights() {
+    ClusteredLightGrid grid;
+    grid.SetProjection(FOV_Y, ASPECT, NEAR_PLANE, FAR_PLANE);
+
+    std::vector<ClusteredLightGrid::ClusterLight> lights(3);
+    lights[0].position = glm::vec3(0.0f, 0.0f, 10.0f);      // Behind the camera
+    lights[0].range = 2.0f;
+    lights[1].position = glm::vec3(0.0f, 0.0f, -300.0f);    // Past the far plane
+    lights[1].range = 2.0f;
+    lights[2].position = glm::vec3(0.0f, 0.0f, -10.0f);     // No range
+    lights[2].range = 0.0f;
+
+    grid.Build(lights, glm::mat4(1.0f), nullptr);
+    CHECK(grid.GetStatistics().inputLights == 3);
+    CHECK(grid.GetStatistics().visibleLights == 0);
+    CHECK(grid.GetLightIndices().empty());
+}
+
+void TestSpotLightStaysAhead() {
+    ClusteredLightGrid grid;
+    grid.SetProjection(FOV_Y, ASPECT, NEAR_PLANE, FAR_PLANE);
+
+    // Narrow spot 10 units ahead pointing further away
+    std::vector<ClusteredLightGrid::ClusterLight> lights(1);
+    lights[0].type = LightType::Spot;
+    lights[0].position = glm::vec3(0.0f, 0.0f, -10.0f);
+    lights[0].direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    lights[0].range = 20.0f;
+    lights[0].outerConeAngle = glm::radians(15.0f);
+    grid.Build(lights, glm::mat4(1.0f), nullptr);
+
+    const ClusteredLightGrid::Config& config = grid.GetConfig();
+    const uint32_t lightSlice = grid.GetSliceForDepth(10.0f);
+    const uint32_t axisSlice = grid.GetSliceForDepth(20.0f);
+    uint32_t nearerHits = 0;
+    bool axisHit = false;
+    for (uint32_t slice = 0; slice < config.slicesZ; ++slice) {
+        for (uint32_t cluster = grid.GetClusterIndex(0, 0, slice); cluster < grid.GetClusterIndex(0, 0, slice + 1); ++cluster) {
+            const bool lit = grid.GetClusterRanges()[cluster].count > 0;
+            nearerHits += (lit && slice < lightSlice) ? 1 : 0;
+        }
+    }
+    const uint32_t axisCluster = grid.GetClusterIndex(config.tilesX / 2, config.tilesY / 2, axisSlice);
+    axisHit = grid.GetClusterRanges()[axisCluster].count == 1;
+    CHECK(nearerHits == 0);
+    CHECK(axisHit);
+}
+
+void TestOverflow() {
+    ClusteredLightGrid::Config config;
+    config.maxLightsPerCluster = 4;
+    ClusteredLightGrid grid(config);
+    grid.SetProjection(FOV_Y, ASPECT, NEAR_PLANE, FAR_PLANE);
+
+    std::vector<ClusteredLightGrid::ClusterLight> lights(10);
+    for (auto& light : lights) {
+        light.position = glm::vec3(0.0f, 0.0f, -5.0f);
+        light.range = 1.0f;
+    }
+    grid.Build(lights, glm::mat4(1.0f), nullptr);
+
+    const ClusteredLightGrid::Statistics& stats = grid.GetStatistics();
+    CHECK(stats.overflowedClusters > 0);
+    CHECK(stats.maxLightsInCluster == 10);
+    for (const ClusteredLightGrid::ClusterRange& range : grid.GetClusterRanges()) {
+        CHECK(range.count <= config.maxLightsPerCluster);
+    }
+}
+
+} // namespace
+
+int main() {
+    JobSystem jobSystem(4);
+
+    TestPointLightsMatchBruteForce(jobSystem);
+    TestCulledLights();
+    TestSpotLightStaysAhead();
+    TestOverflow();
+    return FinishTests("ClusteredLightGridTest");
+}
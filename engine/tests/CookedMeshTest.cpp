@@ -0,0 +1,219 @@
+// =============================================================================
+// Cooked Mesh Test
+// =============================================================================
+//
+// CookMesh -> WriteCookedMeshFile -> CookedMeshFile round trip for a 16-bit
+// mesh with LODs and meshlets and a 32-bit one: the mapped views hold the
+// same bytes as the cooked arrays. Open rejects truncated files, bad headers
+// and records, indices past the vertex count in any LOD, and meshlets whose
+// offsets, counts or indices leave their arrays.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "TestFiles.h"
+#include "TestMeshes.h"
+#include "resources/CookedMesh.h"
+
+namespace {
+
+CookedMesh Cook(const TestMesh& mesh, const char* name, bool allow16Bit) {
+    CPUMesh cpuMesh;
+    cpuMesh.vertices = mesh.vertices.data();
+    cpuMesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    cpuMesh.indices = mesh.indices.data();
+    cpuMesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+    MeshCookSettings settings;
+    settings.autoLODCount = 3;
+    settings.allow16BitIndices = allow16Bit;
+    settings.optimize = true;
+    settings.buildMeshlets = true;
+    CookedMesh cooked = CookMesh(cpuMesh, settings);
+    cooked.name = name;
+    return cooked;
+}
+
+bool SameBytes(const void* a, const void* b, size_t size) {
+    return size == 0 || (a && b && memcmp(a, b, size) == 0);
+}
+
+bool SameMesh(const EncodedMesh& loaded, const CookedMesh& cooked) {
+    const EncodedMesh expected = cooked.GetEncodedMesh();
+    bool same = loaded.layout == expected.layout && loaded.vertexCount == expected.vertexCount &&
+                loaded.indexFormat == expected.indexFormat && loaded.lodCount == expected.lodCount &&
+                memcmp(loaded.lodIndexCounts, expected.lodIndexCounts, sizeof(expected.lodIndexCounts)) == 0 &&
+                memcmp(&loaded.bounds, &expected.bounds, sizeof(MeshBounds)) == 0 &&
+                loaded.meshletCount == expected.meshletCount &&
+                loaded.meshletVertexIndexCount == expected.meshletVertexIndexCount &&
+                loaded.meshletTriangleBytes == expected.meshletTriangleBytes;
+    same = same &&
+           SameBytes(loaded.vertexData, expected.vertexData, cooked.vertexData.size()) &&
+           SameBytes(loaded.indexData, expected.indexData, expected.GetIndexDataSize()) &&
+           SameBytes(loaded.meshlets, expected.meshlets, expected.meshletCount * sizeof(Meshlet)) &&
+           SameBytes(loaded.meshletBounds, expected.meshletBounds, expected.meshletCount * sizeof(MeshletBounds)) &&
+           SameBytes(loaded.meshletVertexIndices, expected.meshletVertexIndices,
+                     expected.meshletVertexIndexCount * sizeof(uint32_t)) &&
+           SameBytes(loaded.meshletTriangles, expected.meshletTriangles, expected.meshletTriangleBytes);
+    return same;
+}
+
+// File bytes with typed access to the header, records and blobs
+struct FileBytes {
+    std::vector<uint8_t> bytes;
+
+    CookedMeshFileHeader& Header() { return *reinterpret_cast<CookedMeshFileHeader*>(bytes.data()); }
+    CookedMeshRecord& Record(uint32_t index) {
+        return reinterpret_cast<CookedMeshRecord*>(bytes.data() + sizeof(CookedMeshFileHeader))[index];
+    }
+    template <typename T>
+    T* Blob(const CookedMeshBlob& blob) { return reinterpret_cast<T*>(bytes.data() + blob.offset); }
+};
+
+bool OpensAfter(const TempDirectory& directory, const FileBytes& file) {
+    const std::string path = directory.File("damaged.de3mesh");
+    WriteTestFile(path, file.bytes);
+    CookedMeshFile cookedFile;
+    return cookedFile.Open(path);
+}
+
+void TestRoundTrip(const TempDirectory& directory, const std::vector<CookedMesh>& meshes) {
+    const std::string path = directory.File("meshes.de3mesh");
+    CHECK(WriteCookedMeshFile(path, meshes));
+
+    CookedMeshFile file;
+    CHECK(file.Open(path));
+    CHECK(file.GetMeshCount() == meshes.size());
+    CHECK(file.GetVertexLayout() == meshes[0].layout);
+    for (uint32_t i = 0; i < file.GetMeshCount() && i < meshes.size(); ++i) {
+        CHECK(file.GetMeshName(i) == meshes[i].name);
+        CHECK(SameMesh(file.GetMesh(i), meshes[i]));
+
+        // Copying out of the mapping gives back the cooked mesh
+        const CookedMesh copy = CopyEncodedMesh(file.GetMesh(i));
+        CHECK(copy.vertexData == meshes[i].vertexData);
+        CHECK(copy.indexData == meshes[i].indexData);
+        CHECK(copy.lodIndexCounts == meshes[i].lodIndexCounts);
+    }
+    CHECK(file.GetMesh(file.GetMeshCount()).vertexData == nullptr);
+    CHECK(file.GetMeshName(file.GetMeshCount()).empty());
+
+    for (const CookedMesh& mesh : meshes) {
+        printf("  %s: %u vertices, %s indices, %zu LODs, %zu meshlets\n", mesh.name.c_str(), mesh.vertexCount,
+               mesh.indexFormat == IndexFormat::Uint16 ? "16-bit" : "32-bit", mesh.lodIndexCounts.size(),
+               mesh.meshlets.meshlets.size());
+    }
+}
+
+void TestCorruption(const TempDirectory& directory, const std::vector<CookedMesh>& meshes) {
+    const std::string path = directory.File("valid.de3mesh");
+    CHECK(WriteCookedMeshFile(path, meshes));
+    FileBytes valid;
+    valid.bytes = ReadTestFile(path);
+    CHECK(OpensAfter(directory, valid));
+
+    const CookedMeshRecord small = valid.Record(0);
+    const CookedMeshRecord large = valid.Record(1);
+    CHECK(static_cast<IndexFormat>(small.indexFormat) == IndexFormat::Uint16);
+    CHECK(static_cast<IndexFormat>(large.indexFormat) == IndexFormat::Uint32);
+    const uint32_t smallIndices = meshes[0].GetEncodedMesh().GetTotalIndexCount();
+    const uint32_t largeIndices = meshes[1].GetEncodedMesh().GetTotalIndexCount();
+
+    // Truncated, or a header that disagrees with the file
+    FileBytes file = valid;
+    file.bytes.resize(file.bytes.size() - 1);
+    CHECK(!OpensAfter(directory, file));
+    file.bytes.resize(sizeof(CookedMeshFileHeader) + 10);
+    CHECK(!OpensAfter(directory, file));
+
+    file = valid;
+    file.Header().magic ^= 1;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Header().meshCount = 1000;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Header().vertexStride += 4;
+    CHECK(!OpensAfter(directory, file));
+
+    // Records whose counts no longer match their blobs
+    file = valid;
+    file.Record(0).vertexCount++;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Record(1).lodCount = 0;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Record(1).indexFormat = 7;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Record(0).meshletCount--;
+    CHECK(!OpensAfter(directory, file));
+
+    // Index values: the largest valid one opens, one past the vertex count
+    // fails in the first, a middle and the last LOD of either width
+    file = valid;
+    file.Blob<uint16_t>(small.indexData)[smallIndices - 1] = static_cast<uint16_t>(small.vertexCount - 1);
+    file.Blob<uint32_t>(large.indexData)[largeIndices - 1] = large.vertexCount - 1;
+    CHECK(OpensAfter(directory, file));
+    for (uint32_t position : { 0u, small.lodIndexCounts[0] + 5, smallIndices - 1 }) {
+        file = valid;
+        file.Blob<uint16_t>(small.indexData)[position] = static_cast<uint16_t>(small.vertexCount);
+        CHECK(!OpensAfter(directory, file));
+    }
+    for (uint32_t position : { 0u, large.lodIndexCounts[0] + 5, largeIndices - 1 }) {
+        file = valid;
+        file.Blob<uint32_t>(large.indexData)[position] = large.vertexCount;
+        CHECK(!OpensAfter(directory, file));
+    }
+    file = valid;
+    file.Blob<uint32_t>(large.indexData)[7] = UINT32_MAX;
+    CHECK(!OpensAfter(directory, file));
+
+    // Meshlets leaving their arrays, past the limits, or naming vertices
+    // that don't exist
+    const uint32_t last = small.meshletCount - 1;
+    const Meshlet lastMeshlet = valid.Blob<Meshlet>(valid.Record(0).meshlets)[last];
+    CHECK(lastMeshlet.vertexOffset + lastMeshlet.vertexCount == small.meshletVertexIndexCount);
+    CHECK(lastMeshlet.triangleOffset + lastMeshlet.triangleCount * 3 <= small.meshletTriangleBytes);
+
+    file = valid;
+    file.Blob<Meshlet>(small.meshlets)[last].vertexOffset++;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<Meshlet>(small.meshlets)[last].vertexOffset = UINT32_MAX;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<Meshlet>(small.meshlets)[last].triangleOffset = small.meshletTriangleBytes - lastMeshlet.triangleCount * 3 + 1;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<Meshlet>(small.meshlets)[0].triangleCount = MAX_MESHLET_TRIANGLES + 1;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<Meshlet>(small.meshlets)[0].vertexCount = MAX_MESHLET_VERTICES + 1;
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<uint8_t>(small.meshletTriangles)[lastMeshlet.triangleOffset] = static_cast<uint8_t>(lastMeshlet.vertexCount);
+    CHECK(!OpensAfter(directory, file));
+    file = valid;
+    file.Blob<uint32_t>(small.meshletVertexIndices)[3] = small.vertexCount;
+    CHECK(!OpensAfter(directory, file));
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("cooked_mesh_test");
+    const std::vector<CookedMesh> meshes = {
+        Cook(MakeTorus(), "torus", true),
+        Cook(MakeBumpySphere(), "bumpy sphere", false),
+    };
+    CHECK(meshes[0].lodIndexCounts.size() > 2);
+    CHECK(!meshes[0].meshlets.meshlets.empty());
+
+    TestRoundTrip(directory, meshes);
+    TestCorruption(directory, meshes);
+    return FinishTests("CookedMeshTest");
+}
@@ -0,0 +1,123 @@
+// =============================================================================
+// Cooked Texture Test
+// =============================================================================
+//
+// GenerateMipChain on even, odd and one-texel-wide sizes: level sizes halve
+// and round down to 1x1, a constant image stays constant, and every level
+// keeps the average of level 0, so an odd size's last row and column are
+// filtered in rather than dropped.
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/CookedTexture.h"
+
+namespace {
+
+TextureImage MakeImage(uint32_t width, uint32_t height) {
+    TextureImage image;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    return image;
+}
+
+// Mean of one channel in [0, 1]
+double ChannelMean(const TextureImage& image, uint32_t channel) {
+    double sum = 0.0;
+    for (size_t i = channel; i < image.pixels.size(); i += 4) {
+        sum += image.pixels[i];
+    }
+    return sum / (255.0 * image.width * image.height);
+}
+
+void TestLevelSizes() {
+    const std::vector<TextureImage> mips = GenerateMipChain(MakeImage(37, 10), TextureUsage::Linear);
+    const uint32_t expected[][2] = { { 37, 10 }, { 18, 5 }, { 9, 2 }, { 4, 1 }, { 2, 1 }, { 1, 1 } };
+    CHECK(mips.size() == 6);
+    for (size_t level = 0; level < mips.size() && level < 6; ++level) {
+        CHECK(mips[level].width == expected[level][0]);
+        CHECK(mips[level].height == expected[level][1]);
+        CHECK(mips[level].IsValid());
+    }
+    CHECK(GenerateMipChain(MakeImage(37, 10), TextureUsage::Linear, 3).size() == 3);
+}
+
+void TestConstantImage() {
+    // Weights sum to one on every axis, in linear space and back
+    for (TextureUsage usage : { TextureUsage::Color, TextureUsage::Linear }) {
+        TextureImage image = MakeImage(13, 7);
+        for (size_t i = 0; i < image.pixels.size(); i += 4) {
+            image.pixels[i + 0] = 200;
+            image.pixels[i + 1] = 90;
+            image.pixels[i + 2] = 17;
+            image.pixels[i + 3] = 128;
+        }
+        uint32_t changed = 0;
+        for (const TextureImage& mip : GenerateMipChain(image, usage)) {
+            for (size_t i = 0; i < mip.pixels.size(); i += 4) {
+                changed += mip.pixels[i] != 200 || mip.pixels[i + 1] != 90 || mip.pixels[i + 2] != 17 ||
+                           mip.pixels[i + 3] != 128 ? 1 : 0;
+            }
+        }
+        CHECK(changed == 0);
+    }
+}
+
+void TestAveragePreserved() {
+    std::mt19937 random(50);
+    const uint32_t sizes[][2] = { { 16, 16 }, { 7, 5 }, { 17, 33 }, { 3, 3 }, { 9, 1 }, { 1, 9 }, { 255, 3 } };
+    double worstError = 0.0;
+    for (const auto& size : sizes) {
+        TextureImage image = MakeImage(size[0], size[1]);
+        for (uint8_t& value : image.pixels) {
+            value = static_cast<uint8_t>(random());
+        }
+        const std::vector<TextureImage> mips = GenerateMipChain(image, TextureUsage::Linear);
+        for (uint32_t channel = 0; channel < 4; ++channel) {
+            const double mean = ChannelMean(image, channel);
+            for (const TextureImage& mip : mips) {
+                worstError = std::max(worstError, std::fabs(ChannelMean(mip, channel) - mean));
+            }
+        }
+    }
+    // Rounding each texel to 8 bits moves the mean by half a step at most
+    CHECK(worstError < 0.501 / 255.0);
+    printf("  worst mean drift %.3f of an 8-bit step\n", worstError * 255.0);
+}
+
+void TestOddEdgeContributes() {
+    // Only the last column and the last row are lit; rounding the size
+    // down must not lose them
+    TextureImage image = MakeImage(7, 5);
+    for (uint32_t y = 0; y < image.height; ++y) {
+        for (uint32_t x = 0; x < image.width; ++x) {
+            if (x == image.width - 1 || y == image.height - 1) {
+                image.pixels[(static_cast<size_t>(y) * image.width + x) * 4] = 255;
+            }
+        }
+    }
+    const std::vector<TextureImage> mips = GenerateMipChain(image, TextureUsage::Linear);
+    CHECK(mips.size() == 3);
+    if (mips.size() == 3) {
+        const TextureImage& half = mips[1];     // 3x2
+        const uint8_t corner = half.pixels[(static_cast<size_t>(half.height) * half.width - 1) * 4];
+        const uint8_t opposite = half.pixels[0];
+        CHECK(corner > 0);
+        CHECK(opposite == 0);
+        CHECK(std::abs(static_cast<int>(mips[2].pixels[0]) - static_cast<int>(ChannelMean(image, 0) * 255.0 + 0.5)) <= 1);
+    }
+}
+
+} // namespace
+
+int main() {
+    TestLevelSizes();
+    TestConstantImage();
+    TestAveragePreserved();
+    TestOddEdgeContributes();
+    return FinishTests("CookedTextureTest");
+}
@@ -0,0 +1,155 @@
+// =============================================================================
+// DrawStream Test
+// =============================================================================
+//
+// Chunking covers the visible list in order, and encoding chunks in parallel
+// then merging gives exactly the stream a serial encode records.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "TestCheck.h"
+#include "jobs/JobSystem.h"
+#include "renderer/DrawStream.h"
+
+namespace {
+
+void TestSplitDrawChunks() {
+    CHECK(SplitDrawChunks(0, 8, 16).empty());
+
+    const uint32_t itemCounts[] = { 1, 7, 16, 100, 1000, 1001, 4099 };
+    for (uint32_t itemCount : itemCounts) {
+        for (uint32_t maxChunks = 1; maxChunks <= 9; ++maxChunks) {
+            const uint32_t minItems = 64;
+            const std::vector<DrawChunk> chunks = SplitDrawChunks(itemCount, maxChunks, minItems);
+
+            CHECK(!chunks.empty());
+            CHECK(chunks.size() <= maxChunks);
+            CHECK(chunks.front().begin == 0);
+            CHECK(chunks.back().end == itemCount);
+
+            uint32_t smallest = UINT32_MAX;
+            uint32_t largest = 0;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                if (i > 0) {
+                    CHECK(chunks[i].begin == chunks[i - 1].end);
+                }
+                smallest = std::min(smallest, chunks[i].GetCount());
+                largest = std::max(largest, chunks[i].GetCount());
+            }
+            CHECK(largest - smallest <= 1);
+            if (chunks.size() > 1) {
+                CHECK(smallest >= minItems);
+            }
+        }
+    }
+
+    // Zero limits are treated as one
+    const std::vector<DrawChunk> clamped = SplitDrawChunks(10, 0, 0);
+    CHECK(clamped.size() == 1 && clamped[0].GetCount() == 10);
+}
+
+// Mirrors the forward pass: constants per item, an index buffer switch
+// whenever the width changes, then the draw
+void EncodeItems(const DrawItem* items, uint32_t count, DrawStream& out) {
+    IndexFormat boundFormat = IndexFormat::Uint32;
+    for (uint32_t i = 0; i < count; ++i) {
+        const DrawItem& item = items[i];
+        out.SetConstants(1, 0x10000 + item.mesh * 256ull, item.mesh);
+
+        const IndexFormat format = item.mesh % 3 == 0 ? IndexFormat::Uint16 : IndexFormat::Uint32;
+        if (format != boundFormat) {
+            IndexBufferBinding binding;
+            binding.gpuAddress = 0x80000;
+            binding.format = format;
+            out.SetIndexBuffer(binding);
+            boundFormat = format;
+        }
+
+        MeshView view;
+        view.indexCount = 3 * (item.mesh % 17 + 1);
+        view.indexOffset = item.mesh * 64;
+        view.vertexOffset = item.mesh * 32;
+        out.DrawIndexed(MakeDrawIndexedArgs(view));
+    }
+}
+
+bool SameCommands(const DrawStream& a, const DrawStream& b) {
+    if (a.GetCommandCount() != b.GetCommandCount() || a.GetDrawCount() != b.GetDrawCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.GetCommandCount(); ++i) {
+        const DrawCommand& x = a.GetCommands()[i];
+        const DrawCommand& y = b.GetCommands()[i];
+        if (x.type != y.type || x.rootParameter != y.rootParameter || x.descriptorIndex != y.descriptorIndex ||
+            x.gpuAddress != y.gpuAddress || x.indexBuffer.format != y.indexBuffer.format ||
+            memcmp(&x.draw, &y.draw, sizeof(DrawIndexedArgs)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestParallelEncodeMatchesSerial(JobSystem& jobSystem) {
+    std::vector<DrawItem> items(5000);
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        items[i].mesh = (i * 7919) % 1000 + 1;
+    }
+
+    // Chunks restart with the default binding, so compare against a serial
+    // encode of the same chunks rather than of the whole list
+    const std::vector<DrawChunk> chunks = SplitDrawChunks(static_cast<uint32_t>(items.size()), 8, 256);
+    DrawStream serial;
+    for (const DrawChunk& chunk : chunks) {
+        DrawStream part;
+        EncodeItems(items.data() + chunk.begin, chunk.GetCount(), part);
+        serial.Append(part);
+    }
+    CHECK(serial.GetDrawCount() == items.size());
+
+    std::vector<DrawStream> streams;
+    EncodeDrawChunks(&jobSystem, items, chunks, EncodeItems, streams);
+    CHECK(streams.size() == chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        CHECK(streams[i].GetDrawCount() == chunks[i].GetCount());
+    }
+
+    DrawStream merged;
+    MergeDrawStreams(streams, merged);
+    CHECK(SameCommands(merged, serial));
+
+    // Without a job system the same streams come out, reused streams are cleared
+    EncodeDrawChunks(nullptr, items, chunks, EncodeItems, streams);
+    DrawStream mergedSerial;
+    MergeDrawStreams(streams, mergedSerial);
+    CHECK(SameCommands(mergedSerial, serial));
+}
+
+void TestMergeAppends() {
+    DrawStream first;
+    first.DrawIndexed(DrawIndexedArgs());
+    DrawStream second;
+    second.SetConstants(0, 1, 2);
+    second.DrawIndexed(DrawIndexedArgs());
+
+    DrawStream out;
+    out.SetConstants(0, 0, 0);
+    MergeDrawStreams({ first, DrawStream(), second }, out);
+    CHECK(out.GetCommandCount() == 4);
+    CHECK(out.GetDrawCount() == 2);
+    CHECK(out.GetCommands()[0].type == DrawCommandType::SetConstants);
+    CHECK(out.GetCommands()[1].type == DrawCommandType::DrawIndexed);
+    CHECK(out.GetCommands()[2].gpuAddress == 1);
+}
+
+} // namespace
+
+int main() {
+    JobSystem jobSystem(4);
+
+    TestSplitDrawChunks();
+    TestParallelEncodeMatchesSerial(jobSystem);
+    TestMergeAppends();
+    return FinishTests("DrawStreamTest");
+}
@@ -0,0 +1,206 @@
+// =============================================================================
+// Geometry Defrag Test
+// =============================================================================
+//
+// Planned moves only go down into space that was free in the snapshot, never
+// overlap, respect the budget and pinned blocks, and repeated compaction
+// passes gather the free space at the end of the buffer.
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/GeometryDefrag.h"
+
+namespace {
+
+// Used blocks by offset, the buffer is [0, capacity)
+struct Layout {
+    struct Used {
+        uint32_t size;
+        uint32_t id;
+    };
+    uint32_t capacity = 0;
+    std::map<uint32_t, Used> used;
+
+    std::vector<DefragBlock> GetBlocks() const {
+        std::vector<DefragBlock> blocks;
+        uint32_t cursor = 0;
+        for (const auto& entry : used) {
+            if (entry.first > cursor) {
+                blocks.push_back({ cursor, entry.first - cursor, DEFRAG_PINNED_BLOCK, false });
+            }
+            blocks.push_back({ entry.first, entry.second.size, entry.second.id, true });
+            cursor = entry.first + entry.second.size;
+        }
+        if (cursor < capacity) {
+            blocks.push_back({ cursor, capacity - cursor, DEFRAG_PINNED_BLOCK, false });
+        }
+        return blocks;
+    }
+
+    uint32_t GetHighWater() const {
+        return used.empty() ? 0 : used.rbegin()->first + used.rbegin()->second.size;
+    }
+};
+
+Layout BuildRandomLayout(uint32_t seed, uint32_t blockCount, bool withPinned) {
+    std::mt19937 random(seed);
+    Layout layout;
+    uint32_t cursor = 0;
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        cursor += random() % 3 == 0 ? (1 + random() % 64) * 256 : 0;     // Hole before it
+        const uint32_t size = (1 + random() % 32) * 256;
+        const bool pinned = withPinned && random() % 10 == 0;
+        layout.used[cursor] = { size, pinned ? DEFRAG_PINNED_BLOCK : i };
+        cursor += size;
+    }
+    layout.capacity = cursor + 64 * 256;
+    return layout;
+}
+
+// Checks a plan against the snapshot it was made from
+void CheckPlan(const Layout& layout, const std::vector<DefragMove>& moves, uint32_t budget, uint32_t movedBytes) {
+    const std::vector<DefragBlock> blocks = layout.GetBlocks();
+
+    uint32_t total = 0;
+    std::map<uint32_t, uint32_t> destinations;     // offset -> size
+    std::vector<uint32_t> movedIds;
+    for (const DefragMove& move : moves) {
+        total += move.size;
+
+        // Source is a live, movable block of that size
+        auto source = layout.used.find(move.srcOffset);
+        CHECK(source != layout.used.end());
+        if (source == layout.used.end()) {
+            continue;
+        }
+        CHECK(source->second.id == move.id && move.id != DEFRAG_PINNED_BLOCK);
+        CHECK(source->second.size == move.size);
+        CHECK(move.dstOffset < move.srcOffset);
+        movedIds.push_back(move.id);
+
+        // Destination lies inside one hole of the snapshot
+        bool insideHole = false;
+        for (const DefragBlock& block : blocks) {
+            insideHole = insideHole || (!block.used && move.dstOffset >= block.offset &&
+                                        move.dstOffset + move.size <= block.offset + block.size);
+        }
+        CHECK(insideHole);
+        destinations[move.dstOffset] = move.size;
+    }
+
+    // Destinations never overlap each other
+    uint32_t previousEnd = 0;
+    for (const auto& destination : destinations) {
+        CHECK(destination.first >= previousEnd);
+        previousEnd = destination.first + destination.second;
+    }
+
+    std::sort(movedIds.begin(), movedIds.end());
+    CHECK(std::adjacent_find(movedIds.begin(), movedIds.end()) == movedIds.end());
+    CHECK(total == movedBytes);
+    CHECK(movedBytes <= budget);
+}
+
+// The copies retire: blocks live at their destination, sources become free
+void ApplyMoves(Layout& layout, const std::vector<DefragMove>& moves) {
+    for (const DefragMove& move : moves) {
+        const Layout::Used block = layout.used[move.srcOffset];
+        layout.used.erase(move.srcOffset);
+        layout.used[move.dstOffset] = block;
+    }
+}
+
+void TestPlansAreValid() {
+    for (uint32_t seed = 0; seed < 50; ++seed) {
+        const Layout layout = BuildRandomLayout(seed, 200, seed % 2 == 0);
+        const uint32_t budget = seed % 5 == 0 ? UINT32_MAX : (1 + seed) * 4096;
+
+        std::vector<DefragMove> moves;
+        const uint32_t movedBytes = PlanDefragMoves(layout.GetBlocks(), budget, moves);
+        CheckPlan(layout, moves, budget, movedBytes);
+    }
+}
+
+void TestPassesCompact() {
+    Layout layout = BuildRandomLayout(32, 500, true);
+    uint32_t usedBytes = 0;
+    std::vector<uint32_t> pinnedOffsets;
+    for (const auto& entry : layout.used) {
+        usedBytes += entry.second.size;
+        if (entry.second.id == DEFRAG_PINNED_BLOCK) {
+            pinnedOffsets.push_back(entry.first);
+        }
+    }
+
+    const float initialFragmentation = ComputeFragmentation(layout.GetBlocks());
+    uint32_t highWater = layout.GetHighWater();
+    uint32_t passes = 0;
+    std::vector<DefragMove> moves;
+    for (; passes < 1000; ++passes) {
+        if (PlanDefragMoves(layout.GetBlocks(), 64 * 1024, moves) == 0) {
+            break;
+        }
+        ApplyMoves(layout, moves);
+
+        // Blocks only move down, so the top of the used range never rises
+        CHECK(layout.GetHighWater() <= highWater);
+        highWater = layout.GetHighWater();
+    }
+    CHECK(passes < 1000);
+
+    uint32_t usedAfter = 0;
+    for (const auto& entry : layout.used) {
+        usedAfter += entry.second.size;
+    }
+    CHECK(usedAfter == usedBytes);
+    for (uint32_t offset : pinnedOffsets) {
+        auto it = layout.used.find(offset);
+        CHECK(it != layout.used.end() && it->second.id == DEFRAG_PINNED_BLOCK);
+    }
+    CHECK(ComputeFragmentation(layout.GetBlocks()) < initialFragmentation);
+    printf("  %u passes, fragmentation %.2f -> %.2f\n", passes, initialFragmentation,
+           ComputeFragmentation(layout.GetBlocks()));
+}
+
+void TestEdgeCases() {
+    std::vector<DefragMove> moves;
+
+    // No holes, nothing to do
+    Layout full;
+    full.used[0] = { 512, 1 };
+    full.used[512] = { 512, 2 };
+    full.capacity = 1024;
+    CHECK(PlanDefragMoves(full.GetBlocks(), UINT32_MAX, moves) == 0 && moves.empty());
+    CHECK(ComputeFragmentation(full.GetBlocks()) == 0.0f);
+
+    // One hole below one block: it moves, but not with a budget too small
+    Layout simple;
+    simple.used[1024] = { 512, 7 };
+    simple.capacity = 1536;
+    CHECK(PlanDefragMoves(simple.GetBlocks(), 256, moves) == 0);
+    CHECK(PlanDefragMoves(simple.GetBlocks(), 512, moves) == 512);
+    CHECK(moves.size() == 1 && moves[0].id == 7 && moves[0].dstOffset == 0);
+
+    // A pinned block stays, even with room below it
+    simple.used[1024].id = DEFRAG_PINNED_BLOCK;
+    CHECK(PlanDefragMoves(simple.GetBlocks(), UINT32_MAX, moves) == 0);
+
+    // Two equal holes split the free space in half
+    Layout split;
+    split.used[256] = { 256, 1 };
+    split.capacity = 768;
+    CHECK(ComputeFragmentation(split.GetBlocks()) == 0.5f);
+}
+
+} // namespace
+
+int main() {
+    TestPlansAreValid();
+    TestPassesCompact();
+    TestEdgeCases();
+    return FinishTests("GeometryDefragTest");
+}
@@ -0,0 +1,96 @@
+// =============================================================================
+// Index Narrowing Test
+// =============================================================================
+//
+// SelectIndexFormat switches to 32-bit past 65536 vertices. NarrowIndices
+// matches a plain cast for every count from 0 to 40, so the SSE2 blocks of
+// eight and the scalar tail both run, from unaligned source and destination
+// pointers, with values around the signed 16-bit boundary the SSE2 bias
+// works across. WriteSpanIndices lands at the requested index in either
+// width, and AlignIndexDataSize pads to whole 32-bit indices.
+
+#include <cstring>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/IndexNarrowing.h"
+
+namespace {
+
+void TestSelectIndexFormat() {
+    CHECK(SelectIndexFormat(1) == IndexFormat::Uint16);
+    CHECK(SelectIndexFormat(65535) == IndexFormat::Uint16);
+    CHECK(SelectIndexFormat(65536) == IndexFormat::Uint16);
+    CHECK(SelectIndexFormat(65537) == IndexFormat::Uint32);
+    CHECK(SelectIndexFormat(UINT32_MAX) == IndexFormat::Uint32);
+}
+
+void TestAlignIndexDataSize() {
+    CHECK(AlignIndexDataSize(0) == 0);
+    CHECK(AlignIndexDataSize(2) == 4);
+    CHECK(AlignIndexDataSize(4) == 4);
+    CHECK(AlignIndexDataSize(6) == 8);
+    CHECK(AlignIndexDataSize(3 * sizeof(uint16_t)) == 2 * sizeof(uint32_t));
+    CHECK(AlignIndexDataSize(3 * sizeof(uint32_t)) == 3 * sizeof(uint32_t));
+}
+
+void TestNarrowIndices() {
+    // Both sides of 32768 and the ends of the range, in every lane
+    const uint32_t values[] = { 0, 1, 255, 256, 32766, 32767, 32768, 32769, 40000, 65534, 65535, 12345, 7 };
+    const uint32_t valueCount = sizeof(values) / sizeof(values[0]);
+
+    uint32_t mismatches = 0;
+    uint32_t overruns = 0;
+    for (uint32_t count = 0; count <= 40; ++count) {
+        for (uint32_t misalign = 0; misalign < 2; ++misalign) {
+            std::vector<uint32_t> source(count + 1);
+            for (uint32_t i = 0; i < count; ++i) {
+                source[misalign + i] = values[(i * 5 + count) % valueCount];
+            }
+
+            // One guard value past the end, the tail must not touch it
+            std::vector<uint16_t> narrowed(count + 2, 0xBEEF);
+            NarrowIndices(source.data() + misalign, count, narrowed.data() + misalign);
+            for (uint32_t i = 0; i < count; ++i) {
+                mismatches += narrowed[misalign + i] == static_cast<uint16_t>(source[misalign + i]) ? 0 : 1;
+            }
+            overruns += narrowed[misalign + count] == 0xBEEF ? 0 : 1;
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(overruns == 0);
+}
+
+void TestWriteSpanIndices() {
+    const uint32_t indices[] = { 3, 65535, 32768, 0, 1, 2, 40000, 9, 10, 11, 32767 };
+    const uint32_t count = sizeof(indices) / sizeof(indices[0]);
+
+    std::vector<uint16_t> narrow(count + 4, 0);
+    MeshWriteSpan span;
+    span.indices = narrow.data();
+    span.indexFormat = IndexFormat::Uint16;
+    span.indexCount = count + 4;
+    WriteSpanIndices(span, 2, indices, count);
+    bool same = narrow[0] == 0 && narrow[1] == 0 && narrow[count + 2] == 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        same = same && narrow[2 + i] == indices[i];
+    }
+    CHECK(same);
+
+    std::vector<uint32_t> wide(count + 4, 0);
+    span.indices = wide.data();
+    span.indexFormat = IndexFormat::Uint32;
+    WriteSpanIndices(span, 3, indices, count);
+    CHECK(wide[2] == 0 && wide[count + 3] == 0);
+    CHECK(memcmp(wide.data() + 3, indices, sizeof(indices)) == 0);
+}
+
+} // namespace
+
+int main() {
+    TestSelectIndexFormat();
+    TestAlignIndexDataSize();
+    TestNarrowIndices();
+    TestWriteSpanIndices();
+    return FinishTests("IndexNarrowingTest");
+}
@@ -0,0 +1,107 @@
+// =============================================================================
+// Indirect Draw Args Test
+// =============================================================================
+//
+// GenerateIndirectDraws keeps exactly the draws the direct path records, in
+// source order, and compacts culled and invalid sources away.
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "renderer/IndirectDrawArgs.h"
+
+namespace {
+
+std::vector<MeshView> BuildMeshTable(uint32_t count) {
+    std::vector<MeshView> table(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        table[i].vertexOffset = i * 100;
+        table[i].vertexCount = 100;
+        table[i].indexOffset = i * 300;
+        table[i].indexCount = i % 5 == 4 ? 0 : 3 * (i + 1);     // Some meshes not uploaded yet
+    }
+    return table;
+}
+
+// What the direct path draws: visible sources with a resident mesh, in order
+std::vector<IndirectDrawRecord> ReferenceRecords(const std::vector<IndirectDrawSource>& sources,
+                                                 const std::vector<MeshView>& meshTable) {
+    std::vector<IndirectDrawRecord> records;
+    for (const IndirectDrawSource& source : sources) {
+        if (!source.visible || source.meshSlot >= meshTable.size() || meshTable[source.meshSlot].indexCount == 0) {
+            continue;
+        }
+        IndirectDrawRecord record;
+        record.constantsAddress = source.constantsAddress;
+        record.draw = MakeDrawIndexedArgs(meshTable[source.meshSlot]);
+        records.push_back(record);
+    }
+    return records;
+}
+
+bool SameRecords(const std::vector<IndirectDrawRecord>& a, const std::vector<IndirectDrawRecord>& b) {
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(IndirectDrawRecord)) == 0);
+}
+
+void TestPrefixSum() {
+    const uint32_t values[] = { 1, 0, 1, 1, 0, 0, 1 };
+    uint32_t offsets[7] = {};
+    CHECK(ExclusivePrefixSum(values, 7, offsets) == 4);
+    const uint32_t expected[] = { 0, 1, 1, 2, 3, 3, 3 };
+    CHECK(memcmp(offsets, expected, sizeof(expected)) == 0);
+
+    // In place
+    uint32_t inPlace[7];
+    memcpy(inPlace, values, sizeof(values));
+    CHECK(ExclusivePrefixSum(inPlace, 7, inPlace) == 4);
+    CHECK(memcmp(inPlace, expected, sizeof(expected)) == 0);
+
+    CHECK(ExclusivePrefixSum(values, 0, offsets) == 0);
+}
+
+void TestMatchesDirectPath() {
+    const std::vector<MeshView> meshTable = BuildMeshTable(64);
+    std::mt19937 random(29);
+    IndirectDrawScratch scratch;
+    std::vector<IndirectDrawRecord> records;
+
+    // Shrinking and growing lists reuse the same scratch and output
+    const uint32_t sourceCounts[] = { 1000, 10, 0, 4097, 1 };
+    for (uint32_t sourceCount : sourceCounts) {
+        std::vector<IndirectDrawSource> sources(sourceCount);
+        for (uint32_t i = 0; i < sourceCount; ++i) {
+            sources[i].constantsAddress = 0x100000ull + i * 256ull;
+            sources[i].meshSlot = random() % 70;                    // Past the table end now and then
+            sources[i].visible = random() % 4 != 0 ? 1 : 0;
+        }
+
+        const uint32_t drawCount = GenerateIndirectDraws(sources, meshTable, scratch, records);
+        const std::vector<IndirectDrawRecord> expected = ReferenceRecords(sources, meshTable);
+        CHECK(drawCount == expected.size());
+        CHECK(SameRecords(records, expected));
+    }
+}
+
+void TestNothingVisible() {
+    const std::vector<MeshView> meshTable = BuildMeshTable(4);
+    std::vector<IndirectDrawSource> sources(16);
+    for (IndirectDrawSource& source : sources) {
+        source.visible = 0;
+    }
+
+    IndirectDrawScratch scratch;
+    std::vector<IndirectDrawRecord> records(8);
+    CHECK(GenerateIndirectDraws(sources, meshTable, scratch, records) == 0);
+    CHECK(records.empty());
+}
+
+} // namespace
+
+int main() {
+    TestPrefixSum();
+    TestMatchesDirectPath();
+    TestNothingVisible();
+    return FinishTests("IndirectDrawArgsTest");
+}
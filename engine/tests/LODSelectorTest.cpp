@@ -0,0 +1,145 @@
+// =============================================================================
+// LOD Selector Test
+// =============================================================================
+//
+// Screen size halves as the distance doubles, grows with the model's largest
+// scale and saturates at 1 inside the bounding sphere. Walking an object away
+// from the camera and back steps through every LOD once each way, with the
+// switch points a hysteresis margin apart, so jitter around a threshold never
+// flips the LOD. Selection clamps to the LODs a mesh has and lodBias shifts
+// the switch distances.
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestCheck.h"
+#include "renderer/LODSelector.h"
+
+namespace {
+
+// Unit cube: bounding sphere radius sqrt(3) / 2
+MeshBounds UnitCube() {
+    MeshBounds bounds;
+    for (int axis = 0; axis < 3; ++axis) {
+        bounds.min[axis] = -0.5f;
+        bounds.max[axis] = 0.5f;
+    }
+    return bounds;
+}
+
+bool Near(float a, float b) {
+    return std::fabs(a - b) <= 1e-4f * std::max(1.0f, std::fabs(b));
+}
+
+void TestScreenSize() {
+    LODSelector selector;
+    selector.BeginFrame(glm::vec3(0.0f), 90.0f);  // tan(45) = 1
+    const MeshBounds cube = UnitCube();
+    const float radius = std::sqrt(3.0f) * 0.5f;
+
+    const glm::mat4 at10 = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f));
+    const glm::mat4 at20 = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -20.0f));
+    CHECK(Near(selector.ComputeScreenSize(cube, at10), radius / 10.0f));
+    CHECK(Near(selector.ComputeScreenSize(cube, at20), radius / 20.0f));
+
+    // Largest axis scale counts, the others do not shrink it
+    const glm::mat4 stretched = glm::scale(at10, glm::vec3(1.0f, 3.0f, 0.5f));
+    CHECK(Near(selector.ComputeScreenSize(cube, stretched), 3.0f * radius / 10.0f));
+
+    // Inside the sphere
+    const glm::mat4 close = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.5f));
+    CHECK(selector.ComputeScreenSize(cube, close) == 1.0f);
+
+    // Narrower field of view, larger on screen
+    selector.BeginFrame(glm::vec3(0.0f), 45.0f);
+    CHECK(Near(selector.ComputeScreenSize(cube, at10), radius / (10.0f * std::tan(glm::radians(22.5f)))));
+}
+
+void TestWalkAwayAndBack() {
+    LODSelector selector;
+    const LODSelector::Config& config = selector.GetConfig();
+
+    // Far and back in 1% steps of screen size
+    float coarsenedAt[MAX_MESH_LODS] = {};
+    float refinedAt[MAX_MESH_LODS] = {};
+    uint32_t lod = 0;
+    uint32_t transitions = 0;
+    for (float size = 1.0f; size > 0.01f; size *= 0.99f) {
+        const uint32_t next = selector.SelectLOD(size, lod, MAX_MESH_LODS);
+        if (next != lod) {
+            CHECK(next == lod + 1);
+            coarsenedAt[next] = size;
+            transitions++;
+        }
+        lod = next;
+    }
+    CHECK(lod == MAX_MESH_LODS - 1);
+    for (float size = 0.01f; size < 1.0f; size *= 1.01f) {
+        const uint32_t next = selector.SelectLOD(size, lod, MAX_MESH_LODS);
+        if (next != lod) {
+            CHECK(next + 1 == lod);
+            refinedAt[lod] = size;
+            transitions++;
+        }
+        lod = next;
+    }
+    CHECK(lod == 0);
+    CHECK(transitions == 2 * (MAX_MESH_LODS - 1));
+
+    // Each switch sits on its side of the threshold's margin
+    for (uint32_t i = 1; i < MAX_MESH_LODS; ++i) {
+        const float threshold = config.thresholds[i - 1];
+        CHECK(coarsenedAt[i] < threshold * (1.0f - config.hysteresis));
+        CHECK(coarsenedAt[i] > threshold * (1.0f - config.hysteresis) * 0.99f);
+        CHECK(refinedAt[i] > threshold * (1.0f + config.hysteresis));
+        CHECK(refinedAt[i] < threshold * (1.0f + config.hysteresis) * 1.01f);
+    }
+
+    // Jitter across a threshold keeps whichever LOD it had
+    const float threshold = config.thresholds[1];
+    for (uint32_t frame = 0; frame < 10; ++frame) {
+        const float size = threshold * (frame % 2 ? 1.05f : 0.95f);
+        CHECK(selector.SelectLOD(size, 1, MAX_MESH_LODS) == 1);
+        CHECK(selector.SelectLOD(size, 2, MAX_MESH_LODS) == 2);
+    }
+}
+
+void TestClampAndBias() {
+    LODSelector selector;
+
+    // Tiny on screen, but only the LODs the mesh has
+    CHECK(selector.SelectLOD(0.001f, 0, 1) == 0);
+    CHECK(selector.SelectLOD(0.001f, 0, 3) == 2);
+    CHECK(selector.SelectLOD(0.001f, 0, MAX_MESH_LODS + 3) == MAX_MESH_LODS - 1);
+
+    // A stale LOD past the mesh's count comes back in range
+    CHECK(selector.SelectLOD(0.001f, MAX_MESH_LODS - 1, 2) == 1);
+    CHECK(selector.SelectLOD(1.0f, MAX_MESH_LODS - 1, 2) == 0);
+
+    // Half the bias, each LOD switches at twice the screen size
+    LODSelector::Config config;
+    config.lodBias = 0.5f;
+    LODSelector biased(config);
+    const float size = config.thresholds[0] * 1.5f;
+    CHECK(selector.SelectLOD(size, 0, MAX_MESH_LODS) == 0);
+    CHECK(biased.SelectLOD(size, 0, MAX_MESH_LODS) == 1);
+
+    // Statistics count this frame's selections
+    biased.BeginFrame(glm::vec3(0.0f), 60.0f);
+    biased.SelectLOD(1.0f, 0, MAX_MESH_LODS);
+    biased.SelectLOD(0.001f, 0, MAX_MESH_LODS);
+    const LODSelector::Statistics& stats = biased.GetStatistics();
+    CHECK(stats.selections == 2 && stats.transitions == 1);
+    CHECK(stats.lodHistogram[0] == 1 && stats.lodHistogram[MAX_MESH_LODS - 1] == 1);
+}
+
+} // namespace
+
+int main() {
+    TestScreenSize();
+    TestWalkAwayAndBack();
+    TestClampAndBias();
+    return FinishTests("LODSelectorTest");
+}
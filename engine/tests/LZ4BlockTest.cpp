@@ -0,0 +1,164 @@
+// =============================================================================
+// LZ4 Block Test
+// =============================================================================
+//
+// Round trips through LZ4CompressBlock and LZ4DecompressBlock: empty, tiny
+// and boundary sizes, incompressible noise (which must stay within
+// LZ4CompressBound), long runs that need overlapping matches, and repeats
+// further apart than the 64 KiB window. Truncated, resized or randomly
+// damaged blocks must be rejected without writing past the output.
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "IO/LZ4Block.h"
+
+namespace {
+
+// Compresses and decompresses, returns the compressed size or SIZE_MAX on
+// a mismatch
+size_t RoundTrip(const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> compressed(LZ4CompressBound(input.size()));
+    const size_t compressedSize = LZ4CompressBlock(input.data(), input.size(), compressed.data());
+    if (compressedSize > compressed.size()) {
+        return SIZE_MAX;
+    }
+
+    // Guard bytes catch writes past dstSize
+    std::vector<uint8_t> output(input.size() + 16, 0xCD);
+    if (!LZ4DecompressBlock(compressed.data(), compressedSize, output.data(), input.size())) {
+        return SIZE_MAX;
+    }
+    for (size_t i = input.size(); i < output.size(); ++i) {
+        if (output[i] != 0xCD) {
+            return SIZE_MAX;
+        }
+    }
+    output.resize(input.size());
+    return output == input ? compressedSize : SIZE_MAX;
+}
+
+std::vector<uint8_t> Noise(size_t size, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& value : bytes) {
+        value = static_cast<uint8_t>(random());
+    }
+    return bytes;
+}
+
+// Words from a small vocabulary, about as compressible as a text asset
+std::vector<uint8_t> Text(size_t size, uint32_t seed) {
+    static const char* words[] = { "vertex ", "index ", "buffer ", "mesh ", "float4 ", "return ", "{\n", "}\n",
+                                   "position", "normal ", "texcoord ", "; " };
+    std::mt19937 random(seed);
+    std::vector<uint8_t> bytes;
+    while (bytes.size() < size) {
+        const char* word = words[random() % (sizeof(words) / sizeof(words[0]))];
+        bytes.insert(bytes.end(), word, word + std::char_traits<char>::length(word));
+    }
+    bytes.resize(size);
+    return bytes;
+}
+
+void TestSmallSizes() {
+    // Everything up to and past the 12-byte match limit and 5 last literals
+    uint32_t failures = 0;
+    for (size_t size = 0; size <= 40; ++size) {
+        failures += RoundTrip(Noise(size, static_cast<uint32_t>(size))) == SIZE_MAX ? 1 : 0;
+        failures += RoundTrip(std::vector<uint8_t>(size, 7)) == SIZE_MAX ? 1 : 0;
+    }
+    CHECK(failures == 0);
+
+    // An empty block is a single token
+    CHECK(RoundTrip({}) == 1);
+}
+
+void TestIncompressible() {
+    for (size_t size : { 100u, 4096u, 65536u, 300000u }) {
+        const size_t compressedSize = RoundTrip(Noise(size, 47));
+        CHECK(compressedSize != SIZE_MAX);
+        CHECK(compressedSize <= LZ4CompressBound(size));
+        CHECK(compressedSize >= size);
+    }
+}
+
+void TestCompressible() {
+    const std::vector<uint8_t> text = Text(200000, 47);
+    const size_t textSize = RoundTrip(text);
+    CHECK(textSize != SIZE_MAX);
+    CHECK(textSize < text.size() / 2);
+    printf("  text: %zu -> %zu bytes\n", text.size(), textSize);
+
+    // Offset 1 and 3 matches overlap the bytes they copy
+    const size_t runSize = RoundTrip(std::vector<uint8_t>(100000, 0));
+    CHECK(runSize != SIZE_MAX);
+    CHECK(runSize < 500);
+    std::vector<uint8_t> pattern(50000);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>("abc"[i % 3]);
+    }
+    CHECK(RoundTrip(pattern) != SIZE_MAX);
+
+    // A 1 KiB block repeated 100 KiB apart is outside the match window
+    std::vector<uint8_t> far = Noise(1024, 1);
+    const std::vector<uint8_t> gap = Noise(100 * 1024, 2);
+    far.insert(far.end(), gap.begin(), gap.end());
+    far.insert(far.end(), far.begin(), far.begin() + 1024);
+    CHECK(RoundTrip(far) != SIZE_MAX);
+}
+
+void TestMalformed() {
+    const std::vector<uint8_t> text = Text(20000, 48);
+    std::vector<uint8_t> compressed(LZ4CompressBound(text.size()));
+    compressed.resize(LZ4CompressBlock(text.data(), text.size(), compressed.data()));
+    std::vector<uint8_t> output(text.size() + 64);
+
+    CHECK(!LZ4DecompressBlock(compressed.data(), 0, output.data(), text.size()));
+    CHECK(!LZ4DecompressBlock(compressed.data(), compressed.size() / 2, output.data(), text.size()));
+    CHECK(!LZ4DecompressBlock(compressed.data(), compressed.size() - 1, output.data(), text.size()));
+    CHECK(!LZ4DecompressBlock(compressed.data(), compressed.size(), output.data(), text.size() - 1));
+    CHECK(!LZ4DecompressBlock(compressed.data(), compressed.size(), output.data(), text.size() + 1));
+
+    // A match reaching back before the start of the output
+    const uint8_t badOffset[] = { 0x10, 'a', 0x05, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f' };
+    CHECK(!LZ4DecompressBlock(badOffset, sizeof(badOffset), output.data(), 10));
+
+    // A match running past the end of the output
+    const uint8_t longMatch[] = { 0x1F, 'a', 0x01, 0x00, 0x00, 0x00 };
+    std::fill(output.begin(), output.end(), 0xCD);
+    CHECK(!LZ4DecompressBlock(longMatch, sizeof(longMatch), output.data(), 10));
+    CHECK(output[10] == 0xCD);
+
+    // Random damage may decode to garbage but must stay inside the buffers
+    std::mt19937 random(49);
+    uint32_t rejected = 0;
+    uint32_t guardWrites = 0;
+    for (uint32_t trial = 0; trial < 2000; ++trial) {
+        std::vector<uint8_t> damaged = compressed;
+        for (uint32_t flips = 1 + random() % 4; flips > 0; --flips) {
+            damaged[random() % damaged.size()] = static_cast<uint8_t>(random());
+        }
+        std::fill(output.begin(), output.end(), 0xCD);
+        rejected += LZ4DecompressBlock(damaged.data(), damaged.size(), output.data(), text.size()) ? 0 : 1;
+        for (size_t i = text.size(); i < output.size(); ++i) {
+            guardWrites += output[i] != 0xCD ? 1 : 0;
+        }
+    }
+    CHECK(guardWrites == 0);
+    CHECK(rejected > 0);
+    printf("  %u of 2000 damaged blocks rejected\n", rejected);
+}
+
+} // namespace
+
+int main() {
+    TestSmallSizes();
+    TestIncompressible();
+    TestCompressible();
+    TestMalformed();
+    return FinishTests("LZ4BlockTest");
+}
@@ -0,0 +1,260 @@
+// =============================================================================
+// Mesh Content Table Test
+// =============================================================================
+//
+// A mesh with the same content as a published one gets its handle, once per
+// Acquire, and the table lets go only with the last Release. Changing one
+// byte of any stream, moving an index from one stream to the next, dropping
+// an optional stream or flipping the occluder flag all miss. Content published under another
+// mesh's hash (a forced collision) is never shared with that mesh, which
+// stays private. Threads acquiring the same content share one mesh.
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/MeshContentTable.h"
+
+namespace {
+
+// Owns the streams a CPUMesh points at
+struct TestMesh {
+    std::vector<VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    std::vector<uint32_t> lodIndices;
+    CPUMeshLOD lod;
+    bool isOccluder = false;
+
+    CPUMesh View() {
+        CPUMesh mesh;
+        mesh.vertices = vertices.data();
+        mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+        mesh.indices = indices.data();
+        mesh.indexCount = static_cast<uint32_t>(indices.size());
+        mesh.normals = normals.empty() ? nullptr : normals.data();
+        mesh.uvs = uvs.empty() ? nullptr : uvs.data();
+        if (!lodIndices.empty()) {
+            lod.indices = lodIndices.data();
+            lod.indexCount = static_cast<uint32_t>(lodIndices.size());
+            mesh.lods = &lod;
+            mesh.lodCount = 1;
+        }
+        mesh.isOccluder = isOccluder;
+        return mesh;
+    }
+};
+
+TestMesh MakeMesh(uint32_t seed) {
+    TestMesh mesh;
+    mesh.vertices.resize(16);
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            mesh.vertices[i].position[c] = static_cast<float>(seed * 100 + i * 3 + c);
+            mesh.vertices[i].color[c] = 0.5f;
+        }
+    }
+    for (uint32_t i = 0; i < 24; ++i) {
+        mesh.indices.push_back((i * 7 + seed) % 16);
+    }
+    mesh.normals.assign(16 * 3, 1.0f);
+    mesh.uvs.assign(16 * 2, 0.25f);
+    mesh.lodIndices.assign(mesh.indices.begin(), mesh.indices.begin() + 12);
+    return mesh;
+}
+
+// Publishes mesh under its own hash, true when it went in
+bool PublishMesh(MeshContentTable& table, TestMesh& mesh, MeshHandle handle) {
+    uint64_t hash = 0;
+    if (table.Acquire(mesh.View(), hash) != INVALID_MESH_HANDLE || hash == 0) {
+        return false;
+    }
+    bool submitted = false;
+    const bool published = table.Publish(hash, handle, MeshContentTable::Serialize(mesh.View()), 1000,
+                                         [&submitted](bool) { submitted = true; });
+    return published && submitted;
+}
+
+// Whether MakeMesh(seed) with edit applied hits the table
+template <typename Edit>
+bool EditedHits(MeshContentTable& table, uint32_t seed, Edit&& edit) {
+    TestMesh mesh = MakeMesh(seed);
+    edit(mesh);
+    uint64_t hash = 0;
+    const MeshHandle handle = table.Acquire(mesh.View(), hash);
+    if (handle != INVALID_MESH_HANDLE) {
+        table.Release(hash, handle);
+        return true;
+    }
+    return false;
+}
+
+void TestHitsAndReferences() {
+    MeshContentTable table;
+    TestMesh original = MakeMesh(1);
+    CHECK(PublishMesh(table, original, 7));
+
+    // Same content from other memory
+    TestMesh copy = MakeMesh(1);
+    uint64_t hash = 0;
+    CHECK(table.Acquire(copy.View(), hash) == 7);
+    CHECK(table.Acquire(copy.View(), hash) == 7);
+    CHECK(hash == MeshContentTable::Hash(original.View()));
+
+    MeshContentTable::Statistics stats = table.GetStatistics();
+    CHECK(stats.hits == 2 && stats.misses == 1 && stats.bytesSaved == 2000 && stats.sharedMeshes == 1);
+
+    // Three references, the mesh goes with the third release
+    CHECK(!table.Release(hash, 7));
+    CHECK(!table.Release(hash, 7));
+    CHECK(table.Release(hash, 7));
+    CHECK(table.GetStatistics().sharedMeshes == 0);
+
+    // Gone, so the next one misses and publishes anew
+    CHECK(PublishMesh(table, copy, 9));
+    CHECK(table.Acquire(original.View(), hash) == 9);
+
+    // Only the publisher's handle counts as the shared one
+    CHECK(table.Release(hash, 8));
+    CHECK(table.GetStatistics().sharedMeshes == 1);
+
+    // Same content published twice: the second stays out, still submitted
+    bool submitted = false;
+    CHECK(!table.Publish(hash, 10, MeshContentTable::Serialize(copy.View()), 1000,
+                         [&submitted](bool published) { submitted = !published; }));
+    CHECK(submitted);
+
+    table.Clear();
+    CHECK(table.GetStatistics().sharedMeshes == 0);
+}
+
+void TestChangedContentMisses() {
+    MeshContentTable table;
+    TestMesh base = MakeMesh(3);
+    CHECK(PublishMesh(table, base, 1));
+    CHECK(EditedHits(table, 3, [](TestMesh&) {}));
+
+    // One byte anywhere in any stream
+    for (size_t byte = 0; byte < 16 * sizeof(VertexAttributes); byte += 5) {
+        CHECK(!EditedHits(table, 3, [byte](TestMesh& mesh) {
+            reinterpret_cast<uint8_t*>(mesh.vertices.data())[byte] ^= 1;
+        }));
+    }
+    for (size_t byte = 0; byte < 24 * sizeof(uint32_t); byte += 3) {
+        CHECK(!EditedHits(table, 3, [byte](TestMesh& mesh) {
+            reinterpret_cast<uint8_t*>(mesh.indices.data())[byte] ^= 0x80;
+        }));
+    }
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.normals[47] = -1.0f; }));
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.uvs[0] = 0.0f; }));
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.lodIndices[11] ^= 1; }));
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.isOccluder = true; }));
+
+    // Streams dropped, or an index moved across a stream boundary
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.normals.clear(); }));
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) { mesh.lodIndices.clear(); }));
+    CHECK(!EditedHits(table, 3, [](TestMesh& mesh) {
+        mesh.lodIndices.insert(mesh.lodIndices.begin(), mesh.indices.back());
+        mesh.indices.pop_back();
+    }));
+
+    const MeshContentTable::Statistics stats = table.GetStatistics();
+    CHECK(stats.hits == 1 && stats.sharedMeshes == 1);
+}
+
+void TestCollisionStaysPrivate() {
+    MeshContentTable table;
+    TestMesh a = MakeMesh(4);
+    TestMesh b = MakeMesh(5);
+
+    // a's content under b's hash, as if they collided
+    const uint64_t bHash = MeshContentTable::Hash(b.View());
+    CHECK(bHash != 0 && bHash != MeshContentTable::Hash(a.View()));
+    CHECK(table.Publish(bHash, 1, MeshContentTable::Serialize(a.View()), 1000, [](bool) {}));
+
+    uint64_t hash = 0;
+    CHECK(table.Acquire(b.View(), hash) == INVALID_MESH_HANDLE);
+    CHECK(hash == 0);
+    CHECK(table.GetStatistics().hits == 0);
+
+    // The colliding entry keeps its single reference
+    CHECK(table.Release(bHash, 1));
+    CHECK(table.GetStatistics().sharedMeshes == 0);
+
+    // Same bytes end to end, one index moved into the LOD stream. The hash
+    // tells them apart already, the byte comparison has to as well.
+    TestMesh shifted = MakeMesh(4);
+    shifted.lodIndices.insert(shifted.lodIndices.begin(), shifted.indices.back());
+    shifted.indices.pop_back();
+    const uint64_t shiftedHash = MeshContentTable::Hash(shifted.View());
+    CHECK(table.Publish(shiftedHash, 2, MeshContentTable::Serialize(a.View()), 1000, [](bool) {}));
+    CHECK(table.Acquire(shifted.View(), hash) == INVALID_MESH_HANDLE);
+    CHECK(hash == 0);
+}
+
+void TestConcurrentAcquire() {
+    MeshContentTable table;
+    const int threadCount = 6;
+    const int perThread = 500;
+    const uint32_t kinds = 4;
+    std::vector<TestMesh> meshes;
+    for (uint32_t kind = 0; kind < kinds; ++kind) {
+        meshes.push_back(MakeMesh(10 + kind));
+    }
+
+    // The loser of a publish race keeps its own handle, like CreateMesh
+    std::vector<std::vector<MeshHandle>> handles(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<TestMesh> local = meshes;    // View() writes the LOD record
+            for (int n = 0; n < perThread; ++n) {
+                TestMesh& mesh = local[(n + t) % kinds];
+                uint64_t hash = 0;
+                MeshHandle handle = table.Acquire(mesh.View(), hash);
+                if (handle == INVALID_MESH_HANDLE) {
+                    handle = 1000 + t * perThread + n;
+                    if (hash != 0) {
+                        table.Publish(hash, handle, MeshContentTable::Serialize(mesh.View()), 1, [](bool) {});
+                    }
+                }
+                handles[t].push_back(handle);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    MeshContentTable::Statistics stats = table.GetStatistics();
+    CHECK(stats.hits + stats.misses == threadCount * perThread);
+    CHECK(stats.sharedMeshes == kinds);
+    printf("  %llu hits, %llu misses for %u meshes over %d threads\n",
+           static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses), kinds,
+           threadCount);
+
+    // Every reference handed out releases, the last one of each empties it
+    uint32_t lastReleases = 0;
+    for (int t = 0; t < threadCount; ++t) {
+        for (int n = 0; n < perThread; ++n) {
+            const uint64_t hash = MeshContentTable::Hash(meshes[(n + t) % kinds].View());
+            if (table.Release(hash, handles[t][n]) && table.GetStatistics().sharedMeshes < kinds - lastReleases) {
+                lastReleases++;
+            }
+        }
+    }
+    CHECK(lastReleases == kinds);
+    CHECK(table.GetStatistics().sharedMeshes == 0);
+}
+
+} // namespace
+
+int main() {
+    TestHitsAndReferences();
+    TestChangedContentMisses();
+    TestCollisionStaysPrivate();
+    TestConcurrentAcquire();
+    return FinishTests("MeshContentTableTest");
+}
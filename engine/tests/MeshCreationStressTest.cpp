@@ -0,0 +1,703 @@
+// =============================================================================
+// Mesh Creation Stress Test
+// =============================================================================
+//
+// Loader threads create meshes through MeshCreationQueue the way
+// GeometryManager does (handle from the slot map, Submit for built meshes,
+// BeginWrite / Commit / CancelWrite for meshes written in place) and publish
+// each handle the moment it is queued. The main thread destroys published
+// handles right away, most before they were drained, then drains, uploads
+// against a simulated GPU fence and retires meshes like GeometryManager.
+//
+// No two registered buffer or staging ranges overlap, no handle is issued
+// twice, every destroy takes effect (some of them deferred to the drain), and
+// every mesh that was not destroyed ends up ready with its own data. A
+// deterministic pass covers each DestroyResult.
+//
+//   MeshCreationStressTest [meshes per thread]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/MeshCreationQueue.h"
+#include "resources/RenderTypes.h"
+#include "resources/SlotMap.h"
+
+namespace {
+
+constexpr uint32_t VERTEX_STRIDE = 20;
+constexpr uint32_t INDEX_SIZE = 4;
+
+// Byte i of a mesh's vertex or index data, so every mesh's content is its own
+uint8_t PatternByte(uint32_t seed, size_t i) {
+    return static_cast<uint8_t>(seed * 31 + i * 7 + (i >> 8));
+}
+
+// Live ranges of one buffer, checked for overlap as they are handed out
+class RangeTracker {
+public:
+    // Returns false when the range overlaps one that is still live
+    bool Add(uint32_t offset, size_t size) {
+        auto next = m_ranges.lower_bound(offset);
+        bool overlaps = next != m_ranges.end() && next->first < offset + size;
+        if (next != m_ranges.begin()) {
+            auto previous = std::prev(next);
+            overlaps = overlaps || previous->first + previous->second > offset;
+        }
+        m_ranges[offset] = size;
+        return !overlaps;
+    }
+    void Remove(uint32_t offset) { m_ranges.erase(offset); }
+
+private:
+    std::map<uint32_t, size_t> m_ranges;
+};
+
+struct MeshRenderData {
+    MeshState state = MeshState::PendingUpload;
+    uint64_t uploadFenceValue = 0;
+};
+
+struct MeshEntry {
+    uint32_t seed = 0;
+    uint32_t vertexOffset = 0;          // Bytes
+    uint32_t vertexBytes = 0;
+    uint32_t indexOffset = 0;
+    uint32_t indexBytes = 0;
+    uint32_t stagingOffset = UINT32_MAX;    // Written in place
+    uint64_t retireFenceValue = 0;
+    std::vector<uint8_t> vertexData;
+    std::vector<uint8_t> indexData;
+};
+
+using CreationQueue = MeshCreationQueue<MeshEntry>;
+using DestroyResult = CreationQueue::DestroyResult;
+
+struct PendingCopy {
+    MeshHandle handle;
+    uint32_t stagingOffset;
+    uint64_t fenceValue;
+};
+
+struct Statistics {
+    std::atomic<uint32_t> overlaps{ 0 };
+    std::atomic<uint32_t> duplicateHandles{ 0 };
+    std::atomic<uint32_t> outOfSpace{ 0 };
+    std::atomic<uint32_t> created{ 0 };
+    std::atomic<uint32_t> written{ 0 };
+    std::atomic<uint32_t> cancelled{ 0 };
+    uint32_t destroyed = 0;
+    uint32_t deferredDestroys = 0;
+    uint32_t unknownDestroys = 0;
+    uint32_t corruptCopies = 0;
+};
+
+// GeometryManager's owner side around the real creation queue
+class MeshCreationHarness {
+public:
+    static constexpr size_t VERTEX_BUFFER_SIZE = 640 * 1024;
+    static constexpr size_t INDEX_BUFFER_SIZE = 320 * 1024;
+    static constexpr size_t UPLOAD_HEAP_SIZE = 256 * 1024;
+
+    MeshCreationHarness()
+        : m_vertexMemory(VERTEX_BUFFER_SIZE)
+        , m_indexMemory(INDEX_BUFFER_SIZE)
+        , m_stagingMemory(UPLOAD_HEAP_SIZE)
+    {
+        CreationQueue::Config config;
+        config.vertexBufferSize = VERTEX_BUFFER_SIZE;
+        config.vertexAlignment = VERTEX_STRIDE;
+        config.indexBufferSize = INDEX_BUFFER_SIZE;
+        config.indexAlignment = INDEX_SIZE;
+        config.uploadHeapSize = UPLOAD_HEAP_SIZE;
+        m_creation.Initialize(config);
+    }
+
+    // =========================================================================
+    // Loader threads
+    // =========================================================================
+
+    // CreateMesh: data built on the caller's thread, copied by the main thread
+    MeshHandle CreateMesh(uint32_t seed, uint32_t vertexCount, uint32_t indexCount) {
+        MeshEntry entry;
+        entry.seed = seed;
+        entry.vertexBytes = vertexCount * VERTEX_STRIDE;
+        entry.indexBytes = indexCount * INDEX_SIZE;
+        entry.vertexData.resize(entry.vertexBytes);
+        entry.indexData.resize(entry.indexBytes);
+        for (size_t i = 0; i < entry.vertexData.size(); ++i) {
+            entry.vertexData[i] = PatternByte(seed, i);
+        }
+        for (size_t i = 0; i < entry.indexData.size(); ++i) {
+            entry.indexData[i] = PatternByte(seed, entry.vertexBytes + i);
+        }
+
+        MeshAllocation allocation;
+        if (!m_creation.Allocate(entry.vertexBytes, entry.indexBytes, allocation)) {
+            m_stats.outOfSpace++;
+            return INVALID_MESH_HANDLE;
+        }
+
+        const MeshHandle handle = AllocateHandle();
+        if (handle == INVALID_MESH_HANDLE) {
+            m_creation.Free(allocation);
+            return INVALID_MESH_HANDLE;
+        }
+
+        entry.vertexOffset = allocation.vertexOffset;
+        entry.indexOffset = allocation.indexOffset;
+        m_creation.Submit(handle, std::move(entry));
+        return handle;
+    }
+
+    // BeginMeshWrite: staging and buffer ranges up front, kept out of the
+    // registry until committed
+    MeshHandle BeginMeshWrite(uint32_t seed, uint32_t vertexCount, uint32_t indexCount, uint8_t*& outStaging) {
+        const MeshHandle handle = AllocateHandle();
+        if (handle == INVALID_MESH_HANDLE) {
+            return INVALID_MESH_HANDLE;
+        }
+
+        MeshAllocation allocation;
+        const uint32_t vertexBytes = vertexCount * VERTEX_STRIDE;
+        const uint32_t indexBytes = indexCount * INDEX_SIZE;
+        const bool reserved = m_creation.BeginWrite(handle, vertexBytes, indexBytes,
+            [&](const MeshAllocation& reservedRanges) {
+                MeshEntry entry;
+                entry.seed = seed;
+                entry.vertexOffset = reservedRanges.vertexOffset;
+                entry.vertexBytes = vertexBytes;
+                entry.indexOffset = reservedRanges.indexOffset;
+                entry.indexBytes = indexBytes;
+                entry.stagingOffset = reservedRanges.stagingOffset;
+                return entry;
+            },
+            allocation);
+        if (!reserved) {
+            m_stats.outOfSpace++;
+            FreeHandle(handle);
+            return INVALID_MESH_HANDLE;
+        }
+
+        outStaging = m_stagingMemory.data() + allocation.stagingOffset;
+        return handle;
+    }
+
+    bool CommitMesh(MeshHandle handle) {
+        return m_creation.Commit(handle, [](MeshEntry&) {});
+    }
+
+    bool CancelMeshWrite(MeshHandle handle) {
+        if (!m_creation.CancelWrite(handle)) {
+            return false;
+        }
+        FreeHandle(handle);
+        return true;
+    }
+
+    // =========================================================================
+    // Main thread
+    // =========================================================================
+
+    void DestroyMesh(MeshHandle handle) {
+        MeshRenderData* renderData = m_registry.GetHot(handle);
+        if (!renderData) {
+            switch (m_creation.Destroy(handle)) {
+            case DestroyResult::Cancelled:
+                FreeHandle(handle);
+                break;
+            case DestroyResult::Deferred:
+                m_stats.deferredDestroys++;
+                break;
+            case DestroyResult::Unknown:
+                m_stats.unknownDestroys++;
+                break;
+            }
+            return;
+        }
+        if (renderData->state == MeshState::PendingDeletion) {
+            return;
+        }
+
+        MeshEntry& entry = *m_registry.GetCold(handle);
+        if (entry.stagingOffset != UINT32_MAX && renderData->state == MeshState::PendingUpload) {
+            std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+            ReleaseStaging(entry);
+        }
+        renderData->state = MeshState::PendingDeletion;
+        entry.retireFenceValue = m_frameFenceValue;
+        m_stats.destroyed++;
+    }
+
+    // BeginFrame: the GPU has finished everything up to completedFenceValue,
+    // this frame's work signals frameFenceValue
+    void BeginFrame(uint64_t completedFenceValue, uint64_t frameFenceValue) {
+        m_frameFenceValue = frameFenceValue;
+        DrainCreatedMeshes();
+        std::lock_guard<std::mutex> lock(m_creation.GetMutex());
+
+        ExecuteCopies(completedFenceValue);
+        ReclaimRanges(completedFenceValue);
+        m_creation.GetVertexAllocator().ReclaimCompleted(completedFenceValue);
+        m_creation.GetIndexAllocator().ReclaimCompleted(completedFenceValue);
+        m_creation.GetUploadAllocator().ReclaimCompleted(completedFenceValue);
+
+        RecordUploads();
+        PerformMaintenance();
+    }
+
+    bool IsIdle() {
+        DrainCreatedMeshes();
+        return m_uploadQueue.empty() && m_pendingCopies.empty() && m_creation.GetQueuedCount() == 0;
+    }
+
+    // Every mesh still registered is ready and its buffer ranges hold its data
+    uint32_t VerifyContents(const std::unordered_set<MeshHandle>& expectedLive) {
+        uint32_t errors = 0;
+        uint32_t live = 0;
+        m_registry.ForEach([&](MeshHandle handle, const MeshRenderData& renderData, const MeshEntry& entry) {
+            if (renderData.state == MeshState::PendingDeletion) {
+                return;
+            }
+            live++;
+            errors += renderData.state != MeshState::Ready ? 1 : 0;
+            errors += expectedLive.count(handle) == 0 ? 1 : 0;
+            for (uint32_t i = 0; i < entry.vertexBytes; ++i) {
+                if (m_vertexMemory[entry.vertexOffset + i] != PatternByte(entry.seed, i)) {
+                    errors++;
+                    break;
+                }
+            }
+            for (uint32_t i = 0; i < entry.indexBytes; ++i) {
+                if (m_indexMemory[entry.indexOffset + i] != PatternByte(entry.seed, entry.vertexBytes + i)) {
+                    errors++;
+                    break;
+                }
+            }
+        });
+        return errors + (live != expectedLive.size() ? 1 : 0);
+    }
+
+    bool Resolves(MeshHandle handle) const { return m_registry.Contains(handle); }
+    Statistics& GetStatistics() { return m_stats; }
+
+private:
+    using Registry = SlotMap<MeshRenderData, MeshEntry>;
+
+    struct DeferredRange {
+        RangeTracker* tracker;
+        uint32_t offset;
+        uint64_t fenceValue;
+    };
+
+    MeshHandle AllocateHandle() {
+        const MeshHandle handle = m_registry.AllocateHandle();
+        if (handle != INVALID_MESH_HANDLE) {
+            std::lock_guard<std::mutex> lock(m_handleMutex);
+            if (!m_issuedHandles.insert(handle).second) {
+                m_stats.duplicateHandles++;
+            }
+        }
+        return handle;
+    }
+
+    void FreeHandle(MeshHandle handle) {
+        {
+            std::lock_guard<std::mutex> lock(m_handleMutex);
+            m_issuedHandles.erase(handle);
+        }
+        m_registry.FreeHandle(handle);
+    }
+
+    // Caller holds the creation mutex
+    void ReleaseStaging(MeshEntry& entry) {
+        m_stagingRanges.Remove(entry.stagingOffset);
+        m_creation.GetUploadAllocator().SetFence(entry.stagingOffset, 0);
+        entry.stagingOffset = UINT32_MAX;
+    }
+
+    // Ranges are tracked from here on: before the drain they may still be
+    // given back by a cancel the owner never sees
+    void DrainCreatedMeshes() {
+        m_creation.Drain([this](MeshHandle handle, MeshEntry&& entry, uint32_t destroyCount) {
+            if (!m_vertexRanges.Add(entry.vertexOffset, entry.vertexBytes) ||
+                !m_indexRanges.Add(entry.indexOffset, entry.indexBytes)) {
+                m_stats.overlaps++;
+            }
+            if (entry.stagingOffset != UINT32_MAX &&
+                !m_stagingRanges.Add(entry.stagingOffset, entry.vertexBytes + entry.indexBytes)) {
+                m_stats.overlaps++;
+            }
+
+            m_registry.Emplace(handle, MeshRenderData(), std::move(entry));
+            m_uploadQueue.push_back(handle);
+            for (uint32_t i = 0; i < destroyCount; ++i) {
+                DestroyMesh(handle);
+            }
+        });
+    }
+
+    // The copy queue runs as late as it may: right before its fence is seen
+    // complete. Staging reused early shows up as wrong mesh data.
+    void ExecuteCopies(uint64_t completedFenceValue) {
+        size_t executed = 0;
+        for (; executed < m_pendingCopies.size(); ++executed) {
+            const PendingCopy& copy = m_pendingCopies[executed];
+            if (copy.fenceValue > completedFenceValue) {
+                break;
+            }
+
+            MeshRenderData* renderData = m_registry.GetHot(copy.handle);
+            MeshEntry* entry = m_registry.GetCold(copy.handle);
+            if (!renderData || !entry) {
+                m_stats.corruptCopies++;    // Registry slot released while its copy was in flight
+                continue;
+            }
+            const uint8_t* staging = m_stagingMemory.data() + copy.stagingOffset;
+            memcpy(m_vertexMemory.data() + entry->vertexOffset, staging, entry->vertexBytes);
+            memcpy(m_indexMemory.data() + entry->indexOffset, staging + entry->vertexBytes, entry->indexBytes);
+            m_stagingRanges.Remove(copy.stagingOffset);
+            if (renderData->state == MeshState::Uploading) {
+                renderData->state = MeshState::Ready;
+            }
+        }
+        m_pendingCopies.erase(m_pendingCopies.begin(), m_pendingCopies.begin() + executed);
+    }
+
+    void ReclaimRanges(uint64_t completedFenceValue) {
+        size_t reclaimed = 0;
+        while (reclaimed < m_deferredRanges.size() && m_deferredRanges[reclaimed].fenceValue <= completedFenceValue) {
+            m_deferredRanges[reclaimed].tracker->Remove(m_deferredRanges[reclaimed].offset);
+            reclaimed++;
+        }
+        m_deferredRanges.erase(m_deferredRanges.begin(), m_deferredRanges.begin() + reclaimed);
+    }
+
+    // Caller holds the creation mutex
+    void RecordUploads() {
+        UploadRingAllocator& uploadAllocator = m_creation.GetUploadAllocator();
+        auto it = m_uploadQueue.begin();
+        while (it != m_uploadQueue.end()) {
+            MeshRenderData* renderData = m_registry.GetHot(*it);
+            if (!renderData || renderData->state != MeshState::PendingUpload) {
+                it = m_uploadQueue.erase(it);
+                continue;
+            }
+
+            MeshEntry& entry = *m_registry.GetCold(*it);
+            if (entry.stagingOffset != UINT32_MAX) {
+                uploadAllocator.SetFence(entry.stagingOffset, m_frameFenceValue);
+            } else {
+                const size_t stagingBytes = entry.vertexBytes + entry.indexBytes;
+                entry.stagingOffset = uploadAllocator.Allocate(stagingBytes, m_frameFenceValue);
+                if (entry.stagingOffset == UINT32_MAX) {
+                    break;  // Staging full, the rest waits for the next frame
+                }
+                if (!m_stagingRanges.Add(entry.stagingOffset, stagingBytes)) {
+                    m_stats.overlaps++;
+                }
+                uint8_t* staging = m_stagingMemory.data() + entry.stagingOffset;
+                memcpy(staging, entry.vertexData.data(), entry.vertexBytes);
+                memcpy(staging + entry.vertexBytes, entry.indexData.data(), entry.indexBytes);
+                entry.vertexData.clear();
+                entry.indexData.clear();
+            }
+
+            m_pendingCopies.push_back({ *it, entry.stagingOffset, m_frameFenceValue });
+            entry.stagingOffset = UINT32_MAX;
+            renderData->state = MeshState::Uploading;
+            renderData->uploadFenceValue = m_frameFenceValue;
+            it = m_uploadQueue.erase(it);
+        }
+    }
+
+    // Caller holds the creation mutex. Destroyed meshes leave the registry,
+    // their buffer ranges follow once the GPU is done with them. A copy
+    // still in flight keeps the slot until it has executed.
+    void PerformMaintenance() {
+        std::unordered_set<MeshHandle> copying;
+        for (const PendingCopy& copy : m_pendingCopies) {
+            copying.insert(copy.handle);
+        }
+
+        std::vector<MeshHandle> removed;
+        m_registry.ForEach([&](MeshHandle handle, MeshRenderData& renderData, MeshEntry& entry) {
+            if (renderData.state != MeshState::PendingDeletion || copying.count(handle) > 0) {
+                return;
+            }
+            m_creation.GetVertexAllocator().FreeDeferred(entry.vertexOffset, entry.retireFenceValue);
+            m_creation.GetIndexAllocator().FreeDeferred(entry.indexOffset, entry.retireFenceValue);
+            m_deferredRanges.push_back({ &m_vertexRanges, entry.vertexOffset, entry.retireFenceValue });
+            m_deferredRanges.push_back({ &m_indexRanges, entry.indexOffset, entry.retireFenceValue });
+            removed.push_back(handle);
+        });
+
+        for (MeshHandle handle : removed) {
+            m_registry.Remove(handle);
+            std::lock_guard<std::mutex> lock(m_handleMutex);
+            m_issuedHandles.erase(handle);
+        }
+    }
+
+    Registry m_registry;
+    CreationQueue m_creation;
+    std::vector<MeshHandle> m_uploadQueue;
+    std::vector<PendingCopy> m_pendingCopies;
+    std::vector<DeferredRange> m_deferredRanges;
+    uint64_t m_frameFenceValue = 0;
+
+    // Main thread only, loaders' ranges join at the drain
+    RangeTracker m_vertexRanges;
+    RangeTracker m_indexRanges;
+    RangeTracker m_stagingRanges;
+
+    std::mutex m_handleMutex;
+    std::unordered_set<MeshHandle> m_issuedHandles;
+
+    // Simulated GPU memory
+    std::vector<uint8_t> m_vertexMemory;
+    std::vector<uint8_t> m_indexMemory;
+    std::vector<uint8_t> m_stagingMemory;
+
+    Statistics m_stats;
+};
+
+// Handles a loader hands to the main thread as soon as they are queued, like
+// a scene loader returning them
+struct LoadedMeshes {
+    std::mutex mutex;
+    std::vector<MeshHandle> handles;
+    std::atomic<bool> stalled{ false };     // Space is not coming back, stop loading
+};
+
+void LoaderThread(MeshCreationHarness& harness, LoadedMeshes& loaded, uint32_t threadIndex, uint32_t meshCount) {
+    std::mt19937 random(38 + threadIndex);
+    Statistics& stats = harness.GetStatistics();
+
+    for (uint32_t i = 0; i < meshCount; ++i) {
+        const uint32_t seed = threadIndex * 100000 + i;
+        const uint32_t vertexCount = 3 + random() % 1500;
+        const uint32_t indexCount = 3 * (1 + random() % 300);
+        const uint32_t path = random() % 10;
+
+        // Out of space: wait for the main thread to retire something
+        MeshHandle handle = INVALID_MESH_HANDLE;
+        for (uint32_t attempt = 0; attempt < 1000 && handle == INVALID_MESH_HANDLE && !loaded.stalled; ++attempt) {
+            if (path < 6) {
+                handle = harness.CreateMesh(seed, vertexCount, indexCount);
+                if (handle == INVALID_MESH_HANDLE) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                stats.created++;
+                break;
+            }
+
+            uint8_t* staging = nullptr;
+            handle = harness.BeginMeshWrite(seed, vertexCount, indexCount, staging);
+            if (handle == INVALID_MESH_HANDLE) {
+                std::this_thread::yield();
+                continue;
+            }
+            const size_t bytes = vertexCount * VERTEX_STRIDE + indexCount * INDEX_SIZE;
+            for (size_t b = 0; b < bytes; ++b) {
+                staging[b] = PatternByte(seed, b);
+            }
+            if (path == 9) {
+                CHECK(harness.CancelMeshWrite(handle));
+                stats.cancelled++;
+                handle = INVALID_MESH_HANDLE;
+                break;
+            }
+            CHECK(harness.CommitMesh(handle));
+            stats.written++;
+        }
+
+        if (handle != INVALID_MESH_HANDLE) {
+            std::lock_guard<std::mutex> lock(loaded.mutex);
+            loaded.handles.push_back(handle);
+        }
+    }
+}
+
+// Every DestroyResult, one step at a time
+void TestDestroyResults() {
+    CreationQueue creation;
+    CreationQueue::Config config;
+    config.vertexBufferSize = 64 * 1024;
+    config.vertexAlignment = VERTEX_STRIDE;
+    config.indexBufferSize = 32 * 1024;
+    config.uploadHeapSize = 64 * 1024;
+    creation.Initialize(config);
+
+    std::vector<std::pair<MeshHandle, uint32_t>> drained;
+    auto drain = [&]() {
+        drained.clear();
+        creation.Drain([&](MeshHandle handle, MeshEntry&& entry, uint32_t destroyCount) {
+            creation.Free(MeshAllocation{ entry.vertexOffset, entry.indexOffset, UINT32_MAX });
+            drained.push_back({ handle, destroyCount });
+        });
+    };
+    auto submit = [&](MeshHandle handle) {
+        MeshAllocation allocation;
+        CHECK(creation.Allocate(100 * VERTEX_STRIDE, 300 * INDEX_SIZE, allocation));
+        MeshEntry entry;
+        entry.vertexOffset = allocation.vertexOffset;
+        entry.indexOffset = allocation.indexOffset;
+        creation.Submit(handle, std::move(entry));
+    };
+
+    // Queued: the destroy travels with the mesh, once per call
+    submit(1);
+    submit(2);
+    CHECK(creation.GetQueuedCount() == 2);
+    CHECK(creation.Destroy(1) == DestroyResult::Deferred);
+    CHECK(creation.Destroy(2) == DestroyResult::Deferred);
+    CHECK(creation.Destroy(2) == DestroyResult::Deferred);
+    drain();
+    CHECK(drained == (std::vector<std::pair<MeshHandle, uint32_t>>{ { 1, 1 }, { 2, 2 } }));
+    CHECK(creation.GetQueuedCount() == 0);
+
+    // Drained or never seen: nothing left to act on
+    CHECK(creation.Destroy(1) == DestroyResult::Unknown);
+    CHECK(creation.Destroy(77) == DestroyResult::Unknown);
+
+    // Open: all three ranges go back on the spot, Commit then fails
+    MeshAllocation allocation;
+    CHECK(creation.BeginWrite(3, 100 * VERTEX_STRIDE, 300 * INDEX_SIZE,
+                              [](const MeshAllocation&) { return MeshEntry(); }, allocation));
+    CHECK(creation.GetOpenWriteCount() == 1);
+    CHECK(creation.Destroy(3) == DestroyResult::Cancelled);
+    CHECK(creation.GetOpenWriteCount() == 0);
+    CHECK(!creation.Commit(3, [](MeshEntry&) {}));
+    CHECK(creation.Destroy(3) == DestroyResult::Unknown);
+    creation.GetUploadAllocator().ReclaimCompleted(0);
+    CHECK(creation.GetVertexAllocator().GetUsedSpace() == 0);
+    CHECK(creation.GetIndexAllocator().GetUsedSpace() == 0);
+    CHECK(creation.GetUploadAllocator().GetUsedSpace() == 0);
+
+    // Committed: queued like a submitted mesh
+    CHECK(creation.BeginWrite(4, 100 * VERTEX_STRIDE, 300 * INDEX_SIZE,
+                              [](const MeshAllocation&) { return MeshEntry(); }, allocation));
+    CHECK(creation.Commit(4, [](MeshEntry&) {}));
+    CHECK(creation.Destroy(4) == DestroyResult::Deferred);
+    drain();
+    CHECK(drained.size() == 1 && drained[0].first == 4 && drained[0].second == 1);
+}
+
+void TestConcurrentCreation(uint32_t threadCount, uint32_t meshesPerThread) {
+    MeshCreationHarness harness;
+    LoadedMeshes loaded;
+
+    std::vector<std::thread> loaders;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        loaders.emplace_back(LoaderThread, std::ref(harness), std::ref(loaded), t, meshesPerThread);
+    }
+    std::atomic<uint32_t> running{ threadCount };
+    std::thread joiner([&]() {
+        for (std::thread& loader : loaders) {
+            loader.join();
+            running--;
+        }
+    });
+
+    // Main thread: frames with a GPU up to three frames behind
+    std::mt19937 random(380);
+    std::unordered_set<MeshHandle> live;
+    std::vector<MeshHandle> destroyed;
+    uint64_t frameFence = 0;
+    uint64_t completedFence = 0;
+    uint32_t frames = 0;
+    uint32_t lastLoadFrame = 0;
+    while (running > 0 || !harness.IsIdle()) {
+        // Leaked ranges starve the loaders or the uploads, fail instead of
+        // spinning on. Handles normally arrive every few dozen frames and
+        // the queue is idle a few frames after the last one.
+        if (frames - lastLoadFrame > 300) {
+            loaded.stalled = true;
+            if (running == 0) {
+                break;
+            }
+        }
+        frameFence++;
+        completedFence = std::max<uint64_t>(completedFence, frameFence > 3 ? frameFence - 1 - random() % 3 : 0);
+        if (running == 0) {
+            completedFence = frameFence - 1;
+        }
+
+        // A third of the new handles are destroyed at once, most of them
+        // still queued while loaders keep pushing behind them
+        {
+            std::lock_guard<std::mutex> lock(loaded.mutex);
+            lastLoadFrame = loaded.handles.empty() ? lastLoadFrame : frames;
+            for (MeshHandle handle : loaded.handles) {
+                if (random() % 3 == 0) {
+                    harness.DestroyMesh(handle);
+                    destroyed.push_back(handle);
+                } else {
+                    live.insert(handle);
+                }
+            }
+            loaded.handles.clear();
+        }
+
+        // Keep the buffers under pressure so loaders wait on retirements
+        while (live.size() > 120 || (!live.empty() && random() % 4 == 0)) {
+            auto it = live.begin();
+            std::advance(it, random() % live.size());
+            harness.DestroyMesh(*it);
+            destroyed.push_back(*it);
+            live.erase(it);
+        }
+
+        harness.BeginFrame(completedFence, frameFence);
+        frames++;
+        std::this_thread::yield();
+    }
+    joiner.join();
+
+    // Handed over after the last frame looked, already uploaded by then
+    live.insert(loaded.handles.begin(), loaded.handles.end());
+    harness.BeginFrame(frameFence, frameFence + 1);
+    harness.BeginFrame(frameFence + 1, frameFence + 2);
+
+    Statistics& stats = harness.GetStatistics();
+    CHECK(stats.overlaps == 0);
+    CHECK(stats.duplicateHandles == 0);
+    CHECK(stats.corruptCopies == 0);
+    CHECK(!loaded.stalled);
+    CHECK(stats.unknownDestroys == 0);
+    CHECK(stats.deferredDestroys > 0);
+    CHECK(harness.VerifyContents(live) == 0);
+    for (MeshHandle handle : destroyed) {
+        CHECK(!harness.Resolves(handle));
+    }
+    CHECK(stats.created + stats.written > threadCount * meshesPerThread / 2);
+
+    printf("  %u threads, %u frames: %u created, %u written, %u cancelled, %u destroyed (%u before the drain), "
+           "%u live, %u out of space\n",
+           threadCount, frames, stats.created.load(), stats.written.load(), stats.cancelled.load(),
+           stats.destroyed, stats.deferredDestroys, static_cast<uint32_t>(live.size()), stats.outOfSpace.load());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t meshesPerThread = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 400;
+
+    TestDestroyResults();
+    TestConcurrentCreation(6, meshesPerThread);
+    TestConcurrentCreation(2, meshesPerThread);
+    return FinishTests("MeshCreationStressTest");
+}
@@ -0,0 +1,390 @@
+// =============================================================================
+// Mesh Optimizer Test
+// =============================================================================
+//
+// Each step of the pipeline on its own, then OptimizeMesh end to end:
+// deduplication welds exact copies only, the vertex cache order beats a
+// shuffled one, vertex fetch numbers vertices by first use, and none of them
+// changes what the mesh renders.
+//
+// OptimizeOverdraw on concave meshes, a torus and a bumpy sphere, measured
+// with a small software rasterizer: orthographic views from around the mesh,
+// clockwise front faces, back faces culled, depth tested. Overdraw is pixels
+// shaded over pixels covered, averaged over the views. The overdraw order
+// must shade no more than the vertex cache order it starts from, and keep
+// the same triangles.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "TestMeshes.h"
+#include "resources/MeshOptimizer.h"
+
+namespace {
+
+// Orthographic depth-tested rasterization of the index list from one
+// direction. Returns pixels shaded and pixels covered.
+void Rasterize(const TestMesh& mesh, const std::vector<uint32_t>& indices, const glm::vec3& viewDirection,
+               uint32_t resolution, uint64_t& outShaded, uint64_t& outCovered) {
+    const glm::vec3 forward = glm::normalize(viewDirection);
+    const glm::vec3 up = std::fabs(forward.z) < 0.9f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    const glm::vec3 right = glm::normalize(glm::cross(up, forward));
+    const glm::vec3 down = glm::cross(forward, right);
+
+    std::vector<float> depth(resolution * resolution, INFINITY);
+    const float scale = resolution / 3.2f;   // Both meshes fit in [-1.6, 1.6]
+    const float center = resolution * 0.5f;
+    uint64_t shaded = 0;
+
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const glm::vec3 a = Position(mesh.vertices[indices[t + 0]]);
+        const glm::vec3 b = Position(mesh.vertices[indices[t + 1]]);
+        const glm::vec3 c = Position(mesh.vertices[indices[t + 2]]);
+        if (glm::dot(TriangleNormal(a, b, c), forward) >= 0.0f) {
+            continue;   // Back face
+        }
+
+        float x[3], y[3], z[3];
+        const glm::vec3 corners[3] = { a, b, c };
+        for (int k = 0; k < 3; ++k) {
+            x[k] = center + glm::dot(corners[k], right) * scale;
+            y[k] = center + glm::dot(corners[k], down) * scale;
+            z[k] = glm::dot(corners[k], forward);
+        }
+        const float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (area == 0.0f) {
+            continue;
+        }
+
+        const int minX = std::max(0, static_cast<int>(std::floor(std::min({ x[0], x[1], x[2] }))));
+        const int maxX = std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::ceil(std::max({ x[0], x[1], x[2] }))));
+        const int minY = std::max(0, static_cast<int>(std::floor(std::min({ y[0], y[1], y[2] }))));
+        const int maxY = std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::ceil(std::max({ y[0], y[1], y[2] }))));
+        for (int py = minY; py <= maxY; ++py) {
+            for (int px = minX; px <= maxX; ++px) {
+                const float sx = px + 0.5f;
+                const float sy = py + 0.5f;
+                const float w0 = ((x[1] - sx) * (y[2] - sy) - (x[2] - sx) * (y[1] - sy)) / area;
+                const float w1 = ((x[2] - sx) * (y[0] - sy) - (x[0] - sx) * (y[2] - sy)) / area;
+                const float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                    continue;
+                }
+                const float pixelDepth = w0 * z[0] + w1 * z[1] + w2 * z[2];
+                float& stored = depth[py * resolution + px];
+                if (pixelDepth < stored) {
+                    stored = pixelDepth;
+                    shaded++;
+                }
+            }
+        }
+    }
+
+    outShaded += shaded;
+    outCovered += std::count_if(depth.begin(), depth.end(), [](float d) { return d != INFINITY; });
+}
+
+// Shaded over covered across views spread over the sphere
+float MeasureOverdraw(const TestMesh& mesh, const std::vector<uint32_t>& indices) {
+    const uint32_t viewCount = 16;
+    uint64_t shaded = 0;
+    uint64_t covered = 0;
+    for (uint32_t i = 0; i < viewCount; ++i) {
+        const float z = 1.0f - (2.0f * i + 1.0f) / viewCount;
+        const float ring = std::sqrt(1.0f - z * z);
+        const float angle = 2.39996323f * i;   // Golden angle
+        Rasterize(mesh, indices, glm::vec3(ring * std::cos(angle), ring * std::sin(angle), z), 128, shaded, covered);
+    }
+    return covered > 0 ? static_cast<float>(shaded) / covered : 0.0f;
+}
+
+std::vector<uint32_t> SortedTriangles(const std::vector<uint32_t>& indices) {
+    std::vector<uint32_t> keys;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        // Rotate so the smallest index leads, which keeps the winding
+        const size_t lead = indices[t] <= std::min(indices[t + 1], indices[t + 2]) ? 0
+                          : indices[t + 1] <= indices[t + 2] ? 1 : 2;
+        for (size_t k = 0; k < 3; ++k) {
+            keys.push_back(indices[t + (lead + k) % 3]);
+        }
+    }
+    std::vector<std::vector<uint32_t>> triangles;
+    for (size_t t = 0; t < keys.size(); t += 3) {
+        triangles.push_back({ keys[t], keys[t + 1], keys[t + 2] });
+    }
+    std::sort(triangles.begin(), triangles.end());
+    std::vector<uint32_t> flat;
+    for (const auto& triangle : triangles) {
+        flat.insert(flat.end(), triangle.begin(), triangle.end());
+    }
+    return flat;
+}
+
+// Every triangle gets its own three vertices, with a normal and a UV, and
+// the triangles come in random order: what an exporter that never welds
+// hands over, and the worst case for the post-transform cache
+struct SoupMesh {
+    std::vector<VertexAttributes> vertices;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    std::vector<uint32_t> indices;
+
+    CPUMesh GetCPUMesh() const {
+        CPUMesh mesh;
+        mesh.vertices = vertices.data();
+        mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+        mesh.indices = indices.data();
+        mesh.indexCount = static_cast<uint32_t>(indices.size());
+        mesh.normals = normals.data();
+        mesh.uvs = uvs.data();
+        return mesh;
+    }
+};
+
+SoupMesh MakeSoup(const TestMesh& mesh, uint32_t seed) {
+    std::vector<uint32_t> order(mesh.indices.size() / 3);
+    for (uint32_t t = 0; t < order.size(); ++t) {
+        order[t] = t;
+    }
+    std::mt19937 random(seed);
+    std::shuffle(order.begin(), order.end(), random);
+
+    SoupMesh soup;
+    for (uint32_t t : order) {
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t source = mesh.indices[t * 3 + k];
+            const glm::vec3 p = Position(mesh.vertices[source]);
+            const glm::vec3 n = glm::normalize(p);
+            soup.indices.push_back(static_cast<uint32_t>(soup.vertices.size()));
+            soup.vertices.push_back(mesh.vertices[source]);
+            soup.normals.insert(soup.normals.end(), { n.x, n.y, n.z });
+            soup.uvs.insert(soup.uvs.end(), { static_cast<float>(source % 97) / 97.0f, static_cast<float>(source / 97) });
+        }
+    }
+    return soup;
+}
+
+// Position, normal and UV of every corner in index order: what the mesh
+// renders, whatever the vertex numbering
+std::vector<float> CornerAttributes(const OptimizedMesh& mesh, const std::vector<uint32_t>& indices) {
+    std::vector<float> corners;
+    for (uint32_t index : indices) {
+        const float* p = mesh.vertices[index].position;
+        corners.insert(corners.end(), { p[0], p[1], p[2] });
+        if (!mesh.normals.empty()) {
+            corners.insert(corners.end(), mesh.normals.begin() + index * 3, mesh.normals.begin() + index * 3 + 3);
+        }
+        if (!mesh.uvs.empty()) {
+            corners.insert(corners.end(), mesh.uvs.begin() + index * 2, mesh.uvs.begin() + index * 2 + 2);
+        }
+    }
+    return corners;
+}
+
+void TestDeduplicate() {
+    const TestMesh torus = MakeTorus();
+    SoupMesh soup = MakeSoup(torus, 1);
+
+    // One corner of the first triangle differs from its welded twins by a
+    // single bit of the normal, and must keep a vertex of its own
+    uint32_t bits;
+    memcpy(&bits, &soup.normals[0], sizeof(bits));
+    bits ^= 1;
+    memcpy(&soup.normals[0], &bits, sizeof(bits));
+
+    OptimizedMesh mesh = CopyMesh(soup.GetCPUMesh());
+    const std::vector<float> before = CornerAttributes(mesh, mesh.indices);
+    const uint32_t uniqueCount = DeduplicateVertices(mesh);
+
+    CHECK(uniqueCount == torus.vertices.size() + 1);
+    CHECK(mesh.vertices.size() == uniqueCount);
+    CHECK(mesh.normals.size() == uniqueCount * 3);
+    CHECK(mesh.uvs.size() == uniqueCount * 2);
+    CHECK(CornerAttributes(mesh, mesh.indices) == before);
+
+    uint32_t outOfRange = 0;
+    for (uint32_t index : mesh.indices) {
+        outOfRange += index >= uniqueCount ? 1 : 0;
+    }
+    CHECK(outOfRange == 0);
+
+    // Already welded: nothing to do
+    CHECK(DeduplicateVertices(mesh) == uniqueCount);
+    printf("  dedup: %u corners -> %u vertices\n", static_cast<uint32_t>(soup.vertices.size()), uniqueCount);
+}
+
+void TestVertexCache() {
+    const TestMesh sphere = MakeBumpySphere();
+    OptimizedMesh mesh = CopyMesh(MakeSoup(sphere, 2).GetCPUMesh());
+    DeduplicateVertices(mesh);
+
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    const uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
+    const std::vector<uint32_t> shuffled = mesh.indices;
+    const VertexCacheStats before = AnalyzeVertexCache(shuffled.data(), indexCount, vertexCount);
+
+    std::vector<uint32_t> optimized = shuffled;
+    std::vector<uint32_t> hardClusters;
+    OptimizeVertexCache(optimized.data(), indexCount, vertexCount, 16, &hardClusters);
+    const VertexCacheStats after = AnalyzeVertexCache(optimized.data(), indexCount, vertexCount);
+
+    CHECK(SortedTriangles(optimized) == SortedTriangles(shuffled));
+    CHECK(before.acmr > 2.0f);
+    CHECK(after.acmr < 0.8f);
+    CHECK(after.atvr < 1.4f);
+    CHECK(!hardClusters.empty() && hardClusters[0] == 0);
+    CHECK(std::is_sorted(hardClusters.begin(), hardClusters.end()));
+    printf("  vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", before.acmr, after.acmr, before.atvr, after.atvr);
+}
+
+void TestVertexFetch() {
+    // Vertices numbered backwards, one unused, one only LOD 1 reaches
+    OptimizedMesh mesh;
+    mesh.vertices.resize(6);
+    for (uint32_t v = 0; v < 6; ++v) {
+        mesh.vertices[v].position[0] = static_cast<float>(v);
+    }
+    mesh.indices = { 4, 3, 2, 2, 3, 1 };
+    mesh.lodIndices = { { 4, 0, 1 } };
+    const std::vector<float> lod0 = CornerAttributes(mesh, mesh.indices);
+    const std::vector<float> lod1 = CornerAttributes(mesh, mesh.lodIndices[0]);
+
+    CHECK(OptimizeVertexFetch(mesh) == 5);
+    CHECK(mesh.vertices.size() == 5);
+    CHECK(mesh.indices == std::vector<uint32_t>({ 0, 1, 2, 2, 1, 3 }));
+    CHECK(mesh.lodIndices[0] == std::vector<uint32_t>({ 0, 4, 3 }));
+    CHECK(CornerAttributes(mesh, mesh.indices) == lod0);
+    CHECK(CornerAttributes(mesh, mesh.lodIndices[0]) == lod1);
+
+    // On a real mesh every index is either seen before or the next new one
+    OptimizedMesh torus = CopyMesh(MakeSoup(MakeTorus(), 3).GetCPUMesh());
+    DeduplicateVertices(torus);
+    const uint32_t vertexCount = OptimizeVertexFetch(torus);
+    uint32_t nextNew = 0;
+    uint32_t outOfOrder = 0;
+    for (uint32_t index : torus.indices) {
+        if (index == nextNew) {
+            nextNew++;
+        } else {
+            outOfOrder += index > nextNew ? 1 : 0;
+        }
+    }
+    CHECK(outOfOrder == 0);
+    CHECK(nextNew == vertexCount);
+}
+
+void TestOptimizeMesh() {
+    // A shuffled soup with a hand-made LOD: every other triangle of LOD 0
+    const SoupMesh soup = MakeSoup(MakeBumpySphere(), 4);
+    std::vector<uint32_t> lodIndices;
+    for (size_t t = 0; t + 2 < soup.indices.size(); t += 6) {
+        lodIndices.insert(lodIndices.end(), soup.indices.begin() + t, soup.indices.begin() + t + 3);
+    }
+    CPUMeshLOD lod;
+    lod.indices = lodIndices.data();
+    lod.indexCount = static_cast<uint32_t>(lodIndices.size());
+    lod.error = 0.25f;
+    CPUMesh source = soup.GetCPUMesh();
+    source.lods = &lod;
+    source.lodCount = 1;
+    source.isOccluder = true;
+
+    const OptimizedMesh sourceCopy = CopyMesh(source);
+    MeshOptimizeReport report;
+    OptimizedMesh optimized = OptimizeMesh(source, MeshOptimizeSettings(), &report);
+
+    CHECK(report.vertexCountBefore == soup.vertices.size());
+    CHECK(report.vertexCountAfter == optimized.vertices.size());
+    CHECK(report.vertexCountAfter < report.vertexCountBefore / 4);
+    CHECK(report.before.transformedVertices > 0 && report.after.transformedVertices > 0);
+    CHECK(report.after.acmr < report.before.acmr * 0.5f);
+    CHECK(report.after.transformedVertices < report.before.transformedVertices / 4);
+
+    // Same triangles with the same attributes, LOD and flags carried along
+    CHECK(optimized.lodIndices.size() == 1 && optimized.lodErrors.size() == 1);
+    CHECK(optimized.lodErrors[0] == 0.25f);
+    CHECK(optimized.isOccluder);
+    CHECK(optimized.indices.size() == soup.indices.size());
+    if (optimized.lodIndices.size() == 1) {
+        CHECK(optimized.lodIndices[0].size() == lodIndices.size());
+    }
+
+    // Triangles as sorted corner attribute tuples, so vertex numbering and
+    // triangle order don't matter
+    auto triangleSet = [](const OptimizedMesh& mesh, const std::vector<uint32_t>& indices) {
+        const std::vector<float> corners = CornerAttributes(mesh, indices);
+        const size_t stride = corners.size() / indices.size() * 3;
+        std::vector<std::vector<float>> triangles;
+        for (size_t t = 0; t + stride <= corners.size(); t += stride) {
+            triangles.emplace_back(corners.begin() + t, corners.begin() + t + stride);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+    CHECK(triangleSet(optimized, optimized.indices) == triangleSet(sourceCopy, sourceCopy.indices));
+    if (optimized.lodIndices.size() == 1) {
+        CHECK(triangleSet(optimized, optimized.lodIndices[0]) == triangleSet(sourceCopy, sourceCopy.lodIndices[0]));
+    }
+    printf("  OptimizeMesh: %u -> %u vertices, ACMR %.3f -> %.3f\n", report.vertexCountBefore,
+           report.vertexCountAfter, report.before.acmr, report.after.acmr);
+
+    // Invalid input comes back untouched and leaves the report alone
+    const uint32_t badIndices[3] = { 0, 1, 7 };
+    CPUMesh invalid = source;
+    invalid.indices = badIndices;
+    invalid.indexCount = 3;
+    invalid.vertexCount = 3;
+    invalid.lods = nullptr;
+    invalid.lodCount = 0;
+    MeshOptimizeReport untouched;
+    const OptimizedMesh copy = OptimizeMesh(invalid, MeshOptimizeSettings(), &untouched);
+    CHECK(copy.indices == std::vector<uint32_t>({ 0, 1, 7 }));
+    CHECK(untouched.vertexCountBefore == 0);
+}
+
+void TestOverdraw(const char* name, const TestMesh& mesh) {
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    const uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+    std::vector<uint32_t> cacheOrder = mesh.indices;
+    std::vector<uint32_t> hardClusters;
+    OptimizeVertexCache(cacheOrder.data(), indexCount, vertexCount, 16, &hardClusters);
+
+    std::vector<uint32_t> overdrawOrder = cacheOrder;
+    OptimizeOverdraw(overdrawOrder.data(), indexCount, mesh.vertices.data(), vertexCount, hardClusters, 16, 1.05f);
+    CHECK(SortedTriangles(overdrawOrder) == SortedTriangles(mesh.indices));
+
+    // Back to front is the order the sort must avoid
+    std::vector<uint32_t> reversedOrder;
+    for (size_t t = overdrawOrder.size(); t >= 3; t -= 3) {
+        reversedOrder.insert(reversedOrder.end(), overdrawOrder.begin() + (t - 3), overdrawOrder.begin() + t);
+    }
+
+    const float cacheOverdraw = MeasureOverdraw(mesh, cacheOrder);
+    const float optimizedOverdraw = MeasureOverdraw(mesh, overdrawOrder);
+    const float reversedOverdraw = MeasureOverdraw(mesh, reversedOrder);
+    CHECK(optimizedOverdraw <= cacheOverdraw);
+    CHECK(optimizedOverdraw < reversedOverdraw);
+
+    const float cacheACMR = AnalyzeVertexCache(cacheOrder.data(), indexCount, vertexCount).acmr;
+    const float optimizedACMR = AnalyzeVertexCache(overdrawOrder.data(), indexCount, vertexCount).acmr;
+    printf("  %s: %u clusters, overdraw %.3f -> %.3f (reversed %.3f), ACMR %.3f -> %.3f\n", name,
+           static_cast<uint32_t>(hardClusters.size()), cacheOverdraw, optimizedOverdraw, reversedOverdraw,
+           cacheACMR, optimizedACMR);
+}
+
+} // namespace
+
+int main() {
+    TestDeduplicate();
+    TestVertexCache();
+    TestVertexFetch();
+    TestOptimizeMesh();
+    TestOverdraw("torus", MakeTorus());
+    TestOverdraw("bumpy sphere", MakeBumpySphere());
+    return FinishTests("MeshOptimizerTest");
+}
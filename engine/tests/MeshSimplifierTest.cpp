@@ -0,0 +1,125 @@
+// =============================================================================
+// Mesh Simplifier Test
+// =============================================================================
+//
+// A grid split into two UV islands along a seam column. Both islands share
+// color and normal, so only the UVs tell the seam copies apart; every
+// simplified triangle must still take all its corners from one island.
+
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/MeshSimplifier.h"
+
+namespace {
+
+constexpr uint32_t GRID = 17;           // Vertices per side
+constexpr uint32_t SEAM_COLUMN = 8;
+
+struct SeamGrid {
+    std::vector<VertexAttributes> vertices;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> island;        // Per vertex, 0 left of the seam, 1 right
+
+    CPUMesh GetCPUMesh(bool withUVs) const {
+        CPUMesh mesh;
+        mesh.vertices = vertices.data();
+        mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+        mesh.indices = indices.data();
+        mesh.indexCount = static_cast<uint32_t>(indices.size());
+        mesh.normals = normals.data();
+        mesh.uvs = withUVs ? uvs.data() : nullptr;
+        return mesh;
+    }
+};
+
+SeamGrid BuildSeamGrid() {
+    SeamGrid grid;
+
+    // index[island][y][x], the seam column exists once per island
+    std::vector<uint32_t> index[2];
+    for (uint32_t side = 0; side < 2; ++side) {
+        index[side].assign(GRID * GRID, UINT32_MAX);
+        for (uint32_t y = 0; y < GRID; ++y) {
+            for (uint32_t x = 0; x < GRID; ++x) {
+                if ((side == 0 && x > SEAM_COLUMN) || (side == 1 && x < SEAM_COLUMN)) {
+                    continue;
+                }
+                VertexAttributes vertex = {};
+                vertex.position[0] = static_cast<float>(x);
+                vertex.position[1] = static_cast<float>(y);
+                vertex.color[0] = vertex.color[1] = vertex.color[2] = 1.0f;
+
+                index[side][y * GRID + x] = static_cast<uint32_t>(grid.vertices.size());
+                grid.vertices.push_back(vertex);
+                grid.normals.insert(grid.normals.end(), { 0.0f, 0.0f, -1.0f });
+                grid.uvs.insert(grid.uvs.end(), { side * 0.5f + x / 64.0f, y / 16.0f });
+                grid.island.push_back(static_cast<uint8_t>(side));
+            }
+        }
+    }
+
+    for (uint32_t y = 0; y + 1 < GRID; ++y) {
+        for (uint32_t x = 0; x + 1 < GRID; ++x) {
+            const std::vector<uint32_t>& side = index[x < SEAM_COLUMN ? 0 : 1];
+            const uint32_t a = side[y * GRID + x];
+            const uint32_t b = side[y * GRID + x + 1];
+            const uint32_t c = side[(y + 1) * GRID + x];
+            const uint32_t d = side[(y + 1) * GRID + x + 1];
+            grid.indices.insert(grid.indices.end(), { a, c, b, b, c, d });
+        }
+    }
+    return grid;
+}
+
+uint32_t CountMixedTriangles(const SeamGrid& grid, const std::vector<uint32_t>& indices) {
+    uint32_t mixed = 0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const uint8_t island = grid.island[indices[i]];
+        if (grid.island[indices[i + 1]] != island || grid.island[indices[i + 2]] != island) {
+            mixed++;
+        }
+    }
+    return mixed;
+}
+
+void TestUVSeamsSurvive() {
+    const SeamGrid grid = BuildSeamGrid();
+    CHECK(CountMixedTriangles(grid, grid.indices) == 0);
+
+    const CPUMesh mesh = grid.GetCPUMesh(true);
+    float error = 0.0f;
+    const std::vector<uint32_t> simplified =
+        SimplifyMesh(mesh, mesh.indices, mesh.indexCount, mesh.indexCount / 4, 1e-3f, &error);
+
+    // A flat grid collapses without error, so it must actually reduce
+    CHECK(!simplified.empty());
+    CHECK(simplified.size() < mesh.indexCount / 2);
+    CHECK(simplified.size() % 3 == 0);
+    CHECK(CountMixedTriangles(grid, simplified) == 0);
+}
+
+void TestLODChainKeepsSeams() {
+    const SeamGrid grid = BuildSeamGrid();
+
+    MeshLODSettings settings;
+    settings.lodCount = 3;
+    const MeshLODChain chain = BuildMeshLODChain(grid.GetCPUMesh(true), settings);
+    CHECK(!chain.lodIndices.empty());
+    for (const std::vector<uint32_t>& lod : chain.lodIndices) {
+        CHECK(CountMixedTriangles(grid, lod) == 0);
+        for (uint32_t vertex : lod) {
+            CHECK(vertex < grid.vertices.size());
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    TestUVSeamsSurvive();
+    TestLODChainKeepsSeams();
+    return FinishTests("MeshSimplifierTest");
+}
@@ -0,0 +1,210 @@
+// =============================================================================
+// Meshlet Test
+// =============================================================================
+//
+// BuildMeshlets on a torus and a bumpy sphere: every triangle lands in exactly
+// one meshlet with its winding, within the limits, inside the bounding
+// sphere and inside the normal cone. MeshletCuller against brute force from
+// cameras all around: a meshlet it cone-culls has no triangle facing the
+// camera, one it frustum-culls has no vertex inside the frustum, and the
+// cone test still culls a good share of meshlets from outside.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestCheck.h"
+#include "TestMeshes.h"
+#include "renderer/MeshletCuller.h"
+#include "resources/MeshletBuilder.h"
+
+namespace {
+
+// Mesh-space corners of one meshlet triangle
+void MeshletTriangle(const TestMesh& mesh, const MeshletData& data, const Meshlet& meshlet, uint32_t t,
+                     glm::vec3 corners[3]) {
+    for (uint32_t k = 0; k < 3; ++k) {
+        const uint8_t local = data.triangles[meshlet.triangleOffset + t * 3 + k];
+        corners[k] = Position(mesh.vertices[data.vertexIndices[meshlet.vertexOffset + local]]);
+    }
+}
+
+void TestBuild(const char* name, const TestMesh& mesh, const MeshletData& data) {
+    const uint32_t triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+    CHECK(data.bounds.size() == data.meshlets.size());
+
+    // Each source triangle once, rotated at most, never flipped
+    std::vector<uint32_t> expected;
+    std::vector<uint32_t> built;
+    auto pushTriangle = [](std::vector<uint32_t>& out, uint32_t a, uint32_t b, uint32_t c) {
+        while (a > b || a > c) {
+            std::swap(a, b);
+            std::swap(b, c);
+        }
+        out.insert(out.end(), { a, b, c });
+    };
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        pushTriangle(expected, mesh.indices[t * 3], mesh.indices[t * 3 + 1], mesh.indices[t * 3 + 2]);
+    }
+
+    uint32_t overLimit = 0;
+    uint32_t badLocalIndex = 0;
+    uint32_t outsideSphere = 0;
+    uint32_t outsideCone = 0;
+    uint32_t coneMeshlets = 0;
+    for (size_t m = 0; m < data.meshlets.size(); ++m) {
+        const Meshlet& meshlet = data.meshlets[m];
+        const MeshletBounds& bounds = data.bounds[m];
+        overLimit += meshlet.vertexCount > MAX_MESHLET_VERTICES || meshlet.triangleCount > MAX_MESHLET_TRIANGLES ? 1 : 0;
+
+        const glm::vec3 center(bounds.center[0], bounds.center[1], bounds.center[2]);
+        const glm::vec3 axis(bounds.coneAxis[0], bounds.coneAxis[1], bounds.coneAxis[2]);
+        const float minDot = std::sqrt(std::max(0.0f, 1.0f - bounds.coneCutoff * bounds.coneCutoff));
+        coneMeshlets += bounds.coneCutoff < 1.0f ? 1 : 0;
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            uint32_t vertex[3];
+            for (uint32_t k = 0; k < 3; ++k) {
+                const uint8_t local = data.triangles[meshlet.triangleOffset + t * 3 + k];
+                badLocalIndex += local >= meshlet.vertexCount ? 1 : 0;
+                vertex[k] = data.vertexIndices[meshlet.vertexOffset + std::min<uint32_t>(local, meshlet.vertexCount - 1)];
+            }
+            pushTriangle(built, vertex[0], vertex[1], vertex[2]);
+
+            glm::vec3 corners[3];
+            MeshletTriangle(mesh, data, meshlet, t, corners);
+            for (const glm::vec3& corner : corners) {
+                outsideSphere += glm::length(corner - center) > bounds.radius * 1.0001f + 1e-5f ? 1 : 0;
+            }
+            const glm::vec3 n = TriangleNormal(corners[0], corners[1], corners[2]);
+            if (bounds.coneCutoff < 1.0f && glm::dot(n, n) > 0.0f) {
+                outsideCone += glm::dot(glm::normalize(n), axis) < minDot - 1e-4f ? 1 : 0;
+            }
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> expectedSorted;
+    std::vector<std::vector<uint32_t>> builtSorted;
+    for (size_t i = 0; i + 2 < expected.size(); i += 3) {
+        expectedSorted.push_back({ expected[i], expected[i + 1], expected[i + 2] });
+    }
+    for (size_t i = 0; i + 2 < built.size(); i += 3) {
+        builtSorted.push_back({ built[i], built[i + 1], built[i + 2] });
+    }
+    std::sort(expectedSorted.begin(), expectedSorted.end());
+    std::sort(builtSorted.begin(), builtSorted.end());
+    CHECK(builtSorted == expectedSorted);
+
+    CHECK(overLimit == 0);
+    CHECK(badLocalIndex == 0);
+    CHECK(outsideSphere == 0);
+    CHECK(outsideCone == 0);
+    CHECK(coneMeshlets > data.meshlets.size() / 2);
+    printf("  %s: %u triangles in %u meshlets, %u with a cone\n", name, triangleCount,
+           static_cast<uint32_t>(data.meshlets.size()), coneMeshlets);
+}
+
+// Cameras on a shell around the mesh, each looking at a random point near it;
+// at least minCulledShare of the meshlet tests must cone-cull
+void TestCulling(const char* name, const TestMesh& mesh, const MeshletData& data, float minCulledShare,
+                 uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    uint32_t wrongBackface = 0;
+    uint32_t wrongFrustum = 0;
+    uint32_t mirroredCulled = 0;
+    uint64_t tested = 0;
+    uint64_t backfaceCulled = 0;
+
+    MeshletCuller culler;
+    for (uint32_t view = 0; view < 200; ++view) {
+        glm::vec3 direction(unit(random), unit(random), unit(random));
+        if (glm::dot(direction, direction) < 1e-3f) {
+            direction = glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+        const glm::vec3 cameraPosition = glm::normalize(direction) * (view % 4 == 0 ? 1.3f : 2.0f + 6.0f * scale(random));
+        const glm::vec3 target(0.4f * unit(random), 0.4f * unit(random), 0.4f * unit(random));
+        const glm::mat4 viewMatrix = glm::lookAt(cameraPosition, target, glm::vec3(0.3f, 0.2f, 1.0f));
+        const glm::mat4 projection = glm::perspective(glm::radians(50.0f), 1.5f, 0.1f, 100.0f);
+        const glm::mat4 viewProj = projection * viewMatrix;
+        culler.BeginView(viewProj, cameraPosition);
+
+        // Identity, then a rotated and non-uniformly scaled instance
+        glm::mat4 model(1.0f);
+        if (view % 2 == 1) {
+            model = glm::rotate(glm::mat4(1.0f), unit(random) * 3.0f, glm::vec3(unit(random), unit(random), 1.0f));
+            model = glm::scale(model, glm::vec3(scale(random), scale(random), scale(random)));
+        }
+
+        std::vector<uint32_t> visible;
+        culler.CullMeshlets(data.bounds.data(), static_cast<uint32_t>(data.bounds.size()), model, visible);
+        std::vector<uint8_t> isVisible(data.meshlets.size(), 0);
+        for (uint32_t m : visible) {
+            isVisible[m] = 1;
+        }
+
+        for (size_t m = 0; m < data.meshlets.size(); ++m) {
+            const MeshletCuller::Result result = culler.Classify(data.bounds[m], model);
+            CHECK((result == MeshletCuller::Result::Visible) == (isVisible[m] != 0));
+            tested++;
+            if (result == MeshletCuller::Result::Visible) {
+                continue;
+            }
+
+            const Meshlet& meshlet = data.meshlets[m];
+            bool anyFront = false;
+            bool anyInside = false;
+            for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+                glm::vec3 corners[3];
+                MeshletTriangle(mesh, data, meshlet, t, corners);
+                for (glm::vec3& corner : corners) {
+                    corner = glm::vec3(model * glm::vec4(corner, 1.0f));
+                    const glm::vec4 clip = viewProj * glm::vec4(corner, 1.0f);
+                    anyInside |= std::fabs(clip.x) <= clip.w && std::fabs(clip.y) <= clip.w &&
+                                 std::fabs(clip.z) <= clip.w;
+                }
+                anyFront |= glm::dot(TriangleNormal(corners[0], corners[1], corners[2]), corners[0] - cameraPosition) < 0.0f;
+            }
+            if (result == MeshletCuller::Result::BackfaceCulled) {
+                wrongBackface += anyFront ? 1 : 0;
+                backfaceCulled++;
+            } else {
+                wrongFrustum += anyInside ? 1 : 0;
+            }
+        }
+
+        // A mirrored instance flips the winding, the cone says nothing
+        const glm::mat4 mirrored = glm::scale(glm::mat4(1.0f), glm::vec3(-1.0f, 1.0f, 1.0f));
+        for (const MeshletBounds& bounds : data.bounds) {
+            mirroredCulled += culler.Classify(bounds, mirrored) == MeshletCuller::Result::BackfaceCulled ? 1 : 0;
+        }
+    }
+
+    CHECK(wrongBackface == 0);
+    CHECK(wrongFrustum == 0);
+    CHECK(mirroredCulled == 0);
+    CHECK(backfaceCulled > minCulledShare * tested);
+    printf("  %s: %.1f%% of meshlet tests cone-culled\n", name, 100.0 * backfaceCulled / tested);
+}
+
+} // namespace
+
+int main() {
+    const TestMesh torus = MakeTorus();
+    const MeshletData torusMeshlets = BuildMeshlets(torus.vertices.data(), static_cast<uint32_t>(torus.vertices.size()),
+                                                    torus.indices.data(), static_cast<uint32_t>(torus.indices.size()));
+    TestBuild("torus", torus, torusMeshlets);
+    TestCulling("torus", torus, torusMeshlets, 0.15f, 43);
+
+    const TestMesh sphere = MakeBumpySphere();
+    const MeshletData sphereMeshlets = BuildMeshlets(sphere.vertices.data(), static_cast<uint32_t>(sphere.vertices.size()),
+                                                     sphere.indices.data(), static_cast<uint32_t>(sphere.indices.size()));
+    TestBuild("bumpy sphere", sphere, sphereMeshlets);
+    TestCulling("bumpy sphere", sphere, sphereMeshlets, 0.02f, 44);
+    return FinishTests("MeshletTest");
+}
@@ -0,0 +1,162 @@
+// =============================================================================
+// Occlusion Culler Test
+// =============================================================================
+//
+// One wall in front of the camera. A box behind it is occluded; boxes beside
+// it, in front of it, or only partly behind its edge stay visible; boxes off
+// screen or past the far plane are frustum culled. A box straddling the near
+// plane is never culled, and an occluder straddling it is dropped rather than
+// hiding what is behind. Runs at the default size and at an odd size that
+// folds edge texels into the pyramid.
+
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TestCheck.h"
+#include "renderer/OcclusionCuller.h"
+
+namespace {
+
+using Result = OcclusionCuller::Result;
+
+// Unit cube centered on the origin
+OccluderGeometry MakeCube() {
+    OccluderGeometry cube;
+    for (int corner = 0; corner < 8; ++corner) {
+        cube.positions.push_back((corner & 1) ? 0.5f : -0.5f);
+        cube.positions.push_back((corner & 2) ? 0.5f : -0.5f);
+        cube.positions.push_back((corner & 4) ? 0.5f : -0.5f);
+    }
+    cube.indices = {
+        0, 2, 1,   1, 2, 3,     // -Z
+        4, 5, 6,   5, 7, 6,     // +Z
+        0, 1, 4,   1, 5, 4,     // -Y
+        2, 6, 3,   3, 6, 7,     // +Y
+        0, 4, 2,   2, 4, 6,     // -X
+        1, 3, 5,   3, 7, 5      // +X
+    };
+    return cube;
+}
+
+MeshBounds MakeBounds(const glm::vec3& center, float halfExtent) {
+    MeshBounds bounds;
+    for (int axis = 0; axis < 3; ++axis) {
+        bounds.min[axis] = center[axis] - halfExtent;
+        bounds.max[axis] = center[axis] + halfExtent;
+    }
+    return bounds;
+}
+
+// Camera at z = 6 looking down -Z; the view is about 10 units wide at z = -3
+glm::mat4 MakeViewProj() {
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 6.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f) * view;
+}
+
+// 4x4 wall, 0.2 thick, at z = 1
+glm::mat4 WallModel() {
+    return glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(4.0f, 4.0f, 0.2f));
+}
+
+void TestScene(const OcclusionCuller::Config& config) {
+    OcclusionCuller culler(config);
+    CHECK(culler.GetWidth() % 4 == 0);
+    CHECK(culler.GetWidth() >= config.width);
+
+    const OccluderGeometry cube = MakeCube();
+    culler.BeginFrame(MakeViewProj());
+    culler.RasterizeOccluder(cube, WallModel());
+    culler.FinalizeOccluders();
+
+    const glm::mat4 identity(1.0f);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, -3.0f), 0.5f), identity) == Result::Occluded);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(1.5f, -1.5f, -3.0f), 0.5f), identity) == Result::Occluded);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(8.0f, 0.0f, -3.0f), 0.5f), identity) == Result::Visible);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, 3.0f), 0.5f), identity) == Result::Visible);
+
+    // The wall's shadow reaches x = 3.7 at z = -3, this box spans 3 to 4
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(3.5f, 0.0f, -3.0f), 0.5f), identity) == Result::Visible);
+
+    // Same box as the first, moved behind the wall through the model matrix
+    const glm::mat4 moved = glm::translate(identity, glm::vec3(0.0f, 0.0f, -3.0f));
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f), 0.5f), moved) == Result::Occluded);
+
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(50.0f, 0.0f, -3.0f), 0.5f), identity) == Result::FrustumCulled);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, -200.0f), 0.5f), identity) == Result::FrustumCulled);
+
+    // Around the camera and fully behind it: clip w crosses zero, so nothing is culled
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, 6.0f), 0.5f), identity) == Result::Visible);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, 5.95f), 0.1f), identity) == Result::Visible);
+    CHECK(culler.TestBounds(MakeBounds(glm::vec3(0.0f, 0.0f, 10.0f), 0.5f), identity) == Result::Visible);
+
+    const OcclusionCuller::Statistics& stats = culler.GetStatistics();
+    CHECK(stats.occluderMeshes == 1);
+    CHECK(stats.occluderTriangles == 12);
+    CHECK(stats.testedObjects == 11);
+    CHECK(stats.occludedObjects == 3);
+    CHECK(stats.frustumCulledObjects == 2);
+    CHECK(stats.visibleObjects == 6);
+    printf("  %ux%u: %u of 12 wall triangles rasterized\n", culler.GetWidth(), culler.GetHeight(),
+           stats.rasterizedTriangles);
+}
+
+void TestOccluderCrossingNearPlane() {
+    // A tilted plane, z = 5 + 0.75x, passing between the camera and the box
+    // at x = 0; its x = 20 edge is behind the camera, so both triangles are
+    // dropped instead of clipped
+    OccluderGeometry plane;
+    plane.positions = {
+        -20.0f, -20.0f, -10.0f,
+        -20.0f,  20.0f, -10.0f,
+         20.0f, -20.0f,  20.0f,
+         20.0f,  20.0f,  20.0f
+    };
+    plane.indices = { 0, 1, 2,   1, 3, 2 };
+
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProj());
+    culler.RasterizeOccluder(plane, glm::mat4(1.0f));
+    culler.FinalizeOccluders();
+
+    CHECK(culler.GetStatistics().rasterizedTriangles == 0);
+    CHECK(culler.Classify(MakeBounds(glm::vec3(0.0f, 0.0f, -3.0f), 0.5f), glm::mat4(1.0f)) == Result::Visible);
+
+    uint32_t written = 0;
+    for (float depth : culler.GetDepthBuffer()) {
+        written += depth < 1.0f ? 1 : 0;
+    }
+    CHECK(written == 0);
+}
+
+void TestBeginFrameClears() {
+    OcclusionCuller culler;
+    culler.BeginFrame(MakeViewProj());
+    culler.RasterizeOccluder(MakeCube(), WallModel());
+    culler.FinalizeOccluders();
+    const MeshBounds behind = MakeBounds(glm::vec3(0.0f, 0.0f, -3.0f), 0.5f);
+    CHECK(culler.Classify(behind, glm::mat4(1.0f)) == Result::Occluded);
+
+    // Next frame without occluders
+    culler.BeginFrame(MakeViewProj());
+    culler.FinalizeOccluders();
+    CHECK(culler.Classify(behind, glm::mat4(1.0f)) == Result::Visible);
+    CHECK(culler.GetStatistics().occluderMeshes == 0);
+}
+
+} // namespace
+
+int main() {
+    TestScene(OcclusionCuller::Config{});
+
+    OcclusionCuller::Config odd;
+    odd.width = 90;
+    odd.height = 45;
+    odd.maxTestTexels = 2;
+    TestScene(odd);
+
+    TestOccluderCrossingNearPlane();
+    TestBeginFrameClears();
+    return FinishTests("OcclusionCullerTest");
+}
@@ -0,0 +1,309 @@
+// =============================================================================
+// Pack File Test
+// =============================================================================
+//
+// PackWriter -> PackFile round trip: every entry starts on a 4 KiB boundary,
+// the TOC is sorted for the binary search and finds every path (and no
+// others), compressed and raw entries read back intact, and compression is
+// dropped where it doesn't pay. Truncated files and corrupt headers or TOC
+// entries are rejected by Open. VirtualFileSystem serves the newest mount
+// that has a file, so a loose directory mounted after a pack overrides it.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "TestFiles.h"
+#include "IO/PackFile.h"
+#include "IO/VirtualFileSystem.h"
+
+namespace {
+
+std::vector<uint8_t> Noise(size_t size, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& value : bytes) {
+        value = static_cast<uint8_t>(random());
+    }
+    return bytes;
+}
+
+std::vector<uint8_t> Repeating(size_t size, uint32_t seed) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>((i / 16 + seed) % 7);
+    }
+    return bytes;
+}
+
+std::vector<uint8_t> Bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+struct Expected {
+    std::string path;
+    std::vector<uint8_t> data;
+};
+
+void TestNormalize() {
+    CHECK(NormalizePackPath("textures\\stone/./albedo.png") == "textures/stone/albedo.png");
+    CHECK(NormalizePackPath("/a//b/../c/") == "a/c");
+    CHECK(NormalizePackPath("../outside") == "../outside");
+    CHECK(NormalizePackPath("") == "");
+}
+
+void TestRoundTrip(const TempDirectory& directory) {
+    PackWriter writer;
+    std::vector<Expected> expected;
+
+    // Enough entries for the binary search to matter, mixed sizes
+    for (uint32_t i = 0; i < 300; ++i) {
+        Expected entry;
+        entry.path = "meshes/group" + std::to_string(i % 7) + "/mesh" + std::to_string(i) + ".de3mesh";
+        const size_t size = (i * 7919) % 20000;
+        entry.data = i % 2 == 0 ? Repeating(size, i) : Noise(size, i);
+        writer.AddData(entry.path, entry.data, true);
+        expected.push_back(std::move(entry));
+    }
+
+    // Written from disk, a non-normalized path, an empty entry, and a path
+    // added twice where the later data wins
+    WriteTestFile(directory.File("source/shader.hlsl"), std::string("float4 main() : SV_Target { return 1; }"));
+    writer.AddFile("shaders\\.\\main.hlsl", directory.File("source/shader.hlsl"), false);
+    expected.push_back({ "shaders/main.hlsl", Bytes("float4 main() : SV_Target { return 1; }") });
+    writer.AddData("empty.bin", {}, true);
+    expected.push_back({ "empty.bin", {} });
+    writer.AddData("config.ini", Bytes("old"), false);
+    writer.AddData("config.ini", Bytes("new"), false);
+    expected.push_back({ "config.ini", Bytes("new") });
+
+    const std::string packPath = directory.File("assets.de3pack");
+    PackWriter::Statistics stats;
+    CHECK(writer.Write(packPath, &stats));
+    CHECK(stats.entries == expected.size());
+    CHECK(stats.compressedEntries > 0);
+    CHECK(stats.storedBytes < stats.sourceBytes);
+
+    PackFile pack;
+    CHECK(pack.Open(packPath));
+    CHECK(pack.GetEntryCount() == expected.size());
+
+    uint32_t misaligned = 0;
+    uint32_t unsorted = 0;
+    uint32_t noisyCompressed = 0;
+    uint32_t repeatingRaw = 0;
+    for (uint32_t i = 0; i < pack.GetEntryCount(); ++i) {
+        const PackEntry& entry = pack.GetEntry(i);
+        misaligned += entry.offset % PACK_ALIGNMENT != 0 ? 1 : 0;
+        if (i > 0) {
+            const PackEntry& previous = pack.GetEntry(i - 1);
+            unsorted += previous.pathHash > entry.pathHash ||
+                        (previous.pathHash == entry.pathHash && pack.GetEntryName(i - 1) >= pack.GetEntryName(i)) ? 1 : 0;
+        }
+        CHECK(entry.pathHash == HashPackPath(pack.GetEntryName(i)));
+    }
+    CHECK(misaligned == 0);
+    CHECK(unsorted == 0);
+
+    uint32_t notFound = 0;
+    uint32_t wrongData = 0;
+    for (size_t e = 0; e < expected.size(); ++e) {
+        const uint32_t index = pack.Find(expected[e].path);
+        if (index == PackFile::INVALID_ENTRY) {
+            notFound++;
+            continue;
+        }
+        std::vector<uint8_t> data;
+        wrongData += pack.Read(index, data) && data == expected[e].data ? 0 : 1;
+
+        // Raw entries are served straight from the mapping
+        const PackEntry& entry = pack.GetEntry(index);
+        if (entry.compression == PackCompression::None) {
+            wrongData += entry.size == 0 || memcmp(pack.GetStoredData(index), data.data(), data.size()) == 0 ? 0 : 1;
+        }
+        if (e < 300 && entry.size > 1000) {
+            noisyCompressed += e % 2 == 1 && entry.compression == PackCompression::LZ4 ? 1 : 0;
+            repeatingRaw += e % 2 == 0 && entry.compression == PackCompression::None ? 1 : 0;
+        }
+    }
+    CHECK(notFound == 0);
+    CHECK(wrongData == 0);
+    CHECK(noisyCompressed == 0);
+    CHECK(repeatingRaw == 0);
+
+    CHECK(pack.Find("meshes/mesh0.de3mesh") == PackFile::INVALID_ENTRY);
+    CHECK(pack.Find("config.in") == PackFile::INVALID_ENTRY);
+    CHECK(pack.Find("") == PackFile::INVALID_ENTRY);
+    printf("  %u entries, %llu -> %llu bytes, %llu byte file\n", stats.entries,
+           static_cast<unsigned long long>(stats.sourceBytes), static_cast<unsigned long long>(stats.storedBytes),
+           static_cast<unsigned long long>(stats.fileSize));
+}
+
+// Writes bytes to a fresh file and tries to open it as a pack
+bool OpensAfter(const TempDirectory& directory, const std::vector<uint8_t>& bytes) {
+    const std::string path = directory.File("damaged.de3pack");
+    WriteTestFile(path, bytes);
+    PackFile pack;
+    return pack.Open(path);
+}
+
+void TestCorruption(const TempDirectory& directory) {
+    PackWriter writer;
+    for (uint32_t i = 0; i < 20; ++i) {
+        writer.AddData("file" + std::to_string(i), Repeating(3000 + i * 100, i), i % 2 == 0);
+    }
+    const std::string packPath = directory.File("valid.de3pack");
+    CHECK(writer.Write(packPath));
+    const std::vector<uint8_t> valid = ReadTestFile(packPath);
+    CHECK(OpensAfter(directory, valid));
+
+    PackHeader header;
+    memcpy(&header, valid.data(), sizeof(header));
+    auto entryAt = [&header](std::vector<uint8_t>& bytes, uint32_t index) {
+        return reinterpret_cast<PackEntry*>(bytes.data() + header.tocOffset + index * sizeof(PackEntry));
+    };
+
+    // Truncated anywhere from the header to the last name byte
+    for (size_t size : { size_t(0), size_t(10), sizeof(PackHeader), static_cast<size_t>(header.tocOffset) + 10,
+                         static_cast<size_t>(header.namesOffset), valid.size() - 1 }) {
+        CHECK(!OpensAfter(directory, std::vector<uint8_t>(valid.begin(), valid.begin() + size)));
+    }
+
+    std::vector<uint8_t> bytes = valid;
+    reinterpret_cast<PackHeader*>(bytes.data())->magic ^= 1;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    reinterpret_cast<PackHeader*>(bytes.data())->version = PACK_VERSION + 1;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    reinterpret_cast<PackHeader*>(bytes.data())->entryCount = 1000000;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    reinterpret_cast<PackHeader*>(bytes.data())->tocOffset += 4;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    entryAt(bytes, 3)->offset = valid.size() - 10;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    entryAt(bytes, 3)->storedSize = UINT64_MAX - 100;
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    entryAt(bytes, 5)->nameOffset = static_cast<uint32_t>(header.namesSize);
+    CHECK(!OpensAfter(directory, bytes));
+
+    bytes = valid;
+    entryAt(bytes, 5)->compression = static_cast<PackCompression>(7);
+    CHECK(!OpensAfter(directory, bytes));
+
+    // Raw entries must store exactly their size
+    bytes = valid;
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        if (entryAt(bytes, i)->compression == PackCompression::None) {
+            entryAt(bytes, i)->size++;
+            break;
+        }
+    }
+    CHECK(!OpensAfter(directory, bytes));
+
+    // Out of order TOC would break the binary search
+    bytes = valid;
+    std::swap(*entryAt(bytes, 2), *entryAt(bytes, 9));
+    CHECK(!OpensAfter(directory, bytes));
+
+    // A damaged LZ4 payload opens, but the read fails instead of
+    // returning garbage
+    bytes = valid;
+    uint32_t compressedIndex = PackFile::INVALID_ENTRY;
+    for (uint32_t i = 0; i < header.entryCount && compressedIndex == PackFile::INVALID_ENTRY; ++i) {
+        if (entryAt(bytes, i)->compression == PackCompression::LZ4) {
+            compressedIndex = i;
+        }
+    }
+    CHECK(compressedIndex != PackFile::INVALID_ENTRY);
+    if (compressedIndex != PackFile::INVALID_ENTRY) {
+        const PackEntry* entry = entryAt(bytes, compressedIndex);
+        entryAt(bytes, compressedIndex)->storedSize = entry->storedSize / 2;
+        const std::string path = directory.File("damaged_payload.de3pack");
+        WriteTestFile(path, bytes);
+        PackFile pack;
+        CHECK(pack.Open(path));
+        std::vector<uint8_t> data;
+        CHECK(!pack.Read(compressedIndex, data));
+    }
+}
+
+void TestVirtualFileSystem(const TempDirectory& directory) {
+    PackWriter base;
+    base.AddData("shaders/main.hlsl", Bytes("pack main"), false);
+    base.AddData("shaders/common.hlsl", Bytes("pack common, long enough to compress: aaaaaaaaaaaaaaaaaaaaaaaaaaaa"), true);
+    base.AddData("textures/stone.png", Bytes("pack stone"), false);
+    CHECK(base.Write(directory.File("base.de3pack")));
+
+    PackWriter patch;
+    patch.AddData("textures/stone.png", Bytes("patch stone"), false);
+    CHECK(patch.Write(directory.File("patch.de3pack")));
+
+    WriteTestFile(directory.File("loose/shaders/main.hlsl"), std::string("loose main"));
+    WriteTestFile(directory.File("loose/textures/stone.png"), std::string("loose stone"));
+
+    VirtualFileSystem vfs;
+    CHECK(vfs.MountPack(directory.File("base.de3pack")));
+    std::string text;
+    CHECK(vfs.ReadFile("shaders/main.hlsl", text) && text == "pack main");
+
+    // Loose files mounted later override the pack, others still come from it
+    vfs.MountDirectory(directory.File("loose"));
+    CHECK(vfs.ReadFile("shaders/main.hlsl", text) && text == "loose main");
+    CHECK(vfs.ReadFile("./shaders\\main.hlsl", text) && text == "loose main");
+    CHECK(vfs.ReadFile("shaders/common.hlsl", text) && text.compare(0, 11, "pack common") == 0);
+    CHECK(vfs.ReadFile("textures/stone.png", text) && text == "loose stone");
+
+    // And a pack mounted after the directory overrides it again
+    CHECK(vfs.MountPack(directory.File("patch.de3pack")));
+    CHECK(vfs.ReadFile("textures/stone.png", text) && text == "patch stone");
+    CHECK(vfs.ReadFile("shaders/main.hlsl", text) && text == "loose main");
+
+    CHECK(!vfs.Exists("shaders/missing.hlsl"));
+    CHECK(!vfs.ReadFile("shaders/missing.hlsl", text));
+    CHECK(!vfs.MountPack(directory.File("missing.de3pack")));
+    CHECK(vfs.GetMountCount() == 3);
+
+    // Views: raw entries point into the pack, compressed ones own a copy
+    FileView view;
+    CHECK(vfs.OpenView("textures/stone.png", view));
+    CHECK(view.IsValid() && view.GetSize() == 11 && memcmp(view.GetData(), "patch stone", 11) == 0);
+    CHECK(vfs.OpenView("shaders/common.hlsl", view));
+    CHECK(view.IsValid() && view.GetSize() > 11 && memcmp(view.GetData(), "pack common", 11) == 0);
+    CHECK(vfs.OpenView("shaders/main.hlsl", view));
+    CHECK(view.IsValid() && view.GetSize() == 10 && memcmp(view.GetData(), "loose main", 10) == 0);
+
+    // A mount point only serves paths under it
+    VirtualFileSystem mounted;
+    CHECK(mounted.MountPack(directory.File("base.de3pack"), "data"));
+    CHECK(mounted.Exists("data/shaders/main.hlsl"));
+    CHECK(!mounted.Exists("shaders/main.hlsl"));
+    CHECK(!mounted.Exists("database/shaders/main.hlsl"));
+
+    vfs.UnmountAll();
+    CHECK(!vfs.Exists("shaders/main.hlsl"));
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("pack_file_test");
+    TestNormalize();
+    TestRoundTrip(directory);
+    TestCorruption(directory);
+    TestVirtualFileSystem(directory);
+    return FinishTests("PackFileTest");
+}
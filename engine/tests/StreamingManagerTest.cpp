@@ -0,0 +1,236 @@
+// =============================================================================
+// Streaming Manager Test
+// =============================================================================
+//
+// StreamingManager against a mock target that records every create and
+// destroy: loads are issued and uploaded in priority order, resident plus
+// loading bytes never exceed the budget even when every mesh stays wanted,
+// eviction takes the least recently requested mesh first and spares meshes
+// within the grace period, and a mesh larger than the whole budget is
+// counted as rejected instead of blocking the queue behind it.
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TestCheck.h"
+#include "TestFiles.h"
+#include "IO/FileIOService.h"
+#include "resources/CookedMesh.h"
+#include "resources/StreamingManager.h"
+
+namespace {
+
+constexpr uint32_t SMALL_MESHES = 6;
+constexpr uint32_t BIG_MESH = SMALL_MESHES;
+
+// Records the target's view of the world; handles are streamed handles + 1
+// so the mock can tell which mesh it was given from the vertex bytes
+class RecordingTarget : public IMeshStreamingTarget {
+public:
+    MeshHandle CreateMesh(const EncodedMesh& mesh) override {
+        const uint32_t id = static_cast<const uint8_t*>(mesh.vertexData)[0];
+        const size_t bytes = static_cast<size_t>(mesh.vertexCount) * mesh.layout.GetStride() + mesh.GetIndexDataSize();
+        created.push_back(id);
+        live[id + 1] = bytes;
+        liveBytes += bytes;
+        return id + 1;
+    }
+
+    void DestroyMesh(MeshHandle handle) override {
+        auto it = live.find(handle);
+        if (it == live.end()) {
+            errors++;
+            return;
+        }
+        destroyed.push_back(handle - 1);
+        liveBytes -= it->second;
+        live.erase(it);
+    }
+
+    std::vector<uint32_t> created;
+    std::vector<uint32_t> destroyed;
+    std::unordered_map<MeshHandle, size_t> live;
+    size_t liveBytes = 0;
+    uint32_t errors = 0;
+};
+
+// Six small meshes of equal size and one big one; the first vertex byte is
+// the mesh's index
+bool WriteMeshes(const std::string& path) {
+    std::vector<CookedMesh> meshes(SMALL_MESHES + 1);
+    for (uint32_t i = 0; i < meshes.size(); ++i) {
+        CookedMesh& mesh = meshes[i];
+        mesh.name = "mesh" + std::to_string(i);
+        mesh.layout = VertexLayout::Float();
+        mesh.vertexCount = i == BIG_MESH ? 4000 : 40;
+        mesh.indexFormat = IndexFormat::Uint32;
+        mesh.lodIndexCounts = { 48 };
+        mesh.bounds.max[0] = mesh.bounds.max[1] = mesh.bounds.max[2] = 1.0f;
+        mesh.vertexData.assign(static_cast<size_t>(mesh.vertexCount) * mesh.layout.GetStride(), static_cast<uint8_t>(i));
+        mesh.indexData.assign(48 * sizeof(uint32_t), 0);
+    }
+    return WriteCookedMeshFile(path, meshes);
+}
+
+// One frame: requests with their screen sizes, then Update, then wait for
+// the loads it issued so the next frame sees them complete
+struct Request {
+    StreamedMeshHandle handle;
+    float screenSize;
+};
+
+void RunFrame(StreamingManager& streaming, FileIOService& io, const std::vector<Request>& requests) {
+    streaming.BeginFrame(glm::vec3(0.0f), 60.0f);
+    for (const Request& request : requests) {
+        streaming.RequestMesh(request.handle, request.screenSize, 10.0f);
+    }
+    streaming.Update();
+    io.WaitIdle();
+}
+
+bool IsResident(const StreamingManager& streaming, StreamedMeshHandle handle) {
+    return streaming.GetMeshState(handle) == StreamingManager::MeshState::Resident;
+}
+
+void TestPriorityOrder(const std::string& path, FileIOService& io) {
+    RecordingTarget target;
+    StreamingManager streaming(&target, &io);
+    std::vector<StreamedMeshHandle> handles;
+    CHECK(streaming.AddCookedMeshFile(path, &handles));
+    CHECK(handles.size() == SMALL_MESHES + 1);
+
+    // One load per frame, so the issue order is visible in the creates
+    StreamingManager::Config config;
+    config.ioBytesPerFrame = streaming.GetMeshBytes(handles[0]);
+    streaming.SetConfig(config);
+
+    const std::vector<Request> requests = {
+        { handles[0], 0.1f }, { handles[1], 0.5f }, { handles[2], 0.05f },
+        { handles[3], 0.9f }, { handles[4], 0.3f }, { handles[5], 0.7f },
+    };
+    for (uint32_t frame = 0; frame < 8; ++frame) {
+        RunFrame(streaming, io, requests);
+    }
+    CHECK(target.created == std::vector<uint32_t>({ 3, 5, 1, 4, 0, 2 }));
+    CHECK(streaming.GetStatistics().loadsIssued == SMALL_MESHES);
+    CHECK(streaming.GetStatistics().residentBytes == target.liveBytes);
+    CHECK(streaming.GetMeshHandle(handles[3]) == 4);
+    CHECK(streaming.GetMeshHandle(handles[6]) == INVALID_MESH_HANDLE);
+
+    // A later, bigger request outranks what is still waiting
+    RecordingTarget second;
+    StreamingManager late(&second, &io, config);
+    CHECK(late.AddCookedMeshFile(path));
+    RunFrame(late, io, { { 0, 0.9f }, { 1, 0.5f }, { 2, 0.1f } });
+    RunFrame(late, io, { { 1, 0.5f }, { 2, 0.95f } });
+    RunFrame(late, io, { { 1, 0.5f }, { 2, 0.95f } });
+    RunFrame(late, io, { { 1, 0.5f }, { 2, 0.95f } });
+    CHECK(second.created == std::vector<uint32_t>({ 0, 2, 1 }));
+    CHECK(second.errors == 0);
+}
+
+void TestBudgetAndEviction(const std::string& path, FileIOService& io) {
+    RecordingTarget target;
+    StreamingManager streaming(&target, &io);
+    std::vector<StreamedMeshHandle> handles;
+    CHECK(streaming.AddCookedMeshFile(path, &handles));
+
+    const size_t meshBytes = streaming.GetMeshBytes(handles[0]);
+    StreamingManager::Config config;
+    config.residentBudget = meshBytes * 3;
+    config.evictionGraceFrames = 2;
+    streaming.SetConfig(config);
+
+    // Everything wanted every frame: three fit, the rest stall
+    std::vector<Request> all;
+    for (uint32_t i = 0; i < SMALL_MESHES; ++i) {
+        all.push_back({ handles[i], 1.0f - 0.1f * i });
+    }
+    uint32_t overBudget = 0;
+    for (uint32_t frame = 0; frame < 10; ++frame) {
+        RunFrame(streaming, io, all);
+        const StreamingManager::Statistics stats = streaming.GetStatistics();
+        overBudget += stats.residentBytes + stats.loadingBytes > config.residentBudget ? 1 : 0;
+    }
+    CHECK(overBudget == 0);
+    CHECK(target.created == std::vector<uint32_t>({ 0, 1, 2 }));
+    CHECK(target.destroyed.empty());
+    CHECK(streaming.GetStatistics().budgetStalls > 0);
+
+    // Last requested at different frames: 1, then 0, then 2
+    RunFrame(streaming, io, { all[1] });
+    RunFrame(streaming, io, { all[0] });
+    RunFrame(streaming, io, { all[2] });
+
+    // Meshes 0 and 2 are still inside their grace period, mesh 3 replaces 1
+    RunFrame(streaming, io, { all[2], all[3] });
+    RunFrame(streaming, io, { all[2], all[3] });
+    CHECK(target.destroyed == std::vector<uint32_t>({ 1 }));
+    CHECK(IsResident(streaming, handles[3]));
+
+    RunFrame(streaming, io, { all[2], all[3], all[4] });
+    RunFrame(streaming, io, { all[2], all[3], all[4] });
+    CHECK(target.destroyed == std::vector<uint32_t>({ 1, 0 }));
+    CHECK(IsResident(streaming, handles[2]));
+    CHECK(IsResident(streaming, handles[4]));
+
+    // With all three resident meshes wanted, a fourth waits
+    RunFrame(streaming, io, { all[2], all[3], all[4], all[5] });
+    RunFrame(streaming, io, { all[2], all[3], all[4], all[5] });
+    CHECK(!IsResident(streaming, handles[5]));
+    CHECK(target.destroyed.size() == 2);
+
+    const StreamingManager::Statistics stats = streaming.GetStatistics();
+    CHECK(stats.evictions == 2);
+    CHECK(stats.evictedBytes == 2 * meshBytes);
+    CHECK(stats.peakBytes <= config.residentBudget);
+    CHECK(stats.residentBytes == target.liveBytes);
+    CHECK(target.errors == 0);
+
+    // A lowered budget evicts without new requests once the grace runs out
+    config.residentBudget = meshBytes;
+    streaming.SetConfig(config);
+    for (uint32_t frame = 0; frame < 4; ++frame) {
+        RunFrame(streaming, io, {});
+    }
+    CHECK(streaming.GetStatistics().residentBytes <= meshBytes);
+    CHECK(target.liveBytes == streaming.GetStatistics().residentBytes);
+}
+
+void TestOversize(const std::string& path, FileIOService& io) {
+    RecordingTarget target;
+    StreamingManager streaming(&target, &io);
+    std::vector<StreamedMeshHandle> handles;
+    CHECK(streaming.AddCookedMeshFile(path, &handles));
+
+    StreamingManager::Config config;
+    config.residentBudget = streaming.GetMeshBytes(handles[BIG_MESH]) - 1;
+    streaming.SetConfig(config);
+
+    // The big mesh ranks first but can never fit; the small one behind it
+    // still loads
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        RunFrame(streaming, io, { { handles[BIG_MESH], 1.0f }, { handles[0], 0.1f } });
+    }
+    CHECK(streaming.GetMeshState(handles[BIG_MESH]) == StreamingManager::MeshState::Unloaded);
+    CHECK(IsResident(streaming, handles[0]));
+    CHECK(streaming.GetStatistics().oversizeRejections == 3);
+    CHECK(streaming.GetStatistics().loadsIssued == 1);
+    CHECK(target.created == std::vector<uint32_t>({ 0 }));
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("streaming_manager_test");
+    const std::string path = directory.File("meshes.de3mesh");
+    CHECK(WriteMeshes(path));
+
+    FileIOService io(2);
+    TestPriorityOrder(path, io);
+    TestBudgetAndEviction(path, io);
+    TestOversize(path, io);
+    return FinishTests("StreamingManagerTest");
+}
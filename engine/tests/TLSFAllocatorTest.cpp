@@ -0,0 +1,201 @@
+// =============================================================================
+// TLSF Allocator Test
+// =============================================================================
+//
+// Randomized allocate/free stress against a shadow map of live ranges, with
+// power-of-two and vertex-stride alignments, deferred frees and AllocateAt.
+//
+//   TLSFAllocatorTest [operations]
+
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/TLSFAllocator.h"
+
+namespace {
+
+// Live allocations by offset, value is the size in whole alignment units
+using RangeMap = std::map<uint32_t, size_t>;
+
+size_t RoundUp(size_t size, size_t alignment) {
+    return std::max<size_t>((size + alignment - 1) / alignment, 1) * alignment;
+}
+
+bool OverlapsLive(const RangeMap& live, uint32_t offset, size_t size) {
+    auto next = live.lower_bound(offset);
+    if (next != live.end() && next->first < offset + size) {
+        return true;
+    }
+    if (next != live.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second > offset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Used blocks reported by the allocator are exactly the live ranges
+bool BlocksMatch(const TLSFAllocator& allocator, const RangeMap& live) {
+    std::vector<TLSFAllocator::Block> blocks;
+    allocator.GetBlocks(blocks);
+
+    uint32_t expectedOffset = 0;
+    size_t usedBlocks = 0;
+    for (const TLSFAllocator::Block& block : blocks) {
+        if (block.offset != expectedOffset) {
+            return false;
+        }
+        expectedOffset += block.size;
+        if (block.used) {
+            auto it = live.find(block.offset);
+            if (it == live.end() || it->second != block.size) {
+                return false;
+            }
+            usedBlocks++;
+        }
+    }
+    return usedBlocks == live.size();
+}
+
+void TestRandomStress(size_t alignment, uint32_t operations, uint32_t seed) {
+    const size_t capacity = 64ull * 1024 * 1024;
+    TLSFAllocator allocator(capacity, alignment);
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    std::vector<uint32_t> liveOffsets;
+    RangeMap live;
+    size_t liveBytes = 0;
+
+    uint32_t overlaps = 0;
+    uint32_t misaligned = 0;
+    uint32_t canAllocateMismatches = 0;
+    uint32_t failures = 0;
+    for (uint32_t op = 0; op < operations; ++op) {
+        // Sizes skewed towards small meshes with the odd large one
+        const bool allocate = live.empty() || percent(random) < 55;
+        if (allocate) {
+            const size_t size = percent(random) < 5 ? 256 * 1024 + random() % (2 * 1024 * 1024) : 1 + random() % 16384;
+            const bool expected = allocator.CanAllocate(size);
+            const uint32_t offset = allocator.Allocate(size);
+            if ((offset != UINT32_MAX) != expected) {
+                canAllocateMismatches++;
+            }
+            if (offset == UINT32_MAX) {
+                failures++;
+                continue;
+            }
+
+            const size_t rounded = RoundUp(size, alignment);
+            misaligned += offset % alignment != 0 ? 1 : 0;
+            if (offset + rounded > capacity || OverlapsLive(live, offset, rounded)) {
+                overlaps++;
+            }
+            live[offset] = rounded;
+            liveOffsets.push_back(offset);
+            liveBytes += rounded;
+        } else {
+            const size_t index = random() % liveOffsets.size();
+            const uint32_t offset = liveOffsets[index];
+            liveOffsets[index] = liveOffsets.back();
+            liveOffsets.pop_back();
+
+            allocator.Free(offset);
+            liveBytes -= live[offset];
+            live.erase(offset);
+        }
+
+        if (op % 4096 == 0) {
+            CHECK(allocator.Validate());
+            CHECK(BlocksMatch(allocator, live));
+        }
+    }
+
+    CHECK(overlaps == 0);
+    CHECK(misaligned == 0);
+    CHECK(canAllocateMismatches == 0);
+    CHECK(allocator.GetUsedSpace() == liveBytes);
+    CHECK(allocator.GetAllocationCount() == live.size());
+    CHECK(allocator.Validate());
+    CHECK(BlocksMatch(allocator, live));
+    printf("  alignment %zu: %u operations, %zu live, %u failed allocations, %u free blocks\n", alignment,
+           operations, live.size(), failures, allocator.GetFreeBlockCount());
+
+    // Everything coalesces back into one block
+    for (uint32_t offset : liveOffsets) {
+        allocator.Free(offset);
+    }
+    CHECK(allocator.GetUsedSpace() == 0);
+    CHECK(allocator.GetFreeBlockCount() == 1);
+    CHECK(allocator.GetLargestFreeBlock() == capacity / alignment * alignment);
+    CHECK(allocator.Validate());
+}
+
+void TestDeferredFree() {
+    TLSFAllocator allocator(1024 * 256, 256);
+    const uint32_t a = allocator.Allocate(1000);
+    const uint32_t b = allocator.Allocate(1000);
+    CHECK(a != UINT32_MAX && b != UINT32_MAX);
+
+    allocator.FreeDeferred(a, 5);
+    allocator.FreeDeferred(b, 3);   // Queued behind a, waits for it
+    CHECK(allocator.GetPendingFreeCount() == 2);
+
+    allocator.ReclaimCompleted(4);
+    CHECK(allocator.GetPendingFreeCount() == 2);
+    CHECK(allocator.GetAllocationCount() == 2);
+
+    allocator.ReclaimCompleted(5);
+    CHECK(allocator.GetPendingFreeCount() == 0);
+    CHECK(allocator.GetAllocationCount() == 0);
+    CHECK(allocator.GetUsedSpace() == 0);
+    CHECK(allocator.Validate());
+}
+
+void TestAllocateAt() {
+    TLSFAllocator allocator(1024 * 20, 20);
+    CHECK(allocator.AllocateAt(200, 400));
+    CHECK(!allocator.AllocateAt(400, 20));      // Inside the first
+    CHECK(!allocator.AllocateAt(190, 40));      // Straddles its start
+    CHECK(allocator.AllocateAt(600, 20));       // Right behind it
+
+    const uint32_t offset = allocator.Allocate(200);
+    CHECK(offset != UINT32_MAX && (offset + 200 <= 200 || offset >= 620));
+    CHECK(allocator.Validate());
+
+    allocator.Free(200);
+    allocator.Free(600);
+    allocator.Free(offset);
+    CHECK(allocator.GetFreeBlockCount() == 1);
+}
+
+void TestExhaustion() {
+    TLSFAllocator allocator(256 * 64, 256);
+    std::vector<uint32_t> offsets;
+    for (uint32_t offset = allocator.Allocate(256); offset != UINT32_MAX; offset = allocator.Allocate(256)) {
+        offsets.push_back(offset);
+    }
+    CHECK(offsets.size() == 64);
+    CHECK(allocator.GetAvailableSpace() == 0);
+    CHECK(!allocator.CanAllocate(1));
+
+    allocator.Free(offsets[10]);
+    CHECK(allocator.Allocate(256) == offsets[10]);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t operations = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 200000;
+
+    TestRandomStress(256, operations, 31);
+    TestRandomStress(20, operations, 32);       // Vertex stride, not a power of two
+    TestRandomStress(4, operations / 4, 33);
+    TestDeferredFree();
+    TestAllocateAt();
+    TestExhaustion();
+    return FinishTests("TLSFAllocatorTest");
+}
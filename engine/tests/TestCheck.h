@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdio>
+
+// =============================================================================
+// Test Checks
+// =============================================================================
+//
+// Minimal assertions for the standalone test executables in tests/. A failed
+// CHECK prints where it failed and the test keeps going; main returns
+// FinishTests() so ctest sees the failure.
+
+inline int& GetTestFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            GetTestFailureCount()++;                                            \
+        }                                                                       \
+    } while (0)
+
+inline int FinishTests(const char* name) {
+    const int failures = GetTestFailureCount();
+    if (failures > 0) {
+        printf("%s: %d checks failed\n", name, failures);
+        return 1;
+    }
+    printf("%s: all checks passed\n", name);
+    return 0;
+}
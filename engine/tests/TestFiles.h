@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// Test Files
+// =============================================================================
+//
+// Scratch directories for the tests that write files. Each test gets its own
+// directory under the system temp path, emptied on creation and removed on
+// destruction, so a crashed run never leaks state into the next one.
+
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : m_path(std::filesystem::temp_directory_path() / ("de3_" + name))
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_path, error);
+        std::filesystem::create_directories(m_path, error);
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(m_path, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    const std::filesystem::path& GetPath() const { return m_path; }
+    std::string File(const std::string& relative) const { return (m_path / relative).string(); }
+
+private:
+    std::filesystem::path m_path;
+};
+
+// Creates parent directories as needed
+inline bool WriteTestFile(const std::string& path, const void* data, size_t size) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
+
+inline bool WriteTestFile(const std::string& path, const std::string& text) {
+    return WriteTestFile(path, text.data(), text.size());
+}
+
+inline bool WriteTestFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    return WriteTestFile(path, bytes.data(), bytes.size());
+}
+
+inline std::vector<uint8_t> ReadTestFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "resources/RenderTypes.h"
+
+// =============================================================================
+// Test Meshes
+// =============================================================================
+//
+// Closed procedural meshes for the geometry tests, wound with clockwise front
+// faces like everything the engine draws. The torus and the bumpy sphere are
+// concave, so overdraw and cone culling have something to get wrong.
+
+struct TestMesh {
+    std::vector<VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+};
+
+inline glm::vec3 Position(const VertexAttributes& vertex) {
+    return glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]);
+}
+
+// Clockwise front faces, as MeshletBuilder's TriangleNormal. Not normalized,
+// the length is twice the area.
+inline glm::vec3 TriangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    return glm::cross(c - a, b - a);
+}
+
+// Wrapped (u, v) grid; surface(u, v, outPosition) returns the outward direction
+// each quad's triangles are wound against
+template <typename Surface>
+TestMesh MakeGridMesh(uint32_t uSegments, uint32_t vSegments, Surface surface) {
+    TestMesh mesh;
+    std::vector<glm::vec3> outward;
+    for (uint32_t j = 0; j < vSegments; ++j) {
+        for (uint32_t i = 0; i < uSegments; ++i) {
+            glm::vec3 p;
+            outward.push_back(surface(static_cast<float>(i) / uSegments, static_cast<float>(j) / vSegments, p));
+            VertexAttributes vertex = {};
+            vertex.position[0] = p.x;
+            vertex.position[1] = p.y;
+            vertex.position[2] = p.z;
+            mesh.vertices.push_back(vertex);
+        }
+    }
+
+    auto addTriangle = [&mesh, &outward](uint32_t a, uint32_t b, uint32_t c) {
+        const glm::vec3 n = TriangleNormal(Position(mesh.vertices[a]), Position(mesh.vertices[b]),
+                                           Position(mesh.vertices[c]));
+        if (glm::dot(n, outward[a]) < 0.0f) {
+            std::swap(b, c);
+        }
+        mesh.indices.insert(mesh.indices.end(), { a, b, c });
+    };
+    for (uint32_t j = 0; j < vSegments; ++j) {
+        for (uint32_t i = 0; i < uSegments; ++i) {
+            const uint32_t i1 = (i + 1) % uSegments;
+            const uint32_t j1 = (j + 1) % vSegments;
+            addTriangle(j * uSegments + i, j * uSegments + i1, j1 * uSegments + i);
+            addTriangle(j * uSegments + i1, j1 * uSegments + i1, j1 * uSegments + i);
+        }
+    }
+    return mesh;
+}
+
+// Ring radius 1, tube radius 0.4, around Z
+inline TestMesh MakeTorus() {
+    const float twoPi = 6.2831853f;
+    return MakeGridMesh(96, 48, [twoPi](float u, float v, glm::vec3& p) {
+        const glm::vec3 ring(std::cos(u * twoPi), std::sin(u * twoPi), 0.0f);
+        const glm::vec3 out(ring.x * std::cos(v * twoPi), ring.y * std::cos(v * twoPi), std::sin(v * twoPi));
+        p = ring + 0.4f * out;
+        return out;
+    });
+}
+
+// Unit sphere with deep bumps, inside a radius of 1.3. The poles are pinched
+// shut by the wrapped grid, which leaves a few degenerate triangles.
+inline TestMesh MakeBumpySphere() {
+    const float pi = 3.14159265f;
+    return MakeGridMesh(80, 80, [pi](float u, float v, glm::vec3& p) {
+        const float theta = u * 2.0f * pi;
+        const float phi = (0.02f + 0.96f * v) * pi;
+        const glm::vec3 out(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+        p = out * (1.0f + 0.3f * std::sin(5.0f * theta) * std::sin(6.0f * phi));
+        return out;
+    });
+}
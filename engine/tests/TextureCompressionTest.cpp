@@ -0,0 +1,338 @@
+// =============================================================================
+// Texture Compression Test
+// =============================================================================
+//
+// Encodes constant, gradient, two-color and noisy blocks in every BC format.
+// Blocks are read back with reference decoders written from the format
+// specs, not with the module's own, so a layout or mode bit the encoder gets
+// wrong shows up. The module's decoders have to agree with the references,
+// and the error against the source must stay within what each format can do.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "TestCheck.h"
+#include "resources/TextureCompression.h"
+
+namespace {
+
+// =============================================================================
+// Reference Decoders
+// =============================================================================
+
+// Bits in little-endian order, as every BC format stores them
+uint32_t ReadBits(const uint8_t* block, uint32_t& position, uint32_t count) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; ++i, ++position) {
+        value |= ((block[position / 8] >> (position % 8)) & 1u) << i;
+    }
+    return value;
+}
+
+void ReferenceBC1(const uint8_t* block, uint8_t* pixels) {
+    const uint32_t color0 = block[0] | (block[1] << 8);
+    const uint32_t color1 = block[2] | (block[3] << 8);
+    int palette[4][4];
+    for (int e = 0; e < 2; ++e) {
+        const uint32_t color = e == 0 ? color0 : color1;
+        const int r = (color >> 11) & 31;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        palette[e][0] = (r << 3) | (r >> 2);
+        palette[e][1] = (g << 2) | (g >> 4);
+        palette[e][2] = (b << 3) | (b >> 2);
+        palette[e][3] = 255;
+    }
+    for (int c = 0; c < 3; ++c) {
+        if (color0 > color1) {
+            palette[2][c] = static_cast<int>(std::lround((2.0 * palette[0][c] + palette[1][c]) / 3.0));
+            palette[3][c] = static_cast<int>(std::lround((palette[0][c] + 2.0 * palette[1][c]) / 3.0));
+        } else {
+            palette[2][c] = static_cast<int>(std::lround((palette[0][c] + palette[1][c]) / 2.0));
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = color0 > color1 ? 255 : 0;
+
+    uint32_t position = 32;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const uint32_t index = ReadBits(block, position, 2);
+        for (int c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+        }
+    }
+}
+
+void ReferenceBC4(const uint8_t* block, uint32_t channel, uint8_t* pixels) {
+    const int value0 = block[0];
+    const int value1 = block[1];
+    int palette[8] = { value0, value1 };
+    if (value0 > value1) {
+        for (int i = 2; i < 8; ++i) {
+            palette[i] = static_cast<int>(std::lround(((8 - i) * value0 + (i - 1) * value1) / 7.0));
+        }
+    } else {
+        for (int i = 2; i < 6; ++i) {
+            palette[i] = static_cast<int>(std::lround(((6 - i) * value0 + (i - 1) * value1) / 5.0));
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint32_t position = 16;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        pixels[i * 4 + channel] = static_cast<uint8_t>(palette[ReadBits(block, position, 3)]);
+    }
+}
+
+// Mode 6 as the BC7 spec lays it out; false for any other mode
+bool ReferenceBC7(const uint8_t* block, uint8_t* pixels) {
+    uint32_t position = 0;
+    uint32_t mode = 0;
+    while (mode < 8 && ReadBits(block, position, 1) == 0) {
+        mode++;
+    }
+    if (mode != 6) {
+        return false;
+    }
+
+    int endpoints[2][4];
+    for (int c = 0; c < 4; ++c) {
+        endpoints[0][c] = static_cast<int>(ReadBits(block, position, 7));
+        endpoints[1][c] = static_cast<int>(ReadBits(block, position, 7));
+    }
+    for (int e = 0; e < 2; ++e) {
+        const int pBit = static_cast<int>(ReadBits(block, position, 1));
+        for (int c = 0; c < 4; ++c) {
+            endpoints[e][c] = (endpoints[e][c] << 1) | pBit;
+        }
+    }
+
+    static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const uint32_t index = ReadBits(block, position, i == 0 ? 3 : 4);     // Anchor drops its top bit
+        for (int c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(
+                ((64 - weights[index]) * endpoints[0][c] + weights[index] * endpoints[1][c] + 32) >> 6);
+        }
+    }
+    return position == 128;
+}
+
+// =============================================================================
+// Test Blocks
+// =============================================================================
+
+enum class BlockKind {
+    Constant,
+    Gradient,
+    TwoColor,
+    Noise
+};
+
+const char* GetBlockKindName(BlockKind kind) {
+    switch (kind) {
+    case BlockKind::Constant: return "constant";
+    case BlockKind::Gradient: return "gradient";
+    case BlockKind::TwoColor: return "two-color";
+    default: return "noise";
+    }
+}
+
+void MakeBlock(BlockKind kind, std::mt19937& random, uint8_t* pixels) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    int start[4], end[4];
+    for (int c = 0; c < 4; ++c) {
+        start[c] = byte(random);
+        end[c] = byte(random);
+    }
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const float t = ((i % 4) + (i / 4)) / 6.0f;    // Diagonal ramp
+        const bool second = ((i * 7 + 3) % 5) < 2;
+        for (int c = 0; c < 4; ++c) {
+            int value = start[c];
+            switch (kind) {
+            case BlockKind::Gradient: value = static_cast<int>(std::lround(start[c] + (end[c] - start[c]) * t)); break;
+            case BlockKind::TwoColor: value = second ? end[c] : start[c]; break;
+            case BlockKind::Noise: value = byte(random); break;
+            default: break;
+            }
+            pixels[i * 4 + c] = static_cast<uint8_t>(value);
+        }
+    }
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+struct ErrorStats {
+    double squaredError = 0.0;
+    uint64_t samples = 0;
+    int worstDifference = 0;        // Module decoder against the reference
+
+    double GetRMSE() const { return samples > 0 ? std::sqrt(squaredError / samples) : 0.0; }
+};
+
+void Accumulate(ErrorStats& stats, const uint8_t* source, const uint8_t* reference, const uint8_t* decoded,
+                uint32_t channelMask) {
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            if (channelMask & (1u << c)) {
+                const int error = static_cast<int>(reference[i * 4 + c]) - source[i * 4 + c];
+                stats.squaredError += error * error;
+                stats.samples++;
+                stats.worstDifference = std::max(stats.worstDifference,
+                                                 std::abs(static_cast<int>(decoded[i * 4 + c]) - reference[i * 4 + c]));
+            }
+        }
+    }
+}
+
+// RMSE bounds per kind: constant, gradient, two-color, noise. A quarter
+// above what the encoders reach today.
+struct FormatBounds {
+    const char* name;
+    double rmse[4];
+};
+
+void TestFormats() {
+    const FormatBounds bounds[] = {
+        { "BC1", { 2.5, 10.5, 2.5, 65.0 } },
+        { "BC3", { 2.25, 9.5, 2.25, 57.0 } },
+        { "BC4", { 0.0, 6.0, 0.0, 11.0 } },
+        { "BC5", { 0.0, 6.0, 0.0, 11.0 } },
+        { "BC7", { 0.75, 2.1, 0.75, 68.0 } },
+    };
+
+    std::mt19937 random(50);
+    for (BlockKind kind : { BlockKind::Constant, BlockKind::Gradient, BlockKind::TwoColor, BlockKind::Noise }) {
+        ErrorStats stats[5];
+        uint32_t badAlpha = 0;
+        uint32_t badMode = 0;
+        for (uint32_t b = 0; b < 2000; ++b) {
+            uint8_t source[64];
+            MakeBlock(kind, random, source);
+
+            uint8_t block[16];
+            uint8_t reference[64];
+            uint8_t decoded[64];
+
+            // BC1 ignores alpha and always encodes four colors, so alpha reads back opaque
+            EncodeBC1Block(source, block);
+            ReferenceBC1(block, reference);
+            DecodeBC1Block(block, decoded);
+            Accumulate(stats[0], source, reference, decoded, 0x7);
+            for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+                badAlpha += reference[i * 4 + 3] != 255 || decoded[i * 4 + 3] != 255 ? 1 : 0;
+            }
+
+            // BC3 is a BC4 alpha block in front of a BC1 color block
+            EncodeBC3Block(source, block);
+            ReferenceBC4(block, 3, reference);
+            uint8_t color[64];
+            ReferenceBC1(block + 8, color);
+            for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+                memcpy(&reference[i * 4], &color[i * 4], 3);
+            }
+            DecodeBC3Block(block, decoded);
+            Accumulate(stats[1], source, reference, decoded, 0xF);
+
+            for (uint32_t channel = 0; channel < 4; ++channel) {
+                EncodeBC4Block(source, channel, block);
+                memset(reference, 0, sizeof(reference));
+                memset(decoded, 0, sizeof(decoded));
+                ReferenceBC4(block, channel, reference);
+                DecodeBC4Block(block, channel, decoded);
+                Accumulate(stats[2], source, reference, decoded, 1u << channel);
+            }
+
+            EncodeBC5Block(source, block);
+            memset(reference, 0, sizeof(reference));
+            ReferenceBC4(block, 0, reference);
+            ReferenceBC4(block + 8, 1, reference);
+            DecodeBC5Block(block, decoded);
+            Accumulate(stats[3], source, reference, decoded, 0x3);
+            for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+                badAlpha += decoded[i * 4 + 2] != 0 || decoded[i * 4 + 3] != 255 ? 1 : 0;
+            }
+
+            EncodeBC7Block(source, block);
+            badMode += ReferenceBC7(block, reference) ? 0 : 1;
+            badMode += DecodeBC7Block(block, decoded) ? 0 : 1;
+            Accumulate(stats[4], source, reference, decoded, 0xF);
+        }
+
+        const size_t k = static_cast<size_t>(kind);
+        printf("  %-9s", GetBlockKindName(kind));
+        for (size_t f = 0; f < 5; ++f) {
+            CHECK(stats[f].GetRMSE() <= bounds[f].rmse[k]);
+            // The module's BC1 thirds truncate where the reference rounds
+            CHECK(stats[f].worstDifference <= (f <= 1 ? 1 : 0));
+            printf(" %s %.2f", bounds[f].name, stats[f].GetRMSE());
+        }
+        printf("\n");
+        CHECK(badAlpha == 0);
+        CHECK(badMode == 0);
+    }
+}
+
+void TestExactBlocks() {
+    // Colors 565 holds exactly come back exactly from BC1, and BC4 keeps
+    // two-value blocks exactly
+    uint8_t source[64];
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        const bool second = i % 3 == 0;
+        source[i * 4 + 0] = second ? 255 : 0;
+        source[i * 4 + 1] = second ? 130 : 65;
+        source[i * 4 + 2] = second ? 66 : 189;
+        source[i * 4 + 3] = second ? 7 : 250;
+    }
+    uint8_t block[16];
+    uint8_t decoded[64];
+    EncodeBC1Block(source, block);
+    ReferenceBC1(block, decoded);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS * 4; ++i) {
+        mismatches += i % 4 != 3 && decoded[i] != source[i] ? 1 : 0;
+    }
+    CHECK(mismatches == 0);
+
+    EncodeBC4Block(source, 3, block);
+    ReferenceBC4(block, 3, decoded);
+    mismatches = 0;
+    for (uint32_t i = 0; i < TEXTURE_BLOCK_PIXELS; ++i) {
+        mismatches += decoded[i * 4 + 3] != source[i * 4 + 3] ? 1 : 0;
+    }
+    CHECK(mismatches == 0);
+
+    // Encoding doesn't depend on anything but the pixels
+    uint8_t again[16];
+    EncodeBC7Block(source, block);
+    EncodeBC7Block(source, again);
+    CHECK(memcmp(block, again, 16) == 0);
+}
+
+void TestOtherBC7Modes() {
+    // Mode 6 is all the decoder reads; every other mode is refused
+    uint8_t pixels[64];
+    for (uint32_t mode = 0; mode < 8; ++mode) {
+        uint8_t block[16] = {};
+        block[0] = static_cast<uint8_t>(1u << mode);
+        CHECK(DecodeBC7Block(block, pixels) == (mode == 6));
+    }
+    const uint8_t reserved[16] = {};
+    CHECK(!DecodeBC7Block(reserved, pixels));
+}
+
+} // namespace
+
+int main() {
+    TestFormats();
+    TestExactBlocks();
+    TestOtherBC7Modes();
+    return FinishTests("TextureCompressionTest");
+}
@@ -0,0 +1,246 @@
+// =============================================================================
+// Upload Batch Planner Test
+// =============================================================================
+//
+// CoalesceBufferCopies sorts by destination and offset and merges only copies
+// contiguous in both destination and source; gaps, overlaps and a different
+// source stay separate, and a random batch writes the same bytes before and
+// after merging. BufferStateTracker skips transitions into the current state
+// and for unregistered buffers, and PlanCopyBatch queues one transition per
+// destination however many copies it holds.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/UploadBatchPlanner.h"
+
+namespace {
+
+// D3D12_RESOURCE_STATE_* values
+constexpr uint32_t STATE_COMMON = 0;
+constexpr uint32_t STATE_COPY_DEST = 0x400;
+constexpr uint32_t STATE_COPY_SOURCE = 0x800;
+
+// Resources are only compared, any distinct addresses do
+char g_resourceSlots[8];
+
+ID3D12Resource* Resource(int index) {
+    return reinterpret_cast<ID3D12Resource*>(&g_resourceSlots[index]);
+}
+
+bool SameCopy(const BufferCopy& copy, ID3D12Resource* dst, uint64_t dstOffset, ID3D12Resource* src,
+              uint64_t srcOffset, uint64_t size) {
+    return copy.dst == dst && copy.dstOffset == dstOffset && copy.src == src && copy.srcOffset == srcOffset &&
+           copy.size == size;
+}
+
+void TestCoalesceCases() {
+    ID3D12Resource* vertices = Resource(0);
+    ID3D12Resource* indices = Resource(1);
+    ID3D12Resource* upload = Resource(2);
+    ID3D12Resource* otherUpload = Resource(3);
+
+    // Contiguous in both, queued out of order: one copy
+    std::vector<BufferCopy> copies = {
+        { vertices, 200, upload, 1200, 100 },
+        { vertices, 0, upload, 1000, 100 },
+        { vertices, 100, upload, 1100, 100 },
+    };
+    CHECK(CoalesceBufferCopies(copies) == 1);
+    CHECK(SameCopy(copies[0], vertices, 0, upload, 1000, 300));
+
+    // Destination contiguous, source not
+    copies = { { vertices, 0, upload, 0, 64 }, { vertices, 64, upload, 128, 64 } };
+    CHECK(CoalesceBufferCopies(copies) == 2);
+
+    // Source contiguous, destination gap
+    copies = { { vertices, 0, upload, 0, 64 }, { vertices, 96, upload, 64, 64 } };
+    CHECK(CoalesceBufferCopies(copies) == 2);
+
+    // Overlapping destination
+    copies = { { vertices, 0, upload, 0, 64 }, { vertices, 32, upload, 64, 64 } };
+    CHECK(CoalesceBufferCopies(copies) == 2);
+
+    // Same offsets, different source or destination buffer
+    copies = { { vertices, 0, upload, 0, 64 }, { vertices, 64, otherUpload, 64, 64 } };
+    CHECK(CoalesceBufferCopies(copies) == 2);
+    copies = { { vertices, 0, upload, 0, 64 }, { indices, 64, upload, 64, 64 } };
+    CHECK(CoalesceBufferCopies(copies) == 2);
+
+    // Sorted by destination, then offset
+    copies = {
+        { indices, 512, upload, 0, 16 },
+        { vertices, 256, upload, 100, 16 },
+        { indices, 0, upload, 50, 16 },
+        { vertices, 0, upload, 300, 16 },
+    };
+    CHECK(CoalesceBufferCopies(copies) == 4);
+    bool sorted = true;
+    for (size_t i = 1; i < copies.size(); ++i) {
+        const BufferCopy& a = copies[i - 1];
+        const BufferCopy& b = copies[i];
+        sorted &= a.dst != b.dst ? std::less<ID3D12Resource*>()(a.dst, b.dst) : a.dstOffset < b.dstOffset;
+    }
+    CHECK(sorted);
+
+    std::vector<BufferCopy> empty;
+    CHECK(CoalesceBufferCopies(empty) == 0);
+}
+
+// Replays copies into byte arrays, one per resource slot
+void Apply(const std::vector<BufferCopy>& copies, std::vector<std::vector<uint8_t>>& memory) {
+    for (const BufferCopy& copy : copies) {
+        const size_t dst = reinterpret_cast<const char*>(copy.dst) - g_resourceSlots;
+        const size_t src = reinterpret_cast<const char*>(copy.src) - g_resourceSlots;
+        std::copy_n(memory[src].begin() + copy.srcOffset, copy.size, memory[dst].begin() + copy.dstOffset);
+    }
+}
+
+void TestCoalesceRandom() {
+    std::mt19937 random(35);
+    uint64_t queued = 0;
+    uint64_t recorded = 0;
+    uint32_t mismatches = 0;
+
+    for (uint32_t batch = 0; batch < 200; ++batch) {
+        // Two destinations cut into non-overlapping ranges, filled from two
+        // upload buffers; runs of ranges are often packed back to back
+        std::vector<BufferCopy> copies;
+        for (int dst = 0; dst < 2; ++dst) {
+            uint64_t dstOffset = 0;
+            uint64_t srcOffset = random() % 64;
+            ID3D12Resource* src = Resource(2 + static_cast<int>(random() % 2));
+            while (true) {
+                const uint64_t size = 1 + random() % 48;
+                if (dstOffset + size > 1024 || srcOffset + size > 4096) {
+                    break;
+                }
+                copies.push_back({ Resource(dst), dstOffset, src, srcOffset, size });
+                dstOffset += size + (random() % 3 == 0 ? random() % 16 : 0);
+                srcOffset += size + (random() % 3 == 0 ? random() % 16 : 0);
+                if (random() % 8 == 0) {
+                    src = Resource(2 + static_cast<int>(random() % 2));
+                }
+            }
+        }
+        std::shuffle(copies.begin(), copies.end(), random);
+
+        std::vector<std::vector<uint8_t>> expected(4);
+        for (int slot = 0; slot < 4; ++slot) {
+            expected[slot].resize(slot < 2 ? 1024 : 4096);
+            for (uint8_t& value : expected[slot]) {
+                value = static_cast<uint8_t>(random());
+            }
+        }
+        std::vector<std::vector<uint8_t>> actual = expected;
+
+        Apply(copies, expected);
+        queued += copies.size();
+        recorded += CoalesceBufferCopies(copies);
+        Apply(copies, actual);
+        mismatches += expected == actual ? 0 : 1;
+    }
+
+    CHECK(mismatches == 0);
+    CHECK(recorded * 3 < queued * 2);
+    printf("  %llu queued copies recorded as %llu\n", static_cast<unsigned long long>(queued),
+           static_cast<unsigned long long>(recorded));
+}
+
+void TestStateTracking() {
+    ID3D12Resource* vertices = Resource(0);
+    ID3D12Resource* indices = Resource(1);
+    ID3D12Resource* upload = Resource(2);
+
+    BufferStateTracker tracker;
+    tracker.RegisterBuffer(vertices, STATE_COMMON);
+    tracker.RegisterBuffer(indices, STATE_COMMON);
+    tracker.RegisterBuffer(nullptr, STATE_COMMON);
+    CHECK(tracker.IsRegistered(vertices));
+    CHECK(!tracker.IsRegistered(upload));
+    CHECK(!tracker.IsRegistered(nullptr));
+
+    // Already there, or not tracked: nothing
+    tracker.Transition(vertices, STATE_COMMON);
+    tracker.Transition(upload, STATE_COPY_SOURCE);
+    CHECK(tracker.GetPendingTransitions().empty());
+    CHECK(tracker.GetTrackedState(upload) == STATE_COMMON);
+
+    // From the tracked state, once
+    tracker.Transition(vertices, STATE_COPY_SOURCE);
+    tracker.Transition(vertices, STATE_COPY_SOURCE);
+    tracker.Transition(indices, STATE_COPY_DEST);
+    const std::vector<BufferTransition>& pending = tracker.GetPendingTransitions();
+    CHECK(pending.size() == 2);
+    if (pending.size() == 2) {
+        CHECK(pending[0].resource == vertices && pending[0].before == STATE_COMMON && pending[0].after == STATE_COPY_SOURCE);
+        CHECK(pending[1].resource == indices && pending[1].before == STATE_COMMON && pending[1].after == STATE_COPY_DEST);
+    }
+    CHECK(tracker.GetTrackedState(vertices) == STATE_COPY_SOURCE);
+    tracker.ClearPendingTransitions();
+
+    // The next transition starts where the last one ended
+    tracker.Transition(vertices, STATE_COPY_DEST);
+    CHECK(tracker.GetPendingTransitions().size() == 1);
+    if (tracker.GetPendingTransitions().size() == 1) {
+        CHECK(tracker.GetPendingTransitions()[0].before == STATE_COPY_SOURCE);
+    }
+    tracker.ClearPendingTransitions();
+
+    // Back to rest: one per moved buffer, none for one already resting
+    tracker.Transition(indices, STATE_COMMON);
+    tracker.ClearPendingTransitions();
+    tracker.TransitionToResting();
+    CHECK(tracker.GetPendingTransitions().size() == 1);
+    CHECK(tracker.GetTrackedState(vertices) == STATE_COMMON);
+    CHECK(tracker.GetTrackedState(indices) == STATE_COMMON);
+
+    tracker.Clear();
+    CHECK(!tracker.IsRegistered(vertices));
+    CHECK(tracker.GetPendingTransitions().empty());
+}
+
+void TestPlanCopyBatch() {
+    ID3D12Resource* vertices = Resource(0);
+    ID3D12Resource* indices = Resource(1);
+    ID3D12Resource* upload = Resource(2);
+
+    BufferStateTracker tracker;
+    tracker.RegisterBuffer(vertices, STATE_COMMON);
+    tracker.RegisterBuffer(indices, STATE_COMMON);
+
+    // 40 meshes staged back to back: the vertex copies merge into one, the
+    // index copies are staggered by 8 bytes and stay apart
+    std::vector<BufferCopy> copies;
+    for (uint64_t mesh = 0; mesh < 40; ++mesh) {
+        copies.push_back({ vertices, mesh * 1000, upload, mesh * 1000, 1000 });
+        copies.push_back({ indices, mesh * 600 + (mesh % 2) * 8, upload, 40000 + mesh * 600, 600 });
+    }
+    const size_t recorded = PlanCopyBatch(copies, tracker, STATE_COPY_DEST);
+    CHECK(recorded == copies.size());
+    CHECK(recorded == 1 + 40);
+    CHECK(tracker.GetPendingTransitions().size() == 2);
+    CHECK(tracker.GetTrackedState(vertices) == STATE_COPY_DEST);
+    CHECK(tracker.GetTrackedState(indices) == STATE_COPY_DEST);
+    tracker.ClearPendingTransitions();
+
+    // A second flush in the same frame finds the buffers in COPY_DEST
+    copies = { { vertices, 40000, upload, 200000, 64 } };
+    PlanCopyBatch(copies, tracker, STATE_COPY_DEST);
+    CHECK(tracker.GetPendingTransitions().empty());
+
+    tracker.TransitionToResting();
+    CHECK(tracker.GetPendingTransitions().size() == 2);
+}
+
+} // namespace
+
+int main() {
+    TestCoalesceCases();
+    TestCoalesceRandom();
+    TestStateTracking();
+    TestPlanCopyBatch();
+    return FinishTests("UploadBatchPlannerTest");
+}
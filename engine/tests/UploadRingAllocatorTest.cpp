@@ -0,0 +1,168 @@
+// =============================================================================
+// Upload Ring Allocator Test
+// =============================================================================
+//
+// Frames allocate staging space against a simulated GPU fence that completes
+// a few frames late. No allocation may overlap one whose fence has not
+// completed yet, including pending ones assigned their fence afterwards.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/UploadRingAllocator.h"
+
+namespace {
+
+struct InFlight {
+    uint32_t offset;
+    size_t size;
+    uint64_t fenceValue;
+};
+
+// GPU side: completes submitted fence values in order, some frames late
+class SimulatedFence {
+public:
+    uint64_t Signal() { return ++m_nextValue; }
+    uint64_t GetCompletedValue() const { return m_completedValue; }
+    void Advance(uint32_t lagFrames) {
+        if (m_nextValue > m_completedValue + lagFrames) {
+            m_completedValue = m_nextValue - lagFrames;
+        }
+    }
+    void Flush() { m_completedValue = m_nextValue; }
+
+private:
+    uint64_t m_nextValue = 0;
+    uint64_t m_completedValue = 0;
+};
+
+bool Overlaps(uint32_t offset, size_t size, const InFlight& other) {
+    return offset < other.offset + other.size && other.offset < offset + size;
+}
+
+void TestFrameSimulation(uint32_t frames, uint32_t seed) {
+    const size_t capacity = 4 * 1024 * 1024;
+    const size_t alignment = 512;
+    UploadRingAllocator ring(capacity, alignment);
+    SimulatedFence fence;
+    std::mt19937 random(seed);
+
+    std::vector<InFlight> inFlight;     // Fence not completed yet, the GPU may read these
+    uint32_t overlaps = 0;
+    uint32_t misaligned = 0;
+    uint32_t outOfRange = 0;
+    uint32_t canAllocateMismatches = 0;
+    uint32_t allocations = 0;
+    uint32_t fullFrames = 0;
+
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        const uint64_t frameFence = frame + 1;     // What this frame's submission will signal
+        std::vector<uint32_t> pendingOffsets;
+
+        const uint32_t uploads = random() % 24;
+        for (uint32_t i = 0; i < uploads; ++i) {
+            const size_t size = 1 + random() % (random() % 8 == 0 ? 512 * 1024 : 16 * 1024);
+            const bool pending = random() % 4 == 0;     // Written ahead of knowing the submission
+            const bool expected = ring.CanAllocate(size);
+            const uint32_t offset = ring.Allocate(size, pending ? UploadRingAllocator::PENDING_FENCE : frameFence);
+            canAllocateMismatches += (offset != UINT32_MAX) != expected ? 1 : 0;
+            if (offset == UINT32_MAX) {
+                fullFrames++;
+                break;
+            }
+            allocations++;
+
+            misaligned += offset % alignment != 0 ? 1 : 0;
+            outOfRange += offset + size > capacity ? 1 : 0;
+            for (const InFlight& other : inFlight) {
+                overlaps += Overlaps(offset, size, other) ? 1 : 0;
+            }
+            inFlight.push_back({ offset, size, frameFence });
+            if (pending) {
+                pendingOffsets.push_back(offset);
+            }
+        }
+
+        // The frame's submission: pending allocations learn their fence
+        for (uint32_t offset : pendingOffsets) {
+            CHECK(ring.SetFence(offset, frameFence));
+        }
+        CHECK(fence.Signal() == frameFence);
+
+        fence.Advance(random() % 4);
+        ring.ReclaimCompleted(fence.GetCompletedValue());
+        const uint64_t completed = fence.GetCompletedValue();
+        inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+                                      [completed](const InFlight& entry) { return entry.fenceValue <= completed; }),
+                       inFlight.end());
+    }
+
+    CHECK(overlaps == 0);
+    CHECK(misaligned == 0);
+    CHECK(outOfRange == 0);
+    CHECK(canAllocateMismatches == 0);
+    CHECK(allocations > frames);
+    printf("  %u frames, %u allocations, %u frames ran out of space\n", frames, allocations, fullFrames);
+
+    // Idle GPU: everything comes back and the ring starts over
+    fence.Flush();
+    ring.ReclaimCompleted(fence.GetCompletedValue());
+    CHECK(ring.GetUsedSpace() == 0);
+    CHECK(ring.GetPendingFenceCount() == 0);
+    CHECK(ring.Allocate(capacity, fence.GetCompletedValue() + 1) == 0);
+}
+
+void TestWrapSkipsTail() {
+    UploadRingAllocator ring(1024, 256);
+    CHECK(ring.Allocate(512, 1) == 0);
+    CHECK(ring.Allocate(256, 2) == 512);
+    ring.ReclaimCompleted(1);
+
+    // 512 bytes free at the front but only 256 at the back: the tail is skipped
+    CHECK(ring.Allocate(512, 3) == 0);
+    CHECK(ring.GetUsedSpace() == 1024);
+    CHECK(!ring.CanAllocate(1));
+
+    // The skipped tail retires with the wrapped allocation, not with fence 2
+    ring.ReclaimCompleted(2);
+    CHECK(ring.GetUsedSpace() == 768);
+    ring.ReclaimCompleted(3);
+    CHECK(ring.GetUsedSpace() == 0);
+}
+
+void TestPendingFenceHoldsLaterSpace() {
+    UploadRingAllocator ring(1024, 256);
+    const uint32_t pending = ring.Allocate(256, UploadRingAllocator::PENDING_FENCE);
+    CHECK(ring.Allocate(256, 1) == 256);
+
+    // Fence 1 completed, but the pending allocation in front of it still holds it
+    ring.ReclaimCompleted(1);
+    CHECK(ring.GetUsedSpace() == 512);
+
+    CHECK(ring.SetFence(pending, 2));
+    CHECK(!ring.SetFence(pending, 3));      // Only once
+    ring.ReclaimCompleted(2);
+    CHECK(ring.GetUsedSpace() == 0);
+}
+
+void TestReset() {
+    UploadRingAllocator ring(1024, 256);
+    ring.Allocate(256, 1);
+    ring.Allocate(300, UploadRingAllocator::PENDING_FENCE);
+    ring.Reset();
+    CHECK(ring.GetUsedSpace() == 0);
+    CHECK(ring.GetPendingFenceCount() == 0);
+    CHECK(ring.Allocate(1024, 2) == 0);
+}
+
+} // namespace
+
+int main() {
+    TestFrameSimulation(20000, 33);
+    TestWrapSkipsTail();
+    TestPendingFenceHoldsLaterSpace();
+    TestReset();
+    return FinishTests("UploadRingAllocatorTest");
+}
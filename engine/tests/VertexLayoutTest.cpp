@@ -0,0 +1,250 @@
+// =============================================================================
+// Vertex Layout Test
+// =============================================================================
+//
+// FloatToHalf against known halves, and EncodeVertices' batched normal and
+// UV paths against the scalar FloatToHalf and EncodeOctahedral, bit for bit,
+// over a sweep of float bit patterns and odd vertex counts. Compact positions
+// and colors decode to within half a quantization step.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "resources/VertexLayout.h"
+
+namespace {
+
+float FromBits(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void TestKnownHalves() {
+    CHECK(FloatToHalf(0.0f) == 0x0000);
+    CHECK(FloatToHalf(-0.0f) == 0x8000);
+    CHECK(FloatToHalf(1.0f) == 0x3C00);
+    CHECK(FloatToHalf(-2.0f) == 0xC000);
+    CHECK(FloatToHalf(0.5f) == 0x3800);
+    CHECK(FloatToHalf(65504.0f) == 0x7BFF);                         // Largest half
+    CHECK(FloatToHalf(65519.0f) == 0x7BFF);
+    CHECK(FloatToHalf(65520.0f) == 0x7C00);                         // Rounds to infinity
+    CHECK(FloatToHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+    CHECK(FloatToHalf(-std::numeric_limits<float>::infinity()) == 0xFC00);
+    CHECK(FloatToHalf(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+    CHECK(FloatToHalf(std::ldexp(1.0f, -14)) == 0x0400);            // Smallest normal
+    CHECK(FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001);            // Smallest subnormal
+    CHECK(FloatToHalf(std::ldexp(1.0f, -25)) == 0x0000);            // Tie, rounds to even
+    CHECK(FloatToHalf(std::ldexp(3.0f, -25)) == 0x0002);            // Tie, rounds to even
+    CHECK(FloatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);     // Tie, rounds to even
+    CHECK(FloatToHalf(1.0f + std::ldexp(3.0f, -11)) == 0x3C02);     // Tie, rounds to even
+}
+
+struct Encoded {
+    std::vector<uint8_t> simd;
+    std::vector<uint8_t> scalar;
+};
+
+// EncodeVertices next to a per-vertex reference from the scalar blocks
+Encoded EncodeBoth(const VertexLayout& layout, const std::vector<float>& normals, const std::vector<float>& uvs,
+                   uint32_t count) {
+    std::vector<VertexAttributes> vertices(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        vertices[i].position[0] = static_cast<float>(i);
+    }
+    MeshBounds bounds;
+    bounds.max[0] = static_cast<float>(count);
+    const MeshDecode decode = MakeMeshDecode(layout, bounds);
+
+    const uint32_t stride = layout.GetStride();
+    Encoded encoded;
+    encoded.simd.resize(static_cast<size_t>(count) * stride);
+    EncodeVertices(layout, decode, vertices.data(), normals.empty() ? nullptr : normals.data(),
+                   uvs.empty() ? nullptr : uvs.data(), count, encoded.simd.data());
+
+    encoded.scalar = encoded.simd;
+    const float defaultNormal[3] = { 0.0f, 0.0f, 1.0f };
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t* out = encoded.scalar.data() + static_cast<size_t>(i) * stride;
+        if (layout.normal == NormalEncoding::Oct16) {
+            int16_t packed[2];
+            EncodeOctahedral(normals.empty() ? defaultNormal : &normals[i * 3], packed);
+            memcpy(out + layout.GetNormalOffset(), packed, sizeof(packed));
+        }
+        if (layout.uv == UVEncoding::Half) {
+            const float u = uvs.empty() ? 0.0f : uvs[i * 2];
+            const float v = uvs.empty() ? 0.0f : uvs[i * 2 + 1];
+            const uint16_t packed[2] = { FloatToHalf(u), FloatToHalf(v) };
+            memcpy(out + layout.GetUVOffset(), packed, sizeof(packed));
+        }
+    }
+    return encoded;
+}
+
+uint32_t CountMismatches(const Encoded& encoded, uint32_t stride) {
+    uint32_t mismatches = 0;
+    for (size_t offset = 0; offset < encoded.simd.size(); offset += stride) {
+        mismatches += memcmp(&encoded.simd[offset], &encoded.scalar[offset], stride) != 0 ? 1 : 0;
+    }
+    return mismatches;
+}
+
+void TestHalfSweep() {
+    // Every 4099th bit pattern, plus both neighbours of each half threshold
+    std::vector<float> uvs;
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFFull; bits += 4099) {
+        uvs.push_back(FromBits(static_cast<uint32_t>(bits)));
+    }
+    for (uint32_t threshold : { 0x33000000u, 0x38800000u, 0x477FF000u, 0x7F800000u }) {
+        for (uint32_t delta = 0; delta < 64; ++delta) {
+            uvs.push_back(FromBits(threshold + delta));
+            uvs.push_back(FromBits(threshold - delta));
+            uvs.push_back(FromBits((threshold + delta) | 0x80000000u));
+        }
+    }
+    while (uvs.size() % 4 != 2) {
+        uvs.push_back(0.25f);   // Odd vertex count, the last one takes the scalar path
+    }
+
+    const VertexLayout layout = VertexLayout::Compact(false, true);
+    const uint32_t count = static_cast<uint32_t>(uvs.size() / 2);
+    const Encoded encoded = EncodeBoth(layout, std::vector<float>(), uvs, count);
+    CHECK(CountMismatches(encoded, layout.GetStride()) == 0);
+    printf("  %u uvs compared\n", count * 2);
+}
+
+void TestOctahedralNormals() {
+    std::mt19937 random(40);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+
+    std::vector<float> normals;
+    auto push = [&normals](float x, float y, float z) {
+        normals.push_back(x);
+        normals.push_back(y);
+        normals.push_back(z);
+    };
+
+    // Axes, zero, negative zeros and the fold's diagonals
+    push(0.0f, 0.0f, 0.0f);
+    push(1.0f, 0.0f, 0.0f);
+    push(0.0f, -1.0f, 0.0f);
+    push(0.0f, 0.0f, -1.0f);
+    push(-0.0f, -0.0f, -1.0f);
+    push(0.5f, -0.5f, -0.0f);
+    push(-0.25f, 0.25f, -0.5f);
+    push(3.0f, 4.0f, -5.0f);        // Not normalized
+
+    // Unit vectors, and a few with components that land on quantization ties
+    for (uint32_t i = 0; i < 100000; ++i) {
+        float x = component(random);
+        float y = component(random);
+        float z = component(random);
+        const float length = std::sqrt(x * x + y * y + z * z);
+        if (length > 0.0f && i % 3 != 0) {
+            x /= length;
+            y /= length;
+            z /= length;
+        }
+        push(x, y, z);
+    }
+    for (int step = -32767; step <= 32767; step += 97) {
+        const float tie = (static_cast<float>(step) + 0.5f) / 32767.0f;
+        push(tie, 1.0f - std::fabs(tie), step % 2 == 0 ? 0.0f : -0.0f);
+    }
+    while (normals.size() % 12 != 9) {
+        push(0.0f, 1.0f, 0.0f);     // Leave a tail of three
+    }
+
+    const VertexLayout layout = VertexLayout::Compact(true, false);
+    const uint32_t count = static_cast<uint32_t>(normals.size() / 3);
+    const Encoded encoded = EncodeBoth(layout, normals, std::vector<float>(), count);
+    CHECK(CountMismatches(encoded, layout.GetStride()) == 0);
+    printf("  %u normals compared\n", count);
+}
+
+void TestDefaultsAndSmallCounts() {
+    // Missing streams encode +Z and 0 whatever the count
+    const VertexLayout layout = VertexLayout::Compact(true, true);
+    for (uint32_t count = 1; count <= 9; ++count) {
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        const Encoded missing = EncodeBoth(layout, normals, uvs, count);
+        CHECK(CountMismatches(missing, layout.GetStride()) == 0);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            normals.insert(normals.end(), { 0.6f, -0.8f, -0.0f });
+            uvs.insert(uvs.end(), { 0.1f * static_cast<float>(i), -3.5f });
+        }
+        const Encoded present = EncodeBoth(layout, normals, uvs, count);
+        CHECK(CountMismatches(present, layout.GetStride()) == 0);
+    }
+}
+
+void TestCompactRoundTrip() {
+    // Vertices spread over bounds with a flat y axis (a floor) and colors
+    // past both ends of [0, 1]
+    std::mt19937 random(40);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    MeshBounds bounds;
+    const float boundsMin[3] = { -3.0f, 2.0f, 100.0f };
+    const float boundsMax[3] = { 5.0f, 2.0f, 100.25f };
+    memcpy(bounds.min, boundsMin, sizeof(boundsMin));
+    memcpy(bounds.max, boundsMax, sizeof(boundsMax));
+
+    const uint32_t count = 1001;
+    std::vector<VertexAttributes> vertices(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float t = i < 2 ? static_cast<float>(i) : unit(random);
+            vertices[i].position[axis] = boundsMin[axis] + t * (boundsMax[axis] - boundsMin[axis]);
+            vertices[i].color[axis] = unit(random) * 1.2f - 0.1f;
+        }
+    }
+
+    const VertexLayout layout = VertexLayout::Compact();
+    const MeshDecode decode = MakeMeshDecode(layout, bounds);
+    std::vector<uint8_t> encoded(static_cast<size_t>(count) * layout.GetStride());
+    EncodeVertices(layout, decode, vertices.data(), nullptr, nullptr, count, encoded.data());
+
+    // What the input assembler and the decoded model matrix make of it:
+    // half a step of each axis' extent, half a step of 1/255 per channel
+    float positionError[3] = {};
+    float colorError = 0.0f;
+    bool paddingKept = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* vertex = encoded.data() + static_cast<size_t>(i) * layout.GetStride();
+        uint16_t position[4];
+        memcpy(position, vertex, sizeof(position));
+        const uint8_t* color = vertex + layout.GetColorOffset();
+        for (int axis = 0; axis < 3; ++axis) {
+            const float decoded = decode.bias[axis] + decode.scale[axis] * (position[axis] / 65535.0f);
+            positionError[axis] = std::max(positionError[axis], std::fabs(decoded - vertices[i].position[axis]));
+            const float clamped = std::min(std::max(vertices[i].color[axis], 0.0f), 1.0f);
+            colorError = std::max(colorError, std::fabs(color[axis] / 255.0f - clamped));
+        }
+        paddingKept = paddingKept && position[3] == 0 && color[3] == 255;
+    }
+    CHECK(positionError[0] <= 0.5f * 8.0f / 65535.0f * 1.01f);
+    CHECK(positionError[1] == 0.0f);
+    CHECK(positionError[2] <= 0.5f * 0.25f / 65535.0f * 1.01f + 1e-5f);
+    CHECK(colorError <= 0.5f / 255.0f * 1.01f);
+    CHECK(paddingKept);
+    printf("  max error x %g, y %g, z %g, color %g\n", positionError[0], positionError[1], positionError[2],
+           colorError);
+}
+
+} // namespace
+
+int main() {
+    TestKnownHalves();
+    TestHalfSweep();
+    TestOctahedralNormals();
+    TestDefaultsAndSmallCounts();
+    TestCompactRoundTrip();
+    return FinishTests("VertexLayoutTest");
+}
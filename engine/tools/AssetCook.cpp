@@ -0,0 +1,231 @@
+// =============================================================================
+// Asset Cook
+// =============================================================================
+//
+// Incremental cook of a content directory through the asset database. The
+// first run cooks everything; later runs re-hash only files whose size or
+// write time changed and re-cook the assets affected by them, including
+// through dependencies (glTF buffers and images, HLSL includes).
+//
+//   AssetCook [--threads N] [--layout float|compact] [--lods N] [--meshlets]
+//             [--dependents path] <source dir> <output dir>
+//
+// Outputs are named by asset GUID; <output dir>/assets.db maps source paths
+// to GUIDs and carries the state between runs. Images are cooked to BC7 (BC5
+// for normal maps, told apart by a "normal" in the file name).
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "IO/GLTFImporter.h"
+#include "jobs/JobSystem.h"
+#include "resources/AssetDatabase.h"
+#include "resources/ContentHash.h"
+#include "resources/CookedMesh.h"
+#include "resources/CookedTexture.h"
+
+namespace {
+
+// Bump when a cooker's output changes for the same input
+constexpr uint64_t MESH_COOKER_VERSION = 1;
+constexpr uint64_t COPY_COOKER_VERSION = 1;
+constexpr uint64_t TEXTURE_COOKER_VERSION = 1;
+
+std::string_view AsText(const std::vector<uint8_t>& bytes) {
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+// Every "uri": "..." that isn't a data URI. The JSON chunk of a .glb is
+// plain text too, so the same scan covers both.
+std::vector<std::string> ScanGLTFDependencies(const std::string&, const std::vector<uint8_t>& source) {
+    std::vector<std::string> dependencies;
+    const std::string_view text = AsText(source);
+    size_t position = 0;
+    while ((position = text.find("\"uri\"", position)) != std::string_view::npos) {
+        position += 5;
+        const size_t open = text.find('"', text.find(':', position));
+        const size_t close = open == std::string_view::npos ? open : text.find('"', open + 1);
+        if (close == std::string_view::npos) {
+            break;
+        }
+        const std::string_view uri = text.substr(open + 1, close - open - 1);
+        if (uri.compare(0, 5, "data:") != 0) {
+            dependencies.emplace_back(uri);
+        }
+        position = close + 1;
+    }
+    return dependencies;
+}
+
+// #include "file" lines
+std::vector<std::string> ScanHLSLDependencies(const std::string&, const std::vector<uint8_t>& source) {
+    std::vector<std::string> dependencies;
+    const std::string_view text = AsText(source);
+    size_t position = 0;
+    while ((position = text.find("#include", position)) != std::string_view::npos) {
+        position += 8;
+        const size_t lineEnd = text.find('\n', position);
+        const size_t open = text.find('"', position);
+        if (open == std::string_view::npos || open > lineEnd) {
+            continue;
+        }
+        const size_t close = text.find('"', open + 1);
+        if (close == std::string_view::npos || close > lineEnd) {
+            continue;
+        }
+        dependencies.emplace_back(text.substr(open + 1, close - open - 1));
+        position = close + 1;
+    }
+    return dependencies;
+}
+
+// Name-based until materials say how their textures are used
+TextureUsage GuessTextureUsage(const std::string& sourcePath) {
+    std::string name = std::filesystem::path(sourcePath).stem().string();
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (name.find("normal") != std::string::npos || name.find("_nrm") != std::string::npos) {
+        return TextureUsage::Normal;
+    }
+    for (const char* linear : { "rough", "metal", "mrao", "_orm", "occlusion", "_ao", "height", "mask" }) {
+        if (name.find(linear) != std::string::npos) {
+            return TextureUsage::Linear;
+        }
+    }
+    return TextureUsage::Color;
+}
+
+bool CookTextureFile(const std::string& sourcePath, const std::string& outputPath) {
+    TextureImage image;
+    if (!LoadTextureImage(sourcePath, image)) {
+        return false;
+    }
+    TextureCookSettings settings;
+    settings.usage = GuessTextureUsage(sourcePath);
+    settings.format = settings.usage == TextureUsage::Normal ? TextureFormat::BC5 : TextureFormat::BC7;
+
+    // Already on a worker, encode single threaded
+    CookedTexture cooked = CookTexture(image, settings);
+    cooked.name = std::filesystem::path(sourcePath).filename().string();
+    return !cooked.data.empty() && WriteCookedTextureFile(outputPath, cooked);
+}
+
+bool CopyFile(const std::string& sourcePath, const std::string& outputPath) {
+    std::error_code error;
+    std::filesystem::copy_file(sourcePath, outputPath, std::filesystem::copy_options::overwrite_existing, error);
+    return !error;
+}
+
+void PrintUsage() {
+    printf("Usage: AssetCook [--threads N] [--layout float|compact] [--lods N] [--meshlets]\n"
+           "                 [--dependents path] <source dir> <output dir>\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MeshCookSettings settings;
+    settings.autoLODCount = MAX_MESH_LODS - 1;
+    settings.optimize = true;
+
+    uint32_t threads = 0;
+    bool compact = true;
+    std::string dependentsOf;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            compact = strcmp(argv[++i], "float") != 0;
+        } else if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc) {
+            settings.autoLODCount = static_cast<uint32_t>(std::clamp(strtol(argv[++i], nullptr, 10), 0L,
+                                                                     static_cast<long>(MAX_MESH_LODS - 1)));
+        } else if (strcmp(argv[i], "--meshlets") == 0) {
+            settings.buildMeshlets = true;
+        } else if (strcmp(argv[i], "--dependents") == 0 && i + 1 < argc) {
+            dependentsOf = argv[++i];
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2) {
+        PrintUsage();
+        return 1;
+    }
+    settings.vertexLayout = compact ? VertexLayout::Compact() : VertexLayout::Float();
+
+    AssetDatabase database(paths[0], paths[1]);
+
+    // Settings that change the cooked bytes are part of the version
+    AssetCooker meshCooker;
+    meshCooker.outputExtension = ".de3mesh";
+    const uint32_t meshOptions[] = { compact, settings.autoLODCount, settings.buildMeshlets };
+    meshCooker.version = HashBytes(meshOptions, sizeof(meshOptions), MESH_COOKER_VERSION);
+    meshCooker.scanDependencies = ScanGLTFDependencies;
+    meshCooker.cook = [&settings](const std::string& sourcePath, const std::string& outputPath) {
+        // Already on a worker, import single threaded
+        ImportedScene scene;
+        if (!GLTFImporter::Import(sourcePath, scene)) {
+            return false;
+        }
+        std::vector<CookedMesh> cooked(scene.meshes.size());
+        for (size_t i = 0; i < cooked.size(); ++i) {
+            cooked[i] = CookMesh(scene.meshes[i].GetCPUMesh(), settings);
+            cooked[i].name = scene.meshes[i].name;
+        }
+        return WriteCookedMeshFile(outputPath, cooked);
+    };
+    database.RegisterCooker(".gltf", meshCooker);
+    database.RegisterCooker(".glb", meshCooker);
+
+    // Shaders compile at runtime for now, the cook tracks includes and copies
+    AssetCooker shaderCooker;
+    shaderCooker.outputExtension = ".hlsl";
+    shaderCooker.version = COPY_COOKER_VERSION;
+    shaderCooker.scanDependencies = ScanHLSLDependencies;
+    shaderCooker.cook = CopyFile;
+    database.RegisterCooker(".hlsl", shaderCooker);
+
+    // Included only, never cooked on their own
+    AssetCooker includeCooker;
+    includeCooker.scanDependencies = ScanHLSLDependencies;
+    database.RegisterCooker(".hlsli", includeCooker);
+
+    AssetCooker textureCooker;
+    textureCooker.outputExtension = ".de3tex";
+    const uint32_t textureFormats[] = { static_cast<uint32_t>(TextureFormat::BC7), static_cast<uint32_t>(TextureFormat::BC5) };
+    textureCooker.version = HashBytes(textureFormats, sizeof(textureFormats), TEXTURE_COOKER_VERSION);
+    textureCooker.cook = CookTextureFile;
+    for (const char* extension : { ".png", ".jpg", ".jpeg", ".tga", ".bmp" }) {
+        database.RegisterCooker(extension, textureCooker);
+    }
+
+    const std::string databasePath = (std::filesystem::path(paths[1]) / "assets.db").string();
+    if (!database.Load(databasePath)) {
+        return 1;
+    }
+
+    JobSystem jobSystem(threads);
+    AssetDatabase::Statistics stats;
+    const bool success = database.Update(jobSystem, &stats);
+    AssetDatabase::PrintStats(stats);
+
+    std::error_code error;
+    std::filesystem::create_directories(paths[1], error);
+    if (!database.Save(databasePath)) {
+        return 1;
+    }
+
+    if (!dependentsOf.empty()) {
+        printf("Dependents of %s:\n", dependentsOf.c_str());
+        for (const AssetDatabase::Asset* asset : database.GetDependents(dependentsOf)) {
+            printf("  %s %s\n", asset->guid.ToString().c_str(), asset->path.c_str());
+        }
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+// =============================================================================
+// File IO Benchmark
+// =============================================================================
+//
+// Writes two sets of files to a scratch directory, many small ones (shader
+// cache sized) and a few huge ones (cooked mesh sized), then times reading
+// every file of a set with:
+//   ifstream  - the seek/tellg/read path FileReader used to take
+//   read      - FileIOService::ReadWholeFile, one allocation, no seeking
+//   mapped    - FileIOService::Map, every byte touched so pages fault in
+//   async     - FileIOService::ReadAsync batched over the I/O threads
+// Every method sums the bytes it sees so none of them can skip work.
+//
+//   FileIOBenchmark [--small N] [--small-kb N] [--huge N] [--huge-mb N]
+//                   [--workers N] [--runs N] [--dir path]
+//
+// Repeated runs are served from the OS file cache; drop it between runs for
+// cold-start numbers.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "IO/FileIOService.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint64_t Checksum(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+bool WriteFiles(const std::filesystem::path& dir, const char* prefix, uint32_t count, size_t size,
+                std::vector<std::string>& paths) {
+    std::vector<char> data(size);
+    uint32_t state = 0x9E3779B9u;
+    for (char& byte : data) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<char>(state >> 24);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const std::string path = (dir / (std::string(prefix) + std::to_string(i) + ".bin")).string();
+        std::ofstream file(path, std::ios::binary);
+        data[0] = static_cast<char>(i);
+        if (!file.write(data.data(), data.size())) {
+            printf("FileIOBenchmark: Failed to write '%s'\n", path.c_str());
+            return false;
+        }
+        paths.push_back(path);
+    }
+    return true;
+}
+
+// The old FileReader::ReadFileBytes
+uint64_t ReadIfstream(const std::vector<std::string>& paths) {
+    uint64_t sum = 0;
+    for (const std::string& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(0, std::ios::end);
+        size_t size = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        std::vector<uint8_t> bytes(size);
+        file.read(reinterpret_cast<char*>(bytes.data()), size);
+        sum += Checksum(bytes.data(), bytes.size());
+    }
+    return sum;
+}
+
+uint64_t ReadWhole(const std::vector<std::string>& paths) {
+    uint64_t sum = 0;
+    std::vector<uint8_t> bytes;
+    for (const std::string& path : paths) {
+        FileIOService::ReadWholeFile(path, bytes);
+        sum += Checksum(bytes.data(), bytes.size());
+    }
+    return sum;
+}
+
+uint64_t ReadMapped(const std::vector<std::string>& paths) {
+    uint64_t sum = 0;
+    for (const std::string& path : paths) {
+        const MappedFile file = FileIOService::Map(path);
+        sum += Checksum(file.GetData(), file.GetSize());
+    }
+    return sum;
+}
+
+uint64_t ReadQueued(FileIOService& service, const std::vector<std::string>& paths) {
+    std::atomic<uint64_t> sum{ 0 };
+    std::vector<FileIOService::ReadRequest> requests;
+    requests.reserve(paths.size());
+    for (const std::string& path : paths) {
+        requests.push_back({ path, [&sum](FileIOService::ReadResult& result) {
+            sum += Checksum(result.data.data(), result.data.size());
+        } });
+    }
+    service.ReadAsync(std::move(requests));
+    service.WaitIdle();
+    return sum;
+}
+
+template <typename Func>
+void Measure(const char* label, size_t totalBytes, uint32_t runs, uint64_t expected, Func&& func) {
+    double best = 0.0;
+    for (uint32_t run = 0; run < runs; ++run) {
+        const Clock::time_point start = Clock::now();
+        const uint64_t sum = func();
+        const double ms = ElapsedMs(start);
+        if (sum != expected) {
+            printf("  %-10s checksum mismatch\n", label);
+            return;
+        }
+        if (run == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    printf("  %-10s %10.2f ms %10.0f MB/s\n", label, best,
+           best > 0.0 ? totalBytes / (1024.0 * 1024.0) / (best / 1000.0) : 0.0);
+}
+
+void RunSet(const char* name, const std::vector<std::string>& paths, size_t fileSize, uint32_t runs,
+            FileIOService& service) {
+    const size_t totalBytes = paths.size() * fileSize;
+    printf("%s: %zu files x %.1f KB (%.1f MB)\n", name, paths.size(), fileSize / 1024.0,
+           totalBytes / (1024.0 * 1024.0));
+
+    // Warm the file cache so every method starts from the same state
+    const uint64_t expected = ReadIfstream(paths);
+
+    Measure("ifstream", totalBytes, runs, expected, [&] { return ReadIfstream(paths); });
+    Measure("read", totalBytes, runs, expected, [&] { return ReadWhole(paths); });
+    Measure("mapped", totalBytes, runs, expected, [&] { return ReadMapped(paths); });
+    Measure("async", totalBytes, runs, expected, [&] { return ReadQueued(service, paths); });
+}
+
+uint32_t ParseCount(const char* value) {
+    return static_cast<uint32_t>(std::max(1L, strtol(value, nullptr, 10)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t smallCount = 2000;
+    uint32_t smallKB = 16;
+    uint32_t hugeCount = 4;
+    uint32_t hugeMB = 256;
+    uint32_t workers = 0;
+    uint32_t runs = 3;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "de3_fileio_bench";
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--small") == 0 && hasValue) {
+            smallCount = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--small-kb") == 0 && hasValue) {
+            smallKB = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--huge") == 0 && hasValue) {
+            hugeCount = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--huge-mb") == 0 && hasValue) {
+            hugeMB = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--workers") == 0 && hasValue) {
+            workers = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && hasValue) {
+            runs = ParseCount(argv[++i]);
+        } else if (strcmp(argv[i], "--dir") == 0 && hasValue) {
+            dir = argv[++i];
+        } else {
+            printf("Usage: FileIOBenchmark [--small N] [--small-kb N] [--huge N] [--huge-mb N]\n"
+                   "                       [--workers N] [--runs N] [--dir path]\n");
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) {
+        printf("FileIOBenchmark: Failed to create '%s'\n", dir.string().c_str());
+        return 1;
+    }
+
+    const size_t smallSize = static_cast<size_t>(smallKB) * 1024;
+    const size_t hugeSize = static_cast<size_t>(hugeMB) * 1024 * 1024;
+    std::vector<std::string> smallFiles, hugeFiles;
+    if (!WriteFiles(dir, "small_", smallCount, smallSize, smallFiles) ||
+        !WriteFiles(dir, "huge_", hugeCount, hugeSize, hugeFiles)) {
+        std::filesystem::remove_all(dir, error);
+        return 1;
+    }
+
+    {
+        FileIOService service(workers);
+
+        printf("=== FileIOBenchmark: %s (best of %u) ===\n", dir.string().c_str(), runs);
+        RunSet("Small", smallFiles, smallSize, runs, service);
+        RunSet("Huge", hugeFiles, hugeSize, runs, service);
+
+        const FileIOService::Statistics stats = service.GetStatistics();
+        printf("Async: %llu reads in %llu batches, %llu failed\n",
+               static_cast<unsigned long long>(stats.completed), static_cast<unsigned long long>(stats.batches),
+               static_cast<unsigned long long>(stats.failed));
+        printf("===========================\n");
+    }
+
+    std::filesystem::remove_all(dir, error);
+    return 0;
+}
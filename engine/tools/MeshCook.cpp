@@ -0,0 +1,122 @@
+// =============================================================================
+// Mesh Cook
+// =============================================================================
+//
+// Converts the meshes of a glTF/GLB file into a cooked mesh file: optimized,
+// with LODs (and optionally meshlets), encoded in the vertex layout the engine
+// runs with. GeometryManager::CreateMesh(EncodedMesh) then only copies bytes.
+//
+//   MeshCook [--layout float|compact] [--normals] [--uvs] [--lods N]
+//            [--no-optimize] [--meshlets] <input.gltf|glb> <output.de3mesh>
+//
+// The layout must match GeometryManager::Config::vertexLayout at load time;
+// the engine's default is compact without normals or uvs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "IO/GLTFImporter.h"
+#include "jobs/JobSystem.h"
+#include "resources/CookedMesh.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void PrintUsage() {
+    printf("Usage: MeshCook [--layout float|compact] [--normals] [--uvs] [--lods N]\n"
+           "                [--no-optimize] [--meshlets] <input.gltf|glb> <output.de3mesh>\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MeshCookSettings settings;
+    settings.autoLODCount = MAX_MESH_LODS - 1;
+    settings.optimize = true;
+
+    bool compact = true;
+    bool withNormals = false;
+    bool withUVs = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            const char* layout = argv[++i];
+            if (strcmp(layout, "float") != 0 && strcmp(layout, "compact") != 0) {
+                PrintUsage();
+                return 1;
+            }
+            compact = strcmp(layout, "compact") == 0;
+        } else if (strcmp(argv[i], "--normals") == 0) {
+            withNormals = true;
+        } else if (strcmp(argv[i], "--uvs") == 0) {
+            withUVs = true;
+        } else if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc) {
+            settings.autoLODCount = static_cast<uint32_t>(std::clamp(strtol(argv[++i], nullptr, 10), 0L,
+                                                                     static_cast<long>(MAX_MESH_LODS - 1)));
+        } else if (strcmp(argv[i], "--no-optimize") == 0) {
+            settings.optimize = false;
+        } else if (strcmp(argv[i], "--meshlets") == 0) {
+            settings.buildMeshlets = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.size() != 2) {
+        PrintUsage();
+        return 1;
+    }
+    settings.vertexLayout = compact ? VertexLayout::Compact(withNormals, withUVs)
+                                    : VertexLayout::Float(withNormals, withUVs);
+
+    JobSystem jobSystem;
+
+    ImportedScene scene;
+    GLTFImporter::Statistics importStats;
+    if (!GLTFImporter::Import(paths[0], scene, &jobSystem, GLTFImportSettings(), &importStats)) {
+        return 1;
+    }
+    GLTFImporter::PrintStats(paths[0], scene, importStats);
+
+    // Every mesh cooks independently
+    const Clock::time_point cookStart = Clock::now();
+    std::vector<CookedMesh> cooked(scene.meshes.size());
+    jobSystem.ParallelFor(static_cast<uint32_t>(cooked.size()), [&](uint32_t i) {
+        cooked[i] = CookMesh(scene.meshes[i].GetCPUMesh(), settings);
+        cooked[i].name = scene.meshes[i].name;
+    });
+    const double cookMs = ElapsedMs(cookStart);
+
+    const Clock::time_point writeStart = Clock::now();
+    if (!WriteCookedMeshFile(paths[1], cooked)) {
+        return 1;
+    }
+    const double writeMs = ElapsedMs(writeStart);
+
+    size_t vertexBytes = 0, indexBytes = 0, meshlets = 0, lods = 0;
+    for (const CookedMesh& mesh : cooked) {
+        vertexBytes += mesh.vertexData.size();
+        indexBytes += mesh.indexData.size();
+        meshlets += mesh.meshlets.meshlets.size();
+        lods += mesh.lodIndexCounts.size();
+    }
+
+    printf("=== MeshCook: %s ===\n", paths[1].c_str());
+    printf("Meshes: %zu, LODs: %zu, Meshlets: %zu\n", cooked.size(), lods, meshlets);
+    printf("Vertex Stride: %u bytes, Vertex Data: %.1f MB, Index Data: %.1f MB\n",
+           settings.vertexLayout.GetStride(), vertexBytes / (1024.0 * 1024.0), indexBytes / (1024.0 * 1024.0));
+    printf("Cook: %.2f ms (%u threads), Write: %.2f ms\n", cookMs, jobSystem.GetThreadCount(), writeMs);
+    printf("===========================\n");
+    return 0;
+}
@@ -0,0 +1,272 @@
+// =============================================================================
+// Mesh Optimize Report
+// =============================================================================
+//
+// Runs the mesh optimizer over OBJ files (or generated test meshes) and prints
+// post-transform cache statistics before and after, then the meshlets built
+// from the optimized mesh and how many of them the cone test rejects from
+// six views around it.
+//
+//   MeshOptimizeReport [--cache N] [--no-overdraw] <file.obj | grid | sphere>...
+//
+// "grid" and "sphere" are generated with shuffled triangles and duplicated
+// vertices, roughly what an exporter without reordering produces.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "resources/MeshOptimizer.h"
+#include "resources/MeshletBuilder.h"
+#include "renderer/MeshletCuller.h"
+
+namespace {
+
+struct SourceMesh {
+    std::string name;
+    std::vector<VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+
+    CPUMesh GetCPUMesh() const {
+        CPUMesh mesh;
+        mesh.vertices = vertices.data();
+        mesh.indices = indices.data();
+        mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+        mesh.indexCount = static_cast<uint32_t>(indices.size());
+        return mesh;
+    }
+};
+
+VertexAttributes MakeVertex(float x, float y, float z) {
+    VertexAttributes vertex = {};
+    vertex.position[0] = x;
+    vertex.position[1] = y;
+    vertex.position[2] = z;
+    vertex.color[0] = vertex.color[1] = vertex.color[2] = 1.0f;
+    return vertex;
+}
+
+// Positions and faces only, polygons are fanned into triangles
+bool LoadOBJ(const char* path, SourceMesh& mesh) {
+    std::ifstream file(path);
+    if (!file) {
+        printf("MeshOptimizeReport: Failed to open '%s'\n", path);
+        return false;
+    }
+
+    mesh.name = path;
+    std::string line;
+    std::vector<uint32_t> face;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if (keyword == "v") {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            stream >> x >> y >> z;
+            mesh.vertices.push_back(MakeVertex(x, y, z));
+        } else if (keyword == "f") {
+            face.clear();
+            std::string corner;
+            while (stream >> corner) {
+                // v, v/vt, v//vn or v/vt/vn; negative indices count from the end
+                const long index = strtol(corner.c_str(), nullptr, 10);
+                const long resolved = index < 0 ? static_cast<long>(mesh.vertices.size()) + index : index - 1;
+                if (resolved < 0 || resolved >= static_cast<long>(mesh.vertices.size())) {
+                    printf("MeshOptimizeReport: Bad face index in '%s'\n", path);
+                    return false;
+                }
+                face.push_back(static_cast<uint32_t>(resolved));
+            }
+            for (size_t i = 2; i < face.size(); ++i) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[i - 1]);
+                mesh.indices.push_back(face[i]);
+            }
+        }
+    }
+
+    if (mesh.indices.empty()) {
+        printf("MeshOptimizeReport: No triangles in '%s'\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Every triangle gets its own three vertices and the triangle order is
+// shuffled, so dedup and both reorderings have work to do
+void Scramble(SourceMesh& mesh, std::mt19937& rng) {
+    const size_t triangleCount = mesh.indices.size() / 3;
+    std::vector<uint32_t> order(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        order[t] = static_cast<uint32_t>(t);
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+    vertices.reserve(triangleCount * 3);
+    indices.reserve(triangleCount * 3);
+    for (uint32_t t : order) {
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            indices.push_back(static_cast<uint32_t>(vertices.size()));
+            vertices.push_back(mesh.vertices[mesh.indices[t * 3 + corner]]);
+        }
+    }
+    mesh.vertices = std::move(vertices);
+    mesh.indices = std::move(indices);
+}
+
+SourceMesh GenerateGrid(uint32_t size, std::mt19937& rng) {
+    SourceMesh mesh;
+    mesh.name = "grid " + std::to_string(size) + "x" + std::to_string(size);
+    for (uint32_t y = 0; y <= size; ++y) {
+        for (uint32_t x = 0; x <= size; ++x) {
+            mesh.vertices.push_back(MakeVertex(static_cast<float>(x), static_cast<float>(y), 0.0f));
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t i = y * (size + 1) + x;
+            mesh.indices.insert(mesh.indices.end(), { i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1 });
+        }
+    }
+    Scramble(mesh, rng);
+    return mesh;
+}
+
+SourceMesh GenerateSphere(uint32_t rings, uint32_t segments, std::mt19937& rng) {
+    const float pi = 3.14159265358979f;
+    SourceMesh mesh;
+    mesh.name = "sphere " + std::to_string(rings) + "x" + std::to_string(segments);
+    for (uint32_t r = 0; r <= rings; ++r) {
+        const float theta = pi * r / rings;
+        for (uint32_t s = 0; s <= segments; ++s) {
+            const float phi = 2.0f * pi * s / segments;
+            mesh.vertices.push_back(MakeVertex(std::sin(theta) * std::cos(phi), std::cos(theta),
+                                               std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (uint32_t r = 0; r < rings; ++r) {
+        for (uint32_t s = 0; s < segments; ++s) {
+            const uint32_t i = r * (segments + 1) + s;
+            mesh.indices.insert(mesh.indices.end(), { i, i + segments + 1, i + 1, i + 1, i + segments + 1, i + segments + 2 });
+        }
+    }
+    Scramble(mesh, rng);
+    return mesh;
+}
+
+void Report(const SourceMesh& source, const MeshOptimizeSettings& settings) {
+    const CPUMesh mesh = source.GetCPUMesh();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    MeshOptimizeReport report;
+    OptimizedMesh optimized = OptimizeMesh(mesh, settings, &report);
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    printf("%s\n", source.name.c_str());
+    printf("  Triangles:  %u\n", mesh.indexCount / 3);
+    printf("  Vertices:   %u -> %u\n", report.vertexCountBefore, report.vertexCountAfter);
+    printf("  ACMR (%2u):  %.3f -> %.3f\n", settings.cacheSize, report.before.acmr, report.after.acmr);
+    printf("  ATVR (%2u):  %.3f -> %.3f\n", settings.cacheSize, report.before.atvr, report.after.atvr);
+
+    // The same order on a larger cache, for hardware that has one
+    const uint32_t largerCache = settings.cacheSize * 2;
+    const VertexCacheStats before = AnalyzeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount, largerCache);
+    const VertexCacheStats after = AnalyzeVertexCache(optimized.indices.data(), static_cast<uint32_t>(optimized.indices.size()),
+                                                      static_cast<uint32_t>(optimized.vertices.size()), largerCache);
+    printf("  ACMR (%2u):  %.3f -> %.3f\n", largerCache, before.acmr, after.acmr);
+    printf("  ATVR (%2u):  %.3f -> %.3f\n", largerCache, before.atvr, after.atvr);
+    printf("  Time:       %.2f ms\n", milliseconds);
+
+    const CPUMesh optimizedMesh = optimized.GetCPUMesh();
+    const auto meshletStart = std::chrono::high_resolution_clock::now();
+    const MeshletData meshlets = BuildMeshlets(optimizedMesh.vertices, optimizedMesh.vertexCount,
+                                               optimizedMesh.indices, optimizedMesh.indexCount);
+    const auto meshletEnd = std::chrono::high_resolution_clock::now();
+    if (meshlets.meshlets.empty()) {
+        return;
+    }
+
+    const uint32_t meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+    printf("  Meshlets:   %u (%.1f vertices, %.1f triangles on average), %.2f ms\n", meshletCount,
+           static_cast<float>(meshlets.vertexIndices.size()) / meshletCount,
+           static_cast<float>(meshlets.triangles.size() / 3) / meshletCount,
+           std::chrono::duration<double, std::milli>(meshletEnd - meshletStart).count());
+
+    // Cameras on the axes outside the bounding box, looking at its center
+    glm::vec3 boundsMin(optimizedMesh.vertices[0].position[0], optimizedMesh.vertices[0].position[1], optimizedMesh.vertices[0].position[2]);
+    glm::vec3 boundsMax = boundsMin;
+    for (uint32_t i = 1; i < optimizedMesh.vertexCount; ++i) {
+        const glm::vec3 p(optimizedMesh.vertices[i].position[0], optimizedMesh.vertices[i].position[1], optimizedMesh.vertices[i].position[2]);
+        boundsMin = glm::min(boundsMin, p);
+        boundsMax = glm::max(boundsMax, p);
+    }
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    const float distance = std::max(glm::length(boundsMax - boundsMin), 1e-3f) * 1.5f;
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, distance * 0.01f, distance * 4.0f);
+    const glm::vec3 directions[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+    MeshletCuller culler;
+    std::vector<uint32_t> visible;
+    uint32_t backfaceCulled = 0;
+    for (const glm::vec3& direction : directions) {
+        const glm::vec3 camera = center + direction * distance;
+        const glm::vec3 up = std::abs(direction.y) > 0.5f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+        culler.BeginView(projection * glm::lookAt(camera, center, up), camera);
+        visible.clear();
+        culler.CullMeshlets(meshlets.bounds.data(), meshletCount, glm::mat4(1.0f), visible);
+        backfaceCulled += culler.GetStatistics().backfaceCulledMeshlets;
+    }
+    printf("  Cone Culled: %.1f%% of meshlets per view (6 axis views)\n",
+           100.0f * backfaceCulled / (6.0f * meshletCount));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MeshOptimizeSettings settings;
+    std::vector<SourceMesh> meshes;
+    std::mt19937 rng(1234);
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            settings.cacheSize = static_cast<uint32_t>(std::max(3L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--no-overdraw") == 0) {
+            settings.optimizeOverdraw = false;
+        } else if (strcmp(argv[i], "grid") == 0) {
+            meshes.push_back(GenerateGrid(128, rng));
+        } else if (strcmp(argv[i], "sphere") == 0) {
+            meshes.push_back(GenerateSphere(96, 192, rng));
+        } else {
+            SourceMesh mesh;
+            if (!LoadOBJ(argv[i], mesh)) {
+                return 1;
+            }
+            meshes.push_back(std::move(mesh));
+        }
+    }
+
+    if (meshes.empty()) {
+        printf("Usage: MeshOptimizeReport [--cache N] [--no-overdraw] <file.obj | grid | sphere>...\n");
+        return 1;
+    }
+
+    for (const SourceMesh& mesh : meshes) {
+        Report(mesh, settings);
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+// =============================================================================
+// Pack Builder
+// =============================================================================
+//
+// Packs the files under a root directory into a pack file, paths relative to
+// the root. Mount the pack over that root (VirtualFileSystem::MountPack) and
+// reads resolve to it instead of the loose files.
+//
+//   PackBuilder [--lz4] [--verify] <output.de3pack> <root> [path under root ...]
+//
+// With no paths, everything under the root is packed. --verify reopens the
+// pack, checks every entry against its source and times reading all files
+// loose versus packed.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "IO/FileIOService.h"
+#include "IO/VirtualFileSystem.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct PackSource {
+    std::string packPath;
+    std::string diskPath;
+};
+
+void CollectFiles(const std::filesystem::path& root, const std::filesystem::path& start,
+                  const std::filesystem::path& exclude, std::vector<PackSource>& sources) {
+    auto add = [&](const std::filesystem::path& file) {
+        std::error_code error;
+        if (std::filesystem::equivalent(file, exclude, error)) {
+            return;
+        }
+        sources.push_back({ file.lexically_relative(root).generic_string(), file.string() });
+    };
+
+    if (std::filesystem::is_regular_file(start)) {
+        add(start);
+        return;
+    }
+    for (const auto& item : std::filesystem::recursive_directory_iterator(start)) {
+        if (item.is_regular_file()) {
+            add(item.path());
+        }
+    }
+}
+
+bool Verify(const std::string& packPath, const std::vector<PackSource>& sources) {
+    const Clock::time_point looseStart = Clock::now();
+    std::vector<std::vector<uint8_t>> loose(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        FileIOService::ReadWholeFile(sources[i].diskPath, loose[i]);
+    }
+    const double looseMs = ElapsedMs(looseStart);
+
+    const Clock::time_point packStart = Clock::now();
+    VirtualFileSystem fileSystem;
+    if (!fileSystem.MountPack(packPath)) {
+        return false;
+    }
+    std::vector<uint8_t> packed;
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (!fileSystem.ReadFile(sources[i].packPath, packed) || packed != loose[i]) {
+            printf("PackBuilder: '%s' differs from its source\n", sources[i].packPath.c_str());
+            mismatches++;
+        }
+    }
+    const double packMs = ElapsedMs(packStart);
+
+    printf("Verify: %zu files, %u mismatches\n", sources.size(), mismatches);
+    printf("Read all: loose %.2f ms, packed %.2f ms (including mount)\n", looseMs, packMs);
+    return mismatches == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool compress = false;
+    bool verify = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--lz4") == 0) {
+            compress = true;
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (args.size() < 2) {
+        printf("Usage: PackBuilder [--lz4] [--verify] <output.de3pack> <root> [path under root ...]\n");
+        return 1;
+    }
+
+    const std::string outputPath = args[0];
+    const std::filesystem::path root = args[1];
+    std::vector<PackSource> sources;
+    try {
+        if (args.size() == 2) {
+            CollectFiles(root, root, outputPath, sources);
+        }
+        for (size_t i = 2; i < args.size(); ++i) {
+            CollectFiles(root, root / args[i], outputPath, sources);
+        }
+    } catch (const std::filesystem::filesystem_error& error) {
+        printf("PackBuilder: %s\n", error.what());
+        return 1;
+    }
+
+    PackWriter writer;
+    for (const PackSource& source : sources) {
+        writer.AddFile(source.packPath, source.diskPath, compress);
+    }
+
+    const Clock::time_point writeStart = Clock::now();
+    PackWriter::Statistics stats;
+    if (!writer.Write(outputPath, &stats)) {
+        return 1;
+    }
+    const double writeMs = ElapsedMs(writeStart);
+
+    printf("=== PackBuilder: %s ===\n", outputPath.c_str());
+    printf("Entries: %u (%u compressed)\n", stats.entries, stats.compressedEntries);
+    printf("Source: %.2f MB, Stored: %.2f MB, File: %.2f MB\n", stats.sourceBytes / (1024.0 * 1024.0),
+           stats.storedBytes / (1024.0 * 1024.0), stats.fileSize / (1024.0 * 1024.0));
+    printf("Write: %.2f ms\n", writeMs);
+    printf("===========================\n");
+
+    if (verify && !Verify(outputPath, sources)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+// =============================================================================
+// Slot Map Benchmark
+// =============================================================================
+//
+// Times the per-draw mesh lookups of the forward pass: for every draw, resolve
+// the mesh handle, check it is drawable, read a LOD view and the bounds. The
+// SlotMap registry the engine uses is compared with the unordered_map of whole
+// entries it replaced, after the same create/destroy churn on both.
+//
+//   SlotMapBenchmark [--meshes N] [--draws N] [--runs N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "resources/RenderTypes.h"
+#include "resources/SlotMap.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Same split as GeometryManager's registry: what a draw reads...
+struct MeshRenderData {
+    MeshState state = MeshState::PendingUpload;
+    uint32_t lodCount = 0;
+    uint64_t uploadFenceValue = 0;
+    MeshView lodViews[MAX_MESH_LODS];
+    MeshBounds bounds;
+    MeshDecode decode;
+    uint32_t meshletOffset = 0;
+    uint32_t meshletCount = 0;
+};
+
+// ...and the bookkeeping it does not
+struct MeshEntry {
+    std::string name;
+    uint32_t uploadFrameIndex = 0;
+    uint64_t retireFenceValue = 0;
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    std::vector<uint8_t> vertexData;
+    std::vector<uint8_t> indexData;
+    std::vector<uint32_t> lodIndexCounts;
+    std::unique_ptr<OccluderGeometry> occluder;
+};
+
+// The registry before the slot map: one node per mesh holding both halves
+struct LegacyMeshEntry {
+    MeshRenderData renderData;
+    MeshEntry entry;
+};
+
+MeshRenderData MakeRenderData(std::mt19937& random) {
+    MeshRenderData renderData;
+    renderData.state = random() % 16 == 0 ? MeshState::Uploading : MeshState::Ready;
+    renderData.lodCount = 1 + random() % MAX_MESH_LODS;
+    for (uint32_t lod = 0; lod < renderData.lodCount; ++lod) {
+        renderData.lodViews[lod].vertexOffset = random() % 1000000;
+        renderData.lodViews[lod].indexCount = 3 * (1 + random() % 10000);
+    }
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        renderData.bounds.min[axis] = -1.0f - static_cast<float>(random() % 8);
+        renderData.bounds.max[axis] = 1.0f + static_cast<float>(random() % 8);
+    }
+    return renderData;
+}
+
+MeshEntry MakeEntry(uint32_t id) {
+    MeshEntry entry;
+    entry.name = "mesh_" + std::to_string(id);
+    entry.lodIndexCounts.resize(MAX_MESH_LODS);
+    return entry;
+}
+
+// The work a draw does with the lookup result, folded into a checksum so it
+// cannot be optimized away
+inline uint64_t ConsumeDraw(const MeshRenderData* renderData, uint32_t lod) {
+    if (!renderData || renderData->state != MeshState::Ready) {
+        return 1;
+    }
+    const MeshView& view = renderData->lodViews[std::min(lod, renderData->lodCount - 1)];
+    const float extent = renderData->bounds.max[0] - renderData->bounds.min[0];
+    return view.vertexOffset + view.indexCount + static_cast<uint64_t>(extent);
+}
+
+struct RunResult {
+    double slotMapMs = 0.0;
+    double unorderedMapMs = 0.0;
+    uint64_t slotMapChecksum = 0;
+    uint64_t unorderedMapChecksum = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t meshCount = 4096;
+    uint32_t drawCount = 100000;
+    uint32_t runs = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--meshes") == 0 && i + 1 < argc) {
+            meshCount = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--draws") == 0 && i + 1 < argc) {
+            drawCount = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else {
+            printf("Usage: SlotMapBenchmark [--meshes N] [--draws N] [--runs N]\n");
+            return 1;
+        }
+    }
+    meshCount = std::min(meshCount, SlotMap<MeshRenderData, MeshEntry>::MAX_SLOTS / 2);
+
+    // Build both registries with the same churn: create twice the meshes,
+    // destroy a random half, so slots and buckets are not in creation order
+    std::mt19937 random(37);
+    SlotMap<MeshRenderData, MeshEntry> slotMap;
+    std::unordered_map<MeshHandle, LegacyMeshEntry> unorderedMap;
+    std::vector<MeshHandle> slotHandles;
+    std::vector<MeshHandle> legacyHandles;
+    MeshHandle nextLegacyHandle = 1;
+    for (uint32_t i = 0; i < meshCount * 2; ++i) {
+        const MeshRenderData renderData = MakeRenderData(random);
+        slotHandles.push_back(slotMap.Insert(renderData, MakeEntry(i)));
+
+        LegacyMeshEntry& legacy = unorderedMap[nextLegacyHandle];
+        legacy.renderData = renderData;
+        legacy.entry = MakeEntry(i);
+        legacyHandles.push_back(nextLegacyHandle++);
+    }
+    for (uint32_t i = 0; i < meshCount; ++i) {
+        const size_t index = random() % slotHandles.size();
+        slotMap.Remove(slotHandles[index]);
+        unorderedMap.erase(legacyHandles[index]);
+        slotHandles[index] = slotHandles.back();
+        slotHandles.pop_back();
+        legacyHandles[index] = legacyHandles.back();
+        legacyHandles.pop_back();
+    }
+
+    // Draw list in entity order, which has nothing to do with mesh order
+    std::vector<uint32_t> drawMeshes(drawCount);
+    std::vector<uint32_t> drawLODs(drawCount);
+    for (uint32_t i = 0; i < drawCount; ++i) {
+        drawMeshes[i] = random() % meshCount;
+        drawLODs[i] = random() % MAX_MESH_LODS;
+    }
+    std::vector<MeshHandle> slotDraws(drawCount);
+    std::vector<MeshHandle> legacyDraws(drawCount);
+    for (uint32_t i = 0; i < drawCount; ++i) {
+        slotDraws[i] = slotHandles[drawMeshes[i]];
+        legacyDraws[i] = legacyHandles[drawMeshes[i]];
+    }
+
+    // Best of N, alternating so neither side always runs on a warm cache
+    RunResult best;
+    for (uint32_t run = 0; run < runs; ++run) {
+        RunResult result;
+
+        const Clock::time_point slotStart = Clock::now();
+        for (uint32_t i = 0; i < drawCount; ++i) {
+            result.slotMapChecksum += ConsumeDraw(slotMap.GetHot(slotDraws[i]), drawLODs[i]);
+        }
+        result.slotMapMs = ElapsedMs(slotStart);
+
+        const Clock::time_point legacyStart = Clock::now();
+        for (uint32_t i = 0; i < drawCount; ++i) {
+            auto it = unorderedMap.find(legacyDraws[i]);
+            const MeshRenderData* renderData = it != unorderedMap.end() ? &it->second.renderData : nullptr;
+            result.unorderedMapChecksum += ConsumeDraw(renderData, drawLODs[i]);
+        }
+        result.unorderedMapMs = ElapsedMs(legacyStart);
+
+        printf("Run %u: slot map %.3f ms, unordered_map %.3f ms\n", run, result.slotMapMs, result.unorderedMapMs);
+        if (run == 0 || result.slotMapMs < best.slotMapMs) {
+            best.slotMapMs = result.slotMapMs;
+            best.slotMapChecksum = result.slotMapChecksum;
+        }
+        if (run == 0 || result.unorderedMapMs < best.unorderedMapMs) {
+            best.unorderedMapMs = result.unorderedMapMs;
+            best.unorderedMapChecksum = result.unorderedMapChecksum;
+        }
+    }
+
+    if (best.slotMapChecksum != best.unorderedMapChecksum) {
+        printf("Checksum mismatch: %llu vs %llu\n", static_cast<unsigned long long>(best.slotMapChecksum),
+               static_cast<unsigned long long>(best.unorderedMapChecksum));
+        return 1;
+    }
+
+    printf("=== SlotMapBenchmark ===\n");
+    printf("Meshes: %u, Draws: %u, Hot: %zu bytes, Entry: %zu bytes\n", meshCount, drawCount,
+           sizeof(MeshRenderData), sizeof(LegacyMeshEntry));
+    printf("SlotMap: %.3f ms (%.2f ns/draw)\n", best.slotMapMs, best.slotMapMs * 1e6 / drawCount);
+    printf("unordered_map: %.3f ms (%.2f ns/draw)\n", best.unorderedMapMs, best.unorderedMapMs * 1e6 / drawCount);
+    printf("Speedup: %.1fx\n", best.slotMapMs > 0.0 ? best.unorderedMapMs / best.slotMapMs : 0.0);
+    printf("===========================\n");
+    return 0;
+}
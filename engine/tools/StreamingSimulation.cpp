@@ -0,0 +1,191 @@
+// =============================================================================
+// Streaming Simulation
+// =============================================================================
+//
+// Walks a camera across a synthetic world streamed through StreamingManager,
+// with a target that only counts bytes, so budgets and eviction can be
+// checked without a GPU. The world is a grid of meshes written to one cooked
+// mesh file; every frame requests the meshes within the view radius.
+//
+//   StreamingSimulation [--grid N] [--mesh-kb N] [--budget-mb N] [--radius R]
+//                       [--frames N] <world.de3mesh>
+//
+// Fails if the budget is ever exceeded or the target's live bytes disagree
+// with the manager's.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "IO/FileIOService.h"
+#include "resources/CookedMesh.h"
+#include "resources/StreamingManager.h"
+
+namespace {
+
+constexpr float CELL_SIZE = 10.0f;
+
+// Stands in for GeometryManager
+class CountingTarget : public IMeshStreamingTarget {
+public:
+    MeshHandle CreateMesh(const EncodedMesh& mesh) override {
+        const size_t bytes = static_cast<size_t>(mesh.vertexCount) * mesh.layout.GetStride() + mesh.GetIndexDataSize();
+        const MeshHandle handle = m_nextHandle++;
+        m_live[handle] = bytes;
+        m_liveBytes += bytes;
+        return handle;
+    }
+
+    void DestroyMesh(MeshHandle handle) override {
+        auto it = m_live.find(handle);
+        if (it == m_live.end()) {
+            printf("StreamingSimulation: destroyed unknown mesh %u\n", handle);
+            m_errors++;
+            return;
+        }
+        m_liveBytes -= it->second;
+        m_live.erase(it);
+    }
+
+    size_t GetLiveBytes() const { return m_liveBytes; }
+    uint32_t GetErrors() const { return m_errors; }
+
+private:
+    std::unordered_map<MeshHandle, size_t> m_live;
+    size_t m_liveBytes = 0;
+    MeshHandle m_nextHandle = 1;
+    uint32_t m_errors = 0;
+};
+
+// One flat mesh per grid cell, vertex count sized to hit meshBytes
+bool WriteWorld(const std::string& path, uint32_t grid, size_t meshBytes) {
+    const VertexLayout layout = VertexLayout::Float();
+    const uint32_t indexCount = 3 * 1024;
+    const size_t indexBytes = indexCount * sizeof(uint32_t);
+    const uint32_t vertexCount = static_cast<uint32_t>(
+        std::max<size_t>(3, (meshBytes > indexBytes ? meshBytes - indexBytes : 0) / layout.GetStride()));
+
+    std::vector<CookedMesh> meshes(static_cast<size_t>(grid) * grid);
+    for (uint32_t y = 0; y < grid; ++y) {
+        for (uint32_t x = 0; x < grid; ++x) {
+            CookedMesh& mesh = meshes[y * grid + x];
+            mesh.name = "cell_" + std::to_string(x) + "_" + std::to_string(y);
+            mesh.layout = layout;
+            mesh.vertexCount = vertexCount;
+            mesh.indexFormat = IndexFormat::Uint32;
+            mesh.lodIndexCounts = { indexCount };
+            mesh.bounds.min[0] = x * CELL_SIZE;
+            mesh.bounds.min[2] = y * CELL_SIZE;
+            mesh.bounds.max[0] = (x + 1) * CELL_SIZE;
+            mesh.bounds.max[1] = 1.0f;
+            mesh.bounds.max[2] = (y + 1) * CELL_SIZE;
+            mesh.vertexData.assign(static_cast<size_t>(vertexCount) * layout.GetStride(), static_cast<uint8_t>(x));
+            mesh.indexData.assign(indexBytes, 0);
+        }
+    }
+    return WriteCookedMeshFile(path, meshes);
+}
+
+void PrintUsage() {
+    printf("Usage: StreamingSimulation [--grid N] [--mesh-kb N] [--budget-mb N] [--radius R]\n"
+           "                           [--frames N] <world.de3mesh>\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t grid = 64;
+    size_t meshKB = 256;
+    size_t budgetMB = 64;
+    float radius = 60.0f;
+    uint32_t frames = 2000;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            grid = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--mesh-kb") == 0 && i + 1 < argc) {
+            meshKB = static_cast<size_t>(std::max(16L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--budget-mb") == 0 && i + 1 < argc) {
+            budgetMB = static_cast<size_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) {
+            radius = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (path.empty()) {
+            path = argv[i];
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (!WriteWorld(path, grid, meshKB * 1024)) {
+        printf("StreamingSimulation: failed to write %s\n", path.c_str());
+        return 1;
+    }
+
+    FileIOService ioService;
+    CountingTarget target;
+    StreamingManager::Config config;
+    config.residentBudget = budgetMB * 1024 * 1024;
+    config.ioBytesPerFrame = config.residentBudget / 16;
+    config.uploadBytesPerFrame = config.residentBudget / 32;
+    StreamingManager streaming(&target, &ioService, config);
+
+    std::vector<StreamedMeshHandle> handles;
+    if (!streaming.AddCookedMeshFile(path, &handles)) {
+        return 1;
+    }
+
+    // Diagonal walk from one corner to the other and back
+    const float worldSize = grid * CELL_SIZE;
+    const glm::mat4 identity(1.0f);
+    uint32_t budgetViolations = 0;
+    uint32_t mismatches = 0;
+    double residentFraction = 0.0;
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        const float t = static_cast<float>(frame) / frames;
+        const float along = (t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f) * worldSize;
+        const glm::vec3 camera(along, 2.0f, along);
+        streaming.BeginFrame(camera, 60.0f);
+
+        for (StreamedMeshHandle handle : handles) {
+            const MeshBounds* bounds = streaming.GetMeshBounds(handle);
+            const glm::vec3 center((bounds->min[0] + bounds->max[0]) * 0.5f, 0.0f,
+                                   (bounds->min[2] + bounds->max[2]) * 0.5f);
+            if (glm::length(center - glm::vec3(camera.x, 0.0f, camera.z)) <= radius) {
+                streaming.RequestMesh(handle, identity);
+            }
+        }
+        streaming.Update();
+
+        const StreamingManager::Statistics stats = streaming.GetStatistics();
+        if (stats.residentBytes + stats.loadingBytes > config.residentBudget) {
+            budgetViolations++;
+        }
+        if (stats.residentBytes != target.GetLiveBytes()) {
+            mismatches++;
+        }
+        if (stats.requestedMeshes > 0) {
+            residentFraction += static_cast<double>(stats.requestedResident) / stats.requestedMeshes;
+        }
+    }
+
+    streaming.PrintStats();
+    const StreamingManager::Statistics stats = streaming.GetStatistics();
+    printf("World: %.1f MB over %zu meshes, budget %zu MB (%.1fx oversubscribed)\n",
+           stats.registeredBytes / (1024.0 * 1024.0), handles.size(), budgetMB,
+           static_cast<double>(stats.registeredBytes) / config.residentBudget);
+    printf("Average requested resident: %.1f%%\n", 100.0 * residentFraction / frames);
+    printf("Budget violations: %u, byte mismatches: %u, target errors: %u\n", budgetViolations, mismatches,
+           target.GetErrors());
+    return budgetViolations == 0 && mismatches == 0 && target.GetErrors() == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// =============================================================================
+// Texture Cook
+// =============================================================================
+//
+// Imports an image, builds its mip chain and block-compresses every level
+// into a cooked texture file, then reads the file back. With --verify each
+// level is decoded again and compared against the uncompressed mip.
+//
+//   TextureCook [--format rgba|bc1|bc3|bc5|bc7] [--usage color|linear|normal]
+//               [--no-mips] [--threads N] [--verify] <image> <file.de3tex>
+//
+// Normal maps default to BC5, everything else to BC7.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "jobs/JobSystem.h"
+#include "resources/CookedTexture.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const char* GetFormatName(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::RGBA8: return "RGBA8";
+    case TextureFormat::RGBA8_SRGB: return "RGBA8_SRGB";
+    case TextureFormat::BC1: return "BC1";
+    case TextureFormat::BC1_SRGB: return "BC1_SRGB";
+    case TextureFormat::BC3: return "BC3";
+    case TextureFormat::BC3_SRGB: return "BC3_SRGB";
+    case TextureFormat::BC5: return "BC5";
+    case TextureFormat::BC7: return "BC7";
+    case TextureFormat::BC7_SRGB: return "BC7_SRGB";
+    }
+    return "?";
+}
+
+bool ParseFormat(const char* text, TextureFormat& format) {
+    const struct {
+        const char* name;
+        TextureFormat format;
+    } formats[] = {
+        { "rgba", TextureFormat::RGBA8 }, { "bc1", TextureFormat::BC1 }, { "bc3", TextureFormat::BC3 },
+        { "bc5", TextureFormat::BC5 }, { "bc7", TextureFormat::BC7 },
+    };
+    for (const auto& entry : formats) {
+        if (strcmp(text, entry.name) == 0) {
+            format = entry.format;
+            return true;
+        }
+    }
+    return false;
+}
+
+// PSNR over the channels the format keeps (BC5: red and green, BC1: RGB)
+double ComputePSNR(const TextureImage& reference, const TextureImage& decoded, TextureFormat format) {
+    uint32_t channels = 4;
+    if (format == TextureFormat::BC5) {
+        channels = 2;
+    } else if (format == TextureFormat::BC1 || format == TextureFormat::BC1_SRGB) {
+        channels = 3;
+    }
+
+    double squaredError = 0.0;
+    for (size_t i = 0; i < reference.pixels.size(); i += 4) {
+        for (uint32_t c = 0; c < channels; ++c) {
+            const double delta = static_cast<double>(reference.pixels[i + c]) - decoded.pixels[i + c];
+            squaredError += delta * delta;
+        }
+    }
+    const double meanError = squaredError / (reference.pixels.size() / 4 * channels);
+    return meanError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanError) : 99.0;
+}
+
+void PrintUsage() {
+    printf("Usage: TextureCook [--format rgba|bc1|bc3|bc5|bc7] [--usage color|linear|normal]\n"
+           "                   [--no-mips] [--threads N] [--verify] <image> <file.de3tex>\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    TextureCookSettings settings;
+    bool formatGiven = false;
+    bool verify = false;
+    uint32_t threads = 0;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (!ParseFormat(argv[++i], settings.format)) {
+                PrintUsage();
+                return 1;
+            }
+            formatGiven = true;
+        } else if (strcmp(argv[i], "--usage") == 0 && i + 1 < argc) {
+            const char* usage = argv[++i];
+            settings.usage = strcmp(usage, "normal") == 0 ? TextureUsage::Normal
+                           : strcmp(usage, "linear") == 0 ? TextureUsage::Linear
+                           : TextureUsage::Color;
+        } else if (strcmp(argv[i], "--no-mips") == 0) {
+            settings.generateMips = false;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<uint32_t>(std::max(1L, strtol(argv[++i], nullptr, 10)));
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2) {
+        PrintUsage();
+        return 1;
+    }
+    if (!formatGiven && settings.usage == TextureUsage::Normal) {
+        settings.format = TextureFormat::BC5;
+    }
+
+    Clock::time_point start = Clock::now();
+    TextureImage image;
+    if (!LoadTextureImage(paths[0], image)) {
+        return 1;
+    }
+    const double loadMs = ElapsedMs(start);
+
+    JobSystem jobSystem(threads);
+    start = Clock::now();
+    CookedTexture cooked = CookTexture(image, settings, &jobSystem);
+    const double cookMs = ElapsedMs(start);
+    if (cooked.data.empty()) {
+        printf("TextureCook: '%s' could not be cooked\n", paths[0].c_str());
+        return 1;
+    }
+    cooked.name = paths[0].substr(paths[0].find_last_of("/\\") + 1);
+
+    if (!WriteCookedTextureFile(paths[1], cooked)) {
+        return 1;
+    }
+    CookedTextureFile file;
+    if (!file.Open(paths[1])) {
+        return 1;
+    }
+
+    size_t uncompressedBytes = 0;
+    for (const TextureLevel& level : cooked.levels) {
+        uncompressedBytes += static_cast<size_t>(level.width) * level.height * 4;
+    }
+    printf("%s: %ux%u, %u levels, %s\n", cooked.name.c_str(), file.GetWidth(), file.GetHeight(), file.GetLevelCount(),
+           GetFormatName(file.GetFormat()));
+    printf("RGBA8 with mips: %.2f MB, cooked: %.2f MB (%.1fx smaller)\n", uncompressedBytes / (1024.0 * 1024.0),
+           file.GetDataSize() / (1024.0 * 1024.0), static_cast<double>(uncompressedBytes) / file.GetDataSize());
+    printf("Load: %.1f ms, mips and encode: %.1f ms on %u threads (%.1f MPixel/s)\n", loadMs, cookMs,
+           jobSystem.GetThreadCount(), uncompressedBytes / 4 / 1000.0 / std::max(cookMs, 0.001));
+
+    if (verify) {
+        // Compare against what was encoded, resampled to whole blocks if it was
+        if (file.GetWidth() != image.width || file.GetHeight() != image.height) {
+            image = ResizeTextureImage(image, settings.usage, file.GetWidth(), file.GetHeight());
+        }
+        const std::vector<TextureImage> mips = GenerateMipChain(image, settings.usage, file.GetLevelCount());
+        for (uint32_t i = 0; i < file.GetLevelCount(); ++i) {
+            const TextureLevel& level = file.GetLevel(i);
+            const TextureImage decoded = DecodeTextureLevel(file.GetLevelData(i), level, file.GetFormat());
+            printf("  Level %2u: %5ux%-5u %8.2f KB  PSNR %.2f dB\n", i, level.width, level.height, level.size / 1024.0,
+                   ComputePSNR(mips[i], decoded, file.GetFormat()));
+        }
+    }
+    return 0;
+}